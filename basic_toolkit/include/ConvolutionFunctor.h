@@ -59,8 +59,10 @@ class ConvolutionFunctor : public AlgorithmPolicy<T> {
 
   void resetLHS( std::vector<T>  const& lhs);
 
-  std::vector<T>   operator()( std::vector<T>  const& lhs, std::vector<T>  const& rhs );
-  std::vector<T>   operator()( std::vector<T> const& rhs );
+  // The result is held by the functor and remains valid until the next call. 
+
+  std::vector<T> const&  operator()( std::vector<T>  const& lhs, std::vector<T>  const& rhs );
+  std::vector<T> const&  operator()( std::vector<T> const& rhs );
 
 };
 
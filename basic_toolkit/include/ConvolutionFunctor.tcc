@@ -55,7 +55,7 @@ void ConvolutionFunctor<T, AlgorithmPolicy >::resetLHS( std::vector<T>  const& l
 //||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
 
 template <typename T,  template<typename U> class AlgorithmPolicy >
-std::vector<T>   ConvolutionFunctor<T, AlgorithmPolicy >::operator()( std::vector<T>  const& lhs, std::vector<T>  const& rhs )
+std::vector<T> const&  ConvolutionFunctor<T, AlgorithmPolicy >::operator()( std::vector<T>  const& lhs, std::vector<T>  const& rhs )
 { 
   return  AlgorithmPolicy<T>::operator()( lhs, rhs); 
 }
@@ -64,7 +64,7 @@ std::vector<T>   ConvolutionFunctor<T, AlgorithmPolicy >::operator()( std::vecto
 //||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
 
 template <typename T,  template<typename U> class AlgorithmPolicy >
-std::vector<T>   ConvolutionFunctor<T, AlgorithmPolicy >::operator()(  std::vector<T> const& rhs ) 
+std::vector<T> const&  ConvolutionFunctor<T, AlgorithmPolicy >::operator()(  std::vector<T> const& rhs ) 
 { 
   return  AlgorithmPolicy<T>::operator()( rhs); 
 }
@@ -100,10 +100,13 @@ std::vector<T> const& ConvolutionFFTPolicy<T>::operator()( std::vector<T> const&
   //-------------------------------------------------------------------------------------------
 
   //--------------------------------------------------------------
-  // compute rhs transform ....
+  // compute rhs transform .... a shorter rhs is zero-padded.
   //--------------------------------------------------------------
 
-   std::copy(  (FFT_Input_t*) &rhs[0],  (FFT_Input_t*) &rhs[0] + fft_input_array_size_ ,   (FFT_Input_t*) &rhsdata_[0] );
+   int const n = std::min( int( rhs.size() ), fft_input_array_size_ );
+
+   std::copy(  (FFT_Input_t*) &rhs[0],  (FFT_Input_t*) &rhs[0] + n ,   (FFT_Input_t*) &rhsdata_[0] );
+   std::fill(  (FFT_Input_t*) &rhsdata_[0] + n,  (FFT_Input_t*) &rhsdata_[0] + fft_input_array_size_,  FFT_Input_t() );
 
    forward_transform_( (FFT_Input_t*) &rhsdata_[0] );
 
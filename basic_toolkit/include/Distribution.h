@@ -55,6 +55,7 @@ extern double drand48();
 
 #include <basic_toolkit/VectorD.h>
 #include <basic_toolkit/RandomOrthogonal.h>
+#include <basic_toolkit/RandomStreams.h>
 
 class Distribution 
 {
@@ -66,6 +67,9 @@ class Distribution
   virtual double getValue() { return drand48();}
 
  protected:
+  Distribution( RandomStream const& s )     // leaves the drand48() state alone
+  : _initialSeed( static_cast<long>( s.seed() ) ) { }
+
   long   _initialSeed;
 };
 
@@ -82,6 +86,7 @@ class Gaussian : public Distribution
   double sigma() const { return _sigma; }
 
   double getValue() const;
+  double getValue( RandomStream& ) const;  // same distribution, drawn from a counter-based stream
 
  private:
   double _mean;
@@ -93,6 +98,9 @@ class MultiGaussian : public Distribution
 {
  public:
   MultiGaussian( const Vector& average, const Vector& sigma, long seed = 0 );
+  MultiGaussian( const Vector& average, const Vector& sigma, RandomStream& );
+  // The second form draws the rotation from the stream
+  // instead of drand48().
   ~MultiGaussian();
 
   void setMean( const Vector& m ) { _mean = m; }
@@ -103,8 +111,11 @@ class MultiGaussian : public Distribution
   void setRotation( const MatrixD& M );
 
   Vector getValue() const;
+  Vector getValue( RandomStream& ) const;
 
  private:
+  void init( MatrixD const& R );
+
   Vector   _mean;
   Vector   _sigma;
   MatrixD  _covariance;
@@ -48,6 +48,8 @@
 
 #include <basic_toolkit/globaldefs.h>
 #include <basic_toolkit/Matrix.h>
+#include <basic_toolkit/RandomStreams.h>
+#include <boost/function.hpp>
 
 class DLLEXPORT RandomOrthogonal
 {
@@ -71,8 +73,13 @@ class DLLEXPORT RandomOrthogonal
     // Default range = [ 0, 2 pi ) for all indices
 
     MatrixD build();
+    MatrixD build( RandomStream& );
+    // The first form draws the angles with drand48();
+    // the second, from a counter-based stream.
     
   private:
+    MatrixD build( boost::function<double()> const& uniform );
+
     int      dim_;
     int      passes_;
     bool**   omitted_;        // owned
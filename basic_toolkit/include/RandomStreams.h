@@ -0,0 +1,140 @@
+/*************************************************************************
+**************************************************************************
+**************************************************************************
+******
+******  BASIC TOOLKIT:  Low level utility C++ classes.
+******
+******  File:      RandomStreams.h
+******
+******  Copyright Fermi Research Alliance / Fermilab
+******            All Rights Reserved
+******
+******  Usage, modification, and redistribution are subject to terms
+******  of the License supplied with this software.
+******
+******  Software and documentation created under
+******  U.S. Department of Energy Contract No. DE-AC02-07CH11359
+******  The U.S. Government retains a world-wide non-exclusive,
+******  royalty-free license to publish or reproduce documentation
+******  and software for U.S. Government purposes. This software
+******  is protected under the U.S. and Foreign Copyright Laws.
+******
+**************************************************************************
+**************************************************************************
+*************************************************************************/
+
+// ==============================================================================
+//
+// Counter-based random numbers.
+//
+// Philox4x32 is the 10 round Philox bijection of
+//
+//   J.K. Salmon, M.A. Moraes, R.O. Dror and D.E. Shaw,
+//   "Parallel Random Numbers: As Easy as 1, 2, 3", SC11 (2011).
+//
+// It maps a 128 bit counter and a 64 bit key to 128 random bits. There
+// is no state to carry from one number to the next: the n-th number of a
+// stream is a function of (key, counter) only. A RandomStream is the
+// sequence obtained by incrementing one word of the counter, the other
+// words and the key being fixed by
+//
+//   - seed:    the key;
+//   - stream:  a 64 bit index, e.g. the index of a particle in a bunch;
+//   - lane:    a 32 bit index, to draw independent sequences for the same
+//              stream, e.g. one per phase space plane.
+//
+// The counter is { block, lane, stream (low word), stream (high word) }, each
+// block yielding two uniform numbers: a stream has 2^33 numbers.
+//
+// Streams with different (seed, stream, lane) are statistically independent,
+// and a stream can be created anywhere, in any thread, in any order: a bunch
+// populated with stream(j) for particle j is the same whatever the number of
+// threads or the order in which the particles are visited.
+//
+// A RandomStream is a function object returning numbers uniformly
+// distributed in (0,1) (0 and 1 excluded), so that it can be used where a
+// boost::function<double()> is expected.
+//
+// ==============================================================================
+
+#ifndef RANDOMSTREAMS_H
+#define RANDOMSTREAMS_H
+
+#include <boost/cstdint.hpp>
+#include <basic_toolkit/globaldefs.h>
+
+class DLLEXPORT Philox4x32 {
+
+ public:
+
+  typedef boost::uint32_t word;
+
+  static int const rounds = 10;
+
+  static void apply( word const key[2], word counter[4] );  // counter <- bijection( key, counter )
+};
+
+//------------------------------------------------------------------------------
+
+class DLLEXPORT RandomStream {
+
+ public:
+
+  RandomStream( boost::uint64_t seed=0, boost::uint64_t stream=0, boost::uint32_t lane=0 );
+
+  double operator()()   { return uniform(); }
+
+  double uniform();                           // in (0,1), 52 random bits
+  double normal();                            // zero mean, unit variance (Box-Muller)
+
+  void   discard( boost::uint64_t n );        // skips the next n uniform numbers
+
+  boost::uint64_t seed()     const;
+  boost::uint64_t stream()   const;
+  boost::uint32_t lane()     const;
+  boost::uint64_t position() const;           // no of uniform numbers drawn so far
+
+ private:
+
+  void refill();
+
+  Philox4x32::word  key_[2];
+  Philox4x32::word  counter_[4];              // { block, lane, stream (lo), stream (hi) }
+  Philox4x32::word  block_[4];                // current block: two uniform numbers
+  int               next_;                    // next unused pair of words in block_; 2 = block exhausted
+  bool              hasNormal_;
+  double            normal_;                  // second number of the last Box-Muller pair
+};
+
+//------------------------------------------------------------------------------
+
+class DLLEXPORT RandomStreams {
+
+ public:
+
+  explicit RandomStreams( boost::uint64_t seed=0 ) : seed_(seed) {}
+
+  RandomStream    stream( boost::uint64_t index, boost::uint32_t lane=0 ) const { return RandomStream( seed_, index, lane ); }
+  boost::uint64_t seed() const { return seed_; }
+
+ private:
+
+  boost::uint64_t seed_;
+};
+
+//------------------------------------------------------------------------------
+// inline members
+//------------------------------------------------------------------------------
+
+inline double RandomStream::uniform()
+{
+  if ( next_ == 2 ) refill();
+
+  Philox4x32::word const hi = block_[2*next_  ] >> 6;   // 26 bits
+  Philox4x32::word const lo = block_[2*next_+1] >> 6;   // 26 bits
+  ++next_;
+
+  return ( hi*67108864.0 + lo + 0.5 ) * ( 1.0/4503599627370496.0 );  // ( [0, 2^52) + 1/2 ) / 2^52, exact
+}
+
+#endif // RANDOMSTREAMS_H
@@ -53,6 +53,7 @@
 #define  REFERENCECOUNTER_H
 
 #include <iostream>
+#include <boost/detail/atomic_count.hpp>
 
 #include <basic_toolkit/globaldefs.h>
 #include <basic_toolkit/iosetup.h>
@@ -78,16 +79,17 @@ void intrusive_ptr_release(ReferenceCounter<T> const* p)
 template<typename T>
 class DLLEXPORT ReferenceCounter {
 
-  unsigned int refcount_; 
+  boost::detail::atomic_count refcount_; 
 
   T& toDerivedClass() { return static_cast<T&>(*this); }
 
  public:
 
   //--------------------------------------------------------
-  // NOTE: ReferenceCount is not thread safe. 
-  //       Thread safety would require a locking mechanism 
-  //       for refcount_
+  // NOTE: refcount_ is updated atomically, so that objects 
+  //       may be shared (and released) by several threads.
+  //       This does not make the objects themselves 
+  //       thread safe.
   //--------------------------------------------------------
 
   ReferenceCounter( ): refcount_(0) {}
@@ -0,0 +1,94 @@
+/*************************************************************************
+**************************************************************************
+**************************************************************************
+******
+******  BASIC TOOLKIT:  Low level utility C++ classes.
+******
+******  File:      WorkerPool.h
+******
+******  Copyright Fermi Research Alliance / Fermilab
+******            All Rights Reserved
+******
+******  Usage, modification, and redistribution are subject to terms
+******  of the License supplied with this software.
+******
+******  Software and documentation created under
+******  U.S. Department of Energy Contract No. DE-AC02-07CH11359
+******  The U.S. Government retains a world-wide non-exclusive,
+******  royalty-free license to publish or reproduce documentation
+******  and software for U.S. Government purposes. This software
+******  is protected under the U.S. and Foreign Copyright Laws.
+******
+**************************************************************************
+**************************************************************************
+*************************************************************************/
+
+// ==============================================================================
+//
+// A WorkerPool is a set of threads that are started once and then wait for
+// work. run() hands a batch of tasks to the workers and returns when every
+// task has completed, so that code that splits a computation over several
+// threads at every call (e.g. once per element, per turn) does not pay for
+// thread creation each time.
+//
+//  - the pool grows to the largest number of tasks handed to run(); its
+//    threads are stopped and joined when the pool is destroyed;
+//  - concurrent calls to run() from different threads are serialized;
+//  - run() called from within a task executes the tasks serially, in the
+//    calling thread;
+//  - a task should not throw. If it does, the remaining tasks still run and
+//    run() throws a GenericException carrying the message of the first
+//    exception.
+//
+// WorkerPool::instance() is a pool shared by the libraries. It is never
+// destroyed: its threads live until the end of the program.
+//
+// ==============================================================================
+
+#ifndef WORKERPOOL_H
+#define WORKERPOOL_H
+
+#include <string>
+#include <vector>
+#include <boost/function.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/thread.hpp>
+#include <basic_toolkit/globaldefs.h>
+
+class DLLEXPORT WorkerPool {
+
+ public:
+
+  typedef boost::function<void()> Task;
+
+  static WorkerPool& instance();
+
+  WorkerPool();
+ ~WorkerPool();
+
+  void run( std::vector<Task> const& tasks );
+
+  int  size() const;                            // no of worker threads started so far
+
+ private:
+
+  void work();
+  void execute( Task const& task );
+
+  boost::mutex                 runMutex_;       // serializes run()
+  mutable boost::mutex         mutex_;          // protects the members below
+  boost::condition_variable    ready_;          // signalled when a batch is posted
+  boost::condition_variable    done_;           // signalled when the last task of a batch completes
+  std::vector<Task> const*     tasks_;          // current batch; 0 when idle
+  int                          next_;           // next task of the batch to be picked up
+  int                          pending_;        // tasks of the batch not yet completed
+  bool                         stop_;           // set by the destructor
+  std::string                  error_;
+  boost::thread_group          threads_;
+
+  WorkerPool( WorkerPool const& );              // threads refer to the pool: not copyable
+  WorkerPool& operator=( WorkerPool const& );
+};
+
+#endif // WORKERPOOL_H
@@ -46,6 +46,11 @@ extern std::complex<double>  w(std::complex<double> const& z);
 extern std::complex<double>  erf(  std::complex<double> const& z );
 extern std::complex<double>  erfc( std::complex<double> const& z ); 
 extern std::complex<double>  erfSeries( std::complex<double> const& z ); 
+
+extern void w( int n, double const* x, double const* y, double* w_re, double* w_im );
+                                                 // w(z) for the n points z = x[j] + i y[j].
+                                                 //  Branch free (vectorizable) and reentrant;
+                                                 //  relative error < 1.0e-12. See erf.cc.
  
 extern bool nexcom( int, int, int* );            // Computes the next composition
                                                  //  of an integer into a number of parts.
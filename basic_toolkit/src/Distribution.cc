@@ -102,6 +102,12 @@ double Gaussian::getValue() const
 }
 
 
+double Gaussian::getValue( RandomStream& s ) const
+{
+  return _mean + _sigma*s.normal();
+}
+
+
 MultiGaussian::MultiGaussian( const Vector& average, 
                               const Vector& deviation,
                               long seed )
@@ -111,11 +117,30 @@ MultiGaussian::MultiGaussian( const Vector& average,
   _covariance( average.Dim(), average.Dim() ),
   _R( average.Dim(), average.Dim() )
 {
+  RandomOrthogonal generator( average.Dim() );
+  init( generator.build() );
+}
+
+
+MultiGaussian::MultiGaussian( const Vector& average, 
+                              const Vector& deviation,
+                              RandomStream& s )
+: Distribution( s ), 
+  _mean( average ),
+  _sigma( deviation ),
+  _covariance( average.Dim(), average.Dim() ),
+  _R( average.Dim(), average.Dim() )
+{
+  RandomOrthogonal generator( average.Dim() );
+  init( generator.build( s ) );
+}
 
-  int n = average.Dim();
-  for( int i=0; i<n; ++i) { _covariance[i][i] = deviation[i]*deviation[i]; }
-  RandomOrthogonal generator( n );
-  _R = generator.build();
+
+void MultiGaussian::init( MatrixD const& R )
+{
+  int n = _mean.Dim();
+  for( int i=0; i<n; ++i) { _covariance[i][i] = _sigma[i]*_sigma[i]; }
+  _R = R;
   _covariance = _R * _covariance * _R.transpose();
 }
 
@@ -183,3 +208,17 @@ Vector MultiGaussian::getValue() const
   ret = _mean + _R*ret;
   return ret;
 }
+
+
+Vector MultiGaussian::getValue( RandomStream& s ) const
+{
+  int n = _mean.Dim();
+  Vector ret( n );
+
+  for( int i = 0; i < n; i++ ) {
+    ret[i] = s.normal()*_sigma[i];
+  }
+
+  ret = _mean + _R*ret;
+  return ret;
+}
@@ -35,6 +35,8 @@
 **************************************************************************
 *************************************************************************/
 
+#include <cstdlib>
+#include <boost/ref.hpp>
 #include <basic_toolkit/RandomOrthogonal.h>
 #include <basic_toolkit/MathConstants.h>
 
@@ -191,6 +193,24 @@ void RandomOrthogonal::setRange( int n, double lo, double hi )
 //|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
 
 TMatrix<double> RandomOrthogonal::build()
+{
+  return build( boost::function<double()>( &drand48 ) );
+}
+
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+TMatrix<double> RandomOrthogonal::build( RandomStream& stream )
+{
+  return build( boost::function<double()>( boost::ref(stream) ) );
+}
+
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+TMatrix<double> RandomOrthogonal::build( boost::function<double()> const& uniform )
 {
   // This was programmed very inefficiently
   // but quickly. It will have to be redone
@@ -204,7 +224,7 @@ TMatrix<double> RandomOrthogonal::build()
     for( int i = 0; i < dim_-1; i++ ) {
       for( int j = i+1; j < dim_; j++ ) {
         if( !(omitted_[i][j]) ) {
-          double theta = lowerTheta_[i][j] + drand48()*rangeTheta_[i][j];
+          double theta = lowerTheta_[i][j] + uniform()*rangeTheta_[i][j];
           double cs = cos( theta );
           double sn = sin( theta );
           W[i][i] =  cs;  W[i][j] = sn;
@@ -0,0 +1,177 @@
+/*************************************************************************
+**************************************************************************
+**************************************************************************
+******
+******  BASIC TOOLKIT:  Low level utility C++ classes.
+******
+******  File:      RandomStreams.cc
+******
+******  Copyright Fermi Research Alliance / Fermilab
+******            All Rights Reserved
+******
+******  Usage, modification, and redistribution are subject to terms
+******  of the License supplied with this software.
+******
+******  Software and documentation created under
+******  U.S. Department of Energy Contract No. DE-AC02-07CH11359
+******  The U.S. Government retains a world-wide non-exclusive,
+******  royalty-free license to publish or reproduce documentation
+******  and software for U.S. Government purposes. This software
+******  is protected under the U.S. and Foreign Copyright Laws.
+******
+**************************************************************************
+**************************************************************************
+*************************************************************************/
+
+#if HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <cmath>
+#include <basic_toolkit/RandomStreams.h>
+
+using boost::uint32_t;
+using boost::uint64_t;
+
+namespace {
+
+ uint32_t const M0 = 0xD2511F53;    // multipliers
+ uint32_t const M1 = 0xCD9E8D57;
+ uint32_t const W0 = 0x9E3779B9;    // key schedule (golden ratio, sqrt(3)-1)
+ uint32_t const W1 = 0xBB67AE85;
+
+ inline void mulhilo( uint32_t a, uint32_t b, uint32_t& hi, uint32_t& lo )
+ {
+   uint64_t const p = uint64_t(a)*uint64_t(b);
+   hi = uint32_t( p >> 32 );
+   lo = uint32_t( p );
+ }
+
+} // namespace
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+void Philox4x32::apply( word const key[2], word c[4] )
+{
+  word k0 = key[0];
+  word k1 = key[1];
+
+  for ( int r=0; r < rounds; ++r ) {
+
+    if ( r > 0 ) { k0 += W0; k1 += W1; }
+
+    word hi0, lo0, hi1, lo1;
+    mulhilo( M0, c[0], hi0, lo0 );
+    mulhilo( M1, c[2], hi1, lo1 );
+
+    word const c0 = hi1 ^ c[1] ^ k0;
+    word const c2 = hi0 ^ c[3] ^ k1;
+
+    c[0] = c0;
+    c[1] = lo1;
+    c[2] = c2;
+    c[3] = lo0;
+  }
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+RandomStream::RandomStream( uint64_t seed, uint64_t stream, uint32_t lane )
+ : next_(2), hasNormal_(false), normal_(0.0)
+{
+  key_[0]     = uint32_t( seed );
+  key_[1]     = uint32_t( seed >> 32 );
+
+  counter_[0] = 0;
+  counter_[1] = lane;
+  counter_[2] = uint32_t( stream );
+  counter_[3] = uint32_t( stream >> 32 );
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+void RandomStream::refill()
+{
+  for ( int i=0; i<4; ++i ) { block_[i] = counter_[i]; }
+
+  Philox4x32::apply( key_, block_ );
+
+  ++counter_[0];
+  next_ = 0;
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+double RandomStream::normal()
+{
+  if ( hasNormal_ ) {
+    hasNormal_ = false;
+    return normal_;
+  }
+
+  // both uniform numbers are in (0,1): the logarithm is finite
+
+  double const r     = std::sqrt( -2.0*std::log( uniform() ) );
+  double const theta = 2.0*M_PI*uniform();
+
+  normal_    = r*std::sin( theta );
+  hasNormal_ = true;
+
+  return r*std::cos( theta );
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+void RandomStream::discard( uint64_t n )
+{
+  hasNormal_ = false;
+
+  uint64_t const pos = position() + n;
+
+  counter_[0] = uint32_t( pos/2 );
+  next_       = 2;
+
+  if ( pos%2 ) {
+    refill();
+    next_ = 1;
+  }
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+uint64_t RandomStream::position() const
+{
+  // counter_[0] is the next block to be computed; the current block, if any, is counter_[0]-1
+
+  return 2*uint64_t( counter_[0] ) - ( 2 - next_ );
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+uint64_t RandomStream::seed() const
+{
+  return ( uint64_t( key_[1] ) << 32 ) | key_[0];
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+uint64_t RandomStream::stream() const
+{
+  return ( uint64_t( counter_[3] ) << 32 ) | counter_[2];
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+uint32_t RandomStream::lane() const
+{
+  return counter_[1];
+}
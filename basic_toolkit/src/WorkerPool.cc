@@ -0,0 +1,177 @@
+/*************************************************************************
+**************************************************************************
+**************************************************************************
+******
+******  BASIC TOOLKIT:  Low level utility C++ classes.
+******
+******  File:      WorkerPool.cc
+******
+******  Copyright Fermi Research Alliance / Fermilab
+******            All Rights Reserved
+******
+******  Usage, modification, and redistribution are subject to terms
+******  of the License supplied with this software.
+******
+******  Software and documentation created under
+******  U.S. Department of Energy Contract No. DE-AC02-07CH11359
+******  The U.S. Government retains a world-wide non-exclusive,
+******  royalty-free license to publish or reproduce documentation
+******  and software for U.S. Government purposes. This software
+******  is protected under the U.S. and Foreign Copyright Laws.
+******
+**************************************************************************
+**************************************************************************
+*************************************************************************/
+
+#if HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <exception>
+#include <boost/bind.hpp>
+#include <boost/thread/tss.hpp>
+#include <basic_toolkit/GenericException.h>
+#include <basic_toolkit/WorkerPool.h>
+
+namespace {
+
+// set while a thread executes a task, so that nested calls to run() do not wait on the pool
+
+boost::thread_specific_ptr<bool> in_task;
+
+} // namespace
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+WorkerPool& WorkerPool::instance()
+{
+  static WorkerPool& pool = *( new WorkerPool() );  // never destroyed: the workers outlive static destruction
+  return pool;
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+WorkerPool::WorkerPool()
+  : tasks_(0), next_(0), pending_(0), stop_(false)
+{}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+WorkerPool::~WorkerPool()
+{
+  {
+    boost::mutex::scoped_lock lock( mutex_ );
+    stop_ = true;
+    ready_.notify_all();
+  }
+
+  threads_.join_all();
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+int WorkerPool::size() const
+{
+  boost::mutex::scoped_lock lock( mutex_ );
+  return threads_.size();
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+void WorkerPool::execute( Task const& task )
+{
+  //---------------------------------------------------------------
+  // exceptions cannot propagate across threads; the message is
+  // recorded and an exception is thrown by run().
+  //---------------------------------------------------------------
+
+  std::string error;
+
+  try {
+    task();
+  }
+  catch ( std::exception const& e ) {
+    error = e.what();
+  }
+  catch ( ... ) {
+    error = "Unknown exception.";
+  }
+
+  if ( !error.empty() ) {
+    boost::mutex::scoped_lock lock( mutex_ );
+    if ( error_.empty() ) { error_ = error; }
+  }
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+void WorkerPool::work()
+{
+  in_task.reset( new bool(true) );
+
+  boost::mutex::scoped_lock lock( mutex_ );
+
+  while ( true ) {
+
+    while ( !stop_ && ( !tasks_ || next_ >= int( tasks_->size() ) ) ) { ready_.wait( lock ); }
+
+    if ( stop_ ) return;
+
+    Task const& task = (*tasks_)[next_++];
+
+    lock.unlock();
+    execute( task );
+    lock.lock();
+
+    if ( --pending_ == 0 ) { done_.notify_all(); }
+  }
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+void WorkerPool::run( std::vector<Task> const& tasks )
+{
+  if ( tasks.empty() ) return;
+
+  if ( in_task.get() ) {
+    for ( std::vector<Task>::const_iterator it = tasks.begin(); it != tasks.end(); ++it ) { (*it)(); }
+    return;
+  }
+
+  boost::mutex::scoped_lock batch( runMutex_ );
+
+  std::string error;
+
+  {
+    boost::mutex::scoped_lock lock( mutex_ );
+
+    while ( int( threads_.size() ) < int( tasks.size() ) ) {
+      threads_.create_thread( boost::bind( &WorkerPool::work, this ) );
+    }
+
+    tasks_   = &tasks;
+    next_    = 0;
+    pending_ = tasks.size();
+    error_.clear();
+
+    ready_.notify_all();
+
+    while ( pending_ > 0 ) { done_.wait( lock ); }
+
+    tasks_ = 0;
+    error.swap( error_ );
+  }
+
+  if ( !error.empty() ) {
+    throw GenericException( __FILE__, __LINE__,
+          "void WorkerPool::run( std::vector<Task> const& tasks )",
+          error );
+  }
+}
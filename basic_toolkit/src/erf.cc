@@ -61,9 +61,11 @@ std::complex<double>  w( std::complex<double> const& z );
 
 std::complex<double>  erfSeries( const std::complex<double> & z ) 
 {
-  static std::complex<double> series        = 1.0;
-  static std::complex<double> oldseries     = 0.0;
-  static std::complex<double> arg           = 2.0*z*z;
+  // Returns (sqrt(pi)/2) exp(z^2) erf(z). No static state: reentrant.
+
+  std::complex<double>        series        = 1.0;
+  std::complex<double>        oldseries     = 0.0;
+  std::complex<double> const  arg           = 2.0*z*z;
   double                      den           = 1.0;
   std::complex<double>        term          = 1.0;
 
@@ -108,15 +110,14 @@ std::complex<double>  erf( const std::complex<double> & z )
 
 std::complex<double>  erfc( const std::complex<double> & z ) 
 {
-  static const std::complex<double>  one( 1.0, 0.0 );
-  return ( one - erf( z ) );
+  return ( 1.0 - erf( z ) );
 }
 
 //////////////////////////////////////////////////////////////
 
 std::complex<double>  w( std::complex<double> const& z ) 
 {
-  static const std::complex<double>  mi( 0., -1. );
+  std::complex<double> const  mi( 0., -1. );
   
   double x = real(z);
   double y = imag(z);
@@ -150,3 +151,107 @@ std::complex<double>  w( std::complex<double> const& z )
 
 }
 
+//////////////////////////////////////////////////////////////
+//
+// Batched Faddeeva function: w(z) for n points.
+//
+// J.A.C. Weideman, "Computation of the complex error function",
+// SIAM J. Numer. Anal. 31 (1994) 1497-1518.
+//
+// In the upper half plane,
+//
+//   w(z) = 2 p(Z)/(L - iz)^2 + (1/sqrt(pi))/(L - iz),  Z = (L + iz)/(L - iz),
+//
+// where p is a polynomial of degree N-1 = 31. The same sequence of
+// operations, without any branch, applies to every point: the loop
+// vectorizes. The relative error is below 1.0e-12 everywhere
+// (including the real axis and large |z|), i.e. much smaller than
+// that of w( std::complex<double> ) above. In the lower half plane,
+// w(z) = 2 exp(-z^2) - w(-z).
+//
+// The coefficients of p ( highest degree first ) and L = sqrt( N/sqrt(2) ), 
+// computed in extended precision.
+//
+//////////////////////////////////////////////////////////////
+
+namespace {
+
+int    const    weideman_N = 32;
+double const    weideman_L = 4.7568284600108843;
+
+double const    weideman_a[weideman_N] = {
+  -1.3033471058600179e-12, +3.7410356413644023e-12, +8.0303946391207691e-12,
+  -2.1543623274697106e-11, -5.5442474623210473e-11, +1.1658238628558322e-10,
+  +4.1537422722516515e-10, -5.2310221134105675e-10, -3.2080152196934395e-09,
+  +8.1248892057789743e-10, +2.3797556704703159e-08, +2.2930439031099885e-08,
+  -1.4813078917967019e-07, -4.1840763711778814e-07, +4.2558331373647538e-07,
+  +4.4015317315300505e-06, +6.8210319440008719e-06, -2.1409619201816365e-05,
+  -1.3075449254609957e-04, -2.4532980270018076e-04, +3.9259136070079017e-04,
+  +4.5195411053492850e-03, +1.9006155784845474e-02, +5.7304403529837192e-02,
+  +1.4060716226893785e-01, +2.9544451071508732e-01, +5.4601397206393421e-01,
+  +9.0192548936479999e-01, +1.3455441692345451e+00, +1.8256696296324813e+00,
+  +2.2635372999002676e+00, +2.5722534081245692e+00 
+};
+
+} // namespace
+
+
+void w( int n, double const* x, double const* y, double* w_re, double* w_im )
+{
+  double const  L           = weideman_L;
+  double const  one_sqrtpi  = 1.0/MATH_SQRTPI;
+
+  for( int j = 0; j < n; ++j ) {
+
+    // reflect into the upper half plane
+
+    double const sgn = ( y[j] < 0.0 ) ? -1.0 : 1.0;
+    double const xr  = sgn*x[j];
+    double const yr  = sgn*y[j];
+
+    // d = L - iz = ( L + yr ) - i xr;  Z = ( L + iz )/d = ( L - yr + i xr )/d 
+
+    double const d_re   =  L + yr;
+    double const d_im   = -xr;
+    double const d_norm =  1.0/( d_re*d_re + d_im*d_im );
+
+    double const inv_re =  d_re*d_norm;          // 1/d
+    double const inv_im = -d_im*d_norm;
+
+    double const n_re   =  L - yr;
+    double const n_im   =  xr;
+
+    double const Z_re   =  n_re*inv_re - n_im*inv_im;
+    double const Z_im   =  n_re*inv_im + n_im*inv_re;
+
+    // p(Z), Horner
+
+    double p_re = weideman_a[0];
+    double p_im = 0.0;
+
+    for( int k = 1; k < weideman_N; ++k ) {
+      double const t = p_re*Z_re - p_im*Z_im + weideman_a[k];
+      p_im           = p_re*Z_im + p_im*Z_re;
+      p_re           = t;
+    }
+
+    // 2 p/d^2 + (1/sqrt(pi))/d = ( 2 p/d + 1/sqrt(pi) )/d
+
+    double const q_re = 2.0*( p_re*inv_re - p_im*inv_im ) + one_sqrtpi;
+    double const q_im = 2.0*( p_re*inv_im + p_im*inv_re );
+
+    w_re[j] = q_re*inv_re - q_im*inv_im;
+    w_im[j] = q_re*inv_im + q_im*inv_re;
+  }
+
+  // lower half plane ( not vectorized; exp(-z^2) may overflow ) 
+
+  for( int j = 0; j < n; ++j ) {
+    if( y[j] < 0.0 ) {
+      double const e     = 2.0*exp( y[j]*y[j] - x[j]*x[j] );
+      double const theta = -2.0*x[j]*y[j];
+      w_re[j] = e*cos( theta ) - w_re[j];
+      w_im[j] = e*sin( theta ) - w_im[j];
+    }
+  }
+}
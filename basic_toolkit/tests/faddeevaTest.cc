@@ -0,0 +1,165 @@
+////////////////////////////////////////////////////////////
+//
+// File:          faddeevaTest.cc
+//
+////////////////////////////////////////////////////////////
+//
+// Checks the batched complex error function
+//
+//   void w( int n, double const* x, double const* y, double* w_re, double* w_im )
+//
+//  - against the scalar w( std::complex<double> ) over a grid
+//    covering both half planes; the scalar version is accurate
+//    to about 1.0e-5 only;
+//  - against closed forms, to 1.0e-12:
+//      w(iy) = exp(y^2) erfc(y)   on the imaginary axis,
+//      Re w(x) = exp(-x^2)        on the real axis;
+//  - the batched result does not depend on the position of
+//    a point in the batch.
+//
+// Also checks that erfSeries, which used to keep its state in
+// static variables, returns (sqrt(pi)/2) exp(z^2) erf(z) on
+// every call.
+//
+// ------------
+// COMMAND LINE
+// ------------
+// faddeevaTest [options]
+//
+// -------
+// OPTIONS
+// -------
+// -step    XXX   grid spacing
+//                : default = 0.05
+//
+////////////////////////////////////////////////////////////
+
+#include <iostream>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <vector>
+#include <complex>
+
+#include <basic_toolkit/utils.h>
+#include <basic_toolkit/MathConstants.h>
+
+using namespace std;
+using namespace MathConstants;
+
+int main( int argc, char** argv )
+{
+  double step = 0.05;
+
+  for( int i = 1; i < argc; ++i ) {
+    if ( 0 == strcmp( argv[i], "-step" ) && i+1 < argc ) { step = atof( argv[++i] ); }
+  }
+
+  int status = 0;
+
+  // ---------------------------------------------
+  // grid: batched vs scalar
+  // ---------------------------------------------
+
+  vector<double> x;
+  vector<double> y;
+
+  for( double u = -25.0; u <= 25.0; u += step ) {
+    for( double v = -3.0; v <= 25.0; v += step ) {
+      x.push_back( u );
+      y.push_back( v );
+    }
+  }
+
+  int const n = x.size();
+
+  vector<double> w_re( n );
+  vector<double> w_im( n );
+
+  w( n, &x[0], &y[0], &w_re[0], &w_im[0] );
+
+  double worst = 0.0;
+  int    jworst = 0;
+
+  for( int j = 0; j < n; ++j ) {
+    complex<double> const s = w( complex<double>( x[j], y[j] ) );
+    double const e = abs( s - complex<double>( w_re[j], w_im[j] ) )/abs( s );
+    if( e > worst ) { worst = e; jworst = j; }
+  }
+
+  if( worst > 1.0e-5 ) {
+    cout << "*** ERROR *** batched w(z) differs from scalar w(z) by " << worst
+         << " at z = ( " << x[jworst] << ", " << y[jworst] << " )" << endl;
+    status = 1;
+  }
+
+  // ---------------------------------------------
+  // position in the batch
+  // ---------------------------------------------
+
+  for( int j = 0; j < n; j += 97 ) {
+    double re, im;
+    w( 1, &x[j], &y[j], &re, &im );
+    if( re != w_re[j] || im != w_im[j] ) {
+      cout << "*** ERROR *** w(z) depends on the position of z in the batch." << endl;
+      status = 1;
+      break;
+    }
+  }
+
+  // ---------------------------------------------
+  // imaginary axis: w(iy) = exp(y^2) erfc(y)
+  // ---------------------------------------------
+
+  worst = 0.0;
+
+  for( double v = 0.0; v <= 20.0; v += step ) {
+    double const u = 0.0;
+    double re, im;
+    w( 1, &u, &v, &re, &im );
+    double const exact = exp( v*v )*erfc( v );
+    worst = std::max( worst, std::abs( re - exact )/exact + std::abs( im )/exact );
+  }
+
+  if( worst > 1.0e-12 ) {
+    cout << "*** ERROR *** w(iy) differs from exp(y^2) erfc(y) by " << worst << endl;
+    status = 1;
+  }
+
+  // ---------------------------------------------
+  // real axis: Re w(x) = exp(-x^2)
+  // ---------------------------------------------
+
+  worst = 0.0;
+
+  for( double u = 0.0; u <= 5.0; u += step ) {
+    double const v = 0.0;
+    double re, im;
+    w( 1, &u, &v, &re, &im );
+    worst = std::max( worst, std::abs( re - exp( -u*u ) )/abs( complex<double>( re, im ) ) );
+  }
+
+  if( worst > 1.0e-12 ) {
+    cout << "*** ERROR *** Re w(x) differs from exp(-x^2) by " << worst << endl;
+    status = 1;
+  }
+
+  // ---------------------------------------------
+  // erfSeries
+  // ---------------------------------------------
+
+  complex<double> const z1( 0.3, 0.2 );
+  complex<double> const z2( 1.1, -0.4 );
+
+  complex<double> const s1 = erfSeries( z1 );
+  complex<double> const s2 = erfSeries( z2 );
+
+  if(    abs( s1 - 0.5*MATH_SQRTPI*exp( z1*z1 )*erf( z1 ) ) > 1.0e-12*abs( s1 )
+      || abs( s2 - 0.5*MATH_SQRTPI*exp( z2*z2 )*erf( z2 ) ) > 1.0e-12*abs( s2 )
+      || erfSeries( z1 ) != s1 ) {
+    cout << "*** ERROR *** erfSeries(z) != (sqrt(pi)/2) exp(z^2) erf(z)." << endl;
+    status = 1;
+  }
+
+  return status;
+}
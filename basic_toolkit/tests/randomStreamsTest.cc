@@ -0,0 +1,251 @@
+////////////////////////////////////////////////////////////
+//
+// File:          randomStreamsTest.cc
+//
+////////////////////////////////////////////////////////////
+//
+// Checks the counter-based random streams.
+//
+//  - Philox4x32 reproduces the known answers of the
+//    reference implementation (Random123);
+//  - uniform numbers are in (0,1), with the expected
+//    mean and variance; normal numbers have zero mean and
+//    unit variance;
+//  - a stream is a function of (seed, stream, lane) only;
+//    neighbouring streams and lanes are uncorrelated;
+//  - discard(n) is equivalent to drawing n numbers;
+//  - MultiGaussian and RandomOrthogonal are reproducible
+//    when given a stream.
+//
+// ------------
+// COMMAND LINE
+// ------------
+// randomStreamsTest [options]
+//
+// -------
+// OPTIONS
+// -------
+// Note: NNN represents an integer
+//
+// -n       NNN   number of samples for the moments
+//                : default = 1000000
+// -seed    NNN   seed
+//                : default = 12345
+//
+////////////////////////////////////////////////////////////
+
+#include <iostream>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+
+#include <basic_toolkit/RandomStreams.h>
+#include <basic_toolkit/RandomOrthogonal.h>
+#include <basic_toolkit/Distribution.h>
+
+using namespace std;
+
+namespace {
+
+bool knownAnswer( Philox4x32::word const key[2], Philox4x32::word const ctr[4], Philox4x32::word const expected[4] )
+{
+  Philox4x32::word c[4] = { ctr[0], ctr[1], ctr[2], ctr[3] };
+
+  Philox4x32::apply( key, c );
+
+  for ( int i=0; i<4; ++i ) {
+    if ( c[i] != expected[i] ) return false;
+  }
+  return true;
+}
+
+} // namespace
+
+int main( int argc, char** argv )
+{
+  int           n    = 1000000;
+  unsigned long seed = 12345;
+
+  for( int i = 1; i < argc; ++i ) {
+    if      ( 0 == strcmp( argv[i], "-n"    ) && i+1 < argc ) { n    = atoi( argv[++i] );        }
+    else if ( 0 == strcmp( argv[i], "-seed" ) && i+1 < argc ) { seed = strtoul( argv[++i], 0, 10 ); }
+  }
+
+  int status = 0;
+
+  // ---------------------------------------------
+  // known answers ( Random123, philox4x32 10 rounds )
+  // ---------------------------------------------
+
+  Philox4x32::word const key0[2] = { 0, 0 };
+  Philox4x32::word const ctr0[4] = { 0, 0, 0, 0 };
+  Philox4x32::word const res0[4] = { 0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8 };
+
+  Philox4x32::word const key1[2] = { 0xffffffff, 0xffffffff };
+  Philox4x32::word const ctr1[4] = { 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff };
+  Philox4x32::word const res1[4] = { 0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd };
+
+  Philox4x32::word const key2[2] = { 0xa4093822, 0x299f31d0 };
+  Philox4x32::word const ctr2[4] = { 0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344 };
+  Philox4x32::word const res2[4] = { 0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1 };
+
+  if ( !knownAnswer( key0, ctr0, res0 ) || !knownAnswer( key1, ctr1, res1 ) || !knownAnswer( key2, ctr2, res2 ) ) {
+    cout << "*** ERROR *** Philox4x32 does not reproduce the known answers." << endl;
+    status = 1;
+  }
+
+  // ---------------------------------------------
+  // moments
+  // ---------------------------------------------
+
+  RandomStreams const streams( seed );
+
+  RandomStream u = streams.stream( 0 );
+
+  double sum  = 0.0;
+  double sum2 = 0.0;
+  double umin = 1.0;
+  double umax = 0.0;
+
+  for ( int i=0; i<n; ++i ) {
+    double const x = u();
+    sum  += x;
+    sum2 += x*x;
+    umin  = std::min( umin, x );
+    umax  = std::max( umax, x );
+  }
+
+  double const mean = sum/n;
+  double const var  = sum2/n - mean*mean;
+
+  if ( umin <= 0.0 || umax >= 1.0 || std::abs( mean - 0.5 ) > 5.0*sqrt( 1.0/(12.0*n) ) || std::abs( var - 1.0/12.0 ) > 5.0*sqrt( 1.0/(180.0*n) ) ) {
+    cout << "*** ERROR *** Uniform numbers: min = " << umin << ", max = " << umax
+         << ", mean = " << mean << ", variance = " << var << endl;
+    status = 1;
+  }
+
+  RandomStream g = streams.stream( 1 );
+
+  sum  = 0.0;
+  sum2 = 0.0;
+
+  for ( int i=0; i<n; ++i ) {
+    double const x = g.normal();
+    sum  += x;
+    sum2 += x*x;
+  }
+
+  if ( std::abs( sum/n ) > 5.0/sqrt( double(n) ) || std::abs( sum2/n - 1.0 ) > 5.0*sqrt( 2.0/n ) ) {
+    cout << "*** ERROR *** Normal numbers: mean = " << sum/n << ", variance = " << sum2/n << endl;
+    status = 1;
+  }
+
+  // ---------------------------------------------
+  // reproducibility and independence
+  // ---------------------------------------------
+
+  RandomStream a = streams.stream( 7, 2 );
+  RandomStream b = RandomStream( seed, 7, 2 );
+
+  for ( int i=0; i<1000; ++i ) {
+    if ( a() != b() ) {
+      cout << "*** ERROR *** Two streams with the same ( seed, stream, lane ) differ." << endl;
+      status = 1;
+      break;
+    }
+  }
+
+  int const m = 100000;
+
+  RandomStream s0 = streams.stream( 1000 );
+  RandomStream s1 = streams.stream( 1001 );
+  RandomStream s2 = streams.stream( 1000, 1 );
+
+  double c01 = 0.0;
+  double c02 = 0.0;
+
+  for ( int i=0; i<m; ++i ) {
+    double const x0 = s0() - 0.5;
+    c01 += x0*( s1() - 0.5 );
+    c02 += x0*( s2() - 0.5 );
+  }
+
+  c01 *= 12.0/m;
+  c02 *= 12.0/m;
+
+  if ( std::abs( c01 ) > 5.0/sqrt( double(m) ) || std::abs( c02 ) > 5.0/sqrt( double(m) ) ) {
+    cout << "*** ERROR *** Correlated streams: " << c01 << ", " << c02 << endl;
+    status = 1;
+  }
+
+  // ---------------------------------------------
+  // discard
+  // ---------------------------------------------
+
+  for ( int skip=0; skip < 6; ++skip ) {
+
+    RandomStream drawn   = streams.stream( 3 );
+    RandomStream skipped = streams.stream( 3 );
+
+    drawn();
+    skipped();
+
+    for ( int i=0; i<skip; ++i ) { drawn(); }
+    skipped.discard( skip );
+
+    if ( drawn.position() != skipped.position() || drawn() != skipped() ) {
+      cout << "*** ERROR *** discard( " << skip << " ) is not equivalent to drawing " << skip << " numbers." << endl;
+      status = 1;
+    }
+  }
+
+  // ---------------------------------------------
+  // MultiGaussian and RandomOrthogonal
+  // ---------------------------------------------
+
+  Vector average( 4 );
+  Vector sigma( 4 );
+  for ( int i=0; i<4; ++i ) { sigma[i] = i+1.0; }
+
+  RandomStream r0 = streams.stream( 0, 9 );
+  RandomStream r1 = streams.stream( 0, 9 );
+
+  MultiGaussian const mg0( average, sigma, r0 );
+  MultiGaussian const mg1( average, sigma, r1 );
+
+  Vector const v0 = mg0.getValue( r0 );
+  Vector const v1 = mg1.getValue( r1 );
+
+  for ( int i=0; i<4; ++i ) {
+    if ( v0[i] != v1[i] ) {
+      cout << "*** ERROR *** MultiGaussian is not reproducible." << endl;
+      status = 1;
+      break;
+    }
+  }
+
+  // the rotation of mg0 was drawn first from the stream
+
+  RandomStream o = streams.stream( 0, 9 );
+
+  MatrixD const R = RandomOrthogonal( 4 ).build( o );
+
+  MatrixD D( 4, 4 );
+  for ( int i=0; i<4; ++i ) { D[i][i] = sigma[i]*sigma[i]; }
+
+  MatrixD const C = R*D*R.transpose();
+
+  double diff = 0.0;
+  for ( int i=0; i<4; ++i ) {
+    for ( int j=0; j<4; ++j ) {
+      diff = std::max( diff, std::abs( C[i][j] - mg0.covariance()[i][j] ) );
+    }
+  }
+
+  if ( !R.isOrthogonal() || diff > 1.0e-12 ) {
+    cout << "*** ERROR *** RandomOrthogonal: the rotation drawn from a stream is not reproducible." << endl;
+    status = 1;
+  }
+
+  return status;
+}
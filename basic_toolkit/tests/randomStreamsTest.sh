@@ -0,0 +1,15 @@
+#!/bin/csh
+
+./randomStreamsTest
+set return_status = $status
+if( 0 != $return_status ) then
+  exit $return_status
+  endif
+
+./randomStreamsTest -seed 0 -n 100000
+set return_status = $status
+if( 0 != $return_status ) then
+  exit $return_status
+  endif
+
+exit 0
@@ -0,0 +1,171 @@
+////////////////////////////////////////////////////////////
+//
+// File:          workerPoolTest.cc
+//
+////////////////////////////////////////////////////////////
+//
+// Checks the WorkerPool.
+//
+//  - every task of a batch runs exactly once, and run()
+//    returns after the last one has completed;
+//  - the threads are reused: the pool does not grow beyond
+//    the largest batch;
+//  - an exception thrown by a task is rethrown by run(),
+//    after the other tasks have completed;
+//  - run() may be called from within a task, and from
+//    several threads at once.
+//
+// ------------
+// COMMAND LINE
+// ------------
+// workerPoolTest [options]
+//
+// -------
+// OPTIONS
+// -------
+// Note: NNN represents an integer
+//
+// -batches NNN   number of batches
+//                : default = 1000
+// -tasks   NNN   number of tasks per batch
+//                : default = 4
+//
+////////////////////////////////////////////////////////////
+
+#include <iostream>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+#include <boost/bind.hpp>
+#include <boost/thread/thread.hpp>
+#include <basic_toolkit/GenericException.h>
+#include <basic_toolkit/WorkerPool.h>
+
+using namespace std;
+
+namespace {
+
+void count( std::vector<int>& counts, int i )
+{
+  ++counts[i];
+}
+
+void fail( int i )
+{
+  if ( i == 1 ) throw std::runtime_error( "task 1 failed" );
+}
+
+void nested( WorkerPool& pool, std::vector<int>& counts, int i )
+{
+  std::vector<WorkerPool::Task> tasks;
+  tasks.push_back( boost::bind( &count, boost::ref(counts), i ) );
+  pool.run( tasks );
+}
+
+void batches( WorkerPool& pool, int nbatches, int ntasks, bool& ok )
+{
+  std::vector<int> counts( ntasks );
+
+  std::vector<WorkerPool::Task> tasks;
+  for ( int i=0; i < ntasks; ++i ) { tasks.push_back( boost::bind( &count, boost::ref(counts), i ) ); }
+
+  for ( int k=0; k < nbatches; ++k ) { pool.run( tasks ); }
+
+  for ( int i=0; i < ntasks; ++i ) { ok = ok && ( counts[i] == nbatches ); }
+}
+
+} // anonymous namespace
+
+int main( int argc, char** argv )
+{
+  int nbatches = 1000;
+  int ntasks   = 4;
+
+  for ( int i=1; i<argc; ++i ) {
+    if ( 0 == strcmp( argv[i], "-batches" ) && i+1 < argc ) { nbatches = atoi( argv[++i] ); }
+    if ( 0 == strcmp( argv[i], "-tasks"   ) && i+1 < argc ) { ntasks   = atoi( argv[++i] ); }
+  }
+
+  int status = 0;
+
+  WorkerPool pool;
+
+  // ---------------------------------------
+  // Batches; the threads are reused
+  // ---------------------------------------
+
+  bool ok = true;
+  batches( pool, nbatches, ntasks, ok );
+
+  if ( !ok ) {
+    cout << "*** ERROR *** Some tasks did not run exactly once per batch." << endl;
+    status = 1;
+  }
+
+  if ( pool.size() != ntasks ) {
+    cout << "*** ERROR *** The pool started " << pool.size() << " threads for batches of "
+         << ntasks << " tasks." << endl;
+    status = 1;
+  }
+
+  // ---------------------------------------
+  // Exceptions
+  // ---------------------------------------
+
+  std::vector<WorkerPool::Task> failing;
+  for ( int i=0; i < 3; ++i ) { failing.push_back( boost::bind( &fail, i ) ); }
+
+  bool thrown = false;
+  try {
+    pool.run( failing );
+  }
+  catch ( GenericException const& e ) {
+    thrown = true;
+  }
+
+  if ( !thrown ) {
+    cout << "*** ERROR *** The exception of a task was not rethrown." << endl;
+    status = 1;
+  }
+
+  // ---------------------------------------
+  // Nested calls
+  // ---------------------------------------
+
+  std::vector<int> counts( ntasks );
+
+  std::vector<WorkerPool::Task> outer;
+  for ( int i=0; i < ntasks; ++i ) { outer.push_back( boost::bind( &nested, boost::ref(pool), boost::ref(counts), i ) ); }
+
+  pool.run( outer );
+
+  for ( int i=0; i < ntasks; ++i ) {
+    if ( counts[i] != 1 ) {
+      cout << "*** ERROR *** A nested batch did not run." << endl;
+      status = 1;
+      break;
+    }
+  }
+
+  // ---------------------------------------
+  // Concurrent callers
+  // ---------------------------------------
+
+  bool ok1 = true;
+  bool ok2 = true;
+
+  boost::thread t1( boost::bind( &batches, boost::ref(pool), nbatches, ntasks, boost::ref(ok1) ) );
+  boost::thread t2( boost::bind( &batches, boost::ref(pool), nbatches, ntasks, boost::ref(ok2) ) );
+
+  t1.join();
+  t2.join();
+
+  if ( !ok1 || !ok2 ) {
+    cout << "*** ERROR *** Batches submitted from two threads were not completed." << endl;
+    status = 1;
+  }
+
+  return status;
+}
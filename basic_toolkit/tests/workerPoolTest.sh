@@ -0,0 +1,15 @@
+#!/bin/csh
+
+./workerPoolTest
+set return_status = $status
+if( 0 != $return_status ) then
+  exit $return_status
+  endif
+
+./workerPoolTest -tasks 16 -batches 200
+set return_status = $status
+if( 0 != $return_status ) then
+  exit $return_status
+  endif
+
+exit 0
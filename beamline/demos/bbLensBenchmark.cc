@@ -0,0 +1,154 @@
+/*
+**
+** Benchmark program:
+**
+** Measures the throughput, in particles per second, of the
+** beam-beam kick of a flat beam (BBLens)
+**
+**   - complex error function alone: scalar w(z), once per
+**     point, vs batched w(n, ...);
+**   - kick: particle by particle, through the ParticleBunch
+**     propagator and through the BunchArrays propagator
+**     (both evaluate the error function for the whole bunch
+**     in one pass).
+**
+** Each measurement is repeated -repeat times; the CPU time is
+** used (the propagators are serial).
+**
+** Usage: bbLensBenchmark [-n n] [-repeat n]
+**
+**   -n n       : number of particles (default: 100000)
+**   -repeat n  : default: 10
+**
+*/
+
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <vector>
+#include <complex>
+
+#include <basic_toolkit/utils.h>
+#include <basic_toolkit/RandomStreams.h>
+#include <beamline/Particle.h>
+#include <beamline/TBunch.h>
+#include <beamline/BunchArrays.h>
+#include <beamline/BBLens.h>
+
+using namespace std;
+
+namespace {
+
+double seconds( clock_t start )
+{
+  return double( clock() - start )/CLOCKS_PER_SEC;
+}
+
+void report( char const* label, int n, int repeat, double t )
+{
+  cout << setw(28) << label << setw(14) << setprecision(4) << n*double(repeat)/t << endl;
+}
+
+} // namespace
+
+int main( int argc, char** argv )
+{
+  int n      = 100000;
+  int repeat = 10;
+
+  for ( int i=1; i<argc; ++i ) {
+    if      ( 0 == strcmp( argv[i], "-n"      ) && i+1 < argc ) { n      = atoi( argv[++i] ); }
+    else if ( 0 == strcmp( argv[i], "-repeat" ) && i+1 < argc ) { repeat = atoi( argv[++i] ); }
+  }
+
+  Proton proton(1000.0);
+
+  BBLens lens( "IP", 1.0, 1.0e11, proton.refGamma() );
+
+  std::vector<double> sigmas( 3, 0.0 );
+  sigmas[0] = 1.0e-3;
+  sigmas[1] = 0.4e-3;
+  lens.setSigmas( sigmas );
+
+  ParticleBunch bunch( proton );
+
+  RandomStreams const streams( 2718 );
+
+  for ( int j=0; j<n; ++j ) {
+    RandomStream rnd = streams.stream( j );
+    Proton p( proton );
+    p.x ( 1.0e-3*rnd.normal() );
+    p.y ( 0.4e-3*rnd.normal() );
+    bunch.append( p );
+  }
+
+  BunchArrays arrays( bunch );
+
+  cout << n << " particles; throughput [ particles/s ]" << endl;
+  cout << endl;
+
+  // ------------------------------
+  // complex error function
+  // ------------------------------
+
+  std::vector<double> x( n );
+  std::vector<double> y( n );
+  std::vector<double> w_re( n );
+  std::vector<double> w_im( n );
+
+  for ( int j=0; j<n; ++j ) {
+    x[j] = std::abs( arrays[Particle::i_x][j] )/1.3e-3;
+    y[j] = std::abs( arrays[Particle::i_y][j] )/1.3e-3;
+  }
+
+  clock_t start = clock();
+  for ( int k=0; k<repeat; ++k ) {
+    for ( int j=0; j<n; ++j ) {
+      std::complex<double> const v = w( std::complex<double>( x[j], y[j] ) );
+      w_re[j] = real( v );
+      w_im[j] = imag( v );
+    }
+  }
+  double const t_scalar = seconds( start );
+
+  start = clock();
+  for ( int k=0; k<repeat; ++k ) {
+    w( n, &x[0], &y[0], &w_re[0], &w_im[0] );
+  }
+  double const t_batched = seconds( start );
+
+  report( "w(z), scalar",  n, repeat, t_scalar  );
+  report( "w(z), batched", n, repeat, t_batched );
+
+  // ------------------------------
+  // kicks
+  // ------------------------------
+
+  start = clock();
+  for ( int k=0; k<repeat; ++k ) {
+    for ( ParticleBunch::iterator it = bunch.begin(); it != bunch.end(); ++it ) {
+      lens.propagate( *it );
+    }
+  }
+  double const t_single = seconds( start );
+
+  start = clock();
+  for ( int k=0; k<repeat; ++k ) {
+    lens.propagate( bunch );
+  }
+  double const t_bunch = seconds( start );
+
+  start = clock();
+  for ( int k=0; k<repeat; ++k ) {
+    lens.propagate( arrays );
+  }
+  double const t_arrays = seconds( start );
+
+  report( "kick, particle by particle", n, repeat, t_single );
+  report( "kick, ParticleBunch",        n, repeat, t_bunch  );
+  report( "kick, BunchArrays",          n, repeat, t_arrays );
+
+  return 0;
+}
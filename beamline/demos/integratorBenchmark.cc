@@ -0,0 +1,144 @@
+/*
+**
+** Benchmark program:
+**
+** Compares the accuracy and cost of the integrators available
+** to the thick quadrupoles and sextupoles (quadrupole::setIntegrator,
+** sextupole::setIntegrator) on a line of FODO cells:
+**
+**   - the original propagators (order 0);
+**   - the symplectic schemes of order 2, 4, 6 and 8, with
+**     several numbers of steps.
+**
+** A bunch is tracked as BunchArrays through the line with each
+** setting. Prints the CPU time per turn, the number of kicks per
+** magnet and the largest deviation from a reference obtained with
+** the 8th order scheme and many steps.
+**
+** Usage: integratorBenchmark [-cells n] [-particles n] [-turns n]
+**
+*/
+
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <ctime>
+
+#include <integrator/SymplecticScheme.h>
+#include <beamline/beamline.h>
+#include <beamline/Drift.h>
+#include <beamline/quadrupole.h>
+#include <beamline/sextupole.h>
+#include <beamline/Particle.h>
+#include <beamline/BunchArrays.h>
+
+using namespace std;
+
+namespace {
+
+double const energy = 100.0;
+
+void setIntegrator( beamline& bml, int order, int n )
+{
+  for ( beamline::deep_iterator it = bml.deep_begin(); it != bml.deep_end(); ++it ) {
+    if ( quadrupole* q = dynamic_cast<quadrupole*>( (*it).get() ) ) { q->setIntegrator( order, n ); }
+    if ( sextupole*  s = dynamic_cast<sextupole*> ( (*it).get() ) ) { s->setIntegrator( order, n ); }
+  }
+}
+
+BunchArrays makeBunch( Particle const& reference, int n )
+{
+  BunchArrays b( reference, n );
+  for ( int j=0; j<n; ++j ) {
+    double const a = ( 2.0*M_PI*j )/n;
+    b[Particle::i_x]  [j] = 2.0e-3*cos( a );
+    b[Particle::i_y]  [j] = 2.0e-3*sin( a );
+    b[Particle::i_npx][j] = 1.0e-4*sin( 3.0*a );
+    b[Particle::i_ndp][j] = 1.0e-3*cos( 2.0*a );
+  }
+  return b;
+}
+
+double maxdiff( BunchArrays const& a, BunchArrays const& b )
+{
+  double d = 0.0;
+  for ( int i=0; i<6; ++i ) {
+    if ( i == Particle::i_cdt ) continue;
+    for ( int j=0; j<a.size(); ++j ) { d = std::max( d, std::abs( a[i][j] - b[i][j] ) ); }
+  }
+  return d;
+}
+
+} // namespace
+
+int main( int argc, char** argv )
+{
+  int ncells     = 20;
+  int nparticles = 10000;
+  int nturns     = 1;
+
+  for( int i = 1; i < argc; ++i ) {
+    if(      0 == strcmp( argv[i], "-cells"     ) && i+1 < argc ) { ncells     = atoi( argv[++i] ); }
+    else if( 0 == strcmp( argv[i], "-particles" ) && i+1 < argc ) { nparticles = atoi( argv[++i] ); }
+    else if( 0 == strcmp( argv[i], "-turns"     ) && i+1 < argc ) { nturns     = atoi( argv[++i] ); }
+    else {
+      cerr << "Usage: " << argv[0] << " [-cells n] [-particles n] [-turns n]" << endl;
+      return 1;
+    }
+  }
+
+  Proton pr( energy );
+  double const brho = pr.refBrho();
+
+  Drift      O ( "O",  1.5 );
+  quadrupole F ( "F",  1.0,  0.3*brho );
+  quadrupole D ( "D",  1.0, -0.3*brho );
+  sextupole  SF( "SF", 0.5,  2.0*brho );
+  sextupole  SD( "SD", 0.5, -3.0*brho );
+
+  beamline line( "LINE" );
+  for ( int i=0; i<ncells; ++i ) {
+    line.append( F ); line.append( O ); line.append( SF ); line.append( O );
+    line.append( D ); line.append( O ); line.append( SD ); line.append( O );
+  }
+  line.registerReference( pr );
+
+  BunchArrays const initial = makeBunch( pr, nparticles );
+
+  setIntegrator( line, 8, 32 );
+
+  BunchArrays reference( initial );
+  for ( int t=0; t<nturns; ++t ) { line.propagate( reference ); }
+
+  struct Setting { int order; int n; };
+
+  Setting const settings[] = { {0, 4}, {2, 1}, {2, 4}, {2, 16}, {4, 1}, {4, 4}, {6, 1}, {6, 2}, {8, 1} };
+  int const nsettings = sizeof(settings)/sizeof(Setting);
+
+  cout << "cells: " << ncells << "   particles: " << nparticles << "   turns: " << nturns << endl;
+  cout << "order  steps  kicks per quadrupole  time/turn [s]  max deviation" << endl;
+
+  for ( int k=0; k<nsettings; ++k ) {
+
+    setIntegrator( line, settings[k].order, settings[k].n );
+
+    int const kicks = ( settings[k].order == 0 ) ? settings[k].n
+                                                 : settings[k].n*SymplecticScheme::forOrder( settings[k].order ).kicksPerStep();
+
+    BunchArrays b( initial );
+
+    clock_t const start = clock();
+    for ( int t=0; t<nturns; ++t ) { line.propagate( b ); }
+    double const time = double( clock() - start )/CLOCKS_PER_SEC/nturns;
+
+    cout << setw(5)  << settings[k].order
+         << setw(7)  << settings[k].n
+         << setw(21) << kicks
+         << setw(15) << time
+         << setw(15) << maxdiff( b, reference ) << endl;
+  }
+
+  return 0;
+}
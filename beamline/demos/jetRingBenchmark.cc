@@ -0,0 +1,132 @@
+/*
+**
+** Benchmark program:
+**
+** Propagates a JetProton once around a ring of FODO cells
+** with bends and sextupoles, first with the sparse
+** multiplication kernels only and then with the dense
+** kernels enabled (at the default fill threshold).
+** Prints the CPU time of each pass and the largest
+** difference between the coefficients of the two one-turn
+** maps.
+**
+** Usage: jetRingBenchmark [-order n] [-cells n] [-repeat n] [-fill x]
+**
+**   -fill x : fill threshold for the dense kernels (default: the 
+**             environment default)
+**
+*/
+
+#include <iostream>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <ctime>
+
+#include <mxyzptlk/Jet.h>
+#include <mxyzptlk/Mapping.h>
+#include <beamline/JetParticle.h>
+#include <beamline/Particle.h>
+#include <beamline/beamline.h>
+#include <beamline/Drift.h>
+#include <beamline/quadrupole.h>
+#include <beamline/sextupole.h>
+#include <beamline/sbend.h>
+
+using namespace std;
+
+namespace {
+
+double trackRing( beamline& ring, Proton const& proton, EnvPtr<double> const& env, int repeat, Mapping& map )
+{
+  clock_t const start = clock();
+
+  for( int k = 0; k < repeat; ++k ) {
+    JetProton jp( proton, env );
+    ring.propagate( jp );
+    map = jp.state();
+  }
+
+  return double( clock() - start )/CLOCKS_PER_SEC/repeat;
+}
+
+double maxDifference( Mapping const& a, Mapping const& b )
+{
+  // largest difference between coefficients, relative to the
+  // largest coefficient of the same component
+
+  double diff = 0.0;
+
+  for( int i = 0; i < a.Dim(); ++i ) {
+
+    double scale = 0.0;
+    for( Jet::const_iterator it = a[i].begin(); it != a[i].end(); ++it ) {
+      scale = std::max( scale, std::abs( it->value_ ) );
+    }
+
+    Jet d = a[i] - b[i];
+    for( Jet::const_iterator it = d.begin(); it != d.end(); ++it ) {
+      diff = std::max( diff, std::abs( it->value_ )/scale );
+    }
+  }
+  return diff;
+}
+
+} // anonymous namespace
+
+int main( int argc, char** argv )
+{
+ int    order     = 5;
+ int    ncells    = 24;
+ int    repeat    = 1;
+ double threshold = Jet__environment::denseThreshold();
+
+ for( int i = 1; i < argc; ++i ) {
+   if      ( 0 == strcmp( argv[i], "-order"  ) && i+1 < argc ) { order  = atoi( argv[++i] ); }
+   else if ( 0 == strcmp( argv[i], "-cells"  ) && i+1 < argc ) { ncells = atoi( argv[++i] ); }
+   else if ( 0 == strcmp( argv[i], "-repeat" ) && i+1 < argc ) { repeat = atoi( argv[++i] ); }
+   else if ( 0 == strcmp( argv[i], "-fill"   ) && i+1 < argc ) { threshold = atof( argv[++i] ); }
+ }
+
+ Proton proton( 100.0 );
+ double const brho = proton.refBrho();
+
+ createStandardEnvironments( order );  // real and complex environments; the latter are used by the bend propagators
+ EnvPtr<double> env = Jet__environment::topEnv();
+
+ // A ring of FODO cells; the two sextupole families
+ // make the one-turn map nonlinear.
+
+ double const angle = 2.0*M_PI/( 2*ncells );
+
+ beamline ring( "ring" );
+ for( int k = 0; k < ncells; ++k ) {
+   ring.append( quadrupole ( "QF", 0.5,   0.5*brho ) );
+   ring.append( Drift      ( "D",  0.5 ) );
+   ring.append( sextupole  ( "SF", 0.2,   1.0*brho ) );
+   ring.append( sbend      ( "B",  3.0,   brho*angle/3.0, angle ) );
+   ring.append( Drift      ( "D",  0.5 ) );
+   ring.append( quadrupole ( "QD", 0.5,  -0.5*brho ) );
+   ring.append( Drift      ( "D",  0.5 ) );
+   ring.append( sextupole  ( "SD", 0.2,  -2.0*brho ) );
+   ring.append( sbend      ( "B",  3.0,   brho*angle/3.0, angle ) );
+   ring.append( Drift      ( "D",  0.5 ) );
+ }
+
+ Mapping sparseMap;
+ Mapping denseMap;
+
+ Jet__environment::setDenseThreshold( 2.0 );  // disables the dense kernels
+ double const tsparse = trackRing( ring, proton, env, repeat, sparseMap );
+
+ Jet__environment::setDenseThreshold( threshold );
+ double const tdense  = trackRing( ring, proton, env, repeat, denseMap );
+
+ cout << "order " << order << ", " << 10*ncells << " elements" << endl;
+ cout << "sparse kernels            : " << tsparse << " s/turn" << endl;
+ cout << "dense kernels (fill >= " << threshold << "): " << tdense << " s/turn" << endl;
+ cout << "speedup                   : " << tsparse/tdense << endl;
+ cout << "max relative difference   : " << maxDifference( sparseMap, denseMap ) << endl;
+
+ return 0;
+}
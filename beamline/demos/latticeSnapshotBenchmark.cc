@@ -0,0 +1,144 @@
+/*
+**
+** Benchmark program:
+**
+** Compares the time needed to obtain a registered ring of
+** FODO cells (reference times set)
+**
+**   - from a MAD8 file, with MAD8Factory;
+**   - from the same file, with XSIFFactory;
+**   - from a BeamlineSnapshot of the ring.
+**
+** The lattice files and the snapshot are written to the
+** current directory and removed afterwards. Prints the CPU
+** time of each method per load, and the number of elements
+** obtained.
+**
+** Usage: latticeSnapshotBenchmark [-cells n] [-repeat n]
+**
+**   -cells n  : number of cells; 10 elements per cell
+**               (default: 2000)
+**
+*/
+
+#include <iostream>
+#include <fstream>
+#include <cstdlib>
+#include <cstdio>
+#include <cstring>
+#include <cmath>
+#include <ctime>
+
+#include <beamline/beamline.h>
+#include <beamline/Particle.h>
+#include <beamline/BeamlineSnapshot.h>
+#include <bmlfactory/MAD8Factory.h>
+#include <parsers/xsif/XSIFFactory.h>
+
+using namespace std;
+
+namespace {
+
+char const* const mad8_file     = "latticeSnapshotBenchmark.lat";
+char const* const xsif_file     = "latticeSnapshotBenchmark.xsif";
+char const* const snapshot_file = "latticeSnapshotBenchmark.bml";
+
+void writeLattice( char const* filename, int ncells )
+{
+  // the MAD8 and XSIF syntax coincide for these definitions
+
+  ofstream os( filename );
+  os.precision( 17 );
+
+  os << "O:  DRIFT,      L=1.5"                                   << endl;
+  os << "QF: QUADRUPOLE, L=0.5, K1=0.12"                          << endl;
+  os << "QD: QUADRUPOLE, L=0.5, K1=-0.12"                         << endl;
+  os << "SF: SEXTUPOLE,  L=0.2, K2=0.4"                           << endl;
+  os << "B:  SBEND,      L=3.0, ANGLE=" << M_PI/ncells            << endl;
+  os << "M:  MONITOR"                                             << endl;
+  os << "CELL: LINE=(QF, O, SF, B, O, M, QD, O, B, O)"            << endl;
+  os << "RING: LINE=(" << ncells << "*CELL)"                      << endl;
+  os << "RETURN"                                                  << endl;
+}
+
+template <typename Factory>
+double loadWithFactory( char const* filename, Proton const& proton, int repeat, int& nelm )
+{
+  clock_t const start = clock();
+
+  for( int k = 0; k < repeat; ++k ) {
+    Factory factory( filename );
+    BmlPtr ring = factory.create_beamline( "RING", proton.refBrho() );
+    ring->setLineMode( beamline::ring );
+    ring->registerReference( proton );
+    nelm = ring->countHowManyDeeply();
+  }
+
+  return double( clock() - start )/CLOCKS_PER_SEC/repeat;
+}
+
+double loadSnapshot( int repeat, int& nelm )
+{
+  clock_t const start = clock();
+
+  for( int k = 0; k < repeat; ++k ) {
+    BeamlineSnapshot snapshot( snapshot_file );
+    BmlPtr ring = snapshot.instantiate();
+    nelm = ring->countHowManyDeeply();
+  }
+
+  return double( clock() - start )/CLOCKS_PER_SEC/repeat;
+}
+
+} // namespace
+
+int main( int argc, char** argv )
+{
+  int ncells = 2000;
+  int repeat = 5;
+
+  for( int i = 1; i < argc; ++i ) {
+    if(      0 == strcmp( argv[i], "-cells"  ) && i+1 < argc ) { ncells = atoi( argv[++i] ); }
+    else if( 0 == strcmp( argv[i], "-repeat" ) && i+1 < argc ) { repeat = atoi( argv[++i] ); }
+    else {
+      cerr << "Usage: " << argv[0] << " [-cells n] [-repeat n]" << endl;
+      return 1;
+    }
+  }
+
+  Proton proton( 100.0 );
+
+  writeLattice( mad8_file, ncells );
+  writeLattice( xsif_file, ncells );
+
+  // the snapshot is taken from the line built by MAD8Factory
+
+  {
+    MAD8Factory factory( mad8_file );
+    BmlPtr ring = factory.create_beamline( "RING", proton.refBrho() );
+    ring->setLineMode( beamline::ring );
+    ring->registerReference( proton );
+    BeamlineSnapshot::write( *ring, snapshot_file );
+  }
+
+  int n_mad8 = 0;
+  int n_xsif = 0;
+  int n_snap = 0;
+
+  double const t_mad8 = loadWithFactory<MAD8Factory>( mad8_file, proton, repeat, n_mad8 );
+  double const t_xsif = loadWithFactory<XSIFFactory>( xsif_file, proton, repeat, n_xsif );
+  double const t_snap = loadSnapshot( repeat, n_snap );
+
+  cout << "cells: " << ncells << "   repeat: " << repeat << endl;
+  cout << "MAD8Factory       : " << t_mad8 << " s  (" << n_mad8 << " elements)" << endl;
+  cout << "XSIFFactory       : " << t_xsif << " s  (" << n_xsif << " elements)" << endl;
+  cout << "BeamlineSnapshot  : " << t_snap << " s  (" << n_snap << " elements)" << endl;
+  cout << "speedup vs MAD8   : " << t_mad8/t_snap << endl;
+  cout << "speedup vs XSIF   : " << t_xsif/t_snap << endl;
+
+  remove( mad8_file );
+  remove( xsif_file );
+  remove( snapshot_file );
+
+  return 0;
+}
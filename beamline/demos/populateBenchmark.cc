@@ -0,0 +1,131 @@
+/*
+**
+** Benchmark program:
+**
+** Measures the time needed to populate the three phase space
+** planes of a bunch with a Gaussian distribution
+**
+**   - from drand48(), through a boost::function<double()>;
+**   - from counter-based random streams, with 1, 2, 4, ...
+**     threads, up to the number given with -threads.
+**
+** Prints the wall clock time of each method and the speedup
+** with respect to drand48(). The bunches populated from the
+** streams are checked to be identical whatever the number of
+** threads.
+**
+** Usage: populateBenchmark [-n n] [-threads n]
+**
+**   -n n        : number of particles (default: 1000000)
+**   -threads n  : maximum number of threads (default: 0,
+**                 one per hardware thread)
+**
+*/
+
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+#include <cstring>
+
+#include <boost/function.hpp>
+#include <boost/date_time/posix_time/posix_time.hpp>
+
+#include <basic_toolkit/RandomStreams.h>
+#include <beamline/Particle.h>
+#include <beamline/TBunch.h>
+#include <beamline/beamline.h>
+
+using namespace std;
+
+namespace {
+
+double const beta    = 10.0;
+double const alpha   = -1.5;
+double const epsilon = 1.0e-6;
+
+double seconds( boost::posix_time::ptime const& start )
+{
+  return ( boost::posix_time::microsec_clock::universal_time() - start ).total_microseconds()*1.0e-6;
+}
+
+bool identical( ParticleBunch const& a, ParticleBunch const& b )
+{
+  ParticleBunch::const_iterator jt = b.begin();
+  for ( ParticleBunch::const_iterator it = a.begin(); it != a.end(); ++it, ++jt ) {
+    for ( int i=0; i<Particle::PSD; ++i ) {
+      if ( memcmp( &it->state()[i], &jt->state()[i], sizeof(double) ) != 0 ) return false;
+    }
+  }
+  return true;
+}
+
+} // namespace
+
+int main( int argc, char** argv )
+{
+  int n        = 1000000;
+  int nthreads = 0;
+
+  for ( int i=1; i<argc; ++i ) {
+    if      ( 0 == strcmp( argv[i], "-n"       ) && i+1 < argc ) { n        = atoi( argv[++i] ); }
+    else if ( 0 == strcmp( argv[i], "-threads" ) && i+1 < argc ) { nthreads = atoi( argv[++i] ); }
+  }
+
+  beamline::setNumberOfThreads( nthreads );
+  int const maxthreads = beamline::numberOfThreads();
+
+  Proton proton(100.0);
+
+  // ------------------
+  // drand48()
+  // ------------------
+
+  ParticleBunch serial( proton, n );
+
+  srand48( 12345 );
+  boost::function<double()> rnd = &drand48;
+
+  boost::posix_time::ptime start = boost::posix_time::microsec_clock::universal_time();
+
+  serial.populateCSGaussian( ParticleBunch::cdt_ndp, beta, alpha, epsilon, rnd, 3.0 );
+  serial.populateCSGaussian( ParticleBunch::x_npx,   beta, alpha, epsilon, rnd, 3.0 );
+  serial.populateCSGaussian( ParticleBunch::y_npy,   beta, alpha, epsilon, rnd, 3.0 );
+
+  double const t_drand48 = seconds( start );
+
+  cout << n << " particles; wall clock times [ s ]" << endl;
+  cout << endl;
+  cout << setw(24) << "drand48"  << setw(12) << t_drand48 << endl;
+
+  // ------------------
+  // streams
+  // ------------------
+
+  RandomStreams const streams( 12345 );
+
+  ParticleBunch reference( proton, n );
+  ParticleBunch bunch    ( proton, n );
+
+  for ( int k=1; ; k = std::min( 2*k, maxthreads ) ) {
+
+    beamline::setNumberOfThreads( k );
+
+    ParticleBunch& b = ( k == 1 ) ? reference : bunch;
+
+    start = boost::posix_time::microsec_clock::universal_time();
+
+    b.populateCSGaussian( ParticleBunch::cdt_ndp, beta, alpha, epsilon, streams, 3.0 );
+    b.populateCSGaussian( ParticleBunch::x_npx,   beta, alpha, epsilon, streams, 3.0 );
+    b.populateCSGaussian( ParticleBunch::y_npy,   beta, alpha, epsilon, streams, 3.0 );
+
+    double const t = seconds( start );
+
+    cout << setw(16) << "streams, " << setw(2) << k << ( k == 1 ? " thread " : " threads" )
+         << setw(12) << t << setw(12) << t_drand48/t
+         << ( ( k == 1 || identical( reference, bunch ) ) ? "" : "   *** bunch differs from 1 thread ***" ) << endl;
+
+    if ( k == maxthreads ) break;
+  }
+
+  return 0;
+}
@@ -47,6 +47,7 @@ public:
 
   void  operator()(  BmlnElmnt const& elm,         Particle& p);
   void  operator()(  BmlnElmnt const& elm,      JetParticle& p); 
+  void  operator()(  BmlnElmnt const& elm,      BunchArrays& b); 
 
   bool hasAlignment() const; 
   void setAlignment( Vector const& offset, Vector const& angles, bool relative=false);
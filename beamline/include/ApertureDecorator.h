@@ -46,13 +46,19 @@ public:
 
   void  operator()(  BmlnElmnt const& elm,         Particle& p);
   void  operator()(  BmlnElmnt const& elm,      JetParticle& p); 
+  void  operator()(  BmlnElmnt const& elm,    ParticleBunch& b); 
+  void  operator()(  BmlnElmnt const& elm,      BunchArrays& b); 
 
   bool hasAperture() const;
   void setAperture( BmlnElmnt::aperture_t const, double const& hor, double const& ver );
 
+  boost::tuple<BmlnElmnt::aperture_t, double, double>  aperture()   const; 
+
  private:
   
   bool  lost ( double const& x, double const& y) const;
+  void  flagLosses( ParticleBunch& b ) const;
+  void  flagLosses( BunchArrays&   b ) const;
 
   BmlnElmnt::aperture_t type_;
   double                hor_;
@@ -85,6 +85,8 @@ struct EVector_t<double> {
 
 class DLLEXPORT BBLens : public BmlnElmnt {
 
+  friend class BeamlineSnapshot;
+
   class Propagator;
 
 public:
@@ -131,6 +133,11 @@ public:
                                          Q is the line density of charge [C/m] (in
                                          rest frame). */
 
+  void NormalizedEField( int n, double const* x, double const* y, double* ex, double* ey ) const; 
+                                      /* the same, for n points at once. The complex
+                                         error function of all the points is evaluated
+                                         in one (vectorized) pass. */
+
 
   void accept( BmlVisitor& v );            
   void accept( ConstBmlVisitor& v ) const; 
@@ -171,6 +178,12 @@ double BBLens::toDouble( double const& value);
 template <>
 double BBLens::toDouble ( Jet const& value); 
 
+// the field at a single point is evaluated by the n point version, so that
+// particles and bunches receive the same kicks.
+
+template <>
+EVector_t<double>::Type BBLens::NormalizedEField( double const& x, double const& y ) const;
+
 #ifndef  BEAMLINE_EXPLICIT_TEMPLATES
 #include <beamline/BBLens.tcc>
 #endif
@@ -120,11 +120,15 @@ typename EVector_t<T>::Type BBLens::NormalizedEField( T const& arg_x, T const& a
 
   if (!normal) { std::swap (x,y);  std::swap ( sigmaX, sigmaY); }
 
+  // The formula holds in the first quadrant; the field 
+  // is odd in x and in y. The signs are those of the
+  // (possibly swapped) coordinates.
+
   double sgnx = 1.0; 
   double sgny = 1.0; 
 
-  if( toDouble(arg_x) < 0.0 ) x = -x; sgnx = -sgnx; 
-  if( toDouble(arg_y) < 0.0 ) y = -y; sgny = -sgny; 
+  if( toDouble(x) < 0.0 ) { x = -x; sgnx = -sgnx; }
+  if( toDouble(y) < 0.0 ) { y = -y; sgny = -sgny; }
 
 
   // The calculation ...
@@ -51,6 +51,8 @@ class BBLens::Propagator : public BasePropagator {
 
   void  operator()( BmlnElmnt const& elm,       Particle&   p);
   void  operator()( BmlnElmnt const& elm,    JetParticle&   p);
+  void  operator()( BmlnElmnt const& elm,  ParticleBunch&   b);
+  void  operator()( BmlnElmnt const& elm,    BunchArrays&   b);
 
 };
 
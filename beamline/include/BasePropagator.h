@@ -47,6 +47,7 @@
 #include <beamline/BmlPtr.h>
 
 class BasePropagator;
+class BunchArrays;
 typedef boost::shared_ptr<BasePropagator> PropagatorPtr; 
 
 #include <beamline/ParticleFwd.h>
@@ -83,6 +84,8 @@ struct PropagatorTraits<JetParticle> {
 
 class BasePropagator {
 
+  friend class CompiledLattice;
+
  public:
   
    BasePropagator(); 
@@ -105,8 +108,11 @@ class BasePropagator {
    virtual void  operator()(  BmlnElmnt const& elm,      JetParticle& p) = 0; 
    virtual void  operator()(  BmlnElmnt const& elm,    ParticleBunch& b);  
    virtual void  operator()(  BmlnElmnt const& elm, JetParticleBunch& b);  
+   virtual void  operator()(  BmlnElmnt const& elm,      BunchArrays& b);  
 
    virtual  bool isComposite() const; 
+   virtual  bool isCollective() const;   // true if the bunch operator() is not equivalent to 
+                                         // propagating each particle independently 
 
    virtual  bool hasAlignment() const; 
    virtual  void setAlignment( Vector const& translation, Vector const& rotation, bool relative=false);
@@ -53,7 +53,27 @@ class beamline::Propagator: public BasePropagator {
   void  operator()( BmlnElmnt const& elm,               JetParticle& p);
   void  operator()( BmlnElmnt const& elm,             ParticleBunch& p);
   void  operator()( BmlnElmnt const& elm,          JetParticleBunch& p);
+  void  operator()( BmlnElmnt const& elm,               BunchArrays& b);
 
+  //-----------------------------------------------------------------------------
+  // Bunches (ParticleBunch and BunchArrays) may be tracked by several threads. 
+  // The particles are split into one chunk per thread, and each thread pushes 
+  // its chunk through a run of consecutive elements without synchronizing.
+  // The threads are synchronized before a collective element (see BmlnElmnt::isCollective()),
+  // which is applied to the whole bunch. The threads are those of WorkerPool::instance(); 
+  // they are started once and reused by every call. Since particles are independent between
+  // collective elements, the results are identical to those of serial tracking.
+  //
+  // n = 1 (the default) : serial tracking
+  // n = 0               : one thread per hardware thread 
+  //-----------------------------------------------------------------------------
+
+  static void setNumberOfThreads( int n );
+  static int     numberOfThreads();
+
+ private:
+
+  static int nthreads_;
  
 };
 
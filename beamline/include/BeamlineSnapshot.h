@@ -0,0 +1,111 @@
+/*************************************************************************
+**************************************************************************
+**************************************************************************
+******
+******  BEAMLINE:  C++ objects for design and analysis
+******             of beamlines, storage rings, and
+******             synchrotrons.
+******
+******  File:      BeamlineSnapshot.h
+******
+******  Copyright Fermi Research Alliance / Fermilab
+******            All Rights Reserved
+*****
+******  Usage, modification, and redistribution are subject to terms
+******  of the License supplied with this software.
+******
+******  Software and documentation created under
+******  U.S. Department of Energy Contract No. DE-AC02-07CH11359
+******  The U.S. Government retains a world-wide non-exclusive,
+******  royalty-free license to publish or reproduce documentation
+******  and software for U.S. Government purposes. This software
+******  is protected under the U.S. and Foreign Copyright Laws.
+******
+**************************************************************************
+**************************************************************************
+*************************************************************************/
+
+//------------------------------------------------------------------------------------------
+//
+// A BeamlineSnapshot is a binary image of a fully instantiated beamline: element types,
+// names and tags, lengths, strengths, type specific attributes (bend and edge angles,
+// multipoles, rf parameters, integrator settings, slot frames ...), alignment, apertures,
+// reference times and nested lines. Every element type created by the MAD8 and XSIF
+// factories can be stored.
+//
+// write() stores a line in a file. The constructor memory-maps a file and checks its
+// header; instantiate() then builds a new beamline directly from the mapped records,
+// with no parsing and no reference propagation. Several processes loading the same
+// snapshot share the mapped pages.
+//
+// The file consists of a header followed by four arrays:
+//
+//   records     one fixed size record per element or line, in pre-order
+//   children    for each line, the record indices of its elements
+//   parameters  the type specific attributes of the elements
+//   strings     the names and tags, null terminated
+//
+// The format is versioned. A file written with another version, or on a machine with
+// a different byte order, is rejected. Only the element types known to the format can
+// be stored; write() throws on any other type. Attributes attached with
+// BmlnElmnt::operator[] are not stored. An element appended to several lines is
+// stored (and instantiated) once per occurrence.
+//
+//------------------------------------------------------------------------------------------
+
+#ifndef BEAMLINESNAPSHOT_H
+#define BEAMLINESNAPSHOT_H
+
+#include <string>
+#include <cstddef>
+#include <boost/cstdint.hpp>
+#include <basic_toolkit/globaldefs.h>
+#include <beamline/ElmPtr.h>
+#include <beamline/BmlPtr.h>
+
+class beamline;
+class BmlnElmnt;
+
+class DLLEXPORT BeamlineSnapshot {
+
+ public:
+
+  static boost::uint32_t const format_version;
+
+  static void write( beamline const& bml, std::string const& filename );
+
+  explicit BeamlineSnapshot( std::string const& filename );
+ ~BeamlineSnapshot();
+
+  BmlPtr       instantiate()       const;
+
+  int          numberOfRecords()   const;      // elements and lines, nested lines included
+  std::string  name()              const;      // name of the stored line
+
+ private:
+
+  struct Header;
+  struct Record;
+  struct Writer;
+
+  static boost::uint32_t  store  ( BmlnElmnt const& elm, Writer& w );
+  static void             restore( BmlnElmnt& elm, Record const& r, double const* p );
+
+  ElmPtr       instantiate( Record const& r ) const;
+  char const*  string( boost::uint32_t offset ) const;
+
+  std::string                filename_;
+  void*                      map_;
+  std::size_t                size_;
+
+  Header const*              header_;
+  Record const*              records_;
+  boost::uint32_t const*     children_;
+  double const*              parameters_;
+  char const*                strings_;
+
+  BeamlineSnapshot( BeamlineSnapshot const& );
+  BeamlineSnapshot& operator=( BeamlineSnapshot const& );
+};
+
+#endif // BEAMLINESNAPSHOT_H
@@ -56,6 +56,7 @@ class DLLEXPORT Bend : public BmlnElmnt {
   class bend_core_access;
 
   friend class  bend_core_access; 
+  friend class  CompiledLattice; 
    
 public:
 
@@ -54,6 +54,11 @@ class Bend::Propagator: public BasePropagator {
 
   void  operator()(  BmlnElmnt const& elm,            Particle& p);
   void  operator()(  BmlnElmnt const& elm,         JetParticle& p);
+  void  operator()(  BmlnElmnt const& elm,         BunchArrays& b);
+
+  double               const& dphi()      const { return dphi_;      }
+  std::complex<double> const& propPhase() const { return propPhase_; }
+  std::complex<double> const& propTerm()  const { return propTerm_;  }
 
  private:
   
@@ -101,6 +101,7 @@ class Alignment;
 class Aperture;
 class sector;
 class BasePropagator;
+class BunchArrays;
 
 typedef boost::shared_ptr<beamline>        BmlPtr;
 typedef boost::shared_ptr<beamline const>  ConstBmlPtr;
@@ -112,6 +113,8 @@ class DLLEXPORT BmlnElmnt {
 
   friend class beamline; 
   friend class core_access; 
+  friend class CompiledLattice; 
+  friend class BeamlineSnapshot; 
 
  public:
  
@@ -247,11 +250,13 @@ public:
   void propagate(      JetParticle& p ) const;
   void propagate(    ParticleBunch& b ) const;
   void propagate( JetParticleBunch& b ) const;
+  void propagate(      BunchArrays& b ) const;
 
   void localPropagate(         Particle& p ) const;
   void localPropagate(      JetParticle& p ) const;
   void localPropagate(    ParticleBunch& b ) const;
   void localPropagate( JetParticleBunch& b ) const;
+  void localPropagate(      BunchArrays& b ) const;
 
   template  <typename Particle_t>
   void enterLocalFrame( Particle_t&  )   const;
@@ -277,6 +282,27 @@ public:
 
   void  rename        ( std::string const& name );  
 
+  // ... Every modifier that may change the way the element acts on a 
+  //     particle (length, strength, alignment, edge angles ...) increments 
+  //     the modification count. Clients caching results computed from 
+  //     an element (e.g. transfer matrices) compare counts to detect changes. 
+
+  unsigned long modificationCount() const { return modcount_; }
+
+  // ... The total number of modifications of all elements (beamlines 
+  //     included: inserting, appending or erasing an element counts as 
+  //     a modification of the line). If it has not changed, no element 
+  //     has been modified, and results cached from any line are valid.
+
+  static unsigned long modifications();
+
+  // ... Every element object (copies included) gets a serial number that 
+  //     is never reused, even after the element is destroyed. Together with 
+  //     the modification count, it identifies the state of an element; 
+  //     an address does not, since it may be reused by a new element.
+
+  unsigned long serial() const { return serial_; }
+
 
   double getReferenceTime() const;     
   void   setReferenceTime( double );               
@@ -296,6 +322,8 @@ public:
   virtual bool hasParallelFaces() const;
   virtual bool hasStandardFaces() const;
   virtual bool     isBeamline()   const;                   
+  virtual bool   isCollective()   const;     // true if the element acts on a bunch as a whole
+                                             // (e.g. wakes, monitors) rather than particle by particle
   virtual bool   isDriftSpace()   const = 0;
   virtual bool       isMagnet()   const = 0;
   virtual bool      isPassive()   const = 0;                   
@@ -318,6 +346,8 @@ protected:
 
   virtual void  propagateReference( Particle& p, double initialBhro, bool scaling );
 
+  void          markModified();
+
   std::string                        ident_;              // Name identifier of the element.
 
   double                             length_;             // Length of object [ meters ]
@@ -340,6 +370,11 @@ protected:
 
   PropagatorPtr                      propagator_;
 
+  unsigned long                      modcount_;         // incremented by markModified()
+  unsigned long                      serial_;           // never reused
+
+  static unsigned long               nextSerial();
+
 
 
 //||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
@@ -0,0 +1,171 @@
+/*************************************************************************
+**************************************************************************
+**************************************************************************
+******
+******  BEAMLINE:  C++ objects for design and analysis
+******             of beamlines, storage rings, and
+******             synchrotrons.
+******
+******  File:      BunchArrays.h
+******
+******  Copyright Fermi Research Alliance / Fermilab
+******            All Rights Reserved
+*****
+******  Usage, modification, and redistribution are subject to terms
+******  of the License supplied with this software.
+******
+******  Software and documentation created under
+******  U.S. Department of Energy Contract No. DE-AC02-07CH11359
+******  The U.S. Government retains a world-wide non-exclusive,
+******  royalty-free license to publish or reproduce documentation
+******  and software for U.S. Government purposes. This software
+******  is protected under the U.S. and Foreign Copyright Laws.
+******
+******
+******  BunchArrays: a structure-of-arrays (SoA) representation
+******  of a bunch of Particles.
+******
+******  The phase space coordinates of the bunch are stored in a
+******  single aligned block of memory, one contiguous array per
+******  coordinate (coordinate i of particle j is at data_[i*stride_+j]).
+******  A survival mask flags particles that have been lost; lost
+******  particles are left in place (so that indices remain stable)
+******  until compact() is called.
+******
+******  Propagators may provide an overload of operator() for BunchArrays
+******  that operates on the whole bunch with tight loops over contiguous
+******  arrays. Element types without a specialized overload fall back
+******  on the single Particle propagator.
+******
+******  A BunchArrays may also be constructed as a view of a contiguous
+******  range of particles of another one. A view shares the storage of
+******  its parent (which must outlive it) and cannot grow; it is used to
+******  hand out disjoint chunks of a bunch to concurrent threads.
+******
+******  NOTE: for the sake of vectorization, the array kernels do not
+******        test the survival mask. The coordinates of a lost particle
+******        are therefore not meaningful once it has been flagged.
+******
+**************************************************************************
+**************************************************************************
+*************************************************************************/
+#ifndef BUNCHARRAYS_H
+#define BUNCHARRAYS_H
+
+#include <basic_toolkit/globaldefs.h>
+#include <basic_toolkit/VectorFwd.h>
+#include <beamline/PhaseSpaceIndexing.h>
+#include <beamline/ParticleFwd.h>
+#include <beamline/ParticleBunchFwd.h>
+
+class DLLEXPORT BunchArrays : public PhaseSpaceIndexing {
+
+ public:
+
+  static int const alignment = 16;  // bytes; each coordinate array starts on this boundary
+
+  BunchArrays( Particle const& reference, int nparticles=0 );
+  explicit BunchArrays( ParticleBunch const& bunch );
+  BunchArrays( BunchArrays const& );
+  BunchArrays( BunchArrays& parent, int first, int last );  // view of particles [first,last) of parent
+ ~BunchArrays();
+
+  BunchArrays& operator=( BunchArrays const& );
+
+  // transfer to/from a conventional (AoS) bunch.
+  // Lost particles are transferred with their lost flag set.
+
+  void load ( ParticleBunch const& bunch );
+  void store( ParticleBunch&       bunch ) const;
+
+  void append( Particle const& p );
+  void append( Vector   const& state );
+
+  void getParticle( int j, Particle&       p ) const;  // p must be of the same type as the reference
+  void setParticle( int j, Particle const& p );
+
+  Particle const& getReferenceParticle() const;
+  void            setReferenceParticle( Particle const& p );
+
+  double  Intensity() const;      // actual population, as opposed to no of pseudo-particles
+  void setIntensity( double const& value );
+
+  int  size()       const;     // no of particles, including lost ones
+  int  survivors()  const;     // no of particles not flagged as lost
+  int  stride()     const;     // distance (in doubles) between two coordinate arrays
+  bool empty()      const;
+  bool isView()     const;
+
+  void reserve( int n );
+  void resize ( int n );       // new particles are zero-initialized and alive
+  void clear();
+  void compact();              // removes lost particles; indices of survivors change
+
+  double*        operator[]( int i );       // contiguous array for coordinate i
+  double const*  operator[]( int i ) const;
+
+  unsigned char*       alive();             // survival mask: 1 = alive, 0 = lost
+  unsigned char const* alive() const;
+
+  bool isLost ( int j ) const;
+  void setLost( int j, bool lost=true );
+
+ private:
+
+  void reallocate( int capacity );
+
+  Particle*        reference_;   // pointer to preserve dynamic type
+  double           intensity_;
+  int              size_;
+  int              stride_;      // multiple of alignment/sizeof(double)
+  int              capacity_;    // == stride_, except for views
+  double*          data_;        // BMLN_dynDim arrays of length stride_
+  unsigned char*   alive_;
+  bool             view_;        // storage is owned by another BunchArrays
+
+};
+
+//-----------------------------------------------------------------------------------
+// inline members
+//-----------------------------------------------------------------------------------
+
+inline int BunchArrays::size() const
+{ return size_; }
+
+inline int BunchArrays::stride() const
+{ return stride_; }
+
+inline bool BunchArrays::empty() const
+{ return (size_ == 0); }
+
+inline bool BunchArrays::isView() const
+{ return view_; }
+
+inline double* BunchArrays::operator[]( int i )
+{ return data_ + i*stride_; }
+
+inline double const* BunchArrays::operator[]( int i ) const
+{ return data_ + i*stride_; }
+
+inline unsigned char* BunchArrays::alive()
+{ return alive_; }
+
+inline unsigned char const* BunchArrays::alive() const
+{ return alive_; }
+
+inline bool BunchArrays::isLost( int j ) const
+{ return !alive_[j]; }
+
+inline void BunchArrays::setLost( int j, bool lost )
+{ alive_[j] = (lost ? 0 : 1); }
+
+inline Particle const& BunchArrays::getReferenceParticle() const
+{ return *reference_; }
+
+inline double BunchArrays::Intensity() const
+{ return intensity_; }
+
+inline void BunchArrays::setIntensity( double const& value )
+{ intensity_ = value; }
+
+#endif // BUNCHARRAYS_H
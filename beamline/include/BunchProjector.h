@@ -31,6 +31,7 @@
 #define BUNCHPROJECTOR_H
 
 #include <vector>
+#include <basic_toolkit/WorkerPool.h>
 #include <beamline/ParticleFwd.h>
 
 
@@ -40,18 +41,69 @@ typedef TBunch<Particle> ParticleBunch;
 
 #include <beamline/Particle.h>
 
+//-------------------------------------------------------------------------------------
+// A BunchProjector deposits the particles of a bunch on a regular grid.
+//
+// - 1-D: the grid is along cdt. The line density (monopole) and the transverse 
+//        dipole densities are computed; they feed the wakefield convolutions.  
+// - 2-D: the grid is in the (x,y) plane.
+// - 3-D: the grid is in (x,y,cdt) space.
+//
+// Each particle is spread over the grid points near it by a shape function: 
+//
+// - ngp: nearest grid point (1 point per dimension)
+// - cic: cloud-in-cell, linear weighting (2 points per dimension)
+// - tsc: triangular-shaped cloud, quadratic weighting (3 points per dimension) 
+//
+// The densities are normalized w/r to the number of particles, i.e. the sum of 
+// the density samples times the cell volume is 1 when the grid covers the bunch. 
+//
+// Large bunches are deposited concurrently (see beamline::setNumberOfThreads()), 
+// each thread on a private grid; the private grids are then summed.   
+//-------------------------------------------------------------------------------------
+
 class BunchProjector {
 
  public:
 
+    enum Shape { ngp = 0, cic, tsc };
+
     BunchProjector( ParticleBunch& bunch, int nsamples=128 );  
     BunchProjector( ParticleBunch& bunch, double const& interval, int nbins=128 );  
+
+    explicit BunchProjector( int nsamples, Shape shape = ngp );   //  1-D, cdt 
+    BunchProjector( int nx, int ny,         Shape shape );        //  2-D, x y
+    BunchProjector( int nx, int ny, int nz, Shape shape );        //  3-D, x y cdt 
+
+    BunchProjector( BunchProjector const& other );
+
    ~BunchProjector();
 
+    BunchProjector& operator=( BunchProjector const& rhs );
+
+    // 1-D only. Projects bunch over an interval of the given length, starting at
+    // the first particle; the bunch is sorted longitudinally. The grids are reused; 
+    // no memory is allocated once their size has been set.
+
+    void project( ParticleBunch& bunch, double const& interval );
+
+    // Deposits bunch on a grid that spans it, leaving room at the edges for the 
+    // shape function. The bunch order is not modified.
+
+    void deposit( ParticleBunch const& bunch );
+
     std::vector<double>  const& monopoleLineDensity()  const;
     std::vector<double>  const& dipoleHorLineDensity() const;
     std::vector<double>  const& dipoleVerLineDensity() const;
 
+    std::vector<double>  const& density()              const;  // 1-D: monopole; 2-D, 3-D: x index varies fastest 
+
+    Shape  shape()                const { return shape_;         }
+    int    dimension()            const { return dim_;           }
+    int    gridSize   ( int d )   const { return n_[d];          }  // number of grid points along dimension d 
+    double gridMin    ( int d )   const { return min_[d];        }  // position of the first grid point 
+    double gridSpacing( int d )   const { return spacing_[d];    }
+
     void debug( ParticleBunch const& bunch) const;
 
     double cdt_min();
@@ -59,16 +111,38 @@ class BunchProjector {
 
  private:
 
+    void init( int dim, int nx, int ny, int nz, Shape shape );
     void populateHistograms( ParticleBunch& bunch, double const& smin, double const& smax, int nsamples );
+    void deposit( ParticleBunch const& bunch, int ncomponents, double* const* out );
+    void depositChunk( int j );
  
     double cdt_min_;
     double cdt_max_;
 
+    Shape                              shape_;
+    int                                dim_;
+    int                                n_[3];
+    double                             min_[3];
+    double                             spacing_[3];
+
     std::vector<double>                monopole_;
     std::vector<double>                dipole_hor_;
     std::vector<double>                dipole_ver_;
-
-
+    std::vector<double>                density_;      // 2-D, 3-D
+
+    //-----------------------------------------------------------------------
+    // Concurrent deposition. The tasks are bound to depositChunk() when the 
+    // number of chunks changes; the private grids and the pointers to their 
+    // components are resized when the number of chunks or the grid changes. 
+    // None of these is copied, since the tasks are bound to this. 
+    //-----------------------------------------------------------------------
+
+    std::vector<std::vector<double> >  private_;      // per thread grids 
+    std::vector<double*>               pointers_;     // chunk j: ncomponents_ pointers, from j*ncomponents_ 
+    std::vector<WorkerPool::Task>      tasks_;        // one task per chunk 
+    std::vector<int>                   bounds_;       // chunk j spans [ bounds_[j], bounds_[j+1] [ 
+    ParticleBunch const*               bunch_;        // set for the duration of a deposition 
+    int                                ncomponents_;
 
 };
 
@@ -0,0 +1,149 @@
+/*************************************************************************
+**************************************************************************
+**************************************************************************
+******
+******  BEAMLINE:  C++ objects for design and analysis
+******             of beamlines, storage rings, and
+******             synchrotrons.
+******
+******  File:      CompiledLattice.h
+******
+******  Copyright Fermi Research Alliance / Fermilab
+******            All Rights Reserved
+*****
+******  Usage, modification, and redistribution are subject to terms
+******  of the License supplied with this software.
+******
+******  Software and documentation created under
+******  U.S. Department of Energy Contract No. DE-AC02-07CH11359
+******  The U.S. Government retains a world-wide non-exclusive,
+******  royalty-free license to publish or reproduce documentation
+******  and software for U.S. Government purposes. This software
+******  is protected under the U.S. and Foreign Copyright Laws.
+******
+**************************************************************************
+**************************************************************************
+*************************************************************************/
+
+//------------------------------------------------------------------------------------------
+//
+// A CompiledLattice is a flattened form of a beamline, for repeated (multi-turn) tracking.
+//
+// compile() walks the line once. Nested beamlines are expanded and the elements are
+// translated into a contiguous array of records:
+//
+//  - drifts, thin quadrupoles, thin sextupoles and edges become records holding
+//    their length, strength and reference time;
+//  - the bend core of sbends and rbends becomes a record holding, in addition,
+//    the coefficients of its propagator;
+//  - quadrupoles, sextupoles, sbends, rbends, CF_sbends and CF_rbends are replaced
+//    by the records of their internal line, followed by their reference time
+//    correction. This does not apply to an element given another propagator
+//    (e.g. sbend::MADPropagator);
+//  - markers are dropped;
+//  - any other element (and any element with an aperture or an alignment decorator)
+//    is kept as a generic record, propagated by the element itself.
+//
+// The records are executed by a switch over the record type: there is no list traversal,
+// no reference counting and no virtual call for the translated elements. The results
+// are identical to those of beamline::propagate().
+//
+// A bunch is tracked through a run of translated records in contiguous ranges of
+// particles, on the threads of the shared WorkerPool (see beamline::setNumberOfThreads()).
+//
+// The plan records the serial number and modification count (BmlnElmnt::serial(),
+// BmlnElmnt::modificationCount()) of every element and nested line it was compiled from.
+// Once the source line has been edited, isValid() returns false; propagate() and track()
+// then recompile. isValid() is O(1) as long as no element of any line has been modified
+// (BmlnElmnt::modifications()); the plan is walked only after a modification.
+//
+// An element replaced by assigning through a beamline iterator is not a modification
+// the line knows about: call compile() after doing so.
+//
+// The source beamline must outlive the CompiledLattice.
+//
+//------------------------------------------------------------------------------------------
+
+#ifndef COMPILEDLATTICE_H
+#define COMPILEDLATTICE_H
+
+#include <vector>
+#include <complex>
+#include <basic_toolkit/globaldefs.h>
+#include <basic_toolkit/WorkerPool.h>
+#include <beamline/ParticleFwd.h>
+#include <beamline/ParticleBunchFwd.h>
+
+class beamline;
+class BmlnElmnt;
+
+class DLLEXPORT CompiledLattice {
+
+ public:
+
+  struct Record {
+
+    enum Kind { drift = 0, thin_quad, thin_sextupole, edge, bend, time_offset, generic, generic_local };
+
+    Kind                  kind;
+    double                length;
+    double                strength;
+    double                ctRef;
+    BmlnElmnt const*      elm;        // the source element
+    bool                  aligned;    // the element frame is entered and left around the record
+    std::complex<double>  propPhase;  // bend: the coefficients of Bend::Propagator
+    std::complex<double>  propTerm;
+    double                dphi;
+  };
+
+  explicit CompiledLattice( beamline const& bml );
+ ~CompiledLattice();
+
+  void  compile();
+  bool  isValid() const;             // false if the source line was edited since compile()
+
+  int   size()             const { return records_.size(); }
+  int   numberOfGeneric()  const { return ngeneric_;       }   // records propagated by their element
+
+  Record const& operator[]( int i ) const { return records_[i]; }
+
+  void  propagate( Particle&      p );
+  void  propagate( ParticleBunch& b );
+
+  void  track( Particle&      p, int nturns );
+  void  track( ParticleBunch& b, int nturns );
+
+ private:
+
+  struct Source {
+    unsigned long     serial;
+    unsigned long     modcount;
+    bool operator!=( Source const& o ) const { return ( serial != o.serial ) || ( modcount != o.modcount ); }
+  };
+
+  void  compile  ( beamline const& bml );
+  void  compile  ( BmlnElmnt const& elm, bool local );
+  void  signature( beamline const& bml, std::vector<Source>& sources ) const;
+
+  void  execute  ( Record const* first, Record const* last, Particle& p ) const;
+  void  execute  ( Record const* first, Record const* last, ParticleBunch& b );
+  void  executeChunk( int j );
+
+  beamline const*               bml_;
+  std::vector<Record>           records_;
+  int                           ngeneric_;
+  std::vector<Source>           sources_;
+  mutable std::vector<Source>   scratch_;
+  mutable unsigned long         modifications_;   // BmlnElmnt::modifications() when the plan was last found valid
+
+  std::vector<WorkerPool::Task> tasks_;           // chunk j tracks particles [ bounds_[j], bounds_[j+1] ) of bunch_
+  std::vector<int>              bounds_;          // through the records [ runFirst_, runLast_ )
+  ParticleBunch*                bunch_;
+  Record const*                 runFirst_;
+  Record const*                 runLast_;
+
+  CompiledLattice( CompiledLattice const& );
+  CompiledLattice& operator=( CompiledLattice const& );
+};
+
+#endif // COMPILEDLATTICE_H
@@ -49,6 +49,7 @@ class Drift::Propagator : public BasePropagator {
 
   void  operator()( BmlnElmnt const& elm,    Particle& p);
   void  operator()( BmlnElmnt const& elm, JetParticle& p);
+  void  operator()( BmlnElmnt const& elm, BunchArrays& b);
 };
 
 class MADDriftPropagator : public BasePropagator {
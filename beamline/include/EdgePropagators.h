@@ -51,6 +51,7 @@ class Edge::Propagator: public BasePropagator {
 
   void  operator()(  BmlnElmnt const& elm,            Particle& p);
   void  operator()(  BmlnElmnt const& elm,         JetParticle& p);
+  void  operator()(  BmlnElmnt const& elm,         BunchArrays& b);
 
 };
 
@@ -51,6 +51,8 @@ class thinLamb::Propagator : public BasePropagator {
  
   Propagator* clone() const { return new Propagator(*this); }
 
+  bool isCollective() const { return true; }
+
   void  operator()( BmlnElmnt const& elm,              Particle&  p);
   void  operator()( BmlnElmnt const& elm,           JetParticle&  p);
   void  operator()( BmlnElmnt const& elm,         ParticleBunch&  b);
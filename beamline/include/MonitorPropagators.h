@@ -56,6 +56,8 @@ class HMonitor::Propagator: public BasePropagator {
   Propagator(Propagator const& p);
 
   Propagator* clone() const { return new Propagator(*this); }
+
+  bool isCollective() const { return true; }
  
   void  ctor( BmlnElmnt const& elm ); 
 
@@ -75,6 +77,8 @@ class VMonitor::Propagator: public BasePropagator {
   Propagator(Propagator const& p);
 
   Propagator* clone() const { return new Propagator(*this); }
+
+  bool isCollective() const { return true; }
  
   void  ctor( BmlnElmnt const& elm ); 
 
@@ -95,6 +99,8 @@ class Monitor::Propagator: public BasePropagator {
   Propagator(Propagator const& p);
 
   Propagator* clone() const { return new Propagator(*this); }
+
+  bool isCollective() const { return true; }
  
   void  ctor( BmlnElmnt const& elm ); 
 
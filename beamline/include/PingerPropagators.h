@@ -57,6 +57,8 @@ public:
 
   Propagator* clone() const { return new Propagator(*this); }
 
+  bool isCollective() const { return true; }
+
   void  ctor( BmlnElmnt const& elm ); 
 
   void  operator()(  BmlnElmnt const& elm,            Particle& p);
@@ -53,9 +53,11 @@ public:
   void  operator()(  BmlnElmnt const& elm,      JetParticle& p); 
   void  operator()(  BmlnElmnt const& elm,    ParticleBunch& b);  
   void  operator()(  BmlnElmnt const& elm, JetParticleBunch& b);  
+  void  operator()(  BmlnElmnt const& elm,      BunchArrays& b);  
 
   bool hasAlignment() const;
   bool hasAperture()  const;
+  bool isCollective() const;
 
   void  setAlignment( Vector const& translation, Vector const& rotation);
   void   setAperture( BmlnElmnt::aperture_t type, double const& hor, double const& ver );
@@ -39,12 +39,14 @@
 #include <beamline/ParticleFwd.h>
 
 
+class SymplecticScheme;
+
 class quadrupole::Propagator: public BasePropagator {
 
  public:
 
   Propagator ( int n=4);
-  Propagator ( quadrupole const& elm, int n=4);
+  Propagator ( quadrupole const& elm, int n=4, int order=0 );
   Propagator ( Propagator const& o );
 
   Propagator* clone() const;
@@ -55,10 +57,14 @@ class quadrupole::Propagator: public BasePropagator {
  
   void  operator()( BmlnElmnt const& elm,             Particle& p);
   void  operator()( BmlnElmnt const& elm,          JetParticle& p);
+  void  operator()( BmlnElmnt const& elm,          BunchArrays& b);
 
  private:
 
-  int n_; // number of thin kicks 
+  int n_;       // number of thin kicks; number of steps if order_ != 0
+  int order_;   // 0: TEAPOT-like internal line; 2, 4, 6, 8: SymplecticScheme::forOrder( order_ ) 
+
+  SymplecticScheme const* scheme_;
  
 };
 
@@ -76,6 +82,7 @@ public:
 
   void  operator()( BmlnElmnt const& elm,              Particle& p);
   void  operator()( BmlnElmnt const& elm,           JetParticle& p);
+  void  operator()( BmlnElmnt const& elm,           BunchArrays& b);
 
 };
 
@@ -58,6 +58,7 @@ class rbend::Propagator: public BasePropagator {
 
   void  operator()( BmlnElmnt const& elm,             Particle& p);
   void  operator()( BmlnElmnt const& elm,          JetParticle& p);
+  void  operator()( BmlnElmnt const& elm,          BunchArrays& b);
 };
 
 class rbend::MADPropagator: public BasePropagator {
@@ -56,6 +56,7 @@ class sbend::Propagator: public BasePropagator {
 
   void  operator()(  BmlnElmnt const& elm,             Particle& p);
   void  operator()(  BmlnElmnt const& elm,          JetParticle& p);
+  void  operator()(  BmlnElmnt const& elm,          BunchArrays& b);
 
 };
 
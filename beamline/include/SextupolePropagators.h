@@ -40,12 +40,14 @@
 #include <beamline/ParticleFwd.h>
 
 
+class SymplecticScheme;
+
 class sextupole::Propagator: public BasePropagator {
 
 public:
 
   Propagator ( int n=4);
-  Propagator ( sextupole const& elm, int n=4);
+  Propagator ( sextupole const& elm, int n=4, int order=0 );
   Propagator ( Propagator const& p);
  
   Propagator* clone() const { return new Propagator(*this); }
@@ -55,10 +57,14 @@ public:
   void  setAttribute( BmlnElmnt& elm, std::string const& name, boost::any const&  value);
   void  operator()(  BmlnElmnt const& elm,            Particle& p);
   void  operator()(  BmlnElmnt const& elm,         JetParticle& p);
+  void  operator()(  BmlnElmnt const& elm,         BunchArrays& b);
 
  private:
 
-  int n_; // number of thin kicks 
+  int n_;       // number of thin kicks; number of steps if order_ != 0
+  int order_;   // 0: single kick internal line; 2, 4, 6, 8: SymplecticScheme::forOrder( order_ ) 
+
+  SymplecticScheme const* scheme_;
  
 };
 
@@ -77,6 +83,7 @@ public:
 
   void  operator()( BmlnElmnt const& elm,            Particle& p);
   void  operator()( BmlnElmnt const& elm,         JetParticle& p);
+  void  operator()( BmlnElmnt const& elm,         BunchArrays& b);
 
 };
 
@@ -0,0 +1,189 @@
+/*************************************************************************
+**************************************************************************
+**************************************************************************
+******
+******  BEAMLINE:  C++ objects for design and analysis
+******             of beamlines, storage rings, and
+******             synchrotrons.
+******
+******  File:      SymplecticSteps.h
+******
+******  Copyright Fermi Research Alliance / Fermilab
+******            All Rights Reserved
+*****
+******  Usage, modification, and redistribution are subject to terms
+******  of the License supplied with this software.
+******
+******  Software and documentation created under
+******  U.S. Department of Energy Contract No. DE-AC02-07CH11359
+******  The U.S. Government retains a world-wide non-exclusive,
+******  royalty-free license to publish or reproduce documentation
+******  and software for U.S. Government purposes. This software
+******  is protected under the U.S. and Foreign Copyright Laws.
+******
+****** REVISION HISTORY:
+******
+****** Oct 2026
+******  - Initial version.
+******
+**************************************************************************
+*************************************************************************/
+
+//-----------------------------------------------------------------------------------
+// The drift and kicks of the thick multipole propagators, in the form expected by
+// SymplecticScheme::integrate(): step( p, l ) advances p (a Particle, JetParticle
+// or BunchArrays) by a length l, which may be negative.
+//
+// The expressions are those of the Drift, thinQuad and thinSextupole propagators,
+// without the reference time: the caller subtracts that of the whole element.
+//-----------------------------------------------------------------------------------
+
+#ifndef SYMPLECTICSTEPS_H
+#define SYMPLECTICSTEPS_H
+
+#include <cmath>
+#include <beamline/BasePropagator.h>
+#include <beamline/BunchArrays.h>
+#include <beamline/Particle.h>
+
+struct ExactDriftStep {
+
+  template<typename Particle_t>
+  void operator()( Particle_t& p, double l ) const
+  {
+    typedef typename PropagatorTraits<Particle_t>::State_t       State_t;
+    typedef typename PropagatorTraits<Particle_t>::Component_t   Component_t;
+
+    State_t& state = p.state();
+
+    Component_t npz = p.npz();
+
+    Component_t xpr = state[Particle::i_npx] / npz;
+    Component_t ypr = state[Particle::i_npy] / npz;
+
+    state[Particle::i_x] += ( l * xpr );
+    state[Particle::i_y] += ( l * ypr );
+
+    Component_t D = l*sqrt( 1.0 + xpr*xpr + ypr*ypr );
+
+    state[Particle::i_cdt] += ( D / p.beta() );
+  }
+
+  void operator()( BunchArrays& b, double l ) const
+  {
+    Particle const& ref = b.getReferenceParticle();
+
+    double const p0 = ref.refMomentum();
+    double const m  = ref.mass();
+    int    const n  = b.size();
+
+    double* const x   = b[Particle::i_x];
+    double* const y   = b[Particle::i_y];
+    double* const cdt = b[Particle::i_cdt];
+    double const* const npx = b[Particle::i_npx];
+    double const* const npy = b[Particle::i_npy];
+    double const* const ndp = b[Particle::i_ndp];
+
+    for ( int j=0; j<n; ++j ) {
+
+      double const dpp  = 1.0 + ndp[j];
+      double const npz  = std::sqrt( dpp*dpp - npx[j]*npx[j] - npy[j]*npy[j] );
+      double const xpr  = npx[j] / npz;
+      double const ypr  = npy[j] / npz;
+
+      x[j] += l * xpr;
+      y[j] += l * ypr;
+
+      double const D    = l*std::sqrt( 1.0 + xpr*xpr + ypr*ypr );
+      double const pc   = p0*dpp;
+
+      cdt[j] += D * ( std::sqrt( pc*pc + m*m )/pc );
+    }
+  }
+};
+
+//-----------------------------------------------------------------------------------
+// k = B'/(B rho) in m^-2
+//-----------------------------------------------------------------------------------
+
+struct QuadrupoleKickStep {
+
+  explicit QuadrupoleKickStep( double k ) : k_(k) {}
+
+  template<typename Particle_t>
+  void operator()( Particle_t& p, double l ) const
+  {
+    typedef typename PropagatorTraits<Particle_t>::State_t  State_t;
+
+    State_t& state = p.state();
+
+    double const kl = k_*l;
+
+    state[Particle::i_npx]  += - kl * state[Particle::i_x];
+    state[Particle::i_npy]  +=   kl * state[Particle::i_y];
+  }
+
+  void operator()( BunchArrays& b, double l ) const
+  {
+    double const kl = k_*l;
+    int    const n  = b.size();
+
+    double const* const x   = b[Particle::i_x];
+    double const* const y   = b[Particle::i_y];
+    double*       const npx = b[Particle::i_npx];
+    double*       const npy = b[Particle::i_npy];
+
+    for ( int j=0; j<n; ++j ) {
+      npx[j] += - kl * x[j];
+      npy[j] +=   kl * y[j];
+    }
+  }
+
+  double k_;
+};
+
+//-----------------------------------------------------------------------------------
+// k = B''/(2 B rho) in m^-3, as for the sextupole strength
+//-----------------------------------------------------------------------------------
+
+struct SextupoleKickStep {
+
+  explicit SextupoleKickStep( double k ) : k_(k) {}
+
+  template<typename Particle_t>
+  void operator()( Particle_t& p, double l ) const
+  {
+    typedef typename PropagatorTraits<Particle_t>::State_t       State_t;
+    typedef typename PropagatorTraits<Particle_t>::Component_t   Component_t;
+
+    State_t& state = p.state();
+
+    double const kl = k_*l;
+
+    Component_t const x = state[Particle::i_x];
+    Component_t const y = state[Particle::i_y];
+
+    state[Particle::i_npx] -= kl * ( x*x - y*y );
+    state[Particle::i_npy] += 2.0 * kl * x*y;
+  }
+
+  void operator()( BunchArrays& b, double l ) const
+  {
+    double const kl = k_*l;
+    int    const n  = b.size();
+
+    double const* const x   = b[Particle::i_x];
+    double const* const y   = b[Particle::i_y];
+    double*       const npx = b[Particle::i_npx];
+    double*       const npy = b[Particle::i_npy];
+
+    for ( int j=0; j<n; ++j ) {
+      npx[j] -= kl * ( x[j]*x[j] - y[j]*y[j] );
+      npy[j] += 2.0 * kl * x[j]*y[j];
+    }
+  }
+
+  double k_;
+};
+
+#endif // SYMPLECTICSTEPS_H
@@ -36,6 +36,7 @@
 
 #include <basic_toolkit/globaldefs.h>
 #include <basic_toolkit/Distribution.h>
+#include <basic_toolkit/RandomStreams.h>
 #include <beamline/ParticleBunch.h>
 #include <beamline/Particle.h>
 #include <boost/pool/pool.hpp>
@@ -94,6 +95,25 @@ public:
   void populateCSKV          ( PhaseSpaceProjection psid, double beta, double alpha, double epsilon, boost::function<double()>& rand );
   void populateCSBinomial    ( PhaseSpaceProjection psid, double M, double beta, double alpha, double epsilon, boost::function<double()>& rand);
 
+  // populate using counter-based random streams: particle j draws its numbers from streams.stream(j, psid),
+  // independently of the other particles. Contiguous ranges of the bunch are populated concurrently
+  // (see beamline::setNumberOfThreads()); the result is the same whatever the number of threads.
+  // The Alt variants use the normal numbers of the streams.
+
+  void populateParGaussian    ( PhaseSpaceProjection psid, double sigma_x, double sigma_np, double r_12 ,       RandomStreams const& streams, double cutoff );
+  void populateParGaussianAlt ( PhaseSpaceProjection psid, double sigma_x, double sigma_np, double r_12 ,       RandomStreams const& streams, double cutoff );
+  void populateParWaterBag    ( PhaseSpaceProjection psid, double sigma_x, double sigma_np, double r_12,        RandomStreams const& streams );
+  void populateParElliptic    ( PhaseSpaceProjection psid, double sigma_x, double sigma_np, double r_12,        RandomStreams const& streams );
+  void populateParKV          ( PhaseSpaceProjection psid, double sigma_x, double sigma_np, double r_12,        RandomStreams const& streams );
+  void populateParBinomial    ( PhaseSpaceProjection psid, double M, double x_lim, double px_lim, double r_12,  RandomStreams const& streams );
+
+  void populateCSGaussian    ( PhaseSpaceProjection psid, double beta, double alpha, double epsilon, RandomStreams const& streams, double cutoff);
+  void populateCSGaussianAlt ( PhaseSpaceProjection psid, double beta, double alpha, double epsilon, RandomStreams const& streams, double cutoff);
+  void populateCSWaterBag    ( PhaseSpaceProjection psid, double beta, double alpha, double epsilon, RandomStreams const& streams );
+  void populateCSElliptic    ( PhaseSpaceProjection psid, double beta, double alpha, double epsilon, RandomStreams const& streams );
+  void populateCSKV          ( PhaseSpaceProjection psid, double beta, double alpha, double epsilon, RandomStreams const& streams );
+  void populateCSBinomial    ( PhaseSpaceProjection psid, double M, double beta, double alpha, double epsilon, RandomStreams const& streams );
+
 
   Matrix  sigmas( std::vector<double> const&  dispersion) const; 
 
@@ -106,6 +126,12 @@ public:
   template <typename LessThanOperator_t>
   inline void sort( LessThanOperator_t );          
 
+  void transfer( iterator first, iterator last, TBunch& from ); 
+                                // moves (without copying) particles [first,last) of bunch from 
+                                // to the end of this bunch. Particles remain allocated in the 
+                                // pool of the bunch that created them; they must be transferred 
+                                // back before that bunch is destroyed.   
+
   void clear(); 
   int  size()           const;
   int  removed_size()   const;
@@ -202,6 +228,43 @@ void TBunch<Particle>::populateCSKV       ( PhaseSpaceProjection psid, double be
 template<>
 void TBunch<Particle>::populateCSBinomial ( PhaseSpaceProjection psid,  double M, double beta, double alpha, double epsilon, boost::function<double()>& );
 
+template<>
+void TBunch<Particle>::populateParGaussian ( PhaseSpaceProjection psid, double sigma_x, double sigma_np, double r_12, RandomStreams const&, double cutoff);
+
+template<>
+void TBunch<Particle>::populateParGaussianAlt ( PhaseSpaceProjection psid, double sigma_x, double sigma_np, double r_12, RandomStreams const&, double cutoff);
+
+template<>
+void TBunch<Particle>::populateParWaterBag ( PhaseSpaceProjection psid, double sigma_x, double sigma_np, double r_12, RandomStreams const& );
+
+template<>
+void TBunch<Particle>::populateParElliptic( PhaseSpaceProjection psid, double sigma_x, double sigma_np, double r_12, RandomStreams const& );
+
+template<>
+void TBunch<Particle>::populateParKV       ( PhaseSpaceProjection psid, double sigma_x, double sigma_np, double r_12, RandomStreams const& );
+
+template<>
+void TBunch<Particle>::populateParBinomial ( PhaseSpaceProjection psid, double M, double x_lim, double px_lim, double r_12, RandomStreams const& );
+
+
+template<>
+void TBunch<Particle>::populateCSGaussian ( PhaseSpaceProjection psid, double beta, double alpha, double epsilon, RandomStreams const&, double cutoff );
+
+template<>
+void TBunch<Particle>::populateCSGaussianAlt ( PhaseSpaceProjection psid, double beta, double alpha, double epsilon, RandomStreams const&, double cutoff );
+
+template<>
+void TBunch<Particle>::populateCSWaterBag ( PhaseSpaceProjection psid, double beta, double alpha, double epsilon, RandomStreams const& );
+
+template<>
+void TBunch<Particle>::populateCSElliptic( PhaseSpaceProjection psid, double beta, double alpha, double epsilon, RandomStreams const& );
+
+template<>
+void TBunch<Particle>::populateCSKV       ( PhaseSpaceProjection psid, double beta, double alpha, double epsilon, RandomStreams const& );
+
+template<>
+void TBunch<Particle>::populateCSBinomial ( PhaseSpaceProjection psid,  double M, double beta, double alpha, double epsilon, RandomStreams const& );
+
 template<>
 std::vector<double> TBunch<Particle>::emittances() const;
 
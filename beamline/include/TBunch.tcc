@@ -249,6 +249,15 @@ typename TBunch<Particle_t>::const_reverse_iterator     TBunch<Particle_t>::remo
 //|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
 //|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
 
+template <typename Particle_t>
+void TBunch<Particle_t>::transfer( iterator first, iterator last, TBunch& from )
+{
+  bunch_.transfer( bunch_.end(), first, last, from.bunch_ );
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
 template <typename Particle_t>
 void TBunch<Particle_t>::clear()
 {
@@ -54,6 +54,7 @@ public:
 
   void  operator()(  BmlnElmnt const& elm,       Particle& p);
   void  operator()(  BmlnElmnt const& elm,    JetParticle& p);
+  void  operator()(  BmlnElmnt const& elm,    BunchArrays& b);
 
 };
 
@@ -39,7 +39,10 @@
 
 #include <basic_toolkit/globaldefs.h>
 #include <basic_toolkit/ConvolutionFunctor.h>
+#include <basic_toolkit/WorkerPool.h>
 #include <beamline/WakeKick.h>
+#include <beamline/BunchProjector.h>
+#include <vector>
 #include <beamline/ParticleFwd.h>
 
 template <typename Particle_t>
@@ -58,6 +61,8 @@ public:
 
   Propagator* clone() const; 
 
+  bool isCollective() const;
+
   void ctor( BmlnElmnt const& elm);
 
   void operator()(  BmlnElmnt const&  elm,          Particle& p );
@@ -69,13 +74,41 @@ public:
 
 private:
 
+  void resetWakes();
+  void kickChunk( int j );
+
   int                        nsamples_;
   double                     interval_;
 
-  // ConvolutionFunctor<double, ConvolutionFFTPolicy> lwake_;
-  // ConvolutionFunctor<double, ConvolutionFFTPolicy> twake_;
-  ConvolutionFunctor<double, ConvolutionInnerProductPolicy> lwake_;
-  ConvolutionFunctor<double, ConvolutionInnerProductPolicy> twake_;
+  //-----------------------------------------------------------------------
+  // The FFT plans and the transforms of the wake functions are computed 
+  // once, and recomputed only when the sampling interval changes. 
+  // The projections and the kicks are held in buffers sized once, so that 
+  // no memory is allocated when the kick is applied.  
+  //-----------------------------------------------------------------------
+
+  ConvolutionFunctor<double, ConvolutionFFTPolicy> lwake_;
+  ConvolutionFunctor<double, ConvolutionFFTPolicy> twake_;
+
+  BunchProjector             projector_;
+
+  std::vector<double>        dpx_;
+  std::vector<double>        dpy_;
+  std::vector<double>        dpz_;
+  std::vector<double>        samples_;    // wake function samples, used by resetWakes()
+
+  //-----------------------------------------------------------------------
+  // The tasks handed to WorkerPool::instance() are bound to kickChunk() 
+  // once, when the number of chunks changes. The bunch and the chunk 
+  // boundaries they operate on are set before each run.  
+  //-----------------------------------------------------------------------
+
+  ParticleBunch*                  bunch_;       
+  double                          cdt_min_;
+  double                          binsize_;
+  std::vector<int>                bounds_;      // chunk j spans [ bounds_[j], bounds_[j+1] [ 
+  std::vector<int>                outOfRange_;  // one flag per chunk of the bunch 
+  std::vector<WorkerPool::Task>   tasks_;       // one task per chunk; not copied, since bound to this 
  
 };
 
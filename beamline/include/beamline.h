@@ -163,6 +163,9 @@ public:
 
    void   propagateReference( Particle& p, double initialBhro, bool scaling);
 
+   static void setNumberOfThreads( int n );  // threads used to track bunches; 1 (default): serial tracking, 
+   static int     numberOfThreads();         // 0: one per hardware thread. See BeamlinePropagators.h.  
+
    iterator putAbove( iterator   it, ElmPtr y ); // Insert y above (before;  upstream of) x
    iterator putBelow( iterator   it, ElmPtr y ); // Insert y below (after, downstream of) x
 
@@ -265,6 +268,7 @@ public:
                                                                                     // depth of all subbeamlines.
   const char*  Type()                           const;
   bool         isBeamline()                     const;
+  bool         isCollective()                   const;  // true if any element is collective
 
   bool         isMagnet()                       const;
   bool         isThin()                         const;
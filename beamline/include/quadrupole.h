@@ -54,6 +54,7 @@
 #ifndef QUADRUPOLE_H
 #define QUADRUPOLE_H
 
+#include <utility>
 #include <basic_toolkit/globaldefs.h>
 #include <beamline/BmlnElmnt.h>
 
@@ -102,11 +103,20 @@ public:
   bool        isPassive()    const;
   bool        isDriftSpace() const;
 
+  // order 0 (default): TEAPOT-like split into n thin kicks (n = 4 by default).
+  // order 2, 4, 6 or 8: n steps of the SymplecticScheme of that order.
+
+  void setIntegrator( int order, int n );
+
+  std::pair<int,int> const& getIntegrator() const;    // ( order, n )
+
  private:
 
   std::ostream& writeTo(std::ostream&);
   std::istream& readFrom(std::istream&);
 
+  std::pair<int,int>  integrator_;
+
 } ;
 
 
@@ -53,6 +53,7 @@
 #ifndef SEXTUPOLE_H
 #define SEXTUPOLE_H
 
+#include <utility>
 #include <basic_toolkit/globaldefs.h>
 #include <beamline/BmlnElmnt.h>
 
@@ -97,6 +98,17 @@ public:
   bool isPassive()     const;
   bool isDriftSpace()  const;
 
+  // order 0 (default): a single thin kick at the center.
+  // order 2, 4, 6 or 8: n steps of the SymplecticScheme of that order.
+
+  void setIntegrator( int order, int n );
+
+  std::pair<int,int> const& getIntegrator() const;    // ( order, n )
+
+ private:
+
+  std::pair<int,int>  integrator_;
+
 } ;
 
 
@@ -51,10 +51,10 @@ class DLLEXPORT thinMultipole : public BmlnElmnt {
 
   class Propagator;
  
-  typedef std::map<int, std::complex<double> >::const_iterator const_iterator; 
-
 public:
 
+  typedef std::map<int, std::complex<double> >::const_iterator const_iterator; 
+
   thinMultipole(); 
   thinMultipole( std::string const& name ); 
   thinMultipole( thinMultipole const& );
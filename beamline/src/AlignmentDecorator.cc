@@ -32,6 +32,7 @@
 #include <beamline/AlignmentDecorator.h>
 #include <beamline/Particle.h>
 #include <beamline/JetParticle.h>
+#include <beamline/BunchArrays.h>
 
 //|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
 //|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
@@ -44,8 +45,10 @@ AlignmentDecorator::AlignmentDecorator( PropagatorPtr p )
 //|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
 
 AlignmentDecorator::AlignmentDecorator( AlignmentDecorator const& o)
-  : PropagatorDecorator(o)
-
+  : PropagatorDecorator(o), 
+    offsets_(o.offsets_), 
+    angles_(o.angles_), 
+    rotation_(o.rotation_)
 {}
 
 //|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
@@ -166,3 +169,36 @@ void  AlignmentDecorator::operator()(  BmlnElmnt const& elm,  JetParticle& p)
 
 //|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
 //|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+void  AlignmentDecorator::operator()(  BmlnElmnt const& elm,  BunchArrays& b) 
+{
+  int const dim = Particle::BMLN_dynDim;
+  int const n   = b.size();
+
+  double r[dim][dim];
+  for ( int i=0; i<dim; ++i ) { 
+    for ( int k=0; k<dim; ++k ) { r[i][k] = rotation_[i][k]; }
+  }
+
+  double* x = b[Particle::i_x];
+  double* y = b[Particle::i_y];
+
+  for ( int j=0; j<n; ++j ) { x[j] -= offsets_[0]; } 
+  for ( int j=0; j<n; ++j ) { y[j] -= offsets_[1]; } 
+
+  double in[dim];
+
+  for ( int j=0; j<n; ++j ) {
+    for ( int k=0; k<dim; ++k ) { in[k] = b[k][j]; }
+    for ( int i=0; i<dim; ++i ) {
+      double sum = 0.0;  
+      for ( int k=0; k<dim; ++k ) { sum += r[i][k]*in[k]; }
+      b[i][j] = sum;
+    }
+  }
+
+  (*propagator_)( elm, b); 
+} 
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
@@ -33,6 +33,10 @@
 #include <beamline/Particle.h>
 #include <beamline/JetParticle.h>
 #include <beamline/BmlnElmnt.h>
+#include <beamline/BunchArrays.h>
+#include <beamline/ParticleBunch.h>
+#include <beamline/TBunch.h>
+#include <cmath>
 
 namespace {
 
@@ -55,7 +59,7 @@ ApertureDecorator::ApertureDecorator( PropagatorPtr p )
 //|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
 
 ApertureDecorator::ApertureDecorator( ApertureDecorator const& o)
-  : PropagatorDecorator(o)
+  : PropagatorDecorator(o), type_(o.type_), hor_(o.hor_), ver_(o.ver_)
 {}
 
 //|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
@@ -89,7 +93,7 @@ bool  ApertureDecorator::lost ( double const& x, double const& y) const
 
     case BmlnElmnt::elliptical : return ( (x*x) + (y*y) > 1.0 );
                                  break;
-    case BmlnElmnt::rectangular: return ( (abs(x) > 1.0) || (abs(y) > 1.0) );  
+    case BmlnElmnt::rectangular: return ( (std::abs(x) > 1.0) || (std::abs(y) > 1.0) );  
                                  break;
     default:                     return false;
                
@@ -110,14 +114,22 @@ void ApertureDecorator::setAperture( BmlnElmnt::aperture_t type, double const& h
 //|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
 //|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
 
+boost::tuple<BmlnElmnt::aperture_t, double, double>  ApertureDecorator::aperture() const
+{
+  return boost::tuple<BmlnElmnt::aperture_t, double, double>( type_, hor_, ver_ );
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
 void ApertureDecorator::operator()( BmlnElmnt const& elm,         Particle& p)
 {
+  if ( p.isLost() ) return;  // do nothing 
+
   Vector& state = p.state();
   
   double xn = state[i_x]/hor_;
   double yn = state[i_y]/ver_;
-  
-  if ( p.isLost() ); return;  // do nothing 
 
   if ( lost(xn, yn) ) { 
     p.setLost(true);
@@ -144,13 +156,13 @@ void ApertureDecorator::operator()( BmlnElmnt const& elm,         Particle& p)
 void ApertureDecorator::operator()( BmlnElmnt const& elm,      JetParticle& p)
 {
  
+  if ( p.isLost() ) return;  // do nothing 
+
   Mapping& state = p.state();
   
   double xn = state[i_x].standardPart()/hor_;
   double yn = state[i_y].standardPart()/ver_;
 
-  if ( p.isLost() ); return;  // do nothing 
-
   if ( lost(xn, yn) ) { 
     p.setLost(true);
     return;
@@ -174,3 +186,90 @@ void ApertureDecorator::operator()( BmlnElmnt const& elm,      JetParticle& p)
 
 //|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
 //|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+void ApertureDecorator::flagLosses( ParticleBunch& b ) const
+{
+  for ( ParticleBunch::iterator it = b.begin(); it != b.end(); ++it ) {
+    if ( it->isLost() ) continue;
+    if ( lost( it->state()[i_x]/hor_, it->state()[i_y]/ver_ ) ) { it->setLost(true); }
+  }
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+void ApertureDecorator::flagLosses( BunchArrays& b ) const
+{
+  double const* x     = b[i_x];
+  double const* y     = b[i_y];
+  unsigned char* alive = b.alive();
+
+  int const n = b.size();
+
+  double const ihor = 1.0/hor_;
+  double const iver = 1.0/ver_;
+
+  switch ( type_ ) {
+
+    case BmlnElmnt::elliptical : 
+      for ( int j=0; j<n; ++j ) {
+        double const xn = x[j]*ihor;
+        double const yn = y[j]*iver;
+        alive[j] &= ( (xn*xn) + (yn*yn) <= 1.0 );
+      }
+      break;
+
+    case BmlnElmnt::rectangular: 
+      for ( int j=0; j<n; ++j ) {
+        alive[j] &= ( (std::abs(x[j]*ihor) <= 1.0) && (std::abs(y[j]*iver) <= 1.0) );
+      }
+      break;
+
+    default: 
+      break;
+  }
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+void ApertureDecorator::operator()( BmlnElmnt const& elm,    ParticleBunch& b)
+{
+  //----------------------------------------------------------------------
+  // A collective propagator needs the whole bunch; otherwise the 
+  // particles are propagated one at a time, so that lost particles 
+  // are left untouched, as with a single particle.
+  //----------------------------------------------------------------------
+
+  if ( !propagator_->isCollective() ) {
+    for ( ParticleBunch::iterator it = b.begin(); it != b.end(); ++it ) { 
+      (*this)( elm, *it ); 
+    }
+    return;
+  }
+
+  flagLosses( b );
+
+  (*propagator_)(elm,b);   
+
+  if ( elm.isThin() ) return;
+
+  flagLosses( b );
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+void ApertureDecorator::operator()( BmlnElmnt const& elm,      BunchArrays& b)
+{
+  flagLosses( b );
+
+  (*propagator_)(elm,b);   
+
+  if ( elm.isThin() ) return;
+
+  flagLosses( b );
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
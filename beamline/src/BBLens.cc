@@ -55,6 +55,8 @@
 #endif
 
 #include <basic_toolkit/GenericException.h>
+#include <basic_toolkit/MathConstants.h>
+#include <basic_toolkit/utils.h>
 #include <beamline/BBLensPropagators.h>
 #include <beamline/BBLens.h>
 #include <beamline/BmlVisitor.h>
@@ -64,6 +66,7 @@
 
 using namespace boost;
 using namespace std;
+using namespace MathConstants;
 
 static complex<double> complex_i(0.0, 1.0);
 
@@ -153,6 +156,7 @@ double const&  BBLens::getDistCharge() const
 void BBLens::setDistCharge( double const& N )
 {
   num_  = N;
+  markModified();
 }
 
 //||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
@@ -161,6 +165,7 @@ void BBLens::setDistCharge( double const& N )
 void BBLens::setSigmas( std::vector<double> const& sigmas)
 {
   sigmas_ = sigmas;
+  markModified();
 }
 
 //||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
@@ -180,6 +185,7 @@ void BBLens::setDistParameters( double const& npart, double const& Gamma, double
   gamma_ = Gamma;
   beta_ = sqrt( 1.0 - 1.0 / ( gamma_*gamma_ ) );
   for( int i=0; i<3; ++i) sigmas_[i] = sigmas[i]; 
+  markModified();
 }
 
 //||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
@@ -257,3 +263,140 @@ void BBLens::accept( ConstBmlVisitor& v ) const
 
 //||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
 //||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+template <>
+EVector_t<double>::Type BBLens::NormalizedEField( double const& x, double const& y ) const
+{
+  Vector retvec(3);
+
+  double ex = 0.0;
+  double ey = 0.0;
+
+  NormalizedEField( 1, &x, &y, &ex, &ey );
+
+  retvec[0] = ex;
+  retvec[1] = ey;
+  retvec[2] = 0.0;
+
+  return retvec;
+}
+
+//||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+void BBLens::NormalizedEField( int n, double const* x, double const* y, double* ex, double* ey ) const
+{
+  //---------------------------------------------------------------------
+  // Same formulas and branches as the template version (BBLens.tcc); 
+  // the points are processed in blocks, the complex error function 
+  // of a whole block being evaluated with a single call. 
+  //---------------------------------------------------------------------
+
+  double const SIGMA_LIMIT = 64.0;
+  double const SIGMA_ROUND = 0.1;
+
+  int const blocksize = 256;
+
+  double sigmaX = sigmas_[0];
+  double sigmaY = sigmas_[1];
+
+  // Asymptotic limit ...
+
+  if( ( sigmaX == 0.0 ) && ( sigmaY == 0.0 ) ) {
+    for( int j=0; j<n; ++j ) {
+      double r = x[j]*x[j] + y[j]*y[j];
+      if( r < 1.0e-20 ) {
+        throw( GenericException( __FILE__, __LINE__, 
+               "void BBLens::NormalizedEField( int n, double const* x, double const* y, double* ex, double* ey ) const", 
+               "Asymptotic limit r seems too small." ) );
+      }
+      ex[j] = x[j]/r;
+      ey[j] = y[j]/r;
+    }
+    return;
+  }
+
+  double const meanSigma = 2.0*sigmaX*sigmaY;
+
+  bool const round = useRound && ( std::abs( ( sigmaX - sigmaY ) / ( sigmaX + sigmaY ) ) < SIGMA_ROUND );
+
+  // Elliptical beam: u is the coordinate along the major axis ... 
+
+  bool const normal = ( sigmaX > sigmaY );
+
+  double const* u    = normal ? x  : y;
+  double const* v    = normal ? y  : x;
+  double*       eu   = normal ? ex : ey;
+  double*       ev   = normal ? ey : ex;
+
+  if (!normal) { std::swap ( sigmaX, sigmaY); }
+
+  double const ds    = round ? 1.0 : sqrt(2.0*(sigmaX*sigmaX - sigmaY*sigmaY));
+  double const ratio = sigmaY/sigmaX;
+  double const scale = Math_SQRTPI/ds;
+
+  double z1_re[blocksize];
+  double z1_im[blocksize];
+  double z2_re[blocksize];
+  double z2_im[blocksize];
+  double w1_re[blocksize];
+  double w1_im[blocksize];
+  double w2_re[blocksize];
+  double w2_im[blocksize];
+
+  for( int first = 0; first < n; first += blocksize ) {
+
+    int const m = std::min( blocksize, n - first );
+
+    double const* ub  = u  + first;
+    double const* vb  = v  + first;
+    double*       eub = eu + first;
+    double*       evb = ev + first;
+
+    if( !round ) {
+
+      for( int j=0; j<m; ++j ) {
+        z1_re[j] = std::abs( ub[j] )/ds;
+        z1_im[j] = std::abs( vb[j] )/ds;
+        z2_re[j] = z1_re[j]*ratio;
+        z2_im[j] = z1_im[j]*ratio;
+      }
+
+      w( m, z1_re, z1_im, w1_re, w1_im );
+      w( m, z2_re, z2_im, w2_re, w2_im );
+
+      for( int j=0; j<m; ++j ) {
+        double const tu = ub[j]/sigmaX;
+        double const tv = vb[j]/sigmaY;
+        double const e  = exp( -0.5*( tu*tu + tv*tv ) );
+
+        // z = -i sqrt(pi)/ds [ w(z1) - exp( -r0/2 ) w(z2) ] 
+
+        eub[j] = ( ub[j] < 0.0 ? -scale : scale )*( w1_im[j] - e*w2_im[j] ); 
+        evb[j] = ( vb[j] < 0.0 ? -scale : scale )*( w1_re[j] - e*w2_re[j] ); 
+      }
+    }
+
+    // Round beam limit ( whole beam, or points far from the core ) ...
+
+    if( !useRound ) continue;
+
+    for( int j=0; j<m; ++j ) {
+
+      double const tu = ub[j]/sigmaX;
+      double const tv = vb[j]/sigmaY;
+
+      if( !round && ( tu*tu + tv*tv ) <= SIGMA_LIMIT ) continue;
+
+      double r = ub[j]*ub[j] + vb[j]*vb[j];
+
+      r = ( r > 1.0e-6*meanSigma ) ? ( 1.0 - exp(-r/ meanSigma ) ) / r : 1.0/meanSigma; 
+
+      eub[j] = ub[j]*r;
+      evb[j] = vb[j]*r;
+    }
+  }
+}
+
+//||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
@@ -38,9 +38,13 @@
 
 #include <beamline/Particle.h>
 #include <beamline/JetParticle.h>
+#include <beamline/ParticleBunch.h>
+#include <beamline/TBunch.h>
+#include <beamline/BunchArrays.h>
 #include <beamline/BBLensPropagators.h>
 #include <beamline/BBLens.h>
 #include <basic_toolkit/PhysicsConstants.h>
+#include <vector>
 
 using namespace PhysicsConstants;
 
@@ -89,6 +93,122 @@ void propagate( BBLens const& elm, Particle_t& p )
 
 }
 
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+class Kick {
+
+  //-------------------------------------------------------------------
+  // The kick of the single particle propagate() above, written out 
+  // in components: K = E + beta_p x ( beta_lens x E ), scaled by 
+  // - num r_p /( beta^2 gamma ) of the particle. 
+  //-------------------------------------------------------------------
+
+ public:
+
+  Kick( BBLens const& elm, Particle const& reference )
+    : p0_( reference.refMomentum() ), m_( reference.mass() )
+  {
+    Vector const beta = elm.Beta(); 
+    bx_ = beta[0];
+    by_ = beta[1];
+    bz_ = beta[2];
+
+    double const num = elm.getDistCharge();
+
+    strength_ = - num*PH_MKS_rp;
+    if( reference.charge()*num < 0.0 ) strength_ = -strength_;
+  }
+
+  void operator()( double ex, double ey, double ndp, double& npx, double& npy ) const
+  {
+    double const p     = p0_*( 1.0 + ndp );
+    double const e     = sqrt( p*p + m_*m_ );
+    double const npz   = sqrt( ( 1.0 + ndp )*( 1.0 + ndp ) - npx*npx - npy*npy );
+
+    double const betax = npx*p0_/e;
+    double const betay = npy*p0_/e;
+    double const betaz = npz*p0_/e;
+
+    double const c0    = - bz_*ey;                // beta_lens x E
+    double const c1    =   bz_*ex;
+    double const c2    =   bx_*ey - by_*ex;
+
+    double const kx    = ex + betay*c2 - betaz*c1;
+    double const ky    = ey + betaz*c0 - betax*c2;
+
+    double const f     = strength_*m_*e/( p*p ); // strength/( beta^2 gamma )
+
+    npx += f*kx;
+    npy += f*ky;
+  }
+
+ private:
+
+  double p0_;
+  double m_;
+  double bx_;
+  double by_;
+  double bz_;
+  double strength_;
+};
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+void propagate( BBLens const& elm, BunchArrays& b )
+{
+  if( elm.Strength() == 0.0 || b.empty() ) return;
+
+  int const np = b.size();
+
+  std::vector<double> ex( np );
+  std::vector<double> ey( np );
+
+  elm.NormalizedEField( np, b[i_x], b[i_y], &ex[0], &ey[0] );
+
+  Kick const kick( elm, b.getReferenceParticle() );
+
+  double const* const ndp = b[i_ndp];
+  double*       const npx = b[i_npx];
+  double*       const npy = b[i_npy];
+
+  for( int j=0; j<np; ++j ) { 
+    kick( ex[j], ey[j], ndp[j], npx[j], npy[j] );
+  }
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+void propagate( BBLens const& elm, ParticleBunch& b )
+{
+  if( elm.Strength() == 0.0 || b.empty() ) return;
+
+  int const np = b.size();
+
+  std::vector<double> x ( np );
+  std::vector<double> y ( np );
+  std::vector<double> ex( np );
+  std::vector<double> ey( np );
+
+  int j = 0;
+  for( ParticleBunch::iterator it = b.begin(); it != b.end(); ++it, ++j ) { 
+    x[j] = it->state()[i_x];
+    y[j] = it->state()[i_y];
+  }
+
+  elm.NormalizedEField( np, &x[0], &y[0], &ex[0], &ey[0] );
+
+  Kick const kick( elm, b.getReferenceParticle() );
+
+  j = 0;
+  for( ParticleBunch::iterator it = b.begin(); it != b.end(); ++it, ++j ) { 
+    Vector& state = it->state();
+    kick( ex[j], ey[j], state[i_ndp], state[i_npx], state[i_npy] );
+  }
+}
+
 } // namespace
 
 //|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
@@ -145,3 +265,18 @@ void BBLens::Propagator::operator()( BmlnElmnt const& elm, JetParticle& p )
 //|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
 //|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
 
+void BBLens::Propagator::operator()( BmlnElmnt const& elm, ParticleBunch& b ) 
+{
+  ::propagate( static_cast<BBLens const&>(elm), b );
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+void BBLens::Propagator::operator()( BmlnElmnt const& elm, BunchArrays& b ) 
+{
+  ::propagate( static_cast<BBLens const&>(elm), b );
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
@@ -31,10 +31,12 @@
 
 #include <beamline/ParticleBunch.h>
 #include <beamline/TBunch.h>
+#include <beamline/BunchArrays.h>
 #include <beamline/BasePropagator.h>
 #include <beamline/BmlnElmnt.h>
 #include <beamline/beamline.h>
 #include <iostream>
+#include <boost/scoped_ptr.hpp>
 
 
 //|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
@@ -104,6 +106,41 @@ void  BasePropagator::operator()(  BmlnElmnt const& elm, JetParticleBunch& b)
 //|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
 //|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
 
+void  BasePropagator::operator()(  BmlnElmnt const& elm, BunchArrays& b)  
+{
+ //----------------------------------------------------------------------
+ // generic (slow) path: each surviving particle is copied into a scratch 
+ // particle and pushed through the single particle propagator. Element 
+ // types that matter for performance override this with loops over 
+ // the coordinate arrays.
+ //---------------------------------------------------------------------- 
+
+ //----------------------------------------------------------------------
+ // A collective propagator needs the bunch as a whole: the arrays are
+ // handed to its ParticleBunch operator() and read back afterwards.
+ //----------------------------------------------------------------------
+
+ if ( isCollective() ) {
+   ParticleBunch bunch( b.getReferenceParticle() );
+   b.store( bunch );
+   (*this)( elm, bunch );
+   b.load( bunch );
+   return;
+ }
+
+ boost::scoped_ptr<Particle> p( b.getReferenceParticle().clone() );
+
+ for ( int j=0; j < b.size(); ++j )  {  
+    if ( b.isLost(j) ) continue;
+    b.getParticle( j, *p ); 
+    (*this)( elm, *p ); 
+    b.setParticle( j, *p ); 
+ }
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
 void   BasePropagator::setReferenceTime( double ct ) 
 {
   ctRef_ = ct;
@@ -141,6 +178,14 @@ bool BasePropagator::isComposite() const
 { 
  return bml_;
 } 
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+bool BasePropagator::isCollective() const
+{ 
+ return false;
+} 
  
 
 //|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
@@ -29,9 +29,27 @@
 *************************************************************************/
 
 #include <beamline/BeamlinePropagators.h>
+#include <beamline/BunchArrays.h>
+#include <beamline/ParticleBunch.h>
+#include <beamline/TBunch.h>
+#include <basic_toolkit/GenericException.h>
+#include <basic_toolkit/WorkerPool.h>
+#include <boost/thread.hpp>
+#include <boost/bind.hpp>
+#include <boost/ptr_container/ptr_vector.hpp>
+#include <algorithm>
+#include <exception>
+#include <string>
+#include <vector>
 
 namespace {
 
+int const min_chunk_size = 256;  // a thread is not worth starting for fewer particles 
+
+// set in worker threads, so that nested beamlines are tracked serially
+
+boost::thread_specific_ptr<bool> in_worker;
+
 template <typename particle_t >
 void propagate( beamline const& bml, particle_t& p )
 {
@@ -41,8 +59,156 @@ void propagate( beamline const& bml, particle_t& p )
  }
 } 
 
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+template <typename bunch_t >
+void trackChunk( beamline::const_iterator first, beamline::const_iterator last, bunch_t& chunk, std::string& error )
+{
+  in_worker.reset( new bool(true) );
+
+  //---------------------------------------------------------------
+  // exceptions cannot propagate across threads; the message is 
+  // recorded and the exception is rethrown by the calling thread.
+  //---------------------------------------------------------------
+
+  try {
+    for ( beamline::const_iterator it = first; it != last; ++it ) { 
+      (*it)->propagate( chunk );
+    }
+  }
+  catch ( std::exception const& e ) {
+    error = e.what();
+  }
+  catch ( ... ) {
+    error = "Unknown exception.";
+  }
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+template <typename bunch_t >
+void trackChunks( beamline::const_iterator first, beamline::const_iterator last, boost::ptr_vector<bunch_t>& chunks )
+{
+  std::vector<std::string>      errors( chunks.size() );
+  std::vector<WorkerPool::Task> tasks( chunks.size() );
+
+  for ( int k=0; k < chunks.size(); ++k ) {
+    tasks[k] = boost::bind( &trackChunk<bunch_t>, first, last, boost::ref(chunks[k]), boost::ref(errors[k]) );
+  }
+
+  WorkerPool::instance().run( tasks );
+
+  for ( std::vector<std::string>::iterator it = errors.begin(); it != errors.end(); ++it ) {
+    if ( !it->empty() ) {
+      throw GenericException( __FILE__, __LINE__,
+            "void trackChunks( beamline::const_iterator first, beamline::const_iterator last, boost::ptr_vector<bunch_t>& chunks )",
+             *it );
+    }
+  }
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+void propagateSegment( beamline::const_iterator first, beamline::const_iterator last, ParticleBunch& b, int nchunks )
+{
+  //----------------------------------------------------------------------
+  // The particles are moved (not copied) into one bunch per thread,
+  // starting from the back of the bunch so that the order is preserved. 
+  // They are moved back once the threads have completed, even if 
+  // tracking failed, since they belong to the pool of the original bunch. 
+  //----------------------------------------------------------------------
+
+  int const n = b.size();
+
+  boost::ptr_vector<ParticleBunch> chunks;
+
+  for ( int k=0; k < nchunks; ++k ) { 
+    chunks.push_back( new ParticleBunch( b.getReferenceParticle() ) );
+  }
+
+  for ( int k=nchunks-1; k >= 0; --k ) { 
+    int const size = n/nchunks + ( (k < n%nchunks) ? 1 : 0 );
+    chunks[k].transfer( b.end()-size, b.end(), b );
+  }
+
+  try { 
+    trackChunks( first, last, chunks );
+  }
+  catch ( ... ) {
+    for ( int k=0; k < nchunks; ++k ) { b.transfer( chunks[k].begin(), chunks[k].end(), chunks[k] ); }
+    throw;
+  }
+
+  for ( int k=0; k < nchunks; ++k ) { b.transfer( chunks[k].begin(), chunks[k].end(), chunks[k] ); }
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+void propagateSegment( beamline::const_iterator first, beamline::const_iterator last, BunchArrays& b, int nchunks )
+{
+  //----------------------------------------------------------------------
+  // Each thread works on a view of a contiguous range of the arrays.
+  // The range boundaries are kept on multiples of 8 particles so that
+  // each chunk starts on an aligned boundary. 
+  //----------------------------------------------------------------------
+
+  int const n    = b.size();
+  int const size = ( (n + nchunks - 1)/nchunks + 7 ) & ~7;
+
+  boost::ptr_vector<BunchArrays> chunks;
+
+  for ( int begin = 0; begin < n; begin += size ) { 
+    chunks.push_back( new BunchArrays( b, begin, std::min( begin+size, n ) ) );
+  }
+
+  trackChunks( first, last, chunks );
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+template <typename bunch_t >
+void propagate( beamline const& bml, bunch_t& b, int nthreads )
+{
+  int const nchunks = std::min( nthreads, b.size()/min_chunk_size );
+
+  if ( nchunks < 2 || in_worker.get() ) { 
+    ::propagate( bml, b );
+    return;
+  } 
+
+  //------------------------------------------------------------------
+  // runs of non-collective elements are tracked concurrently; 
+  // collective elements are applied to the whole bunch.
+  //------------------------------------------------------------------
+
+  beamline::const_iterator it = bml.begin();
+
+  while ( it != bml.end() ) { 
+
+    if ( (*it)->isCollective() ) {
+      (*it)->propagate( b );
+      ++it;
+      continue;
+    }
+
+    beamline::const_iterator last = it;
+    while ( ( last != bml.end() ) && !(*last)->isCollective() ) { ++last; }
+
+    propagateSegment( it, last, b, nchunks );
+
+    it = last;
+  }
+} 
+
 } // anonymous namespace
 
+int beamline::Propagator::nthreads_ = 1;
+
 //||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
 //||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
 
@@ -78,7 +244,7 @@ beamline::Propagator* beamline::Propagator::clone() const
 
 void beamline::Propagator::operator()( BmlnElmnt const& elm, ParticleBunch& p ) 
 {
-  ::propagate( static_cast<beamline const&>(elm), p);
+  ::propagate( static_cast<beamline const&>(elm), p, numberOfThreads() );
 }
 
 //|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
@@ -92,6 +258,14 @@ void beamline::Propagator::operator()( BmlnElmnt const& elm, JetParticleBunch& p
 //|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
 //|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
 
+void beamline::Propagator::operator()( BmlnElmnt const& elm, BunchArrays& b ) 
+{
+  ::propagate( static_cast<beamline const&>(elm), b, numberOfThreads() );
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
 void beamline::Propagator::operator()( BmlnElmnt const& elm, Particle& p ) 
 {
   ::propagate( static_cast<beamline const&>(elm),p);
@@ -142,3 +316,28 @@ double beamline::Propagator::getReferenceTime()  const
 //||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
 //||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
 
+void beamline::Propagator::setNumberOfThreads( int n )
+{
+  if ( n < 0 ) {
+    throw GenericException( __FILE__, __LINE__,
+          "void beamline::Propagator::setNumberOfThreads( int n )",
+          "The number of threads cannot be negative." );
+  }
+
+  nthreads_ = n;
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+int beamline::Propagator::numberOfThreads()
+{
+  if ( nthreads_ > 0 ) return nthreads_;
+
+  int const n = boost::thread::hardware_concurrency();
+
+  return ( n > 0 ) ? n : 1;
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
@@ -0,0 +1,939 @@
+/*************************************************************************
+**************************************************************************
+**************************************************************************
+******
+******  BEAMLINE:  C++ objects for design and analysis
+******             of beamlines, storage rings, and
+******             synchrotrons.
+******
+******  File:      BeamlineSnapshot.cc
+******
+******  Copyright Fermi Research Alliance / Fermilab
+******            All Rights Reserved
+*****
+******  Usage, modification, and redistribution are subject to terms
+******  of the License supplied with this software.
+******
+******  Software and documentation created under
+******  U.S. Department of Energy Contract No. DE-AC02-07CH11359
+******  The U.S. Government retains a world-wide non-exclusive,
+******  royalty-free license to publish or reproduce documentation
+******  and software for U.S. Government purposes. This software
+******  is protected under the U.S. and Foreign Copyright Laws.
+******
+**************************************************************************
+**************************************************************************
+*************************************************************************/
+
+#include <fstream>
+#include <sstream>
+#include <cstring>
+#include <vector>
+#include <complex>
+#include <typeinfo>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include <basic_toolkit/GenericException.h>
+#include <basic_toolkit/VectorD.h>
+#include <basic_toolkit/Matrix.h>
+#include <basic_toolkit/Frame.h>
+#include <beamline/BeamlineSnapshot.h>
+#include <beamline/beamline.h>
+#include <beamline/Alignment.h>
+#include <beamline/ApertureDecorator.h>
+#include <beamline/Drift.h>
+#include <beamline/marker.h>
+#include <beamline/quadrupole.h>
+#include <beamline/sextupole.h>
+#include <beamline/octupole.h>
+#include <beamline/sbend.h>
+#include <beamline/rbend.h>
+#include <beamline/CF_sbend.h>
+#include <beamline/CF_rbend.h>
+#include <beamline/kick.h>
+#include <beamline/Monitor.h>
+#include <beamline/srot.h>
+#include <beamline/rfcavity.h>
+#include <beamline/Solenoid.h>
+#include <beamline/thinpoles.h>
+#include <beamline/thinMultipole.h>
+#include <beamline/gkick.h>
+#include <beamline/LinacCavity.h>
+#include <beamline/septum.h>
+#include <beamline/Slot.h>
+#include <beamline/BBLens.h>
+#include <beamline/WakeKick.h>
+
+using boost::uint32_t;
+using boost::int32_t;
+using boost::uint64_t;
+
+//------------------------------------------------------------------------------------------
+// File layout. All the sections start on an 8 byte boundary.
+//------------------------------------------------------------------------------------------
+
+struct BeamlineSnapshot::Header {
+
+  char      magic[8];           // "CHEFBML"
+  uint32_t  version;
+  uint32_t  byte_order;         // byte_order_mark, as written
+  uint32_t  header_size;        // sizeof(Header)
+  uint32_t  record_size;        // sizeof(Record)
+
+  uint64_t  nrecords;
+  uint64_t  nchildren;
+  uint64_t  nparameters;
+  uint64_t  nchars;
+
+  uint64_t  records;            // section offsets [ bytes ]
+  uint64_t  children;
+  uint64_t  parameters;
+  uint64_t  strings;
+
+  uint64_t  file_size;
+};
+
+struct BeamlineSnapshot::Record {
+
+  uint32_t  type;
+  uint32_t  flags;
+  uint32_t  name;               // offsets in the string section
+  uint32_t  tag;
+  uint32_t  first_parameter;
+  uint32_t  nparameters;
+  uint32_t  first_child;
+  uint32_t  nchildren;
+
+  double    length;
+  double    strength;           // unscaled strength
+  double    scale;              // momentum scaling factor
+  double    ctRef;
+
+  double    alignment[4];       // Alignment: x and y offsets, roll, pitch
+  double    translation[3];     // alignment decorator
+  double    rotation[3];
+
+  int32_t   aperture_type;
+  uint32_t  unused;
+  double    aperture[2];        // horizontal, vertical
+};
+
+uint32_t const BeamlineSnapshot::format_version = 2;
+
+namespace {
+
+char     const magic[8]        = { 'C', 'H', 'E', 'F', 'B', 'M', 'L', '\0' };
+uint32_t const byte_order_mark = 0x01020304;
+
+enum Type { type_beamline = 0,
+            type_drift,
+            type_marker,
+            type_quadrupole,
+            type_thin_quad,
+            type_sextupole,
+            type_thin_sextupole,
+            type_octupole,
+            type_thin_octupole,
+            type_sbend,
+            type_rbend,
+            type_cf_sbend,
+            type_cf_rbend,
+            type_hkick,
+            type_vkick,
+            type_kick,
+            type_monitor,
+            type_hmonitor,
+            type_vmonitor,
+            type_srot,
+            type_rfcavity,
+            type_thin_rfcavity,
+            type_solenoid,
+            type_thin_2pole,
+            type_thin_12pole,
+            type_thin_14pole,
+            type_thin_16pole,
+            type_thin_18pole,
+            type_thin_multipole,
+            type_gkick,
+            type_linac_cavity,
+            type_thin_septum,
+            type_slot,
+            type_bblens,
+            type_wake_kick,
+            number_of_types };
+
+// number of type specific parameters, by type. A thin multipole stores
+// ( n, re, im ) for each of its poles.
+
+uint32_t const variable = 0xffffffff;
+
+uint32_t const nparameters[number_of_types] = { 1, 0, 0, 2, 0, 2, 0, 0, 0, 5, 5, 8, 8, 0, 0, 1, 1, 1, 1, 0, 5, 5, 0,
+                                                0, 0, 0, 0, 0, variable, 10, 3, 3, 24, 10, 0 };
+
+enum Flags { has_align            = 1<<0,
+             has_alignment        = 1<<1,     // alignment decorator
+             has_aperture         = 1<<2,
+             aperture_outside     = 1<<3,     // the aperture decorator wraps the alignment decorator
+             has_upstream_edge    = 1<<4,
+             has_downstream_edge  = 1<<5,
+             ring                 = 1<<6 };
+
+std::size_t padded( std::size_t n ) { return ( n + 7 ) & ~std::size_t(7); }
+
+//------------------------------------------------------------------------------------------
+
+Type typeOf( BmlnElmnt const& elm )
+{
+  std::type_info const& t = typeid(elm);
+
+  if ( t == typeid(beamline)      ) return type_beamline;
+  if ( t == typeid(Drift)         ) return type_drift;
+  if ( t == typeid(marker)        ) return type_marker;
+  if ( t == typeid(quadrupole)    ) return type_quadrupole;
+  if ( t == typeid(thinQuad)      ) return type_thin_quad;
+  if ( t == typeid(sextupole)     ) return type_sextupole;
+  if ( t == typeid(thinSextupole) ) return type_thin_sextupole;
+  if ( t == typeid(octupole)      ) return type_octupole;
+  if ( t == typeid(thinOctupole)  ) return type_thin_octupole;
+  if ( t == typeid(sbend)         ) return type_sbend;
+  if ( t == typeid(rbend)         ) return type_rbend;
+  if ( t == typeid(CF_sbend)      ) return type_cf_sbend;
+  if ( t == typeid(CF_rbend)      ) return type_cf_rbend;
+  if ( t == typeid(hkick)         ) return type_hkick;
+  if ( t == typeid(vkick)         ) return type_vkick;
+  if ( t == typeid(kick)          ) return type_kick;
+  if ( t == typeid(Monitor)       ) return type_monitor;
+  if ( t == typeid(HMonitor)      ) return type_hmonitor;
+  if ( t == typeid(VMonitor)      ) return type_vmonitor;
+  if ( t == typeid(srot)          ) return type_srot;
+  if ( t == typeid(rfcavity)      ) return type_rfcavity;
+  if ( t == typeid(thinrfcavity)  ) return type_thin_rfcavity;
+  if ( t == typeid(Solenoid)      ) return type_solenoid;
+  if ( t == typeid(thin2pole)     ) return type_thin_2pole;
+  if ( t == typeid(thin12pole)    ) return type_thin_12pole;
+  if ( t == typeid(thin14pole)    ) return type_thin_14pole;
+  if ( t == typeid(thin16pole)    ) return type_thin_16pole;
+  if ( t == typeid(thin18pole)    ) return type_thin_18pole;
+  if ( t == typeid(thinMultipole) ) return type_thin_multipole;
+  if ( t == typeid(gkick)         ) return type_gkick;
+  if ( t == typeid(LinacCavity)   ) return type_linac_cavity;
+  if ( t == typeid(thinSeptum)    ) return type_thin_septum;
+  if ( t == typeid(Slot)          ) return type_slot;
+  if ( t == typeid(BBLens)        ) return type_bblens;
+  if ( t == typeid(WakeKick)      ) return type_wake_kick;
+
+  std::ostringstream uic;
+  uic << "Element " << elm.Name() << " of type " << elm.Type() << " cannot be stored in a snapshot.";
+  throw GenericException( __FILE__, __LINE__,
+          "void BeamlineSnapshot::write( beamline const& bml, std::string const& filename )", uic.str().c_str() );
+}
+
+//------------------------------------------------------------------------------------------
+// values are compared bitwise, so that e.g. -0.0 is restored as -0.0
+//------------------------------------------------------------------------------------------
+
+bool differs( double a, double b )
+{
+  return std::memcmp( &a, &b, sizeof(double) ) != 0;
+}
+
+//------------------------------------------------------------------------------------------
+// bends: bend angle, face angles, entry and exit angles
+//------------------------------------------------------------------------------------------
+
+template <typename Bend>
+void storeAngles( Bend const& b, std::vector<double>& p )
+{
+  p.push_back( b.getBendAngle()      );
+  p.push_back( b.getEntryFaceAngle() );
+  p.push_back( b.getExitFaceAngle()  );
+  p.push_back( b.getEntryAngle()     );
+  p.push_back( b.getExitAngle()      );
+}
+
+template <typename Bend>
+void restoreAngles( Bend& b, double const* p )
+{
+  if ( differs( b.getEntryAngle(), p[3] ) ) { b.setEntryAngle( p[3] ); }
+  if ( differs( b.getExitAngle(),  p[4] ) ) { b.setExitAngle ( p[4] ); }
+}
+
+template <typename Bend>
+void storeMultipoles( Bend const& b, std::vector<double>& p )
+{
+  p.push_back( b.getQuadrupole() );
+  p.push_back( b.getSextupole()  );
+  p.push_back( b.getOctupole()   );
+}
+
+//------------------------------------------------------------------------------------------
+// quadrupoles and sextupoles: order and number of steps of the integrator
+//------------------------------------------------------------------------------------------
+
+template <typename Magnet>
+void storeIntegrator( Magnet const& m, std::vector<double>& p )
+{
+  p.push_back( m.getIntegrator().first  );
+  p.push_back( m.getIntegrator().second );
+}
+
+template <typename Magnet>
+void restoreIntegrator( Magnet& m, double const* p )
+{
+  std::pair<int,int> const integrator( static_cast<int>( p[0] ), static_cast<int>( p[1] ) );
+  if ( integrator != m.getIntegrator() ) { m.setIntegrator( integrator.first, integrator.second ); }
+}
+
+//------------------------------------------------------------------------------------------
+// slots: origin and axes of the in and out frames
+//------------------------------------------------------------------------------------------
+
+void storeFrame( Frame const& f, std::vector<double>& p )
+{
+  Vector  const  origin = f.getOrigin();
+  MatrixD const& axes   = f.getAxes();
+
+  for ( int i=0; i<3; ++i ) { p.push_back( origin[i] ); }
+  for ( int i=0; i<3; ++i ) {
+    for ( int j=0; j<3; ++j ) { p.push_back( axes[i][j] ); }
+  }
+}
+
+Frame restoreFrame( double const* p )
+{
+  Vector  origin(3);
+  MatrixD axes(3,3);
+
+  for ( int i=0; i<3; ++i ) { origin[i] = p[i]; }
+  for ( int i=0; i<3; ++i ) {
+    for ( int j=0; j<3; ++j ) { axes[i][j] = p[3+3*i+j]; }
+  }
+
+  Frame f;
+  f.setOrigin( origin );
+  f.setOrthonormalAxes( axes );
+  return f;
+}
+
+} // anonymous namespace
+
+//------------------------------------------------------------------------------------------
+// store() and restore() read and set the private state of BmlnElmnt (unscaled strength,
+// scaling factor, alignment, propagator decorators); BeamlineSnapshot is a friend.
+//------------------------------------------------------------------------------------------
+
+struct BeamlineSnapshot::Writer {
+
+  std::vector<Record>    records;
+  std::vector<uint32_t>  children;
+  std::vector<double>    parameters;
+  std::string            strings;
+
+  uint32_t intern( std::string const& s )
+  {
+    uint32_t const offset = strings.size();
+    strings.append( s );
+    strings.push_back( '\0' );
+    return offset;
+  }
+};
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+uint32_t BeamlineSnapshot::store( BmlnElmnt const& elm, Writer& w )
+{
+  Type const type = typeOf( elm );
+
+  Record r;
+  std::memset( &r, 0, sizeof(Record) );
+
+  r.type             = type;
+  r.name             = w.intern( elm.Name()   );
+  r.tag              = w.intern( elm.getTag() );
+  r.length           = elm.Length();
+  r.strength         = elm.strength_;
+  r.scale            = elm.pscale_;
+  r.ctRef            = elm.getReferenceTime();
+  r.first_parameter  = w.parameters.size();
+
+  if ( elm.align_ ) {
+    r.flags       |= has_align;
+    r.alignment[0] = elm.align_->xOffset();
+    r.alignment[1] = elm.align_->yOffset();
+    r.alignment[2] = elm.align_->roll();
+    r.alignment[3] = elm.align_->pitch();
+  }
+
+  if ( elm.propagator_->hasAlignment() ) {
+    r.flags |= has_alignment;
+    boost::tuple<Vector,Vector> const a = elm.getAlignment();
+    for ( int i=0; i<3; ++i ) {
+      r.translation[i] = a.get<0>()[i];
+      r.rotation[i]    = a.get<1>()[i];
+    }
+  }
+
+  if ( elm.propagator_->hasAperture() ) {
+    r.flags |= has_aperture;
+    if ( dynamic_cast<ApertureDecorator const*>( elm.propagator_.get() ) ) { r.flags |= aperture_outside; }
+    boost::tuple<BmlnElmnt::aperture_t, double, double> const a = elm.aperture();
+    r.aperture_type = a.get<0>();
+    r.aperture[0]   = a.get<1>();
+    r.aperture[1]   = a.get<2>();
+  }
+
+  if ( elm.hasUpstreamEdge()   ) { r.flags |= has_upstream_edge;   }
+  if ( elm.hasDownstreamEdge() ) { r.flags |= has_downstream_edge; }
+
+  std::vector<double>& p = w.parameters;
+
+  switch ( type ) {
+
+    case type_beamline: {
+      beamline const& bml = static_cast<beamline const&>( elm );
+      p.push_back( bml.Momentum() );
+      if ( bml.getLineMode() == beamline::ring ) { r.flags |= ring; }
+      break;
+    }
+    case type_sbend:     storeAngles( static_cast<sbend    const&>( elm ), p );  break;
+    case type_rbend:     storeAngles( static_cast<rbend    const&>( elm ), p );  break;
+    case type_cf_sbend:
+      storeAngles    ( static_cast<CF_sbend const&>( elm ), p );
+      storeMultipoles( static_cast<CF_sbend const&>( elm ), p );
+      break;
+    case type_cf_rbend:
+      storeAngles    ( static_cast<CF_rbend const&>( elm ), p );
+      storeMultipoles( static_cast<CF_rbend const&>( elm ), p );
+      break;
+    case type_kick:
+      p.push_back( static_cast<kick const&>( elm ).getVerStrength() );
+      break;
+    case type_monitor:
+    case type_hmonitor:
+    case type_vmonitor:
+      p.push_back( static_cast<MonitorBase const&>( elm ).getDriftFraction() );
+      break;
+    case type_rfcavity: {
+      rfcavity const& rf = static_cast<rfcavity const&>( elm );
+      p.push_back( rf.frequency() );
+      p.push_back( rf.phi()       );
+      p.push_back( rf.Q()         );
+      p.push_back( rf.R()         );
+      p.push_back( rf.harmon()    );
+      break;
+    }
+    case type_thin_rfcavity: {
+      thinrfcavity const& rf = static_cast<thinrfcavity const&>( elm );
+      p.push_back( rf.frequency() );
+      p.push_back( rf.phi()       );
+      p.push_back( rf.Q()         );
+      p.push_back( rf.R()         );
+      p.push_back( rf.harmon()    );
+      break;
+    }
+    case type_quadrupole: storeIntegrator( static_cast<quadrupole const&>( elm ), p ); break;
+    case type_sextupole:  storeIntegrator( static_cast<sextupole  const&>( elm ), p ); break;
+    case type_thin_multipole: {
+      thinMultipole const& m = static_cast<thinMultipole const&>( elm );
+      for ( thinMultipole::const_iterator it = m.begin(); it != m.end(); ++it ) {
+        p.push_back( it->first         );
+        p.push_back( it->second.real() );
+        p.push_back( it->second.imag() );
+      }
+      break;
+    }
+    case type_gkick: {
+      gkick const& k = static_cast<gkick const&>( elm );
+      p.push_back( k.xOffset()  );
+      p.push_back( k.xpOffset() );
+      p.push_back( k.yOffset()  );
+      p.push_back( k.ypOffset() );
+      p.push_back( k.lOffset()  );
+      p.push_back( k.pOffset()  );
+      p.push_back( k.angle()    );
+      p.push_back( k.zOffset()  );
+      p.push_back( k.v()        );
+      p.push_back( k.t()        );
+      break;
+    }
+    case type_linac_cavity: {
+      LinacCavity const& rf = static_cast<LinacCavity const&>( elm );
+      p.push_back( rf.frequency() );
+      p.push_back( rf.phi()       );
+      p.push_back( rf.wakeOn() ? 1.0 : 0.0 );
+      break;
+    }
+    case type_thin_septum: {
+      thinSeptum const& s = static_cast<thinSeptum const&>( elm );
+      p.push_back( s.getPosStrength() );
+      p.push_back( s.getNegStrength() );
+      p.push_back( s.getWireX()       );
+      break;
+    }
+    case type_slot:
+      storeFrame( static_cast<Slot const&>( elm ).getInFrame(),  p );
+      storeFrame( static_cast<Slot const&>( elm ).getOutFrame(), p );
+      break;
+    case type_bblens: {
+      BBLens const& bb = static_cast<BBLens const&>( elm );
+      p.push_back( bb.num_   );
+      p.push_back( bb.gamma_ );
+      p.push_back( bb.beta_  );
+      for ( int i=0; i<3; ++i ) { p.push_back( bb.emittance_[i] ); }
+      for ( int i=0; i<3; ++i ) { p.push_back( i < int( bb.sigmas_.size() ) ? bb.sigmas_[i] : 0.0 ); }
+      p.push_back( bb.useRound );
+      break;
+    }
+    default:
+      break;
+  }
+
+  r.nparameters = w.parameters.size() - r.first_parameter;
+
+  uint32_t const index = w.records.size();
+  w.records.push_back( r );
+
+  if ( type == type_beamline ) {
+
+    beamline const& bml = static_cast<beamline const&>( elm );
+
+    std::vector<uint32_t> children;
+    for ( beamline::const_iterator it = bml.begin(); it != bml.end(); ++it ) {
+      children.push_back( store( **it, w ) );
+    }
+
+    w.records[index].first_child = w.children.size();
+    w.records[index].nchildren   = children.size();
+    w.children.insert( w.children.end(), children.begin(), children.end() );
+  }
+
+  return index;
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+void BeamlineSnapshot::restore( BmlnElmnt& elm, Record const& r, double const* p )
+{
+  //---------------------------------------------------------------------------------
+  // elm has been constructed from its type specific parameters. The remaining state
+  // is restored in the order a factory sets it, the reference time last.
+  //---------------------------------------------------------------------------------
+
+  if ( r.type != type_beamline ) {
+
+    if ( differs( elm.strength_, r.strength ) ) { elm.setStrength( r.strength ); }   // pscale_ is still 1
+    if ( r.scale != 1.0 )              { elm.setStrengthScale( r.scale ); }
+
+    if ( r.type == type_kick ) { static_cast<kick&>( elm ).setVerStrength( p[0] ); }
+  }
+
+  bool const usedge = ( r.flags & has_upstream_edge   ) != 0;
+  bool const dsedge = ( r.flags & has_downstream_edge ) != 0;
+
+  if ( ( usedge != elm.hasUpstreamEdge() ) || ( dsedge != elm.hasDownstreamEdge() ) ) {
+    elm.enableEdges( usedge, dsedge );
+  }
+
+  if ( r.flags & has_align ) {
+    elm.align_ = new Alignment( r.alignment[0], r.alignment[1], r.alignment[2], r.alignment[3] );
+  }
+
+  Vector translation(3);
+  Vector rotation(3);
+  for ( int i=0; i<3; ++i ) {
+    translation[i] = r.translation[i];
+    rotation[i]    = r.rotation[i];
+  }
+
+  BmlnElmnt::aperture_t const aperture = BmlnElmnt::aperture_t( r.aperture_type );
+
+  if ( r.flags & aperture_outside ) {
+    if ( r.flags & has_alignment ) { elm.setAlignment( translation, rotation ); }
+    elm.setAperture( aperture, r.aperture[0], r.aperture[1] );
+  }
+  else {
+    if ( r.flags & has_aperture  ) { elm.setAperture( aperture, r.aperture[0], r.aperture[1] ); }
+    if ( r.flags & has_alignment ) { elm.setAlignment( translation, rotation ); }
+  }
+
+  elm.setReferenceTime( r.ctRef );
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+void BeamlineSnapshot::write( beamline const& bml, std::string const& filename )
+{
+  Writer w;
+  store( bml, w );
+
+  Header h;
+  std::memset( &h, 0, sizeof(Header) );
+
+  std::memcpy( h.magic, magic, sizeof(magic) );
+  h.version      = format_version;
+  h.byte_order   = byte_order_mark;
+  h.header_size  = sizeof(Header);
+  h.record_size  = sizeof(Record);
+
+  h.nrecords     = w.records.size();
+  h.nchildren    = w.children.size();
+  h.nparameters  = w.parameters.size();
+  h.nchars       = w.strings.size();
+
+  h.records      = padded( sizeof(Header) );
+  h.children     = padded( h.records    + h.nrecords    * sizeof(Record)   );
+  h.parameters   = padded( h.children   + h.nchildren   * sizeof(uint32_t) );
+  h.strings      = padded( h.parameters + h.nparameters * sizeof(double)   );
+  h.file_size    = h.strings + h.nchars;
+
+  std::ofstream os( filename.c_str(), std::ios::out | std::ios::binary | std::ios::trunc );
+
+  if ( !os ) {
+    throw GenericException( __FILE__, __LINE__,
+            "void BeamlineSnapshot::write( beamline const& bml, std::string const& filename )",
+            ( "Cannot open " + filename + " for writing." ).c_str() );
+  }
+
+  char const zeros[8] = { 0, 0, 0, 0, 0, 0, 0, 0 };
+
+  os.write( reinterpret_cast<char const*>( &h ), sizeof(Header) );
+  os.write( zeros, h.records - sizeof(Header) );
+
+  if ( h.nrecords    ) { os.write( reinterpret_cast<char const*>( &w.records[0]    ), h.nrecords    * sizeof(Record)   ); }
+  os.write( zeros, h.children - ( h.records + h.nrecords * sizeof(Record) ) );
+
+  if ( h.nchildren   ) { os.write( reinterpret_cast<char const*>( &w.children[0]   ), h.nchildren   * sizeof(uint32_t) ); }
+  os.write( zeros, h.parameters - ( h.children + h.nchildren * sizeof(uint32_t) ) );
+
+  if ( h.nparameters ) { os.write( reinterpret_cast<char const*>( &w.parameters[0] ), h.nparameters * sizeof(double)   ); }
+  os.write( zeros, h.strings - ( h.parameters + h.nparameters * sizeof(double) ) );
+
+  os.write( w.strings.data(), h.nchars );
+
+  if ( !os ) {
+    throw GenericException( __FILE__, __LINE__,
+            "void BeamlineSnapshot::write( beamline const& bml, std::string const& filename )",
+            ( "Error writing " + filename + "." ).c_str() );
+  }
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+BeamlineSnapshot::BeamlineSnapshot( std::string const& filename )
+  : filename_(filename), map_(0), size_(0),
+    header_(0), records_(0), children_(0), parameters_(0), strings_(0)
+{
+  static char const* const fname = "BeamlineSnapshot::BeamlineSnapshot( std::string const& filename )";
+
+  int const fd = open( filename.c_str(), O_RDONLY );
+
+  if ( fd < 0 ) {
+    throw GenericException( __FILE__, __LINE__, fname, ( "Cannot open " + filename + "." ).c_str() );
+  }
+
+  struct stat st;
+  if ( fstat( fd, &st ) != 0 || std::size_t( st.st_size ) < sizeof(Header) ) {
+    close( fd );
+    throw GenericException( __FILE__, __LINE__, fname, ( filename + " is not a beamline snapshot." ).c_str() );
+  }
+
+  size_ = st.st_size;
+  map_  = mmap( 0, size_, PROT_READ, MAP_PRIVATE, fd, 0 );
+  close( fd );
+
+  if ( map_ == MAP_FAILED ) {
+    map_ = 0;
+    throw GenericException( __FILE__, __LINE__, fname, ( "Cannot map " + filename + "." ).c_str() );
+  }
+
+  //---------------------------------------------------------------------------------
+  // the header and the section bounds are checked once; the records can then be
+  // read without further checks.
+  //---------------------------------------------------------------------------------
+
+  char const* const base = static_cast<char const*>( map_ );
+  Header const& h = *reinterpret_cast<Header const*>( base );
+
+  std::string error;
+
+  if ( std::memcmp( h.magic, magic, sizeof(magic) ) != 0 ) {
+    error = " is not a beamline snapshot.";
+  }
+  else if ( h.byte_order != byte_order_mark ) {
+    error = " was written on a machine with a different byte order.";
+  }
+  else if ( h.version != format_version ) {
+    std::ostringstream uic;
+    uic << " has format version " << h.version << "; version " << format_version << " is expected.";
+    error = uic.str();
+  }
+  else if ( h.header_size != sizeof(Header) || h.record_size != sizeof(Record) ) {
+    error = " has an unexpected record layout.";
+  }
+  else if (    h.file_size != size_ || h.nrecords == 0
+            || h.records    + h.nrecords    * sizeof(Record)   > h.children
+            || h.children   + h.nchildren   * sizeof(uint32_t) > h.parameters
+            || h.parameters + h.nparameters * sizeof(double)   > h.strings
+            || h.strings    + h.nchars                          > h.file_size
+            || h.nchars == 0 || base[h.file_size-1] != '\0' ) {
+    error = " is truncated or corrupt.";
+  }
+
+  if ( error.empty() ) {
+
+    header_     = &h;
+    records_    = reinterpret_cast<Record   const*>( base + h.records    );
+    children_   = reinterpret_cast<uint32_t const*>( base + h.children   );
+    parameters_ = reinterpret_cast<double   const*>( base + h.parameters );
+    strings_    = base + h.strings;
+
+    for ( uint64_t i=0; i < h.nrecords && error.empty(); ++i ) {
+
+      Record const& r = records_[i];
+
+      bool ok =    r.type < number_of_types
+                && ( nparameters[r.type] == variable ? r.nparameters % 3 == 0
+                                                     : r.nparameters == nparameters[r.type] )
+                && uint64_t( r.first_parameter ) + r.nparameters <= h.nparameters
+                && r.name < h.nchars && r.tag < h.nchars
+                && uint64_t( r.first_child ) + r.nchildren <= h.nchildren
+                && ( r.type == type_beamline || r.nchildren == 0 );
+
+      // children follow their line (pre-order); this also excludes cycles
+
+      for ( uint32_t j=0; ok && j < r.nchildren; ++j ) {
+        uint32_t const c = children_[ r.first_child + j ];
+        ok = ( c > i ) && ( c < h.nrecords );
+      }
+
+      if ( !ok ) { error = " is truncated or corrupt."; }
+    }
+
+    if ( error.empty() && records_[0].type != type_beamline ) {
+      error = " does not hold a beamline.";
+    }
+  }
+
+  if ( !error.empty() ) {
+    munmap( map_, size_ );
+    map_ = 0;
+    throw GenericException( __FILE__, __LINE__, fname, ( filename + error ).c_str() );
+  }
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+BeamlineSnapshot::~BeamlineSnapshot()
+{
+  if ( map_ ) { munmap( map_, size_ ); }
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+int BeamlineSnapshot::numberOfRecords() const
+{
+  return header_->nrecords;
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+std::string BeamlineSnapshot::name() const
+{
+  return string( records_[0].name );
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+char const* BeamlineSnapshot::string( uint32_t offset ) const
+{
+  return strings_ + offset;
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+BmlPtr BeamlineSnapshot::instantiate() const
+{
+  return boost::static_pointer_cast<beamline>( instantiate( records_[0] ) );
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+ElmPtr BeamlineSnapshot::instantiate( Record const& r ) const
+{
+  std::string const   name = string( r.name );
+  double const* const p    = parameters_ + r.first_parameter;
+
+  double const L = r.length;
+  double const s = r.strength;
+
+  ElmPtr elm;
+
+  switch ( Type( r.type ) ) {
+
+    case type_beamline: {
+      BmlPtr bml( new beamline( name ) );
+      bml->setMomentum( p[0] );
+      bml->setLineMode( ( r.flags & ring ) ? beamline::ring : beamline::line );
+      for ( uint32_t j=0; j < r.nchildren; ++j ) {
+        bml->append( instantiate( records_[ children_[ r.first_child + j ] ] ) );
+      }
+      elm = bml;
+      break;
+    }
+
+    case type_drift:          elm = ElmPtr( new Drift        ( name, L    ) ); break;
+    case type_marker:         elm = ElmPtr( new marker       ( name       ) ); break;
+    case type_quadrupole: {
+      quadrupole* q = new quadrupole( name, L, s );
+      elm = ElmPtr( q );
+      restoreIntegrator( *q, p );
+      break;
+    }
+    case type_thin_quad:      elm = ElmPtr( new thinQuad     ( name,    s ) ); break;
+    case type_sextupole: {
+      sextupole* q = new sextupole( name, L, s );
+      elm = ElmPtr( q );
+      restoreIntegrator( *q, p );
+      break;
+    }
+    case type_thin_sextupole: elm = ElmPtr( new thinSextupole( name,    s ) ); break;
+    case type_octupole:       elm = ElmPtr( new octupole     ( name, L, s ) ); break;
+    case type_thin_octupole:  elm = ElmPtr( new thinOctupole ( name,    s ) ); break;
+    case type_hkick:          elm = ElmPtr( new hkick        ( name, L, s ) ); break;
+    case type_vkick:          elm = ElmPtr( new vkick        ( name, L, s ) ); break;
+    case type_kick:           elm = ElmPtr( new kick         ( name, L, s, 0.0 ) ); break;
+    case type_srot:           elm = ElmPtr( new srot         ( name,    s ) ); break;
+    case type_solenoid:       elm = ElmPtr( new Solenoid     ( name.c_str(), L, s ) ); break;
+    case type_thin_2pole:     elm = ElmPtr( new thin2pole    ( name,    s ) ); break;
+    case type_thin_12pole:    elm = ElmPtr( new thin12pole   ( name,    s ) ); break;
+    case type_thin_14pole:    elm = ElmPtr( new thin14pole   ( name,    s ) ); break;
+    case type_thin_16pole:    elm = ElmPtr( new thin16pole   ( name,    s ) ); break;
+    case type_thin_18pole:    elm = ElmPtr( new thin18pole   ( name,    s ) ); break;
+    case type_wake_kick:      elm = ElmPtr( new WakeKick     ( name       ) ); break;
+
+    case type_thin_multipole: {
+      thinMultipole* m = new thinMultipole( name );
+      elm = ElmPtr( m );
+      for ( uint32_t j=0; j < r.nparameters; j += 3 ) {
+        m->setPole( int( p[j] ), std::complex<double>( p[j+1], p[j+2] ) );
+      }
+      break;
+    }
+    case type_gkick: {
+      gkick* k = new gkick();
+      elm = ElmPtr( k );
+      k->rename( name );
+      if ( L != 0.0 ) { k->setLength( L ); }
+      k->set_dx   ( p[0] );
+      k->set_dxp  ( p[1] );
+      k->set_dy   ( p[2] );
+      k->set_dyp  ( p[3] );
+      k->set_dl   ( p[4] );
+      k->set_dp   ( p[5] );
+      k->set_angle( p[6] );
+      k->set_dz   ( p[7] );
+      k->set_v    ( p[8] );
+      k->set_t    ( p[9] );
+      break;
+    }
+    case type_linac_cavity: {
+      LinacCavity* rf = new LinacCavity( name, L, p[0], s, p[1], p[2] != 0.0 );
+      elm = ElmPtr( rf );
+      break;
+    }
+    case type_thin_septum: elm = ElmPtr( new thinSeptum( name, p[0], p[1], p[2] ) ); break;
+    case type_slot: {
+      Slot* slot = new Slot( name );
+      elm = ElmPtr( slot );
+      slot->setInFrame ( restoreFrame( p      ) );
+      slot->setOutFrame( restoreFrame( p + 12 ) );
+      if ( differs( slot->Length(), L ) ) { slot->setLength( L ); }
+      break;
+    }
+    case type_bblens: {
+      BBLens* bb = new BBLens( name, L, s, p[1] );
+      elm = ElmPtr( bb );
+      bb->num_   = p[0];
+      bb->beta_  = p[2];
+      for ( int i=0; i<3; ++i ) { bb->emittance_[i] = p[3+i]; }
+      bb->sigmas_.assign( p+6, p+9 );
+      bb->useRound = char( p[9] );
+      break;
+    }
+
+    case type_sbend: {
+      sbend* b = new sbend( name, L, s, p[0], p[1], p[2] );
+      elm = ElmPtr( b );
+      restoreAngles( *b, p );
+      break;
+    }
+    case type_rbend: {
+      rbend* b = new rbend( name, L, s, p[0], p[1], p[2] );
+      elm = ElmPtr( b );
+      restoreAngles( *b, p );
+      break;
+    }
+    case type_cf_sbend: {
+      CF_sbend* b = new CF_sbend( name, L, s, p[0], p[1], p[2] );
+      elm = ElmPtr( b );
+      restoreAngles( *b, p );
+      // CF_sbend returns integrated multipoles
+      if ( p[5] != 0.0 ) { b->setQuadrupole( p[5]/L ); }
+      if ( p[6] != 0.0 ) { b->setSextupole ( p[6]/L ); }
+      if ( p[7] != 0.0 ) { b->setOctupole  ( p[7]/L ); }
+      break;
+    }
+    case type_cf_rbend: {
+      CF_rbend* b = new CF_rbend( name, L, s, p[0], p[1], p[2] );
+      elm = ElmPtr( b );
+      restoreAngles( *b, p );
+      if ( p[5] != 0.0 ) { b->setQuadrupole( p[5] ); }
+      if ( p[6] != 0.0 ) { b->setSextupole ( p[6] ); }
+      if ( p[7] != 0.0 ) { b->setOctupole  ( p[7] ); }
+      break;
+    }
+
+    case type_monitor:  { Monitor*  m = new Monitor ( name, L ); elm = ElmPtr( m ); m->setDriftFraction( p[0] ); break; }
+    case type_hmonitor: { HMonitor* m = new HMonitor( name, L ); elm = ElmPtr( m ); m->setDriftFraction( p[0] ); break; }
+    case type_vmonitor: { VMonitor* m = new VMonitor( name, L ); elm = ElmPtr( m ); m->setDriftFraction( p[0] ); break; }
+
+    case type_rfcavity: {
+      rfcavity* rf = new rfcavity( name, L, p[0], s*1.0e9, p[1], p[2], p[3] );
+      elm = ElmPtr( rf );
+      if ( differs( rf->harmon(), p[4] ) ) { rf->setHarmon( p[4] ); }
+      break;
+    }
+    case type_thin_rfcavity: {
+      thinrfcavity* rf = new thinrfcavity( name, p[0], s*1.0e9, p[1], p[2], p[3] );
+      elm = ElmPtr( rf );
+      if ( differs( rf->harmon(), p[4] ) ) { rf->setHarmon( p[4] ); }
+      break;
+    }
+
+    default:
+      break;  // excluded by the constructor
+  }
+
+  elm->setTag( string( r.tag ) );
+
+  restore( *elm, r, p );
+
+  return elm;
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
@@ -45,6 +45,8 @@
 #include <beamline/beamline.h>
 #include <beamline/Bend.h>
 #include <beamline/BendPropagators.h>
+#include <beamline/BunchArrays.h>
+#include <cmath>
 #include <beamline/beamline.h>
 
 using namespace PhysicsConstants; 
@@ -123,6 +125,91 @@ void propagate( std::complex<double> const& propPhase,
  state[i_npx]   =   imag( vuf )/( E_factor * PH_MKS_c );
 }
 
+//-----------------------------------------------------------------------------------------
+// bunch (SoA) version. This is the same algorithm as above, with the complex 
+// arithmetic written out in terms of real and imaginary parts so that the 
+// loop body does not depend on std::complex and can be vectorized.  
+//-----------------------------------------------------------------------------------------
+
+void propagate( std::complex<double> const& propPhase, 
+                std::complex<double> const& propTerm, double const& dphi, Bend const& elm, BunchArrays& b ) 
+{
+ static const double csq_red = PH_MKS_c * PH_MKS_c * 1.0e-9;
+
+ Particle const& ref = b.getReferenceParticle();
+
+ double const pn     = ref.pn();
+ double const ipnsq  = 1.0/(pn*pn);
+ double const p0     = ref.refMomentum();
+ double const m      = ref.mass();
+ double const ctRef  = elm.getReferenceTime();
+ double const wfac   = csq_red * elm.Strength(); 
+
+ double const ph_re  = real(propPhase);
+ double const ph_im  = imag(propPhase);
+ double const pt_re  = real(propTerm);
+ double const pt_im  = imag(propTerm);
+
+ int    const n      = b.size();
+
+ double* const x   = b[i_x];
+ double* const y   = b[i_y];
+ double* const cdt = b[i_cdt];
+ double* const npx = b[i_npx];
+ double const* const npy = b[i_npy];
+ double const* const ndp = b[i_ndp];
+
+ for ( int j=0; j<n; ++j ) { 
+
+   double const dpp      = 1.0 + ndp[j];
+   double const psq      = dpp*dpp;
+   double const npz      = std::sqrt( psq - npx[j]*npx[j] - npy[j]*npy[j] );
+
+   double const E_factor = 1.0 / std::sqrt( psq + ipnsq );
+
+   double const beta_1   = E_factor * npx[j];
+   double const beta_2   = E_factor * npy[j];
+   double const beta_3   = E_factor * npz;
+
+   double const pc       = p0*dpp;
+   double const omega    = wfac / std::sqrt( pc*pc + m*m );   // FIXME: fails when charge is not +1  
+
+   // vui = c*beta_3 + i c*beta_1 ;  bi = i*vui/omega - i*x 
+
+   double const vui_re   = PH_MKS_c*beta_3;
+   double const vui_im   = PH_MKS_c*beta_1;
+
+   double const bi_re    = -vui_im/omega;
+   double const bi_im    =  vui_re/omega - x[j];
+
+   // bf = bi*propPhase + propTerm
+
+   double const bf_re    = bi_re*ph_re - bi_im*ph_im + pt_re;
+   double const bf_im    = bi_re*ph_im + bi_im*ph_re + pt_im;
+
+   double const rho      = PH_MKS_c * std::sqrt( beta_1*beta_1 + beta_3*beta_3 ) / omega;
+   double const dthmdphi = std::asin( bi_re/rho ) - std::asin( bf_re/rho );
+
+   double const c        = std::cos( dthmdphi ); 
+   double const s        = std::sin( dthmdphi ); 
+
+   // uf = (ui + bi)*expF - bf ; vuf = vui*expF 
+
+   double const a_re     = bi_re;
+   double const a_im     = x[j] + bi_im;
+
+   double const uf_im    = a_re*s + a_im*c - bf_im;
+   double const vuf_im   = vui_re*s + vui_im*c;
+
+   double const dcdt     = - PH_MKS_c * ( dthmdphi + dphi ) / omega;
+
+   x[j]    =  uf_im;
+   y[j]   +=  beta_2*dcdt;
+   cdt[j] +=  dcdt - ctRef;
+   npx[j]  =  vuf_im/( E_factor * PH_MKS_c );
+ }
+}
+
 } // namespace
 
 //|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
@@ -227,6 +314,14 @@ void Bend::Propagator::operator()( BmlnElmnt const& elm, JetParticle& p )
   ::propagate( propPhase_, propTerm_, dphi_, static_cast<Bend const&>(elm), p);
 }
 
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+void Bend::Propagator::operator()( BmlnElmnt const& elm, BunchArrays& b ) 
+{
+  ::propagate( propPhase_, propTerm_, dphi_, static_cast<Bend const&>(elm), b);
+}
+
 //||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
 //||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
 
@@ -63,6 +63,8 @@
 
 #include <typeinfo>
 #include <string>
+#include <boost/scoped_ptr.hpp>
+#include <boost/detail/atomic_count.hpp>
 
 #include <iomanip>
 #include <basic_toolkit/iosetup.h>
@@ -72,6 +74,7 @@
 #include <beamline/JetParticle.h>
 #include <beamline/ParticleBunch.h>
 #include <beamline/TBunch.h>
+#include <beamline/BunchArrays.h>
 #include <beamline/ApertureDecorator.h>
 #include <beamline/AlignmentDecorator.h>
 #include <beamline/beamline.h>
@@ -219,6 +222,42 @@ bool BmlnElmnt::PinnedFrameSet::altered()  const
 //   class BmlnElmnt
 // **************************************************
 
+unsigned long BmlnElmnt::nextSerial()
+{
+  static boost::detail::atomic_count count(0);
+  return ++count;
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+namespace {
+
+boost::detail::atomic_count& modificationTotal()
+{
+  static boost::detail::atomic_count count(0);
+  return count;
+}
+
+} // namespace
+
+void BmlnElmnt::markModified()
+{
+  ++modcount_;
+  ++modificationTotal();
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+unsigned long BmlnElmnt::modifications()
+{
+  return modificationTotal();
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
 BmlnElmnt::BmlnElmnt( std::string const&  n, double const& l, double const& s) 
   : ident_( n ),      
     length_(l),     
@@ -229,7 +268,9 @@ BmlnElmnt::BmlnElmnt( std::string const&  n, double const& l, double const& s)
     attributes_(),
     tag_(), 
     usedge_(false),
-    dsedge_(false)
+    dsedge_(false),
+    modcount_(0),
+    serial_( nextSerial() )
 {
   if( length_ < 0 ) {
     ostringstream uic;
@@ -255,7 +296,9 @@ BmlnElmnt::BmlnElmnt( BmlnElmnt const& o )
                 attributes_(o.attributes_),
                        tag_(o.tag_),
                     usedge_(o.usedge_),
-                    dsedge_(o.dsedge_)
+                    dsedge_(o.dsedge_),
+                  modcount_(0),
+                   serial_( nextSerial() )
 {                  
      align_ = o.align_  ? new Alignment(*o.align_)  : 0;
 
@@ -280,6 +323,8 @@ BmlnElmnt& BmlnElmnt::operator=( BmlnElmnt const& rhs )
     tag_          = rhs.tag_;
     propagator_   = PropagatorPtr(rhs.propagator_->clone());
 
+    markModified();
+
     return *this;
 }
 
@@ -320,6 +365,14 @@ bool BmlnElmnt::isBeamline() const
 //||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
 //||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
 
+bool BmlnElmnt::isCollective() const
+{                   
+  return propagator_->isCollective();
+}
+
+//||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
 void BmlnElmnt::setLength( double const& length ) 
 {
 
@@ -357,6 +410,7 @@ void BmlnElmnt::setLength( double const& length )
   // Notify propagator of attribute change  
 
   propagator_->setAttribute(*this, "LENGTH", length );
+  markModified();
 
 }
 
@@ -378,6 +432,7 @@ void  BmlnElmnt::setStrengthScale( double const& value )
   // Notify propagator of attribute change  
 
   propagator_->setAttribute(*this, "STRENGTH_SCALE", value );
+  markModified();
 
 }
 
@@ -415,6 +470,7 @@ void BmlnElmnt::setStrength( double const& s )
   // Notify propagator of attribute change  
  
   propagator_->setAttribute(*this, "STRENGTH", s );
+  markModified();
 
 }
 
@@ -444,6 +500,7 @@ bool BmlnElmnt::alignRelX( double const& u )
   if( hasParallelFaces() ) {
     if ( !align_ ) { align_ = new Alignment(); }
     align_->setXOffset( align_->xOffset() + u );
+    markModified();
   }
   else {
     (*pcerr) << "\n*** WARNING *** "
@@ -471,6 +528,7 @@ bool BmlnElmnt::alignRelY( double const& u )
   if( hasParallelFaces() ) {
     if ( !align_ ) { align_ = new Alignment(); }
     align_->setYOffset( align_->yOffset() + u );
+    markModified();
   }
   else {
     (*pcerr) << "\n*** WARNING *** "
@@ -499,6 +557,7 @@ bool BmlnElmnt::alignAbsX( double const& u )
   if( hasParallelFaces() ) {
     if ( !align_ ) { align_ = new Alignment(); }
     align_->setXOffset( u );
+    markModified();
   }
 
   else {
@@ -527,6 +586,7 @@ bool BmlnElmnt::alignAbsY( double const& u )
   if( hasParallelFaces() ) {
     if ( !align_ ) { align_ = new Alignment(); }
     align_->setYOffset( u );
+    markModified();
   }
 
   else {
@@ -592,6 +652,7 @@ bool BmlnElmnt::alignRelRoll( double const& u )
 
     if ( !align_) { align_ = new Alignment(); } 
     align_->setRoll( align_->roll() + u );
+    markModified();
   }
   else {
     (*pcerr) << "\n*** WARNING *** "
@@ -619,6 +680,7 @@ bool BmlnElmnt::alignAbsRoll( double const& u )
   if( hasParallelFaces() && hasStandardFaces() ) {
     if (!align_) { align_ = new Alignment(); } 
     align_->setRoll( u );
+    markModified();
   }
   else {
     (*pcerr) << "\n*** WARNING *** "
@@ -808,6 +870,8 @@ bool BmlnElmnt::setAlignment(Alignment const& a)
 {
   realign();
 
+  markModified();
+
   if (!align_) align_ = new Alignment(); //  this is necessary because realign() deletes the alignment object ...   
                                          //  realign() remains an unfinished kludge ! 
 
@@ -868,7 +932,10 @@ double BmlnElmnt::getReferenceTime() const
 
 void BmlnElmnt::setReferenceTime( double ct )
 {
+  if ( ct == propagator_->getReferenceTime() ) return;  // registering an unchanged reference is not a modification
+
   propagator_->setReferenceTime( ct );
+  markModified();
 }
 
 //|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
@@ -887,6 +954,7 @@ void BmlnElmnt::enableEdges(bool usedge, bool dsedge)
    usedge_= usedge;
    dsedge_= dsedge;
    propagator_->ctor(*this);
+   markModified();
 }
 
 //|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
@@ -1113,6 +1181,34 @@ void BmlnElmnt::propagate( JetParticleBunch& x ) const
   }
 }
 
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+void BmlnElmnt::propagate( BunchArrays& b ) const
+{
+
+  if( !align_  ) {
+    localPropagate  ( b );
+    return;
+  }
+
+  // frame changes are applied one particle at a time 
+
+  boost::scoped_ptr<Particle> p( b.getReferenceParticle().clone() );
+
+  for ( int j=0; j < b.size(); ++j ) { 
+    if ( b.isLost(j) ) continue;
+    b.getParticle(j, *p); enterLocalFrame( *p ); b.setParticle(j, *p);
+  }
+
+  localPropagate  ( b );
+
+  for ( int j=0; j < b.size(); ++j ) { 
+    if ( b.isLost(j) ) continue;
+    b.getParticle(j, *p); leaveLocalFrame( *p ); b.setParticle(j, *p);
+  }
+}
+
 //||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
 //||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
 
@@ -1149,6 +1245,14 @@ void BmlnElmnt::localPropagate( JetParticleBunch& b ) const
 //||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
 //||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
 
+void BmlnElmnt::localPropagate( BunchArrays& b ) const
+{
+  (*propagator_)(*this, b);
+}
+
+//||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
 double BmlnElmnt::OrbitLength( Particle const& ) const
 { 
   return length_; 
@@ -1174,6 +1278,7 @@ void BmlnElmnt::setAperture( BmlnElmnt::aperture_t type, double hor, double ver)
   }
   
   propagator_->setAperture( type, hor, ver);
+  markModified();
 }
 
 
@@ -1196,6 +1301,7 @@ void  BmlnElmnt::setAlignment( Vector const& translation, Vector const& rotation
        PropagatorPtr( new AlignmentDecorator( PropagatorPtr( propagator_->clone() ) ) ); 
   }
   propagator_->setAlignment( translation, rotation );
+  markModified();
 }
 
 //||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
@@ -0,0 +1,354 @@
+/*************************************************************************
+**************************************************************************
+**************************************************************************
+******
+******  BEAMLINE:  C++ objects for design and analysis
+******             of beamlines, storage rings, and
+******             synchrotrons.
+******
+******  File:      BunchArrays.cc
+******
+******  Copyright Fermi Research Alliance / Fermilab
+******            All Rights Reserved
+*****
+******  Usage, modification, and redistribution are subject to terms
+******  of the License supplied with this software.
+******
+******  Software and documentation created under
+******  U.S. Department of Energy Contract No. DE-AC02-07CH11359
+******  The U.S. Government retains a world-wide non-exclusive,
+******  royalty-free license to publish or reproduce documentation
+******  and software for U.S. Government purposes. This software
+******  is protected under the U.S. and Foreign Copyright Laws.
+******
+**************************************************************************
+**************************************************************************
+*************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include <new>
+#include <algorithm>
+#include <basic_toolkit/GenericException.h>
+#include <basic_toolkit/VectorD.h>
+#include <beamline/Particle.h>
+#include <beamline/ParticleBunch.h>
+#include <beamline/TBunch.h>
+#include <beamline/BunchArrays.h>
+
+namespace {
+
+ int const dim = PhaseSpaceIndexing::BMLN_dynDim;
+
+ // arrays are padded so that each coordinate array starts on an aligned boundary
+
+ int const pad = BunchArrays::alignment/sizeof(double);
+
+ inline int roundUp( int n )
+ {
+   return ( (n + pad - 1)/pad )*pad;
+ }
+
+ double* alignedAlloc( int n )
+ {
+   void* p = 0;
+   if ( posix_memalign( &p, BunchArrays::alignment, ((n==0) ? 1 : n)*sizeof(double) ) != 0 ) {
+     throw std::bad_alloc();
+   }
+   return static_cast<double*>(p);
+ }
+
+} // anonymous namespace
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+BunchArrays::BunchArrays( Particle const& reference, int nparticles )
+ : reference_( reference.clone() ), intensity_(0.0), size_(0), stride_(0), capacity_(0), data_(0), alive_(0), view_(false)
+{
+  resize( nparticles );
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+BunchArrays::BunchArrays( ParticleBunch const& bunch )
+ : reference_( bunch.getReferenceParticle().clone() ), intensity_( bunch.Intensity() ), size_(0), stride_(0), capacity_(0), data_(0), alive_(0), view_(false)
+{
+  load( bunch );
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+BunchArrays::BunchArrays( BunchArrays const& o )
+ : reference_( o.reference_->clone() ), intensity_( o.intensity_ ), size_(0), stride_(0), capacity_(0), data_(0), alive_(0), view_(false)
+{
+  reallocate( o.size_ );
+  size_ = o.size_;
+
+  for ( int i=0; i<dim; ++i ) {
+    std::copy( o[i], o[i]+size_, (*this)[i] );
+  }
+  std::copy( o.alive_, o.alive_+size_, alive_ );
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+BunchArrays::BunchArrays( BunchArrays& parent, int first, int last )
+ : reference_( parent.reference_->clone() ), intensity_( parent.intensity_ ), 
+   size_( last-first ), stride_( parent.stride_ ), capacity_( last-first ), 
+   data_( parent.data_ + first ), alive_( parent.alive_ + first ), view_(true)
+{
+  if ( (first < 0) || (last < first) || (last > parent.size_) ) {
+    delete reference_;
+    throw GenericException( __FILE__, __LINE__,
+           "BunchArrays::BunchArrays( BunchArrays& parent, int first, int last )",
+           "Range is not within the parent bunch." );
+  }
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+BunchArrays::~BunchArrays()
+{
+  delete reference_;
+
+  if ( view_ ) return;
+
+  free( data_  );
+  delete [] alive_;
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+BunchArrays& BunchArrays::operator=( BunchArrays const& o )
+{
+  if ( this == &o ) return *this;
+
+  setReferenceParticle( *o.reference_ );
+  intensity_ = o.intensity_;
+
+  size_ = 0;
+  reserve( o.size_ );
+  size_ = o.size_;
+
+  for ( int i=0; i<dim; ++i ) {
+    std::copy( o[i], o[i]+size_, (*this)[i] );
+  }
+  std::copy( o.alive_, o.alive_+size_, alive_ );
+
+  return *this;
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+void BunchArrays::reallocate( int capacity )
+{
+  if ( view_ ) {
+    throw GenericException( __FILE__, __LINE__,
+           "void BunchArrays::reallocate( int capacity )",
+           "A view of another BunchArrays cannot be reallocated." );
+  }
+
+  int const newstride = roundUp( capacity );
+
+  double*        data  = alignedAlloc( dim*newstride );
+  unsigned char* alive = new unsigned char[ (newstride==0) ? 1 : newstride ];
+
+  for ( int i=0; i<dim; ++i ) {
+    std::copy( data_ + i*stride_, data_ + i*stride_ + size_, data + i*newstride );
+  }
+  std::copy( alive_, alive_ + size_, alive );
+
+  free( data_ );
+  delete [] alive_;
+
+  data_     = data;
+  alive_    = alive;
+  stride_   = newstride;
+  capacity_ = newstride;
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+void BunchArrays::reserve( int n )
+{
+  if ( n > capacity_ || data_ == 0 ) { reallocate( n ); }
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+void BunchArrays::resize( int n )
+{
+  if ( n < 0 ) {
+    throw GenericException( __FILE__, __LINE__,
+           "void BunchArrays::resize( int n )",
+           "Negative number of particles requested." );
+  }
+
+  reserve( n );
+
+  for ( int i=0; i<dim; ++i ) {
+    if ( n > size_ ) { std::fill( (*this)[i] + size_, (*this)[i] + n, 0.0 ); }
+  }
+  if ( n > size_ ) { std::fill( alive_ + size_, alive_ + n, 1 ); }
+
+  size_ = n;
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+void BunchArrays::clear()
+{
+  size_ = 0;
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+void BunchArrays::append( Vector const& state )
+{
+  if ( size_ == capacity_ ) { reallocate( std::max( 2*capacity_, 128 ) ); }
+
+  for ( int i=0; i<dim; ++i ) {
+    (*this)[i][size_] = state[i];
+  }
+  alive_[size_] = 1;
+
+  ++size_;
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+void BunchArrays::append( Particle const& p )
+{
+  append( p.state() );
+  alive_[size_-1] = ( p.isLost() ? 0 : 1 );
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+void BunchArrays::getParticle( int j, Particle& p ) const
+{
+  Vector& state = p.state();
+
+  for ( int i=0; i<dim; ++i ) {
+    state[i] = (*this)[i][j];
+  }
+  p.setLost( !alive_[j] );
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+void BunchArrays::setParticle( int j, Particle const& p )
+{
+  Vector const& state = p.state();
+
+  for ( int i=0; i<dim; ++i ) {
+    (*this)[i][j] = state[i];
+  }
+  alive_[j] = ( p.isLost() ? 0 : 1 );
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+void BunchArrays::setReferenceParticle( Particle const& p )
+{
+  Particle* ref = p.clone();   // use clone() to preserve dynamic type
+  delete reference_;
+  reference_ = ref;
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+int BunchArrays::survivors() const
+{
+  return std::count( alive_, alive_+size_, 1 );
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+void BunchArrays::compact()
+{
+  if ( view_ ) {
+    throw GenericException( __FILE__, __LINE__,
+           "void BunchArrays::compact()",
+           "Particles of a view of another BunchArrays cannot be removed." );
+  }
+
+  int n = 0;
+
+  for ( int j=0; j<size_; ++j ) {
+
+    if ( !alive_[j] ) continue;
+
+    if ( n != j ) {
+      for ( int i=0; i<dim; ++i ) { (*this)[i][n] = (*this)[i][j]; }
+      alive_[n] = 1;
+    }
+    ++n;
+  }
+
+  size_ = n;
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+void BunchArrays::load( ParticleBunch const& bunch )
+{
+  intensity_ = bunch.Intensity();
+
+  size_ = 0;
+  reserve( bunch.size() );
+
+  for ( ParticleBunch::const_iterator it = bunch.begin(); it != bunch.end(); ++it ) {
+    append( *it );
+  }
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+void BunchArrays::store( ParticleBunch& bunch ) const
+{
+  bunch.setIntensity( intensity_ );
+
+  //-------------------------------------------------------------------
+  // When the bunch has the same number of particles, the states are
+  // updated in place; otherwise the bunch is repopulated from scratch.
+  //-------------------------------------------------------------------
+
+  if ( bunch.size() != size_ ) {
+
+    bunch.clear();
+
+    Particle* p = reference_->clone();
+    for ( int j=0; j<size_; ++j ) {
+      getParticle( j, *p );
+      bunch.append( *p );
+    }
+    delete p;
+
+    return;
+  }
+
+  int j = 0;
+  for ( ParticleBunch::iterator it = bunch.begin(); it != bunch.end(); ++it, ++j ) {
+    getParticle( j, *it );
+  }
+}
@@ -28,14 +28,19 @@
 **************************************************************************/
 
 #include <basic_toolkit/iosetup.h>
+#include <basic_toolkit/GenericException.h>
+#include <basic_toolkit/WorkerPool.h>
 #include <beamline/ParticleBunch.h>
 #include <beamline/Particle.h>
 #include <beamline/ParticleBunch.h>
 #include <beamline/TBunch.h>
 #include <beamline/BunchProjector.h>
+#include <beamline/beamline.h>
 
 #include <algorithm>
+#include <cmath>
 #include <boost/shared_ptr.hpp>
+#include <boost/bind.hpp>
 
 using FNAL::pcout;
 
@@ -63,22 +68,174 @@ namespace {
    }
  };
 
+
+int const min_chunk_size = 256;  // a thread is not worth using for fewer particles 
+
+//-----------------------------------------------------------------------------
+// Shape functions. u is the particle position in units of the grid spacing, 
+// measured from the first grid point. The particle is spread over the order
+// grid points starting at i0, with weights w[0] ... w[order-1].
+//-----------------------------------------------------------------------------
+
+template <int order> 
+struct ShapeFunction;
+
+template <>
+struct ShapeFunction<1> {   // nearest grid point
+  static void weights( double u, int& i0, double* w ) 
+  { 
+    i0   = int( std::floor( u + 0.5 ) ); 
+    w[0] = 1.0;
+  }
+};
+
+template <>
+struct ShapeFunction<2> {   // cloud-in-cell
+  static void weights( double u, int& i0, double* w ) 
+  { 
+    i0   = int( std::floor( u ) ); 
+    double const f = u - i0;
+    w[0] = 1.0 - f;
+    w[1] = f;
+  }
+};
+
+template <>
+struct ShapeFunction<3> {   // triangular-shaped cloud
+  static void weights( double u, int& i0, double* w ) 
+  { 
+    int    const i = int( std::floor( u + 0.5 ) ); 
+    double const d = u - i;
+    i0   = i - 1;
+    w[0] = 0.5*( 0.5 - d )*( 0.5 - d );
+    w[1] = 0.75 - d*d;
+    w[2] = 0.5*( 0.5 + d )*( 0.5 + d );
+  }
+};
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+struct Grid {
+  int     dim;
+  int     coord[3];         // state index of the coordinate along each dimension
+  int     n[3];
+  double  min[3];
+  double  inv_spacing[3];
+  int     ncomponents;      // 1: density; 3: density and x, y moments
+};
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+template <int order>
+void depositRange( ParticleBunch::const_iterator first, ParticleBunch::const_iterator last, Grid const& g, double* const* out )
+{
+  //-------------------------------------------------------------------
+  // Dimensions beyond g.dim have a single grid point, of weight 1. 
+  // Contributions to grid points outside of the grid are dropped.
+  //-------------------------------------------------------------------
+
+  int    i0[3] = { 0, 0, 0 };
+  double w [3][order];
+
+  w[1][0] = 1.0;
+  w[2][0] = 1.0;
+
+  int const m1 = ( g.dim > 1 ) ? order : 1;
+  int const m2 = ( g.dim > 2 ) ? order : 1;
+
+  for ( ParticleBunch::const_iterator it = first; it != last; ++it ) {
+
+    Vector const& state = it->state();
+
+    for ( int d=0; d < g.dim; ++d ) {
+      ShapeFunction<order>::weights( ( state[ g.coord[d] ] - g.min[d] )*g.inv_spacing[d], i0[d], w[d] );
+    }
+
+    for ( int c=0; c < m2; ++c ) { 
+
+      int const iz = i0[2] + c;
+      if ( iz < 0 || iz >= g.n[2] ) continue;
+
+      for ( int b=0; b < m1; ++b ) { 
+
+        int const iy = i0[1] + b;
+        if ( iy < 0 || iy >= g.n[1] ) continue;
+
+        for ( int a=0; a < order; ++a ) { 
+
+          int const ix = i0[0] + a;
+          if ( ix < 0 || ix >= g.n[0] ) continue;
+
+          int    const idx = ix + g.n[0]*( iy + g.n[1]*iz );
+          double const wt  = w[0][a]*w[1][b]*w[2][c];
+
+          out[0][idx] += wt; 
+
+          if ( g.ncomponents == 3 ) {
+            out[1][idx] += wt*state[0];
+            out[2][idx] += wt*state[1];
+          }
+        }
+      }
+    }
+  }
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+void depositRange( BunchProjector::Shape shape, ParticleBunch::const_iterator first, ParticleBunch::const_iterator last, Grid const& g, double* const* out )
+{
+  switch ( shape ) {
+    case BunchProjector::ngp: depositRange<1>( first, last, g, out ); break;
+    case BunchProjector::cic: depositRange<2>( first, last, g, out ); break;
+    case BunchProjector::tsc: depositRange<3>( first, last, g, out ); break;
+  }
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+Grid grid( BunchProjector const& projector, int ncomponents ) 
+{
+  int const coord[3][3] = { { 2, 0, 0 }, { 0, 1, 0 }, { 0, 1, 2 } };
+
+  int const dim = projector.dimension();
+
+  Grid g;
+
+  g.dim         = dim;
+  g.ncomponents = ncomponents;
+
+  for ( int d=0; d<3; ++d ) { 
+    g.coord[d]       = coord[dim-1][d];
+    g.n[d]           = projector.gridSize(d);
+    g.min[d]         = projector.gridMin(d);
+    g.inv_spacing[d] = 1.0/projector.gridSpacing(d);
+  }
+
+  return g;
+}
+
 } // namespace
 
 //||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
 //||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
 
 BunchProjector::BunchProjector( ParticleBunch& bunch, int nsamples )
-  :   monopole_( nsamples, double()    ), 
-    dipole_hor_( nsamples, double()    ),     
-    dipole_ver_( nsamples, double()    )
 {
+   init( 1, nsamples, 1, 1, ngp );
 
    bunch.sort( (LWakeOrder()) );
 
    cdt_min_     =    (bunch.begin()  )->cdt(); 
    cdt_max_     =    ( --bunch.end() )->cdt();  
   
+   min_[0]      =    cdt_min_;
+   spacing_[0]  =    ( cdt_max_ - cdt_min_ )/( nsamples-1 );
+
    populateHistograms( bunch, cdt_min_, cdt_max_, nsamples);  
 }
 
@@ -86,16 +243,101 @@ BunchProjector::BunchProjector( ParticleBunch& bunch, int nsamples )
 //||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
 
 BunchProjector::BunchProjector( ParticleBunch& bunch, double const& length, int nsamples )
-  : monopole_( nsamples, double()    ), 
-    dipole_hor_( nsamples, double()    ),     
-    dipole_ver_( nsamples, double()    )
+{
+   init( 1, nsamples, 1, 1, ngp );
+   project( bunch, length );
+}
+
+//||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+BunchProjector::BunchProjector( int nsamples, Shape shape )
+{
+   init( 1, nsamples, 1, 1, shape );
+}
+
+//||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+BunchProjector::BunchProjector( int nx, int ny, Shape shape )
+{
+   init( 2, nx, ny, 1, shape );
+}
+
+//||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+BunchProjector::BunchProjector( int nx, int ny, int nz, Shape shape )
+{
+   init( 3, nx, ny, nz, shape );
+}
+
+//||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+void BunchProjector::init( int dim, int nx, int ny, int nz, Shape shape )
+{
+   int const minsize = ( shape == tsc ) ? 4 : 2;   // tsc: the edge points are margins
+
+   int const n[] = { nx, ny, nz };
+
+   for ( int d=0; d<3; ++d ) {
+     if ( n[d] < ( ( d < dim ) ? minsize : 1 ) ) { 
+       throw GenericException( __FILE__, __LINE__, 
+             "void BunchProjector::init( int dim, int nx, int ny, int nz, Shape shape )",
+             "The grid is too small for the shape function." );
+     }
+   }
+
+   cdt_min_ = 0.0;
+   cdt_max_ = 0.0;
+   shape_   = shape;
+   dim_     = dim;
+
+   bunch_       = 0;
+   ncomponents_ = 0;
+
+   for ( int d=0; d<3; ++d ) { 
+     n_[d]       = n[d]; 
+     min_[d]     = 0.0; 
+     spacing_[d] = 1.0; 
+   } 
+
+   if ( dim == 1 ) {
+     monopole_.resize( nx, 0.0 ); 
+     dipole_hor_.resize( nx, 0.0 );     
+     dipole_ver_.resize( nx, 0.0 );
+   }
+   else { 
+     density_.resize( nx*ny*nz, 0.0 ); 
+   }
+}
+
+//||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+void BunchProjector::project( ParticleBunch& bunch, double const& length )
 {
 
+   if ( dim_ != 1 ) { 
+     throw GenericException( __FILE__, __LINE__, 
+           "void BunchProjector::project( ParticleBunch& bunch, double const& length )",
+           "A longitudinal projection requires a 1-D grid." );
+   }
+
    bunch.sort( (LWakeOrder()) );
   
-   cdt_min_     =    (bunch.begin())->cdt(); 
+   //-----------------------------------------------------------------
+   // With the tsc shape, the first grid point is a margin.  
+   //-----------------------------------------------------------------
+
+   spacing_[0]  =    length/( n_[0]-1 );
+
+   cdt_min_     =    (bunch.begin())->cdt() - ( ( shape_ == tsc ) ? spacing_[0] : 0.0 ); 
    cdt_max_     =    cdt_min_ + length;
   
+   min_[0]      =    cdt_min_;
+
    if (( (--bunch.end())->cdt() - bunch.begin()->cdt() ) > length ) {
 
      (*pcout) << "*** WARNING ***: BunchProjector: Sampled region is smaller than total bunch length." << std::endl;
@@ -104,11 +346,157 @@ BunchProjector::BunchProjector( ParticleBunch& bunch, double const& length, int
               <<  ( (--bunch.end())->cdt() - bunch.begin()->cdt() ) <<  std::endl;
    }
 
-   populateHistograms( bunch, cdt_min_, cdt_min_ + length, nsamples);  
+   //-----------------------------------------------------------------
+   // All shapes go through deposit(), which spreads large bunches  
+   // over the worker pool. With ngp, the bins are the intervals 
+   // [ cdt_i - 0.5*spacing, cdt_i + 0.5*spacing [; populateHistograms()
+   // closed them on the right instead. 
+   //-----------------------------------------------------------------
+
+   double* const out[] = { &monopole_[0], &dipole_hor_[0], &dipole_ver_[0] };
+   deposit( bunch, 3, out );
 }
 
-//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
-//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+void BunchProjector::deposit( ParticleBunch const& bunch )
+{
+   if ( bunch.empty() ) { 
+     throw GenericException( __FILE__, __LINE__, 
+           "void BunchProjector::deposit( ParticleBunch const& bunch )",
+           "The bunch is empty." );
+   }
+
+   //-----------------------------------------------------------------
+   // The grid spans the bunch. With the tsc shape, the first and last
+   // grid points are margins, so that no contribution is dropped. 
+   //-----------------------------------------------------------------
+
+   int const coord[3][3] = { { 2, 0, 0 }, { 0, 1, 0 }, { 0, 1, 2 } };
+   int const margin      = ( shape_ == tsc ) ? 1 : 0;
+
+   for ( int d=0; d < dim_; ++d ) {
+
+     int const c = coord[dim_-1][d];
+
+     double lo = bunch.begin()->state()[c];
+     double hi = lo;
+
+     for ( ParticleBunch::const_iterator it = bunch.begin(); it != bunch.end(); ++it ) {
+       lo = std::min( lo, it->state()[c] );
+       hi = std::max( hi, it->state()[c] );
+     }
+
+     spacing_[d] = ( hi > lo ) ? ( hi - lo )/( n_[d] - 1 - 2*margin ) : 1.0;
+     min_[d]     = lo - margin*spacing_[d];
+   }
+
+   if ( dim_ == 1 ) { 
+     cdt_min_ = min_[0];
+     cdt_max_ = min_[0] + ( n_[0]-1 )*spacing_[0];
+
+     double* const out[] = { &monopole_[0], &dipole_hor_[0], &dipole_ver_[0] };
+     deposit( bunch, 3, out );
+   }
+   else { 
+     double* const out[] = { &density_[0] };
+     deposit( bunch, 1, out );
+   }
+}
+
+//||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+void BunchProjector::deposit( ParticleBunch const& bunch, int ncomponents, double* const* out )
+{
+   int const ncells = n_[0]*n_[1]*n_[2];
+
+   for ( int k=0; k < ncomponents; ++k ) { 
+     std::fill( out[k], out[k] + ncells, 0.0 );
+   }
+
+   int const n       = bunch.size();
+   int const nchunks = std::min( beamline::numberOfThreads(), n/min_chunk_size );
+
+   if ( nchunks < 2 ) { 
+     depositRange( shape_, bunch.begin(), bunch.end(), grid( *this, ncomponents ), out ); 
+   }
+   else { 
+
+     //-------------------------------------------------------------------
+     // Each thread deposits a contiguous range of the bunch on a private
+     // grid. The grids, the pointers and the tasks are kept from one call 
+     // to the next. 
+     //-------------------------------------------------------------------
+
+     if ( int( tasks_.size() ) != nchunks ) { 
+       tasks_.resize( nchunks );
+       for ( int j=0; j < nchunks; ++j ) { 
+         tasks_[j] = boost::bind( &BunchProjector::depositChunk, this, j );
+       }
+     }
+
+     if ( int( private_.size() ) < nchunks ) { private_.resize( nchunks ); }
+
+     pointers_.resize( nchunks*ncomponents );
+
+     for ( int j=0; j < nchunks; ++j ) { 
+       private_[j].resize( ncomponents*ncells );
+       std::fill( private_[j].begin(), private_[j].end(), 0.0 );
+       for ( int k=0; k < ncomponents; ++k ) { pointers_[j*ncomponents + k] = &private_[j][k*ncells]; }
+     }
+
+     bounds_.resize( nchunks+1 );
+     bounds_[0] = 0;
+     for ( int j=0; j < nchunks; ++j ) {
+       bounds_[j+1] = bounds_[j] + n/nchunks + ( (j < n%nchunks) ? 1 : 0 );
+     }
+
+     bunch_       = &bunch;
+     ncomponents_ = ncomponents;
+
+     WorkerPool::instance().run( tasks_ );
+
+     bunch_ = 0;
+
+     //-------------------------------------------------------------------
+     // reduction 
+     //-------------------------------------------------------------------
+
+     for ( int j=0; j < nchunks; ++j ) {
+       for ( int k=0; k < ncomponents; ++k ) { 
+         double const* src = pointers_[j*ncomponents + k];
+         std::transform( out[k], out[k] + ncells, src, out[k], std::plus<double>() );
+       }
+     }
+   }
+
+   //-------------------------------------------------------------------
+   // normalization w/r to the no of particles and the cell volume 
+   //-------------------------------------------------------------------
+
+   double volume = 1.0;
+   for ( int d=0; d < dim_; ++d ) { volume *= spacing_[d]; }
+
+   double const scale = 1.0/( n*volume );
+
+   for ( int k=0; k < ncomponents; ++k ) { 
+     std::transform( out[k], out[k] + ncells, out[k], std::bind2nd( std::multiplies<double>(), scale ) );
+   }
+}
+
+//||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+void BunchProjector::depositChunk( int j )
+{
+   depositRange( shape_, bunch_->begin() + bounds_[j], bunch_->begin() + bounds_[j+1], 
+                 grid( *this, ncomponents_ ), &pointers_[j*ncomponents_] ); 
+}
+
+//||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
 
 void BunchProjector::populateHistograms( ParticleBunch& bunch, double const& smin,  double const& smax, int nsamples)
 {
@@ -216,6 +604,65 @@ std::vector<double> const& BunchProjector::dipoleVerLineDensity() const
 //||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
 //||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
 
+std::vector<double> const& BunchProjector::density() const
+{
+  return ( dim_ == 1 ) ? monopole_ : density_;
+}
+
+//||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+BunchProjector::BunchProjector( BunchProjector const& o )
+  : cdt_min_(o.cdt_min_), 
+    cdt_max_(o.cdt_max_), 
+    shape_(o.shape_), 
+    dim_(o.dim_), 
+    monopole_(o.monopole_),
+    dipole_hor_(o.dipole_hor_),
+    dipole_ver_(o.dipole_ver_),
+    density_(o.density_),
+    private_(), 
+    pointers_(), 
+    tasks_(), 
+    bounds_(), 
+    bunch_(0),
+    ncomponents_(0)
+{
+  for ( int d=0; d<3; ++d ) { 
+    n_[d]       = o.n_[d]; 
+    min_[d]     = o.min_[d]; 
+    spacing_[d] = o.spacing_[d]; 
+  } 
+}
+
+//||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+BunchProjector& BunchProjector::operator=( BunchProjector const& rhs )
+{
+  if ( &rhs == this ) return *this;
+
+  cdt_min_    = rhs.cdt_min_;
+  cdt_max_    = rhs.cdt_max_;
+  shape_      = rhs.shape_;
+  dim_        = rhs.dim_;
+  monopole_   = rhs.monopole_;
+  dipole_hor_ = rhs.dipole_hor_;
+  dipole_ver_ = rhs.dipole_ver_;
+  density_    = rhs.density_;
+
+  for ( int d=0; d<3; ++d ) { 
+    n_[d]       = rhs.n_[d]; 
+    min_[d]     = rhs.min_[d]; 
+    spacing_[d] = rhs.spacing_[d]; 
+  } 
+
+  return *this;   // the deposition buffers and tasks of this are kept 
+}
+
+//||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
 BunchProjector::~BunchProjector()
 { }
 
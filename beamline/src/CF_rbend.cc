@@ -254,6 +254,7 @@ double CF_rbend::setEntryAngle( double const& phi )
   double ret = usAngle_;
   usAngle_ = phi;
   propagator_->ctor(*this);
+  markModified();
   return ret;
 }
 
@@ -266,6 +267,7 @@ double CF_rbend::setExitAngle( double const& phi /* radians */ )
   double ret = dsAngle_;
   dsAngle_ = phi;  
   propagator_->ctor(*this);
+  markModified();
   return ret;
 }
 
@@ -298,6 +300,7 @@ void CF_rbend::setQuadrupole( double const& value)
 {
   multipoles_[1] = value;
   propagator_->ctor(*this);
+  markModified();
 }
 
 //|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
@@ -307,6 +310,7 @@ void CF_rbend::setSextupole( double const& value)
 {
   multipoles_[2] = value;
   propagator_->ctor(*this);
+  markModified();
  
 }
 //|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
@@ -316,6 +320,7 @@ void CF_rbend::setOctupole( double const& value )
 {
   multipoles_[3] = value;
   propagator_->ctor(*this);
+  markModified();
 }
 
 //|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
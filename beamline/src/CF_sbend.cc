@@ -207,6 +207,7 @@ double CF_sbend::setEntryAngle( double const& phi /* radians */ )
   double ret = usAngle_;
   usAngle_   = phi;
   propagator_->ctor(*this);
+  markModified();
   return ret;
 }
 
@@ -218,6 +219,7 @@ double CF_sbend::setExitAngle( double const& phi /* radians */ )
   double ret = dsAngle_;
   dsAngle_   = phi;  
   propagator_->ctor(*this);
+  markModified();
   return ret;
 }
 
@@ -228,6 +230,7 @@ void CF_sbend::setOctupole( double const& pole )
 {
   multipoles_[3] = pole;
   propagator_->ctor(*this);
+  markModified();
 }
 
 //|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
@@ -237,6 +240,7 @@ void CF_sbend::setSextupole( double const& pole )
 {
   multipoles_[2] = pole;
   propagator_->ctor(*this);
+  markModified();
 }
 
 //|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
@@ -266,6 +270,7 @@ void CF_sbend::setQuadrupole( double const& pole)
 
   multipoles_[1] = pole;
   propagator_->ctor(*this);
+  markModified();
 
 }
 
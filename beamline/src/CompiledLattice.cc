@@ -0,0 +1,521 @@
+/*************************************************************************
+**************************************************************************
+**************************************************************************
+******
+******  BEAMLINE:  C++ objects for design and analysis
+******             of beamlines, storage rings, and
+******             synchrotrons.
+******
+******  File:      CompiledLattice.cc
+******
+******  Copyright Fermi Research Alliance / Fermilab
+******            All Rights Reserved
+*****
+******  Usage, modification, and redistribution are subject to terms
+******  of the License supplied with this software.
+******
+******  Software and documentation created under
+******  U.S. Department of Energy Contract No. DE-AC02-07CH11359
+******  The U.S. Government retains a world-wide non-exclusive,
+******  royalty-free license to publish or reproduce documentation
+******  and software for U.S. Government purposes. This software
+******  is protected under the U.S. and Foreign Copyright Laws.
+******
+**************************************************************************
+**************************************************************************
+*************************************************************************/
+
+#include <basic_toolkit/PhysicsConstants.h>
+#include <beamline/CompiledLattice.h>
+#include <beamline/BasePropagator.h>
+#include <beamline/beamline.h>
+#include <beamline/Drift.h>
+#include <beamline/quadrupole.h>
+#include <beamline/sextupole.h>
+#include <beamline/marker.h>
+#include <beamline/Edge.h>
+#include <beamline/Bend.h>
+#include <beamline/BendPropagators.h>
+#include <beamline/sbend.h>
+#include <beamline/rbend.h>
+#include <beamline/CF_sbend.h>
+#include <beamline/CF_rbend.h>
+#include <beamline/Particle.h>
+#include <beamline/ParticleBunch.h>
+#include <beamline/TBunch.h>
+#include <boost/bind.hpp>
+#include <typeinfo>
+#include <algorithm>
+#include <cmath>
+
+using namespace PhysicsConstants;
+
+namespace {
+
+ typedef PhaseSpaceIndexing::index index;
+
+ index const i_x   = Particle::i_x;
+ index const i_y   = Particle::i_y;
+ index const i_cdt = Particle::i_cdt;
+ index const i_npx = Particle::i_npx;
+ index const i_npy = Particle::i_npy;
+ index const i_ndp = Particle::i_ndp;
+
+ std::complex<double> const complex_i( 0.0, 1.0 );
+
+ double const csq_red = PH_MKS_c * PH_MKS_c * 1.0e-9;
+
+ int const min_chunk_size = 256;  // a thread is not worth using for fewer particles 
+
+ typedef CompiledLattice::Record Record;
+
+} // namespace
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+CompiledLattice::CompiledLattice( beamline const& bml )
+  : bml_(&bml), records_(), ngeneric_(0), sources_(), scratch_(), modifications_(0),
+    tasks_(), bounds_(), bunch_(0), runFirst_(0), runLast_(0)
+{
+  compile();
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+CompiledLattice::~CompiledLattice()
+{}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+void CompiledLattice::compile()
+{
+  records_.clear();
+  ngeneric_ = 0;
+
+  modifications_ = BmlnElmnt::modifications();
+
+  compile( *bml_ );
+
+  sources_.clear();
+  signature( *bml_, sources_ );
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+bool CompiledLattice::isValid() const
+{
+  //---------------------------------------------------------------------
+  // If no element of any line was modified since the last check, the 
+  // plan is valid. Otherwise, the modifications may concern other lines:
+  // the signature of the source line is compared with that of the plan. 
+  //---------------------------------------------------------------------
+
+  unsigned long const modifications = BmlnElmnt::modifications();
+
+  if ( modifications == modifications_ ) return true;
+
+  scratch_.clear();
+  signature( *bml_, scratch_ );
+
+  if ( scratch_.size() != sources_.size() ) return false;
+
+  for ( unsigned int i=0; i < sources_.size(); ++i ) {
+    if ( scratch_[i] != sources_[i] ) return false;
+  }
+
+  modifications_ = modifications;
+  return true;
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+namespace {
+
+//----------------------------------------------------------------------------------
+// a nested line is expanded unless its propagator is decorated; otherwise the
+// decorator (alignment, aperture) would be skipped.
+//----------------------------------------------------------------------------------
+
+bool isPlain( BasePropagator const& propagator )
+{
+  return !propagator.hasAlignment() && !propagator.hasAperture();
+}
+
+//----------------------------------------------------------------------------------
+// elements whose propagator tracks through the elements of an internal line,
+// then corrects cdt by the reference time of the element.
+//----------------------------------------------------------------------------------
+
+bool isComposite( std::type_info const& type )
+{
+  return    type == typeid(quadrupole) || type == typeid(sextupole)
+         || type == typeid(sbend)      || type == typeid(rbend)
+         || type == typeid(CF_sbend)   || type == typeid(CF_rbend);
+}
+
+} // namespace
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+void CompiledLattice::signature( beamline const& bml, std::vector<Source>& sources ) const
+{
+  Source const s = { bml.serial(), bml.modificationCount() };
+  sources.push_back( s );
+
+  for ( beamline::const_iterator it = bml.begin(); it != bml.end(); ++it ) {
+
+    beamline const* nested = dynamic_cast<beamline const*>( (*it).get() );
+
+    if ( nested && !nested->align_ && isPlain( *nested->propagator_ ) ) {
+      signature( *nested, sources );
+    }
+    else {
+      Source const e = { (*it)->serial(), (*it)->modificationCount() };
+      sources.push_back( e );
+    }
+  }
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+void CompiledLattice::compile( beamline const& bml )
+{
+  for ( beamline::const_iterator it = bml.begin(); it != bml.end(); ++it ) {
+
+    beamline const* nested = dynamic_cast<beamline const*>( (*it).get() );
+
+    if ( nested && !nested->align_ && isPlain( *nested->propagator_ ) ) {
+      compile( *nested );
+    }
+    else {
+      compile( **it, false );
+    }
+  }
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+void CompiledLattice::compile( BmlnElmnt const& elm, bool local )
+{
+  //----------------------------------------------------------------------------------
+  // local: elm belongs to the internal line of a composite element. Such elements
+  // are propagated with localPropagate(), i.e. without frame change.
+  //----------------------------------------------------------------------------------
+
+  BasePropagator const& propagator = *elm.propagator_;
+
+  bool const aligned = !local && elm.align_;
+
+  Record r = { Record::generic, elm.Length(), elm.Strength(), elm.getReferenceTime(), &elm, aligned };
+
+  std::type_info const& type = typeid(elm);
+
+  if ( !isPlain( propagator ) ) {
+    // decorated propagator: kept as is
+  }
+  else if ( type == typeid(marker) && !aligned ) {
+    return;
+  }
+  else if ( type == typeid(Drift) ) {
+    r.kind = Record::drift;
+  }
+  else if ( type == typeid(thinQuad) ) {
+    r.kind = Record::thin_quad;
+  }
+  else if ( type == typeid(thinSextupole) ) {
+    r.kind = Record::thin_sextupole;
+  }
+  else if ( type == typeid(Edge) ) {
+    r.kind = Record::edge;
+  }
+  else if ( type == typeid(Bend) && typeid(propagator) == typeid(Bend::Propagator) ) {
+
+    Bend::Propagator const& core = static_cast<Bend::Propagator const&>( propagator );
+
+    r.kind      = Record::bend;
+    r.propPhase = core.propPhase();
+    r.propTerm  = core.propTerm();
+    r.dphi      = core.dphi();
+  }
+  else if ( isComposite( type ) && !aligned && propagator.bml_ ) {
+
+    //-------------------------------------------------------------------------------
+    // The internal line of a CF_sbend or CF_rbend holds sbends or rbends, which
+    // are expanded in turn. An sbend with the MAD propagator has no internal line.
+    //-------------------------------------------------------------------------------
+
+    for ( beamline::const_iterator it = propagator.bml_->begin(); it != propagator.bml_->end(); ++it ) {
+      compile( **it, true );
+    }
+
+    r.kind = Record::time_offset;
+  }
+
+  if ( r.kind == Record::generic ) {
+    r.kind    = local ? Record::generic_local : Record::generic;
+    r.aligned = false;
+    ++ngeneric_;
+  }
+
+  records_.push_back( r );
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+void CompiledLattice::execute( Record const* first, Record const* last, Particle& p ) const
+{
+  //----------------------------------------------------------------------------------
+  // NOTE: the expressions below are those of the element propagators
+  //       (DriftPropagators.cc, QuadrupolePropagators.cc, SextupolePropagators.cc,
+  //       EdgePropagators.cc, BendPropagators.cc) evaluated in the same order, so
+  //       that the results are identical.
+  //----------------------------------------------------------------------------------
+
+  Vector& state = p.state();
+
+  for ( Record const* r = first; r != last; ++r ) {
+
+    if ( r->aligned ) { r->elm->enterLocalFrame( p ); }
+
+    switch ( r->kind ) {
+
+      case Record::drift: {
+        double const npz = p.npz();
+        double const xpr = state[i_npx] / npz;
+        double const ypr = state[i_npy] / npz;
+
+        state[i_x] += ( r->length * xpr );
+        state[i_y] += ( r->length * ypr );
+
+        double const D = r->length*sqrt( 1.0 + xpr*xpr + ypr*ypr );
+
+        state[i_cdt] += ( D / p.beta() ) - r->ctRef;
+        break;
+      }
+
+      case Record::thin_quad: {
+        if ( r->strength == 0.0 ) break;
+
+        double const k = r->strength / p.refBrho();
+
+        state[i_npx] += - k * state[i_x];
+        state[i_npy] +=   k * state[i_y];
+        break;
+      }
+
+      case Record::thin_sextupole: {
+        if ( r->strength == 0.0 ) break;
+
+        double const k = r->strength / p.refBrho();
+        double const x = state[i_x];
+        double const y = state[i_y];
+
+        state[i_npx] -= k * ( x*x - y*y );
+        state[i_npy] += 2.0 * k * x*y;
+        break;
+      }
+
+      case Record::edge: {
+        if ( r->strength == 0.0 ) break;
+
+        double const k = r->strength / p.refBrho();
+
+        state[i_npy] -= k * state[i_y];
+        break;
+      }
+
+      case Record::bend: {
+        double psq = 1.0 + state[i_ndp];
+        psq *= psq;
+
+        double const E_factor = 1.0 / sqrt( psq + 1.0/( p.pn()*p.pn() ));
+
+        double const beta_1 = E_factor * state[i_npx];
+        double const beta_2 = E_factor * state[i_npy];
+        double const beta_3 = E_factor *  p.npz();
+
+        std::complex<double> const ui  = complex_i* state[i_x];
+        std::complex<double> const vui = PH_MKS_c*beta_3 + complex_i*PH_MKS_c*beta_1;
+
+        double               const omega = csq_red * r->strength / p.energy();
+        std::complex<double> const bi    = ( complex_i*vui / omega ) - ui;
+        std::complex<double> const bf    = bi*r->propPhase + r->propTerm;
+
+        double const rho      = PH_MKS_c * sqrt( beta_1*beta_1 + beta_3*beta_3 ) / omega;
+        double const dthmdphi = asin( real(bi)/rho ) - asin( real(bf)/rho );
+
+        std::complex<double> const expF = exp( complex_i * dthmdphi );
+        std::complex<double> const vuf  = vui*expF;
+        std::complex<double> const uf   = ( ui + bi )*expF - bf;
+
+        double const dtheta = dthmdphi + r->dphi;
+        double const cdt    = - PH_MKS_c * dtheta / omega;
+
+        state[i_x  ]  =  imag( uf );
+        state[i_y  ] +=  beta_2*cdt;
+        state[i_cdt] +=  cdt - r->ctRef;
+        state[i_npx]  =  imag( vuf )/( E_factor * PH_MKS_c );
+        break;
+      }
+
+      case Record::time_offset:
+        state[i_cdt] -= r->ctRef;
+        break;
+
+      case Record::generic:
+        r->elm->propagate( p );
+        break;
+
+      case Record::generic_local:
+        r->elm->localPropagate( p );
+        break;
+    }
+
+    if ( r->aligned ) { r->elm->leaveLocalFrame( p ); }
+  }
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+void CompiledLattice::propagate( Particle& p )
+{
+  track( p, 1 );
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+void CompiledLattice::propagate( ParticleBunch& b )
+{
+  track( b, 1 );
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+void CompiledLattice::track( Particle& p, int nturns )
+{
+  if ( !isValid() ) { compile(); }
+
+  if ( records_.empty() ) return;
+
+  Record const* const first = &records_[0];
+  Record const* const last  = first + records_.size();
+
+  for ( int turn=0; turn < nturns; ++turn ) {
+    execute( first, last, p );
+  }
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+void CompiledLattice::track( ParticleBunch& b, int nturns )
+{
+  //----------------------------------------------------------------------------------
+  // Runs of translated records are applied one particle at a time; generic records
+  // are applied to the whole bunch, since the element may be collective or may
+  // remove particles (apertures).
+  //----------------------------------------------------------------------------------
+
+  if ( !isValid() ) { compile(); }
+
+  if ( records_.empty() ) return;
+
+  Record const* const begin = &records_[0];
+  Record const* const end   = begin + records_.size();
+
+  for ( int turn=0; turn < nturns; ++turn ) {
+
+    Record const* first = begin;
+
+    while ( first != end ) {
+
+      if ( first->kind == Record::generic ) {
+        first->elm->propagate( b );
+        ++first;
+        continue;
+      }
+
+      if ( first->kind == Record::generic_local ) {
+        first->elm->localPropagate( b );
+        ++first;
+        continue;
+      }
+
+      Record const* last = first;
+      while ( last != end && last->kind != Record::generic && last->kind != Record::generic_local ) { ++last; }
+
+      execute( first, last, b );
+
+      first = last;
+    }
+  }
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+void CompiledLattice::execute( Record const* first, Record const* last, ParticleBunch& b )
+{
+  //----------------------------------------------------------------------------------
+  // The particles are independent: contiguous ranges of the bunch are tracked
+  // concurrently by the threads of the shared worker pool. The tasks are built
+  // only when the number of chunks changes; they read the records and the
+  // ranges from the members set below.
+  //----------------------------------------------------------------------------------
+
+  int const n       = b.size();
+  int const nchunks = std::min( beamline::numberOfThreads(), n/min_chunk_size );
+
+  if ( nchunks < 2 ) {
+    for ( ParticleBunch::iterator it = b.begin(); it != b.end(); ++it ) {
+      execute( first, last, *it );
+    }
+    return;
+  }
+
+  if ( int( tasks_.size() ) != nchunks ) {
+    tasks_.resize( nchunks );
+    for ( int j=0; j < nchunks; ++j ) {
+      tasks_[j] = boost::bind( &CompiledLattice::executeChunk, this, j );
+    }
+  }
+
+  bounds_.resize( nchunks+1 );
+  bounds_[0] = 0;
+  for ( int j=0; j < nchunks; ++j ) {
+    bounds_[j+1] = bounds_[j] + n/nchunks + ( (j < n%nchunks) ? 1 : 0 );
+  }
+
+  bunch_    = &b;
+  runFirst_ = first;
+  runLast_  = last;
+
+  WorkerPool::instance().run( tasks_ );
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+void CompiledLattice::executeChunk( int j )
+{
+  ParticleBunch::iterator const end = bunch_->begin() + bounds_[j+1];
+
+  for ( ParticleBunch::iterator it = bunch_->begin() + bounds_[j]; it != end; ++it ) {
+    execute( runFirst_, runLast_, *it );
+  }
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
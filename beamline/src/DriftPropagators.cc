@@ -36,9 +36,11 @@
 
 #include <beamline/DriftPropagators.h>
 #include <beamline/Drift.h>
+#include <cmath>
 #include <beamline/Particle.h>
 #include <beamline/JetParticle.h>
 #include <beamline/ParticleBunch.h>
+#include <beamline/BunchArrays.h>
 
 namespace {
   
@@ -72,6 +74,45 @@ void propagate( Drift const& elm, Particle_t& p )
 
      state[i_cdt] += ( D / p.beta() ) - elm.getReferenceTime();
 }
+
+//-----------------------------------------------------------------------------------------
+// bunch (SoA) version. beta = p/E is evaluated per particle from ndp.
+//-----------------------------------------------------------------------------------------
+
+void propagate( Drift const& elm, BunchArrays& b )
+{
+     Particle const& ref   = b.getReferenceParticle();
+
+     double const length   = elm.Length();
+     double const ctRef    = elm.getReferenceTime();
+     double const p0       = ref.refMomentum();
+     double const m        = ref.mass();
+     int    const n        = b.size();
+
+     double* const x   = b[i_x];
+     double* const y   = b[i_y];
+     double* const cdt = b[i_cdt];
+     double const* const npx = b[i_npx];
+     double const* const npy = b[i_npy];
+     double const* const ndp = b[i_ndp];
+
+     for ( int j=0; j<n; ++j ) {
+
+       double const dpp  = 1.0 + ndp[j];
+       double const npz  = std::sqrt( dpp*dpp - npx[j]*npx[j] - npy[j]*npy[j] );
+       double const xpr  = npx[j] / npz;
+       double const ypr  = npy[j] / npz;
+
+       x[j] += length * xpr;
+       y[j] += length * ypr;
+
+       double const D    = length*std::sqrt( 1.0 + xpr*xpr + ypr*ypr ); 
+       double const pc   = p0*dpp;
+
+       cdt[j] += D * ( std::sqrt( pc*pc + m*m )/pc ) - ctRef;
+     }
+}
+
 } // namepace 
 
 //|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
@@ -123,6 +164,15 @@ void Drift::Propagator::operator()( BmlnElmnt const& elm, JetParticle&     p )
 //|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
 
 
+void Drift::Propagator::operator()( BmlnElmnt const& elm, BunchArrays& b ) 
+{
+ ::propagate(static_cast<Drift const&>(elm),b);
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+
 // ****   MAD style optical propagator ***** 
 
 
@@ -39,6 +39,7 @@
 #include <beamline/beamline.h>
 #include <beamline/Edge.h>
 #include <beamline/EdgePropagators.h>
+#include <beamline/BunchArrays.h>
 #include <beamline/Drift.h>
 #include <iostream>
 
@@ -73,6 +74,19 @@ void propagate( Edge const& elm, Particle_t & p )
 
  }
 
+void propagate( Edge const& elm, BunchArrays& b ) 
+{
+ if( elm.Strength() == 0.0 ) return; 
+ 
+ double const k = elm.Strength() / b.getReferenceParticle().refBrho();
+ int    const n = b.size();
+
+ double const* const y   = b[i_y];
+ double*       const npy = b[i_npy];
+
+ for ( int j=0; j<n; ++j ) { npy[j] -= k * y[j]; }
+}
+
 } // namespace
 
 //|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
@@ -116,3 +130,11 @@ void Edge::Propagator::operator()( BmlnElmnt const& elm, JetParticle&     p )
 //|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
 //|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
 
+void Edge::Propagator::operator()( BmlnElmnt const& elm, BunchArrays&     b ) 
+{
+  ::propagate(static_cast<Edge const&>(elm),b);
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
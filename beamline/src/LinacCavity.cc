@@ -249,6 +249,7 @@ void   LinacCavity::setFrequency( double const& freq)
   w_rf_ = 2.0*M_PI*freq;
 
   propagator_->setAttribute( *this, "FREQUENCY", freq );
+  markModified();
 }
 
 //||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
@@ -274,6 +275,7 @@ double const& LinacCavity::radialFrequency() const
 {
   phi_s_ = radians;
   propagator_->setAttribute(*this, "PHASE", radians );
+  markModified();
 }
 
 //||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||  
@@ -283,6 +285,7 @@ void  LinacCavity::setWakeOn( bool set )
 {
   wakeon_ = set;
   propagator_->setAttribute(*this, "WAKEON", set);
+  markModified();
 }
 
 //||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||  
@@ -172,6 +172,7 @@ bool    LCavityUpstream::isDriftSpace() const
 void    LCavityUpstream::setFrequency( double const& f)
 {
   w_rf_ = 2*M_PI*f; 
+  markModified();
 }
 
 //||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
@@ -180,6 +181,7 @@ void    LCavityUpstream::setFrequency( double const& f)
 void  LCavityUpstream::setPhi( double const& radians)
 {
    phi_s_ = radians;
+   markModified();
 }  
 
 //||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
@@ -318,6 +320,7 @@ bool    LCavityDnstream::isDriftSpace() const
 void    LCavityDnstream::setFrequency( double const& f)
 {
   w_rf_ = 2*M_PI*f; 
+  markModified();
 }
 
 //||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
@@ -326,6 +329,7 @@ void    LCavityDnstream::setFrequency( double const& f)
 void  LCavityDnstream::setPhi( double const& radians)
 {
    phi_s_ = radians;
+   markModified();
 }  
 
 //||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
@@ -264,6 +264,7 @@ double MonitorBase::setDriftFraction( double f )
 { 
   double ret = driftFraction_; 
   if ( f <= 1 && f >= 0 ) driftFraction_ = f; 
+  markModified();
   return ret; 
 }
 
@@ -77,12 +77,12 @@ template<>
 double toDouble(Jet    const& value) { return value.standardPart(); }
 
 template<typename Elm_t, typename Particle_t>
-double setMonitorState( Elm_t elm,  Particle_t const& p );
+void setMonitorState( Elm_t elm,  Particle_t const& p );
 
 //-------------------------------------------------------------------------------
 
 template<typename Particle_t>
-double setMonitorState( Monitor const& elm,  Particle_t const& p )
+void setMonitorState( Monitor const& elm,  Particle_t const& p )
 {
   typedef typename PropagatorTraits<Particle_t>::State_t       State_t;
   typedef typename PropagatorTraits<Particle_t>::Component_t   Component_t;
@@ -98,7 +98,7 @@ double setMonitorState( Monitor const& elm,  Particle_t const& p )
 //-------------------------------------------------------------------------------
 
 template<typename Particle_t>
-double setMonitorState( VMonitor const& elm,  Particle_t const& p )
+void setMonitorState( VMonitor const& elm,  Particle_t const& p )
 {
   typedef typename PropagatorTraits<Particle_t>::State_t       State_t;
   typedef typename PropagatorTraits<Particle_t>::Component_t   Component_t;
@@ -111,7 +111,7 @@ double setMonitorState( VMonitor const& elm,  Particle_t const& p )
 //-------------------------------------------------------------------------------
 
 template<typename Particle_t>
-double setMonitorState( HMonitor const& elm,  Particle_t const& p )
+void setMonitorState( HMonitor const& elm,  Particle_t const& p )
 {
   typedef typename PropagatorTraits<Particle_t>::State_t       State_t;
   typedef typename PropagatorTraits<Particle_t>::Component_t   Component_t;
@@ -113,6 +113,14 @@ void  PropagatorDecorator::operator()(  BmlnElmnt const& elm, JetParticleBunch&
 //|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
 //|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
 
+void  PropagatorDecorator::operator()(  BmlnElmnt const& elm, BunchArrays& b)  
+{
+  (*propagator_)(elm,b);
+} 
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
 bool PropagatorDecorator::hasAlignment() const 
 {
   return propagator_->hasAlignment();
@@ -129,6 +137,14 @@ bool PropagatorDecorator::hasAperture()  const
 //|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
 //|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
 
+bool PropagatorDecorator::isCollective()  const
+{
+  return propagator_->isCollective();
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
 void  PropagatorDecorator::setAlignment( Vector const& translation, Vector const& rotation)
 {
   propagator_->setAlignment( translation, rotation);
@@ -40,8 +40,14 @@
 #include <beamline/Particle.h>
 #include <beamline/JetParticle.h>
 #include <beamline/ParticleBunch.h>
+#include <beamline/BunchArrays.h>
 #include <beamline/quadrupole.h>
 #include <beamline/Drift.h>
+#include <beamline/SymplecticSteps.h>
+#include <integrator/SymplecticScheme.h>
+#include <basic_toolkit/GenericException.h>
+#include <boost/any.hpp>
+#include <utility>
 
 namespace {
 
@@ -94,6 +100,25 @@ void propagate( thinQuad const& elm, Particle_t& p )
  state[i_npy]  +=   k * state[i_y];
 
 }
+
+void propagate( thinQuad const& elm, BunchArrays& b ) 
+{
+ if( elm.Strength() == 0.0 ) return; 
+
+ double const k = elm.Strength() / b.getReferenceParticle().refBrho();
+ int    const n = b.size();
+
+ double const* const x   = b[i_x];
+ double const* const y   = b[i_y];
+ double*       const npx = b[i_npx];
+ double*       const npy = b[i_npy];
+
+ for ( int j=0; j<n; ++j ) { 
+   npx[j] += - k * x[j]; 
+   npy[j] +=   k * y[j];
+ }
+}
+
 } // namespace
 
 
@@ -134,6 +159,14 @@ void thinQuad::Propagator::operator()( BmlnElmnt const& elm, JetParticle& p )
   ::propagate( static_cast<thinQuad const&>(elm),p);
 }
 
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+void thinQuad::Propagator::operator()( BmlnElmnt const& elm, BunchArrays& b ) 
+{
+  ::propagate( static_cast<thinQuad const&>(elm),b);
+}
+
 //******************************************************************************************
 //
 //   Quadrupole::Propagator
@@ -158,20 +191,65 @@ void propagate( quadrupole const& elm, Particle_t& p,  BmlPtr bml )
   state[i_cdt] -= elm.getReferenceTime();
 }
 
+void propagate( quadrupole const& elm, BunchArrays& b,  BmlPtr bml )
+{
+  for ( beamline::const_iterator it = bml->begin(); it != bml->end(); ++it ) { 
+     (*it)->localPropagate( b );
+  }
+
+  double const ctRef = elm.getReferenceTime();
+  int    const n     = b.size();
+  double* const cdt  = b[i_cdt];
+  
+  for ( int j=0; j<n; ++j ) { cdt[j] -= ctRef; }
+}
+
+//-----------------------------------------------------------------------------------------
+// integration with a SymplecticScheme: exact drifts and thin quadrupole kicks
+//-----------------------------------------------------------------------------------------
+
+template<typename Particle_t>
+void propagate( quadrupole const& elm, Particle_t& p, SymplecticScheme const& scheme, int nsteps )
+{
+  typedef typename PropagatorTraits<Particle_t>::State_t       State_t;
+
+  ExactDriftStep     drift;
+  QuadrupoleKickStep kick( elm.Strength() / p.refBrho() );
+
+  scheme.integrate( p, elm.Length(), nsteps, drift, kick );
+
+  State_t& state = p.state();
+  state[i_cdt] -= elm.getReferenceTime();
+}
+
+void propagate( quadrupole const& elm, BunchArrays& b, SymplecticScheme const& scheme, int nsteps )
+{
+  ExactDriftStep     drift;
+  QuadrupoleKickStep kick( elm.Strength() / b.getReferenceParticle().refBrho() );
+
+  scheme.integrate( b, elm.Length(), nsteps, drift, kick );
+
+  double const ctRef = elm.getReferenceTime();
+  int    const n     = b.size();
+  double* const cdt  = b[i_cdt];
+  
+  for ( int j=0; j<n; ++j ) { cdt[j] -= ctRef; }
+}
+
 } // namespace
 
 //|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
 //|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
 
 quadrupole::Propagator::Propagator(int n)
-  : n_(n),BasePropagator()
+  : n_(n), order_(0), scheme_(0), BasePropagator()
 {}
 
 //|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
 //|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
 
-quadrupole::Propagator::Propagator(quadrupole const& elm, int n) 
-  : n_(n), BasePropagator(elm)
+quadrupole::Propagator::Propagator(quadrupole const& elm, int n, int order) 
+  : n_(n), order_(order), scheme_(0), BasePropagator(elm)
 {
   ctor(elm);
 }
@@ -180,7 +258,7 @@ quadrupole::Propagator::Propagator(quadrupole const& elm, int n)
 //|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
 
 quadrupole::Propagator::Propagator(quadrupole::Propagator const& p)
-  : n_(p.n_), BasePropagator(p)
+  : n_(p.n_), order_(p.order_), scheme_(p.scheme_), BasePropagator(p)
 {}
 
 
@@ -199,6 +277,18 @@ void quadrupole::Propagator::ctor( BmlnElmnt const& arg )
 {
   quadrupole const& elm = static_cast< quadrupole const&>(arg); 
 
+  //-----------------------------
+  // Symplectic scheme ..........
+  //-----------------------------
+
+  if ( order_ != 0 ) { 
+    scheme_ = &SymplecticScheme::forOrder( order_ );
+    bml_    = BmlPtr();
+    return;
+  }
+
+  scheme_ = 0;
+
   double const lng  = arg.Length();
   double const str  = arg.Strength();
  
@@ -279,6 +369,12 @@ void quadrupole::Propagator::ctor( BmlnElmnt const& arg )
 
 void  quadrupole::Propagator::setAttribute( BmlnElmnt& elm, std::string const& name, boost::any const& value )
 { 
+  if ( name == "INTEGRATOR" ) { 
+    std::pair<int,int> const integrator = boost::any_cast<std::pair<int,int> >( value );
+    order_ = integrator.first;
+    n_     = integrator.second;
+  }
+
   ctor(elm);
 }
 
@@ -287,6 +383,11 @@ void  quadrupole::Propagator::setAttribute( BmlnElmnt& elm, std::string const& n
 
 void quadrupole::Propagator::operator()( BmlnElmnt const& elm, Particle& p ) 
 {
+  if ( scheme_ ) { 
+    ::propagate( static_cast<quadrupole const&>(elm),p, *scheme_, n_);
+    return;
+  }
+
   ::propagate( static_cast<quadrupole const&>(elm),p, bml_);
 }
 
@@ -295,9 +396,27 @@ void quadrupole::Propagator::operator()( BmlnElmnt const& elm, Particle& p )
 
 void quadrupole::Propagator::operator()( BmlnElmnt const& elm, JetParticle& p ) 
 {
+  if ( scheme_ ) { 
+    ::propagate( static_cast<quadrupole const&>(elm),p, *scheme_, n_);
+    return;
+  }
+
   ::propagate( static_cast<quadrupole const&>(elm),p, bml_);
 }
 
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+void quadrupole::Propagator::operator()( BmlnElmnt const& elm, BunchArrays& b ) 
+{
+  if ( scheme_ ) { 
+    ::propagate( static_cast<quadrupole const&>(elm),b, *scheme_, n_);
+    return;
+  }
+
+  ::propagate( static_cast<quadrupole const&>(elm),b, bml_);
+}
+
 //******************************************************************************************
 //
 //   Quadrupole::MADPropagator
@@ -41,6 +41,7 @@
 #include <beamline/Edge.h>
 #include <beamline/Bend.h>
 #include <beamline/rbend.h>
+#include <beamline/BunchArrays.h>
 #include <iostream>
 
 namespace {
@@ -85,6 +86,19 @@ void propagate( rbend const& elm, Particle_t& p, BmlPtr bml )
 
 }
 
+void propagate( rbend const& elm, BunchArrays& b, BmlPtr bml )
+{
+  for ( beamline::const_iterator it = bml->begin(); it != bml->end(); ++it ) { 
+     (*it)->localPropagate( b );
+  }
+
+  double const ctRef = elm.getReferenceTime();
+  int    const n     = b.size();
+  double* const cdt  = b[i_cdt];
+
+  for ( int j=0; j<n; ++j ) { cdt[j] -= ctRef; }
+}
+
 //|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
 //|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
 
@@ -265,6 +279,14 @@ void rbend::Propagator::operator()( BmlnElmnt const& elm, JetParticle& p )
 //||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
 //||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
 
+void rbend::Propagator::operator()( BmlnElmnt const& elm, BunchArrays& b)
+{
+  ::propagate( static_cast<rbend const&>(elm), b, bml_);
+}
+
+//||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
 #if 0
 void rbend::MADPropagator::operator()( BmlnElmnt const& elm, Particle& p ) 
 {
@@ -42,6 +42,7 @@
 #include <beamline/Edge.h>
 #include <beamline/Bend.h>
 #include <beamline/sbend.h>
+#include <beamline/BunchArrays.h>
 #include <beamline/SBendPropagators.h>
 #include <beamline/beamline.h>
 #include <iostream>
@@ -86,6 +87,19 @@ void propagate( sbend const& elm, Particle_t& p, BmlPtr bml )
   state[i_cdt] -= elm.getReferenceTime();   
 }
 
+void propagate( sbend const& elm, BunchArrays& b, BmlPtr bml )
+{
+  for ( beamline::const_iterator it = bml->begin(); it != bml->end(); ++it ) { 
+     (*it)->localPropagate( b );
+  }
+
+  double const ctRef = elm.getReferenceTime();
+  int    const n     = b.size();
+  double* const cdt  = b[i_cdt];
+
+  for ( int j=0; j<n; ++j ) { cdt[j] -= ctRef; }
+}
+
 //|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
 //|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
 
@@ -269,6 +283,14 @@ void sbend::Propagator::operator()( BmlnElmnt const& elm, JetParticle& p)
 //||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
 //||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
 
+void sbend::Propagator::operator()( BmlnElmnt const& elm, BunchArrays& b)
+{
+  ::propagate( static_cast<sbend const&>(elm), b, bml_);
+}
+
+//||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
 
 sbend::MADPropagator::MADPropagator()
   : BasePropagator()
@@ -40,6 +40,11 @@
 #include <beamline/Drift.h>
 #include <beamline/sextupole.h>
 #include <beamline/SextupolePropagators.h>
+#include <beamline/BunchArrays.h>
+#include <beamline/SymplecticSteps.h>
+#include <integrator/SymplecticScheme.h>
+#include <boost/any.hpp>
+#include <utility>
 #include <iostream>
 
 namespace {
@@ -95,20 +100,89 @@ void propagate( thinSextupole const& elm, Particle_t& p )
 
 }
 
+//-----------------------------------------------------------------------------
+
+void propagate( sextupole const& elm, BunchArrays& b, BmlPtr bml )
+{
+  for ( beamline::const_iterator it = bml->begin(); it != bml->end(); ++it ) { 
+     (*it)->localPropagate( b );
+  }
+
+  double const ctRef = elm.getReferenceTime();
+  int    const n     = b.size();
+  double* const cdt  = b[i_cdt];
+
+  for ( int j=0; j<n; ++j ) { cdt[j] -= ctRef; }
+}
+
+//-----------------------------------------------------------------------------
+
+void propagate( thinSextupole const& elm, BunchArrays& b )
+{
+ if( elm.Strength() == 0.0 ) return;  
+ 
+ double const k = elm.Strength() / b.getReferenceParticle().refBrho();
+ int    const n = b.size();
+
+ double const* const x   = b[i_x];
+ double const* const y   = b[i_y];
+ double*       const npx = b[i_npx];
+ double*       const npy = b[i_npy];
+
+ for ( int j=0; j<n; ++j ) { 
+   npx[j] -= k * ( x[j]*x[j] - y[j]*y[j] );
+   npy[j] += 2.0 * k * x[j]*y[j];
+ }
+}
+
+//-----------------------------------------------------------------------------
+// integration with a SymplecticScheme: exact drifts and thin sextupole kicks
+//-----------------------------------------------------------------------------
+
+template<typename Particle_t>
+void propagate( sextupole const& elm, Particle_t& p, SymplecticScheme const& scheme, int nsteps )
+{
+  typedef typename PropagatorTraits<Particle_t>::State_t       State_t;
+
+  ExactDriftStep    drift;
+  SextupoleKickStep kick( elm.Strength() / p.refBrho() );
+
+  scheme.integrate( p, elm.Length(), nsteps, drift, kick );
+
+  State_t& state = p.state();
+  state[i_cdt] -= elm.getReferenceTime(); 
+}
+
+//-----------------------------------------------------------------------------
+
+void propagate( sextupole const& elm, BunchArrays& b, SymplecticScheme const& scheme, int nsteps )
+{
+  ExactDriftStep    drift;
+  SextupoleKickStep kick( elm.Strength() / b.getReferenceParticle().refBrho() );
+
+  scheme.integrate( b, elm.Length(), nsteps, drift, kick );
+
+  double const ctRef = elm.getReferenceTime();
+  int    const n     = b.size();
+  double* const cdt  = b[i_cdt];
+
+  for ( int j=0; j<n; ++j ) { cdt[j] -= ctRef; }
+}
+
 } // namespace
 
 //||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
 //||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
 
 sextupole::Propagator::Propagator ( int n)
-  : n_(n), BasePropagator()
+  : n_(n), order_(0), scheme_(0), BasePropagator()
 {}
 
 //||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
 //||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
 
-sextupole::Propagator::Propagator ( sextupole const& elm, int n)
-  : n_(n), BasePropagator(elm)
+sextupole::Propagator::Propagator ( sextupole const& elm, int n, int order )
+  : n_(n), order_(order), scheme_(0), BasePropagator(elm)
 {
   ctor(elm);
 }
@@ -117,7 +191,7 @@ sextupole::Propagator::Propagator ( sextupole const& elm, int n)
 //||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
 
 sextupole::Propagator::Propagator ( Propagator const& p)
- : n_(p.n_), BasePropagator(p)
+ : n_(p.n_), order_(p.order_), scheme_(p.scheme_), BasePropagator(p)
 {}
 
 //||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
@@ -125,6 +199,14 @@ sextupole::Propagator::Propagator ( Propagator const& p)
  
 void sextupole::Propagator::ctor(BmlnElmnt const& arg)
 { 
+ if ( order_ != 0 ) { 
+   scheme_ = &SymplecticScheme::forOrder( order_ );
+   bml_    = BmlPtr();
+   return;
+ }
+
+ scheme_ = 0;
+
 
  bml_ = BmlPtr( new beamline );
  bml_->append( DriftPtr( new Drift( "", arg.Length()/ 2.0 ) ) );
@@ -138,6 +220,12 @@ void sextupole::Propagator::ctor(BmlnElmnt const& arg)
 
 void sextupole::Propagator::setAttribute( BmlnElmnt& elm, std::string const& name, boost::any const& value )
 { 
+  if ( name == "INTEGRATOR" ) { 
+    std::pair<int,int> const integrator = boost::any_cast<std::pair<int,int> >( value );
+    order_ = integrator.first;
+    n_     = integrator.second;
+  }
+
   ctor(elm);
 }
 
@@ -146,6 +234,11 @@ void sextupole::Propagator::setAttribute( BmlnElmnt& elm, std::string const& nam
 
 void sextupole::Propagator::operator()(BmlnElmnt const& elm, Particle& p)
 {
+  if ( scheme_ ) { 
+    ::propagate(static_cast<sextupole const&>(elm), p, *scheme_, n_);
+    return;
+  }
+
   ::propagate(static_cast<sextupole const&>(elm), p, bml_);
 }
 
@@ -154,12 +247,30 @@ void sextupole::Propagator::operator()(BmlnElmnt const& elm, Particle& p)
 
 void sextupole::Propagator::operator()(BmlnElmnt const& elm, JetParticle& p)
 {
+  if ( scheme_ ) { 
+    ::propagate(static_cast<sextupole const&>(elm), p, *scheme_, n_);
+    return;
+  }
+
   ::propagate(static_cast<sextupole const&>(elm), p, bml_);
 }
 
 //||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
 //||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
 
+void sextupole::Propagator::operator()(BmlnElmnt const& elm, BunchArrays& b)
+{
+  if ( scheme_ ) { 
+    ::propagate(static_cast<sextupole const&>(elm), b, *scheme_, n_);
+    return;
+  }
+
+  ::propagate(static_cast<sextupole const&>(elm), b, bml_);
+}
+
+//||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
 thinSextupole::Propagator::Propagator ()
   : BasePropagator()
 {}
@@ -197,3 +308,11 @@ void thinSextupole::Propagator::operator()(BmlnElmnt const& elm, JetParticle& p)
 //||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
 //||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
 
+void thinSextupole::Propagator::operator()(BmlnElmnt const& elm, BunchArrays& b)
+{
+  ::propagate(static_cast<thinSextupole const&>(elm), b);
+}
+
+//||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
@@ -287,9 +287,8 @@ bool Slot::isDriftSpace()  const
 
  int Slot::setInFrame( Frame const& frm )
 {
-
-  int ret = 0;
-  if ( ret = checkFrame( frm ) ) { in_ = frm; }
+  int ret = checkFrame( frm );   // throws if the frame cannot be used
+  in_ = frm;
   return ret;
 }
 
@@ -307,6 +306,7 @@ int Slot::setOutFrame( Frame const& frm )
          " int Slot::setOutFrame( const Frame& frm )", 
          "Current implementation requires that frames be orthonormal." ) );
   }
+  return ret;
 }
 
 //||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
@@ -54,6 +54,18 @@ namespace {
  index const i_ndp = Particle::i_ndp;
 
 
+Vector unitVector( int i ) 
+{
+  Vector u(3);
+  u[i] = 1.0;
+  return u;
+}
+
+// initialized once at load time, so that frames can be processed concurrently 
+
+Vector const u_y = unitVector(1);
+Vector const u_z = unitVector(2);
+
 inline bool betaParallelTest( double const&  betaParallel ) {
     return (betaParallel <= 0.0); 
 }
@@ -72,17 +84,6 @@ void processFrame( Frame const& frm,  Particle_t & p )
   typedef typename PropagatorTraits<Particle_t>::State_t       State_t;
   typedef typename PropagatorTraits<Particle_t>::Component_t   Component_t;
 
-  static bool firstTime = true;
-  static Vector u_z(3);
-  static Vector u_y(3);
- 
-
-  if( firstTime ) {
-    firstTime = false;
-    u_y[0] = 0.0; u_y[1] = 1.0; u_y[2] = 0.0;
-    u_z[0] = 0.0; u_z[1] = 0.0; u_z[2] = 1.0;
-  }
-
    
   State_t&  state = p.state();
 
@@ -59,8 +59,11 @@
 **************************************************************************
 *************************************************************************/
 
+#include <boost/bind.hpp>
+#include <basic_toolkit/WorkerPool.h>
 #include <beamline/Particle.h>
 #include <beamline/TBunch.h>
+#include <beamline/beamline.h>
 
 
 using namespace std;
@@ -80,6 +83,167 @@ namespace {
   index const   i_npy   = Particle::i_npy; 
   index const   i_ndp   = Particle::i_ndp;
 
+  typedef TBunch<Particle>::iterator  iterator;
+
+  int const min_chunk_size = 256;  // a thread is not worth using for fewer particles 
+
+  //-----------------------------------------------------------------------------
+  // Kernels used with counter-based streams. A kernel populates one phase space 
+  // plane of one particle, drawing from the stream of that particle only; the 
+  // arithmetic is that of the boost::function<double()> versions.
+  //-----------------------------------------------------------------------------
+
+  class PopulateKernel {
+   public:
+    virtual ~PopulateKernel() {}
+    virtual void operator()( Vector& state, RandomStream& rnd ) const = 0;
+  };
+
+  class ParGaussianKernel : public PopulateKernel {
+
+   public:
+
+    ParGaussianKernel( int psid, double xlim, double xplim, double r_12, double cutoff )
+      : psid_(psid), xlim_(xlim), xplim_(xplim), sn_(r_12), cs_( sqrt(1.0 - r_12*r_12) ), cutoff_(cutoff) {}
+
+    void operator()( Vector& state, RandomStream& rnd ) const
+    {
+      double a     = sqrt( -2.0 * log( rnd()) );
+
+      if ( cutoff_ > 0.0 ) {
+        while (  std::abs(a)  > cutoff_ ) { a = sqrt( -2.0 * log( rnd()) ); }
+      }
+      double alpha = 2.0*M_PI* rnd();
+
+      double u     = a*cos(alpha);
+      double v     = a*sin(alpha);
+
+      state[0+psid_]   = xlim_  *  u;
+      state[3+psid_]   = xplim_ * ( psid_ == TBunch<Particle>::cdt_ndp ? 1.0 : (1.0 + state[i_ndp]) ) * (u*sn_ + v*cs_); 
+    }
+
+   private:
+
+    int    psid_;
+    double xlim_;
+    double xplim_;
+    double sn_;
+    double cs_;
+    double cutoff_;
+  };
+
+  class ParGaussianAltKernel : public PopulateKernel {
+
+   public:
+
+    ParGaussianAltKernel( int psid, double sigma1, double sigma2, double r21, double cutoff )
+      : psid_(psid), sigma1_(sigma1), sigma2_(sigma2), r21_(r21), cutoff_(cutoff) {}
+
+    void operator()( Vector& state, RandomStream& rnd ) const
+    {
+      double u0 = rnd.normal();
+      double v0 = rnd.normal();
+
+      if ( cutoff_ > 0.0 ) {
+        while (  std::abs(u0) > cutoff_ ) { u0 = rnd.normal(); }
+        while ( (std::abs(v0) * (psid_ == TBunch<Particle>::cdt_ndp ? 1.0 : (1.0 + state[i_ndp]) )) > cutoff_ ) { v0 = rnd.normal(); }
+      }
+
+      double x  = sigma1_ * u0;
+      double xp = sigma2_ * v0 + r21_ * x;
+
+      state[0+psid_]   = x;
+      state[3+psid_]   = xp * (1.0 + state[i_ndp]) ; 
+    }
+
+   private:
+
+    int    psid_;
+    double sigma1_;
+    double sigma2_;
+    double r21_;
+    double cutoff_;
+  };
+
+  class ParBinomialKernel : public PopulateKernel {
+
+   public:
+
+    ParBinomialKernel( int psid, double M, double sigmax, double sigmaxp, double r_12 )
+      : psid_(psid), M_(M), xlim_( sqrt( 2.0*(M+1.0) )*sigmax ), xplim_( sqrt( 2.0*(M+1.0) )*sigmaxp ),
+        sn_(r_12), cs_( sqrt(1.0 - r_12*r_12) ) {}
+
+    void operator()( Vector& state, RandomStream& rnd ) const
+    {
+      double a     = sqrt(1.0 - pow( rnd(), 1.0/M_ ));
+
+      double alpha = 2.0*M_PI*rnd();
+
+      double u     = a*cos(alpha);
+      double v     = a*sin(alpha);
+
+      state[0+psid_]   = xlim_*u;
+      state[3+psid_]   = xplim_*(u*sn_ + v*cs_ ); 
+    }
+
+   private:
+
+    int    psid_;
+    double M_;
+    double xlim_;
+    double xplim_;
+    double sn_;
+    double cs_;
+  };
+
+  //|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+  //|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+  void populateRange( iterator first, iterator last, int index, RandomStreams const& streams, int lane, PopulateKernel const& kernel )
+  {
+    for ( iterator it = first; it != last; ++it, ++index ) {
+      RandomStream rnd = streams.stream( index, lane );
+      kernel( it->state(), rnd );
+    }
+  }
+
+  //|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+  //|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+  void populate( iterator begin, iterator end, RandomStreams const& streams, int lane, PopulateKernel const& kernel )
+  {
+    //----------------------------------------------------------------------
+    // Particle j draws from stream j only: contiguous ranges of the bunch 
+    // are populated concurrently, and the result does not depend on the 
+    // number of ranges. 
+    //----------------------------------------------------------------------
+
+    int const n       = end - begin;
+    int const nchunks = std::min( beamline::numberOfThreads(), n/min_chunk_size );
+
+    if ( nchunks < 2 ) { 
+      populateRange( begin, end, 0, streams, lane, kernel );
+      return;
+    }
+
+    //----------------------------------------------------------------------
+    // Each task of the shared worker pool populates one range; the first
+    // particle of a range draws from the stream of the same index. 
+    //----------------------------------------------------------------------
+
+    std::vector<WorkerPool::Task> tasks( nchunks );
+
+    iterator first = begin;
+    for ( int k=0; k < nchunks; ++k ) {
+      int const size = n/nchunks + ( (k < n%nchunks) ? 1 : 0 );
+      tasks[k] = boost::bind( &populateRange, first, first+size, int(first-begin), 
+                              boost::cref(streams), lane, boost::cref(kernel) );
+      first += size;
+    }
+
+    WorkerPool::instance().run( tasks );
+  }
+
 }
 
 //|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
@@ -507,3 +671,127 @@ void TBunch<Particle>::populateCSBinomial ( PhaseSpaceProjection psid, double M,
 
 //|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
 //|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+template <>
+void  TBunch<Particle>::populateParGaussian( PhaseSpaceProjection psid, double sigma_x, double sigma_px, double r_12,  RandomStreams const& streams, double cutoff )
+{
+  populate( bunch_.begin(), bunch_.end(), streams, psid, ParGaussianKernel( psid, sigma_x, sigma_px, r_12, cutoff ) );
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+template <>
+void TBunch<Particle>::populateParGaussianAlt( PhaseSpaceProjection psid, double sigmax, double sigmaxp, double r12,  RandomStreams const& streams, double cutoff )
+{
+  populate( bunch_.begin(), bunch_.end(), streams, psid, ParGaussianAltKernel( psid, sigmax, sigmaxp, r12, cutoff ) );
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+template <>
+void TBunch<Particle>::populateCSGaussian ( PhaseSpaceProjection psid, double beta, double alpha, double epsilon,  RandomStreams const& streams, double cutoff )
+{
+  double x_m         = sqrt(epsilon*beta);
+  double gamma       = (1.0+alpha*alpha)/beta; 
+  double theta_m     = sqrt(epsilon*gamma);
+  double sin_chi     = -alpha/sqrt(beta*gamma); // r_12
+  
+  populateParGaussian(psid, x_m, theta_m, sin_chi, streams, cutoff); 
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+template <>
+void TBunch<Particle>::populateCSGaussianAlt( PhaseSpaceProjection psid, double beta, double alpha, double epsilon,  RandomStreams const& streams, double cutoff )
+{
+  double sigma1 = sqrt (epsilon* beta);
+  double sigma2 = sqrt (epsilon/ beta);
+
+  double r21    = -alpha/beta;
+
+  populateParGaussianAlt( psid, sigma1, sigma2, r21, streams, cutoff);
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+template <>
+void  TBunch<Particle>::populateParWaterBag ( PhaseSpaceProjection psid, double x_rms, double px_rms,  double r_12,   RandomStreams const& streams )
+{
+  populateParBinomial ( psid,  1.0,  x_rms,  px_rms, r_12, streams ); 
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+template <>
+void  TBunch<Particle>::populateCSWaterBag( PhaseSpaceProjection psid, double beta, double alpha,  double epsilon,  RandomStreams const& streams )
+{
+  populateCSBinomial( psid, 1.0, beta, alpha, epsilon, streams ); 
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+template <>
+void  TBunch<Particle>::populateParElliptic( PhaseSpaceProjection psid, double x_rms, double px_rms,  double r_12, RandomStreams const& streams )
+{
+  populateParBinomial ( psid,  2.0,  x_rms,  px_rms, r_12, streams ); 
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+template <>
+void  TBunch<Particle>::populateCSElliptic( PhaseSpaceProjection psid, double beta, double alpha,  double epsilon,  RandomStreams const& streams )
+{
+  populateCSBinomial( psid, 2.0, beta, alpha, epsilon, streams ); 
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+template <>
+void  TBunch<Particle>::populateParKV       ( PhaseSpaceProjection psid, double x_rms, double px_rms,  double r_12, RandomStreams const& streams )
+{
+  populateParBinomial ( psid,  1.0e-9,  x_rms,  px_rms, r_12 , streams );  // see the boost::function version 
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+template <>
+void  TBunch<Particle>::populateCSKV( PhaseSpaceProjection psid, double beta, double alpha, double epsilon, RandomStreams const& streams )
+{
+  populateCSBinomial( psid, 1.0e-9, beta, alpha, epsilon, streams ); 
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+template <>
+void TBunch<Particle>::populateParBinomial (PhaseSpaceProjection psid, double M, double sigmax, double sigmaxp, double r_12,  RandomStreams const& streams )
+{
+  populate( bunch_.begin(), bunch_.end(), streams, psid, ParBinomialKernel( psid, M, sigmax, sigmaxp, r_12 ) );
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+template <>
+void TBunch<Particle>::populateCSBinomial ( PhaseSpaceProjection psid, double M, double beta, double alpha, 
+						       double epsilon,  RandomStreams const& streams )
+{
+  double x_m         = sqrt(epsilon*beta);
+  double gamma       = (1.0+alpha*alpha)/beta; 
+  double theta_m     = sqrt(epsilon*gamma);
+  double sin_chi     = -alpha/ sqrt(beta*gamma); // r_12
+  
+  populateParBinomial( psid, M, x_m, theta_m, sin_chi, streams ); 
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
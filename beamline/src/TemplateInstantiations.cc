@@ -323,7 +323,6 @@ namespace {
   std::list<std::pair<boost::shared_ptr<BmlnElmnt>, double> > second_dummy_list;
 }
 
-template        EVector_t<double>::Type BBLens::NormalizedEField(        double const&,       double const&) const;
 template EVector_t<TJet<double> >::Type BBLens::NormalizedEField(  TJet<double> const&, TJet<double> const&) const;
 
 // for RefRegVisitor
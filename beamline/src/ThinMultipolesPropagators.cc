@@ -37,6 +37,7 @@
 #include <mxyzptlk/Jet.h>
 #include <beamline/Particle.h>
 #include <beamline/JetParticle.h>
+#include <beamline/BunchArrays.h>
 #include <complex>
 #include <numeric>
 
@@ -105,6 +106,47 @@ namespace {
    }
   }
 
+  //---------------------------------------------------------------------------
+  // bunch (SoA) version. z^n is obtained by repeated multiplication in real
+  // arithmetic; the multipole orders are small integers.  
+  //---------------------------------------------------------------------------
+
+  void propagate( thinMultipole const& elm, BunchArrays& b ) 
+  {
+   if( elm.Strength() == 0.0 ) return; 
+
+   double const brho = b.getReferenceParticle().refBrho();
+   int    const np   = b.size();
+
+   double const* const x   = b[i_x];
+   double const* const y   = b[i_y];
+   double*       const npx = b[i_npx];
+   double*       const npy = b[i_npy];
+
+   for ( thinMultipole::const_iterator it  = elm.begin(); 
+	                               it != elm.end(); ++it ) {
+
+     int    const n    =    it->first;
+     double const k_re =  - real(it->second) / brho;
+     double const k_im =  - imag(it->second) / brho;
+
+     for ( int j=0; j<np; ++j ) { 
+
+       double z_re = 1.0;
+       double z_im = 0.0;
+
+       for ( int l=0; l<n; ++l ) { 
+         double const tmp = z_re*x[j] - z_im*y[j];
+         z_im = z_re*y[j] + z_im*x[j];
+         z_re = tmp;
+       } 
+
+       npx[j] += k_re*z_re - k_im*z_im;
+       npy[j] += k_re*z_im + k_im*z_re;
+     }
+   }
+  }
+
 } // namespace
 
 //|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
@@ -147,3 +189,11 @@ void thinMultipole::Propagator::operator()(  BmlnElmnt const& elm, JetParticle&
 {
   ::propagate( static_cast<thinMultipole const&>(elm), p);
 }
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+void thinMultipole::Propagator::operator()(  BmlnElmnt const& elm, BunchArrays&     b ) 
+{
+  ::propagate( static_cast<thinMultipole const&>(elm), b);
+}
@@ -38,6 +38,7 @@
 #include <boost/bind.hpp>
 #include <basic_toolkit/iosetup.h>
 #include <basic_toolkit/PhysicsConstants.h>
+#include <basic_toolkit/WorkerPool.h>
 #include <beamline/Particle.h>
 #include <beamline/ParticleBunch.h>
 #include <beamline/TBunch.h>
@@ -45,6 +46,7 @@
 #include <beamline/BunchProjector.h>
 #include <beamline/WakeKickPropagator.h>
 #include <beamline/WakeFunctions.h>
+#include <beamline/beamline.h>
 #include <algorithm>
 #include <vector>
 #include <cmath>
@@ -53,6 +55,49 @@ using namespace std;
 using FNAL::pcerr;
 using FNAL::pcout;
 
+namespace {
+
+int const min_chunk_size = 256;  // a thread is not worth using for fewer particles 
+
+struct Kicks {
+  double const* dpx;      // kicks per bin, scaled by the bunch charge 
+  double const* dpy; 
+  double const* dpz; 
+  double        cdt_min;
+  double        binsize; 
+  int           nbins;
+};
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+void kick( ParticleBunch::iterator first, ParticleBunch::iterator last, Kicks const& kicks, int& out_of_range )
+{
+  for ( ParticleBunch::iterator it = first; it != last; ++it ) {
+
+    Vector& state = it->state();
+
+    int ibin = int( (state[2] - kicks.cdt_min) / kicks.binsize ); 
+
+    if ( ibin > (kicks.nbins-1) ) {  // the bunch is sorted: the particles that follow are out of range as well 
+      out_of_range = 1;
+      return; 
+    }
+
+    state[3]  +=  kicks.dpx[ibin];
+    state[4]  +=  kicks.dpy[ibin]; 
+
+    //------------------------------------------------------
+    // **** apply the longitudinal wake 
+    //------------------------------------------------------
+
+    double npz =  it->npz() + kicks.dpz[ibin];   
+    state[5]   =  sqrt( npz*npz + state[3]*state[3] + state[4]*state[4] ) - 1.0 ;
+  }
+}
+
+} // namespace
+
 
 //|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
 //|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
@@ -62,6 +107,14 @@ WakeKick::Propagator::Propagator(WakeKick const& elm, int nsamples, double inter
      interval_(interval),
      lwake_( nsamples_,  boost::bind<double>( ShortRangeLWakeFunction(),  _1,  interval_/(nsamples_-1),  0.5*interval_ ), true), 
      twake_( nsamples_,  boost::bind<double>( ShortRangeTWakeFunction(),  _1,  interval_/(nsamples_-1),  0.5*interval_ ), true),
+     projector_( nsamples_ ),
+     dpx_( nsamples_ ),
+     dpy_( nsamples_ ),
+     dpz_( nsamples_ ),
+     samples_( nsamples_ ),
+     bunch_(0),
+     cdt_min_(0.0),
+     binsize_(1.0),
      BasePropagator()
 { 
   ctor(elm); 
@@ -84,6 +137,14 @@ WakeKick::Propagator* WakeKick::Propagator::clone() const
 //|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
 //|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
 
+bool WakeKick::Propagator::isCollective() const
+{ 
+  return true;  // the kick depends on the longitudinal distribution of the whole bunch 
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
 //----------------------------------------------------------------------------------------------------
 // NOTE: In the code below, the ConvolutionFunctor uses the wakefunction sampled at nsample locations.
 //       The wakefunction is *truncated* at 0.5*interval, i.e. for z > 0.5*interval the samples are 0. 
@@ -94,6 +155,14 @@ WakeKick::Propagator::Propagator( int nsamples, double interval)
      interval_(interval),
      lwake_( nsamples_,  boost::bind<double>( ShortRangeLWakeFunction(),  _1,  interval_/(nsamples_-1),  0.5*interval_ ), true), 
      twake_( nsamples_,  boost::bind<double>( ShortRangeTWakeFunction(),  _1,  interval_/(nsamples_-1),  0.5*interval_ ), true),
+     projector_( nsamples_ ),
+     dpx_( nsamples_ ),
+     dpy_( nsamples_ ),
+     dpz_( nsamples_ ),
+     samples_( nsamples_ ),
+     bunch_(0),
+     cdt_min_(0.0),
+     binsize_(1.0),
      BasePropagator()
 {}
 
@@ -106,6 +175,14 @@ WakeKick::Propagator::Propagator( WakeKick::Propagator const& other )
    interval_(other.interval_),
    lwake_(other.lwake_), 
    twake_(other.twake_), 
+   projector_(other.projector_),
+   dpx_(other.dpx_),
+   dpy_(other.dpy_),
+   dpz_(other.dpz_),
+   samples_(other.samples_),
+   bunch_(0),
+   cdt_min_(0.0),
+   binsize_(1.0),
    BasePropagator(other)
 {}
 
@@ -125,9 +202,17 @@ void WakeKick::Propagator::operator()(  BmlnElmnt const& arg, ParticleBunch& bun
 
   WakeKick const& elm = static_cast<WakeKick const&>(arg); 
 
-  BunchProjector projector(bunch, interval_, nsamples_);
+  if ( bunch.empty() ) return;
 
-  const double bunch_length = ( (--bunch.end() )->cdt() - bunch.begin()->cdt() );
+  double cdt_first = bunch.begin()->cdt();
+  double cdt_last  = cdt_first;
+
+  for ( ParticleBunch::const_iterator it = bunch.begin(); it != bunch.end(); ++it ) {
+    cdt_first = std::min( cdt_first, it->cdt() );
+    cdt_last  = std::max( cdt_last,  it->cdt() );
+  }
+
+  const double bunch_length = cdt_last - cdt_first;
 
   bool interval_has_changed = false;
 
@@ -152,36 +237,17 @@ void WakeKick::Propagator::operator()(  BmlnElmnt const& arg, ParticleBunch& bun
   }      
 
   if ( interval_has_changed ) {
-
-    boost::function<double(int)> lwake = boost::bind<double>(ShortRangeLWakeFunction(),  _1,  interval_/(nsamples_-1),  0.5*interval_ );
-    boost::function<double(int)> twake = boost::bind<double>(ShortRangeTWakeFunction(),  _1,  interval_/(nsamples_-1),  0.5*interval_ );
-
-    std::vector<double> lwake_lhs(nsamples_);  
-    std::vector<double> twake_lhs(nsamples_);  
-    
-    for (int i=0; i<nsamples_; ++i) { lwake_lhs[i] = lwake(i); } 
-    for (int i=0; i<nsamples_; ++i) { twake_lhs[i] = twake(i); } 
-   
-    lwake_.resetLHS( lwake_lhs );
-    twake_.resetLHS( twake_lhs ); 
+    resetWakes();
   }
 
   //-------------------------------------------------------------------------- 
-  // NOTE: the result of the convolution will need to be scaled by binsize. 
-  //       This is is done below, when the kicks are actually applied
+  // The projection sorts the bunch longitudinally.
   //--------------------------------------------------------------------------
 
-  std::vector<double> dpz_vec =  lwake_( projector.monopoleLineDensity()  );   
-  std::vector<double> dpx_vec =  twake_( projector.dipoleHorLineDensity() );   
-  std::vector<double> dpy_vec =  twake_( projector.dipoleVerLineDensity() );   
-
-  //------------------------------------------------------------------
-  // For each particle in the bunch, apply appropriate wakefield kicks 
-  // -----------------------------------------------------------------  
+  projector_.project( bunch, interval_ );
 
   // -------------------------------------------------------------------------------------------------------------------------------
   // 
-  // At this point, the bunch has been longitudinally sorted by the BunchProjector. 
   // We get the min value of cdt from the first particle.
   //
   // NOTES: 
@@ -197,45 +263,105 @@ void WakeKick::Propagator::operator()(  BmlnElmnt const& arg, ParticleBunch& bun
   // -----------------------------------------------------------------------------------------------------------------------------------
 
   double  const binsize  = interval_/(nsamples_-1);
-  double  const cdt_min =  projector.cdt_min(); 
+  double  const cdt_min =  projector_.cdt_min(); 
   double  const p0      =  bunch.begin()->refMomentum();      // in  [GeV/c] 
   double  const charge  =  bunch.begin()->charge();           // particle charge in C
 
   double const bunch_charge = ( bunch.Intensity() * charge * 1.0e12 );     // in pC. wake is assumed to be in V/pC/m [ integrated     
   double const coeff        = ( 1.0e-9 * bunch_charge /p0 )* binsize;      // converts kick to [GeV/c] / p0 
-                                                                           // binsize is needed (see above comment)                      
+                                                                           // binsize is needed (see below)                      
+
+  //-------------------------------------------------------------------------- 
+  // NOTE: the result of the convolution needs to be scaled by binsize. 
+  //       The convolution results are held by the functors; they are 
+  //       scaled as they are copied into the kick buffers.   
+  //--------------------------------------------------------------------------
+
+  std::vector<double> const& dpz_vec =  lwake_( projector_.monopoleLineDensity()  );   
+  std::transform( dpz_vec.begin(), dpz_vec.begin() + nsamples_, dpz_.begin(), std::bind2nd( multiplies<double>(), coeff) );
 
-  std::transform( dpx_vec.begin(), dpx_vec.end(), dpx_vec.begin(), std::bind2nd( multiplies<double>(), coeff) );
-  std::transform( dpy_vec.begin(), dpy_vec.end(), dpy_vec.begin(), std::bind2nd( multiplies<double>(), coeff) );
-  std::transform( dpz_vec.begin(), dpz_vec.end(), dpz_vec.begin(), std::bind2nd( multiplies<double>(), coeff) );
+  std::vector<double> const& dpx_vec =  twake_( projector_.dipoleHorLineDensity() );   
+  std::transform( dpx_vec.begin(), dpx_vec.begin() + nsamples_, dpx_.begin(), std::bind2nd( multiplies<double>(), coeff) );
 
-  for ( ParticleBunch::iterator it = bunch.begin(); it != bunch.end(); ++it )
-   {
-      Vector& state         =  it->state();
+  std::vector<double> const& dpy_vec =  twake_( projector_.dipoleVerLineDensity() );   
+  std::transform( dpy_vec.begin(), dpy_vec.begin() + nsamples_, dpy_.begin(), std::bind2nd( multiplies<double>(), coeff) );
 
-      int ibin = int( (state[2] - cdt_min) / binsize ); 
-       
-      if ( ibin > (nsamples_-1) ) { 
+  //------------------------------------------------------------------
+  // For each particle in the bunch, apply appropriate wakefield kicks 
+  // -----------------------------------------------------------------  
+
+  //------------------------------------------------------------------
+  // The kicks of different particles are independent; contiguous 
+  // ranges of the bunch are kicked concurrently by the threads of the 
+  // shared worker pool. 
+  // -----------------------------------------------------------------  
+
+  int const n       = bunch.size();
+  int const nchunks = std::max( 1, std::min( beamline::numberOfThreads(), n/min_chunk_size ) );
+
+  if ( int( tasks_.size() ) != nchunks ) { 
+    tasks_.resize( nchunks );
+    for ( int j=0; j < nchunks; ++j ) { 
+      tasks_[j] = boost::bind( &WakeKick::Propagator::kickChunk, this, j ); 
+    }
+  }
+
+  bounds_.resize( nchunks+1 );
+  bounds_[0] = 0;
+  for ( int j=0; j < nchunks; ++j ) {
+    bounds_[j+1] = bounds_[j] + n/nchunks + ( (j < n%nchunks) ? 1 : 0 );
+  }
+
+  outOfRange_.assign( nchunks, 0 );
+
+  bunch_   = &bunch;
+  cdt_min_ = cdt_min;
+  binsize_ = binsize;
+
+  if ( nchunks < 2 ) { 
+    kickChunk( 0 ); 
+  }
+  else { 
+    WorkerPool::instance().run( tasks_ );
+  }
+
+  bunch_ = 0;
+
+  if ( std::find( outOfRange_.begin(), outOfRange_.end(), 1 ) != outOfRange_.end() ) { 
 
 	(*pcerr) << "*** WARNING *** "                                                                << std::endl; 
 	(*pcerr) << "*** WARNING ***   WakeKickPhysics.cc : Histogram bin index out of range  "       << std::endl; 
 	(*pcerr) << "*** WARNING ***   WakeKickPhysics.cc : Total bunch length : "    << bunch_length << std::endl;
 	(*pcerr) << "*** WARNING ***   WakeKickPhysics.cc : Sampling region width : " << interval_     << std::endl;
 
-         break;  //  just a sanity check ... this should never happen !
-      }
+        //  just a sanity check ... this should never happen !
+  }
 
-      state[3]  +=  dpx_vec[ibin] ;
-      state[4]  +=  dpy_vec[ibin] ; 
+}
 
-      //------------------------------------------------------
-      // **** apply the longitudinal wake 
-      //------------------------------------------------------
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
 
-      double npz =  it->npz() + dpz_vec[ibin];   
-      state[5]   =  sqrt( npz*npz + state[3]*state[3] + state[4]*state[4] ) - 1.0 ;
-  }   
+void WakeKick::Propagator::kickChunk( int j )
+{
+  Kicks const kicks = { &dpx_[0], &dpy_[0], &dpz_[0], cdt_min_, binsize_, nsamples_ };
 
+  kick( bunch_->begin() + bounds_[j], bunch_->begin() + bounds_[j+1], kicks, outOfRange_[j] );
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+void WakeKick::Propagator::resetWakes()
+{
+  boost::function<double(int)> lwake = boost::bind<double>(ShortRangeLWakeFunction(),  _1,  interval_/(nsamples_-1),  0.5*interval_ );
+  boost::function<double(int)> twake = boost::bind<double>(ShortRangeTWakeFunction(),  _1,  interval_/(nsamples_-1),  0.5*interval_ );
+
+  for (int i=0; i<nsamples_; ++i) { samples_[i] = lwake(i); } 
+  lwake_.resetLHS( samples_ );
+
+  for (int i=0; i<nsamples_; ++i) { samples_[i] = twake(i); } 
+  twake_.resetLHS( samples_ ); 
 }
 
 //|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
@@ -268,23 +394,30 @@ void WakeKick::Propagator::operator()(  BmlnElmnt const&  elm,  JetParticle& p)
 
 void WakeKick::Propagator::debug(  WakeKick& elm, ParticleBunch& bunch )
 {
-  const BunchProjector projector(bunch);
+  projector_.project( bunch, interval_ );
   
-  double binsize  = interval_/(nsamples_-1);
-  int    ibin = 0;
-
   //-------------------------------------------------------------------------- 
-  // NOTE: the result of the convolution need to be scaled by binsize. 
-  //       This is is done below, when the kicks are actually applied
+  // NOTE: the result of the convolution is not scaled by binsize here. 
+  //       The convolution results are held by the functors; they are 
+  //       copied, since twake_ is used twice.
   //--------------------------------------------------------------------------
 
-  std::vector<double> const dpx_vec =  twake_( projector.dipoleHorLineDensity() );   
-  std::vector<double> const dpy_vec =  twake_( projector.dipoleVerLineDensity() );   
-  std::vector<double> const dpz_vec =  lwake_( projector.monopoleLineDensity()  );   
+  std::vector<double> dpx_vec( nsamples_ );
+  std::vector<double> dpy_vec( nsamples_ );
+  std::vector<double> dpz_vec( nsamples_ );
+
+  std::vector<double> const& hor = twake_( projector_.dipoleHorLineDensity() );
+  std::copy( hor.begin(), hor.begin() + nsamples_, dpx_vec.begin() );
+
+  std::vector<double> const& ver = twake_( projector_.dipoleVerLineDensity() );
+  std::copy( ver.begin(), ver.begin() + nsamples_, dpy_vec.begin() );
+
+  std::vector<double> const& lon = lwake_( projector_.monopoleLineDensity() );
+  std::copy( lon.begin(), lon.begin() + nsamples_, dpz_vec.begin() );
 
-  std::vector<double>::const_iterator it_dipole_x =  projector.dipoleHorLineDensity().begin(); 
-  std::vector<double>::const_iterator it_dipole_y =  projector.dipoleVerLineDensity().begin();
-  std::vector<double>::const_iterator it_monopole =  projector.monopoleLineDensity().begin();
+  std::vector<double>::const_iterator it_dipole_x =  projector_.dipoleHorLineDensity().begin(); 
+  std::vector<double>::const_iterator it_dipole_y =  projector_.dipoleVerLineDensity().begin();
+  std::vector<double>::const_iterator it_monopole =  projector_.monopoleLineDensity().begin();
 
   std::vector<double>::const_iterator it_dpx = dpx_vec.begin();  
   std::vector<double>::const_iterator it_dpy = dpy_vec.begin();
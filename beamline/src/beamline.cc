@@ -322,6 +322,7 @@ double beamline::OrbitLength( Particle const& x ) const
 void beamline::clear() 
 {
   theList_.clear();
+  markModified();
 }
 
 //||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
@@ -362,6 +363,7 @@ void beamline::insert( ElmPtr q ) {
   
   length_ += bml ? bml->BmlnElmnt::Length() : q->Length();
 
+  markModified();
 }  
 
 //||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
@@ -393,6 +395,7 @@ void beamline::append( ElmPtr q ) {
  if (bml)  bml->parent_ = this; 
  length_ += bml ? bml->BmlnElmnt::Length() : q->Length();
 
+ markModified();
 
 } 
 
@@ -753,6 +756,8 @@ beamline::iterator beamline::putAbove( beamline::iterator it, ElmPtr elm )
  length_ += bml ? bml->Length() : elm->Length();
 
  if (bml)  bml->parent_ = this; 
+
+ markModified();
  
  return it;
 
@@ -786,6 +791,8 @@ beamline::iterator beamline::putBelow( beamline::iterator  iter, ElmPtr elm)
  length_ += bml ? bml->Length() : elm->Length();
 
  if (bml)  bml->parent_ = this; 
+
+ markModified();
  
  return iter;
 
@@ -843,6 +850,7 @@ int beamline::startAt( ConstElmPtr const& x, int n ) {
   }
 
   theList_ = newList;
+  markModified();
 
   return 0;
 }
@@ -879,6 +887,7 @@ int beamline::startAt( char const* s, int n ) {
   }
 
   theList_ = newList;
+  markModified();
 
   return 0;
 }
@@ -1059,6 +1068,8 @@ beamline::iterator beamline::erase( beamline::iterator pos1, beamline::iterator
  std::list<ElmPtr>::iterator pos1x = pos1.base();
  std::list<ElmPtr>::iterator pos2x = pos2.base();
  
+ markModified();
+
  return iterator( this, theList_.erase( pos1x, pos2x) ); 
 
 }
@@ -1445,6 +1456,7 @@ bool beamline::setAlignment( Alignment const& al ) {
 void beamline::remove( ElmPtr elm ) 
 { 
   theList_.remove( elm ); 
+  markModified();
   return; 
 }
 
@@ -1506,6 +1518,7 @@ beamline::iterator beamline::erase( beamline::iterator it)
   std::list<ElmPtr>::iterator lit = it.base();  
  
   lit = theList_.erase( lit );    
+  markModified();
 
   return beamline::iterator( this, lit);
 } 
@@ -1521,6 +1534,33 @@ bool  beamline::isBeamline() const
 //||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
 //||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
 
+bool  beamline::isCollective() const 
+{ 
+  for ( beamline::const_iterator it = begin(); it != end(); ++it ) {
+    if ( (*it)->isCollective() ) return true;
+  }
+  return false; 
+}
+
+//||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+void  beamline::setNumberOfThreads( int n ) 
+{ 
+  beamline::Propagator::setNumberOfThreads( n );
+}
+
+//||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+int  beamline::numberOfThreads() 
+{ 
+  return beamline::Propagator::numberOfThreads();
+}
+
+//||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
 int beamline::size() const 
 {
   return theList_.size();
@@ -111,7 +111,7 @@ gkick::gkick( gkick const& x )
     dl_   ( x.dl_  ),   
     dp_   ( x.dp_  ),   
     angle_( x.angle_ ),  
-    dz_   ( x.dx_  ),    
+    dz_   ( x.dz_  ),    
     v_    ( x.v_   ),  
     t_    ( x.t_   )
 {}
@@ -132,7 +132,7 @@ gkick&  gkick::operator=( gkick const& rhs) {
   dl_   = rhs.dl_;   
   dp_   = rhs.dp_;   
   angle_= rhs.angle_;  
-  dz_   = rhs.dx_;    
+  dz_   = rhs.dz_;    
   v_    = rhs.v_;  
   t_    = rhs.t_;
 
@@ -151,6 +151,7 @@ gkick::~gkick()
 void gkick::set_dx( double const& dx)
 {
   dx_ = dx;
+  markModified();
 }
 
 //||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
@@ -159,6 +160,7 @@ void gkick::set_dx( double const& dx)
 void  gkick::set_dxp(double const& dxp )
 {
   dxp_ = dxp;
+  markModified();
 }
 
 //||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
@@ -167,6 +169,7 @@ void  gkick::set_dxp(double const& dxp )
 void  gkick::set_dy( double const& dy )
 {
   dy_ = dy;
+  markModified();
 }
 
 //||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
@@ -175,6 +178,7 @@ void  gkick::set_dy( double const& dy )
 void  gkick::set_dyp(  double const& dyp)
 {
   dyp_ = dyp;
+  markModified();
 }
 
 //||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
@@ -183,6 +187,7 @@ void  gkick::set_dyp(  double const& dyp)
 void  gkick::set_dl( double const& dl)
 {
     dl_ = dl;
+    markModified();
 }
 
 //||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
@@ -191,6 +196,7 @@ void  gkick::set_dl( double const& dl)
 void  gkick::set_dp( double const& dp)
 {
     dp_ = dp;
+    markModified();
 
 }
 //||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
@@ -199,6 +205,7 @@ void  gkick::set_dp( double const& dp)
 void  gkick::set_angle( double const& angle)
 {
     angle_ = angle;
+    markModified();
   
 }
 
@@ -209,6 +216,7 @@ void  gkick::set_dz( double const& dz)
 {
 
     dz_ = dz;
+    markModified();
 }
 
 //||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
@@ -217,6 +225,7 @@ void  gkick::set_dz( double const& dz)
 void  gkick::set_v( double const& v)
 {
      v_ = v;
+     markModified();
 }
 
 //||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
@@ -225,6 +234,7 @@ void  gkick::set_v( double const& v)
 void  gkick::set_t( double const& t)
 {
      t_ = t;
+     markModified();
 }
 
 //||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
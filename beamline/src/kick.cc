@@ -460,6 +460,7 @@ void  kick::setHorStrength(double const& value)
 void   kick::setVerStrength(double const& value)
 {
   vh_ratio_ = ( Strength() != 0.0) ? value/Strength() : value;
+  markModified();
 }
 
 //||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
@@ -118,6 +118,7 @@ thinLamb& thinLamb::operator=( thinLamb const& rhs)
 void thinLamb::setSeptum( double const& x) 
 {
  xSeptum_ = x;
+ markModified();
 }
 
 //|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
@@ -126,6 +127,7 @@ void thinLamb::setSeptum( double const& x)
 void thinLamb::setBeamline( BmlPtr& b) 
 {
  ExtBeamline_ = b;
+ markModified();
 }
 
 //|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
@@ -173,6 +175,7 @@ bool     thinLamb::isDriftSpace() const
 void thinLamb::setRefState( std::vector<double> const& state) 
 {
   RefState_ = state;
+  markModified();
 }
 
 //|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
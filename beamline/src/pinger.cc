@@ -211,6 +211,7 @@ double const& Pinger::getKickDirection() const
 void Pinger::setKickDirection(double const& k) 
 { 
   kick_direction_ = k; 
+  markModified();
 }
 
 // ||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
@@ -55,6 +55,7 @@
 
 #include <basic_toolkit/iosetup.h>
 #include <basic_toolkit/GenericException.h>
+#include <sstream>
 #include <beamline/quadrupole.h>
 #include <beamline/Drift.h>
 #include <beamline/beamline.h>
@@ -73,7 +74,7 @@ using FNAL::pcout;
 // **************************************************
 
 quadrupole::quadrupole()
-  :  BmlnElmnt( "", 1.0, 0.0 )
+  :  BmlnElmnt( "", 1.0, 0.0 ), integrator_( 0, 4 )
 {
    propagator_ = PropagatorPtr( new Propagator( *this, 4 ) );     
 }
@@ -82,7 +83,7 @@ quadrupole::quadrupole()
 //||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
 
 quadrupole::quadrupole( std::string const& n, double const& l, double const& s )
-  : BmlnElmnt( n, l, s)
+  : BmlnElmnt( n, l, s), integrator_( 0, 4 )
 {
     propagator_ = PropagatorPtr( new Propagator(*this, 4) );     
 }
@@ -92,7 +93,7 @@ quadrupole::quadrupole( std::string const& n, double const& l, double const& s )
 //||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
 
 quadrupole::quadrupole( quadrupole const& x ) 
-  : BmlnElmnt(x)
+  : BmlnElmnt(x), integrator_( x.integrator_ )
 {}
 
 //||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
@@ -117,6 +118,7 @@ quadrupole& quadrupole::operator=( quadrupole const& o)
   if ( this == &o ) return *this; 
 
   BmlnElmnt::operator=(o);
+  integrator_ = o.integrator_;
 
   return (*this);
 }
@@ -165,6 +167,33 @@ bool quadrupole::isDriftSpace() const
 //||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
 //||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
 
+void quadrupole::setIntegrator( int order, int n )
+{
+  if ( ( n < 1 ) || ( order != 0 && order != 2 && order != 4 && order != 6 && order != 8 ) ) {
+    ostringstream uic;
+    uic << "Order " << order << " with " << n << " steps requested for " << Type() << "  " << Name()
+        << ". The order must be 0, 2, 4, 6 or 8 and the number of steps positive.";
+    throw( GenericException( __FILE__, __LINE__, 
+           "void quadrupole::setIntegrator( int order, int n )", 
+           uic.str().c_str() ) );
+  }
+
+  propagator_->setAttribute( *this, "INTEGRATOR", std::make_pair( order, n ) );
+  integrator_ = std::make_pair( order, n );
+  markModified();
+}
+
+//||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+std::pair<int,int> const& quadrupole::getIntegrator() const
+{
+  return integrator_;
+}
+
+//||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
 istream& quadrupole::readFrom(istream& is)
 {
   return is;
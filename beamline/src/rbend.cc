@@ -449,6 +449,7 @@ double rbend::setEntryAngle( double const& phi /* radians */ )
   double ret = usAngle_;
   usAngle_   = phi;
   propagator_->ctor(*this);
+  markModified();
   return ret;
 }
 
@@ -460,6 +461,7 @@ double rbend::setExitAngle( double const& phi /* radians */ )
   double ret = dsAngle_;
   dsAngle_   = phi;  
   propagator_->ctor(*this);
+  markModified();
   return ret;
 }
 
@@ -487,7 +489,7 @@ bool rbend::hasStandardFaces() const
 void rbend::propagateReference( Particle& p, double initialBRho, bool scaling) 
 {
   setEntryAngle(p);
-  propagateReference(p, initialBRho, scaling);
+  BmlnElmnt::propagateReference(p, initialBRho, scaling);
   setExitAngle(p);
 }
 
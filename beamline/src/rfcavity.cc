@@ -242,6 +242,7 @@ void rfcavity::setHarmon( double const& h )
   h_ = h;
 
   propagator_->setAttribute(*this, "HARMONIC_NUMBER", h );
+  markModified();
 }
 
 //||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
@@ -251,6 +252,7 @@ void rfcavity::setFrequency( double const& f )
 {
   f_ = f;
   propagator_->setAttribute(*this, "FREQUENCY", f_ );
+  markModified();
 }
 
 //||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
@@ -260,6 +262,7 @@ void rfcavity::setFrequencyRelativeTo( double const& f )
 {
   f_ *= h_;  
   propagator_->setAttribute(*this, "FREQUENCY", f_ );
+  markModified();
 }
 
 //||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
@@ -271,6 +274,7 @@ void rfcavity::setPhi( double const& angle )
   sin_phi_s_ =  sin(angle);
 
   propagator_->setAttribute(*this, "PHIS", phi_s_ );
+  markModified();
 
 };
 
@@ -281,6 +285,7 @@ void rfcavity::setQ( double const& Q )
 {
   Q_     = Q;
   propagator_->setAttribute(*this, "QFACTOR", Q_ );
+  markModified();
 
 };
 
@@ -292,6 +297,7 @@ void rfcavity::setR( double const& R )
 {
   R_ = R;
   propagator_->setAttribute(*this, "SHUNTR", f_ );
+  markModified();
 }
 
 //||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
@@ -513,6 +519,7 @@ bool    thinrfcavity::isDriftSpace() const
 void thinrfcavity::setHarmon( double const& h )
 {
   h_ = ( h > 0 ) ? h : -1; 
+  markModified();
 }
 
 //||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
@@ -521,6 +528,7 @@ void thinrfcavity::setHarmon( double const& h )
 void thinrfcavity::setFrequency( double const& f )
 {
   f_ = f;
+  markModified();
 }
 
 //||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
@@ -533,6 +541,7 @@ void thinrfcavity::setFrequencyRelativeTo( double const& f )
   if( (f > 0) && (h_ > 0) ) {
     f_ = h_* f;
   }
+  markModified();
 }
 
 //||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
@@ -542,6 +551,7 @@ void thinrfcavity::setFrequencyRelativeTo( double const& f )
 void thinrfcavity::setQ( double const& Q )
 {
   Q_ = Q;
+  markModified();
 }
 
 //||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
@@ -550,6 +560,7 @@ void thinrfcavity::setQ( double const& Q )
 void thinrfcavity::setR( double const& R )
 {
   R_ = R;
+  markModified();
 }
 
 //||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
@@ -559,6 +570,7 @@ void thinrfcavity::setPhi( double const& angle )
 {
   phi_s_     = angle;
   sin_phi_s_ = sin(angle);
+  markModified();
 };
 
 
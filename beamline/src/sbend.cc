@@ -258,6 +258,7 @@ double sbend::setEntryAngle( double const& phi /* radians */ )
   double ret  = usAngle_;
   usAngle_    = phi;
   propagator_->ctor(*this);
+  markModified();
   return ret;
 }
 
@@ -269,6 +270,7 @@ double sbend::setExitAngle( double const& phi /* radians */ )
   double ret = dsAngle_;
   dsAngle_   = phi;  
   propagator_->ctor(*this);
+  markModified();
   return ret;
 }
 
@@ -264,6 +264,7 @@ Matrix sector::getMatrix() const
 void sector::setFrequency( double (*fcn)( double const& ) ) 
 {
   DeltaT = fcn;
+  markModified();
 }
 
 //|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
@@ -272,6 +273,7 @@ void sector::setFrequency( double (*fcn)( double const& ) )
 void sector::setFrequency( Jet (*fcn)( const Jet& ) ) 
 {
   JetDeltaT = fcn;
+  markModified();
 }
 
 //|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
@@ -130,6 +130,7 @@ thinSeptum::~thinSeptum() {
 void thinSeptum::setStrengths( double const& sPos, double const& sNeg ) {
  strengthPos_ = sPos;
  strengthNeg_ = sNeg;
+ markModified();
 }
 
 //||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
@@ -137,6 +138,7 @@ void thinSeptum::setStrengths( double const& sPos, double const& sNeg ) {
 
 void thinSeptum::setWire( double const& x) {
  xWire_ = x;
+ markModified();
 }
 
 
@@ -60,6 +60,7 @@
 #endif
 
 #include <basic_toolkit/GenericException.h>
+#include <sstream>
 #include <beamline/beamline.h>
 #include <beamline/sextupole.h>
 #include <beamline/Drift.h>
@@ -78,7 +79,7 @@ using namespace std;
 //||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
 
 sextupole::sextupole ()
-: BmlnElmnt( "", 1.0, 0.0 ) 
+: BmlnElmnt( "", 1.0, 0.0 ), integrator_( 0, 4 ) 
 {
   propagator_ = PropagatorPtr( new Propagator(*this) );
 }
@@ -87,7 +88,7 @@ sextupole::sextupole ()
 //||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
 
 sextupole::sextupole ( std::string const& n, double const& l, double const& s ) 
-: BmlnElmnt( n, l, s ) 
+: BmlnElmnt( n, l, s ), integrator_( 0, 4 ) 
 {
   propagator_ =  PropagatorPtr( new Propagator(*this) );
 }
@@ -96,7 +97,7 @@ sextupole::sextupole ( std::string const& n, double const& l, double const& s )
 //||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
 
 sextupole::sextupole( sextupole const& x ) 
-  : BmlnElmnt( x )
+  : BmlnElmnt( x ), integrator_( x.integrator_ )
 {}
 
 //||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
@@ -122,6 +123,7 @@ sextupole& sextupole::operator=( sextupole const& o)
   if ( this == &o ) return *this; 
 
   BmlnElmnt::operator=(o);
+  integrator_ = o.integrator_;
   propagator_->ctor(*this);
   return (*this);
 }
@@ -170,6 +172,33 @@ bool sextupole::isDriftSpace() const
 //||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
 //||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
 
+void sextupole::setIntegrator( int order, int n )
+{
+  if ( ( n < 1 ) || ( order != 0 && order != 2 && order != 4 && order != 6 && order != 8 ) ) {
+    ostringstream uic;
+    uic << "Order " << order << " with " << n << " steps requested for " << Type() << "  " << Name()
+        << ". The order must be 0, 2, 4, 6 or 8 and the number of steps positive.";
+    throw( GenericException( __FILE__, __LINE__, 
+           "void sextupole::setIntegrator( int order, int n )", 
+           uic.str().c_str() ) );
+  }
+
+  propagator_->setAttribute( *this, "INTEGRATOR", std::make_pair( order, n ) );
+  integrator_ = std::make_pair( order, n );
+  markModified();
+}
+
+//||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+std::pair<int,int> const& sextupole::getIntegrator() const
+{
+  return integrator_;
+}
+
+//||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
 void sextupole::accept( BmlVisitor& v ) 
 { 
   v.visit( *this ); 
@@ -122,6 +122,7 @@ bool thinMultipole::isThin() const
 void  thinMultipole::setPole(int n, std::complex<double> const&  coeff)
 {
   poles_[n] = coeff; 
+  markModified();
 }
 
 //|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
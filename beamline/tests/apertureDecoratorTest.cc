@@ -0,0 +1,144 @@
+////////////////////////////////////////////////////////////
+//
+// File:          apertureDecoratorTest.cc
+//
+////////////////////////////////////////////////////////////
+//
+// Propagates protons through a quadrupole with an aperture
+// (BmlnElmnt::setAperture) and compares with the same
+// quadrupole without one. Checks that
+//
+//  - a particle inside the aperture is propagated exactly
+//    as without the aperture, alone, in a ParticleBunch and
+//    in a BunchArrays;
+//  - a particle outside the aperture is flagged lost and is
+//    not propagated, and a lost particle is left untouched;
+//  - a rectangular aperture flags a particle at 1.5 times
+//    its half-width;
+//  - a copy of the element keeps the aperture.
+//
+// ------------
+// COMMAND LINE
+// ------------
+// apertureDecoratorTest
+//
+////////////////////////////////////////////////////////////
+
+#include <iostream>
+
+#include <beamline/Particle.h>
+#include <beamline/TBunch.h>
+#include <beamline/BunchArrays.h>
+#include <beamline/quadrupole.h>
+
+using namespace std;
+
+namespace {
+
+bool same( Particle const& p, Particle const& q )
+{
+  for ( int i=0; i<6; ++i ) {
+    if ( p.state()[i] != q.state()[i] ) return false;
+  }
+  return true;
+}
+
+} // anonymous namespace
+
+int main( int argc, char** argv )
+{
+  Proton pr( 100.0 );
+
+  double const hw = 0.01;   // [m]
+
+  quadrupole bare( "Q", 0.5, 0.1*pr.refBrho() );
+
+  int status = 0;
+
+  BmlnElmnt::aperture_t const types[] = { BmlnElmnt::elliptical, BmlnElmnt::rectangular };
+
+  for ( int k=0; k<2; ++k ) {
+
+    quadrupole Q( bare );
+    Q.setAperture( types[k], hw, hw );
+
+    char const* const label = ( k == 0 ) ? "elliptical" : "rectangular";
+
+    Proton inside ( pr );  inside.x ( 0.5*hw );  inside.npx( 1.0e-4 );
+    Proton outside( pr );  outside.x( 1.5*hw );
+
+    // ---------------------------------------
+    // single particles
+    // ---------------------------------------
+
+    Proton expected( inside );
+    bare.propagate( expected );
+
+    Proton p( inside );
+    Q.propagate( p );
+
+    if ( p.isLost() || !same( p, expected ) ) {
+      cout << "*** ERROR *** " << label << ": a particle inside the aperture was not propagated." << endl;
+      status = 1;
+    }
+
+    Proton q( outside );
+    Q.propagate( q );
+
+    if ( !q.isLost() || !same( q, outside ) ) {
+      cout << "*** ERROR *** " << label << ": a particle outside the aperture was not flagged, or was propagated." << endl;
+      status = 1;
+    }
+
+    Proton lost( inside );
+    lost.setLost( true );
+    Q.propagate( lost );
+
+    if ( !same( lost, inside ) ) {
+      cout << "*** ERROR *** " << label << ": a lost particle was propagated." << endl;
+      status = 1;
+    }
+
+    // ---------------------------------------
+    // ParticleBunch, BunchArrays
+    // ---------------------------------------
+
+    ParticleBunch bunch( pr );
+    bunch.append( inside );
+    bunch.append( outside );
+
+    BunchArrays arrays( bunch );
+
+    Q.propagate( bunch );
+    Q.propagate( arrays );
+
+    ParticleBunch::const_iterator it = bunch.begin();
+
+    if ( it->isLost() || !same( *it, expected ) || !( it+1 )->isLost() || !same( *( it+1 ), outside ) ) {
+      cout << "*** ERROR *** " << label << ": the aperture was not applied to a ParticleBunch." << endl;
+      status = 1;
+    }
+
+    if ( arrays.isLost( 0 ) || !arrays.isLost( 1 ) ) {
+      cout << "*** ERROR *** " << label << ": the aperture was not applied to a BunchArrays." << endl;
+      status = 1;
+    }
+
+    // ---------------------------------------
+    // copy
+    // ---------------------------------------
+
+    quadrupole C( Q );
+
+    Proton r( outside );
+    C.propagate( r );
+
+    if (    C.aperture().get<0>() != types[k] || C.aperture().get<1>() != hw || C.aperture().get<2>() != hw
+         || !r.isLost() ) {
+      cout << "*** ERROR *** " << label << ": a copy of the element lost its aperture." << endl;
+      status = 1;
+    }
+  }
+
+  return status;
+}
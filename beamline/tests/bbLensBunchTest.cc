@@ -0,0 +1,193 @@
+////////////////////////////////////////////////////////////
+//
+// File:          bbLensBunchTest.cc
+//
+////////////////////////////////////////////////////////////
+//
+// Propagates a bunch of protons through a BBLens, particle
+// by particle and then with the bunch propagators
+// (ParticleBunch and BunchArrays), which evaluate the complex
+// error function for the whole bunch in one pass. All of them
+// use the same complex error function: the kicks must agree
+// to rounding (1.0e-12), and the field at a single point must
+// be that of the n point version.
+//
+// Round, flat (sigma_x > sigma_y) and tall (sigma_x < sigma_y)
+// beams are tested; the particles cover the four quadrants,
+// the core and the tails of the beam. Checks also that the
+// field is odd in x and in y.
+//
+// ------------
+// COMMAND LINE
+// ------------
+// bbLensBunchTest [options]
+//
+// -------
+// OPTIONS
+// -------
+// Note: NNN represents an integer
+//
+// -n       NNN   number of particles
+//                : default = 5000
+//
+////////////////////////////////////////////////////////////
+
+#include <iostream>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <vector>
+
+#include <basic_toolkit/VectorD.h>
+#include <basic_toolkit/RandomStreams.h>
+#include <beamline/Particle.h>
+#include <beamline/TBunch.h>
+#include <beamline/BunchArrays.h>
+#include <beamline/BBLens.h>
+
+using namespace std;
+
+namespace {
+
+double compare( ParticleBunch const& a, ParticleBunch const& b, ParticleBunch const& initial )
+{
+  // largest kick difference, relative to the largest kick
+
+  double maxkick = 0.0;
+  double maxdiff = 0.0;
+
+  ParticleBunch::const_iterator jt = b.begin();
+  ParticleBunch::const_iterator kt = initial.begin();
+  for ( ParticleBunch::const_iterator it = a.begin(); it != a.end(); ++it, ++jt, ++kt ) {
+    for ( int i=Particle::i_npx; i<=Particle::i_npy; ++i ) {
+      maxkick = std::max( maxkick, std::abs( it->state()[i] - kt->state()[i] ) );
+      maxdiff = std::max( maxdiff, std::abs( it->state()[i] - jt->state()[i] ) );
+    }
+  }
+  return ( maxkick > 0.0 ) ? maxdiff/maxkick : 1.0;   // no kick at all is an error
+}
+
+int check( char const* label, BBLens const& lens, ParticleBunch const& initial )
+{
+  int status = 0;
+
+  ParticleBunch single( initial.getReferenceParticle() );
+  ParticleBunch bunch ( initial.getReferenceParticle() );
+
+  for ( ParticleBunch::const_iterator it = initial.begin(); it != initial.end(); ++it ) {
+    single.append( *it );
+    bunch.append ( *it );
+  }
+
+  BunchArrays arrays( initial );
+
+  for ( ParticleBunch::iterator it = single.begin(); it != single.end(); ++it ) {
+    lens.propagate( *it );
+  }
+
+  lens.propagate( bunch  );
+  lens.propagate( arrays );
+
+  ParticleBunch fromArrays( initial.getReferenceParticle() );
+  arrays.store( fromArrays );
+
+  double const e1 = compare( single, bunch,      initial );
+  double const e2 = compare( single, fromArrays, initial );
+
+  if ( !( e1 <= 1.0e-12 && e2 <= 1.0e-12 ) ) {
+    cout << "*** ERROR *** " << label << ": bunch kicks differ from single particle kicks by "
+         << e1 << " (ParticleBunch), " << e2 << " (BunchArrays)" << endl;
+    status = 1;
+  }
+
+  // symmetry
+
+  double const sx = lens.getSigmas()[0];
+  double const sy = lens.getSigmas()[1];
+
+  double const x[4] = {  sx,        -sx,         sx,        -sx        };
+  double const y[4] = {  0.7*sy,     0.7*sy,    -0.7*sy,    -0.7*sy    };
+  double       ex[4];
+  double       ey[4];
+
+  lens.NormalizedEField( 4, x, y, ex, ey );
+
+  // single point
+
+  for ( int k=0; k<4; ++k ) {
+    Vector const e = lens.NormalizedEField( x[k], y[k] );
+    if ( std::abs( e[0] - ex[k] ) > 1.0e-12*std::abs( ex[k] ) || std::abs( e[1] - ey[k] ) > 1.0e-12*std::abs( ey[k] ) ) {
+      cout << "*** ERROR *** " << label << ": the field at a single point differs from the n point version." << endl;
+      status = 1;
+      break;
+    }
+  }
+
+  for ( int k=0; k<4; ++k ) {
+    if (    std::abs( ex[k] - ( x[k] < 0.0 ? -ex[0] : ex[0] ) ) > 1.0e-12*std::abs( ex[0] )
+         || std::abs( ey[k] - ( y[k] < 0.0 ? -ey[0] : ey[0] ) ) > 1.0e-12*std::abs( ey[0] )
+         || ex[0] <= 0.0 || ey[0] <= 0.0 ) {
+      cout << "*** ERROR *** " << label << ": the field is not odd in x and y, or points inwards." << endl;
+      status = 1;
+      break;
+    }
+  }
+
+  return status;
+}
+
+} // anonymous namespace
+
+int main( int argc, char** argv )
+{
+  int n = 5000;
+
+  for ( int i=1; i<argc; ++i ) {
+    if ( 0 == strcmp( argv[i], "-n" ) && i+1 < argc ) { n = atoi( argv[++i] ); }
+  }
+
+  Proton proton(1000.0);
+
+  // ---------------------------------------
+  // particles: core and tails, all quadrants
+  // ---------------------------------------
+
+  ParticleBunch initial( proton );
+
+  RandomStream rnd( 31415 );
+
+  for ( int j=0; j<n; ++j ) {
+    Proton p( proton );
+    double const r = ( j%4 == 0 ? 12.0 : 3.0 )*1.0e-3;   // tails beyond sqrt(64) sigma
+    p.x   ( r*( 2.0*rnd() - 1.0 ) );
+    p.y   ( r*( 2.0*rnd() - 1.0 ) );
+    p.npx ( 1.0e-4*( 2.0*rnd() - 1.0 ) );
+    p.npy ( 1.0e-4*( 2.0*rnd() - 1.0 ) );
+    p.ndp ( 1.0e-3*( 2.0*rnd() - 1.0 ) );
+    initial.append( p );
+  }
+
+  int status = 0;
+
+  BBLens lens( "IP", 1.0, 1.0e11, proton.refGamma() );
+
+  std::vector<double> sigmas( 3, 0.0 );
+
+  sigmas[0] = 1.0e-3;  sigmas[1] = 1.0e-3;
+  lens.setSigmas( sigmas );
+  status |= check( "round beam", lens, initial );
+
+  sigmas[0] = 1.0e-3;  sigmas[1] = 0.4e-3;
+  lens.setSigmas( sigmas );
+  status |= check( "flat beam", lens, initial );
+
+  lens.useRound = 0;
+  status |= check( "flat beam, no round approximation", lens, initial );
+  lens.useRound = 1;
+
+  sigmas[0] = 0.3e-3;  sigmas[1] = 0.8e-3;
+  lens.setSigmas( sigmas );
+  status |= check( "tall beam", lens, initial );
+
+  return status;
+}
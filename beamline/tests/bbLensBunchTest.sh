@@ -0,0 +1,15 @@
+#!/bin/csh
+
+./bbLensBunchTest
+set return_status = $status
+if( 0 != $return_status ) then
+  exit $return_status
+  endif
+
+./bbLensBunchTest -n 1001
+set return_status = $status
+if( 0 != $return_status ) then
+  exit $return_status
+  endif
+
+exit 0
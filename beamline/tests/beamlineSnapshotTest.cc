@@ -0,0 +1,401 @@
+////////////////////////////////////////////////////////////
+//
+// File:          beamlineSnapshotTest.cc
+//
+////////////////////////////////////////////////////////////
+//
+// Checks that a beamline stored in a BeamlineSnapshot is
+// instantiated identically.
+//
+// A ring with nested lines and elements of most of the
+// supported types (bends, bends with face angles, combined
+// function bends, multipoles, kickers, monitors, an rf cavity,
+// aligned and tagged elements) is registered, stored and
+// loaded back. The ring also holds the other types created by
+// the MAD8 and XSIF factories (thin2pole, gkick, LinacCavity),
+// thin multipoles, a septum, a slot, a beam-beam lens, a wake
+// kick, and quadrupoles and sextupoles with a symplectic
+// integrator. The element attributes of the two lines are
+// compared, and particles are tracked around both.
+//
+// The snapshot must be rejected once truncated or when the
+// version differs, and storing an element of an unsupported
+// type must fail.
+//
+// ------------
+// COMMAND LINE
+// ------------
+// beamlineSnapshotTest [options]
+//
+// -------
+// OPTIONS
+// -------
+// Note: NNN represents an integer
+//
+// -cells   NNN   number of cells
+//                : default = 8
+//
+////////////////////////////////////////////////////////////
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <vector>
+#include <complex>
+
+#include <basic_toolkit/GenericException.h>
+#include <beamline/beamline.h>
+#include <beamline/beamline_elements.h>
+#include <beamline/Alignment.h>
+#include <beamline/Particle.h>
+#include <beamline/BeamlineSnapshot.h>
+
+using namespace std;
+
+namespace {
+
+char const* const filename = "beamlineSnapshotTest.bml";
+
+double reldiff( double a, double b )
+{
+  return std::abs( a - b )/std::max( 1.0, std::abs( b ) );
+}
+
+//
+// Compares the attributes of the elements of a and b.
+//
+
+int compare( beamline const& a, beamline const& b )
+{
+  int status = 0;
+
+  if ( a.countHowManyDeeply() != b.countHowManyDeeply() ) {
+    cout << "*** ERROR *** The lines have " << a.countHowManyDeeply() << " and "
+         << b.countHowManyDeeply() << " elements." << endl;
+    return 1;
+  }
+
+  beamline::const_deep_iterator jt = b.deep_begin();
+
+  for ( beamline::const_deep_iterator it = a.deep_begin(); it != a.deep_end(); ++it, ++jt ) {
+
+    BmlnElmnt const& x = **it;
+    BmlnElmnt const& y = **jt;
+
+    bool const same =    ( std::string( x.Type() ) == y.Type() )
+                      && ( std::string( x.Name() ) == y.Name() )
+                      && ( x.getTag()            == y.getTag()            )
+                      && ( x.Length()            == y.Length()            )
+                      && ( x.Strength()          == y.Strength()          )
+                      && ( x.getReferenceTime()  == y.getReferenceTime()  )
+                      && ( x.alignment().xOffset() == y.alignment().xOffset() )
+                      && ( x.alignment().yOffset() == y.alignment().yOffset() )
+                      && ( x.alignment().roll()    == y.alignment().roll()    )
+                      && ( x.hasUpstreamEdge()   == y.hasUpstreamEdge()   )
+                      && ( x.hasDownstreamEdge() == y.hasDownstreamEdge() );
+
+    bool integrator = true;
+
+    if ( quadrupole const* q = dynamic_cast<quadrupole const*>( &x ) ) {
+      integrator = ( q->getIntegrator() == static_cast<quadrupole const&>( y ).getIntegrator() );
+    }
+    if ( sextupole const* s = dynamic_cast<sextupole const*>( &x ) ) {
+      integrator = ( s->getIntegrator() == static_cast<sextupole const&>( y ).getIntegrator() );
+    }
+
+    if ( !same || !integrator ) {
+      cout << "*** ERROR *** Element " << x.Type() << " " << x.Name()
+           << " differs from its instantiation " << y.Type() << " " << y.Name() << endl;
+      status = 1;
+    }
+  }
+
+  return status;
+}
+
+//
+// Tracks a particle around a and b.
+//
+
+int track( beamline const& a, beamline const& b, Proton const& proton, int nturns )
+{
+  Proton p( proton );
+  p.x  ( 1.0e-3 );
+  p.npy( 1.0e-5 );
+  p.ndp( 2.0e-4 );
+
+  Proton q( p );
+
+  for ( int turn=0; turn < nturns; ++turn ) {
+    a.propagate( p );
+    b.propagate( q );
+  }
+
+  double d = 0.0;
+  for ( int i=0; i<6; ++i ) { d = std::max( d, reldiff( q.state()[i], p.state()[i] ) ); }
+
+  if ( d > 1.0e-12 ) {
+    cout << "*** ERROR *** The instantiated ring differs from the original one by " << d
+         << " after " << nturns << " turns." << endl;
+    cout << "*** ERROR *** " << p.state() << endl;
+    cout << "*** ERROR *** " << q.state() << endl;
+    return 1;
+  }
+  return 0;
+}
+
+//
+// true if loading the file fails.
+//
+
+bool rejected( std::string const& fname )
+{
+  try {
+    BeamlineSnapshot snapshot( fname );
+  }
+  catch ( GenericException const& ) {
+    return true;
+  }
+  return false;
+}
+
+} // anonymous namespace
+
+int main( int argc, char** argv )
+{
+  int ncells = 8;
+
+  for ( int i=1; i<argc; ++i ) {
+    if ( 0 == strcmp( argv[i], "-cells" ) && i+1 < argc ) { ncells = atoi( argv[++i] ); }
+  }
+
+  Proton proton( 100.0 );
+  double const brho = proton.refBrho();
+
+  // ---------------------------------------
+  // ring
+  // ---------------------------------------
+
+  double const angle = 2.0*M_PI/( 2*ncells );
+
+  Drift         O ( "O",  1.5 );
+  quadrupole    F ( "F",  0.5,  0.12*brho );
+  quadrupole    D ( "D",  0.5, -0.12*brho );
+  sextupole     SF( "SF", 0.2,  0.4*brho );
+  thinSextupole SD( "SD",      -0.2*brho );
+  octupole      OC( "OC", 0.2,  1.0*brho );
+  thinQuad      TQ( "TQ",       0.002*brho );
+  sbend         B ( "B",  3.0, brho*angle/3.0, angle );
+  CF_sbend      CB( "CB", 3.0, brho*angle/3.0, angle );
+  hkick         HK( "HK",  1.0e-5*brho );
+  vkick         VK( "VK",  0.1, -2.0e-5*brho );
+  kick          K ( "K",   3.0e-6*brho, -1.0e-6*brho );
+  HMonitor      HM( "HM",  0.1 );
+  VMonitor      VM( "VM" );
+  Monitor       M ( "M" );
+  marker        MK( "MK" );
+
+  CB.setQuadrupole( 0.01*brho );
+  HM.setDriftFraction( 0.25 );
+
+  beamline arc( "ARC" );
+  arc.append( MK );
+  arc.append( F  );
+  arc.append( O  );
+  arc.append( SF );
+  arc.append( B  );
+  arc.append( O  );
+  arc.append( HM );
+  arc.append( D  );
+  arc.append( O  );
+  arc.append( SD );
+  arc.append( CB );
+  arc.append( VM );
+  arc.append( O  );
+
+  beamline ring( "RING" );
+
+  for ( int i=0; i<ncells; ++i ) {
+    beamline cell( arc );
+    cell.rename( "CELL" );
+    ring.append( cell );
+  }
+
+  ElmPtr aligned( TQ.clone() );
+  aligned->setAlignment( Alignment( 2.0e-4, -1.0e-4, 0.0, 0.0 ) );
+  aligned->setTag( "ALIGNED" );
+
+  rfcavity RF( "RF", 0.5, 53.0e6, 1.0e6, 0.0, 0.0, 0.0 );
+  RF.setHarmon( 84.0 );
+
+  ring.append( aligned );
+  ring.append( OC );
+  ring.append( HK );
+  ring.append( VK );
+  ring.append( K  );
+  ring.append( M  );
+  ring.append( RF );
+  ring.setLineMode( beamline::ring );
+  ring.setMomentum( proton.refMomentum() );
+
+  ring.registerReference( proton );
+
+  // rbend::propagateReference() does not terminate; the rectangular
+  // bends are added to a registered line
+
+  rbend    RB ( "RB",  2.0, 0.01*brho, 0.01, 0.001, 0.002 );
+  CF_rbend CRB( "CRB", 2.0, 0.01*brho, 0.01, 0.001, 0.002 );
+  CRB.setSextupole( 0.5*brho );
+
+  ring.append( RB  );
+  ring.append( CRB );
+
+  // other types created by the factories, and integrator settings
+
+  quadrupole    QI ( "QI",  0.5, 0.05*brho );
+  sextupole     SI ( "SI",  0.2, 0.3*brho  );
+  thin2pole     T2 ( "T2",  1.0e-5*brho );
+  thin12pole    T12( "T12", 10.0*brho );
+  thinMultipole TM ( "TM" );
+  gkick         GK;
+  LinacCavity   LC ( "LC",  0.5, 1.3e9, 1.0e3, 0.1, false );
+  thinSeptum    SP ( "SP",  1.0e-5, -2.0e-5, 0.02 );
+  Slot          SL ( "SL" );
+  BBLens        BB ( "BB",  1.0, 1.0e10, proton.refGamma() );
+  WakeKick      WK ( "WK" );
+
+  QI.setIntegrator( 4, 3 );
+  SI.setIntegrator( 6, 2 );
+
+  TM.setPole( 3, std::complex<double>( 2.0*brho, 0.0      ) );
+  TM.setPole( 4, std::complex<double>( 0.0,      5.0*brho ) );
+
+  GK.rename( "GK" );
+  GK.set_dx ( 1.0e-5 );
+  GK.set_dyp( 2.0e-6 );
+  GK.set_dz ( 3.0e-4 );
+  GK.setTag ( "GKICK" );
+
+  SL.makeUpstreamHorizontal( 0.5, 1.0e-3 );
+
+  std::vector<double> sigmas( 3, 0.0 );
+  sigmas[0] = 2.0e-3;  sigmas[1] = 1.0e-3;
+  BB.setSigmas( sigmas );
+  BB.useRound = 0;
+
+  ring.append( QI  );
+  ring.append( SI  );
+  ring.append( T2  );
+  ring.append( T12 );
+  ring.append( TM  );
+  ring.append( GK  );
+  ring.append( LC  );
+  ring.append( SP  );
+  ring.append( SL  );
+  ring.append( BB  );
+  ring.append( WK  );
+
+  int status = 0;
+
+  // ---------------------------------------
+  // round trip
+  // ---------------------------------------
+
+  BeamlineSnapshot::write( ring, filename );
+
+  BeamlineSnapshot snapshot( filename );
+
+  if ( snapshot.name() != "RING" ) {
+    cout << "*** ERROR *** The snapshot holds line " << snapshot.name() << endl;
+    status = 1;
+  }
+
+  BmlPtr copy = snapshot.instantiate();
+
+  if ( copy->getLineMode() != beamline::ring || copy->Momentum() != ring.Momentum() ) {
+    cout << "*** ERROR *** The line mode or momentum was not restored." << endl;
+    status = 1;
+  }
+
+  status |= compare( ring, *copy );
+  status |= track  ( ring, *copy, proton, 20 );
+
+  // ---------------------------------------
+  // a snapshot of the snapshot is identical
+  // ---------------------------------------
+
+  std::string const again = std::string( filename ) + ".2";
+  BeamlineSnapshot::write( *copy, again );
+
+  {
+    std::ifstream f1( filename,      std::ios::binary );
+    std::ifstream f2( again.c_str(), std::ios::binary );
+    std::ostringstream s1, s2;
+    s1 << f1.rdbuf();
+    s2 << f2.rdbuf();
+    if ( s1.str() != s2.str() ) {
+      cout << "*** ERROR *** The snapshot of the instantiated line differs from the original snapshot." << endl;
+      status = 1;
+    }
+  }
+
+  // ---------------------------------------
+  // damaged files
+  // ---------------------------------------
+
+  std::string contents;
+  {
+    std::ifstream is( filename, std::ios::binary );
+    std::ostringstream s;
+    s << is.rdbuf();
+    contents = s.str();
+  }
+
+  {
+    std::ofstream os( again.c_str(), std::ios::binary | std::ios::trunc );
+    os.write( contents.data(), contents.size()/2 );
+  }
+  if ( !rejected( again ) ) {
+    cout << "*** ERROR *** A truncated snapshot was accepted." << endl;
+    status = 1;
+  }
+
+  {
+    std::string modified( contents );
+    modified[8] = char( modified[8] + 1 );   // version
+    std::ofstream os( again.c_str(), std::ios::binary | std::ios::trunc );
+    os.write( modified.data(), modified.size() );
+  }
+  if ( !rejected( again ) ) {
+    cout << "*** ERROR *** A snapshot of another version was accepted." << endl;
+    status = 1;
+  }
+
+  // ---------------------------------------
+  // unsupported element
+  // ---------------------------------------
+
+  beamline other( "OTHER" );
+  other.append( O );
+  other.append( thinDecapole( "DEC", 1.0 ) );
+
+  bool thrown = false;
+  try {
+    BeamlineSnapshot::write( other, again );
+  }
+  catch ( GenericException const& ) {
+    thrown = true;
+  }
+  if ( !thrown ) {
+    cout << "*** ERROR *** A line with an unsupported element was stored." << endl;
+    status = 1;
+  }
+
+  remove( filename );
+  remove( again.c_str() );
+
+  return status;
+}
@@ -0,0 +1,15 @@
+#!/bin/csh
+
+./beamlineSnapshotTest
+set return_status = $status
+if( 0 != $return_status ) then
+  exit $return_status
+  endif
+
+./beamlineSnapshotTest -cells 3
+set return_status = $status
+if( 0 != $return_status ) then
+  exit $return_status
+  endif
+
+exit 0
@@ -0,0 +1,132 @@
+////////////////////////////////////////////////////////////
+//
+// File:          bunchArraysTest.cc
+//
+////////////////////////////////////////////////////////////
+//
+// Propagates a bunch of protons through a short lattice
+// twice: once particle by particle, and once as a
+// structure-of-arrays BunchArrays. The two results must
+// agree to within roundoff.
+//
+// ------------
+// COMMAND LINE
+// ------------
+// bunchArraysTest [options]
+//
+// -------
+// OPTIONS
+// -------
+// Note: NNN represents an integer
+//       XXX             a double
+//
+// -n   NNN   number of particles
+//            : default = 1000
+// -tol XXX   relative tolerance
+//            : default = 1.0e-12
+//
+////////////////////////////////////////////////////////////
+
+#include <iostream>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <complex>
+
+#include <basic_toolkit/VectorD.h>
+#include <beamline/Particle.h>
+#include <beamline/TBunch.h>
+#include <beamline/BunchArrays.h>
+#include <beamline/beamline.h>
+#include <beamline/Drift.h>
+#include <beamline/quadrupole.h>
+#include <beamline/sextupole.h>
+#include <beamline/sbend.h>
+#include <beamline/rbend.h>
+#include <beamline/thinMultipole.h>
+
+using namespace std;
+
+int main( int argc, char** argv )
+{
+  int    n   = 1000;
+  double tol = 1.0e-12;
+
+  for ( int i=1; i<argc; ++i ) {
+    if      ( 0 == strcmp( argv[i], "-n"   ) && i+1 < argc ) { n   = atoi( argv[++i] ); }
+    else if ( 0 == strcmp( argv[i], "-tol" ) && i+1 < argc ) { tol = atof( argv[++i] ); }
+  }
+
+  Proton proton(100.0);
+
+  double const brho = proton.refBrho();
+
+  thinMultipole tm("TM");
+  tm.setPole( 2, std::complex<double>( 0.01*brho, 0.002*brho ) );
+  tm.setPole( 3, std::complex<double>( 0.5*brho,  0.0 ) );
+
+  beamline bml("cell");
+  bml.append( Drift      ("D1",  1.0 ) );
+  bml.append( quadrupole ("QF",  0.5,   0.8*brho ) );
+  bml.append( Drift      ("D2",  0.5 ) );
+  bml.append( sextupole  ("SF",  0.2,   2.0*brho ) );
+  bml.append( sbend      ("B1",  2.0,   0.05*brho/2.0, 0.05 ) );
+  bml.append( tm );
+  bml.append( rbend      ("B2",  2.0,   0.05*brho/2.0, 0.05 ) );
+  bml.append( quadrupole ("QD",  0.5,  -0.8*brho ) );
+  bml.append( Drift      ("D3",  1.0 ) );
+
+  // ----------------------------------------
+  // Populate the bunch with a deterministic,
+  // reasonably large distribution
+  // ----------------------------------------
+
+  ParticleBunch bunch( proton );
+  srand48(12345);
+
+  for ( int j=0; j<n; ++j ) {
+    Proton p( proton );
+    p.x   ( 2.0e-3*( 2.0*drand48() - 1.0 ) );
+    p.y   ( 2.0e-3*( 2.0*drand48() - 1.0 ) );
+    p.npx ( 1.0e-3*( 2.0*drand48() - 1.0 ) );
+    p.npy ( 1.0e-3*( 2.0*drand48() - 1.0 ) );
+    p.ndp ( 1.0e-3*( 2.0*drand48() - 1.0 ) );
+    bunch.append( p );
+  }
+
+  BunchArrays arrays( bunch );
+
+  for ( ParticleBunch::iterator it = bunch.begin(); it != bunch.end(); ++it ) {
+    bml.propagate( *it );
+  }
+
+  bml.propagate( arrays );
+
+  // ---------------
+  // Compare results
+  // ---------------
+
+  int    status  = 0;
+  double maxdiff = 0.0;
+
+  int j = 0;
+  for ( ParticleBunch::iterator it = bunch.begin(); it != bunch.end(); ++it, ++j ) {
+    Vector const& state = it->state();
+    for ( int i=0; i<Particle::PSD; ++i ) {
+      double const diff = std::abs( state[i] - arrays[i][j] );
+      double const scale = std::max( 1.0e-6, std::abs( state[i] ) );
+      maxdiff = std::max( maxdiff, diff/scale );
+      if ( diff > tol*scale ) {
+        if ( status == 0 ) {
+          cout << "*** ERROR *** particle " << j << ", coordinate " << i
+               << ": " << state[i] << " != " << arrays[i][j] << endl;
+        }
+        status = 1;
+      }
+    }
+  }
+
+  cout << "Largest relative difference = " << maxdiff << endl;
+
+  return status;
+}
@@ -0,0 +1,15 @@
+#!/bin/csh
+
+./bunchArraysTest
+set return_status = $status
+if( 0 != $return_status ) then
+  exit $return_status
+  endif
+
+./bunchArraysTest -n 1
+set return_status = $status
+if( 0 != $return_status ) then
+  exit $return_status
+  endif
+
+exit 0
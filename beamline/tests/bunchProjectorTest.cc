@@ -0,0 +1,201 @@
+////////////////////////////////////////////////////////////
+//
+// File:          bunchProjectorTest.cc
+//
+////////////////////////////////////////////////////////////
+//
+// Checks the deposition of a bunch by a BunchProjector, for
+// each shape function and grid dimension.
+//
+//  - the density must integrate to 1;
+//  - with the cic and tsc shapes, the first moments of the
+//    density must be equal to the bunch centroid;
+//  - a bunch deposited by several threads must give the
+//    same density as a serial deposition.
+//
+// ------------
+// COMMAND LINE
+// ------------
+// bunchProjectorTest [options]
+//
+// -------
+// OPTIONS
+// -------
+// Note: NNN represents an integer
+//
+// -n       NNN   number of particles
+//                : default = 10000
+// -threads NNN   number of threads
+//                : default = 4
+//
+////////////////////////////////////////////////////////////
+
+#include <iostream>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <vector>
+
+#include <basic_toolkit/VectorD.h>
+#include <beamline/Particle.h>
+#include <beamline/TBunch.h>
+#include <beamline/BunchProjector.h>
+#include <beamline/beamline.h>
+
+using namespace std;
+
+namespace {
+
+char const* names[] = { "ngp", "cic", "tsc" };
+
+void populate( ParticleBunch& bunch, Proton const& proton, int n )
+{
+  srand48(2468);
+
+  for ( int j=0; j<n; ++j ) {
+    Proton p( proton );
+    p.x   ( 1.0e-3*( drand48() + drand48() - 0.8 ) );
+    p.y   ( 2.0e-3*( drand48() + drand48() - 1.1 ) );
+    p.cdt ( 0.5e-3*( drand48() + drand48() - 1.0 ) );
+    bunch.append( p );
+  }
+}
+
+//
+// Checks the integral and the first moments of the density.
+//
+
+int checkMoments( BunchProjector const& projector, ParticleBunch const& bunch )
+{
+  int const coord[3][3] = { { 2, 0, 0 }, { 0, 1, 0 }, { 0, 1, 2 } };
+  int const dim         = projector.dimension();
+
+  double centroid[3] = { 0.0, 0.0, 0.0 };
+
+  for ( ParticleBunch::const_iterator it = bunch.begin(); it != bunch.end(); ++it ) {
+    for ( int d=0; d<dim; ++d ) { centroid[d] += it->state()[ coord[dim-1][d] ]/bunch.size(); }
+  }
+
+  std::vector<double> const& rho = projector.density();
+
+  double volume = 1.0;
+  for ( int d=0; d<dim; ++d ) { volume *= projector.gridSpacing(d); }
+
+  int const nx = projector.gridSize(0);
+  int const ny = ( dim > 1 ) ? projector.gridSize(1) : 1;
+
+  double integral   = 0.0;
+  double moment[3]  = { 0.0, 0.0, 0.0 };
+
+  for ( int idx=0; idx < int( rho.size() ); ++idx ) {
+
+    int const i[3] = { idx%nx, (idx/nx)%ny, idx/(nx*ny) };
+
+    integral += rho[idx]*volume;
+    for ( int d=0; d<dim; ++d ) {
+      moment[d] += rho[idx]*volume*( projector.gridMin(d) + i[d]*projector.gridSpacing(d) );
+    }
+  }
+
+  int status = 0;
+
+  if ( std::abs( integral - 1.0 ) > 1.0e-12 ) {
+    cout << "*** ERROR *** " << dim << "-D " << names[projector.shape()]
+         << ": the density integrates to " << integral << endl;
+    status = 1;
+  }
+
+  if ( projector.shape() != BunchProjector::ngp ) {
+    for ( int d=0; d<dim; ++d ) {
+      if ( std::abs( moment[d] - centroid[d] ) > 1.0e-10*projector.gridSpacing(d) ) {
+        cout << "*** ERROR *** " << dim << "-D " << names[projector.shape()]
+             << ": the first moment along dimension " << d << " is " << moment[d]
+             << "; the bunch centroid is " << centroid[d] << endl;
+        status = 1;
+      }
+    }
+  }
+
+  return status;
+}
+
+//
+// Largest difference between two densities, relative to the
+// largest density.
+//
+
+double difference( std::vector<double> const& a, std::vector<double> const& b )
+{
+  if ( b.empty() ) return 0.0;
+
+  double d    = 0.0;
+  double rmax = 0.0;
+  for ( int i=0; i < int( a.size() ); ++i ) {
+    d    = std::max( d,    std::abs( a[i] - b[i] ) );
+    rmax = std::max( rmax, std::abs( b[i] ) );
+  }
+  return d/rmax;
+}
+
+} // anonymous namespace
+
+int main( int argc, char** argv )
+{
+  int n        = 10000;
+  int nthreads = 4;
+
+  for ( int i=1; i<argc; ++i ) {
+    if      ( 0 == strcmp( argv[i], "-n"       ) && i+1 < argc ) { n        = atoi( argv[++i] ); }
+    else if ( 0 == strcmp( argv[i], "-threads" ) && i+1 < argc ) { nthreads = atoi( argv[++i] ); }
+  }
+
+  Proton proton( 100.0 );
+
+  ParticleBunch bunch( proton );
+  populate( bunch, proton, n );
+
+  int status = 0;
+
+  for ( int s=0; s<3; ++s ) {
+
+    BunchProjector::Shape const shape = BunchProjector::Shape(s);
+
+    BunchProjector serial[] = { BunchProjector( 64, shape ), BunchProjector( 32, 24, shape ), BunchProjector( 16, 12, 20, shape ) };
+
+    beamline::setNumberOfThreads( 1 );
+
+    for ( int dim=1; dim<=3; ++dim ) {
+      serial[dim-1].deposit( bunch );
+      status |= checkMoments( serial[dim-1], bunch );
+    }
+
+    beamline::setNumberOfThreads( nthreads );
+
+    BunchProjector threaded[] = { BunchProjector( 64, shape ), BunchProjector( 32, 24, shape ), BunchProjector( 16, 12, 20, shape ) };
+
+    for ( int dim=1; dim<=3; ++dim ) {
+
+      threaded[dim-1].deposit( bunch );
+
+      double const d = std::max( difference( threaded[dim-1].density(),              serial[dim-1].density() ),
+                                 difference( threaded[dim-1].dipoleHorLineDensity(), serial[dim-1].dipoleHorLineDensity() ) );
+
+      if ( d > 1.0e-12 ) {
+        cout << "*** ERROR *** " << dim << "-D " << names[s]
+             << ": the threaded deposition differs from the serial one by " << d << " (relative)." << endl;
+        status = 1;
+      }
+    }
+
+    //---------------------------------------------
+    // longitudinal projection, as used for wakes
+    //---------------------------------------------
+
+    BunchProjector projector( 128, shape );
+    projector.project( bunch, 2.0e-3 );
+
+    status |= checkMoments( projector, bunch );
+  }
+
+  return status;
+}
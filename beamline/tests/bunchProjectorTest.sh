@@ -0,0 +1,15 @@
+#!/bin/csh
+
+./bunchProjectorTest
+set return_status = $status
+if( 0 != $return_status ) then
+  exit $return_status
+  endif
+
+./bunchProjectorTest -n 700 -threads 3
+set return_status = $status
+if( 0 != $return_status ) then
+  exit $return_status
+  endif
+
+exit 0
@@ -0,0 +1,315 @@
+////////////////////////////////////////////////////////////
+//
+// File:          compiledLatticeTest.cc
+//
+////////////////////////////////////////////////////////////
+//
+// Checks that tracking through a CompiledLattice gives
+// the same results as beamline::propagate().
+//
+// The ring contains elements that are translated by the
+// plan (drifts, quadrupoles, sextupoles, thin kicks,
+// markers, bends), an element that is not (a kicker), an
+// element with an alignment, and nested lines. Particles
+// and a bunch are tracked over several turns, serially and
+// on several threads; the results must be identical to the
+// last bit. A line of sbends and rbends with face angles and
+// of combined function bends is checked in the same way,
+// over one pass. The plan of the ring must then be
+// invalidated by
+//
+//  - a change of strength;
+//  - the addition of an element to the ring;
+//
+// but not by the modification of another line.
+//
+// ------------
+// COMMAND LINE
+// ------------
+// compiledLatticeTest [options]
+//
+// -------
+// OPTIONS
+// -------
+// Note: NNN represents an integer
+//
+// -turns   NNN   number of turns
+//                : default = 100
+//
+////////////////////////////////////////////////////////////
+
+#include <iostream>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+
+#include <basic_toolkit/VectorD.h>
+#include <beamline/beamline.h>
+#include <beamline/Drift.h>
+#include <beamline/quadrupole.h>
+#include <beamline/sextupole.h>
+#include <beamline/marker.h>
+#include <beamline/sbend.h>
+#include <beamline/rbend.h>
+#include <beamline/CF_sbend.h>
+#include <beamline/CF_rbend.h>
+#include <beamline/kick.h>
+#include <beamline/Alignment.h>
+#include <beamline/Particle.h>
+#include <beamline/TBunch.h>
+#include <beamline/CompiledLattice.h>
+
+using namespace std;
+
+namespace {
+
+void populate( ParticleBunch& bunch, Proton const& proton, int n )
+{
+  srand48(97531);
+
+  for ( int j=0; j<n; ++j ) {
+    Proton p( proton );
+    p.x   ( 1.0e-3*( 2.0*drand48() - 1.0 ) );
+    p.y   ( 1.0e-3*( 2.0*drand48() - 1.0 ) );
+    p.npx ( 1.0e-4*( 2.0*drand48() - 1.0 ) );
+    p.npy ( 1.0e-4*( 2.0*drand48() - 1.0 ) );
+    p.ndp ( 1.0e-3*( 2.0*drand48() - 1.0 ) );
+    bunch.append( p );
+  }
+}
+
+//
+// Number of state components that differ between a and b.
+//
+
+int compare( Particle const& a, Particle const& b )
+{
+  int ndiff = 0;
+  for ( int i=0; i<6; ++i ) {
+    if ( a.state()[i] != b.state()[i] ) { ++ndiff; }
+  }
+  return ndiff;
+}
+
+//
+// Tracks a particle with bml and with the plan, and compares.
+//
+
+int check( char const* step, beamline& bml, CompiledLattice& plan, Proton const& proton, int nturns )
+{
+  int status = 0;
+
+  Proton reference( proton );
+  reference.x  ( 1.0e-3 );
+  reference.npy( 2.0e-5 );
+  reference.ndp( 5.0e-4 );
+
+  Proton compiled( reference );
+
+  for ( int turn=0; turn < nturns; ++turn ) {
+    bml.propagate( reference );
+  }
+  plan.track( compiled, nturns );
+
+  if ( compare( compiled, reference ) != 0 ) {
+    cout << "*** ERROR *** " << step << ": the compiled lattice result differs from beamline::propagate()." << endl;
+    cout << "*** ERROR *** " << compiled.state() << endl;
+    cout << "*** ERROR *** " << reference.state() << endl;
+    status = 1;
+  }
+
+  ParticleBunch bunch_reference( proton, 0 );
+  ParticleBunch bunch_compiled ( proton, 0 );
+
+  populate( bunch_reference, proton, 2000 );
+  populate( bunch_compiled,  proton, 2000 );
+
+  for ( int turn=0; turn < nturns; ++turn ) {
+    bml.propagate( bunch_reference );
+  }
+  plan.track( bunch_compiled, nturns );
+
+  int ndiff = 0;
+  ParticleBunch::const_iterator jt = bunch_reference.begin();
+  for ( ParticleBunch::const_iterator it = bunch_compiled.begin(); it != bunch_compiled.end(); ++it, ++jt ) {
+    ndiff += compare( *it, *jt );
+  }
+
+  if ( ndiff != 0 ) {
+    cout << "*** ERROR *** " << step << ": " << ndiff
+         << " bunch coordinates differ from those obtained with beamline::propagate()." << endl;
+    status = 1;
+  }
+
+  return status;
+}
+
+} // anonymous namespace
+
+int main( int argc, char** argv )
+{
+  int nturns = 100;
+
+  for ( int i=1; i<argc; ++i ) {
+    if ( 0 == strcmp( argv[i], "-turns" ) && i+1 < argc ) { nturns = atoi( argv[++i] ); }
+  }
+
+  Proton proton( 100.0 );
+  double const brho = proton.refBrho();
+
+  // ---------------------------------------
+  // ring
+  // ---------------------------------------
+
+  Drift         O ( "O",  2.0 );
+  Drift         OS( "OS", 0.5 );
+  quadrupole    F ( "F",  0.5,  0.1*brho );
+  quadrupole    D ( "D",  0.5, -0.1*brho );
+  sextupole     SF( "SF", 0.2,  0.5*brho );
+  thinSextupole SD( "SD",      -0.1*brho );
+  thinQuad      TQ( "TQ",       0.001*brho );
+  marker        M ( "M" );
+  sbend         B ( "B",  2.0, 0.05*brho/2.0, 0.05 );
+  sbend         BE( "BE", 2.0, 0.05*brho/2.0, 0.05, 0.01, 0.02 );
+  rbend         R ( "R",  1.0, 0.02*brho/1.0, 0.02 );
+  rbend         RE( "RE", 1.0, 0.02*brho/1.0, 0.02, 0.005, 0.005 );
+  CF_sbend      CS( "CS", 2.0, 0.05*brho/2.0, 0.05 );
+  CF_rbend      CR( "CR", 1.0, 0.02*brho/1.0, 0.02 );
+  hkick         K ( "K",  1.0e-6*brho );
+
+  CS.setQuadrupole( 0.02*brho );
+  CR.setSextupole ( 0.1*brho  );
+
+  beamline cell( "CELL" );
+  cell.append( M  );
+  cell.append( F  );
+  cell.append( OS );
+  cell.append( SF );
+  cell.append( O  );
+  cell.append( B  );
+  cell.append( O  );
+  cell.append( D  );
+  cell.append( OS );
+  cell.append( SD );
+  cell.append( O  );
+  cell.append( K  );
+
+  beamline ring( "RING" );
+  for ( int i=0; i<4; ++i ) {
+    ring.append( cell );
+  }
+
+  // a thin quadrupole with an alignment
+
+  thinQuad TA( TQ );
+  TA.setAlignment( Alignment( 1.0e-4, -2.0e-4, 0.0, 0.0 ) );
+  ring.append( TA );
+  ring.append( O );
+
+  ring.setLineMode( beamline::ring );
+  ring.registerReference( proton );
+
+  int status = 0;
+
+  CompiledLattice plan( ring );
+
+  if ( plan.numberOfGeneric() != 4 ) {
+    cout << "*** ERROR *** The plan has " << plan.numberOfGeneric()
+         << " generic records; expected 4 (the kickers)." << endl;
+    status = 1;
+  }
+
+  status |= check( "initial", ring, plan, proton, nturns );
+
+  beamline::setNumberOfThreads( 4 );
+  status |= check( "four threads", ring, plan, proton, nturns );
+  beamline::setNumberOfThreads( 1 );
+
+  // ---------------------------------------
+  // bends
+  // ---------------------------------------
+
+  beamline bends( "BENDS" );
+  bends.append( BE );
+  bends.append( OS );
+  bends.append( R  );
+  bends.append( OS );
+  bends.append( RE );
+  bends.append( OS );
+  bends.append( CS );
+  bends.append( OS );
+  bends.append( CR );
+  bends.registerReference( proton );
+
+  CompiledLattice bendPlan( bends );
+
+  if ( bendPlan.numberOfGeneric() != 0 ) {
+    cout << "*** ERROR *** The plan of the bends has " << bendPlan.numberOfGeneric()
+         << " generic records; expected none." << endl;
+    status = 1;
+  }
+
+  status |= check( "bends", bends, bendPlan, proton, 1 );
+
+  beamline::setNumberOfThreads( 4 );
+  status |= check( "bends, four threads", bends, bendPlan, proton, 1 );
+  beamline::setNumberOfThreads( 1 );
+
+  // ---------------------------------------
+  // strength change
+  // ---------------------------------------
+
+  for ( beamline::deep_iterator it = ring.deep_begin(); it != ring.deep_end(); ++it ) {
+    if ( 0 == strcmp( (*it)->Name(), "SD" ) ) {
+      (*it)->setStrength( 1.1*(*it)->Strength() );
+      break;
+    }
+  }
+
+  if ( plan.isValid() ) {
+    cout << "*** ERROR *** The plan is valid after a change of strength." << endl;
+    status = 1;
+  }
+
+  status |= check( "strength change", ring, plan, proton, nturns );
+
+  if ( !plan.isValid() ) {
+    cout << "*** ERROR *** The plan was not recompiled." << endl;
+    status = 1;
+  }
+
+  // ---------------------------------------
+  // new element
+  // ---------------------------------------
+
+  int const size = plan.size();
+
+  ring.append( TQ );
+
+  if ( plan.isValid() ) {
+    cout << "*** ERROR *** The plan is valid after the addition of an element." << endl;
+    status = 1;
+  }
+
+  status |= check( "new element", ring, plan, proton, nturns );
+
+  if ( plan.size() != size + 1 ) {
+    cout << "*** ERROR *** The recompiled plan has " << plan.size()
+         << " records; expected " << size + 1 << "." << endl;
+    status = 1;
+  }
+
+  // ---------------------------------------
+  // modification of another line
+  // ---------------------------------------
+
+  beamline other( "OTHER" );
+  other.append( TQ );
+
+  if ( !plan.isValid() ) {
+    cout << "*** ERROR *** The plan is not valid after a modification of another line." << endl;
+    status = 1;
+  }
+
+  return status;
+}
@@ -0,0 +1,15 @@
+#!/bin/csh
+
+./compiledLatticeTest
+set return_status = $status
+if( 0 != $return_status ) then
+  exit $return_status
+  endif
+
+./compiledLatticeTest -turns 3
+set return_status = $status
+if( 0 != $return_status ) then
+  exit $return_status
+  endif
+
+exit 0
@@ -0,0 +1,162 @@
+////////////////////////////////////////////////////////////
+//
+// File:          populateStreamsTest.cc
+//
+////////////////////////////////////////////////////////////
+//
+// Populates bunches of protons from counter-based random
+// streams, first serially and then with several threads.
+// Each distribution is tested in each phase space plane.
+// The threaded bunches must be bit-for-bit identical to the
+// serial ones; the rms size of a Gaussian bunch must agree
+// with its Courant-Snyder parameters.
+//
+// ------------
+// COMMAND LINE
+// ------------
+// populateStreamsTest [options]
+//
+// -------
+// OPTIONS
+// -------
+// Note: NNN represents an integer
+//
+// -n       NNN   number of particles
+//                : default = 20000
+// -threads NNN   number of threads
+//                : default = 4
+//
+////////////////////////////////////////////////////////////
+
+#include <iostream>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+
+#include <basic_toolkit/VectorD.h>
+#include <basic_toolkit/RandomStreams.h>
+#include <beamline/Particle.h>
+#include <beamline/TBunch.h>
+#include <beamline/beamline.h>
+
+using namespace std;
+
+namespace {
+
+double const beta    = 10.0;
+double const alpha   = -1.5;
+double const epsilon = 1.0e-6;
+
+void populate( ParticleBunch& bunch, RandomStreams const& streams )
+{
+  bunch.populateCSGaussian    ( ParticleBunch::cdt_ndp, beta, alpha, epsilon, streams, 3.0 );
+  bunch.populateCSGaussian    ( ParticleBunch::x_npx,   beta, alpha, epsilon, streams, 3.0 );
+  bunch.populateCSGaussianAlt ( ParticleBunch::y_npy,   beta, alpha, epsilon, streams, 3.0 );
+}
+
+void populateBinomial( ParticleBunch& bunch, RandomStreams const& streams )
+{
+  bunch.populateCSWaterBag ( ParticleBunch::x_npx,   beta, alpha, epsilon, streams );
+  bunch.populateCSKV       ( ParticleBunch::y_npy,   beta, alpha, epsilon, streams );
+  bunch.populateCSElliptic ( ParticleBunch::cdt_ndp, beta, alpha, epsilon, streams );
+}
+
+bool identical( ParticleBunch const& a, ParticleBunch const& b )
+{
+  if ( a.size() != b.size() ) return false;
+
+  ParticleBunch::const_iterator jt = b.begin();
+  for ( ParticleBunch::const_iterator it = a.begin(); it != a.end(); ++it, ++jt ) {
+    for ( int i=0; i<Particle::PSD; ++i ) {
+      if ( memcmp( &it->state()[i], &jt->state()[i], sizeof(double) ) != 0 ) return false;
+    }
+  }
+  return true;
+}
+
+} // anonymous namespace
+
+int main( int argc, char** argv )
+{
+  int n        = 20000;
+  int nthreads = 4;
+
+  for ( int i=1; i<argc; ++i ) {
+    if      ( 0 == strcmp( argv[i], "-n"       ) && i+1 < argc ) { n        = atoi( argv[++i] ); }
+    else if ( 0 == strcmp( argv[i], "-threads" ) && i+1 < argc ) { nthreads = atoi( argv[++i] ); }
+  }
+
+  Proton proton(100.0);
+
+  RandomStreams const streams( 2718281828UL );
+
+  int status = 0;
+
+  // ---------------------------------------
+  // Populate identical bunches serially and
+  // with several threads
+  // ---------------------------------------
+
+  ParticleBunch serial  ( proton, n );
+  ParticleBunch threaded( proton, n );
+  ParticleBunch serialBinomial  ( proton, n );
+  ParticleBunch threadedBinomial( proton, n );
+
+  beamline::setNumberOfThreads( 1 );
+
+  populate         ( serial,         streams );
+  populateBinomial ( serialBinomial, streams );
+
+  beamline::setNumberOfThreads( nthreads );
+
+  populate         ( threaded,         streams );
+  populateBinomial ( threadedBinomial, streams );
+
+  beamline::setNumberOfThreads( 1 );
+
+  if ( !identical( serial, threaded ) ) {
+    cout << "*** ERROR *** Gaussian bunches populated with several threads differ from serial ones." << endl;
+    status = 1;
+  }
+
+  if ( !identical( serialBinomial, threadedBinomial ) ) {
+    cout << "*** ERROR *** Binomial bunches populated with several threads differ from serial ones." << endl;
+    status = 1;
+  }
+
+  // ---------------------------------------
+  // A different seed gives a different bunch
+  // ---------------------------------------
+
+  ParticleBunch other( proton, n );
+  populate( other, RandomStreams( 1 ) );
+
+  if ( n > 0 && identical( serial, other ) ) {
+    cout << "*** ERROR *** Bunches populated with different seeds are identical." << endl;
+    status = 1;
+  }
+
+  // ---------------------------------------
+  // rms size of the Gaussian bunch ( the 3 sigma
+  // cutoff reduces it by about 1 % )
+  // ---------------------------------------
+
+  double sum  = 0.0;
+  double sum2 = 0.0;
+
+  for ( ParticleBunch::const_iterator it = serial.begin(); it != serial.end(); ++it ) {
+    double const x = it->state()[Particle::i_x];
+    sum  += x;
+    sum2 += x*x;
+  }
+
+  double const mean  = sum/n;
+  double const sigma = sqrt( sum2/n - mean*mean );
+
+  if ( std::abs( sigma/sqrt( beta*epsilon ) - 1.0 ) > 0.05 ) {
+    cout << "*** ERROR *** rms size " << sigma << " differs from sqrt( beta*epsilon ) = " << sqrt( beta*epsilon ) << endl;
+    status = 1;
+  }
+
+  return status;
+}
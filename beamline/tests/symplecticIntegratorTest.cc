@@ -0,0 +1,302 @@
+////////////////////////////////////////////////////////////
+//
+// File:          symplecticIntegratorTest.cc
+//
+////////////////////////////////////////////////////////////
+//
+// Tests the SymplecticScheme coefficients and the thick
+// quadrupole and sextupole propagators that use them.
+//
+//  - The coefficients of every scheme add up to 1, and the
+//    Forest-Ruth scheme is the composition of three leapfrog
+//    steps with Yoshida's weights.
+//  - For a pendulum, halving the step divides the error of
+//    each scheme by 2^order.
+//  - Integrating a range of states substep by substep gives
+//    the same results as integrating them one by one.
+//  - For a quadrupole and a sextupole, the error decreases
+//    with the order and the number of steps; Particle,
+//    JetParticle (standard part) and BunchArrays agree, the
+//    setting survives a copy of the element, and order 0 is
+//    the original propagator.
+//
+////////////////////////////////////////////////////////////
+
+#include <iostream>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <vector>
+
+#include <basic_toolkit/VectorD.h>
+#include <basic_toolkit/GenericException.h>
+#include <integrator/SymplecticScheme.h>
+#include <beamline/Particle.h>
+#include <beamline/JetParticle.h>
+#include <beamline/BunchArrays.h>
+#include <beamline/quadrupole.h>
+#include <beamline/sextupole.h>
+
+using namespace std;
+
+namespace {
+
+int const orders[] = { 2, 4, 6, 8 };
+
+//
+// pendulum: H = p^2/2 - cos(q)
+//
+
+struct PendulumDrift {
+  void operator()( Vector& z, double l ) const { z[0] += l*z[1]; }
+};
+
+struct PendulumKick {
+  void operator()( Vector& z, double l ) const { z[1] -= l*sin( z[0] ); }
+};
+
+Vector pendulum( SymplecticScheme const& scheme, int nsteps )
+{
+  Vector z(2);
+  z[0] = 1.0;
+  z[1] = 0.5;
+
+  PendulumDrift drift;
+  PendulumKick  kick;
+  scheme.integrate( z, 2.0, nsteps, drift, kick );
+
+  return z;
+}
+
+double maxdiff( Vector const& a, Vector const& b )
+{
+  double d = 0.0;
+  for ( int i=0; i<a.Dim(); ++i ) { d = std::max( d, std::abs( a[i] - b[i] ) ); }
+  return d;
+}
+
+Vector initialState()
+{
+  Vector z(6);
+  z[Particle::i_x]   =  2.0e-3;
+  z[Particle::i_y]   = -1.5e-3;
+  z[Particle::i_cdt] =  0.0;
+  z[Particle::i_npx] =  3.0e-4;
+  z[Particle::i_npy] =  1.0e-4;
+  z[Particle::i_ndp] =  1.0e-3;
+  return z;
+}
+
+Vector track( BmlnElmnt const& elm, Particle const& reference )
+{
+  Particle p( reference );
+  p.state() = initialState();
+  elm.propagate( p );
+  return p.state();
+}
+
+template<typename Element_t>
+int checkElement( Element_t& elm, Particle const& reference, char const* what )
+{
+  int status = 0;
+
+  elm.setIntegrator( 8, 64 );
+  Vector const exact = track( elm, reference );
+
+  double err[4][2];
+
+  for ( int k=0; k<4; ++k ) {
+    for ( int s=0; s<2; ++s ) {
+      elm.setIntegrator( orders[k], 2<<s );
+      err[k][s] = maxdiff( track( elm, reference ), exact );
+      cout << what << ": order " << orders[k] << ", " << ( 2<<s ) << " steps: error " << err[k][s] << endl;
+    }
+  }
+
+  for ( int k=0; k<4; ++k ) {
+    if ( !( err[k][1] < err[k][0] ) && err[k][0] > 1.0e-15 ) {
+      cout << "*** ERROR *** " << what << ", order " << orders[k] << ": more steps did not reduce the error." << endl;
+      status = 1;
+    }
+  }
+
+  for ( int k=1; k<4; ++k ) {
+    if ( !( err[k][0] < err[0][0] ) ) {
+      cout << "*** ERROR *** " << what << ": order " << orders[k] << " is not more accurate than order 2." << endl;
+      status = 1;
+    }
+  }
+
+  //---------------------------------------------------------------------
+  // Particle, JetParticle and BunchArrays
+  //---------------------------------------------------------------------
+
+  elm.setIntegrator( 6, 3 );
+
+  Vector const z = track( elm, reference );
+
+  Particle p( reference );
+  p.state() = initialState();
+  JetParticle jp( p );
+  elm.propagate( jp );
+
+  Vector zj(6);
+  for ( int i=0; i<6; ++i ) { zj[i] = jp.state()[i].standardPart(); }
+
+  BunchArrays b( reference );
+  b.append( p );
+  elm.propagate( b );
+
+  Vector zb(6);
+  for ( int i=0; i<6; ++i ) { zb[i] = b[i][0]; }
+
+  if ( maxdiff( zj, z ) > 1.0e-15 || maxdiff( zb, z ) > 1.0e-15 ) {
+    cout << "*** ERROR *** " << what << ": Particle, JetParticle and BunchArrays differ: "
+         << maxdiff( zj, z ) << " " << maxdiff( zb, z ) << endl;
+    status = 1;
+  }
+
+  //---------------------------------------------------------------------
+  // the setting is copied with the element
+  //---------------------------------------------------------------------
+
+  BmlnElmnt* copy = elm.clone();
+  Vector const zc = track( *copy, reference );
+  delete copy;
+
+  if ( maxdiff( zc, z ) != 0.0 ) {
+    cout << "*** ERROR *** " << what << ": a copy of the element propagates differently." << endl;
+    status = 1;
+  }
+
+  return status;
+}
+
+} // anonymous namespace
+
+int main( int argc, char** argv )
+{
+  int status = 0;
+
+  //---------------------------------------------------------------------
+  // coefficients
+  //---------------------------------------------------------------------
+
+  for ( int k=0; k<4; ++k ) {
+
+    SymplecticScheme const& scheme = SymplecticScheme::forOrder( orders[k] );
+
+    double c = 0.0;
+    double d = 0.0;
+    for ( unsigned int i=0; i<scheme.driftCoefficients().size(); ++i ) { c += scheme.driftCoefficients()[i]; }
+    for ( unsigned int i=0; i<scheme.kickCoefficients().size();  ++i ) { d += scheme.kickCoefficients()[i];  }
+
+    if ( scheme.order() != orders[k] || std::abs( c - 1.0 ) > 1.0e-14 || std::abs( d - 1.0 ) > 1.0e-14 ) {
+      cout << "*** ERROR *** The coefficients of the scheme of order " << orders[k]
+           << " add up to " << c << " and " << d << endl;
+      status = 1;
+    }
+  }
+
+  double const theta = 1.0/( 2.0 - std::pow( 2.0, 1.0/3.0 ) );
+
+  std::vector<double> w( 3, theta );
+  w[1] = 1.0 - 2.0*theta;
+
+  SymplecticScheme const triple = SymplecticScheme::compose( w, 4 );
+
+  for ( int i=0; i<4; ++i ) {
+    if ( std::abs( triple.driftCoefficients()[i] - SymplecticScheme::forestRuth().driftCoefficients()[i] ) > 1.0e-15 ) {
+      cout << "*** ERROR *** The Forest-Ruth scheme is not the triple jump." << endl;
+      status = 1;
+    }
+  }
+
+  try {
+    SymplecticScheme::forOrder( 5 );
+    cout << "*** ERROR *** No exception for a scheme of order 5." << endl;
+    status = 1;
+  }
+  catch ( GenericException const& ) {}
+
+  //---------------------------------------------------------------------
+  // convergence order on the pendulum
+  //---------------------------------------------------------------------
+
+  Vector const exact = pendulum( SymplecticScheme::yoshida8(), 256 );
+
+  int const nsteps[] = { 16, 8, 4, 4 };
+
+  for ( int k=0; k<4; ++k ) {
+
+    SymplecticScheme const& scheme = SymplecticScheme::forOrder( orders[k] );
+
+    int    const n     = nsteps[k];
+    double const e1    = maxdiff( pendulum( scheme,   n ), exact );
+    double const e2    = maxdiff( pendulum( scheme, 2*n ), exact );
+    double const order = log( e1/e2 )/log( 2.0 );
+
+    cout << "pendulum: order " << orders[k] << ", " << n << " -> " << 2*n << " steps: error "
+         << e1 << " -> " << e2 << ", observed order " << order << endl;
+
+    if ( std::abs( order - orders[k] ) > 0.5 ) {
+      cout << "*** ERROR *** The scheme of order " << orders[k] << " converges with order " << order << endl;
+      status = 1;
+    }
+  }
+
+  //---------------------------------------------------------------------
+  // a range of states
+  //---------------------------------------------------------------------
+
+  std::vector<Vector> states( 5, Vector(2) );
+  for ( unsigned int j=0; j<states.size(); ++j ) { states[j][0] = 0.3*j; states[j][1] = 0.1; }
+
+  std::vector<Vector> serial( states );
+
+  PendulumDrift drift;
+  PendulumKick  kick;
+
+  SymplecticScheme::yoshida6().integrate( states.begin(), states.end(), 1.5, 3, drift, kick );
+
+  for ( unsigned int j=0; j<serial.size(); ++j ) {
+    SymplecticScheme::yoshida6().integrate( serial[j], 1.5, 3, drift, kick );
+    if ( maxdiff( states[j], serial[j] ) != 0.0 ) {
+      cout << "*** ERROR *** State " << j << " of the range differs from the one integrated alone." << endl;
+      status = 1;
+    }
+  }
+
+  //---------------------------------------------------------------------
+  // thick elements
+  //---------------------------------------------------------------------
+
+  createStandardEnvironments( 1 );
+
+  Proton proton( 100.0 );
+  double const brho = proton.refBrho();
+
+  quadrupole q  ( "Q",  2.0, 0.8*brho );
+  sextupole  sx ( "SX", 1.0, 60.0*brho );
+
+  Vector const original = track( q, proton );
+  q.setIntegrator( 4, 3 );
+  q.setIntegrator( 0, 4 );
+
+  if ( maxdiff( track( q, proton ), original ) != 0.0 ) {
+    cout << "*** ERROR *** Order 0 does not restore the original quadrupole propagator." << endl;
+    status = 1;
+  }
+
+  status |= checkElement( q,  proton, "quadrupole" );
+  status |= checkElement( sx, proton, "sextupole"  );
+
+  try {
+    q.setIntegrator( 3, 4 );
+    cout << "*** ERROR *** No exception for an integrator of order 3." << endl;
+    status = 1;
+  }
+  catch ( GenericException const& ) {}
+
+  return status;
+}
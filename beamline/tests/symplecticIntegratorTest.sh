@@ -0,0 +1,9 @@
+#!/bin/csh
+
+./symplecticIntegratorTest
+set return_status = $status
+if( 0 != $return_status ) then
+  exit $return_status
+  endif
+
+exit 0
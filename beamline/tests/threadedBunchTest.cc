@@ -0,0 +1,167 @@
+////////////////////////////////////////////////////////////
+//
+// File:          threadedBunchTest.cc
+//
+////////////////////////////////////////////////////////////
+//
+// Tracks a bunch of protons through a few turns of a lattice
+// containing a nested beamline and collective elements
+// (monitors), first serially and then with several threads.
+// Both ParticleBunch and BunchArrays are tested. The
+// threaded results must be bit-for-bit identical to the
+// serial ones.
+//
+// ------------
+// COMMAND LINE
+// ------------
+// threadedBunchTest [options]
+//
+// -------
+// OPTIONS
+// -------
+// Note: NNN represents an integer
+//
+// -n       NNN   number of particles
+//                : default = 5000
+// -threads NNN   number of threads
+//                : default = 4
+// -turns   NNN   number of turns
+//                : default = 3
+//
+////////////////////////////////////////////////////////////
+
+#include <iostream>
+#include <cstdlib>
+#include <cstring>
+
+#include <basic_toolkit/VectorD.h>
+#include <beamline/Particle.h>
+#include <beamline/TBunch.h>
+#include <beamline/BunchArrays.h>
+#include <beamline/beamline.h>
+#include <beamline/Drift.h>
+#include <beamline/quadrupole.h>
+#include <beamline/sextupole.h>
+#include <beamline/sbend.h>
+#include <beamline/Monitor.h>
+
+using namespace std;
+
+namespace {
+
+void populate( ParticleBunch& bunch, Proton const& proton, int n )
+{
+  srand48(54321);
+
+  for ( int j=0; j<n; ++j ) {
+    Proton p( proton );
+    p.x   ( 2.0e-3*( 2.0*drand48() - 1.0 ) );
+    p.y   ( 2.0e-3*( 2.0*drand48() - 1.0 ) );
+    p.npx ( 1.0e-3*( 2.0*drand48() - 1.0 ) );
+    p.npy ( 1.0e-3*( 2.0*drand48() - 1.0 ) );
+    p.ndp ( 1.0e-3*( 2.0*drand48() - 1.0 ) );
+    bunch.append( p );
+  }
+}
+
+bool identical( ParticleBunch const& a, ParticleBunch const& b )
+{
+  if ( a.size() != b.size() ) return false;
+
+  ParticleBunch::const_iterator jt = b.begin();
+  for ( ParticleBunch::const_iterator it = a.begin(); it != a.end(); ++it, ++jt ) {
+    for ( int i=0; i<Particle::PSD; ++i ) {
+      if ( memcmp( &it->state()[i], &jt->state()[i], sizeof(double) ) != 0 ) return false;
+    }
+  }
+  return true;
+}
+
+bool identical( BunchArrays const& a, BunchArrays const& b )
+{
+  if ( a.size() != b.size() ) return false;
+
+  for ( int i=0; i<Particle::PSD; ++i ) {
+    if ( memcmp( a[i], b[i], a.size()*sizeof(double) ) != 0 ) return false;
+  }
+  return true;
+}
+
+} // anonymous namespace
+
+int main( int argc, char** argv )
+{
+  int n        = 5000;
+  int nthreads = 4;
+  int nturns   = 3;
+
+  for ( int i=1; i<argc; ++i ) {
+    if      ( 0 == strcmp( argv[i], "-n"       ) && i+1 < argc ) { n        = atoi( argv[++i] ); }
+    else if ( 0 == strcmp( argv[i], "-threads" ) && i+1 < argc ) { nthreads = atoi( argv[++i] ); }
+    else if ( 0 == strcmp( argv[i], "-turns"   ) && i+1 < argc ) { nturns   = atoi( argv[++i] ); }
+  }
+
+  Proton proton(100.0);
+
+  double const brho = proton.refBrho();
+
+  beamline arc("arc");
+  arc.append( quadrupole ("QF",  0.5,   0.8*brho ) );
+  arc.append( sbend      ("B1",  2.0,   0.05*brho/2.0, 0.05 ) );
+  arc.append( HMonitor   ("HM") );
+  arc.append( sextupole  ("SF",  0.2,   2.0*brho ) );
+
+  beamline ring("ring");
+  ring.append( Drift      ("D1",  1.0 ) );
+  ring.append( arc );
+  ring.append( Drift      ("D2",  0.5 ) );
+  ring.append( Monitor    ("M1") );
+  ring.append( quadrupole ("QD",  0.5,  -0.8*brho ) );
+  ring.append( Drift      ("D3",  1.0 ) );
+
+  int status = 0;
+
+  // ---------------------------------------
+  // Track identical bunches serially and 
+  // with several threads
+  // ---------------------------------------
+
+  ParticleBunch serial  ( proton );
+  ParticleBunch threaded( proton );
+
+  populate( serial,   proton, n );
+  populate( threaded, proton, n );
+
+  BunchArrays serialArrays  ( serial );
+  BunchArrays threadedArrays( threaded );
+
+  beamline::setNumberOfThreads( 1 );
+
+  for ( int turn=0; turn<nturns; ++turn ) {
+    ring.propagate( serial );
+    ring.propagate( serialArrays );
+  }
+
+  beamline::setNumberOfThreads( nthreads );
+
+  for ( int turn=0; turn<nturns; ++turn ) {
+    ring.propagate( threaded );
+    ring.propagate( threadedArrays );
+  }
+
+  // ---------------
+  // Compare results
+  // ---------------
+
+  if ( !identical( serial, threaded ) ) {
+    cout << "*** ERROR *** Threaded ParticleBunch results differ from serial ones." << endl;
+    status = 1;
+  }
+
+  if ( !identical( serialArrays, threadedArrays ) ) {
+    cout << "*** ERROR *** Threaded BunchArrays results differ from serial ones." << endl;
+    status = 1;
+  }
+
+  return status;
+}
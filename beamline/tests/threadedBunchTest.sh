@@ -0,0 +1,21 @@
+#!/bin/csh
+
+./threadedBunchTest
+set return_status = $status
+if( 0 != $return_status ) then
+  exit $return_status
+  endif
+
+./threadedBunchTest -n 1000 -threads 3
+set return_status = $status
+if( 0 != $return_status ) then
+  exit $return_status
+  endif
+
+./threadedBunchTest -n 100
+set return_status = $status
+if( 0 != $return_status ) then
+  exit $return_status
+  endif
+
+exit 0
@@ -0,0 +1,181 @@
+////////////////////////////////////////////////////////////
+//
+// File:          wakeKickTest.cc
+//
+////////////////////////////////////////////////////////////
+//
+// Checks the wakefield kicks applied by a WakeKick element.
+//
+// The kicks are computed with FFTs, using the transforms of
+// the wake functions cached by the element propagator. They
+// are compared with kicks computed from scratch, using a
+// direct (inner product) convolution of the same line
+// densities.
+//
+// The element is applied several times, so that the cached
+// transforms and buffers are reused, with the bunch kicked
+// serially and by several threads.
+//
+// ------------
+// COMMAND LINE
+// ------------
+// wakeKickTest [options]
+//
+// -------
+// OPTIONS
+// -------
+// Note: NNN represents an integer
+//
+// -n       NNN   number of particles
+//                : default = 5000
+// -threads NNN   number of threads
+//                : default = 4
+//
+////////////////////////////////////////////////////////////
+
+#include <iostream>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <vector>
+
+#include <boost/bind.hpp>
+#include <basic_toolkit/VectorD.h>
+#include <basic_toolkit/ConvolutionFunctor.h>
+#include <beamline/Particle.h>
+#include <beamline/TBunch.h>
+#include <beamline/BunchProjector.h>
+#include <beamline/WakeFunctions.h>
+#include <beamline/WakeKick.h>
+#include <beamline/beamline.h>
+
+using namespace std;
+
+namespace {
+
+int    const nsamples = 256;                // the WakeKick element defaults
+double const interval = 12 * 300.0e-6;
+
+void populate( ParticleBunch& bunch, Proton const& proton, int n )
+{
+  srand48(12345);
+
+  for ( int j=0; j<n; ++j ) {
+    Proton p( proton );
+    p.x   ( 1.0e-3*( 2.0*drand48() - 1.0 ) );
+    p.y   ( 1.0e-3*( 2.0*drand48() - 1.0 ) );
+    p.cdt ( 0.5e-3*( 2.0*drand48() - 1.0 ) );
+    bunch.append( p );
+  }
+}
+
+//
+// The kicks of the original WakeKick propagator, computed by
+// direct convolution.
+//
+
+void kick( ParticleBunch& bunch )
+{
+  double const binsize = interval/(nsamples-1);
+
+  BunchProjector projector( bunch, interval, nsamples );
+
+  ConvolutionFunctor<double, ConvolutionInnerProductPolicy>
+     lwake( nsamples, boost::bind<double>( ShortRangeLWakeFunction(), _1, binsize, 0.5*interval ), false );
+  ConvolutionFunctor<double, ConvolutionInnerProductPolicy>
+     twake( nsamples, boost::bind<double>( ShortRangeTWakeFunction(), _1, binsize, 0.5*interval ), false );
+
+  std::vector<double> const dpz = lwake( projector.monopoleLineDensity()  );
+  std::vector<double> const dpx = twake( projector.dipoleHorLineDensity() );
+  std::vector<double> const dpy = twake( projector.dipoleVerLineDensity() );
+
+  double const p0    = bunch.begin()->refMomentum();
+  double const coeff = ( 1.0e-9 * bunch.Intensity() * bunch.begin()->charge() * 1.0e12 / p0 ) * binsize;
+
+  for ( ParticleBunch::iterator it = bunch.begin(); it != bunch.end(); ++it ) {
+
+    Vector& state = it->state();
+
+    int const ibin = int( ( state[2] - projector.cdt_min() )/binsize );
+
+    state[3] += coeff*dpx[ibin];
+    state[4] += coeff*dpy[ibin];
+
+    double const npz = it->npz() + coeff*dpz[ibin];
+    state[5] = sqrt( npz*npz + state[3]*state[3] + state[4]*state[4] ) - 1.0;
+  }
+}
+
+//
+// Largest difference between the momenta of a and b, relative
+// to the largest momentum change in b.
+//
+
+double difference( ParticleBunch const& a, ParticleBunch const& b, ParticleBunch const& initial )
+{
+  double d    = 0.0;
+  double kmax = 0.0;
+
+  ParticleBunch::const_iterator jt = b.begin();
+  ParticleBunch::const_iterator kt = initial.begin();
+
+  for ( ParticleBunch::const_iterator it = a.begin(); it != a.end(); ++it, ++jt, ++kt ) {
+    for ( int i=3; i<6; ++i ) {
+      d    = std::max( d,    std::abs( it->state()[i] - jt->state()[i] ) );
+      kmax = std::max( kmax, std::abs( jt->state()[i] - kt->state()[i] ) );
+    }
+  }
+  return ( kmax > 0.0 ) ? d/kmax : 1.0;
+}
+
+} // anonymous namespace
+
+int main( int argc, char** argv )
+{
+  int n        = 5000;
+  int nthreads = 4;
+
+  for ( int i=1; i<argc; ++i ) {
+    if      ( 0 == strcmp( argv[i], "-n"       ) && i+1 < argc ) { n        = atoi( argv[++i] ); }
+    else if ( 0 == strcmp( argv[i], "-threads" ) && i+1 < argc ) { nthreads = atoi( argv[++i] ); }
+  }
+
+  Proton proton( 100.0 );
+
+  WakeKick wake( "WAKE" );
+
+  int status = 0;
+
+  for ( int pass=0; pass < 3; ++pass ) {
+
+    beamline::setNumberOfThreads( ( pass == 0 ) ? 1 : nthreads );
+
+    ParticleBunch initial  ( proton, 0, 2.0e10 );
+    ParticleBunch reference( proton, 0, 2.0e10 );
+    ParticleBunch bunch    ( proton, 0, 2.0e10 );
+
+    populate( initial,   proton, n );
+    populate( reference, proton, n );
+    populate( bunch,     proton, n );
+
+    kick( reference );
+    wake.propagate( bunch );
+
+    //--------------------------------------------------
+    // the kicked bunches have been sorted by the 
+    // projection; the initial one is sorted likewise.
+    //--------------------------------------------------
+
+    BunchProjector( initial, interval, nsamples );
+
+    double const d = difference( bunch, reference, initial );
+
+    if ( d > 1.0e-9 ) {
+      cout << "*** ERROR *** Pass " << pass << ": the wake kicks differ from the direct convolution ones"
+           << " by " << d << " (relative)." << endl;
+      status = 1;
+    }
+  }
+
+  return status;
+}
@@ -0,0 +1,118 @@
+/*************************************************************************
+**************************************************************************
+**************************************************************************
+******
+******  BEAMLINE FACTORY:  Interprets MAD input files and
+******             creates instances of class beamline.
+******
+******  File:      LatticeCache.h
+******
+******  Copyright Fermi Research Alliance / Fermilab
+******            All Rights Reserved
+*****
+******  Usage, modification, and redistribution are subject to terms
+******  of the License supplied with this software.
+******
+******  Software and documentation created under
+******  U.S. Department of Energy Contract No. DE-AC02-07CH11359
+******  The U.S. Government retains a world-wide non-exclusive,
+******  royalty-free license to publish or reproduce documentation
+******  and software for U.S. Government purposes. This software
+******  is protected under the U.S. and Foreign Copyright Laws.
+******
+**************************************************************************
+**************************************************************************
+*************************************************************************/
+
+//------------------------------------------------------------------------------------------
+//
+// LatticeCache: parse-once cache for the beamline factories.
+//
+// LatticeCache::create_beamline<Factory>( fname, bmlname, brho ) returns the line that
+//
+//    Factory( fname ).create_beamline( bmlname, brho )
+//
+// would return, where Factory is MAD8Factory, XSIFFactory or any other bmlfactory.
+// The deck is parsed only the first time. The key is a hash of
+//
+//  - the factory type, the line name and brho;
+//  - the contents of the deck and of every file it includes with CALL.
+//
+// Editing any file of the deck therefore invalidates its entries.
+//
+// There are two stores:
+//
+//  - memory:  a private copy of the lines most recently created or looked up in this
+//             process. A hit returns a deep clone of that copy. The number of lines
+//             kept is bounded (setCapacity(), default 8); the least recently used
+//             line is dropped first. A capacity of 0 disables the memory store.
+//  - disk:    a BeamlineSnapshot per key in a user defined directory. A hit maps
+//             the snapshot and instantiates it, so other processes (chef sessions,
+//             python scripts, batch jobs) skip the parser as well. The directory
+//             is taken from the environment variable CHEF_LATTICE_CACHE, or set
+//             with setDirectory(). If it is empty, the disk store is not used.
+//
+// A line with elements that BeamlineSnapshot cannot store is kept in memory only.
+// A damaged snapshot, or one written with another format version, is replaced.
+//
+// The functions may be called from several threads. The factories run without a lock:
+// each MAD8Factory and XSIFFactory owns its parser state.
+//
+//------------------------------------------------------------------------------------------
+
+#ifndef LATTICECACHE_H
+#define LATTICECACHE_H
+
+#include <string>
+#include <typeinfo>
+#include <boost/cstdint.hpp>
+#include <bmlfactory/bmlfactory.h>
+
+class LatticeCache {
+
+ public:
+
+  template <typename Factory>
+  static BmlPtr create_beamline( std::string const& fname, std::string const& bmlname, double brho );
+
+  static void         setDirectory( std::string const& dir );   // "" disables the disk store
+  static std::string  directory();
+
+  static void         setCapacity( int n );                     // max no of lines in memory; 0 disables the memory store
+  static int          capacity();
+  static int          size();                                   // no of lines in memory
+
+  static void         clear();                                  // empties the memory store
+  static int          hits();                                   // since the last clear()
+  static int          misses();
+
+  static boost::uint64_t  key( std::string const& factory, std::string const& fname,
+                               std::string const& bmlname, double brho );
+
+ private:
+
+  static BmlPtr  lookup( boost::uint64_t key );
+  static void    store ( boost::uint64_t key, BmlPtr const& bml );
+};
+
+//------------------------------------------------------------------------------------------
+// template member
+//------------------------------------------------------------------------------------------
+
+template <typename Factory>
+BmlPtr LatticeCache::create_beamline( std::string const& fname, std::string const& bmlname, double brho )
+{
+  boost::uint64_t const k = key( typeid(Factory).name(), fname, bmlname, brho );
+
+  BmlPtr bml = lookup( k );
+  if ( bml ) return bml;
+
+  Factory factory( fname );
+  bml = factory.create_beamline( bmlname, brho );
+
+  if ( bml ) store( k, bml );
+
+  return bml;
+}
+
+#endif // LATTICECACHE_H
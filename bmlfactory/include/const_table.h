@@ -47,8 +47,6 @@ enum constant_kind {
   CONSTANT_STRING  = 1
 };
 
-extern enum constant_kind current_constant;
-
 #define CONST_OK             0
 #define CONST_INIT_ERR       1
 
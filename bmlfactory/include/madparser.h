@@ -51,6 +51,7 @@
 #include <glib.h>
 #include <bmlfactory/beam_element.h>
 #include <bmlfactory/beam_line.h>
+#include <bmlfactory/const_table.h>
 #include <bmlfactory/madparser_types.h>
 
 #ifdef __cplusplus
@@ -119,6 +120,12 @@ void          madparser_comment_mode_inc( madparser* mp );
 void          madparser_comment_mode_dec( madparser* mp );
 int           madparser_comment_mode( const madparser* mp );
 
+GString*      madparser_comments( madparser* mp );
+void          madparser_set_comments( madparser* mp, GString* comments );
+
+enum constant_kind madparser_current_constant( const madparser* mp );
+void          madparser_set_current_constant( madparser* mp, enum constant_kind kind );
+
 beam_element* madparser_current_bel( madparser* mp );
 char*         madparser_current_bel_type( madparser* mp );
 void          madparser_set_bel_type(madparser* mp, const char* );
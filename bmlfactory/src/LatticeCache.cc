@@ -0,0 +1,441 @@
+/*************************************************************************
+**************************************************************************
+**************************************************************************
+******
+******  BEAMLINE FACTORY:  Interprets MAD input files and
+******             creates instances of class beamline.
+******
+******  File:      LatticeCache.cc
+******
+******  Copyright Fermi Research Alliance / Fermilab
+******            All Rights Reserved
+*****
+******  Usage, modification, and redistribution are subject to terms
+******  of the License supplied with this software.
+******
+******  Software and documentation created under
+******  U.S. Department of Energy Contract No. DE-AC02-07CH11359
+******  The U.S. Government retains a world-wide non-exclusive,
+******  royalty-free license to publish or reproduce documentation
+******  and software for U.S. Government purposes. This software
+******  is protected under the U.S. and Foreign Copyright Laws.
+******
+**************************************************************************
+**************************************************************************
+*************************************************************************/
+
+#if HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <bmlfactory/LatticeCache.h>
+#include <basic_toolkit/GenericException.h>
+#include <basic_toolkit/iosetup.h>
+#include <beamline/beamline.h>
+#include <beamline/BeamlineSnapshot.h>
+#include <boost/thread/mutex.hpp>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <cstdlib>
+#include <cstdio>
+#include <cctype>
+#include <algorithm>
+#include <list>
+#include <map>
+#include <vector>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using FNAL::pcerr;
+
+namespace {
+
+ boost::mutex  state_mutex;     // stores, counters, directory
+
+//------------------------------------------------------------------------------------------
+// memory store: the keys are listed from the most to the least recently used
+//------------------------------------------------------------------------------------------
+
+ typedef std::list<boost::uint64_t> Recency;
+
+ struct Entry {
+   BmlPtr             bml;
+   Recency::iterator  pos;
+ };
+
+ typedef std::map<boost::uint64_t, Entry> Memory;
+
+ Memory   memory;
+ Recency  recency;
+ int      capacity_ = 8;
+
+ int  nhits   = 0;
+ int  nmisses = 0;
+ int  nwrites = 0;    // numbers the temporary snapshot files of this process
+
+ bool         directory_set = false;
+ std::string  directory_;
+
+ int const max_call_depth = 32;  // guards against a deck that includes itself
+
+//------------------------------------------------------------------------------------------
+// 64-bit FNV-1a
+//------------------------------------------------------------------------------------------
+
+ boost::uint64_t const fnv_offset = 14695981039346656037ULL;
+ boost::uint64_t const fnv_prime  = 1099511628211ULL;
+
+ void hash( boost::uint64_t& h, void const* data, std::size_t n )
+ {
+   unsigned char const* p = static_cast<unsigned char const*>( data );
+   for ( std::size_t i=0; i<n; ++i ) {
+     h ^= p[i];
+     h *= fnv_prime;
+   }
+ }
+
+ void hash( boost::uint64_t& h, std::string const& s )
+ {
+   hash( h, s.data(), s.size() );
+   char const separator = '\0';
+   hash( h, &separator, 1 );
+ }
+
+//------------------------------------------------------------------------------------------
+// the names of the files included by the deck text with CALL, FILENAME = "name"
+// (MAD8) or CALL, FILENAME = name (XSIF). Both parsers open the file relative to the
+// working directory. A match within a comment at most adds a file to the key.
+//------------------------------------------------------------------------------------------
+
+ bool matches( std::string const& text, std::size_t pos, char const* word )
+ {
+   for ( std::size_t i=0; word[i]; ++i, ++pos ) {
+     if ( pos >= text.size() || toupper( text[pos] ) != word[i] ) return false;
+   }
+   return true;
+ }
+
+ void skipBlanks( std::string const& text, std::size_t& pos )
+ {
+   while ( pos < text.size() && isspace( text[pos] ) ) ++pos;
+ }
+
+ std::vector<std::string> includedFiles( std::string const& text )
+ {
+   std::vector<std::string> files;
+
+   for ( std::size_t pos = 0; pos < text.size(); ++pos ) {
+
+     if ( !matches( text, pos, "CALL" ) ) continue;
+     if ( pos > 0 && ( isalnum( text[pos-1] ) || text[pos-1] == '_' ) ) continue;
+
+     std::size_t p = pos + 4;
+     skipBlanks( text, p );
+     if ( p >= text.size() || text[p] != ',' ) continue;
+     ++p;
+     skipBlanks( text, p );
+
+     if ( matches( text, p, "FILENAME" ) ) {
+       p += 8;
+       skipBlanks( text, p );
+       if ( p >= text.size() || text[p] != '=' ) continue;
+       ++p;
+       skipBlanks( text, p );
+     }
+
+     if ( p >= text.size() ) break;
+
+     std::string name;
+
+     if ( text[p] == '"' || text[p] == '\'' ) {
+       std::size_t const end = text.find( text[p], p+1 );
+       if ( end == std::string::npos ) break;
+       name = text.substr( p+1, end-p-1 );
+     }
+     else {
+       std::size_t end = p;
+       while ( end < text.size() && !isspace( text[end] ) && text[end] != ',' && text[end] != ';' ) ++end;
+       name = text.substr( p, end-p );
+     }
+
+     if ( !name.empty() ) files.push_back( name );
+   }
+
+   return files;
+ }
+
+//------------------------------------------------------------------------------------------
+// hashes the name and the contents of fname, then those of the files it includes
+//------------------------------------------------------------------------------------------
+
+ void hashDeck( boost::uint64_t& h, std::string const& fname, int depth )
+ {
+   hash( h, fname );
+
+   std::ifstream is( fname.c_str(), std::ios::binary );
+
+   if ( !is ) {
+     hash( h, std::string( "<missing>" ) );
+     return;
+   }
+
+   std::ostringstream contents;
+   contents << is.rdbuf();
+   std::string const text = contents.str();
+
+   hash( h, text );
+
+   if ( depth >= max_call_depth ) return;
+
+   std::vector<std::string> const files = includedFiles( text );
+
+   for ( std::vector<std::string>::const_iterator it = files.begin(); it != files.end(); ++it ) {
+     hashDeck( h, *it, depth+1 );
+   }
+ }
+
+//------------------------------------------------------------------------------------------
+
+ std::string currentDirectory()
+ {
+   if ( !directory_set ) {
+     char const* const dir = getenv( "CHEF_LATTICE_CACHE" );
+     directory_     = dir ? dir : "";
+     directory_set  = true;
+   }
+   return directory_;
+ }
+
+ void evict( int n )
+ {
+   while ( int( memory.size() ) > n ) {
+     memory.erase( recency.back() );
+     recency.pop_back();
+   }
+ }
+
+ void remember( boost::uint64_t key, BmlPtr const& copy )   // copy: a private copy, not shared with the caller
+ {
+   if ( capacity_ <= 0 ) return;
+
+   Memory::iterator it = memory.find( key );
+
+   if ( it != memory.end() ) {
+     it->second.bml = copy;
+     recency.splice( recency.begin(), recency, it->second.pos );
+     return;
+   }
+
+   recency.push_front( key );
+   Entry const e = { copy, recency.begin() };
+   memory[key] = e;
+
+   evict( capacity_ );
+ }
+
+ std::string snapshotFile( std::string const& dir, boost::uint64_t key )
+ {
+   std::ostringstream name;
+   name << dir << "/" << std::hex << std::setw(16) << std::setfill('0') << key << ".bml";
+   return name.str();
+ }
+
+} // namespace
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+void LatticeCache::setDirectory( std::string const& dir )
+{
+  boost::mutex::scoped_lock lock( state_mutex );
+
+  directory_     = dir;
+  directory_set  = true;
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+std::string LatticeCache::directory()
+{
+  boost::mutex::scoped_lock lock( state_mutex );
+
+  return currentDirectory();
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+void LatticeCache::setCapacity( int n )
+{
+  boost::mutex::scoped_lock lock( state_mutex );
+
+  capacity_ = std::max( n, 0 );
+  evict( capacity_ );
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+int LatticeCache::capacity()
+{
+  boost::mutex::scoped_lock lock( state_mutex );
+  return capacity_;
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+int LatticeCache::size()
+{
+  boost::mutex::scoped_lock lock( state_mutex );
+  return memory.size();
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+void LatticeCache::clear()
+{
+  boost::mutex::scoped_lock lock( state_mutex );
+
+  memory.clear();
+  recency.clear();
+  nhits   = 0;
+  nmisses = 0;
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+int LatticeCache::hits()
+{
+  boost::mutex::scoped_lock lock( state_mutex );
+  return nhits;
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+int LatticeCache::misses()
+{
+  boost::mutex::scoped_lock lock( state_mutex );
+  return nmisses;
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+boost::uint64_t LatticeCache::key( std::string const& factory, std::string const& fname,
+                                   std::string const& bmlname, double brho )
+{
+  //----------------------------------------------------------------------------------
+  // The snapshot format version is part of the key, so that snapshots written with
+  // another version are never looked up.
+  //----------------------------------------------------------------------------------
+
+  boost::uint64_t h = fnv_offset;
+
+  hash( h, &BeamlineSnapshot::format_version, sizeof(BeamlineSnapshot::format_version) );
+  hash( h, factory );
+  hash( h, bmlname );
+  hash( h, &brho, sizeof(brho) );
+
+  hashDeck( h, fname, 0 );
+
+  return h;
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+BmlPtr LatticeCache::lookup( boost::uint64_t key )
+{
+  boost::mutex::scoped_lock lock( state_mutex );
+
+  Memory::iterator it = memory.find( key );
+
+  if ( it != memory.end() ) {
+    ++nhits;
+    recency.splice( recency.begin(), recency, it->second.pos );
+    return BmlPtr( it->second.bml->clone() );
+  }
+
+  std::string const dir = currentDirectory();
+
+  if ( !dir.empty() ) {
+
+    std::string const fname = snapshotFile( dir, key );
+
+    if ( 0 == access( fname.c_str(), R_OK ) ) {
+      try {
+        BeamlineSnapshot snapshot( fname );
+        BmlPtr bml = snapshot.instantiate();
+        remember( key, BmlPtr( bml->clone() ) );
+        ++nhits;
+        return bml;
+      }
+      catch ( GenericException const& ) {
+        (*pcerr) << "*** WARNING *** LatticeCache: the snapshot " << fname
+                 << " cannot be used and will be replaced." << std::endl;
+      }
+    }
+  }
+
+  ++nmisses;
+  return BmlPtr();
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+void LatticeCache::store( boost::uint64_t key, BmlPtr const& bml )
+{
+  //----------------------------------------------------------------------------------
+  // The copy kept in memory and the snapshot are made without the lock; it is held
+  // only to publish the copy and to read the directory.
+  //----------------------------------------------------------------------------------
+
+  BmlPtr const copy( bml->clone() );
+
+  std::string dir;
+  int         serial = 0;
+  {
+    boost::mutex::scoped_lock lock( state_mutex );
+    remember( key, copy );
+    dir    = currentDirectory();
+    serial = ++nwrites;
+  }
+
+  if ( dir.empty() ) return;
+
+  //----------------------------------------------------------------------------------
+  // The snapshot is written under a temporary name, then renamed, so that another
+  // process never maps a partially written file. The name is unique to this call:
+  // other threads may be writing the same snapshot.
+  //----------------------------------------------------------------------------------
+
+  mkdir( dir.c_str(), 0755 );   // fails harmlessly if the directory exists
+
+  std::string const fname = snapshotFile( dir, key );
+
+  std::ostringstream tmpname;
+  tmpname << fname << "." << getpid() << "." << serial;
+
+  try {
+    BeamlineSnapshot::write( *bml, tmpname.str() );
+  }
+  catch ( GenericException const& ) {
+    remove( tmpname.str().c_str() );   // e.g. an element type the format does not support
+    return;
+  }
+
+  if ( 0 != rename( tmpname.str().c_str(), fname.c_str() ) ) {
+    remove( tmpname.str().c_str() );
+  }
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
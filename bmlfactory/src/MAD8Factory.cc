@@ -103,12 +103,32 @@ using namespace std;
 #include <bmlfactory/bel_inst_fns.h>
 
 #include <boost/algorithm/string.hpp>
+#include <boost/thread/once.hpp>
 
 using namespace PhysicsConstants;
 using namespace std;
 using FNAL::pcout;
 using FNAL::pcerr;
 
+namespace {
+
+//----------------------------------------------------------------------------------------
+// Each MAD8Factory owns its parser state (madparser, tables and allocators), so that
+// several factories may parse in parallel threads. Before glib 2.32, the glib data
+// structures used by the parser are thread-safe only once g_thread_init() was called.
+//----------------------------------------------------------------------------------------
+
+boost::once_flag glib_threads_flag = BOOST_ONCE_INIT;
+
+void initGlibThreads()
+{
+#if !GLIB_CHECK_VERSION(2,32,0)
+  if ( !g_thread_supported() ) { g_thread_init( 0 ); }
+#endif
+}
+
+} // namespace
+
 
 //||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
 //||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
@@ -186,6 +206,8 @@ MAD8Factory::MAD8Factory( std::string fname, const char* stringbuffer)
 void 
 MAD8Factory::bmlfactory_init( const char* stringbuffer) 
 {
+  boost::call_once( &initGlibThreads, glib_threads_flag );
+
   mp_      = NULL;
   bel_arr_ = NULL;
   bml_arr_ = NULL;
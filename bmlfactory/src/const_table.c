@@ -48,7 +48,6 @@
 #include <bmlfactory/troika.h>
 #include <bmlfactory/const_table.h>
 
-enum constant_kind current_constant = CONSTANT_UNKNOWN;
 
    /*
      Takes a string and returns its hash table index
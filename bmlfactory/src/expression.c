@@ -64,7 +64,7 @@ extern void bmlfactory_parse_error(int inmemory, const char* input_filename, int
 /* Including mp here is a temporary fix. mp is required for error reporting */
 /* the entire error reporting mechanism should be overhauled. -jfo          */ 
 
-static char error_msg[132];
+#define ERROR_MSG_LENGTH 256   /* error messages are built on the stack: the parser is reentrant */
 
 void
 expression_init( void ) {
@@ -317,6 +317,7 @@ expr_evaluate(madparser* mp,  GNode*      expr,
                GHashTable* bel_table ) {
   double val1, val2;
   GNode* node;
+  char   error_msg[ERROR_MSG_LENGTH];
   
   expr_struct* data = NULL;
 
@@ -453,6 +454,7 @@ expr_is_string( madparser*  mp,
                 GNode*      expr,
                 GHashTable* const_table,
                 GHashTable* var_table ) {
+  char error_msg[ERROR_MSG_LENGTH];
   expr_struct* data;
   variable* assigned_var = (variable*)var_table_lookup( ((expr_struct*)(expr->data))->svalue_, var_table );
   if ( assigned_var == NULL ) {
@@ -410,7 +410,7 @@ const_definition		: identifier ':' MAD_CONSTANT '=' identifier {
                                       constant* ptr;
                                       PRIVATE_ALLOCATE( ptr, madparser_const_alloc(mp) );
                                       
-                                      if ( current_constant == CONSTANT_DOUBLE ) {
+                                      if ( madparser_current_constant( mp ) == CONSTANT_DOUBLE ) {
                                         const_init_d( ptr, $<sval>1, (GNode*)$<ptr>5, madparser_linenum(mp), madparser_current_filename(mp), madparser_local_linenum(mp) );
                                       } else {
                                         const_init_c( ptr, $<sval>1, $<sval>5, madparser_linenum(mp), madparser_current_filename(mp), madparser_local_linenum(mp), madparser_expr_alloc(mp) );
@@ -1926,7 +1926,7 @@ const_expr_unit			: MAD_NUMERIC_LITERAL {
                                     free( $<sval>1 );
                                   }
                                   
-                                  current_constant = CONSTANT_DOUBLE;
+                                  madparser_set_current_constant( mp, CONSTANT_DOUBLE );
                                   $<ptr>$ = g_node_new( data );
                                 }
 				;
@@ -197,6 +197,8 @@ struct madparser_ {
 
     int             comment_at_eof_;
     int             comment_mode_;
+    GString*        comments_;            /* multi-line comment being read by the lexer */
+    enum constant_kind current_constant_; /* kind of the last literal read by the lexer */
     int             beam_kinematics_valid_;
 
     beam_element*   current_bel_;
@@ -325,6 +327,8 @@ madparser_init( const char* filename_in,
           */
       mp->comment_at_eof_        = 0;
       mp->comment_mode_          = 0;
+      mp->comments_              = NULL;
+      mp->current_constant_      = CONSTANT_UNKNOWN;
       mp->beam_kinematics_valid_ = 0;
          /*
            current beam element initialization          
@@ -670,6 +674,10 @@ madparser_delete( madparser* mp ) {
 
   reset_input_buffer( mp );
 
+  if ( mp->comments_ != NULL ) {
+    g_string_free( mp->comments_, TRUE );
+  }
+
   comment_arr_delete( mp->comment_arr_ );
   bml_table_delete( mp->bml_table_, mp->bml_alloc_ );
   bel_table_delete( mp->bel_table_, mp->bel_alloc_ , mp->expr_alloc_);
@@ -785,6 +793,30 @@ madparser_comment_mode( const madparser* mp ) {
   return (mp->comment_mode_);
 }
 
+GString*
+madparser_comments( madparser* mp ) {
+  assert( mp != NULL );
+  return mp->comments_;
+}
+
+void
+madparser_set_comments( madparser* mp, GString* comments ) {
+  assert( mp != NULL );
+  mp->comments_ = comments;
+}
+
+enum constant_kind
+madparser_current_constant( const madparser* mp ) {
+  assert( mp != NULL );
+  return mp->current_constant_;
+}
+
+void
+madparser_set_current_constant( madparser* mp, enum constant_kind kind ) {
+  assert( mp != NULL );
+  mp->current_constant_ = kind;
+}
+
 beam_element*
 madparser_current_bel( madparser* mp ) {
   assert( mp != NULL );
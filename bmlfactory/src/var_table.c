@@ -309,22 +309,16 @@ var_table_to_array( variable***  var_arr,
 
 static void
 var_check_circ( GNode*          expr,
-                const variable* vartocomp,
+                const variable* var_to_compare,
                 var_link**      res,
                 GHashTable*     var_table,
                 GHashTable*     bel_table ) {
 
-  static const variable* var_to_compare;
-
   GNode*       node = NULL;
   expr_struct* data = NULL;
 
   assert( expr != NULL );
-
-  if ( vartocomp != NULL ) {
-    var_to_compare = vartocomp;
-    assert( *res == NULL );
-  }
+  assert( var_to_compare != NULL );
 
   if ( *res == NULL ) {
 
@@ -365,70 +359,70 @@ var_check_circ( GNode*          expr,
             send_to_stderr_stream(stderr, "error ! beam element %s never defined\n", data->svalue_ ); 
             bmlfactory_exit();
           } else {
-            var_check_circ( bel->length_, NULL, res, var_table, bel_table );
+            var_check_circ( bel->length_, var_to_compare, res, var_table, bel_table );
           }
         }
         break;
       case BRACKETS_EXPR:
-        var_check_circ( g_node_first_child( expr ), NULL, res, var_table, bel_table );
+        var_check_circ( g_node_first_child( expr ), var_to_compare, res, var_table, bel_table );
         break;
       case UN_PLUS_EXPR :
-        var_check_circ( g_node_first_child( expr ), NULL, res, var_table, bel_table );
+        var_check_circ( g_node_first_child( expr ), var_to_compare, res, var_table, bel_table );
         break;
       case UN_MINUS_EXPR :
-        var_check_circ( g_node_first_child( expr ), NULL, res, var_table, bel_table );
+        var_check_circ( g_node_first_child( expr ), var_to_compare, res, var_table, bel_table );
         break;
       case ADD_OP_EXPR :
         node = g_node_first_child( expr );
-        ( var_check_circ( node, NULL, res, var_table, bel_table ), var_check_circ( node->next, NULL, res, var_table, bel_table ) );
+        ( var_check_circ( node, var_to_compare, res, var_table, bel_table ), var_check_circ( node->next, var_to_compare, res, var_table, bel_table ) );
         break;
       case SUB_OP_EXPR :
         node = g_node_first_child( expr );
-        ( var_check_circ( node, NULL, res, var_table, bel_table ), var_check_circ( node->next, NULL, res, var_table, bel_table ) );
+        ( var_check_circ( node, var_to_compare, res, var_table, bel_table ), var_check_circ( node->next, var_to_compare, res, var_table, bel_table ) );
         break;
       case MUL_OP_EXPR :
         node = g_node_first_child( expr );
-        ( var_check_circ( node, NULL, res, var_table, bel_table ), var_check_circ( node->next, NULL, res, var_table, bel_table ) );
+        ( var_check_circ( node, var_to_compare, res, var_table, bel_table ), var_check_circ( node->next, var_to_compare, res, var_table, bel_table ) );
         break;
       case DIV_OP_EXPR :
         node = g_node_first_child( expr );
-        ( var_check_circ( node, NULL, res, var_table, bel_table ), var_check_circ( node->next, NULL, res, var_table, bel_table ) );
+        ( var_check_circ( node, var_to_compare, res, var_table, bel_table ), var_check_circ( node->next, var_to_compare, res, var_table, bel_table ) );
         break;
       case POW_OP_EXPR :
         node = g_node_first_child( expr );
-        ( var_check_circ( node, NULL, res, var_table, bel_table ), var_check_circ( node->next, NULL, res, var_table, bel_table ) );
+        ( var_check_circ( node, var_to_compare, res, var_table, bel_table ), var_check_circ( node->next, var_to_compare, res, var_table, bel_table ) );
         break;
       case SQRT_EXPR :
-        var_check_circ( g_node_first_child( expr ), NULL, res, var_table, bel_table );
+        var_check_circ( g_node_first_child( expr ), var_to_compare, res, var_table, bel_table );
         break;
       case LOG_EXPR :
-        var_check_circ( g_node_first_child( expr ), NULL, res, var_table, bel_table );
+        var_check_circ( g_node_first_child( expr ), var_to_compare, res, var_table, bel_table );
         break;
       case EXP_EXPR :
-        var_check_circ( g_node_first_child( expr ), NULL, res, var_table, bel_table );
+        var_check_circ( g_node_first_child( expr ), var_to_compare, res, var_table, bel_table );
         break;
       case SIN_EXPR :
-        var_check_circ( g_node_first_child( expr ), NULL, res, var_table, bel_table );
+        var_check_circ( g_node_first_child( expr ), var_to_compare, res, var_table, bel_table );
         break;
       case COS_EXPR :
-        var_check_circ( g_node_first_child( expr ), NULL, res, var_table, bel_table );
+        var_check_circ( g_node_first_child( expr ), var_to_compare, res, var_table, bel_table );
         break;
       case TAN_EXPR :
-        var_check_circ( g_node_first_child( expr ), NULL, res, var_table, bel_table );
+        var_check_circ( g_node_first_child( expr ), var_to_compare, res, var_table, bel_table );
         break;
       case ASIN_EXPR :
-        var_check_circ( g_node_first_child( expr ), NULL, res, var_table, bel_table );
+        var_check_circ( g_node_first_child( expr ), var_to_compare, res, var_table, bel_table );
         break;
       case ABS_EXPR :
-        var_check_circ( g_node_first_child( expr ), NULL, res, var_table, bel_table );
+        var_check_circ( g_node_first_child( expr ), var_to_compare, res, var_table, bel_table );
         break;
       case MAX_EXPR :
         node = g_node_first_child( expr );
-        ( var_check_circ( node, NULL, res, var_table, bel_table ),var_check_circ( node->next, NULL, res, var_table, bel_table ) );
+        ( var_check_circ( node, var_to_compare, res, var_table, bel_table ),var_check_circ( node->next, var_to_compare, res, var_table, bel_table ) );
         break;
       case MIN_EXPR :
         node = g_node_first_child( expr );
-        ( var_check_circ( node, NULL, res, var_table, bel_table ), var_check_circ( node->next, NULL, res, var_table, bel_table ) );
+        ( var_check_circ( node, var_to_compare, res, var_table, bel_table ), var_check_circ( node->next, var_to_compare, res, var_table, bel_table ) );
         break;
       default :
         /* fprintf(stderr, "error ! unknown expression type\n"); */
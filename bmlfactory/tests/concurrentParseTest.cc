@@ -0,0 +1,220 @@
+////////////////////////////////////////////////////////////
+//
+// File:          concurrentParseTest.cc
+//
+////////////////////////////////////////////////////////////
+//
+// Parses several MAD8 decks with MAD8Factory, first one
+// after the other and then from several threads at once.
+//
+// The decks differ by their quadrupole strengths and number
+// of cells; all of them include a common file with CALL and
+// contain multi-line comments and string constants, so that
+// the whole lexer and parser state is exercised. Each thread
+// parses every deck, in its own order. The beamlines built
+// by the threads must be identical, element by element and
+// to the last bit, to those built serially.
+//
+// ------------
+// COMMAND LINE
+// ------------
+// concurrentParseTest [options]
+//
+// -------
+// OPTIONS
+// -------
+// Note: NNN represents an integer
+//
+// -decks   NNN   number of decks
+//                : default = 8
+// -threads NNN   number of threads
+//                : default = 4
+//
+////////////////////////////////////////////////////////////
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <cstdlib>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <boost/thread.hpp>
+#include <boost/bind.hpp>
+
+#include <basic_toolkit/GenericException.h>
+#include <beamline/beamline.h>
+#include <beamline/Particle.h>
+#include <bmlfactory/MAD8Factory.h>
+
+using namespace std;
+
+namespace {
+
+char const* const common_file = "concurrentParseTest_common.lat";
+
+std::string deckFile( int i )
+{
+  std::ostringstream name;
+  name << "concurrentParseTest_" << i << ".lat";
+  return name.str();
+}
+
+//
+// Writes the common file and deck i.
+//
+
+void writeCommon()
+{
+  ofstream os( common_file );
+  os << "! elements common to all decks"                                    << endl;
+  os << "O:  DRIFT,      L=1.5"                                             << endl;
+  os << "SF: SEXTUPOLE,  L=0.2, K2=0.4"                                     << endl;
+  os << "SD: SEXTUPOLE,  L=0.2, K2=-0.6"                                    << endl;
+  os << "M:  MONITOR"                                                       << endl;
+  os << "RETURN"                                                            << endl;
+}
+
+void writeDeck( int i )
+{
+  ofstream os( deckFile( i ).c_str() );
+  os.precision( 17 );
+  os << "  ! deck " << i                                                    << endl;
+  os << "  ! a comment spanning"                                            << endl;
+  os << "  ! several lines"                                                 << endl;
+  os << "DECK: CONSTANT = \"DECK" << i << "\""                              << endl;
+  os << "NC:   CONSTANT = " << 4 + i%3                                      << endl;
+  os << "CALL, FILENAME=\"" << common_file << "\""                          << endl;
+  os << "KF = 0.1 + " << i << "*1.0E-3"                                     << endl;
+  os << "KD := -KF*1.05"                                                    << endl;
+  os << "QF: QUADRUPOLE, L=0.5, K1=KF"                                      << endl;
+  os << "QD: QUADRUPOLE, L=0.5, K1=KD"                                      << endl;
+  os << "B:  SBEND,      L=3.0, ANGLE=PI/NC"                                << endl;
+  os << "CELL: LINE=(QF, O, SF, B, O, M, QD, O, SD, B, O)"                  << endl;
+  os << "RING: LINE=(" << 4 + i%3 << "*CELL)"                               << endl;
+  os << "RETURN"                                                            << endl;
+}
+
+//
+// A description of the line: type, name, length and strength of
+// each element, printed with all digits.
+//
+
+std::string describe( beamline const& bml )
+{
+  std::ostringstream os;
+  os.precision( 17 );
+
+  for ( beamline::const_deep_iterator it = bml.deep_begin(); it != bml.deep_end(); ++it ) {
+    os << (*it)->Type() << " " << (*it)->Name() << " " << (*it)->Length() << " " << (*it)->Strength() << "\n";
+  }
+  return os.str();
+}
+
+std::string parse( int i, double brho )
+{
+  MAD8Factory factory( deckFile( i ) );
+  BmlPtr bml = factory.create_beamline( "RING", brho );
+
+  std::ostringstream os;
+  os.precision( 17 );
+  os << factory.getVariableValue( "KD" ) << "\n";
+  if ( bml ) { os << describe( *bml ); }
+  return os.str();
+}
+
+//
+// Thread body: parses every deck, starting with deck first.
+//
+
+void parseAll( int first, int ndecks, double brho, std::vector<std::string>* results, int* nerrors )
+{
+  results->assign( ndecks, std::string() );
+
+  try {
+    for ( int k=0; k<ndecks; ++k ) {
+      int const i = ( first + k ) % ndecks;
+      (*results)[i] = parse( i, brho );
+    }
+  }
+  catch ( GenericException const& ge ) {
+    cout << "*** ERROR *** " << ge.what() << endl;
+    ++(*nerrors);
+  }
+}
+
+} // anonymous namespace
+
+int main( int argc, char** argv )
+{
+  int ndecks   = 8;
+  int nthreads = 4;
+
+  for ( int i=1; i<argc; ++i ) {
+    if      ( 0 == strcmp( argv[i], "-decks"   ) && i+1 < argc ) { ndecks   = atoi( argv[++i] ); }
+    else if ( 0 == strcmp( argv[i], "-threads" ) && i+1 < argc ) { nthreads = atoi( argv[++i] ); }
+  }
+
+  Proton proton( 100.0 );
+  double const brho = proton.refBrho();
+
+  writeCommon();
+  for ( int i=0; i<ndecks; ++i ) { writeDeck( i ); }
+
+  int status = 0;
+
+  // ---------------------------------------
+  // serial parsing
+  // ---------------------------------------
+
+  std::vector<std::string> serial( ndecks );
+
+  for ( int i=0; i<ndecks; ++i ) {
+    serial[i] = parse( i, brho );
+    if ( serial[i].find( "quadrupole" ) == std::string::npos ) {
+      cout << "*** ERROR *** Deck " << deckFile( i ) << " produced no quadrupoles." << endl;
+      status = 1;
+    }
+  }
+
+  for ( int i=1; i<ndecks; ++i ) {
+    if ( serial[i] == serial[i-1] ) {
+      cout << "*** ERROR *** Decks " << i-1 << " and " << i << " produced the same line." << endl;
+      status = 1;
+    }
+  }
+
+  // ---------------------------------------
+  // concurrent parsing
+  // ---------------------------------------
+
+  std::vector<std::vector<std::string> > results( nthreads );
+  std::vector<int>                       nerrors( nthreads, 0 );
+
+  boost::thread_group threads;
+
+  for ( int t=0; t<nthreads; ++t ) {
+    threads.create_thread( boost::bind( &parseAll, t, ndecks, brho, &results[t], &nerrors[t] ) );
+  }
+  threads.join_all();
+
+  for ( int t=0; t<nthreads; ++t ) {
+
+    if ( nerrors[t] ) { status = 1; continue; }
+
+    for ( int i=0; i<ndecks; ++i ) {
+      if ( results[t][i] != serial[i] ) {
+        cout << "*** ERROR *** Thread " << t << ": the line parsed from " << deckFile( i )
+             << " differs from the one parsed serially." << endl;
+        status = 1;
+      }
+    }
+  }
+
+  remove( common_file );
+  for ( int i=0; i<ndecks; ++i ) { remove( deckFile( i ).c_str() ); }
+
+  return status;
+}
@@ -0,0 +1,15 @@
+#!/bin/csh
+
+./concurrentParseTest
+set return_status = $status
+if( 0 != $return_status ) then
+  exit $return_status
+  endif
+
+./concurrentParseTest -decks 3 -threads 8
+set return_status = $status
+if( 0 != $return_status ) then
+  exit $return_status
+  endif
+
+exit 0
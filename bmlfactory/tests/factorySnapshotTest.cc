@@ -0,0 +1,195 @@
+////////////////////////////////////////////////////////////
+//
+// File:          factorySnapshotTest.cc
+//
+////////////////////////////////////////////////////////////
+//
+// Stores a line built by MAD8Factory in a BeamlineSnapshot
+// and loads it back.
+//
+// The deck contains every element type that the factory
+// creates: bends of both kinds, with and without face angles,
+// thick and thin multipoles, a MULTIPOLE with every strength
+// from K0L (a thin2pole) to K3L and a tilt, a solenoid,
+// kickers, an rf cavity, monitors, a rotation and markers.
+// The elements of the two lines must agree, element by
+// element and to the last bit, and a particle tracked around
+// both must end at the same point. The quadrupoles are given
+// a symplectic integrator, which must be restored too.
+//
+// ------------
+// COMMAND LINE
+// ------------
+// factorySnapshotTest
+//
+////////////////////////////////////////////////////////////
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <cstdio>
+#include <string>
+
+#include <basic_toolkit/GenericException.h>
+#include <beamline/beamline.h>
+#include <beamline/Particle.h>
+#include <beamline/quadrupole.h>
+#include <beamline/BeamlineSnapshot.h>
+#include <bmlfactory/MAD8Factory.h>
+
+using namespace std;
+
+namespace {
+
+char const* const deck_file     = "factorySnapshotTest.lat";
+char const* const snapshot_file = "factorySnapshotTest.snp";
+
+void writeDeck()
+{
+  ofstream os( deck_file );
+  os << "O:   DRIFT,      L=1.0"                                            << endl;
+  os << "OS:  DRIFT,      L=0.25"                                           << endl;
+  os << "B:   SBEND,      L=3.0, ANGLE=PI/16"                               << endl;
+  os << "BE:  SBEND,      L=3.0, ANGLE=PI/16, E1=0.01, E2=0.02"             << endl;
+  os << "BK:  SBEND,      L=3.0, ANGLE=PI/16, K1=0.01"                      << endl;
+  os << "R:   RBEND,      L=2.0, ANGLE=PI/32"                               << endl;
+  os << "RE:  RBEND,      L=2.0, ANGLE=PI/32, E1=0.01, E2=0.01"             << endl;
+  os << "RK:  RBEND,      L=2.0, ANGLE=PI/32, K1=-0.01"                     << endl;
+  os << "QF:  QUADRUPOLE, L=0.5, K1=0.1"                                    << endl;
+  os << "QD:  QUADRUPOLE, L=0.5, K1=-0.1, TILT=0.001"                       << endl;
+  os << "TQ:  QUADRUPOLE, K1=0.01"                                          << endl;
+  os << "SF:  SEXTUPOLE,  L=0.2, K2=0.4"                                    << endl;
+  os << "TS:  SEXTUPOLE,  K2=0.1"                                           << endl;
+  os << "OC:  OCTUPOLE,   L=0.2, K3=2.0"                                    << endl;
+  os << "TO:  OCTUPOLE,   K3=1.0"                                           << endl;
+  os << "MP:  MULTIPOLE,  K0L=1.0E-5, T0=0.002, K1L=0.01, K2L=0.1, K3L=1.0" << endl;
+  os << "SOL: SOLENOID,   L=1.0, KS=0.001"                                  << endl;
+  os << "HK:  HKICK,      KICK=1.0E-5"                                      << endl;
+  os << "VK:  VKICK,      L=0.1, KICK=-1.0E-5"                              << endl;
+  os << "K:   KICKER,     HKICK=1.0E-6, VKICK=2.0E-6"                       << endl;
+  os << "RF:  RFCAVITY,   L=0.5, VOLT=0.1, LAG=0.1, HARMON=4"               << endl;
+  os << "HM:  HMONITOR"                                                     << endl;
+  os << "VM:  VMONITOR"                                                     << endl;
+  os << "M:   MONITOR"                                                      << endl;
+  os << "SR:  SROT,       ANGLE=0.0"                                        << endl;
+  os << "MK:  MARKER"                                                       << endl;
+  os << "CELL: LINE=(QF, O, SF, B, O, HM, QD, O, OC, BE, O, VM, TQ, OS, TS, OS, TO, MP, OS, BK, OS, " << endl;
+  os << "            R, OS, RE, OS, RK, OS, SOL, HK, VK, K, M, SR, MK)"    << endl;
+  os << "RING: LINE=(4*CELL, RF)"                                           << endl;
+  os << "RETURN"                                                            << endl;
+}
+
+//
+// Compares the elements of a and b.
+//
+
+int compare( beamline const& a, beamline const& b )
+{
+  int status = 0;
+
+  if ( a.countHowManyDeeply() != b.countHowManyDeeply() ) {
+    cout << "*** ERROR *** The lines hold " << a.countHowManyDeeply()
+         << " and " << b.countHowManyDeeply() << " elements." << endl;
+    return 1;
+  }
+
+  beamline::const_deep_iterator jt = b.deep_begin();
+
+  for ( beamline::const_deep_iterator it = a.deep_begin(); it != a.deep_end(); ++it, ++jt ) {
+
+    BmlnElmnt const& x = **it;
+    BmlnElmnt const& y = **jt;
+
+    bool same =    ( std::string( x.Type() ) == y.Type() )
+                && ( std::string( x.Name() ) == y.Name() )
+                && ( x.Length()              == y.Length()            )
+                && ( x.Strength()            == y.Strength()          )
+                && ( x.getReferenceTime()    == y.getReferenceTime()  )
+                && ( x.alignment().roll()    == y.alignment().roll()  );
+
+    if ( quadrupole const* q = dynamic_cast<quadrupole const*>( &x ) ) {
+      same = same && ( q->getIntegrator() == static_cast<quadrupole const&>( y ).getIntegrator() );
+    }
+
+    if ( !same ) {
+      cout << "*** ERROR *** Element " << x.Type() << " " << x.Name()
+           << " differs from its instantiation " << y.Type() << " " << y.Name() << endl;
+      status = 1;
+    }
+  }
+
+  return status;
+}
+
+} // anonymous namespace
+
+int main( int argc, char** argv )
+{
+  Proton proton( 100.0 );
+  double const brho = proton.refBrho();
+
+  writeDeck();
+
+  int status = 0;
+
+  BmlPtr ring;
+  {
+    MAD8Factory factory( deck_file );
+    ring = factory.create_beamline( "RING", brho );
+  }
+
+  if ( !ring ) {
+    cout << "*** ERROR *** The factory did not build RING." << endl;
+    return 1;
+  }
+
+  for ( beamline::deep_iterator it = ring->deep_begin(); it != ring->deep_end(); ++it ) {
+    if ( quadrupole* q = dynamic_cast<quadrupole*>( (*it).get() ) ) { q->setIntegrator( 4, 3 ); }
+  }
+
+  ring->setLineMode( beamline::ring );
+  ring->setMomentum( proton.refMomentum() );
+  ring->registerReference( proton );
+
+  BmlPtr copy;
+
+  try {
+    BeamlineSnapshot::write( *ring, snapshot_file );
+    BeamlineSnapshot snapshot( snapshot_file );
+    copy = snapshot.instantiate();
+  }
+  catch ( GenericException const& ge ) {
+    cout << "*** ERROR *** " << ge.what() << endl;
+    return 1;
+  }
+
+  status |= compare( *ring, *copy );
+
+  Proton p( proton );
+  p.x  ( 1.0e-3 );
+  p.npy( 1.0e-5 );
+  p.ndp( 2.0e-4 );
+
+  Proton q( p );
+
+  for ( int turn=0; turn < 10; ++turn ) {
+    ring->propagate( p );
+    copy->propagate( q );
+  }
+
+  for ( int i=0; i<6; ++i ) {
+    if ( p.state()[i] != q.state()[i] ) {
+      cout << "*** ERROR *** The instantiated ring differs from the original one." << endl;
+      cout << "*** ERROR *** " << p.state() << endl;
+      cout << "*** ERROR *** " << q.state() << endl;
+      status = 1;
+      break;
+    }
+  }
+
+  remove( deck_file );
+  remove( snapshot_file );
+
+  if ( 0 == status ) { cout << "factorySnapshotTest: passed." << endl; }
+  return status;
+}
@@ -0,0 +1,303 @@
+////////////////////////////////////////////////////////////
+//
+// File:          latticeCacheTest.cc
+//
+////////////////////////////////////////////////////////////
+//
+// Checks the LatticeCache.
+//
+// The lines are built by DeckFactory, a minimal factory that
+// reads a deck of "CELLS n" and "K2 value" statements and
+// follows CALL statements, so that the cache is tested apart
+// from the MAD8 and XSIF parsers; it counts how many times
+// it is invoked.
+//
+//  - a second request for the same line is a hit, and
+//    returns the line built by the parser;
+//  - editing a file included by the deck with CALL is a miss;
+//  - with the memory store emptied, a line is found in the
+//    disk store;
+//  - a corrupt snapshot is a miss; it is replaced, and the
+//    next request is a hit;
+//  - the memory store holds at most capacity() lines, and
+//    drops the least recently used line first.
+//
+// ------------
+// COMMAND LINE
+// ------------
+// latticeCacheTest
+//
+////////////////////////////////////////////////////////////
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <cstdio>
+#include <string>
+#include <typeinfo>
+
+#include <basic_toolkit/GenericException.h>
+#include <beamline/beamline.h>
+#include <beamline/Particle.h>
+#include <beamline/Drift.h>
+#include <beamline/quadrupole.h>
+#include <beamline/sextupole.h>
+#include <bmlfactory/LatticeCache.h>
+
+using namespace std;
+
+namespace {
+
+char const* const deck_file   = "latticeCacheTest.lat";
+char const* const common_file = "latticeCacheTest_common.lat";
+char const* const cache_dir   = "latticeCacheTest_cache";
+
+//
+// DeckFactory: RING has CELLS cells, RING2 half as many.
+//
+
+class DeckFactory {
+
+ public:
+
+  static int invocations;
+
+  DeckFactory( std::string const& fname ) : ncells_(0), k2_(0.0) { read( fname ); }
+
+  BmlPtr create_beamline( std::string const& name, double brho )
+  {
+    ++invocations;
+
+    Drift      o ( "O",  1.5 );
+    quadrupole qf( "QF", 0.5,  0.1*brho );
+    quadrupole qd( "QD", 0.5, -0.1*brho );
+    sextupole  sf( "SF", 0.2,  k2_*brho );
+
+    int const n = ( name == "RING2" ) ? ncells_/2 : ncells_;
+
+    BmlPtr bml( new beamline( name ) );
+    for ( int i=0; i<n; ++i ) {
+      bml->append( qf );
+      bml->append( o  );
+      bml->append( sf );
+      bml->append( qd );
+      bml->append( o  );
+    }
+    return bml;
+  }
+
+ private:
+
+  void read( std::string const& fname )
+  {
+    ifstream is( fname.c_str() );
+    std::string word;
+
+    while ( is >> word ) {
+      if      ( word == "CELLS" ) { is >> ncells_; }
+      else if ( word == "K2"    ) { is >> k2_;     }
+      else if ( word == "CALL," ) {
+        is >> word;                                          // FILENAME="name"
+        std::string::size_type const first = word.find( '"' );
+        read( word.substr( first+1, word.rfind( '"' ) - first - 1 ) );
+      }
+    }
+  }
+
+  int    ncells_;
+  double k2_;
+};
+
+int DeckFactory::invocations = 0;
+
+void writeCommon( double k2 )
+{
+  ofstream os( common_file );
+  os.precision( 17 );
+  os << "K2 " << k2                                                         << endl;
+}
+
+void writeDeck()
+{
+  ofstream os( deck_file );
+  os << "CALL, FILENAME=\"" << common_file << "\""                          << endl;
+  os << "CELLS 4"                                                           << endl;
+}
+
+std::string describe( beamline const& bml )
+{
+  std::ostringstream os;
+  os.precision( 17 );
+
+  for ( beamline::const_deep_iterator it = bml.deep_begin(); it != bml.deep_end(); ++it ) {
+    os << (*it)->Type() << " " << (*it)->Name() << " " << (*it)->Length() << " " << (*it)->Strength() << "\n";
+  }
+  return os.str();
+}
+
+std::string parsed( std::string const& name, double brho )
+{
+  DeckFactory factory( deck_file );
+  std::string const result = describe( *factory.create_beamline( name, brho ) );
+  --DeckFactory::invocations;                                // not a request to the cache
+  return result;
+}
+
+std::string cached( std::string const& name, double brho )
+{
+  BmlPtr bml = LatticeCache::create_beamline<DeckFactory>( deck_file, name, brho );
+  return bml ? describe( *bml ) : std::string();
+}
+
+std::string snapshotFile( std::string const& name, double brho )
+{
+  std::ostringstream fname;
+  fname << cache_dir << "/" << std::hex << std::setw(16) << std::setfill('0')
+        << LatticeCache::key( typeid(DeckFactory).name(), deck_file, name, brho ) << ".bml";
+  return fname.str();
+}
+
+//
+// Checks the counters of the cache, and that the factory ran once per miss.
+//
+
+int expect( char const* step, int hits, int misses )
+{
+  int const invocations = DeckFactory::invocations;
+
+  if ( LatticeCache::hits() == hits && LatticeCache::misses() == misses && invocations == misses ) return 0;
+
+  cout << "*** ERROR *** " << step << ": " << LatticeCache::hits() << " hits and "
+       << LatticeCache::misses() << " misses, " << invocations << " factory runs; expected "
+       << hits << " and " << misses << "." << endl;
+  return 1;
+}
+
+//
+// Empties the memory store and resets the counters.
+//
+
+void clear()
+{
+  LatticeCache::clear();
+  DeckFactory::invocations = 0;
+}
+
+int same( char const* step, std::string const& result, std::string const& expected )
+{
+  if ( result == expected ) return 0;
+
+  cout << "*** ERROR *** " << step << ": the cached line differs from the parsed one." << endl;
+  return 1;
+}
+
+} // anonymous namespace
+
+int main( int argc, char** argv )
+{
+  int status = 0;
+
+  double const brho = Proton( 100.0 ).refBrho();
+
+  writeCommon( 0.4 );
+  writeDeck();
+
+  LatticeCache::setDirectory( cache_dir );
+  clear();
+
+  remove( snapshotFile( "RING", brho ).c_str() );
+
+  // ---------------------------------------
+  // Miss, then hit
+  // ---------------------------------------
+
+  std::string const ring = parsed( "RING", brho );
+
+  status |= same( "first request",  cached( "RING", brho ), ring );
+  status |= expect( "first request",  0, 1 );
+
+  status |= same( "second request", cached( "RING", brho ), ring );
+  status |= expect( "second request", 1, 1 );
+
+  // ---------------------------------------
+  // Disk store
+  // ---------------------------------------
+
+  clear();
+
+  status |= same( "disk store", cached( "RING", brho ), ring );
+  status |= expect( "disk store", 1, 0 );
+
+  // ---------------------------------------
+  // Corrupt snapshot
+  // ---------------------------------------
+
+  {
+    ofstream os( snapshotFile( "RING", brho ).c_str(), ios::binary | ios::trunc );
+    os << "not a snapshot";
+  }
+
+  clear();
+
+  status |= same( "corrupt snapshot", cached( "RING", brho ), ring );
+  status |= expect( "corrupt snapshot", 0, 1 );
+
+  clear();
+
+  status |= same( "replaced snapshot", cached( "RING", brho ), ring );
+  status |= expect( "replaced snapshot", 1, 0 );
+
+  // ---------------------------------------
+  // Edit of an included file
+  // ---------------------------------------
+
+  writeCommon( 0.5 );
+
+  std::string const edited = parsed( "RING", brho );
+
+  if ( edited == ring ) {
+    cout << "*** ERROR *** The edit of the included file did not change the line." << endl;
+    status = 1;
+  }
+
+  clear();
+
+  status |= same( "edited file", cached( "RING", brho ), edited );
+  status |= expect( "edited file", 0, 1 );
+
+  // ---------------------------------------
+  // Bounded memory store
+  // ---------------------------------------
+
+  LatticeCache::setDirectory( "" );
+  LatticeCache::setCapacity( 1 );
+  clear();
+
+  std::string const ring2 = parsed( "RING2", brho );
+
+  cached( "RING",  brho );
+  status |= same( "capacity", cached( "RING2", brho ), ring2 );
+
+  if ( LatticeCache::size() != 1 ) {
+    cout << "*** ERROR *** The memory store holds " << LatticeCache::size() << " lines; its capacity is 1." << endl;
+    status = 1;
+  }
+
+  cached( "RING2", brho );
+  status |= expect( "capacity, most recent line", 1, 2 );
+
+  cached( "RING",  brho );
+  status |= expect( "capacity, dropped line", 1, 3 );
+
+  LatticeCache::setCapacity( 0 );
+  clear();
+
+  cached( "RING", brho );
+  cached( "RING", brho );
+  status |= expect( "no memory store", 0, 2 );
+
+  remove( snapshotFile( "RING", brho ).c_str() );
+
+  return status;
+}
@@ -24,7 +24,12 @@
 #ifndef GMS_FASTALLOCATOR_H_
 #define GMS_FASTALLOCATOR_H_
 
+#include <algorithm>
 #include <boost/pool/pool.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/tss.hpp>
+#include <boost/detail/atomic_count.hpp>
+#include <vector>
 
 namespace gms {
 
@@ -32,63 +37,169 @@ namespace gms {
 #define MAX_SMALL_OBJECT_SIZE 64
 #endif
 
+// GNU compilers cache the PoolManager of the calling thread in a thread-local pointer;
+// the lookup in a boost::thread_specific_ptr would otherwise cost more than the allocation.
+
+#if defined(__GNUC__) && !defined(WIN32)
+#define GMS_THREAD_LOCAL __thread
+#endif
+
 /// Manages MAX_SMALL_OBJECT_SIZE amount of memory pools (no much cost for empty pools)
 /// It selects the appropriate memory pool depending on how much memory is being allocated/deallocated.
+///
+/// Each thread allocates from its own PoolManager, without locking. The owner of an object is 
+/// recorded in a header that precedes it, so that it may be released by any thread: the owner
+/// releases it directly; another thread hands it back through a locked list, which the owner 
+/// drains on its next allocation. When a thread exits, its PoolManager is kept (objects allocated 
+/// from it may still be in use) and handed over to the next thread that needs one.
 
 class PoolManager {
 	
 public:
 
-/// singleton access
+/// the pools of the calling thread
     static PoolManager& getInstance() {
-	                                static PoolManager instance;
-			                return instance;
+                                        PoolManager* p = current();
+                                        if (p) return *p;
+                                        {
+                                          boost::mutex::scoped_lock lock( freeInstancesMutex() );
+                                          if ( !freeInstances().empty() ) {
+                                            p = freeInstances().back();
+                                            freeInstances().pop_back();
+                                          }
+                                        }
+                                        if (!p) p = new PoolManager();
+                                        instances().reset(p);
+#ifdef GMS_THREAD_LOCAL
+                                        cached() = p;
+#endif
+                                        return *p;
 		                       }
 
      void* allocateMemory(size_t size) {
 		                         if(   (size > MAX_SMALL_OBJECT_SIZE) ) { 
                                          return ::operator new(size);
 		                         }		  
-		                         return m_pools[size - 1]->malloc();
+                                         if ( long(m_released) != m_drained ) drain();
+		                         Header* h = static_cast<Header*>( m_pools[size - 1]->malloc() );
+                                         h->owner = this;
+		                         return h + 1;
 		                       }
 
-     void releaseMemory(void* deletable, size_t size) {
+     static void releaseMemory(void* deletable, size_t size) {
 	       		                                 if (size > MAX_SMALL_OBJECT_SIZE) {
 				                            //use normal delete
                                                             // note: destructor is **not** called 
 				                            ::operator delete(deletable);
 			                                 } else {
 				                           //use pool free. Don't delete null pointers
-				                             if (deletable)
-					                       m_pools[size - 1]->free(deletable);
+				                             if (!deletable) return;
+                                                             Header*      h     = static_cast<Header*>(deletable) - 1;
+                                                             PoolManager* owner = h->owner;
+                                                             if ( owner == current() ) {
+					                       owner->m_pools[size - 1]->free(h);
+                                                             } else {
+                                                               owner->releaseRemote(h, size);
+				                             }
 			                                 }
 		                                      }
 
-    ~PoolManager() {
-		      for (int i = 0; i < MAX_SMALL_OBJECT_SIZE; ++i) {
-				  delete m_pools[i];
-                      }
-
-
-		    }
-
  private:
 		
+    union Header {            // precedes each object
+      PoolManager* owner; 
+      double       align;
+    };
 
-     PoolManager() {
+    struct RemoteNode {       // an object released by another thread
+      RemoteNode* next;
+      size_t      size;
+    };
+
+     PoolManager(): m_remote(0), m_released(0), m_drained(0) {
 			for (int i = 0; i < MAX_SMALL_OBJECT_SIZE; ++i)
-				m_pools[i] = new boost::pool<>(i + 1);
+				m_pools[i] = new boost::pool<>( std::max( sizeof(Header) + i + 1, sizeof(RemoteNode) ) );
 		    }
 
+    ~PoolManager();             // never destroyed: objects may outlive their thread 
+
+    void releaseRemote( Header* h, size_t size ) {
+                                                   RemoteNode* node = reinterpret_cast<RemoteNode*>(h);
+                                                   node->size = size;
+                                                   boost::mutex::scoped_lock lock( m_remoteMutex );
+                                                   node->next = m_remote;
+                                                   m_remote   = node;
+                                                   ++m_released;
+                                                 }
+
+    void drain() {
+                   RemoteNode* node = 0;
+                   {
+                     boost::mutex::scoped_lock lock( m_remoteMutex );
+                     node      = m_remote;
+                     m_remote  = 0;
+                     m_drained = m_released;
+                   }
+                   while (node) {
+                     RemoteNode* next = node->next;
+                     m_pools[node->size - 1]->free(node);
+                     node = next;
+                   }
+                 }
+
+    static void releaseInstance( PoolManager* p ) {   // called on thread exit
+                                                    boost::mutex::scoped_lock lock( freeInstancesMutex() );
+                                                    freeInstances().push_back(p);
+                                                  }
+
+    static PoolManager* current() {   // 0 if the calling thread has no PoolManager yet
+#ifdef GMS_THREAD_LOCAL
+                                    return cached();
+#else
+                                    return instances().get();
+#endif
+                                  }
+
+#ifdef GMS_THREAD_LOCAL
+    static PoolManager*& cached() {
+                                    static GMS_THREAD_LOCAL PoolManager* p = 0;
+                                    return p;
+                                  }
+#endif
+
+    static boost::thread_specific_ptr<PoolManager>& instances() {
+                                                       static boost::thread_specific_ptr<PoolManager>& tss 
+                                                         = *( new boost::thread_specific_ptr<PoolManager>( &releaseInstance ) );
+                                                       return tss;
+                                                     }
+
+    static std::vector<PoolManager*>& freeInstances() {   // no longer owned by a thread
+                                                       static std::vector<PoolManager*>& v = *( new std::vector<PoolManager*>() );
+                                                       return v;
+                                                     }
+
+    static boost::mutex& freeInstancesMutex() {
+                                                 static boost::mutex& m = *( new boost::mutex() );
+                                                 return m;
+                                               }
+
     //no copying of a singleton:
      
     PoolManager(const PoolManager&);
 		
     const PoolManager& operator=(const PoolManager&);
 
-    /// memory pool array. m_pools[n] corresponds to pool with objectSize==n+1.
+    /// memory pool array. m_pools[n] corresponds to pool with objectSize==n+1 (plus the header).
     
     boost::pool<>* m_pools[MAX_SMALL_OBJECT_SIZE];
+
+    /// objects released by other threads; m_released counts them, m_drained is the 
+    /// count at the last drain (read by the owner only).
+
+    boost::mutex                 m_remoteMutex;
+    RemoteNode*                  m_remote;
+    boost::detail::atomic_count  m_released;
+    long                         m_drained;
 	
 }; //  class PoolManager
 
@@ -122,7 +233,7 @@ public:
 #ifdef WIN32
       ::operator delete(deletable);
 #else
-      PoolManager::getInstance().releaseMemory(deletable, size);
+      PoolManager::releaseMemory(deletable, size);
 #endif
 
    }
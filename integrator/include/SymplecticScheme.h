@@ -0,0 +1,275 @@
+/*************************************************************************
+**************************************************************************
+**************************************************************************
+******
+******  INTEGRATOR: Numerical integration and interpolation
+******
+******  File:      SymplecticScheme.h
+******
+******  Copyright (c) Fermi Research Alliance LLC
+******                All Rights Reserved
+******
+******  Usage, modification, and redistribution are subject to terms
+******  of the License supplied with this software.
+******
+******  Software and documentation created under
+******  U.S. Department of Energy Contract No. DE-AC02-07CH11359.
+******  The U.S. Government retains a world-wide non-exclusive,
+******  royalty-free license to publish or reproduce documentation
+******  and software for U.S. Government purposes. This software
+******  is protected under the U.S. and Foreign Copyright Laws.
+******
+******  Revision History
+******
+******  Oct 2026
+******
+******  - Initial version.
+******
+**************************************************************************
+*************************************************************************/
+
+// ==============================================================================
+//
+// A SymplecticScheme is a splitting method for a Hamiltonian H = H_1 + H_2
+// whose flows exp(h:H_1:) ("drift") and exp(h:H_2:) ("kick") are known
+// exactly. One step of length h is the sequence
+//
+//   D(c_0 h) K(d_0 h) D(c_1 h) K(d_1 h) ... K(d_{m-1} h) D(c_m h)
+//
+// The schemes are symmetric, and the drift at the end of a step is merged
+// with the one at the beginning of the next.
+//
+// The state type is left to the caller: integrate() only passes it to the
+// drift and kick, which are called as
+//
+//   drift( state, l );     kick( state, l );
+//
+// where l is the length (coefficient times step) of the substep. The state
+// may be a Vector, a Mapping, a Particle or a whole bunch. For a bunch in
+// SoA form the drift and kick loop over the particles, so that each substep
+// is applied to all the particles before the next one. The overload of
+// integrate() over a range of states does the same for states held in a
+// container.
+//
+// The coefficients are those of
+//
+//   leapfrog    : 2nd order, 1 kick per step
+//   forestRuth  : 4th order, 3 kicks per step (E. Forest and R. Ruth,
+//                 Physica D 43 (1990) 105). This is also Yoshida's
+//                 4th order "triple jump".
+//   yoshida6    : 6th order, 7 kicks per step  (solution A of
+//   yoshida8    : 8th order, 15 kicks per step (solution D of
+//                 H. Yoshida, Phys. Lett. A 150 (1990) 262)
+//
+// Higher order buys fewer steps for a given accuracy at the cost of more
+// kicks per step, some of them backwards.
+//
+// ==============================================================================
+
+#ifndef SYMPLECTICSCHEME_H
+#define SYMPLECTICSCHEME_H
+
+#include <vector>
+#include <cmath>
+#include <sstream>
+#include <basic_toolkit/globaldefs.h>
+#include <basic_toolkit/GenericException.h>
+
+class SymplecticScheme {
+
+ public:
+
+  static SymplecticScheme const& leapfrog();
+  static SymplecticScheme const& forestRuth();
+  static SymplecticScheme const& yoshida6();
+  static SymplecticScheme const& yoshida8();
+
+  static SymplecticScheme const& forOrder( int order );   // order = 2, 4, 6 or 8
+
+  // The symmetric composition of leapfrog steps of lengths w[0]*h, w[1]*h, ...
+  // The weights must add up to 1.
+
+  static SymplecticScheme compose( std::vector<double> const& w, int order );
+
+  int  order()          const { return order_;        }
+  int  kicksPerStep()   const { return kicks_.size(); }
+
+  std::vector<double> const& driftCoefficients() const { return drifts_; }
+  std::vector<double> const& kickCoefficients()  const { return kicks_;  }
+
+  // Integrates over length with nsteps steps.
+
+  template<typename State_t, typename Drift_t, typename Kick_t>
+  void integrate( State_t& state, double length, int nsteps, Drift_t& drift, Kick_t& kick ) const
+  {
+    double const h = length/nsteps;
+    int    const m = kicks_.size();
+
+    double carry = 0.0;
+
+    for ( int s=0; s<nsteps; ++s ) {
+      for ( int i=0; i<m; ++i ) {
+        double const c = drifts_[i] + carry;
+        carry = 0.0;
+        if ( c != 0.0 ) { drift( state, c*h ); }
+        kick( state, kicks_[i]*h );
+      }
+      carry = drifts_[m];
+    }
+
+    if ( carry != 0.0 ) { drift( state, carry*h ); }
+  }
+
+  // Integrates the states in [first, last), substep by substep.
+
+  template<typename Iterator_t, typename Drift_t, typename Kick_t>
+  void integrate( Iterator_t first, Iterator_t last, double length, int nsteps, Drift_t& drift, Kick_t& kick ) const
+  {
+    double const h = length/nsteps;
+    int    const m = kicks_.size();
+
+    double carry = 0.0;
+
+    for ( int s=0; s<nsteps; ++s ) {
+      for ( int i=0; i<m; ++i ) {
+        double const c = drifts_[i] + carry;
+        carry = 0.0;
+        if ( c != 0.0 ) { for ( Iterator_t it = first; it != last; ++it ) { drift( *it, c*h ); } }
+        for ( Iterator_t it = first; it != last; ++it ) { kick( *it, kicks_[i]*h ); }
+      }
+      carry = drifts_[m];
+    }
+
+    if ( carry != 0.0 ) { for ( Iterator_t it = first; it != last; ++it ) { drift( *it, carry*h ); } }
+  }
+
+ private:
+
+  SymplecticScheme( int order, std::vector<double> const& drifts, std::vector<double> const& kicks )
+    : order_(order), drifts_(drifts), kicks_(kicks) {}
+
+  static SymplecticScheme symmetric( int order, double const* w, int n );
+
+  int                  order_;
+  std::vector<double>  drifts_;   // kicksPerStep()+1 coefficients
+  std::vector<double>  kicks_;
+};
+
+//-----------------------------------------------------------------------------------
+// inline members
+//-----------------------------------------------------------------------------------
+
+inline SymplecticScheme SymplecticScheme::compose( std::vector<double> const& w, int order )
+{
+  int const m = w.size();
+
+  if ( m == 0 ) {
+    throw GenericException( __FILE__, __LINE__,
+          "SymplecticScheme SymplecticScheme::compose( std::vector<double> const& w, int order )",
+          "At least one weight is required." );
+  }
+
+  double sum = 0.0;
+  for ( int i=0; i<m; ++i ) { sum += w[i]; }
+
+  if ( std::abs( sum - 1.0 ) > 1.0e-12 ) {
+    std::ostringstream uic;
+    uic << "The weights add up to " << sum << " instead of 1.";
+    throw GenericException( __FILE__, __LINE__,
+          "SymplecticScheme SymplecticScheme::compose( std::vector<double> const& w, int order )",
+          uic.str().c_str() );
+  }
+
+  std::vector<double> drifts( m+1 );
+  std::vector<double> kicks ( w );
+
+  drifts[0] = 0.5*w[0];
+  for ( int i=1; i<m; ++i ) { drifts[i] = 0.5*( w[i-1] + w[i] ); }
+  drifts[m] = 0.5*w[m-1];
+
+  return SymplecticScheme( order, drifts, kicks );
+}
+
+//-----------------------------------------------------------------------------------
+
+inline SymplecticScheme SymplecticScheme::symmetric( int order, double const* w, int n )
+{
+  // w[0] is the central weight; the others appear twice, w[n-1] outermost.
+
+  double w0 = 1.0;
+  for ( int i=1; i<n; ++i ) { w0 -= 2.0*w[i]; }
+
+  std::vector<double> weights;
+  for ( int i=n-1; i>0;  --i ) { weights.push_back( w[i] ); }
+  weights.push_back( w0 );
+  for ( int i=1;   i<n;  ++i ) { weights.push_back( w[i] ); }
+
+  return compose( weights, order );
+}
+
+//-----------------------------------------------------------------------------------
+
+inline SymplecticScheme const& SymplecticScheme::leapfrog()
+{
+  static double const w[] = { 1.0 };
+  static SymplecticScheme const scheme = symmetric( 2, w, 1 );
+  return scheme;
+}
+
+//-----------------------------------------------------------------------------------
+
+inline SymplecticScheme const& SymplecticScheme::forestRuth()
+{
+  static double const theta = 1.0/( 2.0 - std::pow( 2.0, 1.0/3.0 ) );
+  static double const w[]   = { 0.0, theta };
+  static SymplecticScheme const scheme = symmetric( 4, w, 2 );
+  return scheme;
+}
+
+//-----------------------------------------------------------------------------------
+
+inline SymplecticScheme const& SymplecticScheme::yoshida6()
+{
+  static double const w[] = { 0.0,
+                             -1.17767998417887,
+                              0.235573213359357,
+                              0.784513610477560 };
+  static SymplecticScheme const scheme = symmetric( 6, w, 4 );
+  return scheme;
+}
+
+//-----------------------------------------------------------------------------------
+
+inline SymplecticScheme const& SymplecticScheme::yoshida8()
+{
+  static double const w[] = { 0.0,
+                              0.102799849391985,
+                             -1.96061023297549,
+                              1.93813913762276,
+                             -0.158240635368243,
+                             -1.44485223686048,
+                              0.253693336566229,
+                              0.914844246229740 };
+  static SymplecticScheme const scheme = symmetric( 8, w, 8 );
+  return scheme;
+}
+
+//-----------------------------------------------------------------------------------
+
+inline SymplecticScheme const& SymplecticScheme::forOrder( int order )
+{
+  switch ( order ) {
+    case 2: return leapfrog();
+    case 4: return forestRuth();
+    case 6: return yoshida6();
+    case 8: return yoshida8();
+  }
+
+  std::ostringstream uic;
+  uic << "There is no scheme of order " << order << ". The orders are 2, 4, 6 and 8.";
+  throw GenericException( __FILE__, __LINE__,
+        "SymplecticScheme const& SymplecticScheme::forOrder( int order )",
+        uic.str().c_str() );
+}
+
+#endif // SYMPLECTICSCHEME_H
@@ -0,0 +1,138 @@
+/*
+**
+** Benchmark program:
+**
+** Measures the time needed to set up the monomial tables of a jet
+** environment in n variables, for a range of orders:
+**
+**   - building them (index and multiplication table), as done
+**     when an environment is created and no file is available;
+**   - writing them to the disk store;
+**   - mapping the file back, as done by an environment created
+**     later, by this process or by another one;
+**   - creating a Jet environment whose tables are in the disk
+**     store.
+**
+** The files are written in the directory given with -dir (default:
+** a scratch directory, removed at the end). Note that the files of
+** the higher orders are large: at order 12 in 7 variables, the
+** multiplication table takes about 40 MB.
+**
+** Usage: environmentStartupBenchmark [-dim n] [-min n] [-max n] [-dir path]
+**
+*/
+
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <cstdlib>
+#include <cstring>
+#include <cstdio>
+#include <ctime>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include <boost/date_time/posix_time/posix_time.hpp>
+
+#include <mxyzptlk/Jet.h>
+#include <mxyzptlk/MonomialTables.h>
+
+using namespace std;
+
+namespace {
+
+struct Timer {
+
+  Timer() : cpu( clock() ), wall( boost::posix_time::microsec_clock::universal_time() ), tcpu(0.0), twall(0.0) {}
+
+  Timer stop() const
+  {
+    Timer t( *this );
+    t.tcpu  = double( clock() - cpu )/CLOCKS_PER_SEC;
+    t.twall = ( boost::posix_time::microsec_clock::universal_time() - wall ).total_microseconds()*1.0e-6;
+    return t;
+  }
+
+  clock_t                   cpu;
+  boost::posix_time::ptime  wall;
+  double                    tcpu;
+  double                    twall;
+};
+
+} // namespace
+
+int main( int argc, char** argv )
+{
+ int    dim      = 6;
+ int    minorder = 6;
+ int    maxorder = 10;
+ string dir;
+
+ for( int i = 1; i < argc; ++i ) {
+   if      ( 0 == strcmp( argv[i], "-dim" ) && i+1 < argc ) { dim      = atoi( argv[++i] ); }
+   else if ( 0 == strcmp( argv[i], "-min" ) && i+1 < argc ) { minorder = atoi( argv[++i] ); }
+   else if ( 0 == strcmp( argv[i], "-max" ) && i+1 < argc ) { maxorder = atoi( argv[++i] ); }
+   else if ( 0 == strcmp( argv[i], "-dir" ) && i+1 < argc ) { dir      = argv[++i];         }
+ }
+
+ bool const scratch = dir.empty();
+
+ if ( scratch ) {
+   ostringstream name;
+   name << "environmentStartupBenchmark." << getpid();
+   dir = name.str();
+ }
+
+ mkdir( dir.c_str(), 0755 );
+
+ MonomialTables::setDirectory( dir );
+
+ cout << dim << " variables; times are wall clock [ s ]" << endl;
+ cout << endl;
+ cout << setw(6)  << "order"    << setw(10) << "monomials" << setw(12) << "MB"
+      << setw(12) << "build"    << setw(12) << "write"     << setw(12) << "map"
+      << setw(14) << "environment" << endl;
+
+ for ( int order = minorder; order <= maxorder; ++order ) {
+
+   string const fname = MonomialTables::fileName( dir, order, dim );
+
+   Timer timer;
+
+   MonomialTables* built = new MonomialTables( order, dim );
+
+   Timer const t_build = timer.stop();
+
+   timer = Timer();
+   built->write( fname );
+   Timer const t_write = timer.stop();
+
+   int const nterms = built->maxTerms();
+   delete built;
+
+   timer = Timer();
+   MonomialTables const mapped( fname );
+   Timer const t_map = timer.stop();
+
+   MonomialTables::clear();
+
+   timer = Timer();
+   Jet__environment_ptr env = Jet__environment::makeJetEnvironment( order, dim, dim );
+   Timer const t_env = timer.stop();
+
+   struct stat st;
+   stat( fname.c_str(), &st );
+
+   cout << setw(6)  << order << setw(10) << nterms << setw(12) << setprecision(4) << st.st_size/1048576.0
+        << setw(12) << t_build.twall << setw(12) << t_write.twall << setw(12) << t_map.twall
+        << setw(14) << t_env.twall
+        << ( MonomialTables::loaded() == 1 ? "" : "  (tables built)" ) << endl;
+
+   if ( scratch ) remove( fname.c_str() );
+ }
+
+ if ( scratch ) rmdir( dir.c_str() );
+
+ return 0;
+}
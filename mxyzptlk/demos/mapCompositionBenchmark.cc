@@ -0,0 +1,200 @@
+/*
+**
+** Benchmark program:
+**
+** Concatenates the maps of n elements (nonlinear 6D kicked
+** rotations, all different) into a one-turn map, from the
+** start of the line, oneturn = element( oneturn ), and from
+** its end, oneturn = oneturn( element ), the latter in place
+** with Mapping::operator*=. Each is done
+**
+**   - one component at a time, with Jet::operator()( Mapping ),
+**     the monomials of the argument being computed for every
+**     component;
+**   - with Mapping, which computes them once for all the
+**     components, with one thread and then with several.
+**
+** Prints the CPU and wall clock times of each method and the
+** largest difference between the one-turn maps.
+**
+** Usage: mapCompositionBenchmark [-order n] [-elements n] [-threads n]
+**
+*/
+
+#include <iostream>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <ctime>
+#include <vector>
+
+#include <boost/date_time/posix_time/posix_time.hpp>
+
+#include <mxyzptlk/Jet.h>
+#include <mxyzptlk/Mapping.h>
+
+using namespace std;
+
+namespace {
+
+int const dim = 6;
+
+Mapping element( Jet__environment_ptr const& env, int k )
+{
+  double const mu = 2.0*M_PI*( 0.01 + 0.001*( k%7 ) );
+  double const k2 = 0.02*( 1 + k%3 );
+
+  Mapping map( "identity", env );
+
+  Jet x = map[0], y = map[1], z = map[2], px = map[3], py = map[4], pz = map[5];
+
+  px = px - k2*( x*x - y*y ) - 0.005*sin(x)*z;
+  py = py + 2.0*k2*x*y + 0.002*exp(y)*z*z;
+
+  map[0] =  cos(mu)*x + sin(mu)*px;   map[3] = -sin(mu)*x + cos(mu)*px;
+  map[1] =  cos(mu)*y + sin(mu)*py;   map[4] = -sin(mu)*y + cos(mu)*py;
+  map[2] =  z + 0.01*pz;              map[5] =  pz;
+
+  return map;
+}
+
+double maxdiff( Mapping const& a, Mapping const& b )
+{
+  double d = 0.0;
+
+  for ( int i=0; i<dim; ++i ) {
+    Jet const diff = a[i] - b[i];
+    for ( Jet::const_iterator it = diff.begin(); it != diff.end(); ++it ) {
+      d = std::max( d, std::abs( it->coefficient() ) );
+    }
+  }
+  return d;
+}
+
+struct Timer {
+
+  Timer() : cpu( clock() ), wall( boost::posix_time::microsec_clock::universal_time() ), tcpu(0.0), twall(0.0) {}
+
+  Timer stop() const 
+  {
+    Timer t( *this );
+    t.tcpu  = double( clock() - cpu )/CLOCKS_PER_SEC;
+    t.twall = ( boost::posix_time::microsec_clock::universal_time() - wall ).total_microseconds()*1.0e-6;
+    return t;
+  }
+
+  clock_t                   cpu;
+  boost::posix_time::ptime  wall;
+  double                    tcpu;
+  double                    twall;
+};
+
+std::ostream& operator<<( std::ostream& os, Timer const& t )
+{
+  return os << t.tcpu << " s cpu, " << t.twall << " s wall";
+}
+
+} // namespace
+
+int main( int argc, char** argv )
+{
+ int order     = 7;
+ int nelements = 200;
+ int nthreads  = 4;
+
+ for( int i = 1; i < argc; ++i ) {
+   if      ( 0 == strcmp( argv[i], "-order"    ) && i+1 < argc ) { order     = atoi( argv[++i] ); }
+   else if ( 0 == strcmp( argv[i], "-elements" ) && i+1 < argc ) { nelements = atoi( argv[++i] ); }
+   else if ( 0 == strcmp( argv[i], "-threads"  ) && i+1 < argc ) { nthreads  = atoi( argv[++i] ); }
+ }
+
+ Jet__environment_ptr env = Jet__environment::makeJetEnvironment( order, dim, dim );
+ Jet__environment::pushEnv( env );
+
+ std::vector<Mapping> elements;
+ for( int k = 0; k < nelements; ++k ) { elements.push_back( element( env, k ) ); }
+
+ // ----------------------------------------------
+ // oneturn = element[k]( oneturn ), k = 0 ... n-1 
+ // ----------------------------------------------
+
+ Jet__environment::setCompositionThreads( 1 );
+
+ Timer timer;
+
+ Mapping percomponent( "identity", env );
+
+ for( int k = 0; k < nelements; ++k ) {
+   Mapping z( dim, env );
+   for( int i = 0; i < dim; ++i ) { z[i] = elements[k][i]( percomponent ); }
+   percomponent = z;
+ }
+
+ Timer const t_comp = timer.stop();
+
+ timer = Timer();
+
+ Mapping serial( "identity", env );
+ for( int k = 0; k < nelements; ++k ) { serial = elements[k]( serial ); }
+
+ Timer const t_serial = timer.stop();
+
+ Jet__environment::setCompositionThreads( nthreads );
+
+ timer = Timer();
+
+ Mapping threaded( "identity", env );
+ for( int k = 0; k < nelements; ++k ) { threaded = elements[k]( threaded ); }
+
+ Timer const t_threaded = timer.stop();
+
+ // ----------------------------------------------
+ // in place, from the end of the line: 
+ // oneturn = element[n-1]; oneturn *= element[k], k = n-2 ... 0 
+ // ----------------------------------------------
+
+ Jet__environment::setCompositionThreads( 1 );
+
+ timer = Timer();
+
+ Mapping reverse( "identity", env );
+ for( int k = nelements-1; k >= 0; --k ) {
+   Mapping z( dim, env );
+   for( int i = 0; i < dim; ++i ) { z[i] = reverse[i]( elements[k] ); }
+   reverse = z;
+ }
+
+ Timer const t_rcomp = timer.stop();
+
+ timer = Timer();
+
+ Mapping inplace( elements[nelements-1] );
+ for( int k = nelements-2; k >= 0; --k ) { inplace *= elements[k]; }
+
+ Timer const t_inplace = timer.stop();
+
+ Jet__environment::setCompositionThreads( nthreads );
+
+ timer = Timer();
+
+ Mapping tinplace( elements[nelements-1] );
+ for( int k = nelements-2; k >= 0; --k ) { tinplace *= elements[k]; }
+
+ Timer const t_tinplace = timer.stop();
+
+ cout << "order " << order << ", " << nelements << " elements, " << serial[0].termCount() << " terms in x" << endl;
+ cout << endl;
+ cout << "element[k]( oneturn ):" << endl;
+ cout << "  one component at a time : " << t_comp     << endl;
+ cout << "  Mapping, 1 thread        : " << t_serial   << endl;
+ cout << "  Mapping, " << nthreads << " threads       : " << t_threaded << endl;
+ cout << "oneturn( element[k] ):" << endl;
+ cout << "  one component at a time : " << t_rcomp    << endl;
+ cout << "  operator*=, 1 thread     : " << t_inplace  << endl;
+ cout << "  operator*=, " << nthreads << " threads    : " << t_tinplace << endl;
+ cout << endl;
+ cout << "max difference            : " << std::max( std::max( maxdiff( serial,   percomponent ), maxdiff( threaded, percomponent ) ),
+                                                     std::max( maxdiff( inplace,  percomponent ), maxdiff( tinplace, percomponent ) ) ) << endl;
+
+ return 0;
+}
@@ -0,0 +1,119 @@
+/*
+**
+** Benchmark program:
+**
+** Evaluates a nonlinear 6D Taylor map at n points, first
+** with Mapping::operator()( Vector ) one point at a time and
+** then with a MappingEvaluator on the whole batch (structure
+** of arrays). Prints the CPU time per point of each method
+** and the largest difference between the results.
+**
+** Usage: mapEvaluatorBenchmark [-order n] [-n npoints] [-turns n]
+**
+**   -turns n : number of kicked rotations composed into the map
+**              (more turns give a denser map; default 3)
+**
+*/
+
+#include <iostream>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <ctime>
+#include <vector>
+
+#include <basic_toolkit/VectorD.h>
+#include <mxyzptlk/Jet.h>
+#include <mxyzptlk/Mapping.h>
+#include <mxyzptlk/MappingEvaluator.h>
+
+using namespace std;
+
+int main( int argc, char** argv )
+{
+ int order  = 5;
+ int n      = 100000;
+ int nturns = 3;
+
+ for( int i = 1; i < argc; ++i ) {
+   if      ( 0 == strcmp( argv[i], "-order" ) && i+1 < argc ) { order  = atoi( argv[++i] ); }
+   else if ( 0 == strcmp( argv[i], "-n"     ) && i+1 < argc ) { n      = atoi( argv[++i] ); }
+   else if ( 0 == strcmp( argv[i], "-turns" ) && i+1 < argc ) { nturns = atoi( argv[++i] ); }
+ }
+
+ int const dim = 6;
+
+ Jet__environment_ptr env = Jet__environment::makeJetEnvironment( order, dim, dim );
+ Jet__environment::pushEnv( env );
+
+ Mapping map( "identity", env );
+
+ for( int turn = 0; turn < nturns; ++turn ) {
+
+   Jet x = map[0], y = map[1], z = map[2], px = map[3], py = map[4], pz = map[5];
+
+   px = px - 0.3*( x*x - y*y ) - 0.05*sin(x)*z;
+   py = py + 0.6*x*y + 0.02*exp(y)*z*z;
+   pz = pz - 0.1*x*x*x;
+
+   map[0] =  0.6*x + 0.8*px;   map[3] = -0.8*x + 0.6*px;
+   map[1] =  0.8*y + 0.6*py;   map[4] = -0.6*y + 0.8*py;
+   map[2] =  z + 0.1*pz;       map[5] =  pz;
+ }
+
+ MappingEvaluator evaluator( map );
+
+ srand48( 12345 );
+
+ std::vector<std::vector<double> > coords( dim, std::vector<double>(n) );
+ for( int j = 0; j < n; ++j ) {
+   for( int i = 0; i < dim; ++i ) { coords[i][j] = 1.0e-2*( 2.0*drand48() - 1.0 ); }
+ }
+
+ // ----------------------------
+ // Mapping::operator()
+ // ----------------------------
+
+ std::vector<std::vector<double> > expected( coords );
+
+ clock_t start = clock();
+
+ Vector x( dim );
+ for( int j = 0; j < n; ++j ) {
+   for( int i = 0; i < dim; ++i ) { x[i] = coords[i][j]; }
+   Vector z = map( x );
+   for( int i = 0; i < dim; ++i ) { expected[i][j] = z[i]; }
+ }
+
+ double const tmap = double( clock() - start )/CLOCKS_PER_SEC;
+
+ // ----------------------------
+ // MappingEvaluator
+ // ----------------------------
+
+ std::vector<std::vector<double> > result( coords );
+ std::vector<double*> arrays( dim );
+ for( int i = 0; i < dim; ++i ) { arrays[i] = &result[i][0]; }
+
+ start = clock();
+
+ evaluator( &arrays[0], n );
+
+ double const teval = double( clock() - start )/CLOCKS_PER_SEC;
+
+ double maxdiff = 0.0;
+ for( int i = 0; i < dim; ++i ) {
+   for( int j = 0; j < n; ++j ) {
+     maxdiff = std::max( maxdiff, std::abs( result[i][j] - expected[i][j] )/std::max( 1.0, std::abs( expected[i][j] ) ) );
+   }
+ }
+
+ cout << "order " << order << ", " << evaluator.numTerms() << " terms, "
+      << evaluator.numMonomials() << " distinct monomials, " << n << " points" << endl;
+ cout << "Mapping::operator()     : " << 1.0e6*tmap/n  << " us/point" << endl;
+ cout << "MappingEvaluator (batch): " << 1.0e6*teval/n << " us/point" << endl;
+ cout << "speedup                 : " << tmap/teval << endl;
+ cout << "max relative difference : " << maxdiff << endl;
+
+ return 0;
+}
@@ -0,0 +1,227 @@
+/*************************************************************************
+**************************************************************************
+**************************************************************************
+******
+******  MXYZPTLK:  A C++ implementation of differential algebra.
+******
+******  File:      FixedJet.h
+******
+******  Copyright Fermi Research Alliance / Fermilab
+******            All Rights Reserved
+******
+******  Usage, modification, and redistribution are subject to terms
+******  of the License supplied with this software.
+******
+******  Software and documentation created under
+******  U.S. Department of Energy Contract No. DE-AC02-07CH11359
+******  The U.S. Government retains a world-wide non-exclusive,
+******  royalty-free license to publish or reproduce documentation
+******  and software for U.S. Government purposes. This software
+******  is protected under the U.S. and Foreign Copyright Laws.
+******
+******  Revision History
+******
+******  Oct 2026
+******
+******  - Initial version. A truncated power series whose order and
+******    number of variables are fixed at compile time.
+******
+**************************************************************************
+**************************************************************************
+*************************************************************************/
+
+// ==============================================================================
+//
+// FixedJet<Order,NVar,T> is a truncated power series in NVar variables,
+// truncated at (total) degree Order. Unlike TJet<T>, the number of
+// coefficients is known at compile time: the coefficients are stored in a
+// plain array that lives wherever the FixedJet lives (typically on the
+// stack) and no arithmetic operation allocates from the heap.
+//
+// All coefficients, including zeros, are stored; FixedJet is therefore
+// best suited to low orders (first and second order maps, chromaticity)
+// where TJet spends most of its time managing its sparse term lists.
+//
+// Monomials are ordered by weight; within a weight the ordering is
+// unspecified. The monomial index and multiplication tables are shared by
+// all FixedJets with the same (Order,NVar); they are built once, on first
+// use, and never modified afterwards.
+//
+// Coefficients are Taylor coefficients, as in TJet<T>. Conversions to and
+// from TJet<T> are explicit; the TJet environment must have NVar
+// variables. Terms beyond the target order are dropped.
+//
+// FixedJet provides arithmetic with scalars, sqrt, pow, exp, log, the
+// trigonometric and hyperbolic functions, asin, atan and standardPart(),
+// so that code templated on the component type can be evaluated with it.
+// It is a container only: there is no FixedJet particle type, and the
+// element propagators and the map extraction in BeamlineContext still
+// work with Jet.
+//
+// ==============================================================================
+
+#ifndef FIXEDJET_H
+#define FIXEDJET_H
+
+#include <complex>
+#include <iosfwd>
+#include <basic_toolkit/GenericException.h>
+#include <mxyzptlk/TJet.h>
+
+namespace fixedjet_detail {
+
+template<int N, int K>
+struct Binomial {
+  enum { value = ( Binomial<N-1,K-1>::value * N ) / K };
+};
+
+template<int N>
+struct Binomial<N,0> {
+  enum { value = 1 };
+};
+
+template<int B, int E>
+struct Power {
+  enum { value = B * Power<B,E-1>::value };
+};
+
+template<int B>
+struct Power<B,0> {
+  enum { value = 1 };
+};
+
+} // namespace fixedjet_detail
+
+
+template<int Order, int NVar, typename T = double>
+class FixedJet {
+
+ public:
+
+  enum { order   = Order,
+         numVar  = NVar,
+         size    = fixedjet_detail::Binomial<Order+NVar,NVar>::value }; // number of monomials of weight <= Order
+
+  FixedJet();
+  FixedJet( T const& value );
+
+  template<typename U>
+  FixedJet( FixedJet<Order,NVar,U> const& x );              // e.g. real to complex
+
+  explicit FixedJet( TJet<T> const& jet );
+
+  static FixedJet variable( int i, T const& value = T() );   // the i-th coordinate, expanded around value
+
+  TJet<T>  toJet( EnvPtr<T> const& env = TJetEnvironment<T>::topEnv() ) const;
+
+  T const& standardPart()               const  { return c_[0];  }
+  void     setStandardPart( T const& value )   { c_[0] = value; }
+
+  T const& operator[]( int idx )        const  { return c_[idx]; }  // coefficient of monomial idx
+  T&       operator[]( int idx )               { return c_[idx]; }
+
+  T        coefficient( int const* exponents ) const;               // zero if the monomial weight exceeds Order
+  T        derivative ( int i )             const;                  // first derivative w/r to variable i
+
+  // monomial tables
+
+  static int        index    ( int const* exponents ); // -1 if the monomial weight exceeds Order
+  static int const* exponents( int idx );
+  static int        weight   ( int idx );
+
+  // arithmetic
+
+  FixedJet& operator+=( FixedJet const& y );
+  FixedJet& operator-=( FixedJet const& y );
+  FixedJet& operator*=( FixedJet const& y );
+  FixedJet& operator/=( FixedJet const& y );
+
+  FixedJet& operator+=( T const& y )   { c_[0] += y; return *this; }
+  FixedJet& operator-=( T const& y )   { c_[0] -= y; return *this; }
+  FixedJet& operator*=( T const& y );
+  FixedJet& operator/=( T const& y );
+
+  FixedJet  operator-() const;
+
+  friend FixedJet operator+( FixedJet x, FixedJet const& y ) { return x += y; }
+  friend FixedJet operator-( FixedJet x, FixedJet const& y ) { return x -= y; }
+  friend FixedJet operator*( FixedJet const& x, FixedJet const& y ) { FixedJet z; multiply( x, y, z ); return z; }
+  friend FixedJet operator/( FixedJet const& x, FixedJet const& y ) { return x*reciprocal(y); }
+
+  friend FixedJet operator+( FixedJet x, T const& y ) { return x += y; }
+  friend FixedJet operator-( FixedJet x, T const& y ) { return x -= y; }
+  friend FixedJet operator*( FixedJet x, T const& y ) { return x *= y; }
+  friend FixedJet operator/( FixedJet x, T const& y ) { return x /= y; }
+
+  friend FixedJet operator+( T const& x, FixedJet y ) { return y += x; }
+  friend FixedJet operator-( T const& x, FixedJet const& y ) { FixedJet z = -y; return z += x; }
+  friend FixedJet operator*( T const& x, FixedJet y ) { return y *= x; }
+  friend FixedJet operator/( T const& x, FixedJet const& y ) { return reciprocal(y) *= x; }
+
+  // elementary functions. asin, acos and atan are available for T = double only.
+
+  friend FixedJet sqrt ( FixedJet const& x )              { return FixedJet::powSeries( x, 0.5 ); }
+  friend FixedJet pow  ( FixedJet const& x, double const& p ) { return FixedJet::powSeries( x, p ); }
+  friend FixedJet pow  ( FixedJet const& x, int n )       { return FixedJet::intPower( x, n );   }
+  friend FixedJet exp  ( FixedJet const& x )              { return FixedJet::expSeries( x );     }
+  friend FixedJet log  ( FixedJet const& x )              { return FixedJet::logSeries( x );     }
+  friend FixedJet sin  ( FixedJet const& x )              { return FixedJet::trigSeries( x, 0 ); }
+  friend FixedJet cos  ( FixedJet const& x )              { return FixedJet::trigSeries( x, 1 ); }
+  friend FixedJet tan  ( FixedJet const& x )              { return sin(x)/cos(x);                }
+  friend FixedJet sinh ( FixedJet const& x )              { return FixedJet::hypSeries( x, 0 );  }
+  friend FixedJet cosh ( FixedJet const& x )              { return FixedJet::hypSeries( x, 1 );  }
+  friend FixedJet asin ( FixedJet const& x )              { return FixedJet::asinNewton( x );    }
+  friend FixedJet acos ( FixedJet const& x )              { return T(M_PI/2.0) - asin(x);        }
+  friend FixedJet atan ( FixedJet const& x )              { return FixedJet::atanNewton( x );    }
+
+  friend FixedJet reciprocal( FixedJet const& x )         { return FixedJet::powSeries( x, -1.0 ); }
+
+  friend std::ostream& operator<<( std::ostream& os, FixedJet const& x ) { return x.print(os); }
+
+ private:
+
+  struct Tables {
+    Tables();
+    int exponents_[size][NVar];
+    int weight_[size];
+    int key_[size];                                      // exponents packed in base (Order+1)
+    int offset_[Order+2];                                // index of the first monomial of each weight
+    int index_[ fixedjet_detail::Power<Order+1,NVar>::value ]; // key -> monomial index
+  };
+
+  static Tables const& tables();
+
+  static void      multiply( FixedJet const& x, FixedJet const& y, FixedJet& z );
+  static FixedJet  series( FixedJet const& x, T const* d );   // sum_k d[k]*(x - x0)^k
+
+  static FixedJet  powSeries ( FixedJet const& x, double const& p );
+  static FixedJet  intPower  ( FixedJet const& x, int n );
+  static FixedJet  expSeries ( FixedJet const& x );
+  static FixedJet  logSeries ( FixedJet const& x );
+  static FixedJet  trigSeries( FixedJet const& x, int shift );
+  static FixedJet  hypSeries ( FixedJet const& x, int shift );
+  static FixedJet  asinNewton( FixedJet const& x );
+  static FixedJet  atanNewton( FixedJet const& x );
+
+  std::ostream& print( std::ostream& os ) const;
+
+  T c_[size];
+};
+
+
+// real and imaginary parts of a complex FixedJet
+
+template<int Order, int NVar>
+FixedJet<Order,NVar,double> real( FixedJet<Order,NVar,std::complex<double> > const& z );
+
+template<int Order, int NVar>
+FixedJet<Order,NVar,double> imag( FixedJet<Order,NVar,std::complex<double> > const& z );
+
+
+// FixedJet is header-only: its template parameters are chosen
+// by the application, so it cannot be explicitly instantiated
+// in the library.
+
+#include <mxyzptlk/FixedJet.tcc>
+
+#endif // FIXEDJET_H
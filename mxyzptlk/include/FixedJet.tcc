@@ -0,0 +1,583 @@
+/*************************************************************************
+**************************************************************************
+**************************************************************************
+******
+******  MXYZPTLK:  A C++ implementation of differential algebra.
+******
+******  File:      FixedJet.tcc
+******
+******  Copyright Fermi Research Alliance / Fermilab
+******            All Rights Reserved
+******
+******  Usage, modification, and redistribution are subject to terms
+******  of the License supplied with this software.
+******
+******  Software and documentation created under
+******  U.S. Department of Energy Contract No. DE-AC02-07CH11359
+******  The U.S. Government retains a world-wide non-exclusive,
+******  royalty-free license to publish or reproduce documentation
+******  and software for U.S. Government purposes. This software
+******  is protected under the U.S. and Foreign Copyright Laws.
+******
+**************************************************************************
+**************************************************************************
+*************************************************************************/
+
+#include <cmath>
+#include <ostream>
+#include <algorithm>
+#include <basic_toolkit/IntArray.h>
+
+
+//-----------------------------------------------------------------------------
+// Tables
+//-----------------------------------------------------------------------------
+
+template<int Order, int NVar, typename T>
+FixedJet<Order,NVar,T>::Tables::Tables()
+{
+  std::fill( index_, index_ + fixedjet_detail::Power<Order+1,NVar>::value, -1 );
+
+  // ------------------------------------------------------------
+  // Enumerate the monomials of each weight w by stepping through
+  // the exponent tuples e[0..NVar-1] with sum w, in reverse
+  // lexicographic order.
+  // ------------------------------------------------------------
+
+  int n = 0;
+
+  for ( int w=0; w <= Order; ++w ) {
+
+    offset_[w] = n;
+
+    int e[NVar];
+    std::fill( e, e+NVar, 0 );
+    e[0] = w;
+
+    while ( true ) {
+
+      int key   = 0;
+      int radix = 1;
+      for ( int i=0; i<NVar; ++i ) {
+        exponents_[n][i] = e[i];
+        key   += e[i]*radix;
+        radix *= (Order+1);
+      }
+      weight_[n]   = w;
+      key_[n]      = key;
+      index_[key]  = n;
+      ++n;
+
+      // next tuple: move one unit from the first nonzero exponent
+      // (below the last variable) to its right neighbour, and
+      // collect everything to its left back into e[0].
+
+      int i = 0;
+      while ( i < NVar-1 && e[i] == 0 ) ++i;
+      if ( i >= NVar-1 ) break;
+
+      int const carry = e[i] - 1;
+      e[i]    = 0;
+      e[i+1] += 1;
+      e[0]    = carry;
+    }
+  }
+
+  offset_[Order+1] = n;
+}
+
+//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+
+template<int Order, int NVar, typename T>
+typename FixedJet<Order,NVar,T>::Tables const& FixedJet<Order,NVar,T>::tables()
+{
+  // built on first use; the tables are never modified afterwards.
+  static Tables const tables_;
+  return tables_;
+}
+
+//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+
+template<int Order, int NVar, typename T>
+int FixedJet<Order,NVar,T>::index( int const* exponents )
+{
+  int key   = 0;
+  int radix = 1;
+  int w     = 0;
+  for ( int i=0; i<NVar; ++i ) {
+    w     += exponents[i];
+    key   += exponents[i]*radix;
+    radix *= (Order+1);
+  }
+  return ( w > Order ) ? -1 : tables().index_[key];
+}
+
+//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+
+template<int Order, int NVar, typename T>
+int const* FixedJet<Order,NVar,T>::exponents( int idx )
+{
+  return tables().exponents_[idx];
+}
+
+//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+
+template<int Order, int NVar, typename T>
+int FixedJet<Order,NVar,T>::weight( int idx )
+{
+  return tables().weight_[idx];
+}
+
+
+//-----------------------------------------------------------------------------
+// Constructors and conversions
+//-----------------------------------------------------------------------------
+
+template<int Order, int NVar, typename T>
+FixedJet<Order,NVar,T>::FixedJet()
+{
+  std::fill( c_, c_+size, T() );
+}
+
+//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+
+template<int Order, int NVar, typename T>
+FixedJet<Order,NVar,T>::FixedJet( T const& value )
+{
+  std::fill( c_, c_+size, T() );
+  c_[0] = value;
+}
+
+//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+
+template<int Order, int NVar, typename T>
+template<typename U>
+FixedJet<Order,NVar,T>::FixedJet( FixedJet<Order,NVar,U> const& x )
+{
+  for ( int k=0; k<size; ++k ) { c_[k] = T( x[k] ); }
+}
+
+//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+
+template<int Order, int NVar, typename T>
+FixedJet<Order,NVar,T>::FixedJet( TJet<T> const& jet )
+{
+  EnvPtr<T> env = jet.Env();
+
+  if ( env->numVar() != NVar ) {
+    throw GenericException( __FILE__, __LINE__,
+           "FixedJet<Order,NVar,T>::FixedJet( TJet<T> const& jet )",
+           "The number of variables of the Jet environment does not match NVar." );
+  }
+
+  std::fill( c_, c_+size, T() );
+
+  for ( typename TJet<T>::const_iterator it = jet.begin(); it != jet.end(); ++it ) {
+
+    if ( it->weight_ > Order ) continue;
+
+    IntArray const& exps = it->exponents( env );
+    int e[NVar];
+    std::copy( exps.begin(), exps.end(), e );
+
+    c_[ index(e) ] += it->value_;
+  }
+}
+
+//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+
+template<int Order, int NVar, typename T>
+TJet<T> FixedJet<Order,NVar,T>::toJet( EnvPtr<T> const& env ) const
+{
+  if ( env->numVar() != NVar ) {
+    throw GenericException( __FILE__, __LINE__,
+           "TJet<T> FixedJet<Order,NVar,T>::toJet( EnvPtr<T> const& env ) const",
+           "The number of variables of the Jet environment does not match NVar." );
+  }
+
+  Tables const& t = tables();
+
+  TJet<T> jet( c_[0], env );
+
+  int const maxidx = t.offset_[ std::min( Order, env->maxWeight() ) + 1 ];
+
+  for ( int k=1; k < maxidx; ++k ) {
+    if ( c_[k] == T() ) continue;
+    IntArray const exps( t.exponents_[k], t.exponents_[k] + NVar );  // IntArray caches its weight: do not reuse
+    jet.addTerm( TJLterm<T>( exps, c_[k], env ) );
+  }
+
+  return jet;
+}
+
+//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+
+template<int Order, int NVar, typename T>
+FixedJet<Order,NVar,T> FixedJet<Order,NVar,T>::variable( int i, T const& value )
+{
+  if ( i < 0 || i >= NVar ) {
+    throw GenericException( __FILE__, __LINE__,
+           "FixedJet<Order,NVar,T> FixedJet<Order,NVar,T>::variable( int i, T const& value )",
+           "Variable index out of range." );
+  }
+
+  FixedJet x( value );
+  if ( Order > 0 ) { x.c_[ 1 + i ] = T(1.0); }   // the first-order monomials are e_0 ... e_{NVar-1}
+  return x;
+}
+
+//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+
+template<int Order, int NVar, typename T>
+T FixedJet<Order,NVar,T>::coefficient( int const* exponents ) const
+{
+  int const idx = index( exponents );
+  return ( idx < 0 ) ? T() : c_[idx];
+}
+
+//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+
+template<int Order, int NVar, typename T>
+T FixedJet<Order,NVar,T>::derivative( int i ) const
+{
+  return ( Order > 0 ) ? c_[ 1 + i ] : T();
+}
+
+
+//-----------------------------------------------------------------------------
+// Arithmetic
+//-----------------------------------------------------------------------------
+
+template<int Order, int NVar, typename T>
+FixedJet<Order,NVar,T>& FixedJet<Order,NVar,T>::operator+=( FixedJet const& y )
+{
+  for ( int k=0; k<size; ++k ) { c_[k] += y.c_[k]; }
+  return *this;
+}
+
+//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+
+template<int Order, int NVar, typename T>
+FixedJet<Order,NVar,T>& FixedJet<Order,NVar,T>::operator-=( FixedJet const& y )
+{
+  for ( int k=0; k<size; ++k ) { c_[k] -= y.c_[k]; }
+  return *this;
+}
+
+//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+
+template<int Order, int NVar, typename T>
+FixedJet<Order,NVar,T>& FixedJet<Order,NVar,T>::operator*=( FixedJet const& y )
+{
+  FixedJet z;
+  multiply( *this, y, z );
+  return ( *this = z );
+}
+
+//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+
+template<int Order, int NVar, typename T>
+FixedJet<Order,NVar,T>& FixedJet<Order,NVar,T>::operator/=( FixedJet const& y )
+{
+  return ( *this *= reciprocal(y) );
+}
+
+//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+
+template<int Order, int NVar, typename T>
+FixedJet<Order,NVar,T>& FixedJet<Order,NVar,T>::operator*=( T const& y )
+{
+  for ( int k=0; k<size; ++k ) { c_[k] *= y; }
+  return *this;
+}
+
+//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+
+template<int Order, int NVar, typename T>
+FixedJet<Order,NVar,T>& FixedJet<Order,NVar,T>::operator/=( T const& y )
+{
+  if ( y == T() ) {
+    throw GenericException( __FILE__, __LINE__,
+           "FixedJet<Order,NVar,T>& FixedJet<Order,NVar,T>::operator/=( T const& y )",
+           "Attempt to divide by a scalar zero." );
+  }
+  for ( int k=0; k<size; ++k ) { c_[k] /= y; }
+  return *this;
+}
+
+//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+
+template<int Order, int NVar, typename T>
+FixedJet<Order,NVar,T> FixedJet<Order,NVar,T>::operator-() const
+{
+  FixedJet z;
+  for ( int k=0; k<size; ++k ) { z.c_[k] = -c_[k]; }
+  return z;
+}
+
+//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+
+template<int Order, int NVar, typename T>
+void FixedJet<Order,NVar,T>::multiply( FixedJet const& x, FixedJet const& y, FixedJet& z )
+{
+  // z must not alias x or y.
+  // The product of monomials i and j is the monomial whose packed
+  // key is key(i)+key(j); only products of weight <= Order are formed.
+
+  Tables const& t = tables();
+
+  for ( int i=0; i<size; ++i ) {
+
+    T const xi = x.c_[i];
+    if ( xi == T() ) continue;
+
+    int const  jmax = t.offset_[ Order - t.weight_[i] + 1 ];
+    int const  ki   = t.key_[i];
+
+    for ( int j=0; j<jmax; ++j ) {
+      z.c_[ t.index_[ ki + t.key_[j] ] ] += xi*y.c_[j];
+    }
+  }
+}
+
+
+//-----------------------------------------------------------------------------
+// Elementary functions.
+//
+// Each function f is evaluated as the truncated Taylor series
+//
+//      f(x) = sum_k d[k] * (x - x0)^k ,  d[k] = f^(k)(x0)/k!
+//
+// where x0 is the standard part of x. (x - x0) is nilpotent so the
+// series is exact to order Order.
+//-----------------------------------------------------------------------------
+
+template<int Order, int NVar, typename T>
+FixedJet<Order,NVar,T> FixedJet<Order,NVar,T>::series( FixedJet const& x, T const* d )
+{
+  FixedJet h( x );
+  h.c_[0] = T();
+
+  FixedJet z( d[Order] );   // Horner's rule
+  for ( int k=Order-1; k >= 0; --k ) {
+    z *= h;
+    z.c_[0] += d[k];
+  }
+  return z;
+}
+
+//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+
+template<int Order, int NVar, typename T>
+FixedJet<Order,NVar,T> FixedJet<Order,NVar,T>::powSeries( FixedJet const& x, double const& p )
+{
+  T const x0 = x.c_[0];
+
+  if ( x0 == T() ) {
+    throw GenericException( __FILE__, __LINE__,
+           "FixedJet<Order,NVar,T> FixedJet<Order,NVar,T>::powSeries( FixedJet const& x, double const& p )",
+           "The standard part of the argument is zero." );
+  }
+
+  T d[Order+1];
+  d[0] = std::pow( x0, p );
+  for ( int k=1; k <= Order; ++k ) {
+    d[k] = d[k-1] * ( (p - (k-1)) / k ) / x0;    // binomial coefficients (p k) x0^(p-k)
+  }
+  return series( x, d );
+}
+
+//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+
+template<int Order, int NVar, typename T>
+FixedJet<Order,NVar,T> FixedJet<Order,NVar,T>::intPower( FixedJet const& x, int n )
+{
+  if ( n < 0 ) return intPower( reciprocal(x), -n );
+
+  FixedJet z( T(1.0) );
+  FixedJet b( x );
+
+  while ( n > 0 ) {
+    if ( n & 1 ) { z *= b; }
+    n >>= 1;
+    if ( n > 0 ) { b *= b; }
+  }
+  return z;
+}
+
+//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+
+template<int Order, int NVar, typename T>
+FixedJet<Order,NVar,T> FixedJet<Order,NVar,T>::expSeries( FixedJet const& x )
+{
+  T d[Order+1];
+  d[0] = std::exp( x.c_[0] );
+  for ( int k=1; k <= Order; ++k ) {
+    d[k] = d[k-1] / double(k);
+  }
+  return series( x, d );
+}
+
+//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+
+template<int Order, int NVar, typename T>
+FixedJet<Order,NVar,T> FixedJet<Order,NVar,T>::logSeries( FixedJet const& x )
+{
+  T const x0 = x.c_[0];
+
+  if ( x0 == T() ) {
+    throw GenericException( __FILE__, __LINE__,
+           "FixedJet<Order,NVar,T> FixedJet<Order,NVar,T>::logSeries( FixedJet const& x )",
+           "The standard part of the argument is zero." );
+  }
+
+  T d[Order+1];
+  d[0] = std::log( x0 );
+
+  T u = T(1.0);
+  for ( int k=1; k <= Order; ++k ) {
+    u   /= x0;
+    d[k] = ( (k%2) ? u : -u ) / double(k);     // (-1)^(k+1)/(k x0^k)
+  }
+  return series( x, d );
+}
+
+//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+
+template<int Order, int NVar, typename T>
+FixedJet<Order,NVar,T> FixedJet<Order,NVar,T>::trigSeries( FixedJet const& x, int shift )
+{
+  // shift = 0: sin, shift = 1: cos.
+  // The derivatives of sin cycle through sin, cos, -sin, -cos.
+
+  T const s = std::sin( x.c_[0] );
+  T const c = std::cos( x.c_[0] );
+  T const cycle[4] = { s, c, -s, -c };
+
+  T d[Order+1];
+  double f = 1.0;
+  for ( int k=0; k <= Order; ++k ) {
+    if ( k > 0 ) f *= k;
+    d[k] = cycle[ (k+shift)%4 ] / f;
+  }
+  return series( x, d );
+}
+
+//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+
+template<int Order, int NVar, typename T>
+FixedJet<Order,NVar,T> FixedJet<Order,NVar,T>::hypSeries( FixedJet const& x, int shift )
+{
+  // shift = 0: sinh, shift = 1: cosh.
+
+  T const s = std::sinh( x.c_[0] );
+  T const c = std::cosh( x.c_[0] );
+  T const cycle[2] = { s, c };
+
+  T d[Order+1];
+  double f = 1.0;
+  for ( int k=0; k <= Order; ++k ) {
+    if ( k > 0 ) f *= k;
+    d[k] = cycle[ (k+shift)%2 ] / f;
+  }
+  return series( x, d );
+}
+
+//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+
+template<int Order, int NVar, typename T>
+FixedJet<Order,NVar,T> FixedJet<Order,NVar,T>::asinNewton( FixedJet const& x )
+{
+  // Newton iterations on sin(z) = x, starting from the exact
+  // standard part. Each iteration doubles the number of correct
+  // orders.
+
+  FixedJet z( std::asin( x.c_[0] ) );
+
+  for ( int n=1; n <= Order; n *= 2 ) {
+    z += ( x - sin(z) ) / cos(z);
+  }
+  return z;
+}
+
+//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+
+template<int Order, int NVar, typename T>
+FixedJet<Order,NVar,T> FixedJet<Order,NVar,T>::atanNewton( FixedJet const& x )
+{
+  // Newton iterations on tan(z) = x; see asinNewton.
+
+  FixedJet z( std::atan( x.c_[0] ) );
+
+  for ( int n=1; n <= Order; n *= 2 ) {
+    FixedJet const c = cos(z);
+    z += ( x*c - sin(z) )*c;
+  }
+  return z;
+}
+
+//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+
+template<int Order, int NVar, typename T>
+std::ostream& FixedJet<Order,NVar,T>::print( std::ostream& os ) const
+{
+  Tables const& t = tables();
+
+  os << "FixedJet<" << Order << "," << NVar << ">" << std::endl;
+  for ( int k=0; k<size; ++k ) {
+    if ( c_[k] == T() ) continue;
+    os << "(";
+    for ( int i=0; i<NVar; ++i ) { os << ( i ? "," : "" ) << t.exponents_[k][i]; }
+    os << ") " << c_[k] << std::endl;
+  }
+  return os;
+}
+
+//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+
+template<int Order, int NVar>
+FixedJet<Order,NVar,double> real( FixedJet<Order,NVar,std::complex<double> > const& z )
+{
+  FixedJet<Order,NVar,double> x;
+  for ( int k=0; k < FixedJet<Order,NVar,double>::size; ++k ) { x[k] = std::real( z[k] ); }
+  return x;
+}
+
+//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+
+template<int Order, int NVar>
+FixedJet<Order,NVar,double> imag( FixedJet<Order,NVar,std::complex<double> > const& z )
+{
+  FixedJet<Order,NVar,double> x;
+  for ( int k=0; k < FixedJet<Order,NVar,double>::size; ++k ) { x[k] = std::imag( z[k] ); }
+  return x;
+}
@@ -34,6 +34,7 @@
 
 #include <boost/intrusive_ptr.hpp>
 #include <basic_toolkit/globaldefs.h>
+#include <mxyzptlk/JetStatistics.h>
 
 template<typename T>
 class TJL1;
@@ -58,7 +59,12 @@ class DLLEXPORT JLPtr: public boost::intrusive_ptr<TJL<T> >
   explicit JLPtr(TJL<T>* p, bool add_ref=true):     boost::intrusive_ptr<TJL<T> >(p,add_ref) {}
 
   template<class OtherType> 
-  JLPtr ( OtherType const & r):                     boost::intrusive_ptr<TJL<T> >(r) {} 
+  JLPtr ( OtherType const & r):                     boost::intrusive_ptr<TJL<T> >(r) { MXYZPTLK_STAT( JetStatistics::jlPtrCopied() ); } 
+
+#ifdef MXYZPTLK_STATISTICS
+  JLPtr( JLPtr const& r ):                          boost::intrusive_ptr<TJL<T> >(r) { JetStatistics::jlPtrCopied(); }
+  JLPtr& operator=( JLPtr const& r )                { boost::intrusive_ptr<TJL<T> >::operator=(r); JetStatistics::jlPtrCopied(); return *this; }
+#endif
 
   int count()  const                                { return this->get()->count(); }
 };
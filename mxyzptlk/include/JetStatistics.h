@@ -0,0 +1,145 @@
+/*************************************************************************
+**************************************************************************
+**************************************************************************
+******
+******  MXYZPTLK:  A C++ implementation of differential algebra.
+******
+******  File:      JetStatistics.h
+******
+******  Copyright Fermi Research Alliance / Fermilab
+******            All Rights Reserved
+******
+******  Usage, modification, and redistribution are subject to terms
+******  of the License supplied with this software.
+******
+******  Software and documentation created under
+******  U.S. Department of Energy Contract No. DE-AC02-07CH11359
+******  The U.S. Government retains a world-wide non-exclusive,
+******  royalty-free license to publish or reproduce documentation
+******  and software for U.S. Government purposes. This software
+******  is protected under the U.S. and Foreign Copyright Laws.
+******
+******  Revision History
+******
+******  Oct 2026
+******
+******  - Initial version.
+******
+**************************************************************************
+**************************************************************************
+*************************************************************************/
+
+// ==============================================================================
+//
+// Allocation statistics for the jet (TJL) recycling pools and term stores.
+//
+// The counters are collected only when mxyzptlk is compiled with
+// MXYZPTLK_STATISTICS defined (configure --enable-statistics). Otherwise
+// the hooks compile to nothing, enabled() returns false and all the
+// counters stay at zero. JLPtr copies are counted in the code that makes
+// them; client code must also be compiled with MXYZPTLK_STATISTICS for
+// its own copies to be counted.
+//
+// Each thread updates its own counters without locking. The totals add
+// up the counters of all the threads that have used jets, including
+// threads that have exited; they are exact when the other threads are
+// idle. The term store memory (live and peak bytes) is global.
+//
+// The per-environment breakdown is keyed by the shape of the environment
+// (real or complex, number of variables, maximum weight), since this is
+// what determines the size of the term stores.
+//
+// To measure an operation (e.g. the propagation through one element),
+// take the difference of two snapshots:
+//
+//    JetStatistics::Counters const before = JetStatistics::thread();
+//    elm.propagate( jp );
+//    JetStatistics::Counters const used   = JetStatistics::thread() - before;
+//
+// ==============================================================================
+
+#ifndef JETSTATISTICS_H
+#define JETSTATISTICS_H
+
+#include <iosfwd>
+#include <vector>
+#include <cstddef>
+#include <basic_toolkit/globaldefs.h>
+
+#ifdef MXYZPTLK_STATISTICS
+#define MXYZPTLK_STAT( statement )  statement
+#else
+#define MXYZPTLK_STAT( statement )
+#endif
+
+class DLLEXPORT JetStatistics {
+
+ public:
+
+  struct DLLEXPORT Counters {
+
+    Counters();
+
+    unsigned long jlNew;              // TJL objects allocated because the recycling pool was empty
+    unsigned long jlRecycled;         // TJL objects taken from the recycling pool
+    unsigned long jlDiscarded;        // TJL objects returned to the recycling pool
+    unsigned long jlDeleted;          // TJL objects freed (on thread exit)
+    unsigned long poolHighWater;      // largest size reached by a recycling pool
+    unsigned long storeAllocations;   // term stores allocated (including regrowths)
+    unsigned long storeRegrowths;     // term stores doubled because they were full
+    unsigned long storeBytes;         // total size of the term stores allocated
+    unsigned long jlPtrCopies;        // JLPtr copy constructions and assignments
+
+    double        poolHitRate() const;   // jlRecycled/(jlNew+jlRecycled)
+
+    Counters& operator+=( Counters const& rhs );
+    Counters& operator-=( Counters const& rhs );   // poolHighWater is not subtracted
+  };
+
+  struct DLLEXPORT EnvironmentCounters {
+
+    EnvironmentCounters();
+
+    bool          complex;            // TJL<std::complex<double> >
+    int           numVar;
+    int           maxWeight;
+
+    unsigned long jets;               // TJL objects made (new or recycled)
+    unsigned long storeAllocations;
+    unsigned long storeRegrowths;
+    unsigned long storeBytes;
+  };
+
+  static bool     enabled();
+
+  static Counters thread();                              // calling thread
+  static Counters total();                               // all threads
+
+  static std::vector<EnvironmentCounters> environments();   // all threads, sorted by shape
+
+  static std::size_t liveStoreBytes();                   // term store memory in use (including the recycling pools)
+  static std::size_t peakStoreBytes();                   // high-water mark of liveStoreBytes()
+
+  static void     reset();                               // zeroes all counters; the peak is set to the live memory
+  static void     report( std::ostream& os );
+
+  // ---- hooks, called by TJL, JLPtr
+
+  static void jlMade( bool recycled, bool complex, int numVar, int maxWeight );
+  static void jlDiscarded( std::size_t poolsize );
+  static void jlDeleted( std::size_t n );
+  static void storeAllocated( std::size_t bytes, bool regrowth, bool complex, int numVar, int maxWeight );
+  static void storeAllocated( std::size_t bytes );       // environment unknown
+  static void storeReleased( std::size_t bytes );
+  static void jlPtrCopied();
+
+ private:
+
+  JetStatistics();
+};
+
+DLLEXPORT JetStatistics::Counters operator-( JetStatistics::Counters const& lhs, JetStatistics::Counters const& rhs );
+
+DLLEXPORT std::ostream& operator<<( std::ostream& os, JetStatistics::Counters const& c );
+
+#endif // JETSTATISTICS_H
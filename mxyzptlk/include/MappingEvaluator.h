@@ -0,0 +1,114 @@
+/*************************************************************************
+**************************************************************************
+**************************************************************************
+******
+******  MXYZPTLK:  A C++ implementation of differential algebra.
+******
+******  File:      MappingEvaluator.h
+******
+******  Copyright Fermi Research Alliance / Fermilab
+******            All Rights Reserved
+******
+******  Usage, modification, and redistribution are subject to terms
+******  of the License supplied with this software.
+******
+******  Software and documentation created under
+******  U.S. Department of Energy Contract No. DE-AC02-07CH11359
+******  The U.S. Government retains a world-wide non-exclusive,
+******  royalty-free license to publish or reproduce documentation
+******  and software for U.S. Government purposes. This software
+******  is protected under the U.S. and Foreign Copyright Laws.
+******
+******  Revision History
+******
+******  Oct 2026
+******
+******  - Initial version.
+******
+**************************************************************************
+**************************************************************************
+*************************************************************************/
+
+// ==============================================================================
+//
+// A MappingEvaluator is a "compiled" form of a Mapping, intended for
+// tracking large numbers of particles through a (one-turn) Taylor map.
+//
+// Evaluating a Mapping with Mapping::operator()( Vector ) evaluates
+// each component separately; every component walks its own term list
+// and recomputes all the monomials up to its weight.
+//
+// The evaluator is built once. It keeps
+//
+//  - the union of the monomials appearing in any component, in order
+//    of increasing weight, each one stored as (parent monomial, variable)
+//    so that it costs a single multiplication;
+//  - for each component, the list of (monomial, coefficient) pairs.
+//
+// Particles are evaluated in blocks: the monomials of a block are formed
+// once and shared by all the components. All inner loops run over the
+// particles of the block, over contiguous arrays, and are vectorizable.
+//
+// The batch interface takes the coordinates as a structure of arrays:
+// coords[i][j] is coordinate i of particle j (e.g. the arrays of a
+// BunchArrays).
+//
+// A MappingEvaluator does not refer to the Mapping or to its environment
+// once constructed. Evaluation is const and does not use shared scratch
+// space, so an evaluator can be used concurrently by several threads.
+//
+// ==============================================================================
+
+#ifndef MAPPINGEVALUATOR_H
+#define MAPPINGEVALUATOR_H
+
+#include <vector>
+#include <basic_toolkit/globaldefs.h>
+#include <basic_toolkit/VectorD.h>
+#include <mxyzptlk/Mapping.h>
+
+class DLLEXPORT MappingEvaluator {
+
+ public:
+
+  explicit MappingEvaluator( Mapping const& map );
+
+  int  dim()          const { return dim_;  }   // number of components (outputs)
+  int  numVar()       const { return nvar_; }   // number of variables  (inputs)
+  int  numMonomials() const { return nmono_; }  // distinct monomials of weight >= 1
+  int  numTerms()     const { return termMono_.size(); }
+
+  Vector operator()( Vector const& x ) const;
+
+  // batch evaluation of n particles
+
+  void operator()( double const* const* in, double* const* out, int n ) const;
+  void operator()( double* const* coords, int n ) const;  // in place; requires dim() == numVar()
+
+  static int const blockSize = 64;  // particles per block
+
+ private:
+
+  void evaluateBlock( double const* const* in, int first, int m, double* const* out, double* work ) const;
+
+  int                    dim_;
+  int                    nvar_;
+  int                    nmono_;
+
+  std::vector<double>    refPoint_;
+
+  // monomial k (k >= nvar_) = monomial parent_[k] * u[ var_[k] ];
+  // monomials 0 ... nvar_-1 are the variables u[i] = x[i] - refPoint_[i]
+
+  std::vector<int>       parent_;
+  std::vector<int>       var_;
+
+  // terms of component i are [ termBegin_[i], termBegin_[i+1] )
+
+  std::vector<double>    constant_;
+  std::vector<int>       termBegin_;
+  std::vector<int>       termMono_;
+  std::vector<double>    termCoeff_;
+};
+
+#endif // MAPPINGEVALUATOR_H
@@ -0,0 +1,148 @@
+/*************************************************************************
+**************************************************************************
+**************************************************************************
+******
+******  MXYZPTLK:  A C++ implementation of differential algebra.
+******
+******  File:      MonomialTables.h
+******
+******  Copyright Fermi Research Alliance / Fermilab
+******            All Rights Reserved
+******
+******  Usage, modification, and redistribution are subject to terms
+******  of the License supplied with this software.
+******
+******  Software and documentation created under
+******  U.S. Department of Energy Contract No. DE-AC02-07CH11359
+******  The U.S. Government retains a world-wide non-exclusive,
+******  royalty-free license to publish or reproduce documentation
+******  and software for U.S. Government purposes. This software
+******  is protected under the U.S. and Foreign Copyright Laws.
+******
+******  Revision History
+******
+******  Oct 2026
+******
+******  - Initial version.
+******
+**************************************************************************
+**************************************************************************
+*************************************************************************/
+
+// ==============================================================================
+//
+// MonomialTables holds the read-only tables of a jet environment with a
+// given maximum weight and number of variables:
+//
+//  - the exponents of the monomials, in the order of their offsets (by
+//    weight, then in reverse lexicographic order);
+//  - the offsets of the groups of monomials of the same weight;
+//  - the monomial multiplication table: multRow(i)[j] is the offset of
+//    the product of monomials i and j, for j < rowLength(i).
+//
+// The tables do not depend on the scalar type, the reference point or the
+// scaling of the environment. All the (real and complex) environments with
+// the same maximum weight and number of variables share one instance.
+//
+// Filling the multiplication table dominates the cost of creating an
+// environment, and its size grows quickly with the order (5 MB at order 11
+// in 6 variables). get() therefore looks in two stores before building
+// the tables:
+//
+//  - memory:  the tables used so far in this process.
+//  - disk:    one file per (maxWeight, numVar) in a user defined directory.
+//             The multiplication table is memory-mapped, not read: only the
+//             pages actually used are loaded, and processes using the same
+//             file share them. The directory is taken from the environment
+//             variable CHEF_JET_TABLES, or set with setDirectory(). If it is
+//             empty, the disk store is not used.
+//
+// Tables built by get() are written to the disk store under a temporary
+// name, then renamed, so that another process never maps a partially
+// written file. A file written with another format version, on a machine
+// with a different byte order, or whose monomial ordering does not match
+// the one of this library is rejected and replaced.
+//
+// ==============================================================================
+
+#ifndef MONOMIALTABLES_H
+#define MONOMIALTABLES_H
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <boost/cstdint.hpp>
+#include <boost/shared_ptr.hpp>
+#include <basic_toolkit/globaldefs.h>
+#include <basic_toolkit/IntArray.h>
+
+class DLLEXPORT MonomialTables {
+
+ public:
+
+  static boost::uint32_t const format_version;
+
+  static boost::shared_ptr<MonomialTables const> get( int maxWeight, int numVar );
+
+  static void         setDirectory( std::string const& dir );   // "" disables the disk store
+  static std::string  directory();
+  static std::string  fileName( std::string const& dir, int maxWeight, int numVar );
+
+  static void         clear();     // empties the memory store; the tables in use are not affected
+  static int          built();     // tables built by get() since the last clear()
+  static int          loaded();    // tables mapped by get() since the last clear()
+
+  MonomialTables( int maxWeight, int numVar );                  // builds the tables
+  explicit MonomialTables( std::string const& filename );       // maps a file written by write()
+ ~MonomialTables();
+
+  void write( std::string const& filename ) const;
+
+  int  maxWeight()  const { return maxWeight_; }
+  int  numVar()     const { return numVar_;    }
+  int  maxTerms()   const { return maxTerms_;  }
+  bool isMapped()   const { return map_ != 0;  }
+
+  IntArray const& exponents( int offset )   const { return exponents_[offset];              }
+  int             weight( int offset )      const { return exponents_[offset].Sum();        }
+  int             weightOffset( int w )     const { return weightOffsets_[w];               }  // w = 0 ... maxWeight()+1
+  int const*      multRow( int offset )     const { return mult_ + rowStart_[offset];       }
+  int             rowLength( int offset )   const { return rowStart_[offset+1] - rowStart_[offset]; }
+
+  int             multOffset( int i, int j ) const;
+  int             offsetIndex( IntArray const& exp ) const;
+
+ private:
+
+  MonomialTables( MonomialTables const& );
+  MonomialTables& operator=( MonomialTables const& );
+
+  struct Header;
+
+  void index();         // fills exponents_, weightOffsets_ and rowStart_
+
+  int                        maxWeight_;
+  int                        numVar_;
+  int                        maxTerms_;
+
+  std::vector<IntArray>      exponents_;
+  std::vector<int>           weightOffsets_;
+  std::vector<std::size_t>   rowStart_;       // start of each row of the multiplication table; maxTerms_+1 entries
+
+  std::vector<int>           multData_;       // the multiplication table, when built
+  int const*                 mult_;           //   points to multData_ or to the mapped file
+
+  void*                      map_;
+  std::size_t                size_;
+};
+
+//-----------------------------------------------------------------------------------
+// inline members
+//-----------------------------------------------------------------------------------
+
+inline int MonomialTables::multOffset( int i, int j ) const
+{
+  return ( j < rowLength(i) ) ? multRow(i)[j] : multRow(j)[i];
+}
+
+#endif // MONOMIALTABLES_H
@@ -90,10 +90,12 @@
 #include <mxyzptlk/JLPtr.h>
 #include <mxyzptlk/EnvPtr.h>
 #include <mxyzptlk/TJLterm.h>
+#include <mxyzptlk/JetStatistics.h>
 
 #include<boost/iterator/iterator_facade.hpp>
 #include<boost/iterator/reverse_iterator.hpp>
 #include <vector>
+#include <boost/thread/tss.hpp>
 
 // |||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
 // |||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
@@ -339,6 +341,13 @@ friend class TJL;
   template< typename const_iterator_t>
   JLPtr<T> compose(  const_iterator_t itb, const_iterator_t ite ) const; //  Jet composition operator  
 
+  // Composition of n jets with the same argument: z[k] = x[k]( y ), k = 0 ... n-1.
+  // The monomials of the argument are computed once, for all the jets; with 
+  // nthreads > 1, the monomials of each weight, then the results, are shared 
+  // among nthreads threads.
+
+  static void compose( TJL<T> const* const* x, int n, std::vector<JLPtr<T> > const& y, JLPtr<T>* z, int nthreads = 1 ); 
+
   TJL& operator=( TJL const& );
   TJL& operator=( T   const& );
 
@@ -480,12 +489,29 @@ friend class TJL;
   TJLterm<T>*                         jltermStoreCurrentPtr_;
   int                                 jltermStoreCapacity_;
 
-  static std::vector<TJL<T>*  >&      thePool_;                  // TJL<T> objects recycling pool.  
+  static boost::thread_specific_ptr<std::vector<TJL<T>* > >&  pools_;   // TJL<T> objects recycling pools (one per thread).  
+
+  static std::vector<TJL<T>* >&  thePool();                      // recycling pool of the calling thread
+  static void                    releasePool( std::vector<TJL<T>* >* pool );  // called on thread exit
 
 
   void initStore(int capacity);      // setup and initialize the jlterm store 
 
   void transferFromScratchPad();     // transfer result from scratchpad into current TJL   
+  void transferFromDense( T* coeffs, int maxweight ); // same, from a dense array of coefficients (zeroed on exit)
+
+  // dense multiplication backend 
+
+  static bool useDense( TJL<T> const& x, TJL<T> const& y );
+  static void multiplyDense( TJL<T> const& x, TJL<T> const& y, int testWeight, T* product ); 
+
+  // composition backend 
+
+  struct Composition;
+
+  static void     composeWork( Composition const& c, int first, int stride ); 
+  JLPtr<T>        composeFromMonomials( std::vector<JLPtr<T> > const& monomials, EnvPtr<T> const& env ) const; 
+
   void append( TJLterm<T>  const&);  
 
   TJL( EnvPtr<T> const&,  T value = T() );
@@ -546,7 +572,11 @@ inline void TJL<T>::discardTJL( TJL<T>* p)
 
    p->myEnv_ = nullEnv; // nullify the environment. 
 
-   thePool_.push_back(p);
+   std::vector<TJL<T>* >& pool = thePool();
+
+   pool.push_back(p);
+
+   MXYZPTLK_STAT( JetStatistics::jlDiscarded( pool.size() ) );
 
 }
 
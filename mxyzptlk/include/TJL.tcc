@@ -100,6 +100,11 @@
 #include <basic_toolkit/iosetup.h>
 #include <basic_toolkit/utils.h>             // misc utils: nexcom(), bcfRec(), nearestInteger() ...  
 #include <basic_toolkit/GenericException.h>
+#include <basic_toolkit/WorkerPool.h>
+
+#include <boost/thread.hpp>
+#include <boost/type_traits/is_complex.hpp>
+#include <boost/bind.hpp>
 
 #include <cstring> // for memmove
 
@@ -122,10 +127,34 @@ template<typename T>
 const int TJL<T>::mx_maxiter_  = 100;          // Maximum number of iterations allowed  
                                               //  in iterative routines (e.g. transcendental functions)
 
-// ******  a global container for discarded Jets. 
+// ******  containers for discarded Jets, one for each thread. 
+
+template <typename T> 
+boost::thread_specific_ptr<std::vector<TJL<T>* > >& TJL<T>::pools_ 
+        = *( new boost::thread_specific_ptr<std::vector<TJL<T>* > >( &TJL<T>::releasePool ) ); 
 
 template <typename T> 
-std::vector<TJL<T>* >& TJL<T>::thePool_ = *( new std::vector<TJL<T>* > ); 
+std::vector<TJL<T>* >& TJL<T>::thePool()
+{
+  std::vector<TJL<T>* >* pool = pools_.get();
+
+  if ( !pool ) { 
+    pool = new std::vector<TJL<T>* >();
+    pools_.reset( pool );
+  }
+  return *pool;
+}
+
+template <typename T> 
+void TJL<T>::releasePool( std::vector<TJL<T>* >* pool )
+{
+  MXYZPTLK_STAT( JetStatistics::jlDeleted( pool->size() ) );
+
+  for ( typename std::vector<TJL<T>* >::iterator it = pool->begin(); it != pool->end(); ++it ) {
+    delete *it;
+  }
+  delete pool;
+}
 
 
 // ================================================================
@@ -257,6 +286,15 @@ void TJL<T>::initStore( int capacity) {
   jltermStore_            = TJLterm<T>::array_allocate( jltermStoreCapacity_ ); 
   jltermStoreCurrentPtr_  = jltermStore_;
 
+#ifdef MXYZPTLK_STATISTICS
+  if ( myEnv_ ) { 
+    JetStatistics::storeAllocated( capacity*sizeof(TJLterm<T>), false, boost::is_complex<T>::value, myEnv_->numVar(), myEnv_->maxWeight() ); 
+  }
+  else {  // environment not set 
+    JetStatistics::storeAllocated( capacity*sizeof(TJLterm<T>) ); 
+  }
+#endif
+
 }
 
 
@@ -285,9 +323,13 @@ JLPtr<T> TJL<T>::makeTJL( EnvPtr<T> const& pje, T x )
 
   if (!pje) return JLPtr<T>();  // this form is called by TCoord and Tparam
 
-  if (thePool_.empty() ) return (  JLPtr<T>(new  TJL<T>(pje, x ) )); 
+  std::vector<TJL<T>* >& pool = thePool();
+
+  MXYZPTLK_STAT( JetStatistics::jlMade( !pool.empty(), boost::is_complex<T>::value, pje->numVar(), pje->maxWeight() ) );
+
+  if (pool.empty() ) return (  JLPtr<T>(new  TJL<T>(pje, x ) )); 
  
-  TJL<T>* p    = thePool_.back();  thePool_.pop_back();
+  TJL<T>* p    = pool.back();  pool.pop_back();
   p->count_    = 0;
   p->weight_   = 0;
   p->accuWgt_  = pje->maxWeight();
@@ -346,9 +388,13 @@ template<typename T>
 
   if (!pje) return JLPtr<T>();  // cannot create a TJL without a properly constructed environemnt 
 
-  if (thePool_.empty() ) return  JLPtr<T>( new TJL<T>(e,x,pje) );
+  std::vector<TJL<T>* >& pool = thePool();
 
-  TJL<T>* p = thePool_.back(); thePool_.pop_back();
+  MXYZPTLK_STAT( JetStatistics::jlMade( !pool.empty(), boost::is_complex<T>::value, pje->numVar(), pje->maxWeight() ) );
+
+  if (pool.empty() ) return  JLPtr<T>( new TJL<T>(e,x,pje) );
+
+  TJL<T>* p = pool.back(); pool.pop_back();
 
   p->count_     = 0;
   p->weight_    = 0;
@@ -409,13 +455,20 @@ template<typename U>
 JLPtr<T>  TJL<T>::makeTJL( TJL<U> const& x )
 {
 
-  if (thePool_.empty() ) 
+  std::vector<TJL<T>* >& pool = thePool();
+
+  MXYZPTLK_STAT( JetStatistics::jlMade( !pool.empty(), boost::is_complex<T>::value, x.myEnv_->numVar(), x.myEnv_->maxWeight() ) );
+
+  if (pool.empty() ) 
      return  JLPtr<T>(new TJL<T>(x));
  
-  TJL<T>* p = thePool_.back(); thePool_.pop_back(); 
+  TJL<T>* p = pool.back(); pool.pop_back(); 
   
+  p->myEnv_    = x.myEnv_;   // set first: initStore() records the environment
+
   if (p->jltermStoreCapacity_ < x.jltermStoreCapacity_)  
   { 
+       MXYZPTLK_STAT( JetStatistics::storeReleased( p->jltermStoreCapacity_*sizeof(TJLterm<T>) ) );
        TJLterm<T>::array_deallocate( p->jltermStore_ );
        p->initStore(x.jltermStoreCapacity_);   
   
@@ -425,7 +478,6 @@ JLPtr<T>  TJL<T>::makeTJL( TJL<U> const& x )
   p->weight_   = x.weight_;  
   p->accuWgt_  = x.accuWgt_;
   p->lowWgt_   = x.lowWgt_;
-  p->myEnv_    = x.myEnv_;
  
    memcpy( p->jltermStore_, x.jltermStore_, (x.jltermStoreCurrentPtr_-x.jltermStore_)*sizeof(TJLterm<T>) );
    p->jltermStoreCurrentPtr_ = p->jltermStore_ + (x.jltermStoreCurrentPtr_ - x.jltermStore_);
@@ -441,6 +493,7 @@ TJL<T>::~TJL()
 {
  clear();
  TJLterm<T>::array_deallocate( jltermStore_ );
+ MXYZPTLK_STAT( JetStatistics::storeReleased( jltermStoreCapacity_*sizeof(TJLterm<T>) ) );
 
  jltermStore_         = jltermStoreCurrentPtr_ = 0;
  jltermStoreCapacity_ = 0;
@@ -470,6 +523,11 @@ int         old_jltermStoreCapacity   = 0;
 
     jltermStoreCapacity_ *= 2;  // double the capacity
     jltermStore_ = jltermStoreCurrentPtr_ = TJLterm<T>::array_allocate( jltermStoreCapacity_ );
+
+#ifdef MXYZPTLK_STATISTICS
+    JetStatistics::storeReleased( old_jltermStoreCapacity*sizeof(TJLterm<T>) ); 
+    JetStatistics::storeAllocated( jltermStoreCapacity_*sizeof(TJLterm<T>), true, boost::is_complex<T>::value, myEnv_->numVar(), myEnv_->maxWeight() ); 
+#endif
  
 
     memcpy( jltermStore_, old_jltermStore, (old_jltermStoreCurrentPtr-old_jltermStore )*sizeof(TJLterm<T>) );
@@ -824,80 +882,248 @@ T TJL<T>::evaluate( const_iterator_t itb, const_iterator_t ite) const
 template <typename T>
 template <typename const_iterator_t>
 JLPtr<T> TJL<T>::compose(  const_iterator_t itb, const_iterator_t ite ) const //  Jet composition operator  
+{
+ std::vector<JLPtr<T> > y;
+
+ for( const_iterator_t it = itb; it != ite; ++it ) { 
+   y.push_back( *it ); 
+ }
+
+ TJL<T> const* x = this;
+ JLPtr<T>      z;
+
+ compose( &x, 1, y, &z );
+
+ return z;
+}
+
+// |||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+// |||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+template <typename T>
+struct TJL<T>::Composition {
+
+  TJL<T> const* const*               x;           // the jets composed 
+  int                                n; 
+  JLPtr<T>*                          z;           // the results 
+
+  std::vector<JLPtr<T> >             u;           // the argument, minus the reference point 
+  std::vector<JLPtr<T> >*            monomials;   // indexed by offset; only the needed ones are computed 
+  std::vector<int>                   parent;      // monomial[i] = u[factor[i]]*monomial[parent[i]] 
+  std::vector<int>                   factor;
+  std::vector<std::vector<int> >     levels;      // offsets of the needed monomials, by weight 
+
+  int                                step;        // 1 ... levels.size()-1: a weight; levels.size(): the results 
+};
+
+// |||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+// |||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+template <typename T>
+void TJL<T>::compose( TJL<T> const* const* x, int n, std::vector<JLPtr<T> > const& y, JLPtr<T>* z, int nthreads ) 
 {
 
  //-------------------------------------------------
  //  **** Composition operator ****
  //-------------------------------------------------
 
- std::vector<JLPtr<T> > u( myEnv_->numVar() );
+ if ( n < 1 ) return;
+
+ EnvPtr<T> const& env = x[0]->myEnv_;  // indexes the monomials of the jets composed 
+
+ int const nvar = env->numVar();
+
+ if( int( y.size() ) != nvar ) {
+   throw( GenericException( __FILE__, __LINE__, 
+          "void TJL<T>::compose( TJL<T> const* const* x, int n, std::vector<JLPtr<T> > const& y, JLPtr<T>* z, int nthreads )",
+          "Incompatible dimensions." ) );
+ }
+
+ Composition c;
+
+ c.x = x;
+ c.n = n;
+ c.z = z;
 
  //------------------------------------------------
  // Check consistency of reference points and
  // subtract reference point prior to concatenation.
  //-------------------------------------------------
 
- int i = 0;
- for( const_iterator_t it = itb; it != ite; ++it, ++i) {
-   if(  (*it)->getEnv() !=   (*itb)->getEnv() ) {
+ c.u.resize( nvar );
+
+ for( int i=0; i < nvar; ++i ) {
+   if(  y[i]->getEnv() != y[0]->getEnv() ) {
       throw( GenericException( __FILE__, __LINE__, 
-             "TJL<T>::compose(  const_iterator_t itb, const_iterator_t ite ) const ",
+             "void TJL<T>::compose( TJL<T> const* const* x, int n, std::vector<JLPtr<T> > const& y, JLPtr<T>* z, int nthreads )",
              "Inconsistent environments." ) );
     }
- 
-
-    u[i] =  (*it) + JLPtr<T>( makeTJL( (*it)->getEnv(), -( (*it)->getEnv()->refPoint()[i] ) ) ); // u[i] = y[i] - myEnv_->refPoint()[i];
+    c.u[i] =  y[i] + JLPtr<T>( makeTJL( y[i]->getEnv(), -( y[i]->getEnv()->refPoint()[i] ) ) ); // u[i] = y[i] - refPoint[i];
  }
 
+ //------------------------------------------------------------
+ // The monomials needed are those with a non-zero coefficient 
+ // in one of the jets, up to the weight computed accurately, 
+ // and the lower weight ones from which they are built.    
+ //------------------------------------------------------------
 
- std::vector<JLPtr<T> >& tjlmonomial = myEnv_->TJLmonomial(); // for monomials used in multinomial evaluation.  
+ int weight = 0;
 
- // -----------------------------
- // Evaluate and store monomials.
- // -----------------------------
+ for ( int k=0; k<n; ++k ) {
+   if(  x[k]->myEnv_ != env ) {
+      throw( GenericException( __FILE__, __LINE__, 
+             "void TJL<T>::compose( TJL<T> const* const* x, int n, std::vector<JLPtr<T> > const& y, JLPtr<T>* z, int nthreads )",
+             "Inconsistent environments." ) );
+   }
+   weight = std::max( weight, x[k]->weight_ );
+ }
 
- // The zeroth one ...
+ int const maxterms = bcfRec( weight + nvar, nvar );
 
- tjlmonomial[0] = JLPtr<T>(makeTJL( u[0]->myEnv_, ((T) 1.0) ));
+ std::vector<int> needed( maxterms, 0 );
 
- // For all weights higher than 0 ...
- // Get the next set of exponents of weight w.
+ for ( int k=0; k<n; ++k ) {
+   for(  TJLterm<T> const* p = x[k]->jltermStore_; p < x[k]->jltermStoreCurrentPtr_; ++p  ) {
+     if( p->weight_ > x[k]->accuWgt_ ) break;
+     if( p->value_ != T() ) needed[ p->offset_ ] = 1;
+   }
+ }
 
- int const maxterms = bcfRec( weight_ + myEnv_->numVar(), myEnv_->numVar() );
+ // The monomial of a composition is the product of u[i] with the monomial
+ // of the same composition less one in its first non-zero exponent. 
 
- for ( int idx=1; idx<maxterms; ++idx) {
+ c.parent.resize( maxterms, 0 );
+ c.factor.resize( maxterms, 0 );
+ c.levels.resize( weight+1 );
 
-   IntArray exponents = myEnv_->exponents(idx);
+ for ( int idx=maxterms-1; idx>0; --idx) {
 
-   // Find the first non-zero exponent.
+   if ( !needed[idx] ) continue;
+
+   IntArray exponents = env->exponents(idx);
 
    IntArray::iterator p = std::find_if( exponents.begin(), exponents.end(), std::bind2nd( std::not_equal_to<int>(),0 ) ); 
    int i =  std::distance( exponents.begin(), p );
- 
-   // The value of the monomial associated with this composition
-   // is obtained by multiplying a factor into a previously
-   // computed monomial.
 
    --exponents[i];
-   JLPtr<T> term = tjlmonomial[ myEnv_->offsetIndex( exponents ) ];
-   ++exponents[i];
 
-   tjlmonomial[ myEnv_->offsetIndex( exponents )] = u[i]*term; 
-   
- } 
- 
+   c.parent[idx]          = env->offsetIndex( exponents );
+   c.factor[idx]          = i;
+   needed[ c.parent[idx] ] = 1;
+
+   c.levels[ env->weight(idx) ].push_back( idx );
+ }
+
+ c.monomials = &env->TJLmonomial();  // scratch area of the calling thread 
+
+ (*c.monomials)[0] = JLPtr<T>( makeTJL( c.u[0]->myEnv_, ((T) 1.0) ) );
+
+ //------------------------------------------------------------
+ // The monomials of weight w depend only on those of weight 
+ // w-1: each weight is shared among the tasks, and is a 
+ // separate run of the shared worker pool. The results are
+ // the last step. Within a task of the pool, the tasks are 
+ // run by the calling thread, one after the other.  
+ //------------------------------------------------------------
+
+ // A small composition is done by the calling thread alone: 
+ // handing it to the pool would cost more than the work itself. 
+
+ int const min_parallel_monomials = 100;
+
+ int maxtasks   = n;
+ int nmonomials = 0;
+ for ( int w=1; w <= weight; ++w ) { 
+   maxtasks    = std::max( maxtasks, int( c.levels[w].size() ) ); 
+   nmonomials += c.levels[w].size(); 
+ }
+
+ if ( nmonomials < min_parallel_monomials ) { nthreads = 1; } 
+
+ nthreads = std::max( 1, std::min( nthreads, maxtasks ) );
+
+ if ( nthreads == 1 ) {
+   for ( c.step=1; c.step <= weight+1; ++c.step ) { composeWork( c, 0, 1 ); }
+   return;
+ }
+
+ std::vector<WorkerPool::Task> tasks( nthreads );
+
+ for ( int j=0; j<nthreads; ++j ) {
+   tasks[j] = boost::bind( &TJL<T>::composeWork, boost::cref(c), j, nthreads );
+ }
+
+ for ( c.step=1; c.step <= weight+1; ++c.step ) { 
+   WorkerPool::instance().run( tasks );  // rethrows the first exception of a task
+ }
+}
+
+// |||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+// |||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+template <typename T>
+void TJL<T>::composeWork( Composition const& c, int first, int stride ) 
+{
+ std::vector<JLPtr<T> >& monomials = *c.monomials;
+
+ if ( c.step < int( c.levels.size() ) ) {
+
+   std::vector<int> const& level = c.levels[c.step];
+
+   for ( int j=first; j < int( level.size() ); j += stride ) {
+     int const idx  = level[j];
+     monomials[idx] = c.u[ c.factor[idx] ] * monomials[ c.parent[idx] ];
+   }
+   return;
+ }
+
  // -----------------------------------------------
  // Monomials have been stored.
- // Now traverse the TJL<T> variable and evaluate.
+ // Now traverse the TJL<T> variables and evaluate.
  //------------------------------------------------
- 
- JLPtr<T> z( makeTJL(u[0]->myEnv_) ); 
 
- for(  TJLterm<T> const* p = jltermStore_; p< jltermStoreCurrentPtr_; ++p  ) {
-    if( p->weight_ > accuWgt_ ) break;
-    z = z + ( tjlmonomial[ p->offset_ ] *  (p->value_) ); 
+ for ( int k=first; k < c.n; k += stride ) {
+   c.z[k] = c.x[k]->composeFromMonomials( monomials, c.u[0]->myEnv_ );
+ }
+}
+
+// |||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+// |||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+template <typename T>
+JLPtr<T> TJL<T>::composeFromMonomials( std::vector<JLPtr<T> > const& monomials, EnvPtr<T> const& env ) const 
+{
+ //-------------------------------------------------------------------
+ // The terms are accumulated in the dense scratch area of the calling 
+ // thread: no temporary jet is created. 
+ //-------------------------------------------------------------------
+
+ std::vector<T>& sum = env->denseProduct();  // zeroed between uses 
+
+ int weight  = 0;
+ int accuWgt = env->maxWeight();
+
+ for(  TJLterm<T> const* p = jltermStore_; p < jltermStoreCurrentPtr_; ++p  ) {
+
+   if( p->weight_ > accuWgt_ ) break;
+   if( p->value_ == T() ) continue;
+
+   TJL<T> const& m     = *monomials[ p->offset_ ];
+   T      const  value = p->value_;
+
+   for(  TJLterm<T> const* q = m.jltermStore_; q < m.jltermStoreCurrentPtr_; ++q  ) {
+     sum[ q->offset_ ] += value * q->value_;
+   }
+
+   weight  = std::max( weight,  m.weight_  );
+   accuWgt = std::min( accuWgt, m.accuWgt_ );
  } 
- 
+
+ JLPtr<T> z( makeTJL( env ) ); 
+
+ z->transferFromDense( &sum[0], weight );
+ z->accuWgt_ = accuWgt;
+
  return z;
 }
 
@@ -1190,6 +1416,10 @@ TJL<T>& TJL<T>::operator=( TJL<T> const& x )  {
      if ( jltermStoreCapacity_ < x.jltermStoreCapacity_ )  {
           old_jltermStore = jltermStore_;
           jltermStore_ = jltermStoreCurrentPtr_ =  TJLterm<T>::array_allocate(x.jltermStoreCapacity_);
+#ifdef MXYZPTLK_STATISTICS
+          JetStatistics::storeReleased( jltermStoreCapacity_*sizeof(TJLterm<T>) );
+          JetStatistics::storeAllocated( x.jltermStoreCapacity_*sizeof(TJLterm<T>), false, boost::is_complex<T>::value, myEnv_->numVar(), myEnv_->maxWeight() );
+#endif
           jltermStoreCapacity_ = x.jltermStoreCapacity_;
      };
       memcpy( jltermStore_, x.jltermStore_, (x.jltermStoreCurrentPtr_-x.jltermStore_)*sizeof(TJLterm<T>) );
@@ -1238,6 +1468,10 @@ TJL<T>& TJL<T>::operator=( TJL<T> const& x )  {
   if ( jltermStoreCapacity_ < x.jltermStoreCapacity_ )  {
           old_jltermStore = jltermStore_;
           jltermStore_ = jltermStoreCurrentPtr_ =  TJLterm<T>::array_allocate(x.jltermStoreCapacity_);
+#ifdef MXYZPTLK_STATISTICS
+          JetStatistics::storeReleased( jltermStoreCapacity_*sizeof(TJLterm<T>) );
+          JetStatistics::storeAllocated( x.jltermStoreCapacity_*sizeof(TJLterm<T>), false, boost::is_complex<T>::value, myEnv_->numVar(), myEnv_->maxWeight() );
+#endif
           jltermStoreCapacity_ = x.jltermStoreCapacity_;
   };
 
@@ -1296,6 +1530,7 @@ template<typename T>
 JLPtr<T>& operator-=( JLPtr<T>& lhs, T const& x ) 
 {   
   lhs->jltermStore_->value_ -= x; 
+  return lhs;
 }
 
 //||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
@@ -2314,6 +2549,21 @@ typedef typename TJL<T>::const_iterator const_iterator;
    return z;
  }
  
+ //-------------------------------------------------------------------------------
+ // If the operands are mostly filled, use the dense kernel.
+ //-------------------------------------------------------------------------------
+
+ if ( TJL<T>::useDense( *x, *y ) ) {
+
+   std::vector<T>& product = pje->denseProduct();
+
+   TJL<T>::multiplyDense( *x, *y, testWeight, &product[0] );
+
+   z->transferFromDense( &product[0], testWeight );
+   z->accuWgt_ = testWeight;
+   return z;
+ }
+
  //  -----------------------------------------------------------------
  //  Loop over the terms and accumulate monomials in the scrach pad.
  //  Use direct sequential access to access terms since order is
@@ -2434,13 +2684,29 @@ typedef typename TJL<T>::const_iterator const_iterator;
    return x;
  }
 
+ EnvPtr<T> pje(x->myEnv_);
+
+ //-------------------------------------------------------------------------------
+ // If the operands are mostly filled, use the dense kernel.
+ //-------------------------------------------------------------------------------
+
+ if ( TJL<T>::useDense( *x, *y ) ) {
+
+   std::vector<T>& product = pje->denseProduct();
+
+   TJL<T>::multiplyDense( *x, *y, testWeight, &product[0] );
+
+   x->transferFromDense( &product[0], testWeight );
+   x->accuWgt_ = testWeight;
+   return x;
+ }
+
  //  -----------------------------------------------------------------
  //  Loop over the terms and accumulate monomials in the scratch pad.
  //  Use direct sequential access to access terms since order is
  //  immaterial here.
  //  ------------------------------------------------------------------ 
  
- EnvPtr<T> pje(x->myEnv_);
 
  std::vector<TJLterm<T> >& tjlmml =  x->myEnv_->TJLmml(); // the environment scratchpad
 
@@ -2674,6 +2940,142 @@ void TJL<T>::transferFromScratchPad() {
 //|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
 //|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
 
+template <typename T>
+void TJL<T>::transferFromDense( T* coeffs, int maxweight ) {   
+
+  //---------------------------------------------------------------------
+  // coeffs is indexed by monomial offset; terms of weight > maxweight 
+  // are assumed to be zero. Coefficients smaller than mx_small_ are 
+  // dropped.
+  //---------------------------------------------------------------------
+
+  clear();
+
+  int const numvar = myEnv_->numVar();
+
+  appendLinearTerms( numvar );                      
+
+  // *Unconditionally* set the std part and the linear terms
+
+  for( int i=0; i < numvar+1; ++i) {
+     jltermStore_[i].value_ = coeffs[i];
+     coeffs[i] = T();
+  }
+
+  // then the non-linear terms, one weight group at a time
+
+  for( int w=2; w <= maxweight; ++w ) {
+
+    int const end = myEnv_->weight_offset(w+1);
+
+    for( int i = myEnv_->weight_offset(w); i < end; ++i ) {
+
+      if ( coeffs[i] == T() ) continue;
+
+      if ( std::abs( coeffs[i] ) >= mx_small_ ) { 
+        append( TJLterm<T>( coeffs[i], i, w ) );
+      }
+      coeffs[i] = T();
+    }
+  }
+
+  const_iterator itend = end();
+
+  lowWgt_ = 0; 
+  for( iterator it=begin();  it != itend; ++it) {
+     if ( it->value_ != T() ) { 
+        lowWgt_ = it->weight_; 
+  	break;
+      } 
+  }
+
+  weight_ = ( begin() == itend ) ? 0 : ( itend-1 )->weight_;
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+template <typename T>
+bool TJL<T>::useDense( TJL<T> const& x, TJL<T> const& y ) 
+{
+  //--------------------------------------------------------------------------
+  // The dense kernel pays for every monomial of the denser operand, whether 
+  // it is present or not; it wins when most of them are.   
+  //--------------------------------------------------------------------------
+
+  TJetEnvironment<T> const& env = *x.myEnv_;
+
+  double const xfill = double( x.count_ ) / env.weight_offset( x.weight_+1 );
+  double const yfill = double( y.count_ ) / env.weight_offset( y.weight_+1 );
+
+  return ( std::max( xfill, yfill ) >= TJetEnvironment<T>::denseThreshold() );
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+template <typename T>
+void TJL<T>::multiplyDense( TJL<T> const& x, TJL<T> const& y, int testWeight, T* product ) 
+{
+
+  //--------------------------------------------------------------------------
+  // Accumulates the product of x and y, truncated at testWeight, into the 
+  // dense array product (indexed by monomial offset).  
+  //
+  // The denser operand is expanded into a dense array a[]. For each term 
+  // (i, c) of the other operand, its contribution is then 
+  //
+  //    product[ row_i[j] ] += c * a[j],   j = 0 ... weight_offset( testWeight - weight(i) + 1 ) 
+  //  
+  // where row_i is the monomial multiplication table row of i. Terms of the 
+  // same weight thus run over the same contiguous range of a[]; the inner 
+  // loop has no weight test and no table search. Since the map j -> row_i[j] 
+  // is one-to-one, the iterations of the inner loop are independent.    
+  //--------------------------------------------------------------------------
+
+  TJetEnvironment<T> const& env = *x.myEnv_;
+
+  double const xfill = double( x.count_ ) / env.weight_offset( x.weight_+1 );
+  double const yfill = double( y.count_ ) / env.weight_offset( y.weight_+1 );
+
+  TJL<T> const& sparse = ( xfill < yfill ) ? x : y;
+  TJL<T> const& dense  = ( xfill < yfill ) ? y : x;
+
+  std::vector<T>& a = env.denseCoeffs();
+
+  for( const_iterator it = dense.begin(); it != dense.end(); ++it ) {
+    a[it->offset_] = it->value_;
+  }
+
+  int const maxj = std::min( dense.weight_, testWeight );
+
+  T const* const pa = &a[0];
+
+  for( const_iterator it = sparse.begin(); it != sparse.end(); ++it ) {
+
+    if ( it->weight_ > testWeight ) continue; 
+
+    T const c = it->value_; 
+    if ( c == T() ) continue;
+
+    int const        n   = env.weight_offset( std::min( maxj, testWeight - it->weight_ ) + 1 ); 
+    int const* const row = env.multRow( it->offset_ );
+
+    for( int j=0; j < n; ++j ) {
+      product[ row[j] ] += c * pa[j]; 
+    }
+  }
+
+  // leave the operand buffer zeroed for the next use 
+
+  for( const_iterator it = dense.begin(); it != dense.end(); ++it ) {
+    a[it->offset_] = T();
+  }
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
 template <typename T>
 void TJL<T>::appendLinearTerms( int numvar ) {   
 
@@ -45,6 +45,7 @@
 #include <basic_toolkit/ReferenceCounter.h>
 #include <gms/FastPODAllocator.h>
 #include <vector>
+#include <boost/thread/tss.hpp>
 #include <mxyzptlk/JLPtr.h>
 #include <mxyzptlk/EnvPtr.h>
 #include <mxyzptlk/TJLterm.h>
@@ -394,7 +395,10 @@ class TJL1: public ReferenceCounter<TJL1<T> > {
 
 
 
-  static std::vector<TJL1<T>* > thePool_;  // pool of discarded TJL1 objects
+  static boost::thread_specific_ptr<std::vector<TJL1<T>* > >&  pools_;  // pools of discarded TJL1 objects (one per thread)
+
+  static std::vector<TJL1<T>* >&  thePool();                     // pool of the calling thread
+  static void                     releasePool( std::vector<TJL1<T>* >* pool );  // called on thread exit
 
   void insert( TJLterm<T> const& );
   void append( TJLterm<T> const& );
@@ -58,7 +58,29 @@ using FNAL::pcout;
 
 
 template <typename T>
-std::vector<TJL1<T>* > TJL1<T>::thePool_; 
+boost::thread_specific_ptr<std::vector<TJL1<T>* > >& TJL1<T>::pools_ 
+        = *( new boost::thread_specific_ptr<std::vector<TJL1<T>* > >( &TJL1<T>::releasePool ) ); 
+
+template <typename T> 
+std::vector<TJL1<T>* >& TJL1<T>::thePool()
+{
+  std::vector<TJL1<T>* >* pool = pools_.get();
+
+  if ( !pool ) { 
+    pool = new std::vector<TJL1<T>* >();
+    pools_.reset( pool );
+  }
+  return *pool;
+}
+
+template <typename T> 
+void TJL1<T>::releasePool( std::vector<TJL1<T>* >* pool )
+{
+  for ( typename std::vector<TJL1<T>* >::iterator it = pool->begin(); it != pool->end(); ++it ) {
+    delete *it;
+  }
+  delete pool;
+}
 
 
 // ***************************************************************
@@ -103,10 +125,12 @@ JL1Ptr<T>  TJL1<T>::makeTJL( EnvPtr<T> const& pje, T x )
 
   if (!pje) return JL1Ptr<T>(); // this form is called by ONLY by Tcoord and Tparam
 
-  if (thePool_.empty() ) 
+  std::vector<TJL1<T>* >& pool = thePool();
+
+  if (pool.empty() ) 
      return (JL1Ptr<T>( new  TJL1<T>(pje, x )) ); 
  
-  TJL1<T>* p   = thePool_.back();  thePool_.pop_back();
+  TJL1<T>* p   = pool.back();  pool.pop_back();
 
   if ( p->count_  != pje->numVar()+1 ) {
       
@@ -189,10 +213,12 @@ JL1Ptr<T> TJL1<T>::makeTJL( const IntArray& e, const T& x, EnvPtr<T> const& pje
  };
 
 
-  if (thePool_.empty() ) 
+  std::vector<TJL1<T>* >& pool = thePool();
+
+  if (pool.empty() ) 
       return JL1Ptr<T>( new TJL1<T>(e,x,pje) );
 
-  TJL1<T>* p = thePool_.back(); thePool_.pop_back();
+  TJL1<T>* p = pool.back(); pool.pop_back();
 
   if (p->count_  != pje->numVar()+1 ) {
       delete [] p->terms_; 
@@ -243,11 +269,13 @@ template<typename U>
 JL1Ptr<T> TJL1<T>::makeTJL( TJL1<U> const& x )
 {
 
-  if (thePool_.empty() ) {
+  std::vector<TJL1<T>* >& pool = thePool();
+
+  if (pool.empty() ) {
      return JL1Ptr<T>( new TJL1<T>(x) );
   }
   
-  TJL1<T>* p = thePool_.back(); thePool_.pop_back(); 
+  TJL1<T>* p = pool.back(); pool.pop_back(); 
   
   if ( p->count_  != x.myEnv_->numVar()+1) {
       delete [] p->terms_; 
@@ -317,7 +345,7 @@ void TJL1<T>::discardTJL( TJL1<T>* p)
 {
   
    p->myEnv_ =   EnvPtr<T>();  // nullify the environment. 
-   thePool_.push_back(p); 
+   thePool().push_back(p); 
 
 }
 
@@ -65,6 +65,9 @@
 #include <ostream>
 #include <boost/functional/hash/hash.hpp>
 #include <boost/pool/pool.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/tss.hpp>
+#include <vector>
 #include <basic_toolkit/IntArray.h>
 #include <mxyzptlk/EnvPtr.h>
 
@@ -131,7 +134,31 @@ class DLLEXPORT TJLterm
 
   private:
 
-  static boost::pool<>&  ordered_memPool_;  // an ordered pool of TJLterms
+  //----------------------------------------------------------------------
+  // Each thread allocates from its own ordered pool of TJLterms. An array
+  // may be freed by another thread; the pool it came from is recorded in 
+  // the extra block that precedes it. When a thread exits, its pool is 
+  // kept (arrays allocated from it may still be in use) and handed over 
+  // to the next thread that needs one.   
+  //----------------------------------------------------------------------
+
+  struct MemPool { 
+    MemPool(): pool_( sizeof(TJLterm<T>), 2048 ) {}
+    boost::mutex   mutex_;   
+    boost::pool<>  pool_;      // an ordered pool of TJLterms
+  };
+
+  struct ArrayHeader {         // stored in the extra block 
+    int       size_;           // no of blocks, including the header block  
+    MemPool*  pool_;           // owner 
+  };
+
+  static MemPool&  memPool();                    // pool of the calling thread
+  static void      releaseMemPool( MemPool* p ); // called on thread exit
+
+  static boost::thread_specific_ptr<MemPool>&  memPools_;
+  static std::vector<MemPool*>&                freeMemPools_;  // pools no longer owned by a thread
+  static boost::mutex&                         freeMemPoolsMutex_;
   
   // the declarations below are meant to prevent use of all forms of operator new[];
 
@@ -63,6 +63,7 @@
 
 #include <basic_toolkit/iosetup.h>
 #include <basic_toolkit/GenericException.h>
+#include <boost/static_assert.hpp>
 
 using FNAL::pcerr;
 using FNAL::pcout;
@@ -73,7 +74,15 @@ using FNAL::pcout;
 //
 
 template <typename T>
-boost::pool<>&  TJLterm<T>::ordered_memPool_ = *( new boost::pool<>( sizeof(TJLterm<T>), 2048 ));
+boost::thread_specific_ptr<typename TJLterm<T>::MemPool>&  TJLterm<T>::memPools_ 
+               = *( new boost::thread_specific_ptr<typename TJLterm<T>::MemPool>( &TJLterm<T>::releaseMemPool ) );
+
+template <typename T>
+std::vector<typename TJLterm<T>::MemPool*>&  TJLterm<T>::freeMemPools_ 
+               = *( new std::vector<typename TJLterm<T>::MemPool*>() );
+
+template <typename T>
+boost::mutex&  TJLterm<T>::freeMemPoolsMutex_ = *( new boost::mutex() );
 
 
 // ***************************************************************
@@ -110,6 +119,40 @@ TJLterm<T>::TJLterm(  T const& x, int const& offset, int const& weight )
 // |||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
 
 
+template<typename T>
+typename TJLterm<T>::MemPool& TJLterm<T>::memPool() 
+{
+  MemPool* p = memPools_.get();
+
+  if ( p ) return *p;
+
+  {
+    boost::mutex::scoped_lock lock( freeMemPoolsMutex_ );
+    if ( !freeMemPools_.empty() ) { 
+      p = freeMemPools_.back();
+      freeMemPools_.pop_back();
+    }
+  }
+
+  if ( !p ) p = new MemPool();
+
+  memPools_.reset(p);
+  return *p;
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+template<typename T>
+void TJLterm<T>::releaseMemPool( MemPool* p ) 
+{
+  boost::mutex::scoped_lock lock( freeMemPoolsMutex_ );
+  freeMemPools_.push_back(p);
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
 template<typename T>
 TJLterm<T>* TJLterm<T>::array_allocate(int n) {
 
@@ -123,12 +166,21 @@ TJLterm<T>* TJLterm<T>::array_allocate(int n) {
 #else 
 // -----------------------------------------------------------------------
 // This code allocates an extra block and uses it to store the array size
+// and the pool it was allocated from.
 //------------------------------------------------------------------------   
-    TJLterm<T>* p = 
-     static_cast<TJLterm<T>*>(ordered_memPool_.ordered_malloc( n+1 ));
-     int * psize = (int *) p;
-     *psize = n+1;
-     ++p;
+    BOOST_STATIC_ASSERT( sizeof(ArrayHeader) <= sizeof(TJLterm<T>) );
+
+    MemPool& pool = memPool();
+
+    TJLterm<T>* p = 0;
+    {
+      boost::mutex::scoped_lock lock( pool.mutex_ );
+      p = static_cast<TJLterm<T>*>(pool.pool_.ordered_malloc( n+1 ));
+    }
+    ArrayHeader* header = (ArrayHeader*) p;
+    header->size_ = n+1;
+    header->pool_ = &pool;
+    ++p;
 #endif
 
     return p;
@@ -145,11 +197,15 @@ void TJLterm<T>::array_deallocate(TJLterm<T>* p)
     free(p);
 #else 
 // --------------------------------------------------------------------------------------------------
-// This code deallocates an array of blocks assuming that the size has been stored in an extra block
+// This code deallocates an array of blocks assuming that the size and the owning pool have been 
+// stored in an extra block
 //---------------------------------------------------------------------------------------------------   
       --p;
-      int*  psize = (int *) p;
-      ordered_memPool_.ordered_free( p, *psize ); 
+      ArrayHeader* header = (ArrayHeader*) p;
+      MemPool&     pool   = *header->pool_;
+
+      boost::mutex::scoped_lock lock( pool.mutex_ );
+      pool.pool_.ordered_free( p, header->size_ ); 
 #endif
 
 }
@@ -90,6 +90,9 @@ class TJetVector;
 template<typename T> 
 class TLieOperator;
 
+template<typename T> 
+class TMapping;
+
 TJet<double> fabs( TJet<double>                const& );
 
 TJet<double> real( TJet<std::complex<double> > const& );
@@ -325,6 +328,8 @@ class TJet: public gms::FastAllocator  {
 
   friend class TLieOperator<T>;
 
+  friend class TMapping<T>;
+
   friend struct  JetToJL;       // an adaptable unary function used for transform_iterators   
 
 
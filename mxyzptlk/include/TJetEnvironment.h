@@ -58,6 +58,16 @@
 ****** - added STL compatible monomial term iterators   
 ****** - eliminated dependence on class Cascade 
 ******    
+******  Oct 2026 
+****** - scratchpads are now per-thread: the read-only tables of a 
+******   ScratchArea remain shared, but the work areas used while 
+******   multiplying and concatenating jets are allocated lazily 
+******   for each thread. Creation and disposal of environments 
+******   are serialized. 
+****** - the monomial index and multiplication tables are now held by 
+******   MonomialTables, shared by the real and complex scratch areas
+******   and optionally memory-mapped from a file. 
+******    
 *************************************************************************
 *************************************************************************/
 #ifndef TJETENV_H
@@ -71,7 +81,11 @@
 #include <list>
 #include <ostream>
 #include <istream>
+#include <boost/thread/tss.hpp>
+#include <boost/thread/recursive_mutex.hpp>
+#include <boost/shared_ptr.hpp>
 #include <basic_toolkit/ReferenceCounter.h>
+#include <mxyzptlk/MonomialTables.h>
 
 // Forward declarations
 
@@ -128,24 +142,45 @@ class DLLEXPORT TJetEnvironment: public ReferenceCounter<TJetEnvironment<T> > {
  
 template <typename U>
 struct ScratchArea { 
+
+    //----------------------------------------------------------------------
+    // Work areas. These are modified during computations; each thread 
+    // gets its own copy, allocated the first time it is needed.
+    //----------------------------------------------------------------------
+
+    struct Buffers { 
+      std::vector<U>                   monomial_;       // Storage area for monomials used in multinomial evaluation. 
+      std::vector<JLPtr<U> >           TJLmonomial_;    // Storage area for TJL monomials used in concatenation.
+      std::vector<TJLterm<U> >         TJLmml_;         // Same as above, but used for collecting terms
+                                                        //   during multiplication.
+      std::vector<U>                   denseCoeffs_;    // Dense (offset-addressed) coefficients of an operand
+      std::vector<U>                   denseProduct_;   //   and of the product, used by the dense multiplication 
+                                                        //   kernel. Both are kept zeroed between uses.   
+      Buffers( ScratchArea const& );
+    };
+
+    //----------------------------------------------------------------------
+    // Read-only tables, shared by all threads. The monomial exponents and 
+    // the multiplication table are shared with the scratch areas of the 
+    // other scalar type (see MonomialTables). 
+    //----------------------------------------------------------------------
+
     int                                maxWeight_;
     int                                numVar_;
     int                                maxTerms_;       // Maximum number of monomial terms.
-    std::vector<U>                     monomial_;       // Storage area for monomials used in multinomial evaluation. 
-    std::vector<JLPtr<U> >             TJLmonomial_;    // Storage area for TJL monomials used in concatenation.
-    std::vector<TJLterm<U> >           TJLmml_;         // Same as above, but used for collecting terms
-                                                        //   during multiplication.
-    std::vector<IntArray>              index_table_;    // table of monomial exponents ( offset = ordering index)  
-    std::vector<std::vector<int> >     multTable_;      // monomial multiplication table 
-    std::vector<int>                   weight_offsets_; // Offsets of the weights groups within the scratchpad     
+    std::vector<TJLterm<U> >           TJLmml_;         // Empty (zero-valued) scratchpad; the thread work areas
+                                                        //   are copies of it.  
+    boost::shared_ptr<MonomialTables const>  tables_;   // monomial exponents ( offset = ordering index), offsets of the
+                                                        //   weight groups and monomial multiplication table 
 
    ScratchArea( TJetEnvironment<U>* pje, int weight, int numvar);
   ~ScratchArea();
  
-   int  multOffset( int const& rhs, int const& lhs) const 
-                { return ( rhs > multTable_[lhs].size()-1 ) ?  multTable_[lhs][rhs]: multTable_[rhs][lhs]; }  
+   Buffers& buffers() const;                            // work areas of the calling thread
+
+   int  multOffset( int const& lhs, int const& rhs) const { return tables_->multOffset( lhs, rhs ); }
 
-   int  offsetIndex(IntArray const& exp) const;
+   int  offsetIndex(IntArray const& exp) const          { return tables_->offsetIndex( exp ); }
 
    void debug()     const; 
 
@@ -153,6 +188,8 @@ struct ScratchArea {
 
   ScratchArea(ScratchArea const&); 
 
+  mutable boost::thread_specific_ptr<Buffers>  buffers_; 
+
  };
 
  template<typename U>
@@ -185,6 +222,11 @@ struct ScratchArea {
   ~TJetEnvironment();
 
   // factory functions -------------------------------------------
+  //
+  // NOTE: the makeXXX() functions may be called from any thread. 
+  //       BeginEnvironment()/EndEnvironment() and the environment 
+  //       stack (pushEnv()/popEnv()) use global state and should 
+  //       only be used before worker threads are started.
 
   static void        BeginEnvironment(int maxweight); 
   static EnvPtr<T>   EndEnvironment();
@@ -221,9 +263,31 @@ struct ScratchArea {
   TVector<T> const& refPoint()    const { return   refPoint_;    }
   int               maxWeight()   const { return   maxWeight_;   }
  
-  std::vector<T>&            monomial()        const { return   scratch_->monomial_;    }
-  std::vector<TJLterm<T> >&  TJLmml()          const { return   scratch_->TJLmml_;      }
-  std::vector<JLPtr<T> >&    TJLmonomial()     const { return   scratch_->TJLmonomial_; }
+  // scratchpads of the calling thread
+
+  std::vector<T>&            monomial()        const { return   scratch_->buffers().monomial_;    }
+  std::vector<TJLterm<T> >&  TJLmml()          const { return   scratch_->buffers().TJLmml_;      }
+  std::vector<JLPtr<T> >&    TJLmonomial()     const { return   scratch_->buffers().TJLmonomial_; }
+  std::vector<T>&            denseCoeffs()     const { return   scratch_->buffers().denseCoeffs_;  }
+  std::vector<T>&            denseProduct()    const { return   scratch_->buffers().denseProduct_; }
+
+  // row of the monomial multiplication table: multRow(i)[j] is the offset of the
+  // product of monomials i and j, for all j < weight_offset( maxWeight()-weight(i)+1 ) 
+
+  int const*      multRow( int const& offset )   const   { return scratch_->tables_->multRow( offset ); }
+
+  // Products of jets are computed with dense kernels when the fill fraction of the 
+  // denser operand (no of terms/no of monomials up to its weight) is at least 
+  // denseThreshold(). A threshold > 1 disables the dense kernels. 
+
+  static void             setDenseThreshold( double const& fill );
+  static double           denseThreshold();
+
+  // Maps (TMapping::operator(), operator*=) are composed by compositionThreads() 
+  // threads; 0 means one per hardware thread. The default is 1.
+
+  static void             setCompositionThreads( int n );
+  static int              compositionThreads();
 
   int             multOffset    (int const& lhs, int const& rhs)  const   { return  scratch_->multOffset(lhs, rhs); }
 
@@ -231,7 +295,7 @@ struct ScratchArea {
   int           offsetIndex( IntArray const& exp) const; 
   int                weight( int const& offset )  const;
   int         weight_offset( int const& weight )  const;  
-  IntArray const& exponents( int const& offset )  const  { return scratch_->index_table_[offset]; }
+  IntArray const& exponents( int const& offset )  const  { return scratch_->tables_->exponents( offset ); }
 
   int             maxTerms()  const                      { return scratch_->maxTerms_;}
 
@@ -273,6 +337,12 @@ struct ScratchArea {
 
   static int   tmp_maxWeight_; // used by Begin/EndEnvironment() 
 
+  static double denseThreshold_; 
+
+  static int    compositionThreads_; 
+
+  static boost::recursive_mutex&        mutex_;          // serializes creation and disposal of environments
+
   ScratchArea<T>*  buildScratchPads(int maxweight, int numvar);
 
   TJetEnvironment(int maxweight, int nvar, int spacedim );
@@ -319,7 +389,7 @@ inline int  TJetEnvironment<T>::offsetIndex(IntArray const& exp) const
 template <typename T>
 inline int      TJetEnvironment<T>::weight( int const& offset )       const  
 { 
-   return scratch_->index_table_[offset].Weight(); 
+   return scratch_->tables_->weight( offset ); 
 }
 
 //|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
@@ -328,7 +398,7 @@ inline int      TJetEnvironment<T>::weight( int const& offset )       const
 template <typename T>
 inline int      TJetEnvironment<T>::weight_offset( int const& weight )       const  
 { 
-   return scratch_->weight_offsets_[weight]; 
+   return scratch_->tables_->weightOffset( weight ); 
 }
 
 
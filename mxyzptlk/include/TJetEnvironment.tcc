@@ -78,6 +78,7 @@
 #include <mxyzptlk/JLPtr.h>
 #include <mxyzptlk/TMapping.h>
 #include <mxyzptlk/EnvPtr.h>
+#include <boost/thread/thread.hpp>
 
 #include <limits>
 #include <iomanip>
@@ -141,6 +142,14 @@ std::list<typename TJetEnvironment<T>::template ScratchArea<T>* >&  TJetEnvironm
   
 template<typename T> int                       TJetEnvironment<T>::tmp_maxWeight_ = 0;
 
+template<typename T> double                    TJetEnvironment<T>::denseThreshold_ = 0.1;
+
+template<typename T> int                       TJetEnvironment<T>::compositionThreads_ = 1;
+
+template<typename T> 
+boost::recursive_mutex&                        TJetEnvironment<T>::mutex_ 
+               = *( new boost::recursive_mutex() );
+
 
 // |||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
 // |||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
@@ -295,6 +304,8 @@ namespace {
 template<typename T>
 void TJetEnvironment<T>::dispose() {
  
+  boost::recursive_mutex::scoped_lock lock( mutex_ );
+
   static bool disposed = false; 
 
   if ( disposed ) { disposed = false; return; }
@@ -354,6 +365,56 @@ TJetEnvironment<T>::TJetEnvironment(int maxweight, int numvar, int spacedim, TVe
  
 
 
+// |||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+// |||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+template<typename T>
+void TJetEnvironment<T>::setDenseThreshold( double const& fill )
+{
+  if ( fill < 0.0 ) {
+    throw( GenericException( __FILE__, __LINE__, 
+           "void TJetEnvironment<T>::setDenseThreshold( double const& fill )",
+           "The fill threshold cannot be negative." ) );
+  }
+  denseThreshold_ = fill;
+}
+
+// |||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+// |||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+template<typename T>
+double TJetEnvironment<T>::denseThreshold()
+{
+  return denseThreshold_;
+}
+
+// |||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+// |||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+template<typename T>
+void TJetEnvironment<T>::setCompositionThreads( int n )
+{
+  if ( n < 0 ) {
+    throw( GenericException( __FILE__, __LINE__, 
+           "void TJetEnvironment<T>::setCompositionThreads( int n )",
+           "The number of threads cannot be negative." ) );
+  }
+  compositionThreads_ = n;
+}
+
+// |||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+// |||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+template<typename T>
+int TJetEnvironment<T>::compositionThreads()
+{
+  if ( compositionThreads_ > 0 ) return compositionThreads_;
+
+  int const n = boost::thread::hardware_concurrency();
+
+  return ( n > 0 ) ? n : 1;
+}
+
 // |||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
 // |||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
 
@@ -391,9 +452,8 @@ TJetEnvironment<T>::ScratchArea<U>::ScratchArea(TJetEnvironment<U>* pje, int w,
   maxWeight_(w),                                        // maxWeight and numVar are duplicated here because 
   numVar_(n),                                           // they are needed to reference an existing scratch area
   maxTerms_( bcfRec( w + n, n ) ),                      // no of monomials in a polynomial of order w in n variables
-  monomial_( maxTerms_),
-  TJLmonomial_(maxTerms_ ),
-  TJLmml_( maxTerms_ )                                  // the actual scratchpad 
+  TJLmml_( maxTerms_ ),                                 // the (empty) scratchpad 
+  tables_( MonomialTables::get( w, n ) )
 {
 
  //-----------------------------------------------------------------------------------------------------------
@@ -420,82 +480,17 @@ TJetEnvironment<T>::ScratchArea<U>::ScratchArea(TJetEnvironment<U>* pje, int w,
  // Index: ( 9, 1, 2 ) 
  // ...
  //
- //  the weight_offsets_ table contains offsets for the start of each group of terms of identical weight 
- //  
+ // This is the order of the monomials in the MonomialTables; the tables are built (or 
+ // mapped from a file) the first time an environment with these values of maxweight and
+ // numvar is created, whatever its scalar type.
  //-------------------------------------------------------------------------------------------------------------
 
- IntArray exponents(numVar_);
  U startValue(0.0);
 
+ for ( int i=0; i < maxTerms_; ++i ) {
+   new ( &TJLmml_[i] ) TJLterm<U>( startValue, i, tables_->weight(i) );
+ }
 
- weight_offsets_.resize( maxWeight_+2 );
- index_table_.resize(maxTerms_);
-
- new ( &TJLmml_[0] ) TJLterm<U>( startValue, 0, 0 );
-
- weight_offsets_[0] = 0; 
-    index_table_[0] = exponents;
-
- int i = 1;
- for( int wd = 1; wd <= maxWeight_; ++wd ) {
-
-   weight_offsets_[wd] = i;
-
-   while( nexcom( wd, n, exponents ) ) {
-
-     if( i <  maxTerms_ ) {
-       new ( &TJLmml_[i])TJLterm<U>(  startValue, i , exponents.Sum());
-       index_table_[i]    = exponents;
-     }
-     else {
-       throw( GenericException( __FILE__, __LINE__, 
-              "TJetEnvironment::_buildScratchPads()",
-              "Overran number of possible monomial terms." ) );
-     }
-
-     ++i;
-   } // end while
- } // end for
-
-  weight_offsets_[ maxWeight_+1] = i; // points to 1 location beyond the last element in the scratchpad.  
-
-
- //------------------------------------
- // build monomial multiplication table  
- //-------------------------------------
-   
-   multTable_.resize(maxTerms_);
-
-   int maxidx = 0; 
-   int wgt    = maxWeight_+1; 
-
-   for (int i=0; i<maxTerms_; ++i) {
-
-      if ( wgt  >  ( maxWeight_ - index_table_[i].Sum() ) ) {
-          --wgt;  
-          maxidx        =  bcfRec( wgt + numVar_, numVar_ ); 
-      }
-
-      multTable_[i].resize(maxidx);
-
-      for (int j=0; j < maxidx; ++j ) {
-                  
-         exponents =  index_table_[i]  +  index_table_[j];
-         if ( exponents.Sum()  <= maxWeight_ ) 
-         { 
-                multTable_[i][j] = offsetIndex(exponents);
-         }
-
-      }
-   }
-
-  //-----------------------------------------------------------------------------------------
-  // NOTE:  the call to offsetIndex(exponents) involves a reverse lexicographic search 
-  //        within a pre-sorted table. 
-  //        This operation is somewhat slow, and dominates the time needed to fill the 
-  //        multiplication table. The latter needs to be filled once, when the 
-  //        environment is set up.      
-  //-----------------------------------------------------------------------------------------
 }
 
 //|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
@@ -514,8 +509,8 @@ void  TJetEnvironment<T>::ScratchArea<U>::debug() const
   for (int i=0; i < maxTerms_;  ++i ) {
     
     std::cout <<  "offset : " <<  TJLmml_[i].offset_       << "  " 
-              <<  "index : "  <<  index_table_[i]          << "  " 
-              <<  "weight : " <<  index_table_[i].Weight() << "  " 
+              <<  "index : "  <<  tables_->exponents(i)    << "  " 
+              <<  "weight : " <<  tables_->weight(i)       << "  " 
               <<  "value : "  <<  TJLmml_[i].value_        << std::endl;
   }
 
@@ -526,8 +521,8 @@ void  TJetEnvironment<T>::ScratchArea<U>::debug() const
 
    for (int i=0; i < maxWeight_+1;  ++i ) {
  
-   std::cout << "weight " << i << "  start: " << weight_offsets_[i] 
-                               << "  end:   " << weight_offsets_[i+1] << std::endl;
+   std::cout << "weight " << i << "  start: " << tables_->weightOffset(i) 
+                               << "  end:   " << tables_->weightOffset(i+1) << std::endl;
    }
 
    std::cout << " ------------------------------------------------------------------------------" << std::endl;
@@ -535,11 +530,11 @@ void  TJetEnvironment<T>::ScratchArea<U>::debug() const
    std::cout << " ------------------------------------------------------------------------------" << std::endl;
 
    for (int i=0; i < maxTerms_;  ++i ) {
-      for (int j=0; j<multTable_[i].size(); ++j ) {
+      for (int j=0; j<tables_->rowLength(i); ++j ) {
 
-       std::cout <<  index_table_[i] <<  " *  " 
-                 <<  index_table_[j] <<  " =  " 
-                 <<  index_table_[ multTable_[i][j] ] << std::endl;
+       std::cout <<  tables_->exponents(i) <<  " *  " 
+                 <<  tables_->exponents(j) <<  " =  " 
+                 <<  tables_->exponents( tables_->multRow(i)[j] ) << std::endl;
 
       }
    }
@@ -558,55 +553,48 @@ template<typename U>
 //|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
 //|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
 
-namespace {
-
-template <typename T>
-class ReverseLexicographicTermCompare {
-
-public:
-
- ReverseLexicographicTermCompare( typename TJetEnvironment<T>::template ScratchArea<T> const& scratch ): scratch_(scratch) {}
-
-
- bool operator()(TJLterm<T> const& lhs,  IntArray const& rhs)  const
- {
-     return  ( scratch_.index_table_[lhs.offset_] <  rhs );
- }
-
-private:
-
- typename TJetEnvironment<T>::template ScratchArea<T> const& scratch_;
-
-};
+template<typename T>
+template<typename U>
+TJetEnvironment<T>::ScratchArea<U>::Buffers::Buffers( ScratchArea const& scratch ): 
+  monomial_(    scratch.maxTerms_ ),
+  TJLmonomial_( scratch.maxTerms_ ),
+  TJLmml_(      scratch.TJLmml_   ),  // offsets and weights are set; all values are zero.
+  denseCoeffs_(  scratch.maxTerms_ ),
+  denseProduct_( scratch.maxTerms_ )
+{}
 
-}
-//---------------------------------------------------------------------------------------------------------
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
 
-template <typename T>
-template <typename U>
-int  TJetEnvironment<T>::ScratchArea<U>::offsetIndex(IntArray const& exp) const
+template<typename T>
+template<typename U>
+typename TJetEnvironment<T>::template ScratchArea<U>::Buffers& TJetEnvironment<T>::ScratchArea<U>::buffers() const
 {
+  //--------------------------------------------------------------------
+  // The work areas of a thread are created the first time they are 
+  // needed and deleted when the thread exits. Since a ScratchArea is
+  // never deleted, the buffers of the main thread are never released.
+  //--------------------------------------------------------------------
 
- int weight = exp.Sum(); 
-
- TJLterm<T> const* itstart = &TJLmml_[0] + weight_offsets_[weight]; 
- TJLterm<T> const* itend   = &TJLmml_[0] + weight_offsets_[weight+1];
-
- // look for a match to exp in the scratchpad, within monomials of same weight. 
-
- return std::lower_bound( itstart, itend, exp, ReverseLexicographicTermCompare<T>(*this) )->offset_;
+  Buffers* p = buffers_.get();
 
+  if ( !p ) { 
+    p = new Buffers( *this );
+    buffers_.reset( p );
+  }
+  return *p;
 }
 
-// |||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
-// |||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
-
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
 
 template<typename T>
 TJetEnvironment<T>::ScratchArea<T>* 
 TJetEnvironment<T>::buildScratchPads(int maxweight, int numvar)
 {
 
+  boost::recursive_mutex::scoped_lock lock( mutex_ );
+
 
   // If a suitable scratchpad already exists, return it.
  
@@ -672,6 +660,8 @@ template<typename T>
 EnvPtr<T>  TJetEnvironment<T>::makeJetEnvironment(int maxweight, int nvar, int spacedim, TVector<T> const& refpoints )
 {
 
+ boost::recursive_mutex::scoped_lock lock( mutex_ );
+
  //-----------------------------------------------------
  // if a match already  exists, return it 
  //-----------------------------------------------------
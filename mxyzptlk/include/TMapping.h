@@ -103,7 +103,7 @@ class DLLEXPORT TMapping: public TJetVector<T> {
   TVector<T> operator* ( TVector<T>   const& ) const;  //  an alias for operator()
   TMapping   operator* ( TMapping     const& ) const;  //  an alias for operator()
 
-  TMapping& operator*=( TMapping const& );
+  TMapping& operator*=( TMapping const& );          //  in place: *this = (*this)( x ) 
 
   TMatrix<T> jacobian() const;
 
@@ -112,6 +112,8 @@ class DLLEXPORT TMapping: public TJetVector<T> {
  private:
 
   TMapping<T> epsInverse(  EnvPtr<T> const&) const;
+
+  void compose( TMapping const& x, TMapping& z ) const;  // z = (*this)( x ); z may be *this 
  
   static int const maxiter_ = 100;   
 };
@@ -198,10 +198,7 @@ TMapping<T> TMapping<T>::operator()(  TMapping<T> const& x ) const
 
  TMapping<T> z( (this->comp_.size()), x.myEnv_ );
 
- typename TMapping<T>::iterator itz = z.begin(); 
- for( typename TMapping<T>::const_iterator it = this->begin(); it != this->end(); ++it, ++itz ) {
-  (*itz) = (*it)( x );
- }
+ compose( x, z );
 
  return z;
 }
@@ -261,9 +258,7 @@ TMapping<T>& TMapping<T>::operator*=(  TMapping<T> const& x )
           "Incompatible dimensions." ) );
  }
 
- for( typename TMapping<T>::iterator it = this->begin(); it != this->end(); ++it) {
-  (*it) = (*it)( x );
- }
+ compose( x, *this );
 
  return *this;
 
@@ -272,6 +267,43 @@ TMapping<T>& TMapping<T>::operator*=(  TMapping<T> const& x )
 //|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
 //|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
 
+template<typename T>
+void TMapping<T>::compose( TMapping<T> const& x, TMapping<T>& z ) const
+{
+ //---------------------------------------------------------------------
+ // All the components are composed together: the monomials of x are 
+ // computed once. The components of z are replaced only once all the 
+ // results are available, so that z may be *this.
+ //---------------------------------------------------------------------
+
+ int const n = this->comp_.size();
+
+ if ( n == 0 ) return;
+
+ std::vector<TJL<T> const*> jls( n );
+ std::vector<JLPtr<T> >     args( x.comp_.size() );
+ std::vector<JLPtr<T> >     results( n );
+
+ for( int i=0; i<n; ++i ) { 
+   jls[i] = this->comp_[i].jl_.get();
+ }
+
+ for( int i=0; i < x.comp_.size(); ++i ) { 
+   args[i] = x.comp_[i].jl_;
+ }
+
+ TJL<T>::compose( &jls[0], n, args, &results[0], TJetEnvironment<T>::compositionThreads() );
+
+ z.myEnv_ = x.myEnv_;
+
+ for( int i=0; i<n; ++i ) { 
+   z.comp_[i].jl_ = results[i];
+ }
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
 template<typename T>
 TMatrix<T> TMapping<T>::jacobian() const 
 {
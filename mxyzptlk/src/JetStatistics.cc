@@ -0,0 +1,465 @@
+/*************************************************************************
+**************************************************************************
+**************************************************************************
+******
+******  MXYZPTLK:  A C++ implementation of differential algebra.
+******
+******  File:      JetStatistics.cc
+******
+******  Copyright Fermi Research Alliance / Fermilab
+******            All Rights Reserved
+******
+******  Usage, modification, and redistribution are subject to terms
+******  of the License supplied with this software.
+******
+******  Software and documentation created under
+******  U.S. Department of Energy Contract No. DE-AC02-07CH11359
+******  The U.S. Government retains a world-wide non-exclusive,
+******  royalty-free license to publish or reproduce documentation
+******  and software for U.S. Government purposes. This software
+******  is protected under the U.S. and Foreign Copyright Laws.
+******
+**************************************************************************
+**************************************************************************
+*************************************************************************/
+
+#include <map>
+#include <algorithm>
+#include <iostream>
+#include <iomanip>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/tss.hpp>
+#include <mxyzptlk/JetStatistics.h>
+
+namespace {
+
+//-------------------------------------------------------------------------------
+// The counters of each thread are kept in a Record. Records are never freed,
+// so that the totals include the threads that have exited.
+//-------------------------------------------------------------------------------
+
+struct EnvKey {
+
+  EnvKey( bool c, int nv, int mw ) : complex(c), numVar(nv), maxWeight(mw) {}
+
+  bool operator<( EnvKey const& rhs ) const
+  {
+    if ( complex != rhs.complex ) return !complex;
+    if ( numVar  != rhs.numVar  ) return numVar < rhs.numVar;
+    return maxWeight < rhs.maxWeight;
+  }
+
+  bool complex;
+  int  numVar;
+  int  maxWeight;
+};
+
+typedef std::map<EnvKey, JetStatistics::EnvironmentCounters> EnvMap;
+
+struct Record {
+
+  Record() : last_(0) {}
+
+  JetStatistics::Counters               counters_;
+  EnvMap                                envs_;      // insertions and reads by other threads hold mutex_
+  JetStatistics::EnvironmentCounters*   last_;      // most recently used environment
+  boost::mutex                          mutex_;
+};
+
+void keepRecord( Record* ) {}  // records outlive their thread
+
+boost::thread_specific_ptr<Record>& records_ = *( new boost::thread_specific_ptr<Record>( &keepRecord ) );
+
+boost::mutex& registryMutex()
+{
+  static boost::mutex& m = *( new boost::mutex() );
+  return m;
+}
+
+std::vector<Record*>& registry()
+{
+  static std::vector<Record*>& r = *( new std::vector<Record*>() );
+  return r;
+}
+
+Record& theRecord()
+{
+  Record* r = records_.get();
+
+  if ( !r ) {
+    r = new Record();
+    {
+      boost::mutex::scoped_lock lock( registryMutex() );
+      registry().push_back( r );
+    }
+    records_.reset( r );
+  }
+  return *r;
+}
+
+JetStatistics::EnvironmentCounters& theEnvironment( Record& r, bool complex, int numVar, int maxWeight )
+{
+  JetStatistics::EnvironmentCounters* e = r.last_;
+
+  if ( e && e->complex == complex && e->numVar == numVar && e->maxWeight == maxWeight ) return *e;
+
+  boost::mutex::scoped_lock lock( r.mutex_ );
+
+  EnvMap::iterator it = r.envs_.find( EnvKey( complex, numVar, maxWeight ) );
+
+  if ( it == r.envs_.end() ) {
+    JetStatistics::EnvironmentCounters c;
+    c.complex   = complex;
+    c.numVar    = numVar;
+    c.maxWeight = maxWeight;
+    it = r.envs_.insert( std::make_pair( EnvKey( complex, numVar, maxWeight ), c ) ).first;
+  }
+
+  r.last_ = &it->second;
+  return it->second;
+}
+
+//-------------------------------------------------------------------------------
+// term store memory (global)
+//-------------------------------------------------------------------------------
+
+struct StoreMemory {
+
+  StoreMemory() : live_(0), peak_(0) {}
+
+  std::size_t   live_;
+  std::size_t   peak_;
+  boost::mutex  mutex_;
+};
+
+StoreMemory& storeMemory()
+{
+  static StoreMemory& m = *( new StoreMemory() );
+  return m;
+}
+
+} // anonymous namespace
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+JetStatistics::Counters::Counters()
+  : jlNew(0), jlRecycled(0), jlDiscarded(0), jlDeleted(0), poolHighWater(0),
+    storeAllocations(0), storeRegrowths(0), storeBytes(0), jlPtrCopies(0)
+{}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+double JetStatistics::Counters::poolHitRate() const
+{
+  unsigned long const n = jlNew + jlRecycled;
+  return ( n == 0 ) ? 0.0 : double( jlRecycled )/n;
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+JetStatistics::Counters& JetStatistics::Counters::operator+=( Counters const& rhs )
+{
+  jlNew            += rhs.jlNew;
+  jlRecycled       += rhs.jlRecycled;
+  jlDiscarded      += rhs.jlDiscarded;
+  jlDeleted        += rhs.jlDeleted;
+  poolHighWater     = std::max( poolHighWater, rhs.poolHighWater );
+  storeAllocations += rhs.storeAllocations;
+  storeRegrowths   += rhs.storeRegrowths;
+  storeBytes       += rhs.storeBytes;
+  jlPtrCopies      += rhs.jlPtrCopies;
+  return *this;
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+JetStatistics::Counters& JetStatistics::Counters::operator-=( Counters const& rhs )
+{
+  jlNew            -= rhs.jlNew;
+  jlRecycled       -= rhs.jlRecycled;
+  jlDiscarded      -= rhs.jlDiscarded;
+  jlDeleted        -= rhs.jlDeleted;
+  storeAllocations -= rhs.storeAllocations;
+  storeRegrowths   -= rhs.storeRegrowths;
+  storeBytes       -= rhs.storeBytes;
+  jlPtrCopies      -= rhs.jlPtrCopies;
+  return *this;
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+JetStatistics::Counters operator-( JetStatistics::Counters const& lhs, JetStatistics::Counters const& rhs )
+{
+  JetStatistics::Counters c( lhs );
+  return c -= rhs;
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+JetStatistics::EnvironmentCounters::EnvironmentCounters()
+  : complex(false), numVar(0), maxWeight(0),
+    jets(0), storeAllocations(0), storeRegrowths(0), storeBytes(0)
+{}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+bool JetStatistics::enabled()
+{
+#ifdef MXYZPTLK_STATISTICS
+  return true;
+#else
+  return false;
+#endif
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+JetStatistics::Counters JetStatistics::thread()
+{
+  return theRecord().counters_;
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+JetStatistics::Counters JetStatistics::total()
+{
+  Counters c;
+
+  boost::mutex::scoped_lock lock( registryMutex() );
+
+  for ( std::vector<Record*>::const_iterator it = registry().begin(); it != registry().end(); ++it ) {
+    c += (*it)->counters_;
+  }
+  return c;
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+std::vector<JetStatistics::EnvironmentCounters> JetStatistics::environments()
+{
+  EnvMap sum;
+
+  boost::mutex::scoped_lock lock( registryMutex() );
+
+  for ( std::vector<Record*>::const_iterator it = registry().begin(); it != registry().end(); ++it ) {
+
+    boost::mutex::scoped_lock record_lock( (*it)->mutex_ );
+
+    for ( EnvMap::const_iterator e = (*it)->envs_.begin(); e != (*it)->envs_.end(); ++e ) {
+
+      if ( e->second.jets == 0 && e->second.storeAllocations == 0 ) continue;   // zeroed by reset()
+
+      EnvMap::iterator s = sum.find( e->first );
+      if ( s == sum.end() ) { sum.insert( *e ); continue; }
+
+      s->second.jets             += e->second.jets;
+      s->second.storeAllocations += e->second.storeAllocations;
+      s->second.storeRegrowths   += e->second.storeRegrowths;
+      s->second.storeBytes       += e->second.storeBytes;
+    }
+  }
+
+  std::vector<EnvironmentCounters> envs;
+  for ( EnvMap::const_iterator s = sum.begin(); s != sum.end(); ++s ) { envs.push_back( s->second ); }
+  return envs;
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+std::size_t JetStatistics::liveStoreBytes()
+{
+  StoreMemory& m = storeMemory();
+  boost::mutex::scoped_lock lock( m.mutex_ );
+  return m.live_;
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+std::size_t JetStatistics::peakStoreBytes()
+{
+  StoreMemory& m = storeMemory();
+  boost::mutex::scoped_lock lock( m.mutex_ );
+  return m.peak_;
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+void JetStatistics::reset()
+{
+  {
+    boost::mutex::scoped_lock lock( registryMutex() );
+
+    for ( std::vector<Record*>::iterator it = registry().begin(); it != registry().end(); ++it ) {
+
+      (*it)->counters_ = Counters();
+
+      // The entries are zeroed rather than erased: their owner may hold a pointer to one.
+
+      boost::mutex::scoped_lock record_lock( (*it)->mutex_ );
+      for ( EnvMap::iterator e = (*it)->envs_.begin(); e != (*it)->envs_.end(); ++e ) {
+        e->second.jets             = 0;
+        e->second.storeAllocations = 0;
+        e->second.storeRegrowths   = 0;
+        e->second.storeBytes       = 0;
+      }
+    }
+  }
+
+  StoreMemory& m = storeMemory();
+  boost::mutex::scoped_lock lock( m.mutex_ );
+  m.peak_ = m.live_;
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+void JetStatistics::report( std::ostream& os )
+{
+  if ( !enabled() ) {
+    os << "Jet statistics are not available: mxyzptlk was compiled without MXYZPTLK_STATISTICS." << std::endl;
+    return;
+  }
+
+  os << total();
+  os << "term stores, live bytes     : " << liveStoreBytes() << '\n'
+     << "term stores, peak bytes     : " << peakStoreBytes() << '\n';
+
+  std::vector<EnvironmentCounters> const envs = environments();
+  if ( envs.empty() ) return;
+
+  os << "   type  nvar  weight          jets   allocations     regrowths         bytes\n";
+
+  for ( std::vector<EnvironmentCounters>::const_iterator e = envs.begin(); e != envs.end(); ++e ) {
+    os << std::setw(7)  << ( e->complex ? "complex" : "real" )
+       << std::setw(6)  << e->numVar
+       << std::setw(8)  << e->maxWeight
+       << std::setw(14) << e->jets
+       << std::setw(14) << e->storeAllocations
+       << std::setw(14) << e->storeRegrowths
+       << std::setw(14) << e->storeBytes << '\n';
+  }
+  os << std::flush;
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+std::ostream& operator<<( std::ostream& os, JetStatistics::Counters const& c )
+{
+  os << "jets allocated              : " << c.jlNew            << '\n'
+     << "jets recycled               : " << c.jlRecycled       << '\n'
+     << "jets discarded              : " << c.jlDiscarded      << '\n'
+     << "jets freed                  : " << c.jlDeleted        << '\n'
+     << "pool hit rate               : " << c.poolHitRate()    << '\n'
+     << "pool high-water mark        : " << c.poolHighWater    << '\n'
+     << "term stores allocated       : " << c.storeAllocations << '\n'
+     << "term stores regrown         : " << c.storeRegrowths   << '\n'
+     << "term stores, bytes allocated: " << c.storeBytes       << '\n'
+     << "JLPtr copies                : " << c.jlPtrCopies      << '\n';
+  return os;
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//
+//   hooks
+//
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+void JetStatistics::jlMade( bool recycled, bool complex, int numVar, int maxWeight )
+{
+  Record& r = theRecord();
+
+  if ( recycled ) { ++r.counters_.jlRecycled; }
+  else            { ++r.counters_.jlNew;      }
+
+  ++theEnvironment( r, complex, numVar, maxWeight ).jets;
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+void JetStatistics::jlDiscarded( std::size_t poolsize )
+{
+  Counters& c = theRecord().counters_;
+
+  ++c.jlDiscarded;
+  if ( poolsize > c.poolHighWater ) { c.poolHighWater = poolsize; }
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+void JetStatistics::jlDeleted( std::size_t n )
+{
+  theRecord().counters_.jlDeleted += n;
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+void JetStatistics::storeAllocated( std::size_t bytes, bool regrowth, bool complex, int numVar, int maxWeight )
+{
+  Record& r = theRecord();
+
+  EnvironmentCounters& e = theEnvironment( r, complex, numVar, maxWeight );
+
+  ++e.storeAllocations;
+  e.storeBytes += bytes;
+
+  if ( regrowth ) {
+    ++e.storeRegrowths;
+    ++r.counters_.storeRegrowths;
+  }
+
+  storeAllocated( bytes );
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+void JetStatistics::storeAllocated( std::size_t bytes )
+{
+  Counters& c = theRecord().counters_;
+
+  ++c.storeAllocations;
+  c.storeBytes += bytes;
+
+  StoreMemory& m = storeMemory();
+  boost::mutex::scoped_lock lock( m.mutex_ );
+
+  m.live_ += bytes;
+  if ( m.live_ > m.peak_ ) { m.peak_ = m.live_; }
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+void JetStatistics::storeReleased( std::size_t bytes )
+{
+  StoreMemory& m = storeMemory();
+  boost::mutex::scoped_lock lock( m.mutex_ );
+
+  m.live_ -= bytes;
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+void JetStatistics::jlPtrCopied()
+{
+  ++theRecord().counters_.jlPtrCopies;
+}
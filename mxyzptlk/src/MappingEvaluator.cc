@@ -0,0 +1,211 @@
+/*************************************************************************
+**************************************************************************
+**************************************************************************
+******
+******  MXYZPTLK:  A C++ implementation of differential algebra.
+******
+******  File:      MappingEvaluator.cc
+******
+******  Copyright Fermi Research Alliance / Fermilab
+******            All Rights Reserved
+******
+******  Usage, modification, and redistribution are subject to terms
+******  of the License supplied with this software.
+******
+******  Software and documentation created under
+******  U.S. Department of Energy Contract No. DE-AC02-07CH11359
+******  The U.S. Government retains a world-wide non-exclusive,
+******  royalty-free license to publish or reproduce documentation
+******  and software for U.S. Government purposes. This software
+******  is protected under the U.S. and Foreign Copyright Laws.
+******
+**************************************************************************
+**************************************************************************
+*************************************************************************/
+
+#include <map>
+#include <algorithm>
+#include <functional>
+#include <basic_toolkit/GenericException.h>
+#include <basic_toolkit/IntArray.h>
+#include <mxyzptlk/MappingEvaluator.h>
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+MappingEvaluator::MappingEvaluator( Mapping const& map )
+  : dim_( map.Dim() ), nvar_(0), nmono_(0)
+{
+  EnvPtr<double> env = map.Env();
+
+  nvar_ = env->numVar();
+
+  refPoint_.assign( env->refPoint().begin(), env->refPoint().end() );
+
+  //-------------------------------------------------------------------
+  // Collect the monomials used by the map, keyed by their environment
+  // offset, together with all the monomials needed to build them
+  // (the parent of a monomial is obtained by lowering its first
+  // nonzero exponent). Environment offsets are ordered by weight;
+  // iterating over the map therefore visits parents before children.
+  //-------------------------------------------------------------------
+
+  std::map<int,int> monomials;   // offset -> local index
+
+  for ( int i=0; i<dim_; ++i ) {
+    for ( Jet::const_iterator it = map[i].begin(); it != map[i].end(); ++it ) {
+
+      if ( it->weight_ == 0 || it->value_ == 0.0 ) continue;
+
+      int offset = it->offset_;
+      while ( monomials.find( offset ) == monomials.end() ) {
+
+        monomials[offset] = -1;
+
+        IntArray exps = env->exponents( offset );
+        if ( exps.Sum() == 1 ) break;
+
+        IntArray::iterator p = std::find_if( exps.begin(), exps.end(), std::bind2nd( std::not_equal_to<int>(), 0 ) );
+        --exps[ std::distance( exps.begin(), p ) ];   // operator[] (unlike iterators) resets the cached weight
+        offset = env->offsetIndex( exps );
+      }
+    }
+  }
+
+  //-------------------------------------------------------------------
+  // The variables are local monomials 0 ... nvar_-1; higher monomials
+  // follow in weight order.
+  //-------------------------------------------------------------------
+
+  parent_.assign( nvar_, -1 );
+  var_.resize( nvar_ );
+  for ( int i=0; i<nvar_; ++i ) { var_[i] = i; }
+
+  for ( std::map<int,int>::iterator it = monomials.begin(); it != monomials.end(); ++it ) {
+
+    IntArray const& exps = env->exponents( it->first );
+
+    IntArray::const_iterator p = std::find_if( exps.begin(), exps.end(), std::bind2nd( std::not_equal_to<int>(), 0 ) );
+    int const v = std::distance( exps.begin(), p );
+
+    if ( exps.Sum() == 1 ) {
+      it->second = v;
+      continue;
+    }
+
+    IntArray parent( exps );
+    --parent[v];
+
+    it->second = parent_.size();
+    parent_.push_back( monomials[ env->offsetIndex( parent ) ] );
+    var_.push_back( v );
+  }
+
+  nmono_ = parent_.size();
+
+  //-------------------------------------------------------------------
+  // Terms
+  //-------------------------------------------------------------------
+
+  constant_.assign( dim_, 0.0 );
+  termBegin_.push_back(0);
+
+  for ( int i=0; i<dim_; ++i ) {
+    for ( Jet::const_iterator it = map[i].begin(); it != map[i].end(); ++it ) {
+
+      if ( it->weight_ == 0 ) { constant_[i] += it->value_; continue; }
+      if ( it->value_  == 0.0 ) continue;
+
+      termMono_.push_back ( monomials[ it->offset_ ] );
+      termCoeff_.push_back( it->value_ );
+    }
+    termBegin_.push_back( termMono_.size() );
+  }
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+void MappingEvaluator::evaluateBlock( double const* const* in, int first, int m, double* const* out, double* work ) const
+{
+  // work holds nmono_ rows of blockSize monomial values
+
+  for ( int i=0; i<nvar_; ++i ) {
+    double*       u = work + i*blockSize;
+    double const* x = in[i] + first;
+    double const  r = refPoint_[i];
+    for ( int j=0; j<m; ++j ) { u[j] = x[j] - r; }
+  }
+
+  for ( int k=nvar_; k<nmono_; ++k ) {
+    double*       q = work + k*blockSize;
+    double const* p = work + parent_[k]*blockSize;
+    double const* u = work + var_[k]*blockSize;
+    for ( int j=0; j<m; ++j ) { q[j] = p[j]*u[j]; }
+  }
+
+  // All inputs have been consumed: out may alias in.
+
+  for ( int i=0; i<dim_; ++i ) {
+
+    double* y = out[i] + first;
+    double const c0 = constant_[i];
+    for ( int j=0; j<m; ++j ) { y[j] = c0; }
+
+    for ( int t=termBegin_[i]; t<termBegin_[i+1]; ++t ) {
+      double const* q = work + termMono_[t]*blockSize;
+      double const  c = termCoeff_[t];
+      for ( int j=0; j<m; ++j ) { y[j] += c*q[j]; }
+    }
+  }
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+void MappingEvaluator::operator()( double const* const* in, double* const* out, int n ) const
+{
+  std::vector<double> work( std::max(nmono_,1)*blockSize );
+
+  for ( int first=0; first<n; first += blockSize ) {
+    evaluateBlock( in, first, std::min( blockSize, n-first ), out, &work[0] );
+  }
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+void MappingEvaluator::operator()( double* const* coords, int n ) const
+{
+  if ( dim_ != nvar_ ) {
+    throw GenericException( __FILE__, __LINE__,
+           "void MappingEvaluator::operator()( double* const* coords, int n ) const",
+           "In-place evaluation requires a map with as many components as variables." );
+  }
+
+  (*this)( coords, coords, n );
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+Vector MappingEvaluator::operator()( Vector const& x ) const
+{
+  if ( x.Dim() != nvar_ ) {
+    throw GenericException( __FILE__, __LINE__,
+           "Vector MappingEvaluator::operator()( Vector const& x ) const",
+           "Incompatible dimensions." );
+  }
+
+  Vector z( dim_ );
+
+  std::vector<double const*> in ( nvar_ );
+  std::vector<double*>       out( dim_  );
+
+  for ( int i=0; i<nvar_; ++i ) { in[i]  = &x[i]; }
+  for ( int i=0; i<dim_;  ++i ) { out[i] = &z[i]; }
+
+  (*this)( &in[0], &out[0], 1 );
+
+  return z;
+}
@@ -0,0 +1,468 @@
+/*************************************************************************
+**************************************************************************
+**************************************************************************
+******
+******  MXYZPTLK:  A C++ implementation of differential algebra.
+******
+******  File:      MonomialTables.cc
+******
+******  Copyright Fermi Research Alliance / Fermilab
+******            All Rights Reserved
+******
+******  Usage, modification, and redistribution are subject to terms
+******  of the License supplied with this software.
+******
+******  Software and documentation created under
+******  U.S. Department of Energy Contract No. DE-AC02-07CH11359
+******  The U.S. Government retains a world-wide non-exclusive,
+******  royalty-free license to publish or reproduce documentation
+******  and software for U.S. Government purposes. This software
+******  is protected under the U.S. and Foreign Copyright Laws.
+******
+**************************************************************************
+**************************************************************************
+*************************************************************************/
+
+#if HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <mxyzptlk/MonomialTables.h>
+#include <basic_toolkit/GenericException.h>
+#include <basic_toolkit/iosetup.h>
+#include <basic_toolkit/utils.h>
+#include <boost/thread/mutex.hpp>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <cstdlib>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+using FNAL::pcerr;
+
+using boost::uint32_t;
+using boost::int32_t;
+using boost::uint64_t;
+
+//------------------------------------------------------------------------------------------
+// File layout. Both sections start on an 8 byte boundary.
+//------------------------------------------------------------------------------------------
+
+struct MonomialTables::Header {
+
+  char      magic[8];           // "CHEFJET"
+  uint32_t  version;
+  uint32_t  byte_order;         // byte_order_mark, as written
+  uint32_t  header_size;        // sizeof(Header)
+  int32_t   max_weight;
+  int32_t   num_var;
+  int32_t   max_terms;
+
+  uint64_t  nexponents;         // max_terms*num_var
+  uint64_t  nmult;              // entries of the multiplication table
+
+  uint64_t  exponents;          // section offsets [ bytes ]
+  uint64_t  mult;
+
+  uint64_t  file_size;
+};
+
+uint32_t const MonomialTables::format_version = 1;
+
+namespace {
+
+ char     const magic[8]        = { 'C', 'H', 'E', 'F', 'J', 'E', 'T', '\0' };
+ uint32_t const byte_order_mark = 0x01020304;
+
+ uint64_t padded( uint64_t n ) { return ( n + 7 ) & ~uint64_t(7); }
+
+ boost::mutex  state_mutex;     // stores, counters, directory
+
+ // A process uses a handful of environments: the memory store is searched linearly.
+
+ std::vector<boost::shared_ptr<MonomialTables const> > memory;
+
+ int  nbuilt  = 0;
+ int  nloaded = 0;
+
+ bool         directory_set = false;
+ std::string  directory_;
+
+ std::string currentDirectory()
+ {
+   if ( !directory_set ) {
+     char const* const dir = getenv( "CHEF_JET_TABLES" );
+     directory_     = dir ? dir : "";
+     directory_set  = true;
+   }
+   return directory_;
+ }
+
+} // namespace
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+void MonomialTables::index()
+{
+ //-----------------------------------------------------------------------------------------
+ // The monomials are ordered by weight; monomials of the same weight are in reverse
+ // lexicographic order, as generated by nexcom().
+ //-----------------------------------------------------------------------------------------
+
+  exponents_.resize( maxTerms_ );
+  weightOffsets_.resize( maxWeight_+2 );
+
+  IntArray exponents( numVar_ );
+
+  exponents_[0]     = exponents;
+  weightOffsets_[0] = 0;
+
+  int i = 1;
+  for ( int w = 1; w <= maxWeight_; ++w ) {
+
+    weightOffsets_[w] = i;
+
+    while ( nexcom( w, numVar_, exponents ) ) {
+      if ( i >= maxTerms_ ) {
+        throw GenericException( __FILE__, __LINE__,
+              "void MonomialTables::index()",
+              "Overran number of possible monomial terms." );
+      }
+      exponents_[i++] = exponents;
+    }
+  }
+
+  weightOffsets_[maxWeight_+1] = i;
+
+  for ( int i=0; i<maxTerms_; ++i ) { exponents_[i].Sum(); }  // caches the weights: the tables are then read-only
+
+ //-----------------------------------------------------------------------------------------
+ // Row i of the multiplication table holds the products with the monomials of weight
+ // up to maxWeight_ - weight(i).
+ //-----------------------------------------------------------------------------------------
+
+  rowStart_.resize( maxTerms_+1 );
+  rowStart_[0] = 0;
+
+  for ( int i=0; i<maxTerms_; ++i ) {
+    rowStart_[i+1] = rowStart_[i] + weightOffsets_[ maxWeight_ - weight(i) + 1 ];
+  }
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+MonomialTables::MonomialTables( int maxWeight, int numVar )
+  : maxWeight_(maxWeight), numVar_(numVar), maxTerms_( bcfRec( maxWeight + numVar, numVar ) ),
+    mult_(0), map_(0), size_(0)
+{
+  index();
+
+  multData_.resize( rowStart_[maxTerms_] );
+
+  //-----------------------------------------------------------------------------------------
+  // The table is symmetric: for j < i, monomial i is in row j (its weight is at most
+  // maxWeight_ - weight(j)), and the product is copied. The other products are looked
+  // up with a binary search within the monomials of their weight.
+  //-----------------------------------------------------------------------------------------
+
+  for ( int i=0; i<maxTerms_; ++i ) {
+
+    int* const row = &multData_[ rowStart_[i] ];
+    int  const n   = rowLength(i);
+
+    for ( int j=0; j < std::min( i, n ); ++j ) { row[j] = multData_[ rowStart_[j] + i ]; }
+
+    for ( int j=i; j < n; ++j ) { row[j] = offsetIndex( exponents_[i] + exponents_[j] ); }
+  }
+
+  mult_ = &multData_[0];
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+MonomialTables::MonomialTables( std::string const& filename )
+  : maxWeight_(0), numVar_(0), maxTerms_(0), mult_(0), map_(0), size_(0)
+{
+  static char const* const fname = "MonomialTables::MonomialTables( std::string const& filename )";
+
+  int const fd = open( filename.c_str(), O_RDONLY );
+
+  if ( fd < 0 ) {
+    throw GenericException( __FILE__, __LINE__, fname, ( "Cannot open " + filename + "." ).c_str() );
+  }
+
+  struct stat st;
+  if ( fstat( fd, &st ) != 0 || std::size_t( st.st_size ) < sizeof(Header) ) {
+    close( fd );
+    throw GenericException( __FILE__, __LINE__, fname, ( filename + " is not a monomial table file." ).c_str() );
+  }
+
+  size_ = st.st_size;
+  map_  = mmap( 0, size_, PROT_READ, MAP_SHARED, fd, 0 );
+  close( fd );
+
+  if ( map_ == MAP_FAILED ) {
+    map_ = 0;
+    throw GenericException( __FILE__, __LINE__, fname, ( "Cannot map " + filename + "." ).c_str() );
+  }
+
+  char const* const base = static_cast<char const*>( map_ );
+  Header const& h = *reinterpret_cast<Header const*>( base );
+
+  std::string error;
+
+  if ( std::memcmp( h.magic, magic, sizeof(magic) ) != 0 ) {
+    error = " is not a monomial table file.";
+  }
+  else if ( h.byte_order != byte_order_mark ) {
+    error = " was written on a machine with a different byte order.";
+  }
+  else if ( h.version != format_version ) {
+    std::ostringstream uic;
+    uic << " has format version " << h.version << "; version " << format_version << " is expected.";
+    error = uic.str();
+  }
+  else if ( h.header_size != sizeof(Header) || h.max_weight < 0 || h.num_var < 1
+            || h.max_terms != bcfRec( h.max_weight + h.num_var, h.num_var ) ) {
+    error = " has an unexpected layout.";
+  }
+
+  if ( error.empty() ) {
+
+    maxWeight_ = h.max_weight;
+    numVar_    = h.num_var;
+    maxTerms_  = h.max_terms;
+
+    index();
+
+    //---------------------------------------------------------------------------------
+    // The section sizes follow from (maxWeight, numVar). The exponents are compared
+    // with those generated here, so that a file written with another monomial
+    // ordering is rejected.
+    //---------------------------------------------------------------------------------
+
+    if (    h.nexponents != uint64_t( maxTerms_ )*numVar_ || h.nmult != rowStart_[maxTerms_]
+         || h.exponents  <  sizeof(Header)
+         || h.exponents  +  h.nexponents*sizeof(int32_t) > h.mult
+         || h.mult       +  h.nmult     *sizeof(int32_t) > h.file_size
+         || h.file_size  != size_ ) {
+      error = " is truncated or corrupt.";
+    }
+    else {
+      int32_t const* e = reinterpret_cast<int32_t const*>( base + h.exponents );
+      for ( int i=0; i < maxTerms_ && error.empty(); ++i, e += numVar_ ) {
+        if ( !std::equal( exponents_[i].begin(), exponents_[i].end(), e ) ) {
+          error = " uses another monomial ordering.";
+        }
+      }
+    }
+  }
+
+  if ( !error.empty() ) {
+    munmap( map_, size_ );
+    map_ = 0;
+    throw GenericException( __FILE__, __LINE__, fname, ( filename + error ).c_str() );
+  }
+
+  mult_ = reinterpret_cast<int const*>( base + h.mult );
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+MonomialTables::~MonomialTables()
+{
+  if ( map_ ) { munmap( map_, size_ ); }
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+void MonomialTables::write( std::string const& filename ) const
+{
+  static char const* const fname = "void MonomialTables::write( std::string const& filename ) const";
+
+  Header h;
+  std::memset( &h, 0, sizeof(Header) );
+
+  std::memcpy( h.magic, magic, sizeof(magic) );
+  h.version      = format_version;
+  h.byte_order   = byte_order_mark;
+  h.header_size  = sizeof(Header);
+  h.max_weight   = maxWeight_;
+  h.num_var      = numVar_;
+  h.max_terms    = maxTerms_;
+
+  h.nexponents   = uint64_t( maxTerms_ )*numVar_;
+  h.nmult        = rowStart_[maxTerms_];
+
+  h.exponents    = padded( sizeof(Header) );
+  h.mult         = padded( h.exponents + h.nexponents*sizeof(int32_t) );
+  h.file_size    = h.mult + h.nmult*sizeof(int32_t);
+
+  std::vector<int32_t> exponents;
+  exponents.reserve( h.nexponents );
+  for ( int i=0; i<maxTerms_; ++i ) {
+    exponents.insert( exponents.end(), exponents_[i].begin(), exponents_[i].end() );
+  }
+
+  std::ofstream os( filename.c_str(), std::ios::out | std::ios::binary | std::ios::trunc );
+
+  if ( !os ) {
+    throw GenericException( __FILE__, __LINE__, fname, ( "Cannot open " + filename + " for writing." ).c_str() );
+  }
+
+  char const zeros[8] = { 0, 0, 0, 0, 0, 0, 0, 0 };
+
+  os.write( reinterpret_cast<char const*>( &h ), sizeof(Header) );
+  os.write( zeros, h.exponents - sizeof(Header) );
+
+  os.write( reinterpret_cast<char const*>( &exponents[0] ), h.nexponents*sizeof(int32_t) );
+  os.write( zeros, h.mult - ( h.exponents + h.nexponents*sizeof(int32_t) ) );
+
+  os.write( reinterpret_cast<char const*>( mult_ ), h.nmult*sizeof(int32_t) );
+
+  if ( !os ) {
+    throw GenericException( __FILE__, __LINE__, fname, ( "Error writing " + filename + "." ).c_str() );
+  }
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+int MonomialTables::offsetIndex( IntArray const& exp ) const
+{
+  // binary search within the monomials of the same weight (reverse lexicographic order)
+
+  int const w = exp.Sum();
+
+  std::vector<IntArray>::const_iterator it =
+    std::lower_bound( exponents_.begin() + weightOffsets_[w], exponents_.begin() + weightOffsets_[w+1], exp );
+
+  return it - exponents_.begin();
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+std::string MonomialTables::fileName( std::string const& dir, int maxWeight, int numVar )
+{
+  std::ostringstream name;
+  name << dir << "/monomials_w" << maxWeight << "_n" << numVar << ".tables";
+  return name.str();
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+boost::shared_ptr<MonomialTables const> MonomialTables::get( int maxWeight, int numVar )
+{
+  boost::mutex::scoped_lock lock( state_mutex );
+
+  for ( std::vector<boost::shared_ptr<MonomialTables const> >::const_iterator it = memory.begin(); it != memory.end(); ++it ) {
+    if ( (*it)->maxWeight() == maxWeight && (*it)->numVar() == numVar ) return *it;
+  }
+
+  std::string const dir = currentDirectory();
+
+  std::string const fname = dir.empty() ? std::string() : fileName( dir, maxWeight, numVar );
+
+  if ( !dir.empty() && 0 == access( fname.c_str(), R_OK ) ) {
+    try {
+      boost::shared_ptr<MonomialTables const> tables( new MonomialTables( fname ) );
+      memory.push_back( tables );
+      ++nloaded;
+      return tables;
+    }
+    catch ( GenericException const& ) {
+      (*pcerr) << "*** WARNING *** MonomialTables: the file " << fname
+               << " cannot be used and will be replaced." << std::endl;
+    }
+  }
+
+  boost::shared_ptr<MonomialTables const> tables( new MonomialTables( maxWeight, numVar ) );
+  memory.push_back( tables );
+  ++nbuilt;
+
+  if ( dir.empty() ) return tables;
+
+  mkdir( dir.c_str(), 0755 );   // fails harmlessly if the directory exists
+
+  std::ostringstream tmpname;
+  tmpname << fname << "." << getpid();
+
+  try {
+    tables->write( tmpname.str() );
+  }
+  catch ( GenericException const& ) {
+    remove( tmpname.str().c_str() );   // e.g. a read-only directory: the disk store is simply not used
+    return tables;
+  }
+
+  if ( 0 != rename( tmpname.str().c_str(), fname.c_str() ) ) {
+    remove( tmpname.str().c_str() );
+  }
+
+  return tables;
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+void MonomialTables::setDirectory( std::string const& dir )
+{
+  boost::mutex::scoped_lock lock( state_mutex );
+
+  directory_     = dir;
+  directory_set  = true;
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+std::string MonomialTables::directory()
+{
+  boost::mutex::scoped_lock lock( state_mutex );
+
+  return currentDirectory();
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+void MonomialTables::clear()
+{
+  boost::mutex::scoped_lock lock( state_mutex );
+
+  memory.clear();
+  nbuilt  = 0;
+  nloaded = 0;
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+int MonomialTables::built()
+{
+  boost::mutex::scoped_lock lock( state_mutex );
+  return nbuilt;
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+int MonomialTables::loaded()
+{
+  boost::mutex::scoped_lock lock( state_mutex );
+  return nloaded;
+}
@@ -105,12 +105,19 @@ template<>
 JLPtr<std::complex<double> >  TJL<std::complex<double> >::makeTJL(  TJL<double> const& x )
 {
 
-  if (thePool_.empty() ) return JLPtr<std::complex<double> >( new TJL<std::complex<double> >(x) );
+  std::vector<TJL<std::complex<double> >* >& pool = thePool();
 
-  TJL<std::complex<double> >* p = thePool_.back(); thePool_.pop_back(); 
+  MXYZPTLK_STAT( JetStatistics::jlMade( !pool.empty(), true, x.myEnv_->numVar(), x.myEnv_->maxWeight() ) );
+
+  if (pool.empty() ) return JLPtr<std::complex<double> >( new TJL<std::complex<double> >(x) );
+
+  TJL<std::complex<double> >* p = pool.back(); pool.pop_back(); 
   
+  p->myEnv_    = x.myEnv_;  // implicit conversion. Set first: initStore() records the environment.
+
   if (p->jltermStoreCapacity_ < x.jltermStoreCapacity_)  
   { 
+       MXYZPTLK_STAT( JetStatistics::storeReleased( p->jltermStoreCapacity_*sizeof(TJLterm<std::complex<double> >) ) );
        TJLterm<std::complex<double> >::array_deallocate( p->jltermStore_ );
        p->initStore(x.jltermStoreCapacity_);   
   
@@ -120,7 +127,6 @@ JLPtr<std::complex<double> >  TJL<std::complex<double> >::makeTJL(  TJL<double>
   p->weight_   = x.weight_;  
   p->accuWgt_  = x.accuWgt_;
   p->lowWgt_   = x.lowWgt_;
-  p->myEnv_    = x.myEnv_;  // implicit conversion
  
 
   //--------------------------------------------------------------------------
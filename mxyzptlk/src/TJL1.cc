@@ -80,10 +80,12 @@ template<>
 JL1Ptr<std::complex<double> > TJL1<std::complex<double> >::makeTJL( const TJL1<double>& x )
 {
  
-  if (thePool_.empty() ) 
+  std::vector<TJL1<std::complex<double> >* >& pool = thePool();
+
+  if (pool.empty() ) 
      return JL1Ptr<std::complex<double> >(new TJL1<std::complex<double> >(x) );
  
-  TJL1<std::complex<double> >* p = thePool_.back(); thePool_.pop_back(); 
+  TJL1<std::complex<double> >* p = pool.back(); pool.pop_back(); 
   
   if ( p->count_  != x.myEnv_->numVar()+1) {
       delete [] p->jcb_; 
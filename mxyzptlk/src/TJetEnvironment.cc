@@ -77,6 +77,8 @@ EnvPtr<std::complex<double> >  TJetEnvironment<std::complex<double> >::makeJetEn
    *itc = std::complex<double>(*it, 0.0) ;
  }
 
+ boost::recursive_mutex::scoped_lock lock( TJetEnvironment<std::complex<double> >::mutex_ );
+
  TJetEnvironment<std::complex<double> >* pje 
    = new TJetEnvironment<std::complex<double> >( env->maxWeight(), env->numVar(), env->spaceDim(), 
                                                                                   tmp_refpoints );
@@ -124,6 +126,8 @@ EnvPtr<double>  TJetEnvironment<double>::getApproxJetEnvironment(int maxweight,
   //   Otherwise, return a NULL environment
   //-------------------------------------------------
  
+  boost::recursive_mutex::scoped_lock lock( TJetEnvironment<double>::mutex_ );
+
   TJetEnvironment<double>* pje = new TJetEnvironment<double>( maxweight, refpoints.Dim(), refpoints.Dim(), refpoints );
   
   int nvar = refpoints.Dim();
@@ -156,6 +160,8 @@ TJetEnvironment<std::complex<double> >::makeRealJetEnvironment(EnvPtr<std::compl
 
  TVector<double> tmp_refpoints = real( env->refPoint() );
  
+ boost::recursive_mutex::scoped_lock lock( TJetEnvironment<double>::mutex_ );
+
  TJetEnvironment<double>* pje = new TJetEnvironment<double>( env->maxWeight(), env->numVar(), env->spaceDim(), tmp_refpoints );
 
  for( std::list<EnvPtr<double> >::iterator env_iter  = TJetEnvironment<double>::environments_.begin(); 
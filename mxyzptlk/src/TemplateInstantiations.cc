@@ -43,6 +43,8 @@
 #include <mxyzptlk/TMapping.tcc>
 #include <mxyzptlk/TLieOperator.h>
 #include <mxyzptlk/TLieOperator.tcc>
+#include <mxyzptlk/JetStatistics.h>
+#include <mxyzptlk/MonomialTables.h>
 
 #include <gms/FastPODAllocator.h>
 #include <gms/FastAllocator.h>
@@ -422,6 +424,18 @@ class std::deque<Tparam<double>* >;
 template
 class std::deque<Tparam<std::complex<double> >* >;
 
+template
+class std::vector<JetStatistics::EnvironmentCounters>;
+
+template
+class std::vector<IntArray>;
+
+template
+class std::vector<std::size_t>;
+
+template
+class std::vector<boost::shared_ptr<MonomialTables const> >;
+
 
 #endif // MXYZPTLK_EXPLICIT_TEMPLATES 
 
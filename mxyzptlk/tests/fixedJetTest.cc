@@ -0,0 +1,174 @@
+////////////////////////////////////////////////////////////
+//
+// File:          fixedJetTest.cc
+//
+////////////////////////////////////////////////////////////
+//
+// Compares FixedJet<Order,NVar> against Jet.
+//
+// The same templated code -- a drift and a thick "kick"
+// written out in the test, plus an expression exercising
+// every elementary function -- is evaluated with Jet and
+// with FixedJet components. The FixedJet results, converted to
+// Jets, must agree with the Jet results to within rounding.
+// Round trip conversions Jet -> FixedJet -> Jet must be exact.
+//
+// ------------
+// COMMAND LINE
+// ------------
+// fixedJetTest [options]
+//
+// -------
+// OPTIONS
+// -------
+// Note: NNN represents an integer
+//
+// -steps   NNN   number of drift/kick steps
+//                : default = 10
+//
+////////////////////////////////////////////////////////////
+
+#include <iostream>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+
+#include <mxyzptlk/Jet.h>
+#include <mxyzptlk/JetC.h>
+#include <mxyzptlk/FixedJet.h>
+
+using namespace std;
+
+namespace {
+
+int const order  = 4;
+int const numvar = 3;
+
+typedef FixedJet<order,numvar>                       FJet;
+typedef FixedJet<order,numvar,std::complex<double> > FJetC;
+
+// ------------------------------------------------------
+// x, px and dp/p; written like the propagate() templates
+// ------------------------------------------------------
+
+template<typename Component_t>
+void step( Component_t* state, double length, double k2 )
+{
+  Component_t npz = sqrt( pow( 1.0 + state[2], 2 ) - state[1]*state[1] );
+  Component_t xpr = state[1]/npz;
+
+  state[0] += length*xpr;
+  state[1] -= k2*( state[0]*state[0] )/( 1.0 + state[2] ) + 0.01*sinh( state[0] )*cosh( state[1] );
+}
+
+template<typename Component_t>
+Component_t expression( Component_t const& x, Component_t const& y, Component_t const& z )
+{
+  return   exp( x )*log( 2.0 + y ) - sin( x*y )/( 3.0 + cos( z ) )
+         + asin( 0.1 + 0.5*x ) + atan( y - z ) + tan( 0.3*z ) + pow( 1.5 + x*z, -1.5 );
+}
+
+double difference( Jet const& a, Jet const& b )
+{
+  // largest difference between coefficients, relative
+  // to the largest coefficient of a (or 1, if smaller)
+
+  double scale = 1.0;
+  for ( Jet::const_iterator it = a.begin(); it != a.end(); ++it ) {
+    scale = std::max( scale, std::abs( it->value_ ) );
+  }
+
+  double diff = 0.0;
+  Jet d = a - b;
+  for ( Jet::const_iterator it = d.begin(); it != d.end(); ++it ) {
+    diff = std::max( diff, std::abs( it->value_ )/scale );
+  }
+  return diff;
+}
+
+} // anonymous namespace
+
+int main( int argc, char** argv )
+{
+  int nsteps = 10;
+
+  for ( int i=1; i<argc; ++i ) {
+    if ( 0 == strcmp( argv[i], "-steps" ) && i+1 < argc ) { nsteps = atoi( argv[++i] ); }
+  }
+
+  Jet__environment::BeginEnvironment( order );
+    coord cx( 0.0 ), cy( 0.0 ), cz( 0.0 );
+  Jet__environment_ptr env = Jet__environment::EndEnvironment();
+  Jet__environment::pushEnv( env );
+
+  double const tolerance = 1.0e-12;
+  int status = 0;
+
+  // -----------------------------------
+  // Elementary functions
+  // -----------------------------------
+
+  Jet x = cx + 0.1;
+  Jet y = cy + 0.2;
+  Jet z = cz - 0.3;
+
+  FJet fx = FJet::variable( 0,  0.1 );
+  FJet fy = FJet::variable( 1,  0.2 );
+  FJet fz = FJet::variable( 2, -0.3 );
+
+  double diff = difference( expression( x, y, z ), expression( fx, fy, fz ).toJet( env ) );
+  if ( diff > tolerance ) {
+    cout << "*** ERROR *** Elementary functions: FixedJet and Jet differ by " << diff << endl;
+    status = 1;
+  }
+
+  // -----------------------------------
+  // Round trip conversions
+  // -----------------------------------
+
+  Jet f = expression( x, y, z );
+  if ( difference( f, FJet( f ).toJet( env ) ) != 0.0 ) {
+    cout << "*** ERROR *** Jet -> FixedJet -> Jet conversion is not exact." << endl;
+    status = 1;
+  }
+
+  // -----------------------------------
+  // Complex components
+  // -----------------------------------
+
+  FJetC w  = std::complex<double>( 0.0, 1.0 )*FJetC( fx ) + FJetC( fy );
+  FJet  re = real( exp( w ) );
+  FJet  im = imag( exp( w ) );
+
+  if (    difference( re.toJet( env ), exp( y )*cos( x ) ) > tolerance
+       || difference( im.toJet( env ), exp( y )*sin( x ) ) > tolerance ) {
+    cout << "*** ERROR *** Complex FixedJet differs from Jet." << endl;
+    status = 1;
+  }
+
+  // -----------------------------------
+  // Map built by repeated steps
+  // -----------------------------------
+
+  Jet  jstate[numvar] = { cx + 1.0e-3, cy + 2.0e-3, cz + 3.0e-3 };
+  FJet fstate[numvar];
+
+  for ( int i=0; i<numvar; ++i ) {
+    fstate[i] = FJet::variable( i, 1.0e-3*(i+1) );
+  }
+
+  for ( int n=0; n<nsteps; ++n ) {
+    step( jstate, 0.5, 0.8 );
+    step( fstate, 0.5, 0.8 );
+  }
+
+  for ( int i=0; i<numvar; ++i ) {
+    diff = difference( jstate[i], fstate[i].toJet( env ) );
+    if ( diff > tolerance ) {
+      cout << "*** ERROR *** Component " << i << ": FixedJet and Jet maps differ by " << diff << endl;
+      status = 1;
+    }
+  }
+
+  return status;
+}
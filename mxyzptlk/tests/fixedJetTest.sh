@@ -0,0 +1,15 @@
+#!/bin/csh
+
+./fixedJetTest
+set return_status = $status
+if( 0 != $return_status ) then
+  exit $return_status
+  endif
+
+./fixedJetTest -steps 40
+set return_status = $status
+if( 0 != $return_status ) then
+  exit $return_status
+  endif
+
+exit 0
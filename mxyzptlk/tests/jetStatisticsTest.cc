@@ -0,0 +1,220 @@
+////////////////////////////////////////////////////////////
+//
+// File:          jetStatisticsTest.cc
+//
+////////////////////////////////////////////////////////////
+//
+// Checks the JetStatistics counters.
+//
+// A nonlinear map is iterated a few times; then
+//
+//  - every jet made is discarded once the map goes out
+//    of scope;
+//  - the stores of high order jets have been regrown;
+//  - the environment appears in the breakdown, and a
+//    complex jet in the complex breakdown;
+//  - the same computation repeated takes all its jets
+//    from the recycling pool;
+//  - the jets made by another thread are in the totals
+//    but not in the counters of this thread;
+//  - reset() zeroes the counters.
+//
+// If mxyzptlk was compiled without MXYZPTLK_STATISTICS,
+// checks that the counters stay at zero.
+//
+// ------------
+// COMMAND LINE
+// ------------
+// jetStatisticsTest [options]
+//
+// -------
+// OPTIONS
+// -------
+// Note: NNN represents an integer
+//
+// -order   NNN   order of the map
+//                : default = 6
+//
+////////////////////////////////////////////////////////////
+
+#include <iostream>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <boost/thread.hpp>
+
+#include <mxyzptlk/Jet.h>
+#include <mxyzptlk/JetC.h>
+#include <mxyzptlk/Mapping.h>
+#include <mxyzptlk/JetStatistics.h>
+
+using namespace std;
+
+namespace {
+
+int const dim = 4;
+
+void iterate( Jet__environment_ptr const& env )
+{
+  Mapping map( "identity", env );
+
+  for ( int n=0; n<3; ++n ) {
+    Jet const x = map[0], y = map[1], px = map[2], py = map[3];
+    map[0] = 0.8*x + 0.6*px;
+    map[1] = 0.6*y + 0.8*py;
+    map[2] = px - 0.1*( x*x - y*y ) + 0.01*sin(x);
+    map[3] = py + 0.2*x*y;
+  }
+}
+
+struct Iterate {
+  Iterate( Jet__environment_ptr const& env ) : env_(env) {}
+  void operator()() { iterate( env_ ); }
+  Jet__environment_ptr env_;
+};
+
+bool hasEnvironment( bool complex, int nvar, int order )
+{
+  std::vector<JetStatistics::EnvironmentCounters> const envs = JetStatistics::environments();
+
+  for ( unsigned int i=0; i<envs.size(); ++i ) {
+    if ( envs[i].complex == complex && envs[i].numVar == nvar && envs[i].maxWeight == order && envs[i].jets > 0 ) return true;
+  }
+  return false;
+}
+
+} // anonymous namespace
+
+int main( int argc, char** argv )
+{
+  int order = 6;
+
+  for( int i = 1; i < argc; ++i ) {
+    if( 0 == strcmp( argv[i], "-order" ) && i+1 < argc ) { order = atoi( argv[++i] ); }
+    else {
+      cerr << "Usage: " << argv[0] << " [-order n]" << endl;
+      return 1;
+    }
+  }
+
+  Jet__environment_ptr env = Jet__environment::makeJetEnvironment( order, dim, dim );
+
+  JetStatistics::reset();
+
+  iterate( env );
+
+  JetStatistics::Counters const first = JetStatistics::thread();
+
+  if ( !JetStatistics::enabled() ) {
+
+    JetStatistics::report( cout );
+
+    if ( first.jlNew != 0 || first.jlRecycled != 0 || first.storeAllocations != 0 || JetStatistics::peakStoreBytes() != 0 ) {
+      cout << "*** ERROR *** The counters are not zero." << endl;
+      return 1;
+    }
+    return 0;
+  }
+
+  int status = 0;
+
+  cout << "first pass:\n" << first << endl;
+
+  unsigned long const made = first.jlNew + first.jlRecycled;
+
+  if ( made == 0 || first.jlDiscarded != made ) {
+    cout << "*** ERROR *** " << made << " jets made, " << first.jlDiscarded << " discarded." << endl;
+    status = 1;
+  }
+
+  if ( first.storeRegrowths == 0 || first.jlPtrCopies == 0 ) {
+    cout << "*** ERROR *** No store regrowth or no JLPtr copy was counted." << endl;
+    status = 1;
+  }
+
+  if ( !hasEnvironment( false, dim, order ) ) {
+    cout << "*** ERROR *** The environment is missing from the breakdown." << endl;
+    status = 1;
+  }
+
+  if ( JetStatistics::peakStoreBytes() < JetStatistics::liveStoreBytes() || JetStatistics::peakStoreBytes() == 0 ) {
+    cout << "*** ERROR *** Peak store memory " << JetStatistics::peakStoreBytes()
+         << " bytes, live " << JetStatistics::liveStoreBytes() << " bytes." << endl;
+    status = 1;
+  }
+
+  //---------------------------------------------------------------------
+  // the same computation, from the recycling pool
+  //---------------------------------------------------------------------
+
+  iterate( env );
+
+  JetStatistics::Counters const second = JetStatistics::thread() - first;
+
+  cout << "second pass:\n" << second << endl;
+
+  if ( second.jlNew != 0 || second.poolHitRate() != 1.0 ) {
+    cout << "*** ERROR *** The second pass allocated " << second.jlNew << " new jets." << endl;
+    status = 1;
+  }
+
+  if ( second.jlNew + second.jlRecycled != made ) {
+    cout << "*** ERROR *** The two passes made a different number of jets." << endl;
+    status = 1;
+  }
+
+  if ( second.storeRegrowths > first.storeRegrowths ) {
+    cout << "*** ERROR *** The recycled stores were regrown more often." << endl;
+    status = 1;
+  }
+
+  //---------------------------------------------------------------------
+  // complex jets
+  //---------------------------------------------------------------------
+
+  {
+    JetC__environment_ptr cenv = JetC__environment::makeJetEnvironment( order, dim, dim );
+    JetC z( std::complex<double>( 1.0, 0.5 ), cenv );
+    z = z*z;
+  }
+
+  if ( !hasEnvironment( true, dim, order ) ) {
+    cout << "*** ERROR *** The complex environment is missing from the breakdown." << endl;
+    status = 1;
+  }
+
+  //---------------------------------------------------------------------
+  // another thread
+  //---------------------------------------------------------------------
+
+  JetStatistics::Counters const mine  = JetStatistics::thread();
+  JetStatistics::Counters const total = JetStatistics::total();
+
+  boost::thread worker( (Iterate( env )) );
+  worker.join();
+
+  JetStatistics::Counters const others = JetStatistics::total() - total;
+
+  if ( ( JetStatistics::thread() - mine ).jlNew != 0 || others.jlNew + others.jlRecycled != made ) {
+    cout << "*** ERROR *** The jets of the other thread are not counted separately." << endl;
+    status = 1;
+  }
+
+  JetStatistics::report( cout );
+
+  //---------------------------------------------------------------------
+  // reset
+  //---------------------------------------------------------------------
+
+  JetStatistics::reset();
+
+  JetStatistics::Counters const zero = JetStatistics::total();
+
+  if ( zero.jlNew != 0 || zero.jlDiscarded != 0 || zero.storeBytes != 0 || !JetStatistics::environments().empty()
+       || JetStatistics::peakStoreBytes() != JetStatistics::liveStoreBytes() ) {
+    cout << "*** ERROR *** reset() did not zero the counters." << endl;
+    status = 1;
+  }
+
+  return status;
+}
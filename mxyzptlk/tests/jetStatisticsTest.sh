@@ -0,0 +1,15 @@
+#!/bin/csh
+
+./jetStatisticsTest
+set return_status = $status
+if( 0 != $return_status ) then
+  exit $return_status
+  endif
+
+./jetStatisticsTest -order 9
+set return_status = $status
+if( 0 != $return_status ) then
+  exit $return_status
+  endif
+
+exit 0
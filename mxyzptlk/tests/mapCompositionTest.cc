@@ -0,0 +1,205 @@
+////////////////////////////////////////////////////////////
+//
+// File:          mapCompositionTest.cc
+//
+////////////////////////////////////////////////////////////
+//
+// Checks the composition of maps, Mapping::operator()
+// and Mapping::operator*=.
+//
+// Two nonlinear 6D maps a and b (kicked rotations with 
+// constant offsets, so that every monomial of a has terms 
+// of lower weight) are composed and the result is compared 
+// with a direct expansion: each component of b( a ) is 
+// summed term by term, the monomials of a being built with 
+// Jet multiplications. Then
+//
+//  - the composition computed with several threads must be 
+//    bit-for-bit identical to the serial one; 
+//  - b *= a must give b( a ); 
+//  - the composition of a single Jet, b[i]( a ), must give
+//    the component i of b( a ). 
+//
+// ------------
+// COMMAND LINE
+// ------------
+// mapCompositionTest [options]
+//
+// -------
+// OPTIONS
+// -------
+// Note: NNN represents an integer
+//
+// -order   NNN   order of the maps
+//                : default = 5
+// -threads NNN   number of threads
+//                : default = 4
+//
+////////////////////////////////////////////////////////////
+
+#include <iostream>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+
+#include <mxyzptlk/Jet.h>
+#include <mxyzptlk/Mapping.h>
+
+using namespace std;
+
+namespace {
+
+int const dim = 6;
+
+Mapping kickedRotation( Jet__environment_ptr const& env, double mu, double k2, double offset )
+{
+  Mapping map( "identity", env );
+
+  Jet x = map[0], y = map[1], z = map[2], px = map[3], py = map[4], pz = map[5];
+
+  px = px - k2*( x*x - y*y ) - 0.05*sin(x)*z + offset;
+  py = py + 2.0*k2*x*y + 0.02*exp(y)*z*z;
+  pz = pz - 0.1*x*x*x;
+
+  map[0] =  cos(mu)*x + sin(mu)*px + offset;   map[3] = -sin(mu)*x + cos(mu)*px;
+  map[1] =  cos(mu)*y + sin(mu)*py;            map[4] = -sin(mu)*y + cos(mu)*py - offset;
+  map[2] =  z + 0.1*pz;                        map[5] =  pz;
+
+  return map;
+}
+
+//
+// b( a ), term by term
+//
+
+Mapping expansion( Mapping const& b, Mapping const& a, Jet__environment_ptr const& env )
+{
+  Mapping z( dim, env );
+
+  for ( int i=0; i<dim; ++i ) {
+
+    Jet sum( 0.0, env );
+
+    for ( Jet::const_iterator it = b[i].begin(); it != b[i].end(); ++it ) {
+
+      IntArray const& exponents = it->exponents( env );
+
+      Jet monomial( 1.0, env );
+      for ( int j=0; j<dim; ++j ) {
+        for ( int e=0; e<exponents[j]; ++e ) { monomial = monomial*a[j]; }
+      }
+      sum = sum + it->coefficient()*monomial;
+    }
+    z[i] = sum;
+  }
+
+  return z;
+}
+
+double maxdiff( Mapping const& a, Mapping const& b )
+{
+  double d = 0.0;
+
+  for ( int i=0; i<dim; ++i ) {
+    Jet const diff = a[i] - b[i];
+    for ( Jet::const_iterator it = diff.begin(); it != diff.end(); ++it ) {
+      d = std::max( d, std::abs( it->coefficient() ) );
+    }
+  }
+  return d;
+}
+
+bool identical( Mapping const& a, Mapping const& b )
+{
+  for ( int i=0; i<dim; ++i ) {
+
+    Jet::const_iterator it = a[i].begin();
+    Jet::const_iterator jt = b[i].begin();
+
+    for ( ; it != a[i].end() && jt != b[i].end(); ++it, ++jt ) {
+      if ( it->offset_ != jt->offset_ ) return false;
+      if ( memcmp( &it->value_, &jt->value_, sizeof(double) ) != 0 ) return false;
+    }
+    if ( ( it != a[i].end() ) || ( jt != b[i].end() ) ) return false;
+  }
+  return true;
+}
+
+} // anonymous namespace
+
+int main( int argc, char** argv )
+{
+  int order    = 5;
+  int nthreads = 4;
+
+  for ( int i=1; i<argc; ++i ) {
+    if      ( 0 == strcmp( argv[i], "-order"   ) && i+1 < argc ) { order    = atoi( argv[++i] ); }
+    else if ( 0 == strcmp( argv[i], "-threads" ) && i+1 < argc ) { nthreads = atoi( argv[++i] ); }
+  }
+
+  Jet__environment_ptr env = Jet__environment::makeJetEnvironment( order, dim, dim );
+  Jet__environment::pushEnv( env );
+
+  Mapping const a = kickedRotation( env, 2.0*M_PI*0.21, 0.3,  1.0e-2 );
+  Mapping const b = kickedRotation( env, 2.0*M_PI*0.17, 0.5, -2.0e-2 );
+
+  int status = 0;
+
+  // ---------------------------------------
+  // serial composition
+  // ---------------------------------------
+
+  Jet__environment::setCompositionThreads( 1 );
+
+  Mapping const serial = b( a );
+  Mapping const direct = expansion( b, a, env );
+
+  double const d = maxdiff( serial, direct );
+
+  if ( d > 1.0e-12 ) {
+    cout << "*** ERROR *** The composition differs from the direct expansion by " << d << endl;
+    status = 1;
+  }
+
+  // ---------------------------------------
+  // threaded composition
+  // ---------------------------------------
+
+  Jet__environment::setCompositionThreads( nthreads );
+
+  if ( !identical( b( a ), serial ) ) {
+    cout << "*** ERROR *** The composition computed with " << nthreads << " threads differs from the serial one." << endl;
+    status = 1;
+  }
+
+  // ---------------------------------------
+  // in place composition
+  // ---------------------------------------
+
+  Mapping c = b;
+  c *= a;
+
+  if ( !identical( c, serial ) ) {
+    cout << "*** ERROR *** b *= a differs from b( a )." << endl;
+    status = 1;
+  }
+
+  Jet__environment::setCompositionThreads( 1 );
+
+  // ---------------------------------------
+  // composition of a single jet 
+  // ---------------------------------------
+
+  for ( int i=0; i<dim; ++i ) {
+    Mapping single = serial;
+    single[i] = b[i]( a );
+    if ( !identical( single, serial ) ) {
+      cout << "*** ERROR *** The composition of component " << i << " differs from the one of the map." << endl;
+      status = 1;
+    }
+  }
+
+  Jet__environment::popEnv();
+
+  return status;
+}
@@ -0,0 +1,15 @@
+#!/bin/csh
+
+./mapCompositionTest
+set return_status = $status
+if( 0 != $return_status ) then
+  exit $return_status
+  endif
+
+./mapCompositionTest -order 7 -threads 3
+set return_status = $status
+if( 0 != $return_status ) then
+  exit $return_status
+  endif
+
+exit 0
@@ -0,0 +1,143 @@
+////////////////////////////////////////////////////////////
+//
+// File:          mappingEvaluatorTest.cc
+//
+////////////////////////////////////////////////////////////
+//
+// Compares MappingEvaluator against Mapping::operator().
+//
+// A nonlinear 6D map is built in an environment with a
+// nonzero reference point and evaluated at random points,
+// one at a time through the Vector interface and in batches
+// (out of place and in place). The batch size is not a
+// multiple of the evaluator block size. The results must
+// agree with Mapping::operator() to within rounding.
+//
+// ------------
+// COMMAND LINE
+// ------------
+// mappingEvaluatorTest [options]
+//
+// -------
+// OPTIONS
+// -------
+// Note: NNN represents an integer
+//
+// -order   NNN   order of the map
+//                : default = 5
+// -n       NNN   number of points
+//                : default = 1001
+//
+////////////////////////////////////////////////////////////
+
+#include <iostream>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <vector>
+
+#include <basic_toolkit/VectorD.h>
+#include <mxyzptlk/Jet.h>
+#include <mxyzptlk/Mapping.h>
+#include <mxyzptlk/MappingEvaluator.h>
+
+using namespace std;
+
+int main( int argc, char** argv )
+{
+  int order = 5;
+  int n     = 1001;
+
+  for ( int i=1; i<argc; ++i ) {
+    if      ( 0 == strcmp( argv[i], "-order" ) && i+1 < argc ) { order = atoi( argv[++i] ); }
+    else if ( 0 == strcmp( argv[i], "-n"     ) && i+1 < argc ) { n     = atoi( argv[++i] ); }
+  }
+
+  int const dim = 6;
+
+  Vector ref( dim );
+  for ( int i=0; i<dim; ++i ) { ref[i] = 1.0e-3*(i+1); }
+
+  Jet__environment_ptr env = Jet__environment::makeJetEnvironment( order, dim, dim, ref );
+  Jet__environment::pushEnv( env );
+
+  // ---------------------------------------
+  // A few turns of a kicked 6D rotation
+  // ---------------------------------------
+
+  Mapping map( "identity", env );
+
+  for ( int turn=0; turn<3; ++turn ) {
+
+    Jet x = map[0], y = map[1], z = map[2], px = map[3], py = map[4], pz = map[5];
+
+    px = px - 0.3*( x*x - y*y ) - 0.05*sin(x)*z;
+    py = py + 0.6*x*y + 0.02*exp(y)*z*z;
+    pz = pz - 0.1*x*x*x;
+
+    map[0] =  0.6*x + 0.8*px;   map[3] = -0.8*x + 0.6*px;
+    map[1] =  0.8*y + 0.6*py;   map[4] = -0.6*y + 0.8*py;
+    map[2] =  z + 0.1*pz;       map[5] =  pz;
+  }
+
+  MappingEvaluator evaluator( map );
+
+  // ---------------------------------------
+  // Random points around the reference
+  // ---------------------------------------
+
+  srand48( 12345 );
+
+  std::vector<std::vector<double> > coords( dim, std::vector<double>(n) );
+  for ( int j=0; j<n; ++j ) {
+    for ( int i=0; i<dim; ++i ) { coords[i][j] = ref[i] + 1.0e-2*( 2.0*drand48() - 1.0 ); }
+  }
+
+  std::vector<std::vector<double> > result( coords );
+
+  std::vector<double const*> in ( dim );
+  std::vector<double*>       out( dim );
+  std::vector<double*>       inplace( dim );
+
+  for ( int i=0; i<dim; ++i ) {
+    in[i]      = &coords[i][0];
+    out[i]     = &result[i][0];
+  }
+
+  evaluator( &in[0], &out[0], n );
+
+  std::vector<std::vector<double> > updated( coords );
+  for ( int i=0; i<dim; ++i ) { inplace[i] = &updated[i][0]; }
+
+  evaluator( &inplace[0], n );
+
+  // ---------------------------------------
+  // Compare
+  // ---------------------------------------
+
+  double const tolerance = 1.0e-13;
+  double maxdiff = 0.0;
+
+  for ( int j=0; j<n; ++j ) {
+
+    Vector x( dim );
+    for ( int i=0; i<dim; ++i ) { x[i] = coords[i][j]; }
+
+    Vector expected = map( x );
+    Vector single   = evaluator( x );
+
+    for ( int i=0; i<dim; ++i ) {
+      double const scale = std::max( 1.0, std::abs( expected[i] ) );
+      maxdiff = std::max( maxdiff, std::abs( single[i]     - expected[i] )/scale );
+      maxdiff = std::max( maxdiff, std::abs( result[i][j]  - expected[i] )/scale );
+      maxdiff = std::max( maxdiff, std::abs( updated[i][j] - expected[i] )/scale );
+    }
+  }
+
+  if ( maxdiff > tolerance ) {
+    cout << "*** ERROR *** MappingEvaluator and Mapping differ by " << maxdiff << endl;
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,15 @@
+#!/bin/csh
+
+./mappingEvaluatorTest
+set return_status = $status
+if( 0 != $return_status ) then
+  exit $return_status
+  endif
+
+./mappingEvaluatorTest -order 8 -n 63
+set return_status = $status
+if( 0 != $return_status ) then
+  exit $return_status
+  endif
+
+exit 0
@@ -0,0 +1,254 @@
+////////////////////////////////////////////////////////////
+//
+// File:          monomialTablesTest.cc
+//
+////////////////////////////////////////////////////////////
+//
+// Checks the persistent MonomialTables.
+//
+//  - tables written to a file and mapped back are identical
+//    to the tables built in memory;
+//  - the multiplication table agrees with the sum of the
+//    exponents;
+//  - an environment created when its tables are in the disk
+//    store maps them instead of building them, and jets
+//    multiply as expected with the mapped tables;
+//  - a corrupt or truncated file is rejected, and get()
+//    replaces it.
+//
+// The files are written in a scratch directory, which is
+// removed at the end.
+//
+// ------------
+// COMMAND LINE
+// ------------
+// monomialTablesTest [options]
+//
+// -------
+// OPTIONS
+// -------
+// Note: NNN represents an integer
+//
+// -order   NNN   maximum weight of the tables
+//                : default = 6
+// -dim     NNN   number of variables
+//                : default = 4
+//
+////////////////////////////////////////////////////////////
+
+#include <iostream>
+#include <sstream>
+#include <fstream>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include <basic_toolkit/GenericException.h>
+#include <mxyzptlk/Jet.h>
+#include <mxyzptlk/Mapping.h>
+#include <mxyzptlk/MonomialTables.h>
+
+using namespace std;
+
+namespace {
+
+bool sameTables( MonomialTables const& a, MonomialTables const& b )
+{
+  if ( a.maxWeight() != b.maxWeight() || a.numVar() != b.numVar() || a.maxTerms() != b.maxTerms() ) return false;
+
+  for ( int w=0; w <= a.maxWeight()+1; ++w ) {
+    if ( a.weightOffset(w) != b.weightOffset(w) ) return false;
+  }
+
+  for ( int i=0; i < a.maxTerms(); ++i ) {
+    if ( !( a.exponents(i) == b.exponents(i) ) || a.rowLength(i) != b.rowLength(i) ) return false;
+    for ( int j=0; j < a.rowLength(i); ++j ) {
+      if ( a.multRow(i)[j] != b.multRow(i)[j] ) return false;
+    }
+  }
+  return true;
+}
+
+bool consistent( MonomialTables const& t )
+{
+  for ( int i=0; i < t.maxTerms(); ++i ) {
+    if ( t.offsetIndex( t.exponents(i) ) != i ) return false;
+    for ( int j=0; j < t.maxTerms(); ++j ) {
+      IntArray const exp = t.exponents(i) + t.exponents(j);
+      if ( exp.Sum() > t.maxWeight() ) continue;
+      if ( !( t.exponents( t.multOffset(i,j) ) == exp ) ) return false;
+    }
+  }
+  return true;
+}
+
+Jet polynomial( Jet__environment_ptr const& env, int seed )
+{
+  Mapping const id( "identity", env );
+
+  Jet p( 0.0, env );
+  for ( int i=0; i < env->numVar(); ++i ) { p = p + ( 0.1*seed + 0.3*i )*id[i]; }
+
+  return exp( p ) + p*p;
+}
+
+//
+// c = a*b, computed term by term from the exponents
+//
+
+double productError( Jet const& a, Jet const& b, Jet const& c, MonomialTables const& t )
+{
+  Jet__environment_ptr const env = a.Env();
+
+  vector<double> expected( t.maxTerms(), 0.0 );
+
+  for ( Jet::const_iterator ia = a.begin(); ia != a.end(); ++ia ) {
+    for ( Jet::const_iterator ib = b.begin(); ib != b.end(); ++ib ) {
+      IntArray const exp = ia->exponents(env) + ib->exponents(env);
+      if ( exp.Sum() > t.maxWeight() ) continue;
+      expected[ t.offsetIndex(exp) ] += ia->coefficient() * ib->coefficient();
+    }
+  }
+
+  for ( Jet::const_iterator ic = c.begin(); ic != c.end(); ++ic ) {
+    expected[ t.offsetIndex( ic->exponents(env) ) ] -= ic->coefficient();
+  }
+
+  double err = 0.0;
+  for ( int i=0; i < t.maxTerms(); ++i ) { err = std::max( err, std::abs( expected[i] ) ); }
+  return err;
+}
+
+} // anonymous namespace
+
+int main( int argc, char** argv )
+{
+  int order = 6;
+  int dim   = 4;
+
+  for( int i = 1; i < argc; ++i ) {
+    if     ( 0 == strcmp( argv[i], "-order" ) && i+1 < argc ) { order = atoi( argv[++i] ); }
+    else if( 0 == strcmp( argv[i], "-dim"   ) && i+1 < argc ) { dim   = atoi( argv[++i] ); }
+    else {
+      cerr << "Usage: " << argv[0] << " [-order n] [-dim n]" << endl;
+      return 1;
+    }
+  }
+
+  int status = 0;
+
+  ostringstream dirname;
+  dirname << "monomialTablesTest." << getpid();
+  string const dir = dirname.str();
+
+  mkdir( dir.c_str(), 0755 );
+
+  MonomialTables::setDirectory( dir );
+
+  //---------------------------------------------------------------------
+  // built and mapped tables
+  //---------------------------------------------------------------------
+
+  MonomialTables const built( order, dim );
+
+  if ( built.isMapped() || !consistent( built ) ) {
+    cout << "*** ERROR *** The tables built are not consistent." << endl;
+    status = 1;
+  }
+
+  string const fname = MonomialTables::fileName( dir, order, dim );
+
+  built.write( fname );
+
+  {
+    MonomialTables const mapped( fname );
+
+    if ( !mapped.isMapped() || !sameTables( built, mapped ) ) {
+      cout << "*** ERROR *** The mapped tables differ from the tables built." << endl;
+      status = 1;
+    }
+  }
+
+  //---------------------------------------------------------------------
+  // an environment whose tables are in the disk store
+  //---------------------------------------------------------------------
+
+  MonomialTables::clear();
+
+  Jet__environment_ptr env = Jet__environment::makeJetEnvironment( order, dim, dim );
+
+  if ( MonomialTables::loaded() != 1 || MonomialTables::built() != 0 || !MonomialTables::get( order, dim )->isMapped() ) {
+    cout << "*** ERROR *** The environment did not map its tables: "
+         << MonomialTables::loaded() << " loaded, " << MonomialTables::built() << " built." << endl;
+    status = 1;
+  }
+
+  Jet const a = polynomial( env, 1 );
+  Jet const b = polynomial( env, 2 );
+  Jet const c = a*b;
+
+  double const err = productError( a, b, c, built );
+
+  cout << "order " << order << ", " << dim << " variables, " << built.maxTerms() << " monomials; product error " << err << endl;
+
+  if ( c.termCount() == 0 || err > 1.0e-12*std::abs( c.standardPart() ) ) {
+    cout << "*** ERROR *** Jets multiplied with the mapped tables differ from the expected product." << endl;
+    status = 1;
+  }
+
+  //---------------------------------------------------------------------
+  // corrupt and truncated files
+  //---------------------------------------------------------------------
+
+  string const badname = MonomialTables::fileName( dir, 3, 2 );
+
+  MonomialTables( 3, 2 ).write( badname );
+
+  {
+    fstream f( badname.c_str(), ios::in | ios::out | ios::binary );
+    f.seekp( 0 );
+    f.write( "XXXXXXX", 7 );
+  }
+
+  bool rejected = false;
+  try {
+    MonomialTables const bad( badname );
+  }
+  catch ( GenericException const& ) {
+    rejected = true;
+  }
+
+  MonomialTables::clear();
+
+  boost::shared_ptr<MonomialTables const> replaced = MonomialTables::get( 3, 2 );
+
+  if ( !rejected || MonomialTables::built() != 1 || !sameTables( *replaced, MonomialTables( badname ) ) ) {
+    cout << "*** ERROR *** A corrupt file was not rejected and replaced." << endl;
+    status = 1;
+  }
+
+  truncate( badname.c_str(), 64 );
+
+  rejected = false;
+  try {
+    MonomialTables const bad( badname );
+  }
+  catch ( GenericException const& ) {
+    rejected = true;
+  }
+
+  if ( !rejected ) {
+    cout << "*** ERROR *** A truncated file was not rejected." << endl;
+    status = 1;
+  }
+
+  remove( fname.c_str() );
+  remove( badname.c_str() );
+  rmdir( dir.c_str() );
+
+  return status;
+}
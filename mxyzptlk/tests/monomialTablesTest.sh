@@ -0,0 +1,15 @@
+#!/bin/csh
+
+./monomialTablesTest
+set return_status = $status
+if( 0 != $return_status ) then
+  exit $return_status
+  endif
+
+./monomialTablesTest -order 9 -dim 6
+set return_status = $status
+if( 0 != $return_status ) then
+  exit $return_status
+  endif
+
+exit 0
@@ -0,0 +1,156 @@
+////////////////////////////////////////////////////////////
+//
+// File:          threadedJetTest.cc
+//
+////////////////////////////////////////////////////////////
+//
+// Multithreaded stress test for the Jet machinery.
+//
+// Each task computes a truncated one-turn map of a kicked
+// rotation (a 4D Henon-like map) with its own kick strengths,
+// then composes the map with itself. Environments of several
+// orders are requested from within the tasks. The tasks are
+// run first serially and then concurrently, several times
+// each; every Jet coefficient computed by the threads must
+// be bit-for-bit identical to the serial one.
+//
+// ------------
+// COMMAND LINE
+// ------------
+// threadedJetTest [options]
+//
+// -------
+// OPTIONS
+// -------
+// Note: NNN represents an integer
+//
+// -tasks   NNN   number of independent maps
+//                : default = 12
+// -threads NNN   number of threads
+//                : default = 4
+// -turns   NNN   number of turns per map
+//                : default = 10
+//
+////////////////////////////////////////////////////////////
+
+#include <iostream>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <vector>
+
+#include <boost/thread.hpp>
+#include <boost/bind.hpp>
+
+#include <mxyzptlk/Jet.h>
+#include <mxyzptlk/Mapping.h>
+
+using namespace std;
+
+namespace {
+
+void oneTurnMap( int task, int nturns, Mapping* result )
+{
+  int const order = 4 + task%3;
+
+  Jet__environment_ptr env = Jet__environment::makeJetEnvironment( order, 4, 4 );
+
+  double const k2    = 0.1  + 0.01*task;
+  double const k3    = 0.02 + 0.005*task;
+  double const mux   = 2.0*M_PI*( 0.21 + 0.001*task );
+  double const muy   = 2.0*M_PI*( 0.17 + 0.002*task );
+
+  Mapping map( "identity", env );
+
+  for ( int turn=0; turn<nturns; ++turn ) {
+
+    Jet x  = map[0];
+    Jet px = map[1];
+    Jet y  = map[2];
+    Jet py = map[3];
+
+    px = px - k2*( x*x - y*y ) - k3*sin(x)*y*y;
+    py = py + 2.0*k2*x*y + k3*exp(y)*x*x*x/( 1.0 + x );
+
+    map[0] =  cos(mux)*x + sin(mux)*px;
+    map[1] = -sin(mux)*x + cos(mux)*px;
+    map[2] =  cos(muy)*y + sin(muy)*py;
+    map[3] = -sin(muy)*y + cos(muy)*py;
+  }
+
+  *result = map( map );
+}
+
+void runTasks( int first, int last, int stride, int nturns, std::vector<Mapping>* results )
+{
+  for ( int task=first; task<last; task += stride ) {
+    oneTurnMap( task, nturns, &(*results)[task] );
+  }
+}
+
+bool identical( Mapping const& a, Mapping const& b )
+{
+  if ( a.Dim() != b.Dim() ) return false;
+
+  for ( int i=0; i<a.Dim(); ++i ) {
+
+    Jet::const_iterator it = a[i].begin();
+    Jet::const_iterator jt = b[i].begin();
+
+    for ( ; it != a[i].end() && jt != b[i].end(); ++it, ++jt ) {
+      if ( it->offset_ != jt->offset_ ) return false;
+      if ( memcmp( &it->value_, &jt->value_, sizeof(double) ) != 0 ) return false;
+    }
+    if ( ( it != a[i].end() ) || ( jt != b[i].end() ) ) return false;
+  }
+  return true;
+}
+
+} // anonymous namespace
+
+int main( int argc, char** argv )
+{
+  int ntasks   = 12;
+  int nthreads = 4;
+  int nturns   = 10;
+
+  for ( int i=1; i<argc; ++i ) {
+    if      ( 0 == strcmp( argv[i], "-tasks"   ) && i+1 < argc ) { ntasks   = atoi( argv[++i] ); }
+    else if ( 0 == strcmp( argv[i], "-threads" ) && i+1 < argc ) { nthreads = atoi( argv[++i] ); }
+    else if ( 0 == strcmp( argv[i], "-turns"   ) && i+1 < argc ) { nturns   = atoi( argv[++i] ); }
+  }
+
+  // ---------------------------------------------------
+  // The environment stack is global; the default 
+  // environment must be pushed before threads are 
+  // started.
+  // ---------------------------------------------------
+
+  Jet__environment::pushEnv( Jet__environment::makeJetEnvironment( 4, 4, 4 ) );
+
+  std::vector<Mapping> serial( ntasks );
+  runTasks( 0, ntasks, 1, nturns, &serial );
+
+  int status = 0;
+
+  for ( int pass=0; pass<3; ++pass ) {
+
+    std::vector<Mapping> threaded( ntasks );
+
+    boost::thread_group threads;
+    for ( int t=0; t<nthreads; ++t ) {
+      threads.create_thread( boost::bind( &runTasks, t, ntasks, nthreads, nturns, &threaded ) );
+    }
+    threads.join_all();
+
+    for ( int task=0; task<ntasks; ++task ) {
+      if ( !identical( serial[task], threaded[task] ) ) {
+        cout << "*** ERROR *** pass " << pass << ", task " << task
+             << ": threaded map differs from serial one." << endl;
+        status = 1;
+      }
+    }
+  }
+
+  return status;
+}
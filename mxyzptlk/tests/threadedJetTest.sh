@@ -0,0 +1,15 @@
+#!/bin/csh
+
+./threadedJetTest
+set return_status = $status
+if( 0 != $return_status ) then
+  exit $return_status
+  endif
+
+./threadedJetTest -tasks 20 -threads 7 -turns 5
+set return_status = $status
+if( 0 != $return_status ) then
+  exit $return_status
+  endif
+
+exit 0
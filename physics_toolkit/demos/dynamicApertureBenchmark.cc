@@ -0,0 +1,124 @@
+/*
+**
+** Benchmark program:
+**
+** Measures the cost of a polar dynamic aperture scan of a ring
+** of FODO cells with strong sextupoles and elliptical apertures
+** on the quadrupoles, with a DynamicAperture:
+**
+**   - every point tracked, one thread;
+**   - every point tracked, one thread per hardware thread;
+**   - with refinement, one thread per hardware thread.
+**
+** Prints the wall clock time of each scan, the number of
+** points tracked and the mean boundary amplitude over the rays.
+**
+** Usage: dynamicApertureBenchmark [-cells n] [-turns n] [-amplitudes n] [-angles n] [-refine n]
+**
+**   -cells n       : number of cells (default: 50)
+**   -turns n       : number of turns (default: 1000)
+**   -amplitudes n  : number of amplitudes per ray (default: 50)
+**   -angles n      : number of rays (default: 9)
+**   -refine n      : refinement (default: 5)
+**
+*/
+
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include <boost/date_time/posix_time/posix_time.hpp>
+
+#include <beamline/beamline.h>
+#include <beamline/Drift.h>
+#include <beamline/quadrupole.h>
+#include <beamline/sextupole.h>
+#include <beamline/Particle.h>
+#include <physics_toolkit/DynamicAperture.h>
+#include <physics_toolkit/LatticeFunctionTable.h>
+
+using namespace std;
+
+namespace {
+
+double seconds( boost::posix_time::ptime const& start )
+{
+  return ( boost::posix_time::microsec_clock::universal_time() - start ).total_microseconds()*1.0e-6;
+}
+
+void scan( char const* label, DynamicAperture& da, int nturns, int namplitudes, int nangles )
+{
+  LatticeFunctionTable lft;
+
+  boost::posix_time::ptime const start = boost::posix_time::microsec_clock::universal_time();
+
+  int const ntracked = da.polar( lft, nturns, 0.04, namplitudes, nangles );
+
+  double const t = seconds( start );
+
+  std::vector<double> const& boundary = lft["DYNAMIC_APERTURE_BOUNDARY"].column( "amplitude" );
+
+  double mean = 0.0;
+  for ( int j=0; j<nangles; ++j ) { mean += boundary[j]/nangles; }
+
+  cout << setw(28) << label << setw(12) << t << setw(10) << ntracked << setw(16) << mean << endl;
+}
+
+} // namespace
+
+int main( int argc, char** argv )
+{
+  int ncells      = 50;
+  int nturns      = 1000;
+  int namplitudes = 50;
+  int nangles     = 9;
+  int refine      = 5;
+
+  for ( int i=1; i<argc; ++i ) {
+    if      ( 0 == strcmp( argv[i], "-cells"      ) && i+1 < argc ) { ncells      = atoi( argv[++i] ); }
+    else if ( 0 == strcmp( argv[i], "-turns"      ) && i+1 < argc ) { nturns      = atoi( argv[++i] ); }
+    else if ( 0 == strcmp( argv[i], "-amplitudes" ) && i+1 < argc ) { namplitudes = atoi( argv[++i] ); }
+    else if ( 0 == strcmp( argv[i], "-angles"     ) && i+1 < argc ) { nangles     = atoi( argv[++i] ); }
+    else if ( 0 == strcmp( argv[i], "-refine"     ) && i+1 < argc ) { refine      = atoi( argv[++i] ); }
+  }
+
+  Proton pr( 100.0 );
+  double const brho = pr.refBrho();
+
+  Drift      O ( "O",  1.5 );
+  quadrupole F ( "F",  0.5,  0.12*brho );
+  quadrupole D ( "D",  0.5, -0.12*brho );
+  sextupole  SF( "SF", 0.2,  8.0*brho );
+  sextupole  SD( "SD", 0.2, -8.0*brho );
+
+  F.setAperture( BmlnElmnt::elliptical, 0.03, 0.03 );
+  D.setAperture( BmlnElmnt::elliptical, 0.03, 0.03 );
+
+  beamline ring( "RING" );
+  for ( int i=0; i<ncells; ++i ) {
+    ring.append( F ); ring.append( O ); ring.append( SF ); ring.append( O );
+    ring.append( D ); ring.append( O ); ring.append( SD ); ring.append( O );
+  }
+  ring.setLineMode( beamline::ring );
+
+  DynamicAperture da( ring, pr );
+
+  cout << namplitudes*nangles << " points, " << nturns << " turns, " << da.numberOfThreads() << " threads" << endl;
+  cout << endl;
+  cout << setw(28) << "" << setw(12) << "time [s]" << setw(10) << "tracked" << setw(16) << "boundary [m]" << endl;
+
+  int const nthreads = da.numberOfThreads();
+
+  da.setNumberOfThreads( 1 );
+  scan( "all points, 1 thread", da, nturns, namplitudes, nangles );
+
+  da.setNumberOfThreads( nthreads );
+  scan( "all points", da, nturns, namplitudes, nangles );
+
+  da.setRefinement( refine );
+  scan( "refinement", da, nturns, namplitudes, nangles );
+
+  return 0;
+}
@@ -0,0 +1,168 @@
+/*
+**
+** Benchmark program:
+**
+** Measures the cost of recording turn-by-turn coordinates at
+** the BPMs of a ring of FODO cells (one BPM per cell) with a
+** TrackingDriver and a TurnByTurnWriter:
+**
+**   - tracking only, with beamline::propagate;
+**   - tracking and recording with the driver, in double and
+**     in single precision.
+**
+** Prints the wall clock time and the throughput of each run in
+** particle-turns per second, the size of the file and the
+** number of chunks written. The memory used by the writer is
+** one chunk, whatever the number of turns.
+**
+** Usage: trackingDriverBenchmark [-cells n] [-n n] [-turns n] [-file name]
+**
+**   -cells n  : number of cells (default: 100)
+**   -n n      : number of particles (default: 10)
+**   -turns n  : number of turns (default: 10000)
+**   -file s   : turn-by-turn file (default: trackingDriverBenchmark.tbt);
+**               it is removed at the end
+**
+*/
+
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+#include <cstring>
+#include <cstdio>
+#include <string>
+#include <sys/stat.h>
+
+#include <boost/date_time/posix_time/posix_time.hpp>
+
+#include <basic_toolkit/RandomStreams.h>
+#include <beamline/beamline.h>
+#include <beamline/Drift.h>
+#include <beamline/marker.h>
+#include <beamline/quadrupole.h>
+#include <beamline/sextupole.h>
+#include <beamline/Particle.h>
+#include <beamline/TBunch.h>
+#include <physics_toolkit/TrackingDriver.h>
+#include <physics_toolkit/TurnByTurnFile.h>
+
+using namespace std;
+
+namespace {
+
+bool isBPM( BmlnElmnt const& e )
+{
+  return 0 == strcmp( e.Name(), "BPM" );
+}
+
+double seconds( boost::posix_time::ptime const& start )
+{
+  return ( boost::posix_time::microsec_clock::universal_time() - start ).total_microseconds()*1.0e-6;
+}
+
+void fill( ParticleBunch& bunch, Proton const& pr, int n )
+{
+  RandomStreams const streams( 1234 );
+
+  for ( int j=0; j<n; ++j ) {
+    RandomStream rnd = streams.stream( j );
+    Proton p( pr );
+    p.x ( 1.0e-3*rnd.normal() );
+    p.y ( 1.0e-3*rnd.normal() );
+    bunch.append( p );
+  }
+}
+
+void report( char const* label, int n, int nturns, double t, std::string const& fname, int chunks )
+{
+  cout << setw(28) << label << setw(12) << t << setw(18) << setprecision(4) << n*double(nturns)/t;
+
+  struct stat st;
+  if ( !fname.empty() && 0 == stat( fname.c_str(), &st ) ) {
+    cout << setw(12) << st.st_size/( 1024.0*1024.0 ) << setw(10) << chunks;
+  }
+  cout << endl;
+}
+
+} // namespace
+
+int main( int argc, char** argv )
+{
+  int         ncells = 100;
+  int         n      = 10;
+  int         nturns = 10000;
+  std::string fname  = "trackingDriverBenchmark.tbt";
+
+  for ( int i=1; i<argc; ++i ) {
+    if      ( 0 == strcmp( argv[i], "-cells" ) && i+1 < argc ) { ncells = atoi( argv[++i] ); }
+    else if ( 0 == strcmp( argv[i], "-n"     ) && i+1 < argc ) { n      = atoi( argv[++i] ); }
+    else if ( 0 == strcmp( argv[i], "-turns" ) && i+1 < argc ) { nturns = atoi( argv[++i] ); }
+    else if ( 0 == strcmp( argv[i], "-file"  ) && i+1 < argc ) { fname  = argv[++i]; }
+  }
+
+  Proton pr( 100.0 );
+  double const brho = pr.refBrho();
+
+  Drift      O  ( "O",  1.5 );
+  quadrupole F  ( "F",  0.5,  0.12*brho );
+  quadrupole D  ( "D",  0.5, -0.12*brho );
+  sextupole  S  ( "S",  0.2,  2.0*brho );
+  marker     BPM( "BPM" );
+
+  beamline ring( "RING" );
+  for ( int i=0; i<ncells; ++i ) {
+    ring.append( F ); ring.append( O ); ring.append( BPM ); ring.append( S );
+    ring.append( O ); ring.append( D ); ring.append( O );
+  }
+  ring.setLineMode( beamline::ring );
+
+  TrackingDriver driver( ring );
+  driver.observe( &isBPM );
+
+  cout << n << " particles, " << nturns << " turns, " << driver.numObservationPoints() << " BPMs" << endl;
+  cout << endl;
+  cout << setw(28) << "" << setw(12) << "time [s]" << setw(18) << "particle-turns/s" << setw(12) << "file [MB]" << setw(10) << "chunks" << endl;
+
+  // ------------------------------
+  // tracking only
+  // ------------------------------
+
+  {
+    ParticleBunch bunch( pr );
+    fill( bunch, pr, n );
+
+    boost::posix_time::ptime const start = boost::posix_time::microsec_clock::universal_time();
+
+    for ( int turn=0; turn<nturns; ++turn ) { ring.propagate( bunch ); }
+
+    report( "tracking only", n, nturns, seconds( start ), "", 0 );
+  }
+
+  // ------------------------------
+  // tracking and recording
+  // ------------------------------
+
+  TurnByTurnFile::Precision const precisions[] = { TurnByTurnFile::double_precision, TurnByTurnFile::single_precision };
+  char const* const labels[] = { "recording, double", "recording, single" };
+
+  for ( int k=0; k<2; ++k ) {
+
+    ParticleBunch bunch( pr );
+    fill( bunch, pr, n );
+
+    boost::posix_time::ptime const start = boost::posix_time::microsec_clock::universal_time();
+
+    int tpc = 0;
+    {
+      TurnByTurnWriter out( fname, n, driver.names(), driver.azimuths(), precisions[k] );
+      driver.track( bunch, nturns, out );
+      tpc = out.turnsPerChunk();
+    }
+
+    report( labels[k], n, nturns, seconds( start ), fname, ( nturns + tpc - 1 )/tpc );
+  }
+
+  remove( fname.c_str() );
+
+  return 0;
+}
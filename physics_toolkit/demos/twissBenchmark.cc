@@ -0,0 +1,187 @@
+/*
+**
+** Benchmark program:
+**
+** Compares the time needed to obtain the periodic Courant-Snyder
+** and dispersion functions of a ring of FODO cells with bends
+**
+**   - by propagating JetParticles through every element
+**     (Optics::propagateCourantSnyder2D, Optics::propagateDispersion);
+**   - from the element matrices of a TransferMatrixCache, filled
+**     from scratch;
+**   - from the same cache, after a change of one quadrupole
+**     strength.
+**
+** Each method starts from the line and ends with the lattice
+** functions at every element, one-turn map included. Prints the
+** CPU time of each method and the largest relative difference
+** between the beta functions obtained with and without the cache.
+**
+** Usage: twissBenchmark [-cells n] [-repeat n]
+**
+**   -cells n  : number of cells; 10 elements per cell
+**               (default: 2000)
+**
+*/
+
+#include <iostream>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <ctime>
+
+#include <beamline/beamline.h>
+#include <beamline/Drift.h>
+#include <beamline/quadrupole.h>
+#include <beamline/sextupole.h>
+#include <beamline/sbend.h>
+#include <beamline/Particle.h>
+#include <beamline/JetParticle.h>
+#include <physics_toolkit/Optics.h>
+#include <physics_toolkit/LatticeFunctionTable.h>
+#include <physics_toolkit/TransferMatrixCache.h>
+
+#include <sqlite/connection.hpp>
+
+using namespace std;
+
+namespace {
+
+double const energy = 100.0;
+
+void twissWithJets( sqlite::connection& db, beamline const& ring, Particle const& p, LatticeFunctionTable& lft )
+{
+  JetParticle oneturn( p );
+  ring.propagate( oneturn );
+
+  CSLattFuncs lf = Optics::periodicCourantSnyder2D( db, oneturn );
+  Vector    eta0 = Optics::periodicDispersion( db, oneturn );
+
+  Optics::propagateCourantSnyder2D( lft, ring, JetParticle( p ), lf );
+  Optics::propagateDispersion     ( lft, ring, JetParticle( p ), eta0 );
+}
+
+void twissWithMatrices( sqlite::connection& db, beamline const& ring, Particle const& p, TransferMatrixCache& cache, LatticeFunctionTable& lft )
+{
+  cache.update( ring, p );
+
+  JetParticle oneturn = cache.oneTurnJetParticle();
+
+  CSLattFuncs lf = Optics::periodicCourantSnyder2D( db, oneturn );
+  Vector    eta0 = Optics::periodicDispersion( db, oneturn );
+
+  cache.propagateCourantSnyder2D( lft, lf );
+  cache.propagateDispersion     ( lft, eta0 );
+}
+
+double maxdiff( std::vector<double> const& a, std::vector<double> const& b )
+{
+  if ( a.size() != b.size() ) return 1.0e30;
+
+  double d = 0.0;
+  for ( unsigned int i=0; i<a.size(); ++i ) {
+    d = std::max( d, std::abs( a[i] - b[i] )/std::abs( b[i] ) );
+  }
+  return d;
+}
+
+} // namespace
+
+int main( int argc, char** argv )
+{
+  int ncells = 2000;
+  int repeat = 3;
+
+  for( int i = 1; i < argc; ++i ) {
+    if(      0 == strcmp( argv[i], "-cells"  ) && i+1 < argc ) { ncells = atoi( argv[++i] ); }
+    else if( 0 == strcmp( argv[i], "-repeat" ) && i+1 < argc ) { repeat = atoi( argv[++i] ); }
+    else {
+      cerr << "Usage: " << argv[0] << " [-cells n] [-repeat n]" << endl;
+      return 1;
+    }
+  }
+
+  createStandardEnvironments(1);
+
+  Proton pr( energy );
+  double const brho  = pr.refBrho();
+  double const angle = M_PI/ncells;
+
+  Drift      O ( "O",  1.5 );
+  quadrupole F ( "F",  0.5,  0.12*brho );
+  quadrupole D ( "D",  0.5, -0.12*brho );
+  sextupole  SF( "SF", 0.2,  0.4*brho );
+  sextupole  SD( "SD", 0.2, -0.6*brho );
+  sbend      B ( "B",  3.0, brho*angle/3.0, angle );
+
+  beamline ring( "RING" );
+  for ( int i=0; i<ncells; ++i ) {
+    ring.append( F ); ring.append( O ); ring.append( SF ); ring.append( B ); ring.append( O );
+    ring.append( D ); ring.append( O ); ring.append( SD ); ring.append( B ); ring.append( O );
+  }
+  ring.setLineMode( beamline::ring );
+  ring.registerReference( pr );
+
+  sqlite::connection db( ":memory:" );
+  Optics::initdb( db );
+
+  // ---------------------------------------
+  // Jet propagation
+  // ---------------------------------------
+
+  LatticeFunctionTable jets;
+
+  clock_t start = clock();
+  for ( int k=0; k<repeat; ++k ) { twissWithJets( db, ring, pr, jets ); }
+  double const t_jets = double( clock() - start )/CLOCKS_PER_SEC/repeat;
+
+  // ---------------------------------------
+  // element matrices, from scratch
+  // ---------------------------------------
+
+  LatticeFunctionTable matrices;
+
+  start = clock();
+  for ( int k=0; k<repeat; ++k ) {
+    TransferMatrixCache cache;
+    twissWithMatrices( db, ring, pr, cache, matrices );
+  }
+  double const t_cold = double( clock() - start )/CLOCKS_PER_SEC/repeat;
+
+  // ---------------------------------------
+  // element matrices, one quadrupole changed
+  // ---------------------------------------
+
+  TransferMatrixCache cache;
+  cache.update( ring, pr );
+
+  beamline::deep_iterator it = ring.deep_begin();
+  for ( int i=0; i<5*ncells; ++i ) { ++it; }
+
+  double const k1 = (*it)->Strength();
+
+  start = clock();
+  for ( int k=0; k<repeat; ++k ) {
+    (*it)->setStrength( k1*( 1.0 + ( (k%2) ? -1.0e-3 : 1.0e-3 ) ) );
+    twissWithMatrices( db, ring, pr, cache, matrices );
+  }
+  double const t_warm = double( clock() - start )/CLOCKS_PER_SEC/repeat;
+
+  (*it)->setStrength( k1 );
+
+  twissWithJets    ( db, ring, pr,        jets     );
+  twissWithMatrices( db, ring, pr, cache, matrices );
+
+  double const dbeta = std::max( maxdiff( Optics::beta_x( matrices ), Optics::beta_x( jets ) ),
+                                 maxdiff( Optics::beta_y( matrices ), Optics::beta_y( jets ) ) );
+
+  cout << "cells: " << ncells << "   elements: " << ring.countHowManyDeeply() << "   repeat: " << repeat << endl;
+  cout << "JetParticle propagation     : " << t_jets << " s" << endl;
+  cout << "TransferMatrixCache (cold)  : " << t_cold << " s" << endl;
+  cout << "TransferMatrixCache (1 quad): " << t_warm << " s" << endl;
+  cout << "speedup (cold)              : " << t_jets/t_cold << endl;
+  cout << "speedup (1 quad)            : " << t_jets/t_warm << endl;
+  cout << "max relative beta difference: " << dbeta << endl;
+
+  return 0;
+}
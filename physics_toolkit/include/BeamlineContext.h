@@ -58,6 +58,8 @@
 #include <beamline/JetParticle.h>
 #include <beamline/LatticeFunctions.h>
 #include <beamline/beamline.h>
+#include <physics_toolkit/LatticeFunctionTable.h>
+#include <physics_toolkit/TransferMatrixCache.h>
 
 #include <sqlite/connection.hpp>
 
@@ -182,6 +184,7 @@ class BeamlineContext: public beamline {
 
     bool              is_linac() const;
     bool    reference_orbit_ok() const; 
+    void          oneTurnMap();          // refjp_: the one-turn map, about the closed orbit
     bool         dispersion_ok() const;  
     bool   courant_snyder2d_ok() const;
     bool   courant_snyder4d_ok() const;
@@ -200,6 +203,10 @@ class BeamlineContext: public beamline {
 
     JetParticle           refjp_;  // reference jet particle (for a ring, 1-turn map;  for a line, identity map) 
 
+    Particle*             closedOrbit_;       // last closed orbit found, at the entrance of the ring; 0 if none
+    bool                  oneTurnMapOk_;      // refjp_ is the one-turn map for the current state of the elements
+    bool                  oneTurnMapLinear_;  // refjp_ is first order (computed from the cached element matrices)
+
     //   Used for computing equilibrium covariance  matrix.
     //   Default values: eps_1_ = 40, eps_2_ = 40.
     // Relation to <I> = <aa*>: 
@@ -224,6 +231,9 @@ class BeamlineContext: public beamline {
 
             std::string                          dbname_;
     mutable boost::shared_ptr<sqlite::connection>    db_;
+    mutable LatticeFunctionTable                     lattice_;   // flushed to db_ on demand, by dbname() and saveDatabase()
+            TransferMatrixCache                      matrices_;     // not reset by clear(); revalidated against the elements on use
+    mutable TransferMatrixCache                   offmomentum_;  // same, about the off-momentum closed orbit used by chromaticity()
 
     BeamlineContext( BeamlineContext const& );
 
@@ -0,0 +1,123 @@
+/*************************************************************************
+**************************************************************************
+**************************************************************************
+******
+******  PHYSICS TOOLKIT: Library of utilites and Sage classes
+******             which facilitate calculations with the
+******             BEAMLINE class library.
+******
+******  File:      ClosedOrbitScan.h
+******
+******  Copyright (c) Fermi Research Alliance LLC
+******                All Rights Reserved
+******
+******  Usage, modification, and redistribution are subject to terms
+******  of the License supplied with this software.
+******
+******  Software and documentation created under
+******  U.S. Department of Energy Contract No. DE-AC02-07CH11359.
+******  The U.S. Government retains a world-wide non-exclusive,
+******  royalty-free license to publish or reproduce documentation
+******  and software for U.S. Government purposes. This software
+******  is protected under the U.S. and Foreign Copyright Laws.
+******
+******  Revision History
+******
+******  Oct 2026
+******
+******  - Initial version.
+******
+**************************************************************************
+*************************************************************************/
+
+// ==============================================================================
+//
+// A ClosedOrbitScan finds the closed orbit and the one-turn map of a ring
+// for a list of momentum offsets (dp/p), optionally repeated for several
+// parameter sets (e.g. sextupole settings), with several threads.
+//
+// A task is one (parameter set, dp/p) pair; tasks are numbered set by set:
+//
+//   task = set*dpp.size() + i
+//
+// The tasks are handed out to a pool of worker threads. Each worker owns
+// a copy of the ring. For a scan with parameter sets, every task starts
+// from a fresh copy of the worker's ring, to which the setup function is
+// applied with the index of the set. The line given to the constructor is
+// never modified. The closed orbit is searched with Optics::closed_orbit;
+// the Jet arithmetic uses the per-thread scratch areas of the Jet
+// environment of the JetParticle given to the constructor, which run()
+// makes current for its duration.
+//
+// The results are appended to the keyed table CLOSED_ORBIT_SCAN of a
+// LatticeFunctionTable, one row per task, in task order:
+//
+//   set dpp converged x y cdt npx npy ndp nux nuy m00 m01 ... m55
+//
+// where (x ... ndp) is the closed orbit at the entrance of the ring,
+// (nux, nuy) are the fractional tunes and mij is the element (i,j) of the
+// one-turn matrix, in phase space index order. A task whose search fails
+// or does not close has converged = 0 and NaN results.
+//
+// ==============================================================================
+
+#ifndef CLOSEDORBITSCAN_H
+#define CLOSEDORBITSCAN_H
+
+#include <vector>
+#include <boost/function.hpp>
+#include <basic_toolkit/globaldefs.h>
+#include <beamline/BmlPtr.h>
+#include <beamline/JetParticle.h>
+
+class beamline;
+class LatticeFunctionTable;
+
+class DLLEXPORT ClosedOrbitScan {
+
+ public:
+
+  typedef boost::function<void( beamline&, int )>  Setup;   // applies parameter set k to a copy of the ring
+
+  ClosedOrbitScan( beamline const& ring, JetParticle const& jp );
+ ~ClosedOrbitScan();
+
+  void setNumberOfThreads( int n );         // 0 (default): one per hardware thread
+  int  numberOfThreads()  const;
+
+  // Each run() returns the number of tasks that did not converge.
+
+  int  run( LatticeFunctionTable& lft, std::vector<double> const& dpp );
+  int  run( LatticeFunctionTable& lft, std::vector<double> const& dpp, int nsets, Setup const& setup );
+
+  // Results of the last run()
+
+  int                 numTasks()               const { return results_.size(); }
+  bool                converged ( int task )   const;
+  JetParticle const&  oneTurnMap( int task )   const;    // on the closed orbit; the state is the one-turn map
+
+ private:
+
+  struct Result {
+    Result( JetParticle const& jp );
+
+    bool         converged;
+    JetParticle  oneturn;
+    double       nux;
+    double       nuy;
+  };
+
+  class Worker;
+
+  void solve( beamline const& ring, double dpp, Result& result ) const;
+
+  BmlPtr               ring_;
+  JetParticle          jp_;
+  int                  nthreads_;
+  std::vector<Result>  results_;
+
+  ClosedOrbitScan( ClosedOrbitScan const& );
+  ClosedOrbitScan& operator=( ClosedOrbitScan const& );
+};
+
+#endif // CLOSEDORBITSCAN_H
@@ -0,0 +1,151 @@
+/*************************************************************************
+**************************************************************************
+**************************************************************************
+******
+******  PHYSICS TOOLKIT: Library of utilites and Sage classes
+******             which facilitate calculations with the
+******             BEAMLINE class library.
+******
+******  File:      DynamicAperture.h
+******
+******  Copyright (c) Fermi Research Alliance LLC
+******                All Rights Reserved
+******
+******  Usage, modification, and redistribution are subject to terms
+******  of the License supplied with this software.
+******
+******  Software and documentation created under
+******  U.S. Department of Energy Contract No. DE-AC02-07CH11359.
+******  The U.S. Government retains a world-wide non-exclusive,
+******  royalty-free license to publish or reproduce documentation
+******  and software for U.S. Government purposes. This software
+******  is protected under the U.S. and Foreign Copyright Laws.
+******
+******  Revision History
+******
+******  Oct 2026
+******
+******  - Initial version.
+******
+**************************************************************************
+*************************************************************************/
+
+// ==============================================================================
+//
+// A DynamicAperture tracks a grid of initial conditions around a ring for a
+// number of turns and records how many turns each of them survives.
+//
+// An initial condition is the state of the particle given to the constructor
+// (e.g. on the closed orbit, with a momentum offset), displaced by (x, y).
+// Two grids are available:
+//
+//   polar()      amplitudes r_k = amax*(k+1)/namplitudes, k = 0 ... namplitudes-1,
+//                on rays at the angles a_j = (pi/2)*(j+1)/(nangles+1),
+//                j = 0 ... nangles-1:  x = r cos(a), y = r sin(a);
+//   cartesian()  nx x ny points evenly spaced in [xmin, xmax] x [ymin, ymax].
+//
+// The initial conditions are tracked in batches (BunchArrays), element by
+// element, through copies of the ring. The batches are handed out to
+// workers run by WorkerPool::instance(), each with its own copy. Losses are flagged by the
+// apertures of the elements (BmlnElmnt::setAperture); a particle whose
+// transverse coordinates are not finite or exceed the escape amplitude is
+// lost as well, so that rings without apertures can be scanned. Lost
+// particles are removed from their batch at the end of each turn, and a
+// batch stops as soon as it is empty.
+//
+// Refinement (polar grid only): with setRefinement( m ), m > 1, each ray is
+// first tracked at every m-th amplitude (and at the largest one). Only the
+// amplitudes between the last surviving point below the first loss and that
+// loss are then tracked. The other points are not tracked: those below the
+// first loss survive, those above take the result of the nearest tracked
+// point below them on the same ray. This assumes that the stable region of
+// a ray is an interval: islands of stability beyond the first loss are only
+// found if they contain a coarse point.
+//
+// Each scan replaces the keyed table DYNAMIC_APERTURE of a
+// LatticeFunctionTable, one row per grid point:
+//
+//   x y amplitude angle turns tracked
+//
+// where turns is the number of complete turns survived (nturns for a point
+// that is never lost) and tracked is 0 for a point inferred by refinement.
+// polar() also replaces the table DYNAMIC_APERTURE_BOUNDARY, one row per
+// ray:
+//
+//   angle amplitude
+//
+// where amplitude is the largest amplitude of the ray up to which all the
+// points survive (0 if the first one is lost).
+//
+// ==============================================================================
+
+#ifndef DYNAMICAPERTURE_H
+#define DYNAMICAPERTURE_H
+
+#include <vector>
+#include <basic_toolkit/globaldefs.h>
+#include <beamline/BmlPtr.h>
+#include <beamline/ParticleFwd.h>
+
+class beamline;
+class LatticeFunctionTable;
+
+class DLLEXPORT DynamicAperture {
+
+ public:
+
+  DynamicAperture( beamline const& ring, Particle const& particle );
+ ~DynamicAperture();
+
+  void    setNumberOfThreads( int n );        // 0 (default): one per hardware thread
+  int     numberOfThreads()   const;
+
+  void    setBatchSize( int n );              // initial conditions per batch (default: 64)
+  int     batchSize()         const { return batchSize_; }
+
+  void    setEscapeAmplitude( double a );     // [m] (default: 1.0)
+  double  escapeAmplitude()   const { return escape_; }
+
+  void    setRefinement( int m );             // 1 (default): every point is tracked
+  int     refinement()        const { return refinement_; }
+
+  // Each scan returns the number of initial conditions actually tracked.
+
+  int     polar    ( LatticeFunctionTable& lft, int nturns, double amax, int namplitudes, int nangles );
+  int     cartesian( LatticeFunctionTable& lft, int nturns, double xmin, double xmax, int nx,
+                                                            double ymin, double ymax, int ny );
+
+  // Results of the last scan, in table order
+
+  int     numPoints()                const { return points_.size(); }
+  int     survivalTurns( int point ) const;
+
+ private:
+
+  struct Point {
+    Point( double x, double y );
+
+    double x;
+    double y;
+    int    turns;
+    bool   tracked;
+  };
+
+  class Worker;
+
+  int   track( std::vector<int> const& ids, int nturns );   // tracks points_[ids]; returns ids.size()
+  void  write( LatticeFunctionTable& lft ) const;
+
+  BmlPtr               ring_;
+  Particle*            particle_;
+  int                  nthreads_;
+  int                  batchSize_;
+  double               escape_;
+  int                  refinement_;
+  std::vector<Point>   points_;
+
+  DynamicAperture( DynamicAperture const& );
+  DynamicAperture& operator=( DynamicAperture const& );
+};
+
+#endif // DYNAMICAPERTURE_H
@@ -0,0 +1,154 @@
+/*************************************************************************
+**************************************************************************
+**************************************************************************
+******
+******  PHYSICS TOOLKIT: Library of utilites and Sage classes
+******             which facilitate calculations with the
+******             BEAMLINE class library.
+******
+******  File:      LatticeFunctionTable.h
+******
+******  Copyright (c) Fermi Research Alliance LLC
+******                All Rights Reserved
+******
+******  Usage, modification, and redistribution are subject to terms
+******  of the License supplied with this software.
+******
+******  Software and documentation created under
+******  U.S. Department of Energy Contract No. DE-AC02-07CH11359.
+******  The U.S. Government retains a world-wide non-exclusive,
+******  royalty-free license to publish or reproduce documentation
+******  and software for U.S. Government purposes. This software
+******  is protected under the U.S. and Foreign Copyright Laws.
+******
+******  Revision History
+******
+******  Oct 2026
+******
+******  - Initial version.
+******
+**************************************************************************
+*************************************************************************/
+
+// ==============================================================================
+//
+// A LatticeFunctionTable is an in-memory, column oriented store for the
+// per-element results computed by the Optics functions (reference orbit,
+// dispersion, Courant-Snyder functions, eigenvectors ...).
+//
+// It holds a set of named tables laid out like the tables of the Optics
+// database: each column is a contiguous std::vector, so that a lattice
+// function can be handed out by reference, without any query or copy.
+// Tables declared as keyed have an implicit "iseq INTEGER PRIMARY KEY"
+// column equal to the row index.
+//
+// Rows are appended field by field, in column order:
+//
+//   table << iseq << betax << alphax ...
+//
+// much like the arguments bound to a sqlite::command.
+//
+// Writing to the database is optional. flush() writes every table that was
+// (re)defined or modified since the previous flush in one transaction per
+// table, replacing the database table of the same name.
+//
+// ==============================================================================
+
+#ifndef LATTICEFUNCTIONTABLE_H
+#define LATTICEFUNCTIONTABLE_H
+
+#include <map>
+#include <string>
+#include <vector>
+#include <boost/cstdint.hpp>
+#include <basic_toolkit/globaldefs.h>
+
+namespace sqlite { class connection; }
+
+class DLLEXPORT LatticeFunctionTable {
+
+ public:
+
+  class Table {
+
+   public:
+
+    enum column_type { real, integer, text };
+
+    //  columns is a whitespace separated list of column names, each one
+    //  optionally followed by its type: "name:TEXT object:INTEGER length".
+    //  The default type is REAL.
+
+    Table( std::string const& name, std::string const& columns, bool keyed );
+
+    std::string const&  name()                          const { return name_;            }
+    bool                keyed()                         const { return keyed_;           }
+    int                 numColumns()                    const { return columns_.size();  }
+    int                 numRows()                       const { return nrows_;           }
+    bool                empty()                         const { return nrows_ == 0;      }
+
+    std::string const&  columnName( int j )             const;
+    column_type         columnType( int j )             const;
+    int                 columnIndex( std::string const& colname ) const;  // -1 if absent
+
+    std::vector<double>         const&  column       ( std::string const& colname ) const;
+    std::vector<boost::int64_t> const&  integerColumn( std::string const& colname ) const;
+    std::vector<std::string>    const&  textColumn   ( std::string const& colname ) const;
+
+    std::vector<double> const&  column( int j ) const;
+
+    Table& operator<<( double               value );
+    Table& operator<<( int                  value );
+    Table& operator<<( boost::int64_t       value );
+    Table& operator<<( std::string const&   value );
+
+    void reserve( int nrows );
+    void clear();
+
+   private:
+
+    friend class LatticeFunctionTable;
+
+    struct Column {
+      std::string                  name;
+      column_type                  type;
+      std::vector<double>          reals;
+      std::vector<boost::int64_t>  integers;
+      std::vector<std::string>     texts;
+    };
+
+    Column&       next( column_type type );
+    Column const& find( std::string const& colname, column_type type ) const;
+
+    std::string          name_;
+    bool                 keyed_;
+    std::vector<Column>  columns_;
+    int                  nrows_;
+    int                  field_;   // column to be filled next
+    bool                 dirty_;   // modified since the last flush
+  };
+
+  Table&       define( std::string const& name, std::string const& columns, bool keyed = true );
+
+  bool         has( std::string const& name )  const;
+  bool         ok ( std::string const& name )  const;  // exists and is not empty
+
+  Table&       operator[]( std::string const& name );
+  Table const& operator[]( std::string const& name ) const;
+
+  std::vector<double> const& column( std::string const& name, std::string const& colname ) const;
+
+  void         remove( std::string const& name );
+  void         clear();
+
+  void         flush( sqlite::connection& db );                              // modified tables only
+  void         flush( sqlite::connection& db, std::string const& name );
+
+ private:
+
+  void         write( sqlite::connection& db, Table& table ) const;
+
+  std::map<std::string, Table>  tables_;
+};
+
+#endif // LATTICEFUNCTIONTABLE_H
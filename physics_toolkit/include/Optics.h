@@ -43,6 +43,8 @@
 class JetParticle;
 class Particle;
 class beamline;
+class LatticeFunctionTable;
+class TransferMatrixCache;
 
 namespace sqlite { class connection; }
 
@@ -51,8 +53,15 @@ namespace Optics {
   void initdb( sqlite::connection& db );
 
   Vector tunes( sqlite::connection& db, JetParticle const& oneturnjp);
+  Vector tunes(                         JetParticle const& oneturnjp);   // does not update the database
 
   JetParticle           find_closed_orbit( sqlite::connection& db, beamline const& bml, JetParticle const& jp );
+
+  // The closed orbit search of find_closed_orbit alone: the Jet environment of jp must be the
+  // current one, and the closed orbit is not registered with bml. Distinct lines may be
+  // searched concurrently.
+
+  JetParticle                closed_orbit(                         beamline const& bml, JetParticle const& jp );
   void                              orbit( sqlite::connection& db, beamline const& bml, JetParticle const& jp );
 
   CSLattFuncs     periodicCourantSnyder2D( sqlite::connection& db,                      JetParticle const& jp );
@@ -74,6 +83,28 @@ namespace Optics {
   MatrixC            periodicEigenVectors( sqlite::connection& db,                      JetParticle const& oneturnjp );
   void              propagateEigenVectors( sqlite::connection& db, beamline const& bml, JetParticle const& jp, MatrixC const& ev0, Vector const& eta0 );
 
+  //----------------------------------------------------------------------------------------------
+  // The versions below store their results in a LatticeFunctionTable instead of the database.
+  // The tables and columns have the same names as in the database; the database versions above
+  // compute into a LatticeFunctionTable and flush it.
+  //----------------------------------------------------------------------------------------------
+
+  void                              orbit( LatticeFunctionTable& lft, beamline const& bml, JetParticle const& jp );
+  int            propagateCourantSnyder2D( LatticeFunctionTable& lft, beamline const& bml, JetParticle const& jp, CSLattFuncs const& initial );
+  int            propagateCourantSnyder4D( LatticeFunctionTable& lft, beamline const& bml, JetParticle const& jp, CSLattFuncs4D const& initial );
+  int                 propagateDispersion( LatticeFunctionTable& lft, beamline const& bml, JetParticle const& jp, Vector const& eta0, bool dppconstant = true );
+  void              propagateEigenVectors( LatticeFunctionTable& lft, beamline const& bml, JetParticle const& jp, MatrixC const& ev0, Vector const& eta0 );
+
+  //----------------------------------------------------------------------------------------------
+  // The versions below use the element matrices held by a TransferMatrixCache instead of
+  // propagating a JetParticle through the line. matrices must be up to date with the line for
+  // the reference particle of jp; offmomentum is brought up to date for the off-momentum orbit.
+  //----------------------------------------------------------------------------------------------
+
+  int            propagateCourantSnyder4D( LatticeFunctionTable& lft, TransferMatrixCache const& matrices, JetParticle const& jp, CSLattFuncs4D const& initial );
+
+  Vector                     chromaticity( sqlite::connection& db, TransferMatrixCache& offmomentum, beamline const& bml, JetParticle const& jp, Vector const& eta );
+
 
   std::vector<double>      lattice_function(std::string const& dbname, std::string const& colname);
   std::vector<double>            arclength( std::string const& dbname );
@@ -97,6 +128,27 @@ namespace Optics {
   std::vector<double>               etap_x( std::string const& dbname );
   std::vector<double>               etap_y( std::string const& dbname );
 
+  std::vector<double> const&      arclength( LatticeFunctionTable const& lft );
+  std::vector<double> const&          gamma( LatticeFunctionTable const& lft );
+  std::vector<double> const&         beta_x( LatticeFunctionTable const& lft );
+  std::vector<double> const&         beta_y( LatticeFunctionTable const& lft );
+  std::vector<double> const&        alpha_x( LatticeFunctionTable const& lft );
+  std::vector<double> const&        alpha_y( LatticeFunctionTable const& lft );
+  std::vector<double> const&          psi_x( LatticeFunctionTable const& lft );
+  std::vector<double> const&          psi_y( LatticeFunctionTable const& lft );
+  std::vector<double> const&        beta_1x( LatticeFunctionTable const& lft );
+  std::vector<double> const&        beta_1y( LatticeFunctionTable const& lft );
+  std::vector<double> const&       alpha_1x( LatticeFunctionTable const& lft );
+  std::vector<double> const&       alpha_1y( LatticeFunctionTable const& lft );
+  std::vector<double> const&        beta_2x( LatticeFunctionTable const& lft );
+  std::vector<double> const&        beta_2y( LatticeFunctionTable const& lft );
+  std::vector<double> const&       alpha_2x( LatticeFunctionTable const& lft );
+  std::vector<double> const&       alpha_2y( LatticeFunctionTable const& lft );
+  std::vector<double> const&          eta_x( LatticeFunctionTable const& lft );
+  std::vector<double> const&          eta_y( LatticeFunctionTable const& lft );
+  std::vector<double> const&         etap_x( LatticeFunctionTable const& lft );
+  std::vector<double> const&         etap_y( LatticeFunctionTable const& lft );
+
 
   Vector                     chromaticity( sqlite::connection& db, beamline const& bml, JetParticle const& jp, Vector const& eta );
 
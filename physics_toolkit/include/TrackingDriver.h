@@ -0,0 +1,118 @@
+/*************************************************************************
+**************************************************************************
+**************************************************************************
+******
+******  PHYSICS TOOLKIT: Library of utilites and Sage classes
+******             which facilitate calculations with the
+******             BEAMLINE class library.
+******
+******  File:      TrackingDriver.h
+******
+******  Copyright (c) Fermi Research Alliance LLC
+******                All Rights Reserved
+******
+******  Usage, modification, and redistribution are subject to terms
+******  of the License supplied with this software.
+******
+******  Software and documentation created under
+******  U.S. Department of Energy Contract No. DE-AC02-07CH11359.
+******  The U.S. Government retains a world-wide non-exclusive,
+******  royalty-free license to publish or reproduce documentation
+******  and software for U.S. Government purposes. This software
+******  is protected under the U.S. and Foreign Copyright Laws.
+******
+******  Revision History
+******
+******  Oct 2026
+******
+******  - Initial version.
+******
+**************************************************************************
+*************************************************************************/
+
+// ==============================================================================
+//
+// A TrackingDriver tracks a particle or a bunch around a ring for a number
+// of turns and records the phase space coordinates at a set of observation
+// points into a TurnByTurnWriter.
+//
+// The driver owns a flattened copy of the ring; the line given to the
+// constructor is not modified. The observation points are the elements of
+// the flattened ring selected by observe(), in the order of the ring; the
+// coordinates are recorded at the exit of each of them. The copy is cut
+// into segments ending at the observation points, each of which is tracked
+// with beamline::propagate, so that bunches are tracked with the number of
+// threads set by beamline::setNumberOfThreads.
+//
+// track() may be called several times with the same writer: the turns are
+// appended. The number of particles of the bunch must stay equal to the one
+// of the writer; lost particles are recorded as NaN.
+//
+// Example:
+//
+//   bool isBPM( BmlnElmnt const& e ) { return 0 == strncmp( e.Name(), "BPM", 3 ); }
+//
+//   TrackingDriver driver( ring );
+//   driver.observe( &isBPM );
+//
+//   TurnByTurnWriter out( "run.tbt", bunch.size(), driver.names(), driver.azimuths() );
+//   driver.track( bunch, 1000000, out );
+//
+// ==============================================================================
+
+#ifndef TRACKINGDRIVER_H
+#define TRACKINGDRIVER_H
+
+#include <string>
+#include <vector>
+#include <boost/function.hpp>
+#include <basic_toolkit/globaldefs.h>
+#include <beamline/BmlPtr.h>
+#include <beamline/ElmPtr.h>
+#include <beamline/ParticleFwd.h>
+#include <beamline/ParticleBunchFwd.h>
+
+class BmlnElmnt;
+class BunchArrays;
+class TurnByTurnWriter;
+
+class DLLEXPORT TrackingDriver {
+
+ public:
+
+  typedef boost::function<bool( BmlnElmnt const& )>  Criterion;
+
+  explicit TrackingDriver( beamline const& ring );
+ ~TrackingDriver();
+
+  int  observe( Criterion const& criterion );      // adds the elements that satisfy criterion; returns their number
+  void clearObservationPoints();
+
+  int                              numObservationPoints() const { return names_.size(); }
+  std::vector<std::string> const&  names()                const { return names_;    }
+  std::vector<double>      const&  azimuths()             const { return azimuths_; }   // [m], at the exit
+
+  // Each track() returns the number of turns recorded so far by out.
+
+  int  track( Particle&      p, int nturns, TurnByTurnWriter& out ) const;
+  int  track( ParticleBunch& b, int nturns, TurnByTurnWriter& out ) const;
+  int  track( BunchArrays&   b, int nturns, TurnByTurnWriter& out ) const;
+
+ private:
+
+  template <typename particle_t>
+  int  trackTurns( particle_t& p, int nturns, TurnByTurnWriter& out ) const;
+
+  void segment();                                  // cuts the ring at the observation points
+
+  std::vector<ElmPtr>        elements_;            // the flattened ring
+  std::vector<bool>          observed_;
+  std::vector<BmlPtr>        segments_;            // segment k ends at observation point k; the last one ends the ring
+  std::vector<std::string>   names_;
+  std::vector<double>        azimuths_;
+
+  TrackingDriver( TrackingDriver const& );
+  TrackingDriver& operator=( TrackingDriver const& );
+};
+
+#endif // TRACKINGDRIVER_H
@@ -0,0 +1,148 @@
+/*************************************************************************
+**************************************************************************
+**************************************************************************
+******
+******  PHYSICS TOOLKIT: Library of utilites and Sage classes
+******             which facilitate calculations with the
+******             BEAMLINE class library.
+******
+******  File:      TransferMatrixCache.h
+******
+******  Copyright (c) Fermi Research Alliance LLC
+******                All Rights Reserved
+******
+******  Usage, modification, and redistribution are subject to terms
+******  of the License supplied with this software.
+******
+******  Software and documentation created under
+******  U.S. Department of Energy Contract No. DE-AC02-07CH11359.
+******  The U.S. Government retains a world-wide non-exclusive,
+******  royalty-free license to publish or reproduce documentation
+******  and software for U.S. Government purposes. This software
+******  is protected under the U.S. and Foreign Copyright Laws.
+******
+******  Revision History
+******
+******  Oct 2026
+******
+******  - Initial version.
+******
+**************************************************************************
+*************************************************************************/
+
+// ==============================================================================
+//
+// A TransferMatrixCache holds the linear (6x6) transfer matrix of every
+// element of a beamline, computed about the reference orbit, together with
+// the products of these matrices.
+//
+// Each matrix is keyed on the serial number of its element (BmlnElmnt::serial(),
+// never reused, unlike an address) and on the element modification count
+// (BmlnElmnt::modificationCount()). update() compares the
+// keys with the current state of the line and recomputes only
+//
+//  - the matrices of the elements that were replaced or modified, and of the
+//    downstream elements whose entrance orbit moved as a result;
+//  - the products that involve a recomputed matrix.
+//
+// Products over segments of the line are kept in a balanced binary tree,
+// so that the one-turn matrix is brought up to date in O(log N) products
+// per modified element. The cumulative matrices (from the entrance of the
+// line to the exit of element i) are extended on demand, starting from the
+// first modified element.
+//
+// The lattice functions computed from the cached matrices are written into
+// a LatticeFunctionTable, with the same tables and columns as the Optics
+// functions (COURANT_SNYDER, DISPERSION, EIGENVECTORS), without any Jet
+// propagation. The Optics overloads that take a TransferMatrixCache
+// (propagateCourantSnyder4D, chromaticity) are built on these.
+//
+// ==============================================================================
+
+#ifndef TRANSFERMATRIXCACHE_H
+#define TRANSFERMATRIXCACHE_H
+
+#include <vector>
+#include <basic_toolkit/globaldefs.h>
+#include <basic_toolkit/Matrix.h>
+#include <basic_toolkit/VectorD.h>
+#include <mxyzptlk/Jet__environment.h>
+#include <beamline/Particle.h>
+#include <beamline/LatticeFunctions.h>
+
+class beamline;
+class BmlnElmnt;
+class JetParticle;
+class LatticeFunctionTable;
+
+class DLLEXPORT TransferMatrixCache {
+
+ public:
+
+  TransferMatrixCache();
+ ~TransferMatrixCache();
+
+  // Brings the cache up to date with bml, for a reference particle entering the
+  // line with the state of p. Returns the number of element matrices recomputed.
+
+  int  update( beamline const& bml, Particle const& p );
+
+  void clear();
+
+  int  size()          const { return elements_.size(); }
+  bool empty()         const { return elements_.empty(); }
+
+  int  firstChanged()  const { return first_;       }   // first element recomputed by the last update(); size() if none
+  int  numRecomputed() const { return recomputed_;  }   // number of element matrices recomputed by the last update()
+
+  MatrixD  const& matrix    ( int i ) const;            // element i, about the reference orbit
+  MatrixD  const& cumulative( int i ) const;            // entrance of the line to the exit of element i
+  MatrixD  const& oneTurn()           const;            // entrance to exit of the line
+
+  Particle const& particle  ( int i ) const;            // reference particle at the exit of element i
+
+  // A first order JetParticle on the reference orbit at the exit of the line,
+  // whose state has the one-turn matrix as its jacobian. It can be handed to
+  // the Optics periodic*() functions.
+
+  JetParticle     oneTurnJetParticle() const;
+
+  // Lattice functions propagated from the entrance of the line. Same tables,
+  // columns and conventions as Optics::propagateCourantSnyder2D,
+  // Optics::propagateDispersion and Optics::propagateEigenVectors.
+
+  int  propagateCourantSnyder2D( LatticeFunctionTable& lft, CSLattFuncs const& initial )                    const;
+  int  propagateDispersion     ( LatticeFunctionTable& lft, Vector const& eta0, bool dppconstant = true )   const;
+  void propagateEigenVectors   ( LatticeFunctionTable& lft, MatrixC const& EV0, Vector const& eta0 )        const;
+
+ private:
+
+  struct Element {
+    Element( BmlnElmnt const* e, Particle const& p );
+
+    BmlnElmnt const*  elm;        // valid only while the key is current
+    unsigned long     serial;
+    unsigned long     modcount;
+    MatrixD           matrix;
+    Particle          exit;       // reference particle at the exit of the element
+  };
+
+  void   compute( Element& element, Particle const& entry ) const;
+  void   rebuildTree();
+  void   updateTree( int i );
+
+  std::vector<Element>          elements_;
+  std::vector<MatrixD>          tree_;         // segment products; leaves at [leaves_, leaves_+size())
+  int                           leaves_;
+  mutable std::vector<MatrixD>  cumulative_;
+  mutable int                   nvalid_;       // number of valid cumulative matrices
+  Particle*                     entry_;        // reference particle at the entrance of the line
+  int                           first_;
+  int                           recomputed_;
+  EnvPtr<double>                env_;          // first order, 6D
+
+  TransferMatrixCache( TransferMatrixCache const& );
+  TransferMatrixCache& operator=( TransferMatrixCache const& );
+};
+
+#endif // TRANSFERMATRIXCACHE_H
@@ -0,0 +1,195 @@
+/*************************************************************************
+**************************************************************************
+**************************************************************************
+******
+******  PHYSICS TOOLKIT: Library of utilites and Sage classes
+******             which facilitate calculations with the
+******             BEAMLINE class library.
+******
+******  File:      TurnByTurnFile.h
+******
+******  Copyright (c) Fermi Research Alliance LLC
+******                All Rights Reserved
+******
+******  Usage, modification, and redistribution are subject to terms
+******  of the License supplied with this software.
+******
+******  Software and documentation created under
+******  U.S. Department of Energy Contract No. DE-AC02-07CH11359.
+******  The U.S. Government retains a world-wide non-exclusive,
+******  royalty-free license to publish or reproduce documentation
+******  and software for U.S. Government purposes. This software
+******  is protected under the U.S. and Foreign Copyright Laws.
+******
+******  Revision History
+******
+******  Oct 2026
+******
+******  - Initial version.
+******
+**************************************************************************
+*************************************************************************/
+
+// ==============================================================================
+//
+// Turn-by-turn recording of the phase space coordinates of a fixed set of
+// particles at a fixed set of observation points (e.g. BPMs), in a binary
+// file that is written append-only and read through a memory map.
+//
+// File layout (native byte order; every section starts on an 8 byte
+// boundary):
+//
+//   header      magic "CHEFTBT", format version, byte order mark, number
+//               of particles, of observation points and of turns per
+//               chunk, value size (4 or 8 bytes), number of turns written.
+//   points      for each observation point: its azimuth [m] (double), the
+//               length of its name (uint32) and the name, padded.
+//   chunks      chunk k holds turns [ k*T, (k+1)*T ), T = turns per chunk.
+//               All chunks have the same size, so that chunk k starts at
+//               a fixed offset. Within a chunk the values are ordered as
+//
+//                 [point][particle][coordinate][turn]
+//
+//               i.e. the T values of one coordinate of one particle at one
+//               point are contiguous. Coordinates are in phase space index
+//               order (x, y, cdt, npx, npy, ndp).
+//
+// The writer fills one chunk in memory and appends it to the file when it
+// is full. The number of turns in the header is updated after each chunk
+// has been written, so that the file can be read while it is being written;
+// unused turns of the last chunk are NaN. The coordinates of a lost
+// particle are recorded as NaN.
+//
+// The size of a chunk is (points x particles x 6 x T x value size) bytes.
+// By default T is chosen to keep it near 8 MB: memory use does not grow
+// with the number of turns.
+//
+// ==============================================================================
+
+#ifndef TURNBYTURNFILE_H
+#define TURNBYTURNFILE_H
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <boost/cstdint.hpp>
+#include <basic_toolkit/globaldefs.h>
+#include <beamline/ParticleFwd.h>
+#include <beamline/ParticleBunchFwd.h>
+
+class BunchArrays;
+
+class DLLEXPORT TurnByTurnFile {
+
+ public:
+
+  enum Precision { single_precision = 4, double_precision = 8 };   // value size [ bytes ]
+
+  static boost::uint32_t const format_version;
+  static int             const ncoords = 6;
+
+  int                 numParticles()           const { return nparticles_;    }
+  int                 numObservationPoints()   const { return npoints_;       }
+  int                 turnsPerChunk()          const { return turnsPerChunk_; }
+  Precision           precision()              const { return Precision( valueSize_ ); }
+
+  std::string const&  name   ( int point )     const;
+  double              azimuth( int point )     const;
+  int                 index  ( std::string const& name ) const;    // -1 if there is no such point
+
+ protected:
+
+  struct Header;
+
+  TurnByTurnFile();
+
+  static std::size_t padded( std::size_t n ) { return ( n + 7 ) & ~std::size_t(7); }
+
+  int                       nparticles_;
+  int                       npoints_;
+  int                       turnsPerChunk_;
+  int                       valueSize_;
+  std::vector<std::string>  names_;
+  std::vector<double>       azimuths_;
+};
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+class DLLEXPORT TurnByTurnWriter : public TurnByTurnFile {
+
+ public:
+
+  // turnsPerChunk = 0: chosen from the chunk size
+
+  TurnByTurnWriter( std::string const& filename, int nparticles,
+                    std::vector<std::string> const& names, std::vector<double> const& azimuths,
+                    Precision precision = double_precision, int turnsPerChunk = 0 );
+ ~TurnByTurnWriter();                  // calls close()
+
+  // The coordinates of all the points are recorded for a turn, then
+  // endTurn() is called. A point that is not recorded is NaN.
+
+  void record( int point, Particle      const& p );   // one particle only
+  void record( int point, ParticleBunch const& b );
+  void record( int point, BunchArrays   const& b );
+
+  void endTurn();
+
+  void close();                        // writes the last chunk; further records are errors
+
+  int  numTurns() const { return nturns_ + turn_; }   // recorded, written or not
+
+ private:
+
+  void check( int point, int nparticles ) const;
+  void flush();                        // appends the current chunk
+
+  std::string            filename_;
+  int                    fd_;
+  std::size_t            dataOffset_;
+  std::size_t            chunkValues_;
+  int                    nturns_;        // turns written to the file
+  int                    turn_;          // turn within the current chunk
+  std::vector<double>    chunk_;
+  std::vector<float>     single_;        // conversion buffer, single precision only
+
+  TurnByTurnWriter( TurnByTurnWriter const& );
+  TurnByTurnWriter& operator=( TurnByTurnWriter const& );
+};
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+class DLLEXPORT TurnByTurnReader : public TurnByTurnFile {
+
+ public:
+
+  explicit TurnByTurnReader( std::string const& filename );   // maps the turns written so far
+ ~TurnByTurnReader();
+
+  int     numTurns() const { return nturns_; }
+
+  double  value ( int turn, int point, int particle, int coord ) const;
+
+  // n values of one coordinate, from turn first on; returns the number copied
+
+  int     series( int point, int particle, int coord, int first, int n, double* out ) const;
+
+ private:
+
+  void check( int point, int particle, int coord ) const;
+
+  void const*   chunk( int k ) const;
+
+  void*         map_;
+  std::size_t   size_;
+  std::size_t   dataOffset_;
+  std::size_t   chunkBytes_;
+  int           nturns_;
+
+  TurnByTurnReader( TurnByTurnReader const& );
+  TurnByTurnReader& operator=( TurnByTurnReader const& );
+};
+
+#endif // TURNBYTURNFILE_H
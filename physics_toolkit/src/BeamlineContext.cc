@@ -94,6 +94,27 @@ static double const small_x_err   = 1.0e-9;
 static double const small_y_err   = 1.0e-9;
 static double const small_npx_err = 1.0e-9;
 static double const small_npy_err = 1.0e-9;
+static double const small_cdt_err = 1.0e-9;
+
+namespace {
+
+//------------------------------------------------------------------------------
+// true if a particle entering the ring with the state of entry leaves it 
+// with the state of exit, i.e. entry is (still) on the closed orbit, with 
+// the reference times registered for it.
+//------------------------------------------------------------------------------
+
+bool closes( Particle const& entry, Particle const& exit )
+{
+  return (    ( std::abs( entry.x()   - exit.x()   ) < small_x_err   )
+           && ( std::abs( entry.y()   - exit.y()   ) < small_y_err   )
+           && ( std::abs( entry.npx() - exit.npx() ) < small_npx_err )
+           && ( std::abs( entry.npy() - exit.npy() ) < small_npy_err )
+           && ( std::abs( entry.cdt() - exit.cdt() ) < small_cdt_err )
+           && ( entry.ndp() == exit.ndp() ) );
+}
+
+} // anonymous namespace
 
 //||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
 //||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
@@ -102,8 +123,12 @@ BeamlineContext::BeamlineContext( Particle const& p, beamline const& bml )
 :   beamline(*bml.clone()), particle_(0) ,particleBunchPtr_(0) , 
     initialCSLattFuncs_() , 
     eps1_(40.0), eps2_(40.0), refjp_(p),
+    closedOrbit_(0), oneTurnMapOk_(false), oneTurnMapLinear_(false),
     dbname_(),
-    db_()
+    db_(),
+    lattice_(),
+    matrices_(),
+    offmomentum_()
 {
 
    particle_         = p.clone();
@@ -184,8 +209,12 @@ BeamlineContext::BeamlineContext( BeamlineContext const& o)
     eps1_(o.eps1_), 
     eps2_(o.eps2_), 
     refjp_( o.refjp_ ),
+    closedOrbit_(0), oneTurnMapOk_(false), oneTurnMapLinear_(false),
     dbname_ (),
-    db_()
+    db_(),
+    lattice_(),
+    matrices_(),
+    offmomentum_()
 {
    //-------------------------------------------------------------------
    // create and initialize the database
@@ -220,6 +249,7 @@ BeamlineContext* BeamlineContext::clone() const
 
 BeamlineContext::~BeamlineContext()
 {
+ delete closedOrbit_;
 
  boost::filesystem::path dbpathname(dbname_ ); 
  //boost::filesystem::remove( dbpathname );
@@ -231,6 +261,8 @@ BeamlineContext::~BeamlineContext()
 
 void BeamlineContext::saveDatabase( std::string const& dbname) const
 {
+  lattice_.flush( *db_ );
+
   std::string sql("BEGIN IMMEDIATE TRANSACTION");
   sqlite::execute(*db_, sql, true );
 
@@ -252,6 +284,7 @@ void BeamlineContext::saveDatabase( std::string const& dbname) const
 void BeamlineContext::setParticle( Particle const& p) 
 { 
   particle_ = p.clone();
+  delete closedOrbit_; closedOrbit_ = 0;
   clear();
 }
 
@@ -260,6 +293,7 @@ void BeamlineContext::setParticle( Particle const& p)
 
 char const*  BeamlineContext::dbname() const
 { 
+  lattice_.flush( *db_ );
   return dbname_.c_str();
 }
 
@@ -305,6 +339,11 @@ CSLattFuncs4D const& BeamlineContext::getInitialCS4D()
 
 Mapping const& BeamlineContext::getOneTurnMap()
 {
+  if ( oneTurnMapLinear_ ) {            // the map of the full Jet propagation is expected 
+    oneTurnMapOk_ = false;
+    delete closedOrbit_; closedOrbit_ = 0;
+    oneTurnMap();
+  }
   return refjp_.state();
 }
 
@@ -379,14 +418,48 @@ Particle const& BeamlineContext::getParticle()
 //||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
 //||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
 
+void BeamlineContext::oneTurnMap()
+{
+  if ( oneTurnMapOk_ ) return;
+
+  //-------------------------------------------------------------------------
+  // The last closed orbit is tried first: the cached element matrices are 
+  // brought up to date about it, which recomputes only the modified elements 
+  // (and those downstream, if the orbit through them moved). If it still 
+  // closes, the one-turn map is the product of the cached matrices and no
+  // Jet propagation is needed. Otherwise, the closed orbit is searched 
+  // again, with a full Jet propagation.
+  //-------------------------------------------------------------------------
+
+  if ( closedOrbit_ ) { 
+    matrices_.update( *this, *closedOrbit_ );
+    if ( closes( *closedOrbit_, matrices_.particle( matrices_.size()-1 ) ) ) {
+      refjp_            = matrices_.oneTurnJetParticle();
+      oneTurnMapOk_     = true;
+      oneTurnMapLinear_ = true;
+      return;
+    }
+  }
+
+  refjp_ = Optics::find_closed_orbit( (*db_), *this, JetParticle(*particle_) );  
+
+  delete closedOrbit_;
+  closedOrbit_      = new Particle(refjp_);
+  oneTurnMapOk_     = true;
+  oneTurnMapLinear_ = false;
+}
+
+//||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
 void BeamlineContext::periodicReferenceOrbit()
 {
   if( reference_orbit_ok() )  return; 
 
-   refjp_ = Optics::find_closed_orbit( (*db_), *this, JetParticle(*particle_) );  
+   oneTurnMap();
    Particle p(refjp_);
    registerReference(p);
-   Optics::orbit( (*db_), *this,  p);
+   Optics::orbit( lattice_, *this,  p);
 
 }
 
@@ -415,7 +488,7 @@ void BeamlineContext::propagateReferenceOrbit()
 
    registerReference(p);
 
-   Optics::orbit( (*db_), *this, p );
+   Optics::orbit( lattice_, *this, p );
 }
 
 //||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
@@ -424,7 +497,7 @@ void BeamlineContext::propagateReferenceOrbit()
 Vector BeamlineContext::chromaticity() const
 {
      Vector eta0 = Optics::periodicDispersion( (*db_), refjp_ );  
-     Vector chromas = Optics::chromaticity( (*db_), *this, refjp_, eta0 );
+     Vector chromas = Optics::chromaticity( (*db_), offmomentum_, *this, refjp_, eta0 );
 
   return chromas;
 }
@@ -456,14 +529,9 @@ double BeamlineContext::getVTune()
 void BeamlineContext::computeEigenTunes()
 {
 
-  if( !reference_orbit_ok() ) {
-    try {
-      periodicReferenceOrbit(); 
-    }
-    catch( GenericException const& ge ) {
-      throw ge;
-    }
-  }
+  // The tunes need the one-turn map only, not the orbit along the ring.
+
+  oneTurnMap(); 
  
   // FIXME: this should not be called if the tunes have already been computed.
 
@@ -484,7 +552,8 @@ void  BeamlineContext::periodicCourantSnyder2D()
   
    if ( isTreatedAsRing() ){
      CSLattFuncs lf = initialCSLattFuncs_ = Optics::periodicCourantSnyder2D( (*db_), refjp_ );  
-     Optics::propagateCourantSnyder2D( (*db_), *this, refjp_, lf );
+     matrices_.update( *this, Particle(refjp_) );
+     matrices_.propagateCourantSnyder2D( lattice_, lf );
    }  
    else {
       throw GenericException( __FILE__, __LINE__, 
@@ -501,7 +570,8 @@ void BeamlineContext::propagateCourantSnyder2D()
 {
  if ( !reference_orbit_ok() ) { propagateReferenceOrbit(); }
 
- Optics::propagateCourantSnyder2D( (*db_), *this, refjp_,  initialCSLattFuncs_ );
+ matrices_.update( *this, Particle(refjp_) );
+ matrices_.propagateCourantSnyder2D( lattice_, initialCSLattFuncs_ );
 }
 
 //||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
@@ -555,7 +625,8 @@ void BeamlineContext::periodicCourantSnyder4D()
     if ( isTreatedAsRing() ){
       if ( courant_snyder4d_ok() ) return;
       CSLattFuncs4D lf = Optics::periodicCourantSnyder4D( (*db_), refjp_ );  
-      Optics::propagateCourantSnyder4D( (*db_), *this, refjp_, lf );
+      matrices_.update( *this, Particle(refjp_) );
+      Optics::propagateCourantSnyder4D( lattice_, matrices_, refjp_, lf );
     }  
     else { 
       throw GenericException( __FILE__, __LINE__, 
@@ -587,7 +658,8 @@ void BeamlineContext::propagateCourantSnyder4D()
 
     // if( !reference_orbit_ok() ) { periodicReferenceOrbit(); }
  
-    Optics::propagateCourantSnyder4D( (*db_), *this, refjp_, CSLattFuncs4D(initialCSLattFuncs_) );
+    matrices_.update( *this, Particle(refjp_) );
+    Optics::propagateCourantSnyder4D( lattice_, matrices_, refjp_, CSLattFuncs4D(initialCSLattFuncs_) );
 
   }// try
   
@@ -605,16 +677,16 @@ void  BeamlineContext::periodicDispersion()
   
    if ( !reference_orbit_ok() )  { periodicReferenceOrbit(); }
 
-   Particle p(*particle_); 
+   matrices_.update( *this, Particle(refjp_) );
 
    if ( isTreatedAsRing() ){
      Vector eta0 = Optics::periodicDispersion( (*db_), refjp_ );  
-     Optics::propagateDispersion( (*db_), *this, refjp_, eta0 );
+     matrices_.propagateDispersion( lattice_, eta0 );
    }  
    else {
 
       Vector eta0 = initialCSLattFuncs_.dispersion.eta;  
-      Optics::propagateDispersion( (*db_), *this, refjp_, eta0 );
+      matrices_.propagateDispersion( lattice_, eta0 );
 
       // throw GenericException( __FILE__, __LINE__, 
       //   "BeamlineContext::periodicDispersion()", 
@@ -632,7 +704,8 @@ void  BeamlineContext::propagateDispersion()
      if ( !reference_orbit_ok() )  { propagateReferenceOrbit(); }
 
      Vector eta0 = initialCSLattFuncs_.dispersion.eta;  
-     Optics::propagateDispersion( (*db_), *this, refjp_, eta0 );
+     matrices_.update( *this, Particle(refjp_) );
+     matrices_.propagateDispersion( lattice_, eta0 );
 }
 
 //||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
@@ -651,7 +724,10 @@ MatrixD BeamlineContext::equilibriumCovariance()
 void  BeamlineContext::clear()
 {
   Optics:: cleardb(*db_);
+  lattice_.clear();
   refjp_ = JetParticle(*particle_);
+  oneTurnMapOk_     = false;
+  oneTurnMapLinear_ = false;
 }
 
 //||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
@@ -659,7 +735,7 @@ void  BeamlineContext::clear()
 
 bool  BeamlineContext::reference_orbit_ok() const
 {
-  return Optics::reference_orbit_ok( *db_);
+  return lattice_.ok( "REFERENCE_ORBIT" );
 } 
 
 //||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
@@ -667,7 +743,7 @@ bool  BeamlineContext::reference_orbit_ok() const
 
 bool     BeamlineContext::dispersion_ok() const
 {  
-  return Optics::dispersion_ok( *db_);
+  return lattice_.ok( "DISPERSION" );
 }
 
 //||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
@@ -675,7 +751,7 @@ bool     BeamlineContext::dispersion_ok() const
 
 bool     BeamlineContext::eigenvectors_ok() const
 {  
-  return Optics::eigenvectors_ok( *db_);
+  return lattice_.ok( "EIGENVECTORS" );
 }
 
 //||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
@@ -683,7 +759,7 @@ bool     BeamlineContext::eigenvectors_ok() const
 
 bool    BeamlineContext::courant_snyder2d_ok() const
 {
-  return Optics::courant_snyder2d_ok( *db_ );
+  return lattice_.ok( "COURANT_SNYDER" );
 }
 
 //||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
@@ -691,7 +767,7 @@ bool    BeamlineContext::courant_snyder2d_ok() const
 
 bool        BeamlineContext::edwards_teng_ok() const
 {
-  return Optics::edwards_teng_ok( *db_);
+  return lattice_.ok( "EDWARDS_TENG" );
 }
 
 //||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
@@ -699,7 +775,7 @@ bool        BeamlineContext::edwards_teng_ok() const
 
 bool BeamlineContext::covariance_ok() const
 {
-  return Optics::covariance_ok( *db_);
+  return lattice_.ok( "COVARIANCE" );
 }
 
 //||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
@@ -707,7 +783,7 @@ bool BeamlineContext::covariance_ok() const
 
 bool  BeamlineContext::courant_snyder4d_ok() const
 {
-  return Optics::courant_snyder4d_ok( *db_);
+  return lattice_.ok( "COURANT_SNYDER_4D" );
 }
 
 //||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
@@ -787,7 +863,7 @@ bool BeamlineContext::isRing() const
 
 std::vector<double> BeamlineContext::arclength() const
 {
-  return Optics::arclength(dbname_);
+  return Optics::arclength(lattice_);
 }
 
 //||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
@@ -795,7 +871,7 @@ std::vector<double> BeamlineContext::arclength() const
 
 std::vector<double> BeamlineContext::gamma() const
 {
-  return Optics::gamma(dbname_);
+  return Optics::gamma(lattice_);
 }
 
 //||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
@@ -803,14 +879,14 @@ std::vector<double> BeamlineContext::gamma() const
 
 std::vector<double> BeamlineContext::beta_x() const
 {
-  return Optics::beta_x(dbname_);
+  return Optics::beta_x(lattice_);
 }
 //||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
 //||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
 
 std::vector<double> BeamlineContext::beta_y() const
 {  
-  return Optics::beta_y(dbname_);
+  return Optics::beta_y(lattice_);
 }
 
 //||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
@@ -818,7 +894,7 @@ std::vector<double> BeamlineContext::beta_y() const
 
 std::vector<double> BeamlineContext::alpha_x() const
 {
-  return Optics::alpha_x(dbname_);
+  return Optics::alpha_x(lattice_);
 }
 
 //||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
@@ -826,7 +902,7 @@ std::vector<double> BeamlineContext::alpha_x() const
 
 std::vector<double> BeamlineContext::alpha_y() const
 {
-  return Optics::alpha_y(dbname_);
+  return Optics::alpha_y(lattice_);
 }
 
 //||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
@@ -834,7 +910,7 @@ std::vector<double> BeamlineContext::alpha_y() const
 
 std::vector<double> BeamlineContext::psi_x() const
 {
-  return Optics::psi_x(dbname_);
+  return Optics::psi_x(lattice_);
 }
 
 //||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
@@ -842,7 +918,7 @@ std::vector<double> BeamlineContext::psi_x() const
 
 std::vector<double> BeamlineContext::psi_y() const
 {
-  return Optics::psi_y(dbname_);
+  return Optics::psi_y(lattice_);
 }
 
 //||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
@@ -850,7 +926,7 @@ std::vector<double> BeamlineContext::psi_y() const
 
 std::vector<double> BeamlineContext::beta_1x() const
 {
-  return Optics::beta_1x(dbname_);
+  return Optics::beta_1x(lattice_);
 }
 
 //||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
@@ -858,7 +934,7 @@ std::vector<double> BeamlineContext::beta_1x() const
 
 std::vector<double> BeamlineContext::beta_1y() const
 {
-  return Optics::beta_1y(dbname_);
+  return Optics::beta_1y(lattice_);
 }
 
 //||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
@@ -866,7 +942,7 @@ std::vector<double> BeamlineContext::beta_1y() const
 
 std::vector<double> BeamlineContext::alpha_1x() const
 {
-  return Optics::alpha_1x(dbname_);
+  return Optics::alpha_1x(lattice_);
 }
 
 //||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
@@ -874,7 +950,7 @@ std::vector<double> BeamlineContext::alpha_1x() const
 
 std::vector<double> BeamlineContext::alpha_1y() const
 {
-  return Optics::alpha_1y(dbname_);
+  return Optics::alpha_1y(lattice_);
 }
 
 //||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
@@ -882,7 +958,7 @@ std::vector<double> BeamlineContext::alpha_1y() const
 
 std::vector<double> BeamlineContext::beta_2x() const
 {
-  return Optics::beta_2x(dbname_);
+  return Optics::beta_2x(lattice_);
 }
 
 //||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
@@ -890,7 +966,7 @@ std::vector<double> BeamlineContext::beta_2x() const
 
 std::vector<double> BeamlineContext::beta_2y() const
 {
-  return Optics::beta_2y(dbname_);
+  return Optics::beta_2y(lattice_);
 }
 
 //||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
@@ -898,7 +974,7 @@ std::vector<double> BeamlineContext::beta_2y() const
 
 std::vector<double> BeamlineContext::alpha_2x() const
 {
-  return Optics::alpha_2x(dbname_);
+  return Optics::alpha_2x(lattice_);
 }
 
 //||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
@@ -906,7 +982,7 @@ std::vector<double> BeamlineContext::alpha_2x() const
 
 std::vector<double> BeamlineContext::alpha_2y() const
 {
-  return Optics::alpha_2y(dbname_);
+  return Optics::alpha_2y(lattice_);
 }
 
 //||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
@@ -914,7 +990,7 @@ std::vector<double> BeamlineContext::alpha_2y() const
 
 std::vector<double> BeamlineContext::eta_x() const
 {  
-  return Optics::eta_x(dbname_);
+  return Optics::eta_x(lattice_);
 }
 
 //||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
@@ -922,7 +998,7 @@ std::vector<double> BeamlineContext::eta_x() const
 
 std::vector<double> BeamlineContext::eta_y() const
 {
-  return Optics::eta_y(dbname_);
+  return Optics::eta_y(lattice_);
 }
 
 //||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
@@ -930,7 +1006,7 @@ std::vector<double> BeamlineContext::eta_y() const
 
 std::vector<double> BeamlineContext::etap_x() const
 {
-   return Optics::etap_x(dbname_);
+   return Optics::etap_x(lattice_);
 }
 
 //||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
@@ -938,7 +1014,7 @@ std::vector<double> BeamlineContext::etap_x() const
 
 std::vector<double> BeamlineContext::etap_y() const
 {     
-  return Optics::etap_y(dbname_);
+  return Optics::etap_y(lattice_);
 }
 
 //||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
@@ -0,0 +1,366 @@
+/*************************************************************************
+**************************************************************************
+**************************************************************************
+******
+******  PHYSICS TOOLKIT: Library of utilites and Sage classes
+******             which facilitate calculations with the
+******             BEAMLINE class library.
+******
+******  File:      ClosedOrbitScan.cc
+******
+******  Copyright (c) Fermi Research Alliance LLC
+******                All Rights Reserved
+******
+******  Usage, modification, and redistribution are subject to terms
+******  of the License supplied with this software.
+******
+******  Software and documentation created under
+******  U.S. Department of Energy Contract No. DE-AC02-07CH11359.
+******  The U.S. Government retains a world-wide non-exclusive,
+******  royalty-free license to publish or reproduce documentation
+******  and software for U.S. Government purposes. This software
+******  is protected under the U.S. and Foreign Copyright Laws.
+******
+******  Revision History
+******
+******  Oct 2026
+******
+******  - Initial version.
+******
+**************************************************************************
+*************************************************************************/
+
+#include <physics_toolkit/ClosedOrbitScan.h>
+#include <physics_toolkit/Optics.h>
+#include <physics_toolkit/LatticeFunctionTable.h>
+#include <basic_toolkit/GenericException.h>
+#include <basic_toolkit/iosetup.h>
+#include <mxyzptlk/Jet__environment.h>
+#include <beamline/beamline.h>
+#include <beamline/Particle.h>
+
+#include <boost/thread.hpp>
+#include <boost/bind.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <sstream>
+
+using FNAL::pcerr;
+
+namespace {
+
+ typedef PhaseSpaceIndexing::index idx;
+
+ idx const i_x    = Particle::i_x;
+ idx const i_y    = Particle::i_y;
+ idx const i_npx  = Particle::i_npx;
+ idx const i_npy  = Particle::i_npy;
+ idx const i_ndp  = Particle::i_ndp;
+
+ double const closure_tolerance = 1.0e-8;   // [m], [rad]: transverse orbit mismatch after one turn
+
+ std::string const columns = "set:INTEGER dpp converged:INTEGER x y cdt npx npy ndp nux nuy "
+                             "m00 m01 m02 m03 m04 m05 m10 m11 m12 m13 m14 m15 m20 m21 m22 m23 m24 m25 "
+                             "m30 m31 m32 m33 m34 m35 m40 m41 m42 m43 m44 m45 m50 m51 m52 m53 m54 m55";
+
+} // anonymous namespace
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+//-----------------------------------------------------------------------------------
+// A Worker takes the next task from the shared counter until none is left.
+// It owns its copy of the ring.
+//-----------------------------------------------------------------------------------
+
+class ClosedOrbitScan::Worker {
+
+ public:
+
+  Worker( ClosedOrbitScan const& scan, BmlPtr ring, std::vector<double> const& dpp, int nsets,
+          Setup const& setup, std::vector<Result>& results, boost::mutex& mutex, int& next )
+    : scan_(scan), ring_(ring), dpp_(dpp), nsets_(nsets), setup_(setup), results_(results), mutex_(mutex), next_(next)
+  {}
+
+  void operator()();
+
+ private:
+
+  ClosedOrbitScan const&      scan_;
+  BmlPtr                      ring_;
+  std::vector<double> const&  dpp_;
+  int                         nsets_;
+  Setup const&                setup_;
+  std::vector<Result>&        results_;
+  boost::mutex&               mutex_;
+  int&                        next_;
+};
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+void ClosedOrbitScan::Worker::operator()()
+{
+  int const ntasks = nsets_*dpp_.size();
+
+  while ( true ) {
+
+    int task = 0;
+    {
+      boost::mutex::scoped_lock lock( mutex_ );
+      if ( next_ >= ntasks ) return;
+      task = next_++;
+    }
+
+    Result& result = results_[task];
+
+    int    const set = task/dpp_.size();
+    double const dpp = dpp_[task%dpp_.size()];
+
+    try {
+      if ( setup_ ) {
+        BmlPtr ring( ring_->clone() );
+        setup_( *ring, set );
+        scan_.solve( *ring, dpp, result );
+      }
+      else {
+        scan_.solve( *ring_, dpp, result );
+      }
+    }
+    catch ( std::exception const& e ) {
+      result.converged = false;
+      boost::mutex::scoped_lock lock( mutex_ );
+      (*pcerr) << "*** WARNING *** ClosedOrbitScan: task " << task << " (set " << set
+               << ", dp/p = " << dpp << ") failed: " << e.what() << std::endl;
+    }
+    catch ( ... ) {
+      result.converged = false;
+    }
+  }
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+ClosedOrbitScan::Result::Result( JetParticle const& jp )
+  : converged(false), oneturn(jp), nux(0.0), nuy(0.0)
+{}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+ClosedOrbitScan::ClosedOrbitScan( beamline const& ring, JetParticle const& jp )
+  : ring_( ring.clone() ), jp_(jp), nthreads_(0), results_()
+{}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+ClosedOrbitScan::~ClosedOrbitScan()
+{}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+void ClosedOrbitScan::setNumberOfThreads( int n )
+{
+  if ( n < 0 ) {
+    throw GenericException( __FILE__, __LINE__,
+          "void ClosedOrbitScan::setNumberOfThreads( int n )",
+          "The number of threads cannot be negative." );
+  }
+
+  nthreads_ = n;
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+int ClosedOrbitScan::numberOfThreads() const
+{
+  if ( nthreads_ > 0 ) return nthreads_;
+
+  int const n = boost::thread::hardware_concurrency();
+
+  return ( n > 0 ) ? n : 1;
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+bool ClosedOrbitScan::converged( int task ) const
+{
+  if ( (task < 0) || (task >= numTasks()) ) {
+    throw GenericException( __FILE__, __LINE__,
+           "bool ClosedOrbitScan::converged( int task ) const",
+           "Task index out of range." );
+  }
+  return results_[task].converged;
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+JetParticle const& ClosedOrbitScan::oneTurnMap( int task ) const
+{
+  if ( (task < 0) || (task >= numTasks()) ) {
+    throw GenericException( __FILE__, __LINE__,
+           "JetParticle const& ClosedOrbitScan::oneTurnMap( int task ) const",
+           "Task index out of range." );
+  }
+  return results_[task].oneturn;
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+void ClosedOrbitScan::solve( beamline const& ring, double dpp, Result& result ) const
+{
+  Particle p( jp_ );
+  p.state()[i_ndp] = dpp;
+
+  result.oneturn = Optics::closed_orbit( ring, JetParticle( p, jp_.state().Env() ) );
+
+  //-----------------------------------------------------------------
+  // The search stops after a fixed number of iterations, converged
+  // or not: the orbit is propagated once more to check that it closes.
+  //-----------------------------------------------------------------
+
+  Particle co( result.oneturn );
+  Particle probe( co );
+
+  ring.propagate( probe );
+
+  double mismatch = 0.0;
+
+  idx const transverse[] = { i_x, i_npx, i_y, i_npy };
+
+  for ( int k=0; k<4; ++k ) {
+    mismatch = std::max( mismatch, std::abs( probe.state()[transverse[k]] - co.state()[transverse[k]] ) );
+  }
+
+  result.converged = ( mismatch < closure_tolerance );  // false if NaN
+
+  if ( !result.converged ) return;
+
+  Vector const nu = Optics::tunes( result.oneturn );
+
+  result.nux = nu[0];
+  result.nuy = nu[1];
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+int ClosedOrbitScan::run( LatticeFunctionTable& lft, std::vector<double> const& dpp )
+{
+  return run( lft, dpp, 1, Setup() );
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+int ClosedOrbitScan::run( LatticeFunctionTable& lft, std::vector<double> const& dpp, int nsets, Setup const& setup )
+{
+  if ( nsets < 1 ) {
+    throw GenericException( __FILE__, __LINE__,
+          "int ClosedOrbitScan::run( LatticeFunctionTable&, std::vector<double> const&, int, Setup const& )",
+          "The number of parameter sets must be positive." );
+  }
+
+  int const ntasks   = nsets*dpp.size();
+  int const nworkers = std::min( numberOfThreads(), ntasks );
+
+  results_.assign( ntasks, Result( jp_ ) );
+
+  //-----------------------------------------------------------------
+  // The environment stack is global: it is set up here, once, for
+  // all the workers. The copies of the ring are made here as well.
+  //-----------------------------------------------------------------
+
+   Jet__environment::pushEnv( jp_.state().Env() );
+  JetC__environment::pushEnv( jp_.state().Env() );
+
+  boost::mutex mutex;
+  int          next = 0;
+
+  try {
+
+    std::vector<Worker> workers;
+    workers.reserve( nworkers );
+
+    for ( int j=0; j<nworkers; ++j ) {
+      workers.push_back( Worker( *this, BmlPtr( ring_->clone() ), dpp, nsets, setup, results_, mutex, next ) );
+    }
+
+    if ( nworkers == 1 ) {
+      workers[0]();
+    }
+    else {
+      boost::thread_group threads;
+
+      try {
+        for ( int j=0; j<nworkers; ++j ) { threads.create_thread( boost::ref( workers[j] ) ); }
+      }
+      catch ( ... ) {
+        {
+          boost::mutex::scoped_lock lock( mutex );
+          next = ntasks;        // the running workers stop after their current task
+        }
+        threads.join_all();
+        throw;
+      }
+
+      threads.join_all();
+    }
+  }
+  catch ( ... ) {
+     Jet__environment::popEnv();
+    JetC__environment::popEnv();
+    throw;
+  }
+
+   Jet__environment::popEnv();
+  JetC__environment::popEnv();
+
+  //-----------------------------------------------------------------
+  // collect the results
+  //-----------------------------------------------------------------
+
+  LatticeFunctionTable::Table& table = lft.define( "CLOSED_ORBIT_SCAN", columns );
+
+  table.reserve( ntasks );
+
+  double const nan = std::numeric_limits<double>::quiet_NaN();
+
+  int nfailed = 0;
+
+  for ( int task=0; task<ntasks; ++task ) {
+
+    Result const& r = results_[task];
+
+    table << task/int( dpp.size() ) << dpp[task%dpp.size()] << int( r.converged );
+
+    if ( !r.converged ) {
+      ++nfailed;
+      for ( int k=0; k<6+2+36; ++k ) { table << nan; }
+      continue;
+    }
+
+    Particle const co( r.oneturn );
+
+    for ( int i=0; i<6; ++i ) { table << co.state()[i]; }
+
+    table << r.nux << r.nuy;
+
+    MatrixD const m = r.oneturn.state().jacobian();
+
+    for ( int i=0; i<6; ++i ) {
+      for ( int j=0; j<6; ++j ) { table << m[i][j]; }
+    }
+  }
+
+  return nfailed;
+}
@@ -0,0 +1,523 @@
+/*************************************************************************
+**************************************************************************
+**************************************************************************
+******
+******  PHYSICS TOOLKIT: Library of utilites and Sage classes
+******             which facilitate calculations with the
+******             BEAMLINE class library.
+******
+******  File:      DynamicAperture.cc
+******
+******  Copyright (c) Fermi Research Alliance LLC
+******                All Rights Reserved
+******
+******  Usage, modification, and redistribution are subject to terms
+******  of the License supplied with this software.
+******
+******  Software and documentation created under
+******  U.S. Department of Energy Contract No. DE-AC02-07CH11359.
+******  The U.S. Government retains a world-wide non-exclusive,
+******  royalty-free license to publish or reproduce documentation
+******  and software for U.S. Government purposes. This software
+******  is protected under the U.S. and Foreign Copyright Laws.
+******
+******  Revision History
+******
+******  Oct 2026
+******
+******  - Initial version.
+******
+**************************************************************************
+*************************************************************************/
+
+#include <physics_toolkit/DynamicAperture.h>
+#include <physics_toolkit/LatticeFunctionTable.h>
+#include <basic_toolkit/GenericException.h>
+#include <basic_toolkit/WorkerPool.h>
+#include <beamline/beamline.h>
+#include <beamline/Particle.h>
+#include <beamline/BunchArrays.h>
+
+#include <boost/thread.hpp>
+#include <boost/ref.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <exception>
+#include <string>
+
+namespace {
+
+ typedef PhaseSpaceIndexing::index idx;
+
+ idx const i_x = Particle::i_x;
+ idx const i_y = Particle::i_y;
+
+ std::string const columns          = "x y amplitude angle turns:INTEGER tracked:INTEGER";
+ std::string const boundary_columns = "angle amplitude";
+
+} // anonymous namespace
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+//-----------------------------------------------------------------------------------
+// A Worker takes the next batch of initial conditions until none is left.
+// It owns its copy of the ring.
+//-----------------------------------------------------------------------------------
+
+class DynamicAperture::Worker {
+
+ public:
+
+  Worker( DynamicAperture& da, BmlPtr ring, std::vector<int> const& ids, int nturns,
+          boost::mutex& mutex, int& next, std::string& error );
+
+  void operator()();
+
+ private:
+
+  void track( int first, int last );
+
+  DynamicAperture&         da_;
+  BmlPtr                   ring_;
+  std::vector<ElmPtr>      elements_;
+  std::vector<int> const&  ids_;
+  int                      nturns_;
+  boost::mutex&            mutex_;
+  int&                     next_;
+  std::string&             error_;
+};
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+DynamicAperture::Worker::Worker( DynamicAperture& da, BmlPtr ring, std::vector<int> const& ids, int nturns,
+                                 boost::mutex& mutex, int& next, std::string& error )
+  : da_(da), ring_(ring), elements_(), ids_(ids), nturns_(nturns), mutex_(mutex), next_(next), error_(error)
+{
+  // the batches are tracked element by element: nested lines do not start threads of their own
+
+  for ( beamline::deep_iterator it = ring_->deep_begin(); it != ring_->deep_end(); ++it ) {
+    elements_.push_back( *it );
+  }
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+void DynamicAperture::Worker::operator()()
+{
+  int const n = ids_.size();
+
+  while ( true ) {
+
+    int first = 0;
+    {
+      boost::mutex::scoped_lock lock( mutex_ );
+      if ( next_ >= n ) return;
+      first  = next_;
+      next_ += da_.batchSize_;
+    }
+
+    //---------------------------------------------------------------
+    // exceptions cannot propagate across threads; the first message
+    // is kept and the other workers stop after their current batch.
+    //---------------------------------------------------------------
+
+    try {
+      track( first, std::min( first + da_.batchSize_, n ) );
+    }
+    catch ( std::exception const& e ) {
+      boost::mutex::scoped_lock lock( mutex_ );
+      if ( error_.empty() ) { error_ = e.what(); }
+      next_ = n;
+      return;
+    }
+    catch ( ... ) {
+      boost::mutex::scoped_lock lock( mutex_ );
+      if ( error_.empty() ) { error_ = "Unknown exception."; }
+      next_ = n;
+      return;
+    }
+  }
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+void DynamicAperture::Worker::track( int first, int last )
+{
+  std::vector<Point>& points = da_.points_;
+
+  BunchArrays batch( *da_.particle_, 0 );
+  batch.reserve( last - first );
+
+  std::vector<int> active;                       // point index of each particle of the batch
+
+  for ( int k=first; k<last; ++k ) {
+    Point const& pt = points[ ids_[k] ];
+    Vector state = da_.particle_->state();
+    state[i_x] += pt.x;
+    state[i_y] += pt.y;
+    batch.append( state );
+    active.push_back( ids_[k] );
+  }
+
+  double const escape = da_.escape_;
+
+  for ( int turn=0; turn < nturns_ && !batch.empty(); ++turn ) {
+
+    for ( std::vector<ElmPtr>::const_iterator it = elements_.begin(); it != elements_.end(); ++it ) {
+      (*it)->propagate( batch );
+    }
+
+    //-------------------------------------------------------------
+    // Losses of the turn: flagged by an aperture, or escaped.
+    // The lost particles are removed; the order of the others, and
+    // of their indices, is preserved.
+    //-------------------------------------------------------------
+
+    double const* const x = batch[i_x];
+    double const* const y = batch[i_y];
+
+    int nactive = 0;
+
+    for ( int j=0; j < batch.size(); ++j ) {
+
+      bool const escaped = !( std::abs( x[j] ) <= escape && std::abs( y[j] ) <= escape );   // true if NaN
+
+      if ( batch.isLost(j) || escaped ) {
+        batch.setLost(j);
+        points[ active[j] ].turns = turn;
+        continue;
+      }
+
+      active[nactive++] = active[j];
+    }
+
+    if ( nactive < batch.size() ) {
+      batch.compact();
+      active.resize( nactive );
+    }
+  }
+
+  for ( std::vector<int>::const_iterator it = active.begin(); it != active.end(); ++it ) {
+    points[*it].turns = nturns_;
+  }
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+DynamicAperture::Point::Point( double x0, double y0 )
+  : x(x0), y(y0), turns(0), tracked(false)
+{}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+DynamicAperture::DynamicAperture( beamline const& ring, Particle const& particle )
+  : ring_( ring.clone() ), particle_( particle.clone() ), nthreads_(0), batchSize_(64),
+    escape_(1.0), refinement_(1), points_()
+{}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+DynamicAperture::~DynamicAperture()
+{
+  delete particle_;
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+void DynamicAperture::setNumberOfThreads( int n )
+{
+  if ( n < 0 ) {
+    throw GenericException( __FILE__, __LINE__,
+          "void DynamicAperture::setNumberOfThreads( int n )",
+          "The number of threads cannot be negative." );
+  }
+
+  nthreads_ = n;
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+int DynamicAperture::numberOfThreads() const
+{
+  if ( nthreads_ > 0 ) return nthreads_;
+
+  int const n = boost::thread::hardware_concurrency();
+
+  return ( n > 0 ) ? n : 1;
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+void DynamicAperture::setBatchSize( int n )
+{
+  if ( n < 1 ) {
+    throw GenericException( __FILE__, __LINE__,
+          "void DynamicAperture::setBatchSize( int n )",
+          "The batch size must be positive." );
+  }
+
+  batchSize_ = n;
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+void DynamicAperture::setEscapeAmplitude( double a )
+{
+  if ( !( a > 0.0 ) ) {
+    throw GenericException( __FILE__, __LINE__,
+          "void DynamicAperture::setEscapeAmplitude( double a )",
+          "The escape amplitude must be positive." );
+  }
+
+  escape_ = a;
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+void DynamicAperture::setRefinement( int m )
+{
+  if ( m < 1 ) {
+    throw GenericException( __FILE__, __LINE__,
+          "void DynamicAperture::setRefinement( int m )",
+          "The refinement step must be positive." );
+  }
+
+  refinement_ = m;
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+int DynamicAperture::survivalTurns( int point ) const
+{
+  if ( (point < 0) || (point >= numPoints()) ) {
+    throw GenericException( __FILE__, __LINE__,
+           "int DynamicAperture::survivalTurns( int point ) const",
+           "Point index out of range." );
+  }
+  return points_[point].turns;
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+int DynamicAperture::track( std::vector<int> const& ids, int nturns )
+{
+  int const nbatches = ( ids.size() + batchSize_ - 1 )/batchSize_;
+  int const nworkers = std::min( numberOfThreads(), nbatches );
+
+  if ( nworkers == 0 ) return 0;
+
+  for ( std::vector<int>::const_iterator it = ids.begin(); it != ids.end(); ++it ) {
+    points_[*it].tracked = true;
+  }
+
+  boost::mutex mutex;
+  int          next = 0;
+  std::string  error;
+
+  std::vector<Worker> workers;
+  workers.reserve( nworkers );
+
+  for ( int j=0; j<nworkers; ++j ) {
+    workers.push_back( Worker( *this, BmlPtr( ring_->clone() ), ids, nturns, mutex, next, error ) );
+  }
+
+  if ( nworkers == 1 ) {
+    workers[0]();
+  }
+  else {
+
+    //---------------------------------------------------------------
+    // The workers are tasks of the shared pool. When track() is 
+    // itself called from a task of the pool, they run one after the 
+    // other, and the first one takes all the batches.
+    //---------------------------------------------------------------
+
+    std::vector<WorkerPool::Task> tasks;
+    tasks.reserve( nworkers );
+
+    for ( int j=0; j<nworkers; ++j ) { tasks.push_back( boost::ref( workers[j] ) ); }
+
+    WorkerPool::instance().run( tasks );
+  }
+
+  if ( !error.empty() ) {
+    throw GenericException( __FILE__, __LINE__,
+          "int DynamicAperture::track( std::vector<int> const& ids, int nturns )",
+          error.c_str() );
+  }
+
+  return ids.size();
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+int DynamicAperture::polar( LatticeFunctionTable& lft, int nturns, double amax, int namplitudes, int nangles )
+{
+  if ( nturns < 1 || namplitudes < 1 || nangles < 1 || !( amax > 0.0 ) ) {
+    throw GenericException( __FILE__, __LINE__,
+          "int DynamicAperture::polar( LatticeFunctionTable&, int, double, int, int )",
+          "The number of turns, of amplitudes and of angles, and the largest amplitude must be positive." );
+  }
+
+  //-----------------------------------------------------------------
+  // point index = ray*namplitudes + amplitude index
+  //-----------------------------------------------------------------
+
+  points_.clear();
+  points_.reserve( namplitudes*nangles );
+
+  std::vector<double> angles( nangles );
+
+  for ( int j=0; j<nangles; ++j ) {
+    angles[j] = 0.5*M_PI*( j+1 )/( nangles+1 );
+    for ( int k=0; k<namplitudes; ++k ) {
+      double const r = amax*( k+1 )/namplitudes;
+      points_.push_back( Point( r*cos( angles[j] ), r*sin( angles[j] ) ) );
+    }
+  }
+
+  int const m = refinement_;
+
+  std::vector<int> ids;
+
+  for ( int j=0; j<nangles; ++j ) {
+    for ( int k=0; k<namplitudes; ++k ) {
+      if ( (k+1)%m == 0 || k == namplitudes-1 ) { ids.push_back( j*namplitudes + k ); }
+    }
+  }
+
+  int ntracked = track( ids, nturns );
+
+  if ( m > 1 ) {
+
+    //---------------------------------------------------------------
+    // first loss on each ray, and the points left between it and
+    // the previous coarse point
+    //---------------------------------------------------------------
+
+    std::vector<int> first( nangles, namplitudes );   // amplitude index of the first tracked loss
+
+    ids.clear();
+
+    for ( int j=0; j<nangles; ++j ) {
+
+      int previous = -1;
+
+      for ( int k=0; k<namplitudes; ++k ) {
+        Point const& pt = points_[ j*namplitudes + k ];
+        if ( !pt.tracked ) continue;
+        if ( pt.turns < nturns ) { first[j] = k; break; }
+        previous = k;
+      }
+
+      for ( int k=previous+1; k<first[j]; ++k ) {
+        if ( !points_[ j*namplitudes + k ].tracked ) { ids.push_back( j*namplitudes + k ); }
+      }
+    }
+
+    ntracked += track( ids, nturns );
+
+    //---------------------------------------------------------------
+    // The untracked points below the first loss survive; those above
+    // take the result of the nearest tracked point below them.
+    //---------------------------------------------------------------
+
+    for ( int j=0; j<nangles; ++j ) {
+
+      int turns = nturns;
+
+      for ( int k=0; k<namplitudes; ++k ) {
+        Point& pt = points_[ j*namplitudes + k ];
+        if ( pt.tracked ) {
+          turns = ( k < first[j] ) ? nturns : pt.turns;
+        }
+        else {
+          pt.turns = turns;
+        }
+      }
+    }
+  }
+
+  write( lft );
+
+  //-----------------------------------------------------------------
+  // boundary
+  //-----------------------------------------------------------------
+
+  LatticeFunctionTable::Table& boundary = lft.define( "DYNAMIC_APERTURE_BOUNDARY", boundary_columns );
+
+  boundary.reserve( nangles );
+
+  for ( int j=0; j<nangles; ++j ) {
+    int k = 0;
+    while ( k < namplitudes && points_[ j*namplitudes + k ].turns >= nturns ) { ++k; }
+    boundary << angles[j] << amax*k/namplitudes;
+  }
+
+  return ntracked;
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+int DynamicAperture::cartesian( LatticeFunctionTable& lft, int nturns, double xmin, double xmax, int nx,
+                                                                       double ymin, double ymax, int ny )
+{
+  if ( nturns < 1 || nx < 1 || ny < 1 ) {
+    throw GenericException( __FILE__, __LINE__,
+          "int DynamicAperture::cartesian( LatticeFunctionTable&, int, double, double, int, double, double, int )",
+          "The number of turns and of grid points must be positive." );
+  }
+
+  points_.clear();
+  points_.reserve( nx*ny );
+
+  double const dx = ( nx > 1 ) ? ( xmax - xmin )/( nx-1 ) : 0.0;
+  double const dy = ( ny > 1 ) ? ( ymax - ymin )/( ny-1 ) : 0.0;
+
+  std::vector<int> ids;
+
+  for ( int i=0; i<nx; ++i ) {
+    for ( int j=0; j<ny; ++j ) {
+      ids.push_back( points_.size() );
+      points_.push_back( Point( xmin + i*dx, ymin + j*dy ) );
+    }
+  }
+
+  int const ntracked = track( ids, nturns );
+
+  write( lft );
+
+  return ntracked;
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+void DynamicAperture::write( LatticeFunctionTable& lft ) const
+{
+  LatticeFunctionTable::Table& table = lft.define( "DYNAMIC_APERTURE", columns );
+
+  table.reserve( points_.size() );
+
+  for ( std::vector<Point>::const_iterator it = points_.begin(); it != points_.end(); ++it ) {
+    table << it->x << it->y << sqrt( it->x*it->x + it->y*it->y ) << atan2( it->y, it->x )
+          << it->turns << int( it->tracked );
+  }
+}
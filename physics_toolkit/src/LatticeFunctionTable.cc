@@ -0,0 +1,403 @@
+/*************************************************************************
+**************************************************************************
+**************************************************************************
+******
+******  PHYSICS TOOLKIT: Library of utilites and Sage classes
+******             which facilitate calculations with the
+******             BEAMLINE class library.
+******
+******  File:      LatticeFunctionTable.cc
+******
+******  Copyright (c) Fermi Research Alliance LLC
+******                All Rights Reserved
+******
+******  Usage, modification, and redistribution are subject to terms
+******  of the License supplied with this software.
+******
+******  Software and documentation created under
+******  U.S. Department of Energy Contract No. DE-AC02-07CH11359.
+******  The U.S. Government retains a world-wide non-exclusive,
+******  royalty-free license to publish or reproduce documentation
+******  and software for U.S. Government purposes. This software
+******  is protected under the U.S. and Foreign Copyright Laws.
+******
+**************************************************************************
+*************************************************************************/
+
+#include <physics_toolkit/LatticeFunctionTable.h>
+#include <basic_toolkit/GenericException.h>
+
+#include <sstream>
+#include <sqlite/connection.hpp>
+#include <sqlite/command.hpp>
+#include <sqlite/execute.hpp>
+
+namespace {
+
+char const* const sqltype[] = { "REAL", "INTEGER", "TEXT" };
+
+} // anonymous namespace
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+LatticeFunctionTable::Table::Table( std::string const& name, std::string const& columns, bool keyed )
+  : name_(name), keyed_(keyed), columns_(), nrows_(0), field_(0), dirty_(true)
+{
+  std::istringstream is(columns);
+  std::string        word;
+
+  while ( is >> word ) {
+
+    Column col;
+    col.type = real;
+
+    std::string::size_type pos = word.find(':');
+    col.name = word.substr( 0, pos );
+
+    if ( pos != std::string::npos ) {
+      std::string const type = word.substr( pos+1 );
+      if      ( type == "REAL"    ) { col.type = real;    }
+      else if ( type == "INTEGER" ) { col.type = integer; }
+      else if ( type == "TEXT"    ) { col.type = text;    }
+      else {
+        throw GenericException( __FILE__, __LINE__,
+              "LatticeFunctionTable::Table::Table( std::string const& name, std::string const& columns, bool keyed )",
+              "Unknown column type " + type + " in table " + name + "." );
+      }
+    }
+
+    columns_.push_back( col );
+  }
+
+  if ( columns_.empty() ) {
+    throw GenericException( __FILE__, __LINE__,
+          "LatticeFunctionTable::Table::Table( std::string const& name, std::string const& columns, bool keyed )",
+          "Table " + name + " has no columns." );
+  }
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+std::string const& LatticeFunctionTable::Table::columnName( int j ) const
+{
+  return columns_.at(j).name;
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+LatticeFunctionTable::Table::column_type LatticeFunctionTable::Table::columnType( int j ) const
+{
+  return columns_.at(j).type;
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+int LatticeFunctionTable::Table::columnIndex( std::string const& colname ) const
+{
+  for ( int j=0; j < int( columns_.size() ); ++j ) {
+    if ( columns_[j].name == colname ) return j;
+  }
+  return -1;
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+LatticeFunctionTable::Table::Column const& LatticeFunctionTable::Table::find( std::string const& colname, column_type type ) const
+{
+  int const j = columnIndex( colname );
+
+  if ( j < 0 ) {
+    throw GenericException( __FILE__, __LINE__,
+          "LatticeFunctionTable::Table::find( std::string const& colname, column_type type ) const",
+          "Table " + name_ + " has no column " + colname + "." );
+  }
+
+  if ( columns_[j].type != type ) {
+    throw GenericException( __FILE__, __LINE__,
+          "LatticeFunctionTable::Table::find( std::string const& colname, column_type type ) const",
+          "Column " + colname + " of table " + name_ + " is of type " + sqltype[ columns_[j].type ] + "." );
+  }
+
+  return columns_[j];
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+std::vector<double> const& LatticeFunctionTable::Table::column( std::string const& colname ) const
+{
+  return find( colname, real ).reals;
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+std::vector<double> const& LatticeFunctionTable::Table::column( int j ) const
+{
+  return find( columnName(j), real ).reals;
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+std::vector<boost::int64_t> const& LatticeFunctionTable::Table::integerColumn( std::string const& colname ) const
+{
+  return find( colname, integer ).integers;
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+std::vector<std::string> const& LatticeFunctionTable::Table::textColumn( std::string const& colname ) const
+{
+  return find( colname, text ).texts;
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+LatticeFunctionTable::Table::Column& LatticeFunctionTable::Table::next( column_type type )
+{
+  Column& col = columns_[field_];
+
+  if ( col.type != type ) {
+    throw GenericException( __FILE__, __LINE__,
+          "LatticeFunctionTable::Table::next( column_type type )",
+          "Wrong value type for column " + col.name + " of table " + name_ + "." );
+  }
+
+  if ( ++field_ == int( columns_.size() ) ) { field_ = 0; ++nrows_; }
+
+  dirty_ = true;
+
+  return col;
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+LatticeFunctionTable::Table& LatticeFunctionTable::Table::operator<<( double value )
+{
+  next( real ).reals.push_back( value );
+  return *this;
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+LatticeFunctionTable::Table& LatticeFunctionTable::Table::operator<<( int value )
+{
+  return (*this) << boost::int64_t( value );
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+LatticeFunctionTable::Table& LatticeFunctionTable::Table::operator<<( boost::int64_t value )
+{
+  next( integer ).integers.push_back( value );
+  return *this;
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+LatticeFunctionTable::Table& LatticeFunctionTable::Table::operator<<( std::string const& value )
+{
+  next( text ).texts.push_back( value );
+  return *this;
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+void LatticeFunctionTable::Table::reserve( int nrows )
+{
+  for ( std::vector<Column>::iterator it = columns_.begin(); it != columns_.end(); ++it ) {
+    switch ( it->type ) {
+      case real:    it->reals.reserve(nrows);    break;
+      case integer: it->integers.reserve(nrows); break;
+      case text:    it->texts.reserve(nrows);    break;
+    }
+  }
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+void LatticeFunctionTable::Table::clear()
+{
+  for ( std::vector<Column>::iterator it = columns_.begin(); it != columns_.end(); ++it ) {
+    it->reals.clear();
+    it->integers.clear();
+    it->texts.clear();
+  }
+
+  nrows_ = 0;
+  field_ = 0;
+  dirty_ = true;
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+LatticeFunctionTable::Table& LatticeFunctionTable::define( std::string const& name, std::string const& columns, bool keyed )
+{
+  tables_.erase( name );
+  return tables_.insert( std::make_pair( name, Table( name, columns, keyed ) ) ).first->second;
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+bool LatticeFunctionTable::has( std::string const& name ) const
+{
+  return tables_.find( name ) != tables_.end();
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+bool LatticeFunctionTable::ok( std::string const& name ) const
+{
+  std::map<std::string, Table>::const_iterator it = tables_.find( name );
+  return ( it != tables_.end() ) && !it->second.empty();
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+LatticeFunctionTable::Table& LatticeFunctionTable::operator[]( std::string const& name )
+{
+  std::map<std::string, Table>::iterator it = tables_.find( name );
+
+  if ( it == tables_.end() ) {
+    throw GenericException( __FILE__, __LINE__,
+          "LatticeFunctionTable::Table& LatticeFunctionTable::operator[]( std::string const& name )",
+          "No table named " + name + "." );
+  }
+
+  return it->second;
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+LatticeFunctionTable::Table const& LatticeFunctionTable::operator[]( std::string const& name ) const
+{
+  std::map<std::string, Table>::const_iterator it = tables_.find( name );
+
+  if ( it == tables_.end() ) {
+    throw GenericException( __FILE__, __LINE__,
+          "LatticeFunctionTable::Table const& LatticeFunctionTable::operator[]( std::string const& name ) const",
+          "No table named " + name + "." );
+  }
+
+  return it->second;
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+std::vector<double> const& LatticeFunctionTable::column( std::string const& name, std::string const& colname ) const
+{
+  return (*this)[name].column( colname );
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+void LatticeFunctionTable::remove( std::string const& name )
+{
+  tables_.erase( name );
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+void LatticeFunctionTable::clear()
+{
+  tables_.clear();
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+void LatticeFunctionTable::flush( sqlite::connection& db )
+{
+  for ( std::map<std::string, Table>::iterator it = tables_.begin(); it != tables_.end(); ++it ) {
+    if ( it->second.dirty_ ) write( db, it->second );
+  }
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+void LatticeFunctionTable::flush( sqlite::connection& db, std::string const& name )
+{
+  write( db, (*this)[name] );
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+void LatticeFunctionTable::write( sqlite::connection& db, Table& table ) const
+{
+  if ( table.field_ != 0 ) {
+    throw GenericException( __FILE__, __LINE__,
+          "void LatticeFunctionTable::write( sqlite::connection& db, Table& table ) const",
+          "Table " + table.name_ + " has an incomplete row." );
+  }
+
+  std::vector<Table::Column> const& columns = table.columns_;
+
+  std::ostringstream sql;
+
+  sql << "DROP TABLE IF EXISTS " << table.name_ << std::ends;
+  sqlite::execute( db, sql.str(), true );
+
+  sql.str("");
+  sql << "CREATE TABLE " << table.name_ << " ( ";
+  if ( table.keyed_ ) { sql << "iseq INTEGER PRIMARY KEY, "; }
+  for ( int j=0; j < int( columns.size() ); ++j ) {
+    sql << ( j ? ", " : "" ) << columns[j].name << " " << sqltype[ columns[j].type ];
+  }
+  sql << " )" << std::ends;
+  sqlite::execute( db, sql.str(), true );
+
+  sql.str("");
+  sql << "INSERT INTO " << table.name_ << " VALUES ( ";
+  int const nfields = columns.size() + ( table.keyed_ ? 1 : 0 );
+  for ( int j=0; j < nfields; ++j ) { sql << ( j ? ", ?" : "?" ); }
+  sql << " )" << std::ends;
+
+  sqlite::command cmd( db, sql.str() );
+
+  sqlite::execute( db, "BEGIN TRANSACTION", true );
+
+  for ( int i=0; i < table.nrows_; ++i ) {
+
+    cmd.clear();
+
+    if ( table.keyed_ ) { cmd % i; }
+
+    for ( std::vector<Table::Column>::const_iterator it = columns.begin(); it != columns.end(); ++it ) {
+      switch ( it->type ) {
+        case Table::real:    cmd % it->reals[i];    break;
+        case Table::integer: cmd % it->integers[i]; break;
+        case Table::text:    cmd % it->texts[i];    break;
+      }
+    }
+
+    cmd();
+  }
+
+  sqlite::execute( db, "COMMIT TRANSACTION", true );
+
+  table.dirty_ = false;
+}
@@ -44,6 +44,8 @@
 #include <beamline/JetParticle.h>
 #include <beamline/LatticeFunctions.h>
 #include <physics_toolkit/BmlUtil.h>
+#include <physics_toolkit/LatticeFunctionTable.h>
+#include <physics_toolkit/TransferMatrixCache.h>
 #include <algorithm>
 #include <limits>
 #include <cmath>
@@ -184,25 +186,12 @@ void initdb( sqlite::connection& db )
 // local functions used by find_closed_orbit
 //-------------------------------------------------------------------------------
 
-static Matrix invjacobian ( JetParticle const& jp0, beamline const& bml, Vector v )
+static Matrix invjacobian ( JetParticle const& jp0, beamline const& bml )
 { 
 
-  static MatrixD M = Matrix(6,6);
+  MatrixD M = Matrix(6,6);
 
-  static bool first = true;
-
-  if (!first) return M;
-
-  if (first) first=false;
-
-  static int i_x   = 0; 
-  static int i_y   = 1;
-  static int i_cdt = 2;
-  static int i_npx = 3;
-  static int i_npy = 4;
-  static int i_ndp = 5;
-
-  static int l_[] = { i_x, i_npx, i_y, i_npy, i_cdt, i_ndp };
+  static int const l_[] = { i_x, i_npx, i_y, i_npy, i_cdt, i_ndp };
 
   JetParticle jp = jp0;
 
@@ -243,6 +232,11 @@ static Matrix invjacobian ( JetParticle const& jp0, beamline const& bml, Vector
   
 }
 
+static Matrix constant ( Matrix const& M, Vector const& )
+{ 
+  return M;
+}
+
 static Vector map ( Particle const& p0, beamline const& bml, Vector const& v0 )
 { 
    Particle   p = p0;
@@ -275,21 +269,20 @@ static double norm ( Vector const & v )
 //|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
 
 
-JetParticle find_closed_orbit( sqlite::connection& db, beamline const& bml, JetParticle const& jp )
+JetParticle closed_orbit( beamline const& bml, JetParticle const& jp )
 {
-
-  // TURN RF OFF **** FIXME     
-
-   Jet__environment::pushEnv( jp.state().Env() );
-   JetC__environment::pushEnv( jp.state().Env() );
-
+   //-----------------------------------------------------------------------
+   // The inverse transverse jacobian is computed once, by propagating an 
+   // identity map around the line, and used for every Newton iteration.
+   //-----------------------------------------------------------------------
 
    JetParticle jpco(jp);
 
+   Matrix const M = invjacobian( jpco, bml );
 
    NewtonSolver newton ( boost::bind<Vector>( &map,      Particle(jpco), boost::cref(bml), _1 ),  
                          boost::function<double(Vector const& )>(&norm), 
-                         boost::bind<Matrix>( &invjacobian, jpco,        boost::cref(bml), _1 )  ); 
+                         boost::bind<Matrix>( &constant, M, _1 )  ); 
 
    Vector co = newton( Particle(jpco).state() );
    co[ i_cdt] = 0.0;
@@ -300,6 +293,21 @@ JetParticle find_closed_orbit( sqlite::connection& db, beamline const& bml, JetP
 
    jpco.state()[ i_cdt ].setStandardPart(0.0);
 
+   return jpco;
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+JetParticle find_closed_orbit( sqlite::connection& db, beamline const& bml, JetParticle const& jp )
+{
+
+  // TURN RF OFF **** FIXME     
+
+   Jet__environment::pushEnv( jp.state().Env() );
+   JetC__environment::pushEnv( jp.state().Env() );
+
+   JetParticle jpco = closed_orbit( bml, jp );
 
   /// ***** FIXME: NEED TO SET ENV REF TO that of closed orbit ! 
 
@@ -321,7 +329,19 @@ JetParticle find_closed_orbit( sqlite::connection& db, beamline const& bml, JetP
 //|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
 //|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
 
-void orbit( sqlite::connection& db, beamline const& bml, JetParticle const& jp_arg )
+void orbit( sqlite::connection& db, beamline const& bml, JetParticle const& jp )
+{
+  LatticeFunctionTable lft;
+
+  orbit( lft, bml, jp );
+
+  lft.flush( db );
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+void orbit( LatticeFunctionTable& lft, beamline const& bml, JetParticle const& jp_arg )
 {
   //------------------------------------
   // propagate particle and store orbit
@@ -332,48 +352,12 @@ void orbit( sqlite::connection& db, beamline const& bml, JetParticle const& jp_a
   JetParticle jp(p,jp_arg.state().Env());
   jp.cdt(0.0);
 
-  std::ostringstream sql;
+  LatticeFunctionTable::Table& elements = lft.define( "ELEMENTS",        "object:INTEGER name:TEXT type:TEXT length strength" );
+  LatticeFunctionTable::Table& corbit   = lft.define( "REFERENCE_ORBIT", "arclength xco yco beta gamma" );
 
-  sql << "DROP TABLE IF EXISTS REFERENCE_ORBIT" <<std::ends; 
-  sqlite::execute(db, sql.str(),true );
-
-  sql.str("");
-  sql << "DROP TABLE IF EXISTS ELEMENTS" <<std::ends; 
-  sqlite::execute(db, sql.str(),true );
-
-  sql.str("");
-  sql << "CREATE TABLE " 
-      << "REFERENCE_ORBIT "
-      << "( iseq INTEGER PRIMARY KEY, arclength REAL, xco REAL,  yco REAL, beta REAL, gamma REAL )"
-      << std::ends;
-
-  sqlite::execute(db, sql.str(),true );
-
-  sql.str("");
-  sql << "CREATE TABLE " 
-      << "ELEMENTS "
-      << "( iseq INTEGER PRIMARY KEY, object INTEGER UNIQUE, name TEXT, type TEXT, length REAL, strength REAL )"
-      << std::ends;
-
-  sqlite::execute(db, sql.str(),true );
-
-  sql.str("");
-  sql << "INSERT INTO REFERENCE_ORBIT "  
-      << " ( iseq, arclength, xco, yco, beta, gamma )  VALUES (?, ?, ?, ?, ?, ?)" << std::ends;
+  elements.reserve( bml.countHowManyDeeply() );
+  corbit.reserve  ( bml.countHowManyDeeply() );
 
-  sqlite::command cmd_corbit(db, sql.str());
-
-
-  sql.str("");
-  sql << "INSERT INTO ELEMENTS "  
-      << " ( iseq, object, name, type, length, strength )  VALUES (?, ?, ?, ?, ?, ? )" << std::ends;
-
-  sqlite::command cmd_elements(db, sql.str());
-
-
-  sqlite::execute(db, "BEGIN TRANSACTION", true);
-
-  int iseq    = -1;
   double  lng = 0.0;
   for ( beamline::const_deep_iterator it  = bml.deep_begin();  
                                       it != bml.deep_end(); ++it ) {
@@ -382,17 +366,10 @@ void orbit( sqlite::connection& db, beamline const& bml, JetParticle const& jp_a
      
       lng += (*it)->OrbitLength( p );
 
-      cmd_elements.clear();
-      cmd_elements % ++iseq % (int64_t) &(*it) % (*it)->Name() % (*it)->Type() % (*it)->Length() % (*it)->Strength();
-      cmd_elements();
-
-      cmd_corbit.clear();
-      cmd_corbit     %  iseq %  lng % p.x() %  p.y()  % p.beta() % p.gamma();  
-      cmd_corbit();
+      elements << (boost::int64_t) &(*it) << (*it)->Name() << (*it)->Type() << (*it)->Length() << (*it)->Strength();
+      corbit   << lng << p.x() << p.y() << p.beta() << p.gamma();  
   };
 
-  sqlite::execute(db, "COMMIT TRANSACTION", true);
-  
   //-------------------------------------------------------------------------------------------------
   // verify that the orbit is indeed a closed one.
   //------------------------------------------------------------------------------------------------- 
@@ -403,7 +380,7 @@ void orbit( sqlite::connection& db, beamline const& bml, JetParticle const& jp_a
 //|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
 //|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
 
-Vector tunes( sqlite::connection& db, JetParticle const& oneturnjp)
+Vector tunes( JetParticle const& oneturnjp)
 {
 
   MatrixD mtrx = oneturnjp.state().jacobian();
@@ -462,6 +439,16 @@ Vector tunes( sqlite::connection& db, JetParticle const& oneturnjp)
      if (  tunes[i] < 0.0  ) { tunes[i]  += 1.0; }  
    }
 
+   return tunes;  
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+Vector tunes( sqlite::connection& db, JetParticle const& oneturnjp)
+{
+   Vector tunes = Optics::tunes( oneturnjp );
+
    std::stringstream sql;
    sql.str("");
    sql << "UPDATE PROPERTIES SET " 
@@ -519,7 +506,21 @@ Vector periodicDispersion( sqlite::connection& db, JetParticle const& jp_arg )
 //||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
 //||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
 
-int propagateDispersion( sqlite::connection& db, beamline const& bml, JetParticle const& arg_jp,  Vector const& eta0,  bool dppconstant)
+int propagateDispersion( sqlite::connection& db, beamline const& bml, JetParticle const& jp,  Vector const& eta0,  bool dppconstant)
+{
+  LatticeFunctionTable lft;
+
+  int ret = propagateDispersion( lft, bml, jp, eta0, dppconstant );
+
+  lft.flush( db );
+
+  return ret;
+}
+
+//||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+int propagateDispersion( LatticeFunctionTable& lft, beamline const& bml, JetParticle const& arg_jp,  Vector const& eta0,  bool dppconstant)
 {
 
   //--------------------------------------------------------------------
@@ -562,29 +563,10 @@ int propagateDispersion( sqlite::connection& db, beamline const& bml, JetParticl
 
   const double start_momentum = jp.refMomentum();
 
-  std::ostringstream sql;
-
-  sql << "DROP TABLE IF EXISTS DISPERSION" << std::ends;
-  sqlite::execute(db, sql.str(),true );
-
-  sql.str("");
-  sql << "CREATE TABLE DISPERSION "
-      << "( iseq INTEGER PRIMARY KEY, "
-      << "etax REAL,  etapx REAL,  etay REAL,  etapy REAL )"
-      << std::ends;
-
-  sqlite::execute(db, sql.str(),true );
-
-  sql.str("");
-  sql << "INSERT INTO DISPERSION "  
-      << " ( iseq, etax, etapx, etay,  etapy )  VALUES (?, ?, ?, ?, ? )" 
-      << std::ends;
+  LatticeFunctionTable::Table& dispersion = lft.define( "DISPERSION", "etax etapx etay etapy" );
 
-  sqlite::command cmd_dispersion(db, sql.str());
+  dispersion.reserve( bml.countHowManyDeeply() );
 
-  sqlite::execute(db, "BEGIN TRANSACTION", true);
-
-  int iseq = -1;
 
   for ( beamline::const_deep_iterator it  = bml.deep_begin();  
                                       it != bml.deep_end(); ++it ) {
@@ -595,15 +577,12 @@ int propagateDispersion( sqlite::connection& db, beamline const& bml, JetParticl
       (*it)->propagate(jp);
      
 
-      cmd_dispersion.clear();
-
-
       if (dppconstant) { 
           
-         cmd_dispersion % ++iseq  % ( state[i_x  ].weightedDerivative( exp_d ) ) 
-	                          % ( state[i_npx].weightedDerivative( exp_d ) )
-		                  % ( state[i_y  ].weightedDerivative( exp_d ) )
-                                  % ( state[i_npy].weightedDerivative( exp_d ) );
+         dispersion << ( state[i_x  ].weightedDerivative( exp_d ) ) 
+	            << ( state[i_npx].weightedDerivative( exp_d ) )
+		    << ( state[i_y  ].weightedDerivative( exp_d ) )
+                    << ( state[i_npy].weightedDerivative( exp_d ) );
 
           // keep dp/p constant ...
 
@@ -615,18 +594,13 @@ int propagateDispersion( sqlite::connection& db, beamline const& bml, JetParticl
 
  	 double scale = ( 1.0 / state[i_ndp].weightedDerivative( exp_d ));
 
-         cmd_dispersion % ++iseq  % ( scale*state[i_x  ].weightedDerivative( exp_d ) ) 
-	                          % ( scale*state[i_npx].weightedDerivative( exp_d ) )
-		                  % ( scale*state[i_y  ].weightedDerivative( exp_d ) )
-                                  % ( scale*state[i_npy].weightedDerivative( exp_d ) );
+         dispersion << ( scale*state[i_x  ].weightedDerivative( exp_d ) ) 
+	            << ( scale*state[i_npx].weightedDerivative( exp_d ) )
+		    << ( scale*state[i_y  ].weightedDerivative( exp_d ) )
+                    << ( scale*state[i_npy].weightedDerivative( exp_d ) );
       }
-      
-      cmd_dispersion();
- 
   }
 
-  sqlite::execute(db, "COMMIT TRANSACTION", true);
-  
   return ret;
 }
 
@@ -634,47 +608,88 @@ int propagateDispersion( sqlite::connection& db, beamline const& bml, JetParticl
 //|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
 //|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
 
-Vector chromaticity( sqlite::connection& db, beamline const& bml, JetParticle const& oneturnjp, Vector const& eta )
+//-------------------------------------------------------------------------------
+// local functions used by chromaticity
+//-------------------------------------------------------------------------------
+
+static double const chromaticity_dpp = 0.001;
+
+static Particle offMomentumParticle( JetParticle const& oneturnjp, Vector const& eta )
 {
-   
-  double const dpp = 0.001;
+  // eta is ordered as the phase space coordinates ( see periodicDispersion() )
 
-  Matrix oneturnmtrx = oneturnjp.state().jacobian();
+  double const dpp = chromaticity_dpp;
 
   Particle p_off(oneturnjp);
 
   Vector& state = p_off.state(); 
   
-  state[i_x  ] += eta[0]* dpp; 
-  state[i_npx] += eta[1]* dpp; 
-  state[i_y  ] += eta[2]* dpp; 
-  state[i_npy] += eta[3]* dpp; 
+  state[i_x  ] += eta[i_x  ]* dpp; 
+  state[i_npx] += eta[i_npx]* dpp; 
+  state[i_y  ] += eta[i_y  ]* dpp; 
+  state[i_npy] += eta[i_npy]* dpp; 
 
   state[i_cdt]  = 0.0;
   state[i_ndp] += dpp; 
 
-  JetParticle jp_off( p_off); 
-
-  bml.propagate(jp_off);
+  return p_off;
+}
 
-  MatrixD oneturnmtrx_off  = jp_off.state().jacobian();
+static Vector chromaticity( sqlite::connection& db, JetParticle const& oneturnjp, JetParticle const& oneturnjp_off )
+{
+  // the off-momentum tunes are computed first, so that the database is left with the on-momentum ones.
 
-  Vector nu     = Optics::tunes( db, oneturnjp );
-  Vector nu_off = Optics::tunes( db, jp_off    );
+  Vector nu_off = Optics::tunes( db, oneturnjp_off );
+  Vector nu     = Optics::tunes( db, oneturnjp     );
 
   Vector chroma(2); 
-  chroma[0]  = ( nu_off[0] - nu[0] ) / dpp;
-  chroma[1]  = ( nu_off[1] - nu[1] ) / dpp;
-
+  chroma[0]  = ( nu_off[0] - nu[0] ) / chromaticity_dpp;
+  chroma[1]  = ( nu_off[1] - nu[1] ) / chromaticity_dpp;
 
   return chroma;
 }
 
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+Vector chromaticity( sqlite::connection& db, beamline const& bml, JetParticle const& oneturnjp, Vector const& eta )
+{
+  JetParticle jp_off( offMomentumParticle( oneturnjp, eta ) ); 
+
+  bml.propagate(jp_off);
+
+  return chromaticity( db, oneturnjp, jp_off );
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+Vector chromaticity( sqlite::connection& db, TransferMatrixCache& offmomentum, beamline const& bml, JetParticle const& oneturnjp, Vector const& eta )
+{
+  offmomentum.update( bml, offMomentumParticle( oneturnjp, eta ) );
+
+  return chromaticity( db, oneturnjp, offmomentum.oneTurnJetParticle() );
+}
+
 
 //||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
 //||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
 
-int propagateCourantSnyder2D( sqlite::connection& db, beamline const& bml, JetParticle const& jparg, CSLattFuncs const& initialConditions )
+int propagateCourantSnyder2D( sqlite::connection& db, beamline const& bml, JetParticle const& jp, CSLattFuncs const& initialConditions )
+{
+  LatticeFunctionTable lft;
+
+  int ret = propagateCourantSnyder2D( lft, bml, jp, initialConditions );
+
+  lft.flush( db );
+
+  return ret;
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+int propagateCourantSnyder2D( LatticeFunctionTable& lft, beamline const& bml, JetParticle const& jparg, CSLattFuncs const& initialConditions )
 {
   
   int ret = 0;
@@ -715,47 +730,12 @@ int propagateCourantSnyder2D( sqlite::connection& db, beamline const& bml, JetPa
 
   double const momentum = jp.refMomentum();
 
-  std::ostringstream sql;
+  LatticeFunctionTable::Table& dispersion = lft.define( "DISPERSION",     "etax etapx etay etapy" );
+  LatticeFunctionTable::Table& cs         = lft.define( "COURANT_SNYDER", "betax alphax psix betay alphay psiy" );
 
-  sql.str("");
-  sql << "DROP TABLE IF EXISTS DISPERSION" << std::ends;
-  sqlite::execute(db, sql.str(),true );
+  dispersion.reserve( bml.countHowManyDeeply() );
+  cs.reserve        ( bml.countHowManyDeeply() );
 
-  sql.str("");
-  sql << "CREATE TABLE DISPERSION "
-      << "( iseq INTEGER PRIMARY KEY, "
-      << "etax REAL,  etapx REAL,  etay REAL,  etapy REAL )"
-      << std::ends;
-
-  sqlite::execute(db, sql.str(),true );
-
-  sql.str("");
-  sql << "DROP TABLE IF EXISTS COURANT_SNYDER" << std::ends;
-  sqlite::execute(db, sql.str(),true );
-
-  sql.str("");
-  sql << "CREATE TABLE " 
-      << "COURANT_SNYDER"
-      << "( iseq INTEGER PRIMARY KEY, betax REAL, alphax REAL, psix REAL, betay REAL, alphay REAL, psiy REAL  )" 
-      << ends;
-  sqlite::execute(db, sql.str(),true );
-
-  sql.str("");
-  sql << "INSERT INTO DISPERSION "  
-      << " ( iseq, etax, etapx, etay,  etapy )  VALUES (?, ?, ?, ?, ? )" 
-      << std::ends;
-  sqlite::command cmd_insert_disp(db, sql.str());
-
-  sql.str("");
-  sql << "INSERT INTO COURANT_SNYDER "  
-      << " ( iseq, betax, alphax, psix,  betay, alphay, psiy)  VALUES ( ?, ?, ?, ?, ?, ?, ? )" << ends;
-  
-  sqlite::command cmd_insert_cs(db, sql.str());
-
-
-  sqlite::execute(db, "BEGIN TRANSACTION", true);
-
-  int iseq = -1;
 
   double mux    = 0.0;
   double muy    = 0.0;
@@ -821,19 +801,11 @@ int propagateCourantSnyder2D( sqlite::connection& db, beamline const& bml, JetPa
     psix0 =   psix;
     psiy0 =   psiy;
 
-    cmd_insert_cs.clear(); 
-    cmd_insert_cs % ++iseq % betax % alphax % mux % betay % alphay % muy; 
-    cmd_insert_cs(); 
-
-    cmd_insert_disp.clear(); 
-    cmd_insert_disp % iseq % eta[i_x] % eta[i_npx] % eta[i_y] % eta[i_npy]; 
-    cmd_insert_disp();
-
+    cs         << betax << alphax << mux << betay << alphay << muy; 
+    dispersion << eta[i_x] << eta[i_npx] << eta[i_y] << eta[i_npy]; 
 
   } // end loop over the beamline elements ..............
 
-  sqlite::execute(db, "COMMIT", true);
-
 
   // restore env before exiting ... 
   
@@ -907,7 +879,11 @@ CSLattFuncs periodicCourantSnyder2D(  sqlite::connection& db, JetParticle const&
 //|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
 //|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
 
-MatrixC periodicEigenVectors( sqlite::connection& db, JetParticle const& oneturnjp )
+//-------------------------------------------------------------------------------
+// local function used by periodicEigenVectors and propagateCourantSnyder4D
+//-------------------------------------------------------------------------------
+
+static MatrixC normalizedEigenVectors( JetParticle const& oneturnjp )
 {
 
   MatrixD mtrx = oneturnjp.state().jacobian();
@@ -933,68 +909,51 @@ MatrixC periodicEigenVectors( sqlite::connection& db, JetParticle const& oneturn
 //|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
 //|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
 
+MatrixC periodicEigenVectors( sqlite::connection& db, JetParticle const& oneturnjp )
+{
+  return normalizedEigenVectors( oneturnjp );
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
 void propagateEigenVectors( sqlite::connection& db, beamline const& bml, JetParticle const& jp, TMatrix<std::complex<double> >const& EV0, TVector<double> const& eta0)
 {
-  std::cerr << "propagateEigenVectors" << std::endl;
-  std::cerr << EV0 << std::endl;
- 
-  std::ostringstream sql;
+  LatticeFunctionTable lft;
 
-  sql.str("");
-  sql << "DROP TABLE IF EXISTS EIGENVECTORS" << std::ends; 
-  sqlite::execute(db, sql.str(),true );
+  propagateEigenVectors( lft, bml, jp, EV0, eta0 );
 
-  sql.str("");
-  sql << "CREATE TABLE " 
-      << "EIGENVECTORS"
-      << "( iseq INTEGER, component INTEGER,  e0_real REAL,   e0_imag REAL,  e1_real REAL,  e1_imag REAL,  e2_real REAL,   e2_imag REAL, "
-      <<                                    " e3_real REAL,   e3_imag REAL,  e4_real REAL,  e4_imag REAL,  e5_real REAL,   e5_imag REAL  )"
-      << ends;
-  sqlite::execute(db, sql.str(),true );
+  lft.flush( db );
+
+  std::ostringstream sql;
 
-  sql.str("");
   sql << " CREATE  UNIQUE INDEX idx ON EIGENVECTORS ( iseq, component )"
       << std::ends;
   sqlite::execute(db, sql.str(),true );
+}
 
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
 
-  sql.str("");
-  sql << "INSERT INTO EIGENVECTORS "  
-     << "( iseq,  component,  e0_real,   e0_imag,   e1_real,   e1_imag,  e2_real,  e2_imag, "
-     <<                    "  e3_real,   e3_imag,   e4_real,   e4_imag,  e5_real,  e5_imag  )"
-      << " VALUES (?,?, ?,?, ?,?, ?,?, ?,?, ?,?, ?,? )"
-      << ends;
-  sqlite::command cmd_insert_vectors(db, sql.str());
-  
+void propagateEigenVectors( LatticeFunctionTable& lft, beamline const& bml, JetParticle const& jp, TMatrix<std::complex<double> >const& EV0, TVector<double> const& eta0)
+{
+  std::cerr << "propagateEigenVectors" << std::endl;
+  std::cerr << EV0 << std::endl;
  
-  sql.str("");
-  sql << "DROP TABLE IF EXISTS DISPERSION" << std::ends;
-  sqlite::execute(db, sql.str(),true );
-
-  sql.str("");
-  sql << "CREATE TABLE DISPERSION "
-      << "( iseq INTEGER PRIMARY KEY, "
-      << "etax REAL,  etapx REAL,  etay REAL,  etapy REAL )"
-      << std::ends;
+  LatticeFunctionTable::Table& vectors    = lft.define( "EIGENVECTORS", 
+                                                        "iseq:INTEGER component:INTEGER e0_real e0_imag e1_real e1_imag e2_real e2_imag "
+                                                        "                               e3_real e3_imag e4_real e4_imag e5_real e5_imag", false );
 
-  sqlite::execute(db, sql.str(),true );
+  LatticeFunctionTable::Table& dispersion = lft.define( "DISPERSION", "etax etapx etay etapy" );
 
-  sql.str("");
-  sql << "INSERT INTO DISPERSION "  
-      << " ( iseq, etax, etapx, etay,  etapy )  VALUES (?, ?, ?, ?, ? )" 
-      << std::ends;
-  sqlite::command cmd_insert_disp(db, sql.str());
+  vectors.reserve   ( 6*bml.countHowManyDeeply() );
+  dispersion.reserve(   bml.countHowManyDeeply() );
 
-  sqlite::execute(db, "BEGIN TRANSACTION", true);
-  
   Particle    p(jp);
   JetParticle jpart(p); // mapping reset to identity.
 
   int iseq = -1;
 
-  double mu1 = 0.0;  // normalize integrated phase advances
-  double mu2 = 0.0; 
-  
   double const momentum = jpart.refMomentum();
  
   for (beamline::const_deep_iterator it  =  bml.deep_begin(); 
@@ -1012,38 +971,22 @@ void propagateEigenVectors( sqlite::connection& db, beamline const& bml, JetPart
 
     double const scale = jpart.refMomentum()/momentum;
 
+    dispersion << eta[i_x] << eta[i_npx] << eta[i_y] << eta[i_npy]; 
 
-    // --------------------------------------------------------
-    // commit the dispersion to the database
-    //---------------------------------------------------------
-
-    cmd_insert_disp.clear(); 
-    cmd_insert_disp % ++iseq % eta[i_x] % eta[i_npx] % eta[i_y] % eta[i_npy]; 
-    cmd_insert_disp();
-
-
-    // --------------------------------------------------------
-    // commit the eigenvectors to the database
-    //---------------------------------------------------------
-
+    ++iseq;
 
     for (int i=0 ; i<6;  ++i ) {
 
-        cmd_insert_vectors.clear();
-        cmd_insert_vectors % iseq % i;
+        vectors << iseq << i;
 
         for (int j=0 ; j<6; ++j ) { 
 	  std::complex<double> value =  EN[i][j]*sqrt(scale);
-          cmd_insert_vectors % ( value.real()) % ( value.imag() );
+          vectors << value.real() << value.imag();
         }
- 
-      cmd_insert_vectors();
     }
 
   } // for
 
-  sqlite::execute(db, "COMMIT TRANSACTION", true);
-
 }
 
 //|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
@@ -1415,7 +1358,31 @@ CSLattFuncs4D periodicCourantSnyder4D( sqlite::connection& db, JetParticle const
 
 int  propagateCourantSnyder4D( sqlite::connection& db, beamline const& bml, JetParticle const& jp, CSLattFuncs4D const& initial )
 {
+  LatticeFunctionTable lft;
+
+  int ret = propagateCourantSnyder4D( lft, bml, jp, initial );
+
+  lft.flush( db );
+
+  std::ostringstream sql;
 
+  sql << " CREATE  UNIQUE INDEX idx ON EIGENVECTORS ( iseq, component )"
+      << std::ends;
+  sqlite::execute(db, sql.str(),true );
+
+  return ret;
+}
+
+//||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+//-------------------------------------------------------------------------------
+// local function used by propagateCourantSnyder4D: computes the 4D lattice
+// functions from the EIGENVECTORS table of lft.
+//-------------------------------------------------------------------------------
+
+static void courantSnyder4DFromEigenVectors( LatticeFunctionTable& lft )
+{
 
 //-------------------------------------------------------------------------
 // 
@@ -1440,87 +1407,38 @@ int  propagateCourantSnyder4D( sqlite::connection& db, beamline const& bml, JetP
 //     The eigenvalue with negative imaginary part is _first_.
 //       
 //------------------------------------------------------------------------------
- 
-  std::cerr << initial.mode1.beta.hor  << std::endl; 
-  std::cerr << initial.mode1.alpha.hor << std::endl;
-  std::cerr << initial.mode1.beta.ver  << std::endl; 
-  std::cerr << initial.mode1.alpha.ver << std::endl;
 
-  std::cerr << initial.mode2.beta.hor  << std::endl; 
-  std::cerr << initial.mode2.alpha.hor << std::endl;
-  std::cerr << initial.mode2.beta.ver  << std::endl; 
-  std::cerr << initial.mode2.alpha.ver << std::endl;
-
-  // MatrixC EV0 = courantSnyder4DtoEV(initial); FIXME !!!!!
+  LatticeFunctionTable::Table& cs = lft.define( "COURANT_SNYDER_4D", "beta1x alpha1x beta1y alpha1y psi1 "
+                                                                     "beta2x alpha2x beta2y alpha2y psi2" ); 
 
-  MatrixC EV0 = periodicEigenVectors( db, const_cast<JetParticle &>(jp) );
+  LatticeFunctionTable::Table const& vectors = lft["EIGENVECTORS"];
 
-  std::cout <<  EV0 << std::endl;
-
-  propagateEigenVectors( db, bml, jp, EV0, initial.dispersion.eta );
-
-
-  std::ostringstream sql;
-
-  sql << "DROP TABLE IF EXISTS COURANT_SNYDER_4D" << std::ends; 
-  sqlite::execute(db, sql.str(),true );
-
-  sql.str("");
-  sql << "CREATE TABLE " 
-      << "COURANT_SNYDER_4D"
-      << " ( iseq INTEGER PRIMARY KEY, beta1x REAL,    alpha1x REAL,   beta1y     REAL, alpha1y    REAL,   psi1 REAL,"
-      <<                              "beta2x REAL,    alpha2x REAL,   beta2y     REAL, alpha2y    REAL,   psi2 REAL )"
-      << ends;
-
-  sqlite::execute(db, sql.str(),true );
-
-
-  sql.str("");
-  sql << "INSERT INTO COURANT_SNYDER_4D"  
-      << "( iseq, beta1x, alpha1x, beta1y, alpha1y, psi1, "
-      <<         "beta2x, alpha2x, beta2y, alpha2y, psi2 )"
-      << " VALUES (?, ?,?,?,?,?, ?,?,?,?,? )"  
-      << ends;
-  sqlite::command cmd_insert(db, sql.str());
-
-
-  sql.str("");
-  sql << "SELECT * FROM EIGENVECTORS " << std::ends;
-
-  sqlite::query q(db,sql.str() ); 
-  sqlite::result_type res = q.emit_result();
+  std::vector<boost::int64_t> const& component = vectors.integerColumn("component");
+  std::vector<double>         const& e0_real   = vectors.column("e0_real");
+  std::vector<double>         const& e0_imag   = vectors.column("e0_imag");
+  std::vector<double>         const& e1_real   = vectors.column("e1_real");
+  std::vector<double>         const& e1_imag   = vectors.column("e1_imag");
 
+  cs.reserve( vectors.numRows()/6 );
 
   TVector<std::complex<double> > ev1(6);
   TVector<std::complex<double> > ev2(6);
 
-  int iseq = 0;
   double fmu10 = 0.0, fmu20 = 0.0;
 
   double fmu1_adv = 0.0;  // cumulative phase advances
   double fmu2_adv = 0.0; 
   
-  sqlite::execute(db, "BEGIN TRANSACTION", true);
-
-  bool done = false;
   bool first_record = true;
 
-  if (res) { 
+  for ( int row = 0; row+6 <= vectors.numRows(); row += 6 ) { 
 
-    do { 
-      
-      int i=0; 
- 
-      for ( int k=0; k<6; ++k ) {
+      for ( int k=row; k<row+6; ++k ) {
 
-        iseq     = res->get_int(0);
-            i    = res->get_int(1);
-
-        ev1[i] = std::complex<double>( res->get_double(2),  res->get_double(3) );
-        ev2[i] = std::complex<double>( res->get_double(4),  res->get_double(5) );
-        
-        done = !res->next_row();
+        int const i = component[k];
 
+        ev1[i] = std::complex<double>( e0_real[k],  e0_imag[k] );
+        ev2[i] = std::complex<double>( e1_real[k],  e1_imag[k] );
       }
  
       //--------------------
@@ -1604,19 +1522,54 @@ int  propagateCourantSnyder4D( sqlite::connection& db, beamline const& bml, JetP
     fmu10 = fmu1;
     fmu20 = fmu2;
  
-    cmd_insert.clear();
+    cs << beta_1x << alpha_1x << beta_1y << alpha_1y <<  fmu1_adv 
+       << beta_2x << alpha_2x << beta_2y << alpha_2y <<  fmu2_adv; 
 
-    cmd_insert % iseq % beta_1x % alpha_1x % beta_1y % alpha_1y %  fmu1_adv 
-                      % beta_2x % alpha_2x % beta_2y % alpha_2y %  fmu2_adv; 
- 
-    
-    cmd_insert();
+  }
+}
 
-    } while ( !done );
+//||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
 
-  }
+int  propagateCourantSnyder4D( LatticeFunctionTable& lft, beamline const& bml, JetParticle const& jp, CSLattFuncs4D const& initial )
+{
+  std::cerr << initial.mode1.beta.hor  << std::endl; 
+  std::cerr << initial.mode1.alpha.hor << std::endl;
+  std::cerr << initial.mode1.beta.ver  << std::endl; 
+  std::cerr << initial.mode1.alpha.ver << std::endl;
 
-  sqlite::execute(db, "COMMIT", true);
+  std::cerr << initial.mode2.beta.hor  << std::endl; 
+  std::cerr << initial.mode2.alpha.hor << std::endl;
+  std::cerr << initial.mode2.beta.ver  << std::endl; 
+  std::cerr << initial.mode2.alpha.ver << std::endl;
+
+  // MatrixC EV0 = courantSnyder4DtoEV(initial); FIXME !!!!!
+
+  MatrixC EV0 = normalizedEigenVectors( jp );
+
+  std::cout <<  EV0 << std::endl;
+
+  propagateEigenVectors( lft, bml, jp, EV0, initial.dispersion.eta );
+
+  courantSnyder4DFromEigenVectors( lft );
+
+  return 0;
+}
+
+//||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+int  propagateCourantSnyder4D( LatticeFunctionTable& lft, TransferMatrixCache const& matrices, JetParticle const& jp, CSLattFuncs4D const& initial )
+{
+  // matrices is up to date with the line, for the reference particle of jp.
+
+  MatrixC EV0 = normalizedEigenVectors( jp );
+
+  matrices.propagateEigenVectors( lft, EV0, initial.dispersion.eta );
+
+  courantSnyder4DFromEigenVectors( lft );
+
+  return 0;
 }
 
 //||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
@@ -2122,4 +2075,169 @@ std::vector<double> etap_y ( std::string const& dbname)
 
 
 
+//------------------------------------------------------------------------------
+// LatticeFunctionTable getters: the columns are returned by reference.
+//------------------------------------------------------------------------------
+
+std::vector<double> const& arclength( LatticeFunctionTable const& lft )
+{
+  return lft.column( "REFERENCE_ORBIT", "arclength" );
+}
+
+//||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+std::vector<double> const& gamma( LatticeFunctionTable const& lft )
+{
+  return lft.column( "REFERENCE_ORBIT", "gamma" );
+}
+
+//||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+std::vector<double> const& beta_x( LatticeFunctionTable const& lft )
+{
+  return lft.column( "COURANT_SNYDER", "betax" );
+}
+
+//||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+std::vector<double> const& beta_y( LatticeFunctionTable const& lft )
+{
+  return lft.column( "COURANT_SNYDER", "betay" );
+}
+
+//||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+std::vector<double> const& alpha_x( LatticeFunctionTable const& lft )
+{
+  return lft.column( "COURANT_SNYDER", "alphax" );
+}
+
+//||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+std::vector<double> const& alpha_y( LatticeFunctionTable const& lft )
+{
+  return lft.column( "COURANT_SNYDER", "alphay" );
+}
+
+//||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+std::vector<double> const& psi_x( LatticeFunctionTable const& lft )
+{
+  return lft.column( "COURANT_SNYDER", "psix" );
+}
+
+//||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+std::vector<double> const& psi_y( LatticeFunctionTable const& lft )
+{
+  return lft.column( "COURANT_SNYDER", "psiy" );
+}
+
+//||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+std::vector<double> const& beta_1x( LatticeFunctionTable const& lft )
+{
+  return lft.column( "COURANT_SNYDER_4D", "beta1x" );
+}
+
+//||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+std::vector<double> const& beta_1y( LatticeFunctionTable const& lft )
+{
+  return lft.column( "COURANT_SNYDER_4D", "beta1y" );
+}
+
+//||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+std::vector<double> const& alpha_1x( LatticeFunctionTable const& lft )
+{
+  return lft.column( "COURANT_SNYDER_4D", "alpha1x" );
+}
+
+//||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+std::vector<double> const& alpha_1y( LatticeFunctionTable const& lft )
+{
+  return lft.column( "COURANT_SNYDER_4D", "alpha1y" );
+}
+
+//||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+std::vector<double> const& beta_2x( LatticeFunctionTable const& lft )
+{
+  return lft.column( "COURANT_SNYDER_4D", "beta2x" );
+}
+
+//||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+std::vector<double> const& beta_2y( LatticeFunctionTable const& lft )
+{
+  return lft.column( "COURANT_SNYDER_4D", "beta2y" );
+}
+
+//||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+std::vector<double> const& alpha_2x( LatticeFunctionTable const& lft )
+{
+  return lft.column( "COURANT_SNYDER_4D", "alpha2x" );
+}
+
+//||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+std::vector<double> const& alpha_2y( LatticeFunctionTable const& lft )
+{
+  return lft.column( "COURANT_SNYDER_4D", "alpha2y" );
+}
+
+//||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+std::vector<double> const& eta_x( LatticeFunctionTable const& lft )
+{
+  return lft.column( "DISPERSION", "etax" );
+}
+
+//||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+std::vector<double> const& eta_y( LatticeFunctionTable const& lft )
+{
+  return lft.column( "DISPERSION", "etay" );
+}
+
+//||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+std::vector<double> const& etap_x( LatticeFunctionTable const& lft )
+{
+  return lft.column( "DISPERSION", "etapx" );
+}
+
+//||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+std::vector<double> const& etap_y( LatticeFunctionTable const& lft )
+{
+  return lft.column( "DISPERSION", "etapy" );
+}
+
+//||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+
 } // namespace Optics
@@ -0,0 +1,177 @@
+/*************************************************************************
+**************************************************************************
+**************************************************************************
+******
+******  PHYSICS TOOLKIT: Library of utilites and Sage classes
+******             which facilitate calculations with the
+******             BEAMLINE class library.
+******
+******  File:      TrackingDriver.cc
+******
+******  Copyright (c) Fermi Research Alliance LLC
+******                All Rights Reserved
+******
+******  Usage, modification, and redistribution are subject to terms
+******  of the License supplied with this software.
+******
+******  Software and documentation created under
+******  U.S. Department of Energy Contract No. DE-AC02-07CH11359.
+******  The U.S. Government retains a world-wide non-exclusive,
+******  royalty-free license to publish or reproduce documentation
+******  and software for U.S. Government purposes. This software
+******  is protected under the U.S. and Foreign Copyright Laws.
+******
+******  Revision History
+******
+******  Oct 2026
+******
+******  - Initial version.
+******
+**************************************************************************
+*************************************************************************/
+
+#include <physics_toolkit/TrackingDriver.h>
+#include <physics_toolkit/TurnByTurnFile.h>
+#include <basic_toolkit/GenericException.h>
+#include <beamline/beamline.h>
+#include <beamline/Particle.h>
+#include <beamline/ParticleBunch.h>
+#include <beamline/TBunch.h>
+#include <beamline/BunchArrays.h>
+
+#include <memory>
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+TrackingDriver::TrackingDriver( beamline const& ring )
+  : elements_(), observed_(), segments_(), names_(), azimuths_()
+{
+  std::auto_ptr<beamline> copy( ring.clone() );
+
+  beamline const flat = copy->flatten();
+
+  for ( beamline::const_iterator it = flat.begin(); it != flat.end(); ++it ) {
+    elements_.push_back( *it );
+  }
+
+  observed_.assign( elements_.size(), false );
+
+  segment();
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+TrackingDriver::~TrackingDriver()
+{}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+int TrackingDriver::observe( Criterion const& criterion )
+{
+  int count = 0;
+
+  for ( unsigned int k=0; k<elements_.size(); ++k ) {
+    if ( !observed_[k] && criterion( *elements_[k] ) ) {
+      observed_[k] = true;
+      ++count;
+    }
+  }
+
+  segment();
+
+  return count;
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+void TrackingDriver::clearObservationPoints()
+{
+  observed_.assign( elements_.size(), false );
+  segment();
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+void TrackingDriver::segment()
+{
+  segments_.clear();
+  names_.clear();
+  azimuths_.clear();
+
+  double s = 0.0;
+
+  BmlPtr current( new beamline( "SEGMENT" ) );
+
+  for ( unsigned int k=0; k<elements_.size(); ++k ) {
+
+    current->append( elements_[k] );
+    s += elements_[k]->Length();
+
+    if ( observed_[k] ) {
+      segments_.push_back( current );
+      names_.push_back( elements_[k]->Name() );
+      azimuths_.push_back( s );
+      current = BmlPtr( new beamline( "SEGMENT" ) );
+    }
+  }
+
+  segments_.push_back( current );
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+template <typename particle_t>
+int TrackingDriver::trackTurns( particle_t& p, int nturns, TurnByTurnWriter& out ) const
+{
+  if ( out.numObservationPoints() != numObservationPoints() ) {
+    throw GenericException( __FILE__, __LINE__,
+          "int TrackingDriver::trackTurns( particle_t& p, int nturns, TurnByTurnWriter& out ) const",
+          "The writer does not have the same number of observation points as the driver." );
+  }
+
+  int const npoints = numObservationPoints();
+
+  for ( int turn=0; turn<nturns; ++turn ) {
+
+    for ( int k=0; k<npoints; ++k ) {
+      segments_[k]->propagate( p );
+      out.record( k, p );
+    }
+
+    segments_[npoints]->propagate( p );
+
+    out.endTurn();
+  }
+
+  return out.numTurns();
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+int TrackingDriver::track( Particle& p, int nturns, TurnByTurnWriter& out ) const
+{
+  return trackTurns( p, nturns, out );
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+int TrackingDriver::track( ParticleBunch& b, int nturns, TurnByTurnWriter& out ) const
+{
+  return trackTurns( b, nturns, out );
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+int TrackingDriver::track( BunchArrays& b, int nturns, TurnByTurnWriter& out ) const
+{
+  return trackTurns( b, nturns, out );
+}
@@ -0,0 +1,517 @@
+/*************************************************************************
+**************************************************************************
+**************************************************************************
+******
+******  PHYSICS TOOLKIT: Library of utilites and Sage classes
+******             which facilitate calculations with the
+******             BEAMLINE class library.
+******
+******  File:      TransferMatrixCache.cc
+******
+******  Copyright (c) Fermi Research Alliance LLC
+******                All Rights Reserved
+******
+******  Usage, modification, and redistribution are subject to terms
+******  of the License supplied with this software.
+******
+******  Software and documentation created under
+******  U.S. Department of Energy Contract No. DE-AC02-07CH11359.
+******  The U.S. Government retains a world-wide non-exclusive,
+******  royalty-free license to publish or reproduce documentation
+******  and software for U.S. Government purposes. This software
+******  is protected under the U.S. and Foreign Copyright Laws.
+******
+******  Revision History
+******
+******  Oct 2026
+******
+******  - Initial version.
+******
+**************************************************************************
+*************************************************************************/
+
+#include <physics_toolkit/TransferMatrixCache.h>
+#include <physics_toolkit/LatticeFunctionTable.h>
+#include <basic_toolkit/GenericException.h>
+#include <basic_toolkit/MathConstants.h>
+#include <mxyzptlk/Jet.h>
+#include <mxyzptlk/JetC.h>
+#include <beamline/beamline.h>
+#include <beamline/BmlnElmnt.h>
+#include <beamline/JetParticle.h>
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <limits>
+
+using namespace MathConstants;
+using namespace std;
+
+namespace {
+
+ typedef PhaseSpaceIndexing::index index;
+
+ index const i_x    = Particle::i_x;
+ index const i_y    = Particle::i_y;
+ index const i_cdt  = Particle::i_cdt;
+ index const i_npx  = Particle::i_npx;
+ index const i_npy  = Particle::i_npy;
+ index const i_ndp  = Particle::i_ndp;
+
+ // Two reference particles are on the same orbit if they have identical states and
+ // reference momenta. Exact comparison is intended: an unmodified element maps
+ // identical inputs to identical outputs.
+
+ bool sameOrbit( Particle const& a, Particle const& b )
+ {
+   if ( a.refMomentum() != b.refMomentum() ) return false;
+
+   Vector const& u = a.state();
+   Vector const& v = b.state();
+
+   for ( int i=0; i<u.Dim(); ++i ) {
+     if ( u[i] != v[i] ) return false;
+   }
+   return true;
+ }
+
+} // anonymous namespace
+
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+TransferMatrixCache::Element::Element( BmlnElmnt const* e, Particle const& p )
+  : elm(e), serial(e->serial()), modcount(e->modificationCount()), matrix(), exit(p)
+{}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+TransferMatrixCache::TransferMatrixCache()
+  : elements_(), tree_(), leaves_(0), cumulative_(), nvalid_(0), entry_(0), first_(0), recomputed_(0),
+    env_( TJetEnvironment<double>::makeJetEnvironment( 1, 6, 6 ) )
+{}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+TransferMatrixCache::~TransferMatrixCache()
+{
+  delete entry_;
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+void TransferMatrixCache::clear()
+{
+  elements_.clear();
+  tree_.clear();
+  cumulative_.clear();
+
+  delete entry_; entry_ = 0;
+
+  leaves_     = 0;
+  nvalid_     = 0;
+  first_      = 0;
+  recomputed_ = 0;
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+int TransferMatrixCache::update( beamline const& bml, Particle const& p )
+{
+  std::vector<BmlnElmnt const*> elms;
+  elms.reserve( elements_.size() );
+
+  for ( beamline::const_deep_iterator it  = bml.deep_begin();
+                                      it != bml.deep_end(); ++it ) {
+    elms.push_back( &(**it) );
+  }
+
+  int const n = elms.size();
+
+  //-----------------------------------------------------------------
+  // moved is true when the entrance orbit of the current element
+  // differs from the one its cached matrix was computed about.
+  //-----------------------------------------------------------------
+
+  bool moved = ( !entry_ || !sameOrbit( *entry_, p ) );
+
+  if ( moved ) { delete entry_; entry_ = new Particle(p); }
+
+  bool const resized = ( n != size() );
+
+  if ( n < size() ) { elements_.erase( elements_.begin()+n, elements_.end() ); }
+
+  elements_.reserve( n );  // entry refers to the previous element
+
+  first_      = n;
+  recomputed_ = 0;
+
+   Jet__environment::pushEnv( env_ );
+  JetC__environment::pushEnv( env_ ); // implicit conversion
+
+  try {
+
+    for ( int i=0; i<n; ++i ) {
+
+      Particle const& entry = ( i == 0 ) ? *entry_ : elements_[i-1].exit;
+
+      if ( i == int( elements_.size() ) ) {
+        elements_.push_back( Element( elms[i], entry ) );
+        compute( elements_.back(), entry );
+        moved = true;
+      }
+      else {
+        Element& e = elements_[i];
+
+        if ( !moved && ( e.serial == elms[i]->serial() ) && ( e.modcount == elms[i]->modificationCount() ) ) continue;
+
+        Particle const previous( e.exit );
+
+        e.elm      = elms[i];
+        e.serial   = elms[i]->serial();
+        e.modcount = elms[i]->modificationCount();
+
+        compute( e, entry );
+
+        moved = !sameOrbit( e.exit, previous );
+
+        if ( !resized ) { updateTree(i); }
+      }
+
+      first_ = std::min( first_, i );
+      ++recomputed_;
+    }
+  }
+  catch ( ... ) {
+     Jet__environment::popEnv();
+    JetC__environment::popEnv();
+    clear();
+    throw;
+  }
+
+    Jet__environment::popEnv();
+   JetC__environment::popEnv();
+
+  if ( resized ) { rebuildTree(); }
+
+  cumulative_.resize( n );
+  nvalid_ = std::min( nvalid_, first_ );
+
+  return recomputed_;
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+void TransferMatrixCache::compute( Element& element, Particle const& entry ) const
+{
+  JetParticle jp( entry, env_ );
+
+  element.elm->propagate( jp );
+
+  element.matrix = jp.state().jacobian();
+  element.exit   = Particle( jp );
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+void TransferMatrixCache::rebuildTree()
+{
+  //-----------------------------------------------------------------
+  // Node k holds the product over the segment of its children:
+  // tree_[k] = tree_[2k+1] * tree_[2k]. The leaves past the end of
+  // the line are identity matrices.
+  //-----------------------------------------------------------------
+
+  int const n = elements_.size();
+
+  leaves_ = 1;
+  while ( leaves_ < n ) { leaves_ *= 2; }
+
+  tree_.assign( 2*leaves_, MatrixD::Imatrix(6) );
+
+  for ( int i=0; i<n; ++i ) { tree_[leaves_+i] = elements_[i].matrix; }
+
+  for ( int k=leaves_-1; k>0; --k ) { tree_[k] = tree_[2*k+1] * tree_[2*k]; }
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+void TransferMatrixCache::updateTree( int i )
+{
+  int k = leaves_ + i;
+
+  tree_[k] = elements_[i].matrix;
+
+  for ( k /= 2; k > 0; k /= 2 ) { tree_[k] = tree_[2*k+1] * tree_[2*k]; }
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+MatrixD const& TransferMatrixCache::matrix( int i ) const
+{
+  if ( (i < 0) || (i >= size()) ) {
+    throw GenericException( __FILE__, __LINE__,
+           "MatrixD const& TransferMatrixCache::matrix( int i ) const",
+           "Element index out of range." );
+  }
+  return elements_[i].matrix;
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+MatrixD const& TransferMatrixCache::cumulative( int i ) const
+{
+  if ( (i < 0) || (i >= size()) ) {
+    throw GenericException( __FILE__, __LINE__,
+           "MatrixD const& TransferMatrixCache::cumulative( int i ) const",
+           "Element index out of range." );
+  }
+
+  for ( ; nvalid_ <= i; ++nvalid_ ) {
+    cumulative_[nvalid_] = ( nvalid_ == 0 ) ? elements_[0].matrix
+                                            : elements_[nvalid_].matrix * cumulative_[nvalid_-1];
+  }
+
+  return cumulative_[i];
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+MatrixD const& TransferMatrixCache::oneTurn() const
+{
+  if ( empty() ) {
+    throw GenericException( __FILE__, __LINE__,
+           "MatrixD const& TransferMatrixCache::oneTurn() const",
+           "The cache is empty." );
+  }
+  return tree_[1];
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+Particle const& TransferMatrixCache::particle( int i ) const
+{
+  if ( (i < 0) || (i >= size()) ) {
+    throw GenericException( __FILE__, __LINE__,
+           "Particle const& TransferMatrixCache::particle( int i ) const",
+           "Element index out of range." );
+  }
+  return elements_[i].exit;
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+JetParticle TransferMatrixCache::oneTurnJetParticle() const
+{
+  MatrixD  const& mtrx = oneTurn();
+  Particle const& exit = elements_.back().exit;
+
+  JetParticle jp( exit,    env_ );
+  JetParticle id( *entry_, env_ );
+
+  Vector const& x0 = entry_->state();
+
+  for ( int i=0; i<6; ++i ) {
+    Jet z( exit.state()[i], env_ );
+    for ( int j=0; j<6; ++j ) {
+      if ( mtrx[i][j] != 0.0 ) { z += mtrx[i][j] * ( id.state()[j] - x0[j] ); }
+    }
+    jp.state()[i] = z;
+  }
+
+  return jp;
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+int TransferMatrixCache::propagateCourantSnyder2D( LatticeFunctionTable& lft, CSLattFuncs const& lf ) const
+{
+  int const n = size();
+
+  const double betax0  = lf.beta.hor;
+  const double alphax0 = lf.alpha.hor;
+  const double gamma_x0 = ( 1.0 + alphax0*alphax0 )/betax0;
+
+  const double betay0  = lf.beta.ver;
+  const double alphay0 = lf.alpha.ver;
+  const double gamma_y0 = ( 1.0 + alphay0*alphay0 )/betay0;
+
+  Vector eta0 = lf.dispersion.eta;
+
+  eta0[ i_cdt]  = 0.0;
+  eta0[ i_ndp]  = 1.0;
+
+  double const momentum = entry_ ? entry_->refMomentum() : 0.0;
+
+  LatticeFunctionTable::Table& dispersion = lft.define( "DISPERSION",     "etax etapx etay etapy" );
+  LatticeFunctionTable::Table& cs         = lft.define( "COURANT_SNYDER", "betax alphax psix betay alphay psiy" );
+
+  dispersion.reserve( n );
+  cs.reserve        ( n );
+
+  double mux    = 0.0;
+  double muy    = 0.0;
+  double psix0  = 0.0;
+  double psiy0  = 0.0;
+
+  for ( int i=0; i<n; ++i ) {
+
+    MatrixD const& mtrx = cumulative(i);
+
+    Vector eta    = mtrx*eta0;
+
+    double a = mtrx[i_x  ] [i_x   ];
+    double b = mtrx[i_x  ] [i_npx ];
+    double c = mtrx[i_npx] [i_x   ];
+    double d = mtrx[i_npx] [i_npx ];
+
+    // Allow for possible acceleration by scaling with momentum
+
+    double const scale = elements_[i].exit.refMomentum()/momentum;
+
+    double betax  = scale * ( a*a*betax0 - 2.0*a*b*alphax0 + b*b*gamma_x0 );
+    double alphax = scale * ( - a*c*betax0 + (a*d+b*c)*alphax0 - d*b*gamma_x0 );
+
+    double sinpsi =   b / sqrt(betax*betax0);
+    double cospsi =   a * sqrt(betax0/betax) - alphax0*sinpsi;
+
+    double psix  =  atan2( sinpsi,cospsi) / Math_TWOPI; if ( psix < 0.0) {psix += 1.0;}
+
+    a = mtrx[i_y  ][i_y   ];
+    b = mtrx[i_y  ][i_npy ];
+    c = mtrx[i_npy][i_y   ];
+    d = mtrx[i_npy][i_npy ];
+
+    double betay  = scale * ( a*a*betay0 - 2.0*a*b*alphay0 + b*b*gamma_y0 );
+    double alphay = scale * ( - a*c*betay0 + (a*d+b*c)*alphay0 - d*b*gamma_y0 );
+
+    sinpsi =   b /sqrt(betay*betay0);
+    cospsi =   a * sqrt(betay0/betay) - alphay0*sinpsi;
+
+    double psiy  =  atan2( sinpsi,cospsi) / Math_TWOPI; if ( psiy < 0.0) {psiy += 1.0;}
+
+    // phase advances are accumulated as in Optics::propagateCourantSnyder2D
+
+    double dmux = std::abs(psix - psix0);
+    double dmuy = std::abs(psiy - psiy0);
+
+    mux +=  (dmux>0.5) ? ( 1.0-dmux ) : dmux;
+    muy +=  (dmuy>0.5) ? ( 1.0-dmuy ) : dmuy;
+
+    psix0 =   psix;
+    psiy0 =   psiy;
+
+    cs         << betax << alphax << mux << betay << alphay << muy;
+    dispersion << eta[i_x] << eta[i_npx] << eta[i_y] << eta[i_npy];
+  }
+
+  return 0;
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+int TransferMatrixCache::propagateDispersion( LatticeFunctionTable& lft, Vector const& eta_arg, bool dppconstant ) const
+{
+  //-----------------------------------------------------------------
+  // The dispersion vector is carried from element to element, as in
+  // Optics::propagateDispersion: with dppconstant, the dp/p component
+  // is restored after an element that changes the reference momentum;
+  // otherwise, the result is rescaled by the dp/p component.
+  //-----------------------------------------------------------------
+
+  int const n = size();
+
+  Vector eta = eta_arg;
+
+  eta[ i_cdt]  = 0.0;
+  eta[ i_ndp]  = 1.0;
+
+  LatticeFunctionTable::Table& dispersion = lft.define( "DISPERSION", "etax etapx etay etapy" );
+
+  dispersion.reserve( n );
+
+  static double const eps =  10.0 * std::numeric_limits<double>::epsilon();
+
+  double p0 = entry_ ? entry_->refMomentum() : 0.0;
+
+  for ( int i=0; i<n; ++i ) {
+
+    double const ndp = eta[i_ndp];
+
+    eta = elements_[i].matrix*eta;
+
+    double const p1 = elements_[i].exit.refMomentum();
+
+    if ( dppconstant ) {
+      dispersion << eta[i_x] << eta[i_npx] << eta[i_y] << eta[i_npy];
+      if ( std::abs( p1 - p0 ) > eps ) { eta[i_ndp] = ndp; }
+    }
+    else {
+      double const scale = 1.0/eta[i_ndp];
+      dispersion << scale*eta[i_x] << scale*eta[i_npx] << scale*eta[i_y] << scale*eta[i_npy];
+    }
+
+    p0 = p1;
+  }
+
+  return 0;
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+void TransferMatrixCache::propagateEigenVectors( LatticeFunctionTable& lft, MatrixC const& EV0, Vector const& eta0 ) const
+{
+  int const n = size();
+
+  LatticeFunctionTable::Table& vectors    = lft.define( "EIGENVECTORS",
+                                                        "iseq:INTEGER component:INTEGER e0_real e0_imag e1_real e1_imag e2_real e2_imag "
+                                                        "                               e3_real e3_imag e4_real e4_imag e5_real e5_imag", false );
+
+  LatticeFunctionTable::Table& dispersion = lft.define( "DISPERSION", "etax etapx etay etapy" );
+
+  vectors.reserve   ( 6*n );
+  dispersion.reserve(   n );
+
+  double const momentum = entry_ ? entry_->refMomentum() : 0.0;
+
+  for ( int i=0; i<n; ++i ) {
+
+    MatrixD const& mtrx = cumulative(i);
+
+    MatrixC EN  = mtrx*EV0;          // propagate eigenvectors
+    Vector  eta = mtrx*eta0;         // propagate dispersion
+
+    // allow for possible acceleration by scaling
+
+    double const scale = sqrt( elements_[i].exit.refMomentum()/momentum );
+
+    dispersion << eta[i_x] << eta[i_npx] << eta[i_y] << eta[i_npy];
+
+    for ( int k=0; k<6; ++k ) {
+
+      vectors << i << k;
+
+      for ( int j=0; j<6; ++j ) {
+        std::complex<double> value = EN[k][j]*scale;
+        vectors << value.real() << value.imag();
+      }
+    }
+  }
+}
@@ -0,0 +1,611 @@
+/*************************************************************************
+**************************************************************************
+**************************************************************************
+******
+******  PHYSICS TOOLKIT: Library of utilites and Sage classes
+******             which facilitate calculations with the
+******             BEAMLINE class library.
+******
+******  File:      TurnByTurnFile.cc
+******
+******  Copyright (c) Fermi Research Alliance LLC
+******                All Rights Reserved
+******
+******  Usage, modification, and redistribution are subject to terms
+******  of the License supplied with this software.
+******
+******  Software and documentation created under
+******  U.S. Department of Energy Contract No. DE-AC02-07CH11359.
+******  The U.S. Government retains a world-wide non-exclusive,
+******  royalty-free license to publish or reproduce documentation
+******  and software for U.S. Government purposes. This software
+******  is protected under the U.S. and Foreign Copyright Laws.
+******
+******  Revision History
+******
+******  Oct 2026
+******
+******  - Initial version.
+******
+**************************************************************************
+*************************************************************************/
+
+#include <physics_toolkit/TurnByTurnFile.h>
+#include <basic_toolkit/GenericException.h>
+#include <basic_toolkit/iosetup.h>
+#include <beamline/Particle.h>
+#include <beamline/ParticleBunch.h>
+#include <beamline/TBunch.h>
+#include <beamline/BunchArrays.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <limits>
+#include <sstream>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+using FNAL::pcerr;
+
+using boost::uint32_t;
+using boost::int32_t;
+using boost::uint64_t;
+
+//------------------------------------------------------------------------------------------
+// File header. The name table starts at offset points, the first chunk at offset data.
+//------------------------------------------------------------------------------------------
+
+struct TurnByTurnFile::Header {
+
+  char      magic[8];           // "CHEFTBT"
+  uint32_t  version;
+  uint32_t  byte_order;         // byte_order_mark, as written
+  uint32_t  header_size;        // sizeof(Header)
+  int32_t   nparticles;
+  int32_t   npoints;
+  int32_t   turns_per_chunk;
+  int32_t   value_size;         // 4 or 8 bytes
+  int32_t   ncoords;
+
+  uint64_t  points;             // section offsets [ bytes ]
+  uint64_t  data;
+  uint64_t  chunk_bytes;        // size of a full chunk
+
+  uint64_t  nturns;             // turns written; updated after each chunk
+};
+
+uint32_t const TurnByTurnFile::format_version = 1;
+
+namespace {
+
+ char        const magic[8]        = { 'C', 'H', 'E', 'F', 'T', 'B', 'T', '\0' };
+ uint32_t    const byte_order_mark = 0x01020304;
+
+ std::size_t const default_chunk_bytes = 8*1024*1024;
+
+ double      const missing = std::numeric_limits<double>::quiet_NaN();   // lost particles, unused turns
+
+ void writeAll( int fd, void const* buffer, std::size_t n, std::string const& filename )
+ {
+   char const* p = static_cast<char const*>( buffer );
+
+   while ( n > 0 ) {
+     ssize_t const written = write( fd, p, n );
+     if ( written < 0 && errno == EINTR ) continue;
+     if ( written <= 0 ) {
+       throw GenericException( __FILE__, __LINE__,
+             "void writeAll( int fd, void const* buffer, std::size_t n, std::string const& filename )",
+             ( "Error writing " + filename + "." ).c_str() );
+     }
+     p += written;
+     n -= written;
+   }
+ }
+
+} // namespace
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+TurnByTurnFile::TurnByTurnFile()
+  : nparticles_(0), npoints_(0), turnsPerChunk_(0), valueSize_(0), names_(), azimuths_()
+{}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+std::string const& TurnByTurnFile::name( int point ) const
+{
+  if ( (point < 0) || (point >= npoints_) ) {
+    throw GenericException( __FILE__, __LINE__,
+           "std::string const& TurnByTurnFile::name( int point ) const",
+           "Observation point index out of range." );
+  }
+  return names_[point];
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+double TurnByTurnFile::azimuth( int point ) const
+{
+  if ( (point < 0) || (point >= npoints_) ) {
+    throw GenericException( __FILE__, __LINE__,
+           "double TurnByTurnFile::azimuth( int point ) const",
+           "Observation point index out of range." );
+  }
+  return azimuths_[point];
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+int TurnByTurnFile::index( std::string const& name ) const
+{
+  std::vector<std::string>::const_iterator it = std::find( names_.begin(), names_.end(), name );
+
+  return ( it == names_.end() ) ? -1 : int( it - names_.begin() );
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+TurnByTurnWriter::TurnByTurnWriter( std::string const& filename, int nparticles,
+                                    std::vector<std::string> const& names, std::vector<double> const& azimuths,
+                                    Precision precision, int turnsPerChunk )
+  : filename_(filename), fd_(-1), dataOffset_(0), chunkValues_(0), nturns_(0), turn_(0), chunk_(), single_()
+{
+  static char const* const fname = "TurnByTurnWriter::TurnByTurnWriter( std::string const&, int, ... )";
+
+  if ( nparticles < 1 || names.empty() || names.size() != azimuths.size() || turnsPerChunk < 0
+       || ( precision != single_precision && precision != double_precision ) ) {
+    throw GenericException( __FILE__, __LINE__, fname,
+          "There must be at least one particle and one observation point, with one azimuth per name." );
+  }
+
+  nparticles_ = nparticles;
+  npoints_    = names.size();
+  valueSize_  = precision;
+  names_      = names;
+  azimuths_   = azimuths;
+
+  std::size_t const turnValues = std::size_t( npoints_ )*nparticles_*ncoords;
+
+  turnsPerChunk_ = ( turnsPerChunk > 0 ) ? turnsPerChunk
+                                         : std::max( std::size_t(1), default_chunk_bytes/( turnValues*valueSize_ ) );
+  chunkValues_   = turnValues*turnsPerChunk_;
+
+  chunk_.assign( chunkValues_, missing );
+  if ( valueSize_ == single_precision ) { single_.resize( chunkValues_ ); }
+
+  //---------------------------------------------------------------
+  // header and name table
+  //---------------------------------------------------------------
+
+  std::vector<char> points;
+
+  for ( int k=0; k<npoints_; ++k ) {
+    uint32_t const length = names_[k].size();
+    std::size_t const pos = points.size();
+    points.resize( pos + padded( sizeof(double) + sizeof(uint32_t) + length ), '\0' );
+    std::memcpy( &points[pos], &azimuths_[k], sizeof(double) );
+    std::memcpy( &points[pos + sizeof(double)], &length, sizeof(uint32_t) );
+    std::memcpy( &points[pos + sizeof(double) + sizeof(uint32_t)], names_[k].data(), length );
+  }
+
+  Header h;
+  std::memset( &h, 0, sizeof(Header) );
+
+  std::memcpy( h.magic, magic, sizeof(magic) );
+  h.version          = format_version;
+  h.byte_order       = byte_order_mark;
+  h.header_size      = sizeof(Header);
+  h.nparticles       = nparticles_;
+  h.npoints          = npoints_;
+  h.turns_per_chunk  = turnsPerChunk_;
+  h.value_size       = valueSize_;
+  h.ncoords          = ncoords;
+  h.points           = padded( sizeof(Header) );
+  h.data             = h.points + points.size();
+  h.chunk_bytes      = chunkValues_*valueSize_;
+  h.nturns           = 0;
+
+  dataOffset_ = h.data;
+
+  fd_ = open( filename_.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644 );
+
+  if ( fd_ < 0 ) {
+    throw GenericException( __FILE__, __LINE__, fname, ( "Cannot open " + filename_ + " for writing." ).c_str() );
+  }
+
+  char const zeros[8] = { 0, 0, 0, 0, 0, 0, 0, 0 };
+
+  try {
+    writeAll( fd_, &h, sizeof(Header), filename_ );
+    writeAll( fd_, zeros, h.points - sizeof(Header), filename_ );
+    if ( !points.empty() ) { writeAll( fd_, &points[0], points.size(), filename_ ); }
+  }
+  catch ( ... ) {
+    ::close( fd_ );
+    fd_ = -1;
+    throw;
+  }
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+TurnByTurnWriter::~TurnByTurnWriter()
+{
+  try {
+    close();
+  }
+  catch ( std::exception const& e ) {
+    (*pcerr) << "*** WARNING *** TurnByTurnWriter: " << e.what() << std::endl;
+  }
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+void TurnByTurnWriter::check( int point, int nparticles ) const
+{
+  if ( fd_ < 0 ) {
+    throw GenericException( __FILE__, __LINE__,
+           "void TurnByTurnWriter::check( int point, int nparticles ) const",
+           ( filename_ + " has been closed." ).c_str() );
+  }
+
+  if ( (point < 0) || (point >= npoints_) ) {
+    throw GenericException( __FILE__, __LINE__,
+           "void TurnByTurnWriter::check( int point, int nparticles ) const",
+           "Observation point index out of range." );
+  }
+
+  if ( nparticles != nparticles_ ) {
+    std::ostringstream uic;
+    uic << filename_ << " records " << nparticles_ << " particles; " << nparticles << " were given.";
+    throw GenericException( __FILE__, __LINE__,
+           "void TurnByTurnWriter::check( int point, int nparticles ) const",
+           uic.str().c_str() );
+  }
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+void TurnByTurnWriter::record( int point, Particle const& p )
+{
+  check( point, 1 );
+
+  double* const values = &chunk_[ std::size_t( point )*ncoords*turnsPerChunk_ + turn_ ];
+
+  for ( int i=0; i<ncoords; ++i ) {
+    values[i*turnsPerChunk_] = p.isLost() ? missing : p.state()[i];
+  }
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+void TurnByTurnWriter::record( int point, ParticleBunch const& b )
+{
+  check( point, b.size() );
+
+  double* values = &chunk_[ std::size_t( point )*nparticles_*ncoords*turnsPerChunk_ + turn_ ];
+
+  for ( ParticleBunch::const_iterator it = b.begin(); it != b.end(); ++it, values += ncoords*turnsPerChunk_ ) {
+    for ( int i=0; i<ncoords; ++i ) {
+      values[i*turnsPerChunk_] = it->isLost() ? missing : it->state()[i];
+    }
+  }
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+void TurnByTurnWriter::record( int point, BunchArrays const& b )
+{
+  check( point, b.size() );
+
+  double* const values = &chunk_[ std::size_t( point )*nparticles_*ncoords*turnsPerChunk_ + turn_ ];
+
+  std::size_t const stride = ncoords*turnsPerChunk_;
+
+  for ( int i=0; i<ncoords; ++i ) {
+    double const* const coord = b[i];
+    for ( int j=0; j<nparticles_; ++j ) {
+      values[j*stride + i*turnsPerChunk_] = b.isLost(j) ? missing : coord[j];
+    }
+  }
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+void TurnByTurnWriter::endTurn()
+{
+  if ( fd_ < 0 ) {
+    throw GenericException( __FILE__, __LINE__,
+           "void TurnByTurnWriter::endTurn()",
+           ( filename_ + " has been closed." ).c_str() );
+  }
+
+  if ( ++turn_ == turnsPerChunk_ ) { flush(); }
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+void TurnByTurnWriter::flush()
+{
+  //-----------------------------------------------------------------------
+  // A partial chunk is only written by close(): its series are packed
+  // in place, with a stride equal to the number of turns it holds, so
+  // that the file does not grow by a full chunk. The reader computes the
+  // stride of the last chunk from the number of turns in the header.
+  //-----------------------------------------------------------------------
+
+  if ( turn_ == 0 ) return;
+
+  std::size_t const nseries = chunkValues_/turnsPerChunk_;
+  std::size_t const nvalues = nseries*turn_;
+
+  if ( turn_ < turnsPerChunk_ ) {
+    for ( std::size_t s=1; s<nseries; ++s ) {
+      std::copy( &chunk_[s*turnsPerChunk_], &chunk_[s*turnsPerChunk_] + turn_, &chunk_[s*turn_] );
+    }
+  }
+
+  if ( valueSize_ == single_precision ) {
+    std::copy( chunk_.begin(), chunk_.begin() + nvalues, single_.begin() );
+    writeAll( fd_, &single_[0], nvalues*sizeof(float), filename_ );
+  }
+  else {
+    writeAll( fd_, &chunk_[0], nvalues*sizeof(double), filename_ );
+  }
+
+  nturns_ += turn_;
+  turn_    = 0;
+
+  uint64_t const nturns = nturns_;
+
+  if ( pwrite( fd_, &nturns, sizeof(uint64_t), offsetof( Header, nturns ) ) != sizeof(uint64_t) ) {
+    throw GenericException( __FILE__, __LINE__,
+           "void TurnByTurnWriter::flush()",
+           ( "Error writing the header of " + filename_ + "." ).c_str() );
+  }
+
+  std::fill( chunk_.begin(), chunk_.end(), missing );
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+void TurnByTurnWriter::close()
+{
+  if ( fd_ < 0 ) return;
+
+  int const fd = fd_;
+
+  try {
+    flush();
+  }
+  catch ( ... ) {
+    ::close( fd );
+    fd_ = -1;
+    throw;
+  }
+
+  fd_ = -1;
+
+  if ( ::close( fd ) != 0 ) {
+    throw GenericException( __FILE__, __LINE__,
+           "void TurnByTurnWriter::close()",
+           ( "Error closing " + filename_ + "." ).c_str() );
+  }
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+TurnByTurnReader::TurnByTurnReader( std::string const& filename )
+  : map_(0), size_(0), dataOffset_(0), chunkBytes_(0), nturns_(0)
+{
+  static char const* const fname = "TurnByTurnReader::TurnByTurnReader( std::string const& filename )";
+
+  int const fd = open( filename.c_str(), O_RDONLY );
+
+  if ( fd < 0 ) {
+    throw GenericException( __FILE__, __LINE__, fname, ( "Cannot open " + filename + "." ).c_str() );
+  }
+
+  struct stat st;
+  if ( fstat( fd, &st ) != 0 || std::size_t( st.st_size ) < sizeof(Header) ) {
+    ::close( fd );
+    throw GenericException( __FILE__, __LINE__, fname, ( filename + " is not a turn-by-turn file." ).c_str() );
+  }
+
+  size_ = st.st_size;
+  map_  = mmap( 0, size_, PROT_READ, MAP_SHARED, fd, 0 );
+  ::close( fd );
+
+  if ( map_ == MAP_FAILED ) {
+    map_ = 0;
+    throw GenericException( __FILE__, __LINE__, fname, ( "Cannot map " + filename + "." ).c_str() );
+  }
+
+  char const* const base = static_cast<char const*>( map_ );
+  Header const& h = *reinterpret_cast<Header const*>( base );
+
+  std::string error;
+
+  if ( std::memcmp( h.magic, magic, sizeof(magic) ) != 0 ) {
+    error = " is not a turn-by-turn file.";
+  }
+  else if ( h.byte_order != byte_order_mark ) {
+    error = " was written on a machine with a different byte order.";
+  }
+  else if ( h.version != format_version ) {
+    std::ostringstream uic;
+    uic << " has format version " << h.version << "; version " << format_version << " is expected.";
+    error = uic.str();
+  }
+  else if (    h.header_size != sizeof(Header) || h.ncoords != ncoords
+            || h.nparticles < 1 || h.npoints < 1 || h.turns_per_chunk < 1
+            || ( h.value_size != single_precision && h.value_size != double_precision )
+            || h.chunk_bytes != uint64_t( h.npoints )*h.nparticles*ncoords*h.turns_per_chunk*h.value_size
+            || h.points < sizeof(Header) || h.data < h.points || h.data > size_ ) {
+    error = " has an unexpected layout.";
+  }
+
+  //---------------------------------------------------------------
+  // name table
+  //---------------------------------------------------------------
+
+  if ( error.empty() ) {
+
+    nparticles_    = h.nparticles;
+    npoints_       = h.npoints;
+    turnsPerChunk_ = h.turns_per_chunk;
+    valueSize_     = h.value_size;
+    dataOffset_    = h.data;
+    chunkBytes_    = h.chunk_bytes;
+
+    std::size_t pos = h.points;
+
+    for ( int k=0; k < npoints_ && error.empty(); ++k ) {
+
+      uint32_t length = 0;
+      double   s      = 0.0;
+
+      if ( pos + sizeof(double) + sizeof(uint32_t) > dataOffset_ ) { error = " is truncated or corrupt."; break; }
+
+      std::memcpy( &s,      base + pos,                  sizeof(double)   );
+      std::memcpy( &length, base + pos + sizeof(double), sizeof(uint32_t) );
+
+      if ( pos + sizeof(double) + sizeof(uint32_t) + length > dataOffset_ ) { error = " is truncated or corrupt."; break; }
+
+      azimuths_.push_back( s );
+      names_.push_back( std::string( base + pos + sizeof(double) + sizeof(uint32_t), length ) );
+
+      pos += padded( sizeof(double) + sizeof(uint32_t) + length );
+    }
+  }
+
+  //---------------------------------------------------------------
+  // Turns: the count in the header is trusted only as far as the
+  // file holds the corresponding chunks (the writer may not have
+  // updated the header yet, or may have been interrupted).
+  //---------------------------------------------------------------
+
+  if ( error.empty() ) {
+
+    std::size_t const turnBytes = chunkBytes_/turnsPerChunk_;
+    std::size_t const available = size_ - dataOffset_;
+
+    uint64_t const nfull    = available/chunkBytes_;
+    uint64_t const fitting  = nfull*turnsPerChunk_ + ( available - nfull*chunkBytes_ )/turnBytes;
+
+    nturns_ = std::min( h.nturns, fitting );
+
+    if ( h.nturns > fitting ) {
+      (*pcerr) << "*** WARNING *** TurnByTurnReader: " << filename << " holds " << fitting
+               << " of the " << h.nturns << " turns announced by its header." << std::endl;
+    }
+  }
+
+  if ( !error.empty() ) {
+    munmap( map_, size_ );
+    map_ = 0;
+    throw GenericException( __FILE__, __LINE__, fname, ( filename + error ).c_str() );
+  }
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+TurnByTurnReader::~TurnByTurnReader()
+{
+  if ( map_ ) { munmap( map_, size_ ); }
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+void TurnByTurnReader::check( int point, int particle, int coord ) const
+{
+  if (    (point    < 0) || (point    >= npoints_)
+       || (particle < 0) || (particle >= nparticles_)
+       || (coord    < 0) || (coord    >= ncoords) ) {
+    throw GenericException( __FILE__, __LINE__,
+           "void TurnByTurnReader::check( int point, int particle, int coord ) const",
+           "Observation point, particle or coordinate index out of range." );
+  }
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+void const* TurnByTurnReader::chunk( int k ) const
+{
+  return static_cast<char const*>( map_ ) + dataOffset_ + std::size_t( k )*chunkBytes_;
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+double TurnByTurnReader::value( int turn, int point, int particle, int coord ) const
+{
+  double v = 0.0;
+
+  if ( series( point, particle, coord, turn, 1, &v ) != 1 ) {
+    throw GenericException( __FILE__, __LINE__,
+           "double TurnByTurnReader::value( int turn, int point, int particle, int coord ) const",
+           "Turn index out of range." );
+  }
+
+  return v;
+}
+
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+
+int TurnByTurnReader::series( int point, int particle, int coord, int first, int n, double* out ) const
+{
+  check( point, particle, coord );
+
+  if ( first < 0 || n <= 0 || first >= nturns_ ) return 0;
+
+  int const last   = std::min( first + n, nturns_ );
+  int const nfull  = nturns_/turnsPerChunk_;
+
+  std::size_t const s = ( std::size_t( point )*nparticles_ + particle )*ncoords + coord;   // series index
+
+  for ( int turn = first; turn < last; ) {
+
+    int const k      = turn/turnsPerChunk_;
+    int const stride = ( k < nfull ) ? turnsPerChunk_ : nturns_ - nfull*turnsPerChunk_;   // packed last chunk
+    int const j      = turn - k*turnsPerChunk_;
+    int const m      = std::min( stride - j, last - turn );
+
+    if ( valueSize_ == single_precision ) {
+      float const* const v = static_cast<float const*>( chunk(k) ) + s*stride + j;
+      std::copy( v, v + m, out );
+    }
+    else {
+      double const* const v = static_cast<double const*>( chunk(k) ) + s*stride + j;
+      std::copy( v, v + m, out );
+    }
+
+    out  += m;
+    turn += m;
+  }
+
+  return last - first;
+}
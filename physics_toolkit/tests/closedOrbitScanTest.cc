@@ -0,0 +1,230 @@
+////////////////////////////////////////////////////////////
+//
+// File:          closedOrbitScanTest.cc
+//
+////////////////////////////////////////////////////////////
+//
+// Checks that a ClosedOrbitScan run with several threads
+// gives the same closed orbits, tunes and one-turn matrices
+// as Optics::closed_orbit called serially, one momentum
+// offset after the other.
+//
+// The ring is made of FODO cells with bends and sextupoles,
+// so that the closed orbit and the tunes depend on dp/p.
+// The scan is run once without parameter sets, then with
+// two sets, the second one with a stronger focusing
+// quadrupole. The line given to the scan must not be
+// modified.
+//
+// ------------
+// COMMAND LINE
+// ------------
+// closedOrbitScanTest [options]
+//
+// -------
+// OPTIONS
+// -------
+// Note: NNN represents an integer
+//
+// -cells   NNN   number of cells
+//                : default = 8
+// -threads NNN   number of threads
+//                : default = 4
+//
+////////////////////////////////////////////////////////////
+
+#include <iostream>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <vector>
+
+#include <boost/bind.hpp>
+
+#include <basic_toolkit/GenericException.h>
+#include <beamline/beamline.h>
+#include <beamline/Drift.h>
+#include <beamline/quadrupole.h>
+#include <beamline/sextupole.h>
+#include <beamline/sbend.h>
+#include <beamline/Particle.h>
+#include <beamline/JetParticle.h>
+#include <physics_toolkit/Optics.h>
+#include <physics_toolkit/ClosedOrbitScan.h>
+#include <physics_toolkit/LatticeFunctionTable.h>
+
+using namespace std;
+
+namespace {
+
+double const kf_scale = 1.02;
+
+//
+// Parameter set 1 scales the strength of every "F" quadrupole.
+//
+
+void scaleF( beamline& bml, int set )
+{
+  if ( set == 0 ) return;
+
+  for ( beamline::deep_iterator it = bml.deep_begin(); it != bml.deep_end(); ++it ) {
+    if ( 0 == strcmp( (*it)->Name(), "F" ) ) { (*it)->setStrength( kf_scale*(*it)->Strength() ); }
+  }
+}
+
+//
+// Compares row task of the table with a serial closed orbit search.
+//
+
+int check( LatticeFunctionTable const& lft, int task, beamline const& bml, Particle const& pr, double dpp )
+{
+  LatticeFunctionTable::Table const& table = lft["CLOSED_ORBIT_SCAN"];
+
+  if ( table.integerColumn( "converged" )[task] != 1 ) {
+    cout << "*** ERROR *** Task " << task << " (dp/p = " << dpp << ") did not converge." << endl;
+    return 1;
+  }
+
+  Particle p( pr );
+  p.state()[Particle::i_ndp] = dpp;
+
+  JetParticle const jp = Optics::closed_orbit( bml, JetParticle( p ) );
+  Particle    const co( jp );
+  Vector      const nu = Optics::tunes( jp );
+  MatrixD     const m  = jp.state().jacobian();
+
+  char const* const names[] = { "x", "y", "cdt", "npx", "npy", "ndp" };
+
+  double dco = 0.0;
+  for ( int i=0; i<6; ++i ) {
+    if ( i == Particle::i_cdt ) continue;
+    dco = std::max( dco, std::abs( table.column( names[i] )[task] - co.state()[i] ) );
+  }
+
+  double const dnu = std::max( std::abs( table.column( "nux" )[task] - nu[0] ),
+                               std::abs( table.column( "nuy" )[task] - nu[1] ) );
+
+  double dm = 0.0;
+  for ( int i=0; i<6; ++i ) {
+    for ( int j=0; j<6; ++j ) {
+      char name[4] = { 'm', char( '0'+i ), char( '0'+j ), '\0' };
+      dm = std::max( dm, std::abs( table.column( name )[task] - m[i][j] ) );
+    }
+  }
+
+  if ( dco > 1.0e-12 || dnu > 1.0e-10 || dm > 1.0e-9 ) {
+    cout << "*** ERROR *** Task " << task << " (dp/p = " << dpp << "): the results differ from the serial ones by "
+         << dco << " (orbit), " << dnu << " (tunes), " << dm << " (one-turn matrix)" << endl;
+    return 1;
+  }
+
+  return 0;
+}
+
+} // anonymous namespace
+
+int main( int argc, char** argv )
+{
+  int ncells   = 8;
+  int nthreads = 4;
+
+  for ( int i=1; i<argc; ++i ) {
+    if      ( 0 == strcmp( argv[i], "-cells"   ) && i+1 < argc ) { ncells   = atoi( argv[++i] ); }
+    else if ( 0 == strcmp( argv[i], "-threads" ) && i+1 < argc ) { nthreads = atoi( argv[++i] ); }
+  }
+
+  createStandardEnvironments(1);
+
+  Proton pr( 100.0 );
+  double const brho  = pr.refBrho();
+  double const angle = M_PI/ncells;
+
+  Drift      O ( "O",  1.5 );
+  quadrupole F ( "F",  0.5,  0.12*brho );
+  quadrupole D ( "D",  0.5, -0.12*brho );
+  sextupole  SF( "SF", 0.2,  0.4*brho );
+  sextupole  SD( "SD", 0.2, -0.6*brho );
+  sbend      B ( "B",  3.0, brho*angle/3.0, angle );
+
+  beamline ring( "RING" );
+  for ( int i=0; i<ncells; ++i ) {
+    ring.append( F ); ring.append( O ); ring.append( SF ); ring.append( B ); ring.append( O );
+    ring.append( D ); ring.append( O ); ring.append( SD ); ring.append( B ); ring.append( O );
+  }
+  ring.setLineMode( beamline::ring );
+  ring.registerReference( pr );
+
+  std::vector<double> dpp;
+  for ( int i=-3; i<=3; ++i ) { dpp.push_back( 1.0e-3*i ); }
+
+  int status = 0;
+
+  try {
+
+    ClosedOrbitScan scan( ring, JetParticle( pr ) );
+    scan.setNumberOfThreads( nthreads );
+
+    // ---------------------------------------
+    // one parameter set
+    // ---------------------------------------
+
+    LatticeFunctionTable lft;
+
+    if ( scan.run( lft, dpp ) != 0 || lft["CLOSED_ORBIT_SCAN"].numRows() != int( dpp.size() ) ) {
+      cout << "*** ERROR *** The scan without parameter sets failed." << endl;
+      status = 1;
+    }
+
+    for ( unsigned int i=0; i<dpp.size(); ++i ) {
+      status |= check( lft, i, ring, pr, dpp[i] );
+    }
+
+    if ( lft["CLOSED_ORBIT_SCAN"].column( "x" )[0] * lft["CLOSED_ORBIT_SCAN"].column( "x" )[dpp.size()-1] >= 0.0 ) {
+      cout << "*** ERROR *** The closed orbit does not change sign with dp/p." << endl;
+      status = 1;
+    }
+
+    // ---------------------------------------
+    // two parameter sets
+    // ---------------------------------------
+
+    LatticeFunctionTable lft2;
+
+    if ( scan.run( lft2, dpp, 2, boost::bind( &scaleF, _1, _2 ) ) != 0 ) {
+      cout << "*** ERROR *** The scan with parameter sets failed." << endl;
+      status = 1;
+    }
+
+    beamline* modified = ring.clone();
+    scaleF( *modified, 1 );
+
+    for ( unsigned int i=0; i<dpp.size(); ++i ) {
+      status |= check( lft2, i,              ring,      pr, dpp[i] );
+      status |= check( lft2, i + dpp.size(), *modified, pr, dpp[i] );
+    }
+
+    delete modified;
+
+    if ( std::abs( lft2["CLOSED_ORBIT_SCAN"].column( "nux" )[dpp.size()/2] -
+                   lft2["CLOSED_ORBIT_SCAN"].column( "nux" )[dpp.size() + dpp.size()/2] ) < 1.0e-4 ) {
+      cout << "*** ERROR *** The parameter sets have the same tunes." << endl;
+      status = 1;
+    }
+
+    // the line given to the scan is left untouched
+
+    for ( beamline::deep_iterator it = ring.deep_begin(); it != ring.deep_end(); ++it ) {
+      if ( 0 == strcmp( (*it)->Name(), "F" ) && (*it)->Strength() != F.Strength() ) {
+        cout << "*** ERROR *** The scan modified the ring." << endl;
+        status = 1;
+        break;
+      }
+    }
+  }
+  catch ( GenericException const& ge ) {
+    cout << "*** ERROR *** " << ge.what() << endl;
+    status = 1;
+  }
+
+  return status;
+}
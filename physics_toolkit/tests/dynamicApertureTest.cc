@@ -0,0 +1,235 @@
+////////////////////////////////////////////////////////////
+//
+// File:          dynamicApertureTest.cc
+//
+////////////////////////////////////////////////////////////
+//
+// Scans the dynamic aperture of a ring of FODO cells with
+// strong sextupoles and elliptical apertures on the
+// quadrupoles, with a DynamicAperture, and checks that
+//
+//  - the survival turns agree with those of particles
+//    tracked one at a time through beamline::propagate
+//    (the vectorized bunch kernels may round differently, so
+//    that a few points close to the boundary may differ);
+//  - the results do not depend on the number of threads or
+//    on the batch size;
+//  - refinement finds the same boundary with fewer tracked
+//    points;
+//  - particles escape from a ring without apertures.
+//
+// ------------
+// COMMAND LINE
+// ------------
+// dynamicApertureTest [options]
+//
+// -------
+// OPTIONS
+// -------
+// Note: NNN represents an integer
+//
+// -turns   NNN   number of turns
+//                : default = 200
+// -threads NNN   number of threads
+//                : default = 4
+//
+////////////////////////////////////////////////////////////
+
+#include <iostream>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <vector>
+
+#include <basic_toolkit/GenericException.h>
+#include <beamline/beamline.h>
+#include <beamline/Drift.h>
+#include <beamline/quadrupole.h>
+#include <beamline/sextupole.h>
+#include <beamline/Particle.h>
+#include <physics_toolkit/DynamicAperture.h>
+#include <physics_toolkit/LatticeFunctionTable.h>
+
+using namespace std;
+
+namespace {
+
+double const aperture = 0.03;     // [m]
+
+//
+// survival turns of a particle tracked alone
+//
+
+int survival( beamline const& ring, Particle const& pr, double x, double y, int nturns, double escape )
+{
+  Particle p( pr );
+  p.state()[Particle::i_x] += x;
+  p.state()[Particle::i_y] += y;
+
+  for ( int turn=0; turn<nturns; ++turn ) {
+    ring.propagate( p );
+    if ( p.isLost() || !( std::abs( p.x() ) <= escape && std::abs( p.y() ) <= escape ) ) return turn;
+  }
+  return nturns;
+}
+
+beamline* makeRing( Particle const& pr, bool apertures )
+{
+  double const brho = pr.refBrho();
+
+  Drift      O ( "O",  1.5 );
+  quadrupole F ( "F",  0.5,  0.12*brho );
+  quadrupole D ( "D",  0.5, -0.12*brho );
+  sextupole  SF( "SF", 0.2,  8.0*brho );
+  sextupole  SD( "SD", 0.2, -8.0*brho );
+
+  if ( apertures ) {
+    F.setAperture( BmlnElmnt::elliptical, aperture, aperture );
+    D.setAperture( BmlnElmnt::elliptical, aperture, aperture );
+  }
+
+  beamline* ring = new beamline( "RING" );
+  for ( int i=0; i<8; ++i ) {
+    ring->append( F ); ring->append( O ); ring->append( SF ); ring->append( O );
+    ring->append( D ); ring->append( O ); ring->append( SD ); ring->append( O );
+  }
+  ring->setLineMode( beamline::ring );
+
+  return ring;
+}
+
+} // anonymous namespace
+
+int main( int argc, char** argv )
+{
+  int nturns   = 200;
+  int nthreads = 4;
+
+  for ( int i=1; i<argc; ++i ) {
+    if      ( 0 == strcmp( argv[i], "-turns"   ) && i+1 < argc ) { nturns   = atoi( argv[++i] ); }
+    else if ( 0 == strcmp( argv[i], "-threads" ) && i+1 < argc ) { nthreads = atoi( argv[++i] ); }
+  }
+
+  Proton pr( 100.0 );
+
+  int status = 0;
+
+  try {
+
+    beamline* ring = makeRing( pr, true );
+
+    int    const namplitudes = 40;
+    int    const nangles     = 5;
+    double const amax        = 0.04;
+
+    // ---------------------------------------
+    // serial scan vs particles tracked alone
+    // ---------------------------------------
+
+    DynamicAperture da( *ring, pr );
+    da.setNumberOfThreads( 1 );
+
+    LatticeFunctionTable serial;
+
+    if ( da.polar( serial, nturns, amax, namplitudes, nangles ) != namplitudes*nangles ) {
+      cout << "*** ERROR *** Not every point was tracked." << endl;
+      status = 1;
+    }
+
+    LatticeFunctionTable::Table const& table = serial["DYNAMIC_APERTURE"];
+
+    int ndiffer = 0;
+    int nlost   = 0;
+
+    for ( int i=0; i<table.numRows(); ++i ) {
+      int const turns = table.integerColumn( "turns" )[i];
+      if ( turns < nturns ) ++nlost;
+      if ( turns != survival( *ring, pr, table.column( "x" )[i], table.column( "y" )[i], nturns, da.escapeAmplitude() ) ) ++ndiffer;
+    }
+
+    if ( nlost == 0 || nlost == table.numRows() || ndiffer > table.numRows()/50 ) {
+      cout << "*** ERROR *** " << ndiffer << " of " << table.numRows() << " points do not survive as long as "
+           << "particles tracked alone; " << nlost << " are lost." << endl;
+      status = 1;
+    }
+
+    // ---------------------------------------
+    // threads and batches
+    // ---------------------------------------
+
+    da.setNumberOfThreads( nthreads );
+    da.setBatchSize( 7 );
+
+    LatticeFunctionTable threaded;
+    da.polar( threaded, nturns, amax, namplitudes, nangles );
+
+    if ( threaded["DYNAMIC_APERTURE"].integerColumn( "turns" ) != table.integerColumn( "turns" ) ) {
+      cout << "*** ERROR *** The survival turns depend on the number of threads or on the batch size." << endl;
+      status = 1;
+    }
+
+    // ---------------------------------------
+    // refinement
+    // ---------------------------------------
+
+    da.setRefinement( 4 );
+
+    LatticeFunctionTable refined;
+    int const ntracked = da.polar( refined, nturns, amax, namplitudes, nangles );
+
+    std::vector<double> const& b0 = serial ["DYNAMIC_APERTURE_BOUNDARY"].column( "amplitude" );
+    std::vector<double> const& b1 = refined["DYNAMIC_APERTURE_BOUNDARY"].column( "amplitude" );
+
+    for ( int j=0; j<nangles; ++j ) {
+      if ( b0[j] != b1[j] ) {
+        cout << "*** ERROR *** With refinement, the boundary at angle " << j << " is "
+             << b1[j] << " instead of " << b0[j] << endl;
+        status = 1;
+      }
+      if ( !( b0[j] > 0.0 && b0[j] < amax ) ) {
+        cout << "*** ERROR *** The boundary at angle " << j << " is not within the scan: " << b0[j] << endl;
+        status = 1;
+      }
+    }
+
+    if ( ntracked >= namplitudes*nangles/2 ) {
+      cout << "*** ERROR *** Refinement tracked " << ntracked << " of " << namplitudes*nangles << " points." << endl;
+      status = 1;
+    }
+
+    delete ring;
+
+    // ---------------------------------------
+    // no apertures: particles escape
+    // ---------------------------------------
+
+    ring = makeRing( pr, false );
+
+    DynamicAperture open( *ring, pr );
+    open.setNumberOfThreads( nthreads );
+    open.setEscapeAmplitude( 0.1 );
+
+    LatticeFunctionTable grid;
+    open.cartesian( grid, nturns, -0.08, 0.08, 9, 0.0, 0.08, 5 );
+
+    LatticeFunctionTable::Table const& g = grid["DYNAMIC_APERTURE"];
+
+    int const center = 4*5;   // x = 0, y = 0
+    int const corner = 8*5+4; // x = 0.08, y = 0.08
+
+    if ( g.numRows() != 45 || g.column( "x" )[center] != 0.0 || g.integerColumn( "turns" )[center] != nturns
+         || g.integerColumn( "turns" )[corner] >= nturns
+         || g.integerColumn( "turns" )[corner] != survival( *ring, pr, 0.08, 0.08, nturns, 0.1 ) ) {
+      cout << "*** ERROR *** Without apertures, the centre of the grid must survive and its corner escape." << endl;
+      status = 1;
+    }
+
+    delete ring;
+  }
+  catch ( GenericException const& ge ) {
+    cout << "*** ERROR *** " << ge.what() << endl;
+    status = 1;
+  }
+
+  return status;
+}
@@ -0,0 +1,174 @@
+////////////////////////////////////////////////////////////
+//
+// File:          latticeFunctionTableTest.cc
+//
+////////////////////////////////////////////////////////////
+//
+// Checks the LatticeFunctionTable versions of the Optics
+// functions against the database versions.
+//
+// The periodic Courant-Snyder functions of a FODO ring are
+// propagated into a LatticeFunctionTable. The functions at
+// the end of the ring must be equal to the periodic ones;
+// after flushing the table, the database getters must return
+// the same values as the table getters, and so must the
+// database version of propagateCourantSnyder2D.
+//
+// ------------
+// COMMAND LINE
+// ------------
+// latticeFunctionTableTest [options]
+//
+// -------
+// OPTIONS
+// -------
+// Note: NNN represents an integer
+//
+// -cells   NNN   number of FODO cells
+//                : default = 12
+//
+////////////////////////////////////////////////////////////
+
+#include <iostream>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <cstdio>
+
+#include <basic_toolkit/GenericException.h>
+#include <beamline/beamline.h>
+#include <beamline/Drift.h>
+#include <beamline/quadrupole.h>
+#include <beamline/Particle.h>
+#include <beamline/JetParticle.h>
+#include <physics_toolkit/Optics.h>
+#include <physics_toolkit/LatticeFunctionTable.h>
+
+#include <sqlite/connection.hpp>
+
+using namespace std;
+
+namespace {
+
+bool same( std::vector<double> const& a, std::vector<double> const& b )
+{
+  return ( a.size() == b.size() ) && std::equal( a.begin(), a.end(), b.begin() );
+}
+
+} // anonymous namespace
+
+int main( int argc, char** argv )
+{
+  int ncells = 12;
+
+  for ( int i=1; i<argc; ++i ) {
+    if ( 0 == strcmp( argv[i], "-cells" ) && i+1 < argc ) { ncells = atoi( argv[++i] ); }
+  }
+
+  double const energy = 100.0;
+
+  createStandardEnvironments(1);
+
+  Proton pr( energy );
+
+  // ---------------------------------------
+  // FODO ring
+  // ---------------------------------------
+
+  Drift      O( "O", 5.0 );
+  quadrupole F( "F", 0.5,  0.1*pr.refBrho() );
+  quadrupole D( "D", 0.5, -0.1*pr.refBrho() );
+
+  beamline bml( "FODO" );
+  for ( int i=0; i<ncells; ++i ) {
+    bml.append( F );
+    bml.append( O );
+    bml.append( D );
+    bml.append( O );
+  }
+  bml.setLineMode( beamline::ring );
+
+  int const nelements = bml.countHowManyDeeply();
+
+  // ---------------------------------------
+  // Periodic solution
+  // ---------------------------------------
+
+  char const* const dbname = "latticeFunctionTableTest.db";
+  std::remove( dbname );
+
+  sqlite::connection db( dbname );
+  Optics::initdb( db );
+
+  JetProton oneturn( energy );
+  bml.propagate( oneturn );
+
+  CSLattFuncs lf = Optics::periodicCourantSnyder2D( db, oneturn );
+
+  int status = 0;
+
+  // ---------------------------------------
+  // Propagation into a table
+  // ---------------------------------------
+
+  LatticeFunctionTable lft;
+
+  Optics::orbit( lft, bml, JetProton( energy ) );
+  Optics::propagateCourantSnyder2D( lft, bml, JetProton( energy ), lf );
+
+  if (    int( Optics::beta_x   ( lft ).size() ) != nelements
+       || int( Optics::arclength( lft ).size() ) != nelements ) {
+    cout << "*** ERROR *** The table has " << Optics::beta_x( lft ).size()
+         << " rows; the ring has " << nelements << " elements." << endl;
+    return 1;
+  }
+
+  double const betax = Optics::beta_x( lft ).back();
+  double const betay = Optics::beta_y( lft ).back();
+
+  if (    std::abs( betax - lf.beta.hor ) > 1.0e-8*lf.beta.hor
+       || std::abs( betay - lf.beta.ver ) > 1.0e-8*lf.beta.ver ) {
+    cout << "*** ERROR *** The lattice functions are not periodic: "
+         << betax << " " << lf.beta.hor << ", " << betay << " " << lf.beta.ver << endl;
+    status = 1;
+  }
+
+  // ---------------------------------------
+  // Flushed table and database version
+  // ---------------------------------------
+
+  lft.flush( db );
+
+  if (    !same( Optics::beta_x   ( dbname ), Optics::beta_x   ( lft ) )
+       || !same( Optics::psi_y    ( dbname ), Optics::psi_y    ( lft ) )
+       || !same( Optics::eta_x    ( dbname ), Optics::eta_x    ( lft ) )
+       || !same( Optics::arclength( dbname ), Optics::arclength( lft ) ) ) {
+    cout << "*** ERROR *** The flushed database differs from the table." << endl;
+    status = 1;
+  }
+
+  Optics::propagateCourantSnyder2D( db, bml, JetProton( energy ), lf );
+
+  if (    !same( Optics::beta_y ( dbname ), Optics::beta_y ( lft ) )
+       || !same( Optics::alpha_x( dbname ), Optics::alpha_x( lft ) ) ) {
+    cout << "*** ERROR *** The database version of propagateCourantSnyder2D differs from the table version." << endl;
+    status = 1;
+  }
+
+  // ---------------------------------------
+  // Incomplete rows are not flushed
+  // ---------------------------------------
+
+  lft.define( "INCOMPLETE", "a b" ) << 1.0;
+
+  try {
+    lft.flush( db );
+    cout << "*** ERROR *** A table with an incomplete row was flushed." << endl;
+    status = 1;
+  }
+  catch ( GenericException const& ) {}
+
+  std::remove( dbname );
+
+  return status;
+}
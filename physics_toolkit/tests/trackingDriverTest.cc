@@ -0,0 +1,300 @@
+////////////////////////////////////////////////////////////
+//
+// File:          trackingDriverTest.cc
+//
+////////////////////////////////////////////////////////////
+//
+// Tracks a bunch of protons around a ring of FODO cells with
+// a TrackingDriver, observing the markers "BPM" of every
+// cell, and reads the turn-by-turn file back. The recorded
+// coordinates must be identical to those obtained by tracking
+// a copy of the bunch element by element, by hand.
+//
+// Checks also that
+//
+//  - a single particle and a BunchArrays give the same
+//    records as the ParticleBunch;
+//  - turns are appended by successive calls to track(), and
+//    the last, partial, chunk is read back correctly;
+//  - a file read while it is written holds the complete
+//    chunks written so far;
+//  - single precision files hold the values rounded to float;
+//  - the coordinates of a lost particle are NaN.
+//
+// ------------
+// COMMAND LINE
+// ------------
+// trackingDriverTest [options]
+//
+// -------
+// OPTIONS
+// -------
+// Note: NNN represents an integer
+//
+// -n       NNN   number of particles
+//                : default = 50
+// -turns   NNN   number of turns
+//                : default = 300
+// -chunk   NNN   turns per chunk
+//                : default = 64
+//
+////////////////////////////////////////////////////////////
+
+#include <iostream>
+#include <cstdlib>
+#include <cstring>
+#include <cstdio>
+#include <cmath>
+#include <vector>
+#include <string>
+
+#include <basic_toolkit/GenericException.h>
+#include <basic_toolkit/RandomStreams.h>
+#include <beamline/beamline.h>
+#include <beamline/Drift.h>
+#include <beamline/marker.h>
+#include <beamline/quadrupole.h>
+#include <beamline/sextupole.h>
+#include <beamline/Particle.h>
+#include <beamline/TBunch.h>
+#include <beamline/BunchArrays.h>
+#include <physics_toolkit/TrackingDriver.h>
+#include <physics_toolkit/TurnByTurnFile.h>
+
+using namespace std;
+
+namespace {
+
+bool isBPM( BmlnElmnt const& e )
+{
+  return 0 == strcmp( e.Name(), "BPM" );
+}
+
+//
+// Records of every turn, every BPM, every particle, tracked by hand.
+// values[ ( ( turn*npoints + point )*n + j )*6 + i ]
+//
+
+std::vector<double> reference( beamline const& ring, ParticleBunch const& initial, int nturns )
+{
+  ParticleBunch bunch( initial.getReferenceParticle() );
+  for ( ParticleBunch::const_iterator it = initial.begin(); it != initial.end(); ++it ) { bunch.append( *it ); }
+
+  beamline const flat = ring.flatten();
+
+  std::vector<double> values;
+
+  for ( int turn=0; turn<nturns; ++turn ) {
+    for ( beamline::const_iterator it = flat.begin(); it != flat.end(); ++it ) {
+      (*it)->propagate( bunch );
+      if ( !isBPM( **it ) ) continue;
+      for ( ParticleBunch::const_iterator jt = bunch.begin(); jt != bunch.end(); ++jt ) {
+        for ( int i=0; i<6; ++i ) { values.push_back( jt->isLost() ? NAN : jt->state()[i] ); }
+      }
+    }
+  }
+
+  return values;
+}
+
+//
+// Compares the file with the reference values; float: values rounded to single precision.
+//
+
+int compare( char const* label, std::string const& filename, std::vector<double> const& values,
+             int n, int npoints, int nturns, bool single = false )
+{
+  TurnByTurnReader in( filename );
+
+  if ( in.numTurns() != nturns || in.numParticles() != n || in.numObservationPoints() != npoints ) {
+    cout << "*** ERROR *** " << label << ": the file holds " << in.numTurns() << " turns of " << in.numParticles()
+         << " particles at " << in.numObservationPoints() << " points; " << nturns << ", " << n << " and "
+         << npoints << " were expected." << endl;
+    return 1;
+  }
+
+  std::vector<double> series( nturns );
+
+  for ( int k=0; k<npoints; ++k ) {
+    for ( int j=0; j<n; ++j ) {
+      for ( int i=0; i<6; ++i ) {
+
+        in.series( k, j, i, 0, nturns, &series[0] );
+
+        for ( int turn=0; turn<nturns; ++turn ) {
+          double expected = values[ ( ( std::size_t( turn )*npoints + k )*n + j )*6 + i ];
+          if ( single ) { expected = float( expected ); }
+          double const v = series[turn];
+          if ( !( v == expected || ( std::isnan( v ) && std::isnan( expected ) ) ) ) {
+            cout << "*** ERROR *** " << label << ": turn " << turn << ", point " << k << ", particle " << j
+                 << ", coordinate " << i << ": " << v << " was recorded; " << expected << " was expected." << endl;
+            return 1;
+          }
+        }
+      }
+    }
+  }
+
+  return 0;
+}
+
+} // anonymous namespace
+
+int main( int argc, char** argv )
+{
+  int n      = 50;
+  int nturns = 300;
+  int nchunk = 64;
+
+  for ( int i=1; i<argc; ++i ) {
+    if      ( 0 == strcmp( argv[i], "-n"     ) && i+1 < argc ) { n      = atoi( argv[++i] ); }
+    else if ( 0 == strcmp( argv[i], "-turns" ) && i+1 < argc ) { nturns = atoi( argv[++i] ); }
+    else if ( 0 == strcmp( argv[i], "-chunk" ) && i+1 < argc ) { nchunk = atoi( argv[++i] ); }
+  }
+
+  Proton pr( 100.0 );
+  double const brho = pr.refBrho();
+
+  Drift      O  ( "O",  1.5 );
+  quadrupole F  ( "F",  0.5,  0.12*brho );
+  quadrupole D  ( "D",  0.5, -0.12*brho );
+  sextupole  S  ( "S",  0.2,  2.0*brho );
+  marker     BPM( "BPM" );
+
+  int const ncells = 6;
+
+  beamline ring( "RING" );
+  for ( int i=0; i<ncells; ++i ) {
+    beamline cell( "CELL" );
+    cell.append( F ); cell.append( O ); cell.append( BPM ); cell.append( S ); cell.append( O );
+    cell.append( D ); cell.append( O ); cell.append( O );
+    ring.append( cell );
+  }
+  ring.setLineMode( beamline::ring );
+
+  ParticleBunch bunch( pr );
+
+  RandomStream rnd( 4242 );
+
+  for ( int j=0; j<n; ++j ) {
+    Proton p( pr );
+    p.x   ( 2.0e-3*( 2.0*rnd() - 1.0 ) );
+    p.y   ( 2.0e-3*( 2.0*rnd() - 1.0 ) );
+    p.npx ( 1.0e-4*( 2.0*rnd() - 1.0 ) );
+    p.ndp ( 1.0e-3*( 2.0*rnd() - 1.0 ) );
+    bunch.append( p );
+  }
+
+  bunch.begin()->setLost( true );   // the kicks do not depend on the loss flag
+
+  std::vector<double> const values = reference( ring, bunch, nturns );
+
+  std::string const fname = "trackingDriverTest.tbt";
+
+  int status = 0;
+
+  try {
+
+    TrackingDriver driver( ring );
+
+    if ( driver.observe( &isBPM ) != ncells || std::abs( driver.azimuths()[1] - driver.azimuths()[0] - ring.Length()/ncells ) > 1.0e-12 ) {
+      cout << "*** ERROR *** The BPMs were not all found, or are at the wrong azimuths." << endl;
+      status = 1;
+    }
+
+    // ---------------------------------------
+    // bunch, in two calls; the file is read
+    // while it is written
+    // ---------------------------------------
+
+    {
+      ParticleBunch b( pr );
+      for ( ParticleBunch::const_iterator it = bunch.begin(); it != bunch.end(); ++it ) { b.append( *it ); }
+
+      TurnByTurnWriter out( fname, n, driver.names(), driver.azimuths(), TurnByTurnFile::double_precision, nchunk );
+
+      int const first = nturns/2;
+
+      driver.track( b, first, out );
+
+      TurnByTurnReader partial( fname );
+
+      if ( partial.numTurns() != ( first/nchunk )*nchunk ) {
+        cout << "*** ERROR *** A file being written holds " << partial.numTurns() << " turns; "
+             << ( first/nchunk )*nchunk << " complete turns were written." << endl;
+        status = 1;
+      }
+
+      if ( driver.track( b, nturns - first, out ) != nturns ) {
+        cout << "*** ERROR *** The writer did not count " << nturns << " turns." << endl;
+        status = 1;
+      }
+    }
+
+    status |= compare( "ParticleBunch", fname, values, n, ncells, nturns );
+
+    // ---------------------------------------
+    // BunchArrays, single precision
+    // ---------------------------------------
+
+    {
+      BunchArrays b( bunch );
+      TurnByTurnWriter out( fname, n, driver.names(), driver.azimuths(), TurnByTurnFile::single_precision, nchunk );
+      driver.track( b, nturns, out );
+    }
+
+    status |= compare( "BunchArrays, single precision", fname, values, n, ncells, nturns, true );
+
+    // ---------------------------------------
+    // single particle, default chunk size
+    // ---------------------------------------
+
+    {
+      Particle p( *( bunch.begin() + 1 ) );
+      TurnByTurnWriter out( fname, 1, driver.names(), driver.azimuths() );
+      driver.track( p, nturns, out );
+    }
+
+    {
+      std::vector<double> one;
+      for ( std::size_t v = 0; v < values.size(); v += 6*n ) {
+        one.insert( one.end(), values.begin() + v + 6, values.begin() + v + 12 );
+      }
+      status |= compare( "Particle", fname, one, 1, ncells, nturns );
+    }
+
+    // ---------------------------------------
+    // names and errors
+    // ---------------------------------------
+
+    TurnByTurnReader in( fname );
+
+    if ( in.name( 2 ) != "BPM" || in.index( "BPM" ) != 0 || in.index( "QF" ) != -1 || in.azimuth( 3 ) != driver.azimuths()[3] ) {
+      cout << "*** ERROR *** The observation points were not read back." << endl;
+      status = 1;
+    }
+
+    bool thrown = false;
+    try {
+      ParticleBunch b( pr );
+      TurnByTurnWriter out( fname, n + 1, driver.names(), driver.azimuths() );
+      driver.track( bunch, 1, out );
+    }
+    catch ( GenericException const& ) {
+      thrown = true;
+    }
+
+    if ( !thrown ) {
+      cout << "*** ERROR *** A bunch of the wrong size was recorded." << endl;
+      status = 1;
+    }
+  }
+  catch ( GenericException const& ge ) {
+    cout << "*** ERROR *** " << ge.what() << endl;
+    status = 1;
+  }
+
+  remove( fname.c_str() );
+
+  return status;
+}
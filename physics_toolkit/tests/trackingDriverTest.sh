@@ -0,0 +1,15 @@
+#!/bin/csh
+
+./trackingDriverTest
+set return_status = $status
+if( 0 != $return_status ) then
+  exit $return_status
+  endif
+
+./trackingDriverTest -n 3 -turns 1000 -chunk 1
+set return_status = $status
+if( 0 != $return_status ) then
+  exit $return_status
+  endif
+
+exit 0
@@ -0,0 +1,350 @@
+////////////////////////////////////////////////////////////
+//
+// File:          transferMatrixCacheTest.cc
+//
+////////////////////////////////////////////////////////////
+//
+// Checks that a TransferMatrixCache recomputes only what an
+// element modification affects, and that the results agree
+// with a full Jet propagation.
+//
+// A FODO ring is cached, then
+//
+//  - the strength of one quadrupole is changed: exactly one
+//    element matrix must be recomputed;
+//  - one quadrupole is displaced: the orbit moves, and every
+//    element downstream must be recomputed;
+//  - thin corrector and multipole setters are called: each must
+//    count as a modification, and a copy of an element must not
+//    be mistaken for the original;
+//  - a quadrupole strength is changed under a BeamlineContext:
+//    the tunes must match those of a fresh context.
+//
+// After each step, the one-turn matrix, the Courant-Snyder
+// functions, the dispersion and the chromaticities computed
+// from the cache are compared with the ones obtained by
+// propagating a JetParticle around the ring.
+//
+// ------------
+// COMMAND LINE
+// ------------
+// transferMatrixCacheTest [options]
+//
+// -------
+// OPTIONS
+// -------
+// Note: NNN represents an integer
+//
+// -cells   NNN   number of FODO cells
+//                : default = 12
+//
+////////////////////////////////////////////////////////////
+
+#include <iostream>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+
+#include <basic_toolkit/GenericException.h>
+#include <beamline/beamline.h>
+#include <beamline/Drift.h>
+#include <beamline/quadrupole.h>
+#include <beamline/kick.h>
+#include <beamline/gkick.h>
+#include <beamline/thinMultipole.h>
+#include <beamline/Particle.h>
+#include <beamline/JetParticle.h>
+#include <physics_toolkit/Optics.h>
+#include <physics_toolkit/LatticeFunctionTable.h>
+#include <physics_toolkit/TransferMatrixCache.h>
+#include <physics_toolkit/BeamlineContext.h>
+
+#include <sqlite/connection.hpp>
+
+using namespace std;
+
+namespace {
+
+double maxdiff( MatrixD const& a, MatrixD const& b )
+{
+  double d = 0.0;
+  for ( int i=0; i<6; ++i ) {
+    for ( int j=0; j<6; ++j ) {
+      d = std::max( d, std::abs( a[i][j] - b[i][j] ) );
+    }
+  }
+  return d;
+}
+
+double maxdiff( std::vector<double> const& a, std::vector<double> const& b )
+{
+  if ( a.size() != b.size() ) return 1.0e30;
+
+  double d = 0.0;
+  for ( unsigned int i=0; i<a.size(); ++i ) {
+    d = std::max( d, std::abs( a[i] - b[i] )/std::max( 1.0, std::abs(b[i]) ) );
+  }
+  return d;
+}
+
+//
+// Compares the cache with a full propagation around bml.
+//
+
+int check( char const* step, beamline const& bml, TransferMatrixCache const& cache, sqlite::connection& db, double energy )
+{
+  int status = 0;
+
+  JetProton oneturn( energy );
+  bml.propagate( oneturn );
+
+  double const dm = maxdiff( cache.oneTurn(), oneturn.state().jacobian() );
+
+  if ( dm > 1.0e-10 ) {
+    cout << "*** ERROR *** " << step << ": the one-turn matrices differ by " << dm << endl;
+    status = 1;
+  }
+
+  CSLattFuncs lf = Optics::periodicCourantSnyder2D( db, cache.oneTurnJetParticle() );
+
+  LatticeFunctionTable full;
+  LatticeFunctionTable cached;
+
+  Optics::propagateCourantSnyder2D( full, bml, JetProton( energy ), lf );
+  cache.propagateCourantSnyder2D( cached, lf );
+
+  double const dbeta = std::max( maxdiff( Optics::beta_x( cached ), Optics::beta_x( full ) ),
+                                 maxdiff( Optics::beta_y( cached ), Optics::beta_y( full ) ) );
+  double const dp = std::max( maxdiff( Optics::psi_x ( cached ), Optics::psi_x ( full ) ),
+                              maxdiff( Optics::psi_y ( cached ), Optics::psi_y ( full ) ) );
+
+  if ( dbeta > 1.0e-10 || dp > 1.0e-10 ) {
+    cout << "*** ERROR *** " << step << ": the Courant-Snyder functions differ by "
+         << dbeta << " (beta), " << dp << " (psi)" << endl;
+    status = 1;
+  }
+
+  // an arbitrary initial dispersion; the ring has no bends
+
+  Vector eta0(6);
+  eta0[Particle::i_x  ] =  1.5;
+  eta0[Particle::i_npx] = -0.1;
+
+  LatticeFunctionTable full_eta;
+  LatticeFunctionTable cached_eta;
+
+  Optics::propagateDispersion( full_eta, bml, JetProton( energy ), eta0 );
+  cache.propagateDispersion( cached_eta, eta0 );
+
+  double const deta = std::max( maxdiff( Optics::eta_x ( cached_eta ), Optics::eta_x ( full_eta ) ),
+                                maxdiff( Optics::etap_x( cached_eta ), Optics::etap_x( full_eta ) ) );
+
+  if ( deta > 1.0e-10 ) {
+    cout << "*** ERROR *** " << step << ": the dispersion functions differ by " << deta << endl;
+    status = 1;
+  }
+
+  TransferMatrixCache offmomentum;
+
+  Vector const chroma        = Optics::chromaticity( db,              bml, oneturn, eta0 );
+  Vector const cached_chroma = Optics::chromaticity( db, offmomentum, bml, oneturn, eta0 );
+
+  double const dc = std::max( std::abs( cached_chroma[0] - chroma[0] ), std::abs( cached_chroma[1] - chroma[1] ) );
+
+  if ( dc > 1.0e-6 ) {
+    cout << "*** ERROR *** " << step << ": the chromaticities differ by " << dc << endl;
+    status = 1;
+  }
+
+  return status;
+}
+
+} // anonymous namespace
+
+int main( int argc, char** argv )
+{
+  int ncells = 12;
+
+  for ( int i=1; i<argc; ++i ) {
+    if ( 0 == strcmp( argv[i], "-cells" ) && i+1 < argc ) { ncells = atoi( argv[++i] ); }
+  }
+
+  double const energy = 100.0;
+
+  createStandardEnvironments(1);
+
+  Proton pr( energy );
+
+  // ---------------------------------------
+  // FODO ring
+  // ---------------------------------------
+
+  Drift      O( "O", 5.0 );
+  quadrupole F( "F", 0.5,  0.1*pr.refBrho() );
+  quadrupole D( "D", 0.5, -0.1*pr.refBrho() );
+
+  beamline bml( "FODO" );
+  for ( int i=0; i<ncells; ++i ) {
+    bml.append( F );
+    bml.append( O );
+    bml.append( D );
+    bml.append( O );
+  }
+  bml.setLineMode( beamline::ring );
+
+  int const nelements = bml.countHowManyDeeply();
+
+  sqlite::connection db( ":memory:" );
+  Optics::initdb( db );
+
+  int status = 0;
+
+  // ---------------------------------------
+  // Initial fill
+  // ---------------------------------------
+
+  TransferMatrixCache cache;
+
+  if ( cache.update( bml, pr ) != nelements ) {
+    cout << "*** ERROR *** The initial update did not compute every element." << endl;
+    status = 1;
+  }
+
+  if ( cache.update( bml, pr ) != 0 ) {
+    cout << "*** ERROR *** An update of an unmodified ring recomputed "
+         << cache.numRecomputed() << " elements." << endl;
+    status = 1;
+  }
+
+  status |= check( "initial", bml, cache, db, energy );
+
+  // ---------------------------------------
+  // Strength change
+  // ---------------------------------------
+
+  int const k = nelements/2 + 2;   // a D quadrupole
+
+  beamline::deep_iterator it = bml.deep_begin();
+  for ( int i=0; i<k; ++i ) { ++it; }
+
+  (*it)->setStrength( 1.02*(*it)->Strength() );
+
+  if ( cache.update( bml, pr ) != 1 || cache.firstChanged() != k ) {
+    cout << "*** ERROR *** After a strength change, " << cache.numRecomputed()
+         << " elements were recomputed starting at " << cache.firstChanged()
+         << "; expected 1 starting at " << k << "." << endl;
+    status = 1;
+  }
+
+  status |= check( "strength change", bml, cache, db, energy );
+
+  // ---------------------------------------
+  // Displacement: the orbit moves downstream
+  // ---------------------------------------
+
+  Vector translation(3);
+  translation[0] = 1.0e-3;
+
+  (*it)->setAlignment( translation, Vector(3) );
+
+  if ( cache.update( bml, pr ) != nelements - k || cache.firstChanged() != k ) {
+    cout << "*** ERROR *** After a displacement, " << cache.numRecomputed()
+         << " elements were recomputed starting at " << cache.firstChanged()
+         << "; expected " << nelements - k << " starting at " << k << "." << endl;
+    status = 1;
+  }
+
+  Particle probe( pr );
+  bml.propagate( probe );
+
+  if ( std::abs( probe.x() - cache.particle( nelements-1 ).x() ) > 1.0e-15 ) {
+    cout << "*** ERROR *** The cached orbit differs from the propagated one." << endl;
+    status = 1;
+  }
+
+  // ---------------------------------------
+  // Setters of thin elements; copies
+  // ---------------------------------------
+
+  kick          vk( "K", 1.0e-5, 1.0e-5 );
+  gkick         gk;
+  thinMultipole tm( "TM" );
+
+  beamline thin( "THIN" );
+  thin.append( O );
+  thin.append( vk );
+  thin.append( gk );
+  thin.append( tm );
+  thin.append( O );
+
+  TransferMatrixCache thincache;
+  thincache.update( thin, pr );
+
+  beamline::deep_iterator tit = thin.deep_begin();
+  ++tit;
+  boost::static_pointer_cast<kick>( *tit )->setVerStrength( 2.0e-5 );
+
+  if ( thincache.update( thin, pr ) != 4 || thincache.firstChanged() != 1 ) {
+    cout << "*** ERROR *** kick::setVerStrength was not seen as a modification." << endl;
+    status = 1;
+  }
+
+  ++tit;
+  boost::static_pointer_cast<gkick>( *tit )->set_dx( 1.0e-4 );
+
+  if ( thincache.update( thin, pr ) != 3 || thincache.firstChanged() != 2 ) {
+    cout << "*** ERROR *** gkick::set_dx was not seen as a modification." << endl;
+    status = 1;
+  }
+
+  ++tit;
+  boost::static_pointer_cast<thinMultipole>( *tit )->setPole( 2, std::complex<double>( 0.1, 0.0 ) );
+
+  if ( thincache.update( thin, pr ) != 1 || thincache.firstChanged() != 3 ) {
+    cout << "*** ERROR *** thinMultipole::setPole was not seen as a modification." << endl;
+    status = 1;
+  }
+
+  ElmPtr copy( (*tit)->clone() );
+
+  if ( copy->serial() == (*tit)->serial() ) {
+    cout << "*** ERROR *** A copy has the serial number of its original." << endl;
+    status = 1;
+  }
+
+  // ---------------------------------------
+  // BeamlineContext: tunes after a change
+  // ---------------------------------------
+
+  (*it)->setAlignment( Vector(3), Vector(3) );    // back on axis
+  bml.setMomentum( pr.refMomentum() );            // the context takes its momentum from the line
+
+  BeamlineContext context( pr, bml );             // holds a copy of the line
+  double const htune0 = context.getHTune();
+
+  beamline::deep_iterator cit = context.deep_begin();
+  for ( int i=0; i<k; ++i ) { ++cit; }
+
+  (*cit)->setStrength( 0.98*(*cit)->Strength() );
+  context.clear();
+
+  double const htune = context.getHTune();
+  double const vtune = context.getVTune();
+
+  BeamlineContext fresh( pr, context );
+
+  if ( std::abs( htune - htune0 ) < 1.0e-6 ) {
+    cout << "*** ERROR *** The tune of a context did not change with a quadrupole strength." << endl;
+    status = 1;
+  }
+
+  double const dt = std::max( std::abs( htune - fresh.getHTune() ), std::abs( vtune - fresh.getVTune() ) );
+
+  if ( dt > 1.0e-10 ) {
+    cout << "*** ERROR *** After a strength change, the tunes of a context differ from those of a fresh one by "
+         << dt << endl;
+    status = 1;
+  }
+
+  return status;
+}
@@ -0,0 +1,47 @@
+/***************************************************************************
+******  Boost.python Python bindings for mxyzpltk/beamline libraries
+******
+******
+******  File:      py-gil.h
+******
+******  Copyright Fermi Research Alliance / Fermilab
+******            All Rights Reserved
+******
+******  Software and documentation created under
+******  U.S. Department of Energy Contract No. DE-AC02-07CH11359
+******  The U.S. Government retains a world-wide non-exclusive,
+******  royalty-free license to publish or reproduce documentation
+******  and software for U.S. Government purposes. This software
+******  is protected under the U.S.and Foreign Copyright Laws.
+******
+****************************************************************************/
+#ifndef PY_GIL_H
+#define PY_GIL_H
+
+#include <Python.h>
+
+//
+// Releases the Python global interpreter lock for the lifetime of the
+// object, so that other Python threads run while a long computation
+// (e.g. tracking a bunch) proceeds in C++. The code executed in the scope
+// must not touch any Python object, including the arguments of the
+// wrapped function, other than through the C++ references extracted
+// before the lock was released.
+//
+
+class ScopedGILRelease {
+
+ public:
+
+  ScopedGILRelease()  : state_( PyEval_SaveThread() ) {}
+ ~ScopedGILRelease()                                  { PyEval_RestoreThread( state_ ); }
+
+ private:
+
+  ScopedGILRelease( ScopedGILRelease const& );
+  ScopedGILRelease& operator=( ScopedGILRelease const& );
+
+  PyThreadState* state_;
+};
+
+#endif // PY_GIL_H
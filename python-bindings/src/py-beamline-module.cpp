@@ -37,6 +37,7 @@ extern void wrap_BmlnElmnt();
 extern void wrap_beamline();
 extern void wrap_particle();
 extern void wrap_jetparticle();
+extern void wrap_buncharrays();
 
 extern void wrap_bblens();
 extern void wrap_cf_rbend();
@@ -74,6 +75,7 @@ wrap_BmlnElmnt();
 wrap_beamline();
 wrap_particle();
 wrap_jetparticle();
+wrap_buncharrays();
 wrap_bmlvisitor(); 
 wrap_bblens();
 wrap_cf_rbend();
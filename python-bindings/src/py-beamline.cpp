@@ -38,6 +38,8 @@
 #include <beamline/TBunch.h>
 #include <beamline/BmlVisitor.h>
 #include <beamline/beamline.h>
+#include <beamline/BunchArrays.h>
+#include <python-bindings/py-gil.h>
 #include <list>
 
 class PropFunc;
@@ -85,7 +87,21 @@ indirect_reverse_deep_iterator        indirect_rdeep_end( beamline& bml )  { ret
 
 void (beamline::*beamline_propagateParticle)     (Particle&      ) const =  &beamline::propagate;
 void (beamline::*beamline_propagateJetParticle)  (JetParticle&   ) const =  &beamline::propagate;
-void (beamline::*beamline_propagateParticleBunch)(ParticleBunch& ) const =  &beamline::propagate;
+
+// bunches are tracked without the interpreter lock, so that other Python threads
+// (e.g. analysis of the previous turn) run concurrently
+
+void beamline_propagateParticleBunch( beamline const& bml, ParticleBunch& b ) 
+{
+  ScopedGILRelease nogil;
+  bml.propagate( b );
+}
+
+void beamline_propagateBunchArrays( beamline const& bml, BunchArrays& b ) 
+{
+  ScopedGILRelease nogil;
+  bml.propagate( b );
+}
 
 void (beamline::*insert1) (  ElmPtr )                              =  &beamline::insert;
 void (beamline::*append1) (  ElmPtr )                              =  &beamline::append;
@@ -173,6 +189,11 @@ beamline_.def("reverse_deep_iterator",
  beamline_.def("propagateParticle",      beamline_propagateParticle);
  beamline_.def("propagateJetParticle",   beamline_propagateJetParticle);
  beamline_.def("propagateParticleBunch", beamline_propagateParticleBunch);
+ beamline_.def("propagateBunchArrays",   beamline_propagateBunchArrays);
+ beamline_.def("setNumberOfThreads",     &beamline::setNumberOfThreads);
+ beamline_.staticmethod("setNumberOfThreads");
+ beamline_.def("numberOfThreads",        &beamline::numberOfThreads);
+ beamline_.staticmethod("numberOfThreads");
 
  beamline_.def("setMomentum",    &beamline::setMomentum);
 
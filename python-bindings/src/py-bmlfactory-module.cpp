@@ -27,6 +27,7 @@
 
 #include <bmlfactory/MAD8Factory.h>
 #include <parsers/xsif/XSIFFactory.h>
+#include <bmlfactory/LatticeCache.h>
 #include <beamline/beamline.h>
 #include <string>
 
@@ -58,4 +59,21 @@ class_<XSIFFactory, bases<bmlfactory> >("XSIFFactory", init<std::string, const c
   .def( init<std::string>() ) 
   .def( init<std::string, double>() );
 
+
+class_<LatticeCache>("LatticeCache", no_init)
+  .def("create_mad8_beamline",  &LatticeCache::create_beamline<MAD8Factory> )
+  .staticmethod("create_mad8_beamline")
+  .def("create_xsif_beamline",  &LatticeCache::create_beamline<XSIFFactory> )
+  .staticmethod("create_xsif_beamline")
+  .def("setDirectory",          &LatticeCache::setDirectory )
+  .staticmethod("setDirectory")
+  .def("directory",             &LatticeCache::directory )
+  .staticmethod("directory")
+  .def("clear",                 &LatticeCache::clear )
+  .staticmethod("clear")
+  .def("hits",                  &LatticeCache::hits )
+  .staticmethod("hits")
+  .def("misses",                &LatticeCache::misses )
+  .staticmethod("misses");
+
 }
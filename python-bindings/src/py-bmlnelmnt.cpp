@@ -31,6 +31,8 @@
 #include <beamline/ParticleBunch.h>
 #include <beamline/TBunch.h>
 #include <beamline/BmlnElmnt.h>
+#include <beamline/BunchArrays.h>
+#include <python-bindings/py-gil.h>
 
 
 class PropFunc;
@@ -41,7 +43,18 @@ namespace {
 
 void   (BmlnElmnt::*propagate_particle     )  (      Particle&   ) const = &BmlnElmnt::propagate;
 void   (BmlnElmnt::*propagate_jetparticle  )  (   JetParticle&   ) const = &BmlnElmnt::propagate;
-void   (BmlnElmnt::*propagate_bunch        )  ( ParticleBunch&   ) const = &BmlnElmnt::propagate;
+
+void propagate_bunch( BmlnElmnt const& elm, ParticleBunch& b )
+{
+  ScopedGILRelease nogil;
+  elm.propagate( b );
+}
+
+void propagate_buncharrays( BmlnElmnt const& elm, BunchArrays& b )
+{
+  ScopedGILRelease nogil;
+  elm.propagate( b );
+}
 
 void   (BmlnElmnt::* setStrength1)               (double const&  )        =  &BmlnElmnt::setStrength;
 void   (BmlnElmnt::* enterLocalFrame_particle)   (     Particle& )  const =  &BmlnElmnt::enterLocalFrame; 
@@ -65,6 +78,7 @@ void wrap_BmlnElmnt() {
     .def("propagate",                     propagate_particle      )
     .def("propagate",                     propagate_jetparticle   )
     .def("propagate",                     propagate_bunch         )
+    .def("propagate",                     propagate_buncharrays   )
     .def("getTag",                        &BmlnElmnt::getTag      )
     .def("setTag",                        &BmlnElmnt::setTag      )
      /****  virtual functions ***/ 
@@ -0,0 +1,378 @@
+/***************************************************************************
+****************************************************************************
+****************************************************************************
+******
+******  Python bindings for mxyzpltk/beamline libraries
+******
+******  File:      py-buncharrays.cpp
+******
+******  Copyright Fermi Research Alliance / Fermilab
+******            All Rights Reserved
+******
+******  Software and documentation created under
+******  U.S. Department of Energy Contract No. DE-AC02-07CH11359
+******  The U.S. Government retains a world-wide non-exclusive,
+******  royalty-free license to publish or reproduce documentation
+******  and software for U.S. Government purposes. This software
+******  is protected under the U.S.and Foreign Copyright Laws.
+******
+****************************************************************************
+****************************************************************************
+****************************************************************************/
+
+//
+// The coordinates of a BunchArrays are exported to NumPy without copying,
+// through the array interface protocol (__array_interface__):
+//
+//   b = BunchArrays( Proton(), 1000000 )
+//   x = numpy.asarray( b.coordinates() )    # (N,6) view, x[j,i] = coordinate i of particle j
+//   m = numpy.asarray( b.alive() )          # (N,) uint8 survival mask
+//
+// The view shares the storage of the bunch, which it keeps alive. Since the
+// coordinate arrays of a BunchArrays are contiguous, the view is strided
+// (x[:,i] is contiguous). The views of a bunch are counted: as long as one
+// of them (or an array made from it) exists, the calls that would reallocate
+// the storage (reserve and resize beyond the capacity, setCoordinates with
+// more particles than the capacity) or move particles (compact) raise an
+// exception instead. The arrays must be deleted first, and the views
+// obtained again afterwards. After a resize within the capacity or a clear,
+// the shape of an existing view is stale, but its memory remains valid.
+//
+// setCoordinates( a ) fills the bunch from an (N,6) float64 array, or from
+// any object exposing the array interface, with a single pass over its
+// memory. A sequence of 6-sequences is also accepted (slowly). An array that
+// shares memory with the bunch itself (e.g. a slice of its own coordinates)
+// is copied to a temporary first.
+//
+// No NumPy header or library is needed to build these bindings.
+//
+
+#include <boost/python.hpp>
+
+#include <beamline/Particle.h>
+#include <beamline/BunchArrays.h>
+#include <python-bindings/py-exception.h>
+#include <python-bindings/py-gil.h>
+
+#include <string>
+#include <cstddef>
+#include <map>
+#include <vector>
+#include <algorithm>
+
+using namespace boost::python;
+
+//-----------------------------------------------------------------------------------------------
+// locally defined classes and functions
+//-----------------------------------------------------------------------------------------------
+
+namespace {
+
+int const dim = PhaseSpaceIndexing::BMLN_dynDim;
+
+bool littleEndian()
+{
+  union { int i; char c[sizeof(int)]; } u;
+  u.i = 1;
+  return u.c[0] == 1;
+}
+
+//
+// no of live views on the storage of each bunch. Views are created and destroyed
+// with the interpreter lock held.
+//
+
+std::map<BunchArrays const*, int> views;
+
+void checkNoViews( BunchArrays const& b, char const* operation )
+{
+  std::map<BunchArrays const*, int>::const_iterator it = views.find( &b );
+
+  if ( it != views.end() ) {
+    throw PyBindingsException( std::string( "BunchArrays." ) + operation
+          + ": the coordinates or the survival mask of the bunch are exported to an array;"
+          + " the array must be deleted first." );
+  }
+}
+
+void checkCapacity( BunchArrays const& b, int n, char const* operation )   // b must not grow while views exist
+{
+  if ( n > b.stride() ) { checkNoViews( b, operation ); }
+}
+
+//
+// A strided view on the storage of a BunchArrays. Either one dimensional (the survival
+// mask) or two dimensional (the coordinates).
+//
+
+class ArrayView {
+
+ public:
+
+  ArrayView( BunchArrays const& owner, void* data, std::string const& typestr, int n, int itemsize, int colstride )
+    : owner_(&owner), data_(data), typestr_(typestr), n_(n), itemsize_(itemsize), colstride_(colstride)
+  { ++views[owner_]; }
+
+  ArrayView( ArrayView const& o )
+    : owner_(o.owner_), data_(o.data_), typestr_(o.typestr_), n_(o.n_), itemsize_(o.itemsize_), colstride_(o.colstride_)
+  { ++views[owner_]; }
+
+ ~ArrayView() { release(); }
+
+  ArrayView& operator=( ArrayView const& o )
+  {
+    if ( this == &o ) return *this;
+    release();
+    owner_     = o.owner_;
+    data_      = o.data_;
+    typestr_   = o.typestr_;
+    n_         = o.n_;
+    itemsize_  = o.itemsize_;
+    colstride_ = o.colstride_;
+    ++views[owner_];
+    return *this;
+  }
+
+  dict arrayInterface() const
+  {
+    dict d;
+    d["version"] = 3;
+    d["typestr"] = typestr_;
+    d["data"]    = make_tuple( reinterpret_cast<std::size_t>( data_ ), false );
+
+    if ( colstride_ == 0 ) {
+      d["shape"]   = make_tuple( n_ );
+      d["strides"] = make_tuple( itemsize_ );
+    }
+    else {
+      d["shape"]   = make_tuple( n_, dim );
+      d["strides"] = make_tuple( itemsize_, colstride_ );
+    }
+    return d;
+  }
+
+  int  size() const { return n_; }
+
+ private:
+
+  void release()
+  {
+    std::map<BunchArrays const*, int>::iterator it = views.find( owner_ );
+    if ( --(it->second) == 0 ) { views.erase( it ); }
+  }
+
+  BunchArrays const*  owner_;
+  void*        data_;
+  std::string  typestr_;
+  int          n_;
+  int          itemsize_;
+  int          colstride_;    // bytes; 0 for a one dimensional view
+};
+
+ArrayView coordinates( BunchArrays& b )
+{
+  return ArrayView( b, b[0], littleEndian() ? "<f8" : ">f8", b.size(), sizeof(double), b.stride()*sizeof(double) );
+}
+
+ArrayView alive( BunchArrays& b )
+{
+  return ArrayView( b, b.alive(), "|u1", b.size(), sizeof(unsigned char), 0 );
+}
+
+//
+// storage operations; the python calls check for exported views
+//
+
+void reserve( BunchArrays& b, int n )
+{
+  checkCapacity( b, n, "reserve" );
+  b.reserve( n );
+}
+
+void resize( BunchArrays& b, int n )
+{
+  checkCapacity( b, n, "resize" );
+  b.resize( n );
+}
+
+void compact( BunchArrays& b )
+{
+  checkNoViews( b, "compact" );
+  b.compact();
+}
+
+//
+// bulk import
+//
+
+void setCoordinatesFromSequence( BunchArrays& b, object const& a )
+{
+  int const n = len( a );
+
+  checkCapacity( b, n, "setCoordinates" );
+
+  b.resize( 0 );
+  b.resize( n );
+
+  for ( int j=0; j<n; ++j ) {
+
+    object const row = a[j];
+
+    if ( len( row ) != dim ) {
+      throw PyBindingsException( "BunchArrays.setCoordinates: each particle must have 6 coordinates." );
+    }
+    for ( int i=0; i<dim; ++i ) { b[i][j] = extract<double>( row[i] ); }
+  }
+}
+
+void setCoordinates( BunchArrays& b, object const& a )
+{
+  if ( !PyObject_HasAttrString( a.ptr(), "__array_interface__" ) ) {
+    setCoordinatesFromSequence( b, a );
+    return;
+  }
+
+  dict const ai = extract<dict>( a.attr("__array_interface__") );
+
+  std::string const typestr = extract<std::string>( ai["typestr"] );
+
+  if ( typestr != ( littleEndian() ? "<f8" : ">f8" ) ) {
+    throw PyBindingsException( "BunchArrays.setCoordinates: the array must be of type float64, in native byte order." );
+  }
+
+  tuple const shape = extract<tuple>( ai["shape"] );
+
+  if ( len( shape ) != 2 || extract<int>( shape[1] ) != dim ) {
+    throw PyBindingsException( "BunchArrays.setCoordinates: the array must be of shape (N,6)." );
+  }
+
+  if ( ai.has_key( "mask" ) && object( ai["mask"] ).ptr() != Py_None ) {
+    throw PyBindingsException( "BunchArrays.setCoordinates: masked arrays are not supported." );
+  }
+
+  int const n = extract<int>( shape[0] );
+
+  std::ptrdiff_t rowstride = dim*sizeof(double);   // bytes; C-contiguous unless strides are given
+  std::ptrdiff_t colstride = sizeof(double);
+
+  if ( ai.has_key( "strides" ) && object( ai["strides"] ).ptr() != Py_None ) {
+    tuple const strides = extract<tuple>( ai["strides"] );
+    rowstride = extract<std::ptrdiff_t>( strides[0] );
+    colstride = extract<std::ptrdiff_t>( strides[1] );
+  }
+
+  object const data = ai["data"];
+
+  if ( !PyTuple_Check( data.ptr() ) ) {
+    throw PyBindingsException( "BunchArrays.setCoordinates: the array does not expose a data pointer." );
+  }
+
+  char const* base = reinterpret_cast<char const*>( static_cast<std::size_t>( extract<std::size_t>( data[0] ) ) );
+
+  checkCapacity( b, n, "setCoordinates" );
+
+  // the bunch is cleared before the copy: an array that overlaps its storage
+  // (e.g. a slice of b.coordinates()) is first copied to a temporary.
+
+  std::vector<double> temporary;
+
+  if ( n > 0 ) {
+
+    char const* first = base;
+    char const* last  = base;
+
+    std::ptrdiff_t const offsets[] = { (n-1)*rowstride, (dim-1)*colstride };
+    for ( int k=0; k<2; ++k ) {
+      if ( offsets[k] < 0 ) { first += offsets[k]; } else { last += offsets[k]; }
+    }
+    last += sizeof(double);
+
+    char const* const data_first  = reinterpret_cast<char const*>( b[0] );
+    char const* const data_last   = reinterpret_cast<char const*>( b[0] + dim*b.stride() );
+    char const* const alive_first = reinterpret_cast<char const*>( b.alive() );
+    char const* const alive_last  = alive_first + b.stride();
+
+    if ( ( first < data_last && data_first < last ) || ( first < alive_last && alive_first < last ) ) {
+
+      temporary.resize( n*dim );
+
+      for ( int j=0; j<n; ++j ) {
+        for ( int i=0; i<dim; ++i ) {
+          temporary[j*dim+i] = *reinterpret_cast<double const*>( base + j*rowstride + i*colstride );
+        }
+      }
+
+      base      = reinterpret_cast<char const*>( &temporary[0] );
+      rowstride = dim*sizeof(double);
+      colstride = sizeof(double);
+    }
+  }
+
+  b.resize( 0 );
+  b.resize( n );
+
+  // a holds the memory; the copy proceeds without the interpreter lock
+
+  ScopedGILRelease nogil;
+
+  for ( int i=0; i<dim; ++i ) {
+
+    double*           dst = b[i];
+    char const*       src = base + i*colstride;
+
+    for ( int j=0; j<n; ++j, src += rowstride ) {
+      dst[j] = *reinterpret_cast<double const*>( src );
+    }
+  }
+}
+
+void setLost( BunchArrays& b, int j, bool lost )
+{
+  if ( j < 0 || j >= b.size() ) {
+    throw PyBindingsException( "BunchArrays.setLost: particle index out of range." );
+  }
+  b.setLost( j, lost );
+}
+
+bool isLost( BunchArrays const& b, int j )
+{
+  if ( j < 0 || j >= b.size() ) {
+    throw PyBindingsException( "BunchArrays.isLost: particle index out of range." );
+  }
+  return b.isLost( j );
+}
+
+} // anonymous namespace
+
+//-----------------------------------------------------------------------------------------------
+// end of locally defined classes and functions
+//-----------------------------------------------------------------------------------------------
+
+void wrap_buncharrays() {
+
+  class_<ArrayView>  ArrayViewClass_( "BunchArraysView", no_init );
+  ArrayViewClass_.add_property("__array_interface__", &ArrayView::arrayInterface );
+  ArrayViewClass_.def("__len__",                      &ArrayView::size           );
+
+  class_<BunchArrays>  BunchArraysClass_( "BunchArrays", init<Particle const&, optional<int> >() );
+  BunchArraysClass_.def( init<BunchArrays const&>() );
+  BunchArraysClass_.def("size",                  &BunchArrays::size      );
+  BunchArraysClass_.def("__len__",               &BunchArrays::size      );
+  BunchArraysClass_.def("survivors",             &BunchArrays::survivors );
+  BunchArraysClass_.def("stride",                &BunchArrays::stride    );
+  BunchArraysClass_.def("empty",                 &BunchArrays::empty     );
+  BunchArraysClass_.def("reserve",               &reserve                );
+  BunchArraysClass_.def("resize",                &resize                 );
+  BunchArraysClass_.def("clear",                 &BunchArrays::clear     );
+  BunchArraysClass_.def("compact",               &compact                );
+  BunchArraysClass_.def("isLost",                &isLost                 );
+  BunchArraysClass_.def("setLost",               &setLost                );
+  BunchArraysClass_.def("Intensity",             &BunchArrays::Intensity    );
+  BunchArraysClass_.def("setIntensity",          &BunchArrays::setIntensity );
+  BunchArraysClass_.def("getReferenceParticle",  &BunchArrays::getReferenceParticle, return_internal_reference<>() );
+  BunchArraysClass_.def("setReferenceParticle",  &BunchArrays::setReferenceParticle );
+  BunchArraysClass_.def("coordinates",           &coordinates,    with_custodian_and_ward_postcall<0,1>() );
+  BunchArraysClass_.def("alive",                 &alive,          with_custodian_and_ward_postcall<0,1>() );
+  BunchArraysClass_.def("setCoordinates",        &setCoordinates );
+
+}
@@ -0,0 +1,105 @@
+/***************************************************************************
+****************************************************************************
+****************************************************************************
+******
+******  Python bindings for mxyzpltk/beamline libraries
+******
+******  File:      py-jetstatistics.cpp
+******
+******  Copyright Fermi Research Alliance / Fermilab
+******            All Rights Reserved
+******
+******  Software and documentation created under
+******  U.S. Department of Energy Contract No. DE-AC02-07CH11359
+******  The U.S. Government retains a world-wide non-exclusive,
+******  royalty-free license to publish or reproduce documentation
+******  and software for U.S. Government purposes. This software
+******  is protected under the U.S.and Foreign Copyright Laws.
+******
+****************************************************************************
+****************************************************************************
+****************************************************************************/
+
+#include <boost/python.hpp>
+
+#include <mxyzptlk/JetStatistics.h>
+
+#include <sstream>
+#include <string>
+
+using namespace boost::python;
+
+//-----------------------------------------------------------------------------------------------
+// locally defined classes and functions
+//-----------------------------------------------------------------------------------------------
+
+namespace {
+
+list environments()
+{
+  std::vector<JetStatistics::EnvironmentCounters> const envs = JetStatistics::environments();
+
+  list l;
+  for ( std::vector<JetStatistics::EnvironmentCounters>::const_iterator it = envs.begin(); it != envs.end(); ++it ) {
+    l.append( *it );
+  }
+  return l;
+}
+
+std::string report()
+{
+  std::ostringstream os;
+  JetStatistics::report( os );
+  return os.str();
+}
+
+} // anonymous namespace
+
+//-----------------------------------------------------------------------------------------------
+// end of locally defined classes and functions
+//-----------------------------------------------------------------------------------------------
+
+void wrap_mxyzptlk_jetstatistics() {
+
+  class_<JetStatistics::Counters>  JetStatisticsCountersClass_("JetStatisticsCounters", init<>() );
+  JetStatisticsCountersClass_.def_readonly("jlNew",            &JetStatistics::Counters::jlNew           );
+  JetStatisticsCountersClass_.def_readonly("jlRecycled",       &JetStatistics::Counters::jlRecycled      );
+  JetStatisticsCountersClass_.def_readonly("jlDiscarded",      &JetStatistics::Counters::jlDiscarded     );
+  JetStatisticsCountersClass_.def_readonly("jlDeleted",        &JetStatistics::Counters::jlDeleted       );
+  JetStatisticsCountersClass_.def_readonly("poolHighWater",    &JetStatistics::Counters::poolHighWater   );
+  JetStatisticsCountersClass_.def_readonly("storeAllocations", &JetStatistics::Counters::storeAllocations);
+  JetStatisticsCountersClass_.def_readonly("storeRegrowths",   &JetStatistics::Counters::storeRegrowths  );
+  JetStatisticsCountersClass_.def_readonly("storeBytes",       &JetStatistics::Counters::storeBytes      );
+  JetStatisticsCountersClass_.def_readonly("jlPtrCopies",      &JetStatistics::Counters::jlPtrCopies     );
+  JetStatisticsCountersClass_.def("poolHitRate",               &JetStatistics::Counters::poolHitRate     );
+  JetStatisticsCountersClass_.def( self - self );
+  JetStatisticsCountersClass_.def( self_ns::str(self) );
+
+  class_<JetStatistics::EnvironmentCounters>  JetEnvironmentCountersClass_("JetEnvironmentCounters", no_init );
+  JetEnvironmentCountersClass_.def_readonly("complex",          &JetStatistics::EnvironmentCounters::complex         );
+  JetEnvironmentCountersClass_.def_readonly("numVar",           &JetStatistics::EnvironmentCounters::numVar          );
+  JetEnvironmentCountersClass_.def_readonly("maxWeight",        &JetStatistics::EnvironmentCounters::maxWeight       );
+  JetEnvironmentCountersClass_.def_readonly("jets",             &JetStatistics::EnvironmentCounters::jets            );
+  JetEnvironmentCountersClass_.def_readonly("storeAllocations", &JetStatistics::EnvironmentCounters::storeAllocations);
+  JetEnvironmentCountersClass_.def_readonly("storeRegrowths",   &JetStatistics::EnvironmentCounters::storeRegrowths  );
+  JetEnvironmentCountersClass_.def_readonly("storeBytes",       &JetStatistics::EnvironmentCounters::storeBytes      );
+
+  class_<JetStatistics, boost::noncopyable>  JetStatisticsClass_("JetStatistics", no_init );
+  JetStatisticsClass_.def("enabled",        &JetStatistics::enabled        );
+  JetStatisticsClass_.staticmethod("enabled");
+  JetStatisticsClass_.def("thread",         &JetStatistics::thread         );
+  JetStatisticsClass_.staticmethod("thread");
+  JetStatisticsClass_.def("total",          &JetStatistics::total          );
+  JetStatisticsClass_.staticmethod("total");
+  JetStatisticsClass_.def("environments",   &environments                  );
+  JetStatisticsClass_.staticmethod("environments");
+  JetStatisticsClass_.def("liveStoreBytes", &JetStatistics::liveStoreBytes );
+  JetStatisticsClass_.staticmethod("liveStoreBytes");
+  JetStatisticsClass_.def("peakStoreBytes", &JetStatistics::peakStoreBytes );
+  JetStatisticsClass_.staticmethod("peakStoreBytes");
+  JetStatisticsClass_.def("reset",          &JetStatistics::reset          );
+  JetStatisticsClass_.staticmethod("reset");
+  JetStatisticsClass_.def("report",         &report                        );
+  JetStatisticsClass_.staticmethod("report");
+
+}
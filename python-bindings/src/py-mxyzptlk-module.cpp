@@ -33,6 +33,7 @@ extern void wrap_mxyzptlk_jetvectorc();
 extern void wrap_mxyzptlk_mapping();
 extern void wrap_mxyzptlk_mappingc();
 extern void wrap_mxyzptlk_coord();
+extern void wrap_mxyzptlk_jetstatistics();
 
 BOOST_PYTHON_MODULE(mxyzptlk)
 {
@@ -46,6 +47,7 @@ BOOST_PYTHON_MODULE(mxyzptlk)
   wrap_mxyzptlk_coord();
   wrap_mxyzptlk_mapping();
   wrap_mxyzptlk_mappingc();
+  wrap_mxyzptlk_jetstatistics();
 
 }    
 